@@ -205,6 +205,10 @@ OBJS:= $(TEMP_DIR)/bradler16.o \
 	$(TEMP_DIR)/bratomic.o \
 	$(TEMP_DIR)/brautorepeat.o \
 	$(TEMP_DIR)/brbase.o \
+	$(TEMP_DIR)/brbc4.o \
+	$(TEMP_DIR)/brbc5.o \
+	$(TEMP_DIR)/brbc7.o \
+	$(TEMP_DIR)/brboundingboxtree.o \
 	$(TEMP_DIR)/brcapturestdout.o \
 	$(TEMP_DIR)/brcodelibrary.o \
 	$(TEMP_DIR)/brcommandparameter.o \
@@ -214,16 +218,21 @@ OBJS:= $(TEMP_DIR)/bradler16.o \
 	$(TEMP_DIR)/brcompress.o \
 	$(TEMP_DIR)/brcompressdeflate.o \
 	$(TEMP_DIR)/brcompresslbmrle.o \
+	$(TEMP_DIR)/brcompresslz4.o \
 	$(TEMP_DIR)/brcompresslzss.o \
 	$(TEMP_DIR)/brconsolemanager.o \
+	$(TEMP_DIR)/brcpudispatch.o \
 	$(TEMP_DIR)/brcrc16.o \
 	$(TEMP_DIR)/brcrc32.o \
 	$(TEMP_DIR)/brcriticalsection.o \
+	$(TEMP_DIR)/brcriticalsectionlinux.o \
 	$(TEMP_DIR)/brdebug.o \
 	$(TEMP_DIR)/brdecompress.o \
 	$(TEMP_DIR)/brdecompressdeflate.o \
 	$(TEMP_DIR)/brdecompresslbmrle.o \
+	$(TEMP_DIR)/brdecompresslz4.o \
 	$(TEMP_DIR)/brdecompresslzss.o \
+	$(TEMP_DIR)/brdecompressstream.o \
 	$(TEMP_DIR)/brdetectmultilaunch.o \
 	$(TEMP_DIR)/brdirectorysearch.o \
 	$(TEMP_DIR)/brdirectorysearchlinux.o \
@@ -316,6 +325,7 @@ OBJS:= $(TEMP_DIR)/bradler16.o \
 	$(TEMP_DIR)/brmouse.o \
 	$(TEMP_DIR)/brmp3.o \
 	$(TEMP_DIR)/brmp3math.o \
+	$(TEMP_DIR)/brmultihash.o \
 	$(TEMP_DIR)/brnetendpoint.o \
 	$(TEMP_DIR)/brnetendpointtcp.o \
 	$(TEMP_DIR)/brnetmanager.o \
@@ -343,10 +353,12 @@ OBJS:= $(TEMP_DIR)/bradler16.o \
 	$(TEMP_DIR)/brrenderersoftware16.o \
 	$(TEMP_DIR)/brrenderersoftware8.o \
 	$(TEMP_DIR)/brrezfile.o \
+	$(TEMP_DIR)/brrezfilelinux.o \
 	$(TEMP_DIR)/brrunqueue.o \
 	$(TEMP_DIR)/brsdbmhash.o \
 	$(TEMP_DIR)/brsequencer.o \
 	$(TEMP_DIR)/brsha1.o \
+	$(TEMP_DIR)/brsha256.o \
 	$(TEMP_DIR)/brshader2dccolor.o \
 	$(TEMP_DIR)/brshader2dcolorvertex.o \
 	$(TEMP_DIR)/brshaders.o \
@@ -390,6 +402,10 @@ DEPS:= $(TEMP_DIR)/bradler16.d \
 	$(TEMP_DIR)/bratomic.d \
 	$(TEMP_DIR)/brautorepeat.d \
 	$(TEMP_DIR)/brbase.d \
+	$(TEMP_DIR)/brbc4.d \
+	$(TEMP_DIR)/brbc5.d \
+	$(TEMP_DIR)/brbc7.d \
+	$(TEMP_DIR)/brboundingboxtree.d \
 	$(TEMP_DIR)/brcapturestdout.d \
 	$(TEMP_DIR)/brcodelibrary.d \
 	$(TEMP_DIR)/brcommandparameter.d \
@@ -399,16 +415,21 @@ DEPS:= $(TEMP_DIR)/bradler16.d \
 	$(TEMP_DIR)/brcompress.d \
 	$(TEMP_DIR)/brcompressdeflate.d \
 	$(TEMP_DIR)/brcompresslbmrle.d \
+	$(TEMP_DIR)/brcompresslz4.d \
 	$(TEMP_DIR)/brcompresslzss.d \
 	$(TEMP_DIR)/brconsolemanager.d \
+	$(TEMP_DIR)/brcpudispatch.d \
 	$(TEMP_DIR)/brcrc16.d \
 	$(TEMP_DIR)/brcrc32.d \
 	$(TEMP_DIR)/brcriticalsection.d \
+	$(TEMP_DIR)/brcriticalsectionlinux.d \
 	$(TEMP_DIR)/brdebug.d \
 	$(TEMP_DIR)/brdecompress.d \
 	$(TEMP_DIR)/brdecompressdeflate.d \
 	$(TEMP_DIR)/brdecompresslbmrle.d \
+	$(TEMP_DIR)/brdecompresslz4.d \
 	$(TEMP_DIR)/brdecompresslzss.d \
+	$(TEMP_DIR)/brdecompressstream.d \
 	$(TEMP_DIR)/brdetectmultilaunch.d \
 	$(TEMP_DIR)/brdirectorysearch.d \
 	$(TEMP_DIR)/brdirectorysearchlinux.d \
@@ -501,6 +522,7 @@ DEPS:= $(TEMP_DIR)/bradler16.d \
 	$(TEMP_DIR)/brmouse.d \
 	$(TEMP_DIR)/brmp3.d \
 	$(TEMP_DIR)/brmp3math.d \
+	$(TEMP_DIR)/brmultihash.d \
 	$(TEMP_DIR)/brnetendpoint.d \
 	$(TEMP_DIR)/brnetendpointtcp.d \
 	$(TEMP_DIR)/brnetmanager.d \
@@ -528,10 +550,12 @@ DEPS:= $(TEMP_DIR)/bradler16.d \
 	$(TEMP_DIR)/brrenderersoftware16.d \
 	$(TEMP_DIR)/brrenderersoftware8.d \
 	$(TEMP_DIR)/brrezfile.d \
+	$(TEMP_DIR)/brrezfilelinux.d \
 	$(TEMP_DIR)/brrunqueue.d \
 	$(TEMP_DIR)/brsdbmhash.d \
 	$(TEMP_DIR)/brsequencer.d \
 	$(TEMP_DIR)/brsha1.d \
+	$(TEMP_DIR)/brsha256.d \
 	$(TEMP_DIR)/brshader2dccolor.d \
 	$(TEMP_DIR)/brshader2dcolorvertex.d \
 	$(TEMP_DIR)/brshaders.d \
@@ -569,7 +593,7 @@ DEPS:= $(TEMP_DIR)/bradler16.d \
 # Disable building the source files
 #
 
-../source/ansi/brcapturestdout.cpp ../source/ansi/brfileansihelpers.cpp ../source/ansi/brmemoryansi.cpp ../source/ansi/brstdouthelpers.cpp ../source/audio/bralaw.cpp ../source/audio/brimportit.cpp ../source/audio/brimports3m.cpp ../source/audio/brimportxm.cpp ../source/audio/brmace.cpp ../source/audio/brmicrosoftadpcm.cpp ../source/audio/brmp3.cpp ../source/audio/brsequencer.cpp ../source/audio/brsound.cpp ../source/audio/brsoundbufferrez.cpp ../source/audio/brsounddecompress.cpp ../source/audio/brulaw.cpp ../source/commandline/brcommandparameter.cpp ../source/commandline/brcommandparameterbooltrue.cpp ../source/commandline/brcommandparameterstring.cpp ../source/commandline/brcommandparameterwordptr.cpp ../source/commandline/brconsolemanager.cpp ../source/commandline/brgameapp.cpp ../source/compression/bradler16.cpp ../source/compression/bradler32.cpp ../source/compression/brcompress.cpp ../source/compression/brcompressdeflate.cpp ../source/compression/brcompresslbmrle.cpp ../source/compression/brcompresslzss.cpp ../source/compression/brcrc16.cpp ../source/compression/brcrc32.cpp ../source/compression/brdecompress.cpp ../source/compression/brdecompressdeflate.cpp ../source/compression/brdecompresslbmrle.cpp ../source/compression/brdecompresslzss.cpp ../source/compression/brdjb2hash.cpp ../source/compression/brdxt1.cpp ../source/compression/brdxt3.cpp ../source/compression/brdxt5.cpp ../source/compression/brgost.cpp ../source/compression/brhashmap.cpp ../source/compression/brmd2.cpp ../source/compression/brmd4.cpp ../source/compression/brmd5.cpp ../source/compression/brpackfloat.cpp ../source/compression/brsdbmhash.cpp ../source/compression/brsha1.cpp ../source/compression/brunpackbytes.cpp ../source/file/brdirectorysearch.cpp ../source/file/brfile.cpp ../source/file/brfileapf.cpp ../source/file/brfilebmp.cpp ../source/file/brfiledds.cpp ../source/file/brfilegif.cpp ../source/file/brfileini.cpp ../source/file/brfilelbm.cpp ../source/file/brfilemanager.cpp ../source/file/brfilemp3.cpp ../source/file/brfilename.cpp ../source/file/brfilepcx.cpp ../source/file/brfilepng.cpp ../source/file/brfiletga.cpp ../source/file/brfilexml.cpp ../source/file/brinputmemorystream.cpp ../source/file/broutputmemorystream.cpp ../source/file/brrezfile.cpp ../source/flashplayer/brflashaction.cpp ../source/flashplayer/brflashactionvalue.cpp ../source/flashplayer/brflashavm2.cpp ../source/flashplayer/brflashcolortransform.cpp ../source/flashplayer/brflashdisasmactionscript.cpp ../source/flashplayer/brflashmanager.cpp ../source/flashplayer/brflashmatrix23.cpp ../source/flashplayer/brflashrect.cpp ../source/flashplayer/brflashrgba.cpp ../source/flashplayer/brflashstream.cpp ../source/flashplayer/brflashutils.cpp ../source/graphics/brdisplay.cpp ../source/graphics/brdisplayobject.cpp ../source/graphics/brdisplayopengl.cpp ../source/graphics/brdisplayopenglsoftware8.cpp ../source/graphics/brfont.cpp ../source/graphics/brfont4bit.cpp ../source/graphics/brimage.cpp ../source/graphics/brpalette.cpp ../source/graphics/brpoint2d.cpp ../source/graphics/brrect.cpp ../source/graphics/brrenderer.cpp ../source/graphics/brrenderersoftware16.cpp ../source/graphics/brrenderersoftware8.cpp ../source/graphics/brshape8bit.cpp ../source/graphics/brtexture.cpp ../source/graphics/brtextureopengl.cpp ../source/graphics/brvertexbuffer.cpp ../source/graphics/brvertexbufferopengl.cpp ../source/graphics/effects/breffect.cpp ../source/graphics/effects/breffect2d.cpp ../source/graphics/effects/breffectpositiontexturecolor.cpp ../source/graphics/effects/breffectstaticpositiontexture.cpp ../source/graphics/effects/brshaders.cpp ../source/graphics/shaders/brshader2dccolor.cpp ../source/graphics/shaders/brshader2dcolorvertex.cpp ../source/input/brjoypad.cpp ../source/input/brkeyboard.cpp ../source/input/brmouse.cpp ../source/linux/brdirectorysearchlinux.cpp ../source/linux/brglobalslinux.cpp ../source/linux/brosstringfunctionslinux.cpp ../source/lowlevel/bralgorithm.cpp ../source/lowlevel/brarray.cpp ../source/lowlevel/brassert.cpp ../source/lowlevel/bratomic.cpp ../source/lowlevel/brautorepeat.cpp ../source/lowlevel/brbase.cpp ../source/lowlevel/brcodelibrary.cpp ../source/lowlevel/brcriticalsection.cpp ../source/lowlevel/brdebug.cpp ../source/lowlevel/brdetectmultilaunch.cpp ../source/lowlevel/brdoublylinkedlist.cpp ../source/lowlevel/brendian.cpp ../source/lowlevel/brerror.cpp ../source/lowlevel/brglobals.cpp ../source/lowlevel/brgridindex.cpp ../source/lowlevel/brguid.cpp ../source/lowlevel/brintrinsics.cpp ../source/lowlevel/brlastinfirstout.cpp ../source/lowlevel/brlinkedlistobject.cpp ../source/lowlevel/brlinkedlistpointer.cpp ../source/lowlevel/broscursor.cpp ../source/lowlevel/brpair.cpp ../source/lowlevel/brperforce.cpp ../source/lowlevel/brqueue.cpp ../source/lowlevel/brrunqueue.cpp ../source/lowlevel/brsimplearray.cpp ../source/lowlevel/brsmartpointer.cpp ../source/lowlevel/brstaticrtti.cpp ../source/lowlevel/brtick.cpp ../source/lowlevel/brtimedate.cpp ../source/lowlevel/brtypes.cpp ../source/math/brearcliptriangulate.cpp ../source/math/brfixedmatrix3d.cpp ../source/math/brfixedmatrix4d.cpp ../source/math/brfixedpoint.cpp ../source/math/brfixedvector2d.cpp ../source/math/brfixedvector3d.cpp ../source/math/brfixedvector4d.cpp ../source/math/brfloatingpoint.cpp ../source/math/brfpinfo.cpp ../source/math/brmatrix3d.cpp ../source/math/brmatrix4d.cpp ../source/math/brmp3math.cpp ../source/math/brsinecosine.cpp ../source/math/brvector2d.cpp ../source/math/brvector3d.cpp ../source/math/brvector4d.cpp ../source/memory/brglobalmemorymanager.cpp ../source/memory/brmemoryhandle.cpp ../source/memory/brmemorymanager.cpp ../source/network/brnetendpoint.cpp ../source/network/brnetendpointtcp.cpp ../source/network/brnetmanager.cpp ../source/network/brnetmodule.cpp ../source/network/brnetmoduletcp.cpp ../source/network/brnetplay.cpp ../source/random/brmersennetwist.cpp ../source/random/brrandom.cpp ../source/random/brrandombase.cpp ../source/text/brasciito.cpp ../source/text/brisolatin1.cpp ../source/text/brlocalization.cpp ../source/text/brmacromanus.cpp ../source/text/brmemoryfunctions.cpp ../source/text/brnumberstring.cpp ../source/text/brnumberstringhex.cpp ../source/text/brnumberto.cpp ../source/text/brosstringfunctions.cpp ../source/text/brprintf.cpp ../source/text/brsimplestring.cpp ../source/text/brstring.cpp ../source/text/brstring16.cpp ../source/text/brstringfunctions.cpp ../source/text/brutf16.cpp ../source/text/brutf32.cpp ../source/text/brutf8.cpp ../source/text/brwin1252.cpp: ;
+../source/ansi/brcapturestdout.cpp ../source/ansi/brfileansihelpers.cpp ../source/ansi/brmemoryansi.cpp ../source/ansi/brstdouthelpers.cpp ../source/audio/bralaw.cpp ../source/audio/brimportit.cpp ../source/audio/brimports3m.cpp ../source/audio/brimportxm.cpp ../source/audio/brmace.cpp ../source/audio/brmicrosoftadpcm.cpp ../source/audio/brmp3.cpp ../source/audio/brsequencer.cpp ../source/audio/brsound.cpp ../source/audio/brsoundbufferrez.cpp ../source/audio/brsounddecompress.cpp ../source/audio/brulaw.cpp ../source/commandline/brcommandparameter.cpp ../source/commandline/brcommandparameterbooltrue.cpp ../source/commandline/brcommandparameterstring.cpp ../source/commandline/brcommandparameterwordptr.cpp ../source/commandline/brconsolemanager.cpp ../source/commandline/brgameapp.cpp ../source/compression/bradler16.cpp ../source/compression/bradler32.cpp ../source/compression/brbc4.cpp ../source/compression/brbc5.cpp ../source/compression/brbc7.cpp ../source/compression/brcompress.cpp ../source/compression/brcompressdeflate.cpp ../source/compression/brcompresslbmrle.cpp ../source/compression/brcompresslz4.cpp ../source/compression/brcompresslzss.cpp ../source/compression/brcrc16.cpp ../source/compression/brcrc32.cpp ../source/compression/brdecompress.cpp ../source/compression/brdecompressdeflate.cpp ../source/compression/brdecompresslbmrle.cpp ../source/compression/brdecompresslz4.cpp ../source/compression/brdecompresslzss.cpp ../source/compression/brdecompressstream.cpp ../source/compression/brdjb2hash.cpp ../source/compression/brdxt1.cpp ../source/compression/brdxt3.cpp ../source/compression/brdxt5.cpp ../source/compression/brgost.cpp ../source/compression/brhashmap.cpp ../source/compression/brmd2.cpp ../source/compression/brmd4.cpp ../source/compression/brmd5.cpp ../source/compression/brmultihash.cpp ../source/compression/brpackfloat.cpp ../source/compression/brsdbmhash.cpp ../source/compression/brsha1.cpp ../source/compression/brsha256.cpp ../source/compression/brunpackbytes.cpp ../source/file/brdirectorysearch.cpp ../source/file/brfile.cpp ../source/file/brfileapf.cpp ../source/file/brfilebmp.cpp ../source/file/brfiledds.cpp ../source/file/brfilegif.cpp ../source/file/brfileini.cpp ../source/file/brfilelbm.cpp ../source/file/brfilemanager.cpp ../source/file/brfilemp3.cpp ../source/file/brfilename.cpp ../source/file/brfilepcx.cpp ../source/file/brfilepng.cpp ../source/file/brfiletga.cpp ../source/file/brfilexml.cpp ../source/file/brinputmemorystream.cpp ../source/file/broutputmemorystream.cpp ../source/file/brrezfile.cpp ../source/flashplayer/brflashaction.cpp ../source/flashplayer/brflashactionvalue.cpp ../source/flashplayer/brflashavm2.cpp ../source/flashplayer/brflashcolortransform.cpp ../source/flashplayer/brflashdisasmactionscript.cpp ../source/flashplayer/brflashmanager.cpp ../source/flashplayer/brflashmatrix23.cpp ../source/flashplayer/brflashrect.cpp ../source/flashplayer/brflashrgba.cpp ../source/flashplayer/brflashstream.cpp ../source/flashplayer/brflashutils.cpp ../source/graphics/brdisplay.cpp ../source/graphics/brdisplayobject.cpp ../source/graphics/brdisplayopengl.cpp ../source/graphics/brdisplayopenglsoftware8.cpp ../source/graphics/brfont.cpp ../source/graphics/brfont4bit.cpp ../source/graphics/brimage.cpp ../source/graphics/brpalette.cpp ../source/graphics/brpoint2d.cpp ../source/graphics/brrect.cpp ../source/graphics/brrenderer.cpp ../source/graphics/brrenderersoftware16.cpp ../source/graphics/brrenderersoftware8.cpp ../source/graphics/brshape8bit.cpp ../source/graphics/brtexture.cpp ../source/graphics/brtextureopengl.cpp ../source/graphics/brvertexbuffer.cpp ../source/graphics/brvertexbufferopengl.cpp ../source/graphics/effects/breffect.cpp ../source/graphics/effects/breffect2d.cpp ../source/graphics/effects/breffectpositiontexturecolor.cpp ../source/graphics/effects/breffectstaticpositiontexture.cpp ../source/graphics/effects/brshaders.cpp ../source/graphics/shaders/brshader2dccolor.cpp ../source/graphics/shaders/brshader2dcolorvertex.cpp ../source/input/brjoypad.cpp ../source/input/brkeyboard.cpp ../source/input/brmouse.cpp ../source/linux/brcriticalsectionlinux.cpp ../source/linux/brdirectorysearchlinux.cpp ../source/linux/brglobalslinux.cpp ../source/linux/brosstringfunctionslinux.cpp ../source/linux/brrezfilelinux.cpp ../source/lowlevel/bralgorithm.cpp ../source/lowlevel/brarray.cpp ../source/lowlevel/brassert.cpp ../source/lowlevel/bratomic.cpp ../source/lowlevel/brautorepeat.cpp ../source/lowlevel/brbase.cpp ../source/lowlevel/brboundingboxtree.cpp ../source/lowlevel/brcodelibrary.cpp ../source/lowlevel/brcpudispatch.cpp ../source/lowlevel/brcriticalsection.cpp ../source/lowlevel/brdebug.cpp ../source/lowlevel/brdetectmultilaunch.cpp ../source/lowlevel/brdoublylinkedlist.cpp ../source/lowlevel/brendian.cpp ../source/lowlevel/brerror.cpp ../source/lowlevel/brglobals.cpp ../source/lowlevel/brgridindex.cpp ../source/lowlevel/brguid.cpp ../source/lowlevel/brintrinsics.cpp ../source/lowlevel/brlastinfirstout.cpp ../source/lowlevel/brlinkedlistobject.cpp ../source/lowlevel/brlinkedlistpointer.cpp ../source/lowlevel/broscursor.cpp ../source/lowlevel/brpair.cpp ../source/lowlevel/brperforce.cpp ../source/lowlevel/brqueue.cpp ../source/lowlevel/brrunqueue.cpp ../source/lowlevel/brsimplearray.cpp ../source/lowlevel/brsmartpointer.cpp ../source/lowlevel/brstaticrtti.cpp ../source/lowlevel/brtick.cpp ../source/lowlevel/brtimedate.cpp ../source/lowlevel/brtypes.cpp ../source/math/brearcliptriangulate.cpp ../source/math/brfixedmatrix3d.cpp ../source/math/brfixedmatrix4d.cpp ../source/math/brfixedpoint.cpp ../source/math/brfixedvector2d.cpp ../source/math/brfixedvector3d.cpp ../source/math/brfixedvector4d.cpp ../source/math/brfloatingpoint.cpp ../source/math/brfpinfo.cpp ../source/math/brmatrix3d.cpp ../source/math/brmatrix4d.cpp ../source/math/brmp3math.cpp ../source/math/brsinecosine.cpp ../source/math/brvector2d.cpp ../source/math/brvector3d.cpp ../source/math/brvector4d.cpp ../source/memory/brglobalmemorymanager.cpp ../source/memory/brmemoryhandle.cpp ../source/memory/brmemorymanager.cpp ../source/network/brnetendpoint.cpp ../source/network/brnetendpointtcp.cpp ../source/network/brnetmanager.cpp ../source/network/brnetmodule.cpp ../source/network/brnetmoduletcp.cpp ../source/network/brnetplay.cpp ../source/random/brmersennetwist.cpp ../source/random/brrandom.cpp ../source/random/brrandombase.cpp ../source/text/brasciito.cpp ../source/text/brisolatin1.cpp ../source/text/brlocalization.cpp ../source/text/brmacromanus.cpp ../source/text/brmemoryfunctions.cpp ../source/text/brnumberstring.cpp ../source/text/brnumberstringhex.cpp ../source/text/brnumberto.cpp ../source/text/brosstringfunctions.cpp ../source/text/brprintf.cpp ../source/text/brsimplestring.cpp ../source/text/brstring.cpp ../source/text/brstring16.cpp ../source/text/brstringfunctions.cpp ../source/text/brutf16.cpp ../source/text/brutf32.cpp ../source/text/brutf8.cpp ../source/text/brwin1252.cpp: ;
 
 #
 # Build the object file folder
@@ -632,12 +656,20 @@ $(TEMP_DIR)/bradler16.o: ../source/compression/bradler16.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/bradler32.o: ../source/compression/bradler32.cpp ; $(BUILD_CPP)
 
+$(TEMP_DIR)/brbc4.o: ../source/compression/brbc4.cpp ; $(BUILD_CPP)
+
+$(TEMP_DIR)/brbc5.o: ../source/compression/brbc5.cpp ; $(BUILD_CPP)
+
+$(TEMP_DIR)/brbc7.o: ../source/compression/brbc7.cpp ; $(BUILD_CPP)
+
 $(TEMP_DIR)/brcompress.o: ../source/compression/brcompress.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brcompressdeflate.o: ../source/compression/brcompressdeflate.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brcompresslbmrle.o: ../source/compression/brcompresslbmrle.cpp ; $(BUILD_CPP)
 
+$(TEMP_DIR)/brcompresslz4.o: ../source/compression/brcompresslz4.cpp ; $(BUILD_CPP)
+
 $(TEMP_DIR)/brcompresslzss.o: ../source/compression/brcompresslzss.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brcrc16.o: ../source/compression/brcrc16.cpp ; $(BUILD_CPP)
@@ -650,8 +682,12 @@ $(TEMP_DIR)/brdecompressdeflate.o: ../source/compression/brdecompressdeflate.cpp
 
 $(TEMP_DIR)/brdecompresslbmrle.o: ../source/compression/brdecompresslbmrle.cpp ; $(BUILD_CPP)
 
+$(TEMP_DIR)/brdecompresslz4.o: ../source/compression/brdecompresslz4.cpp ; $(BUILD_CPP)
+
 $(TEMP_DIR)/brdecompresslzss.o: ../source/compression/brdecompresslzss.cpp ; $(BUILD_CPP)
 
+$(TEMP_DIR)/brdecompressstream.o: ../source/compression/brdecompressstream.cpp ; $(BUILD_CPP)
+
 $(TEMP_DIR)/brdjb2hash.o: ../source/compression/brdjb2hash.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brdxt1.o: ../source/compression/brdxt1.cpp ; $(BUILD_CPP)
@@ -670,12 +706,16 @@ $(TEMP_DIR)/brmd4.o: ../source/compression/brmd4.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brmd5.o: ../source/compression/brmd5.cpp ; $(BUILD_CPP)
 
+$(TEMP_DIR)/brmultihash.o: ../source/compression/brmultihash.cpp ; $(BUILD_CPP)
+
 $(TEMP_DIR)/brpackfloat.o: ../source/compression/brpackfloat.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brsdbmhash.o: ../source/compression/brsdbmhash.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brsha1.o: ../source/compression/brsha1.cpp ; $(BUILD_CPP)
 
+$(TEMP_DIR)/brsha256.o: ../source/compression/brsha256.cpp ; $(BUILD_CPP)
+
 $(TEMP_DIR)/brunpackbytes.o: ../source/compression/brunpackbytes.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brdirectorysearch.o: ../source/file/brdirectorysearch.cpp ; $(BUILD_CPP)
@@ -792,12 +832,16 @@ $(TEMP_DIR)/brkeyboard.o: ../source/input/brkeyboard.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brmouse.o: ../source/input/brmouse.cpp ; $(BUILD_CPP)
 
+$(TEMP_DIR)/brcriticalsectionlinux.o: ../source/linux/brcriticalsectionlinux.cpp ; $(BUILD_CPP)
+
 $(TEMP_DIR)/brdirectorysearchlinux.o: ../source/linux/brdirectorysearchlinux.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brglobalslinux.o: ../source/linux/brglobalslinux.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brosstringfunctionslinux.o: ../source/linux/brosstringfunctionslinux.cpp ; $(BUILD_CPP)
 
+$(TEMP_DIR)/brrezfilelinux.o: ../source/linux/brrezfilelinux.cpp ; $(BUILD_CPP)
+
 $(TEMP_DIR)/bralgorithm.o: ../source/lowlevel/bralgorithm.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brarray.o: ../source/lowlevel/brarray.cpp ; $(BUILD_CPP)
@@ -810,8 +854,12 @@ $(TEMP_DIR)/brautorepeat.o: ../source/lowlevel/brautorepeat.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brbase.o: ../source/lowlevel/brbase.cpp ; $(BUILD_CPP)
 
+$(TEMP_DIR)/brboundingboxtree.o: ../source/lowlevel/brboundingboxtree.cpp ; $(BUILD_CPP)
+
 $(TEMP_DIR)/brcodelibrary.o: ../source/lowlevel/brcodelibrary.cpp ; $(BUILD_CPP)
 
+$(TEMP_DIR)/brcpudispatch.o: ../source/lowlevel/brcpudispatch.cpp ; $(BUILD_CPP)
+
 $(TEMP_DIR)/brcriticalsection.o: ../source/lowlevel/brcriticalsection.cpp ; $(BUILD_CPP)
 
 $(TEMP_DIR)/brdebug.o: ../source/lowlevel/brdebug.cpp ; $(BUILD_CPP)
@@ -461,18 +461,15 @@ Word BURGER_API Burger::ImportS3M(Sequencer::SongPackage *pOutput,const Word8 *p
 										if (pSampleDescription->m_uBitsPerSample==16) {
 											WordPtr uLength = pSampleDescription->m_uSampleSize/2;
 											if (uLength) {
+												Word16 *pSampleTemp = static_cast<Word16 *>(pSampleDescription->m_pSample);
+												LittleEndian::FixupArray(pSampleTemp,uLength);
 												if (uSampleType != 1) {
-													Word16 *pSampleTemp = static_cast<Word16 *>(pSampleDescription->m_pSample);
+													// Convert unsigned samples to signed
 													do {
-														pSampleTemp[0] = static_cast<Word16>(LittleEndian::Load(pSampleTemp)^0x8000U);
+														pSampleTemp[0] = static_cast<Word16>(pSampleTemp[0]^0x8000U);
 														++pSampleTemp;
 													} while (--uLength);
 												}
-#if defined(BURGER_BIGENDIAN)
-												else {
-													ConvertEndian(static_cast<Word16 *>(pSampleDescription->m_pSample),uLength);
-												}
-#endif
 											}
 										} else {
 											if (uSampleType != 1) {
@@ -19,14 +19,179 @@
 ***************************************/
 
 #include "bradler16.h"
+#include "brcpudispatch.h"
+
+#if defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
 
 #if !defined(DOXYGEN)
 // Note : Do NOT alter these defines or the checksum
 // will not be the same as found in deflate/inflate gzip
 // archives. This is a bad thing.
 
-#define LARGESTPRIME 251	// largest prime smaller than 256
-#define LARGESTBLOCK 5802	// NMAX is the largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1
+#define LARGESTPRIME 251U	// largest prime smaller than 256
+#define LARGESTBLOCK 5802U	// NMAX is the largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1
+
+typedef Word (BURGER_API *Adler16Proc)(Word uAdler16,const Word8 *pInput,WordPtr uInputLength);
+
+//
+// Process a byte at a time
+//
+
+static Word BURGER_API Adler16Generic(Word uAdler16,const Word8 *pInput,WordPtr uInputLength) BURGER_NOEXCEPT
+{
+	Word32 uAdditive = static_cast<Word8>(uAdler16);		// Get the additive checksum
+	Word32 uFactorial = static_cast<Word8>(uAdler16>>8U);	// Get the factorial checksum
+	do {
+		// Get the chunk size to process
+		Word uCount = LARGESTBLOCK;
+		if (uInputLength<LARGESTBLOCK) {
+			// Truncate to the remainder
+			uCount = static_cast<Word>(uInputLength);
+		}
+		// Remove the count from the processed list
+		uInputLength -= uCount;
+		do {
+			// Add to the additive checksum
+			uAdditive += pInput[0];
+			++pInput;
+			// Add the checksum to the factorial
+			uFactorial += uAdditive;
+		} while (--uCount);
+		uAdditive %= LARGESTPRIME;		// Force to fit in a byte
+		uFactorial %= LARGESTPRIME;		// Force to fit in a byte
+	} while (uInputLength);				// All done?
+	// Blend the final 16 bit result
+	return static_cast<Word>((uFactorial<<8U)+uAdditive);
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+//
+// Same block scheme as CalcAdler32(), 32 bytes at a time with psadbw
+// for the additive sum and pmaddubsw for the weighted factorial sum.
+// Only the prime and the pass length differ.
+//
+
+static const WordPtr g_uBlockSize = 32U;
+static const WordPtr g_uBlocksPerPass = LARGESTBLOCK/g_uBlockSize;
+
+static BURGER_TARGET_SSSE3 Word BURGER_API Adler16SSSE3(Word uAdler16,const Word8 *pInput,WordPtr uInputLength) BURGER_NOEXCEPT
+{
+	Word32 uAdditive = static_cast<Word8>(uAdler16);
+	Word32 uFactorial = static_cast<Word8>(uAdler16>>8U);
+	WordPtr uBlocks = uInputLength/g_uBlockSize;
+	uInputLength -= uBlocks*g_uBlockSize;
+
+	const __m128i vTap1 = _mm_setr_epi8(32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17);
+	const __m128i vTap2 = _mm_setr_epi8(16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1);
+	const __m128i vZero = _mm_setzero_si128();
+	const __m128i vOnes = _mm_set1_epi16(1);
+
+	while (uBlocks) {
+		WordPtr uCount = g_uBlocksPerPass;
+		if (uBlocks<uCount) {
+			uCount = uBlocks;
+		}
+		uBlocks -= uCount;
+
+		// Previous additive sums, times 32 at the end
+		__m128i vPrevious = _mm_cvtsi32_si128(static_cast<int>(uAdditive*uCount));
+		__m128i vFactorial = _mm_cvtsi32_si128(static_cast<int>(uFactorial));
+		__m128i vAdditive = vZero;
+		do {
+			__m128i vBytes1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput));
+			__m128i vBytes2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput+16));
+			vPrevious = _mm_add_epi32(vPrevious,vAdditive);
+			vAdditive = _mm_add_epi32(vAdditive,_mm_sad_epu8(vBytes1,vZero));
+			vFactorial = _mm_add_epi32(vFactorial,_mm_madd_epi16(_mm_maddubs_epi16(vBytes1,vTap1),vOnes));
+			vAdditive = _mm_add_epi32(vAdditive,_mm_sad_epu8(vBytes2,vZero));
+			vFactorial = _mm_add_epi32(vFactorial,_mm_madd_epi16(_mm_maddubs_epi16(vBytes2,vTap2),vOnes));
+			pInput += g_uBlockSize;
+		} while (--uCount);
+		vFactorial = _mm_add_epi32(vFactorial,_mm_slli_epi32(vPrevious,5));
+
+		// Sum the lanes
+		vAdditive = _mm_add_epi32(vAdditive,_mm_shuffle_epi32(vAdditive,_MM_SHUFFLE(2,3,0,1)));
+		vAdditive = _mm_add_epi32(vAdditive,_mm_shuffle_epi32(vAdditive,_MM_SHUFFLE(1,0,3,2)));
+		uAdditive += static_cast<Word32>(_mm_cvtsi128_si32(vAdditive));
+		vFactorial = _mm_add_epi32(vFactorial,_mm_shuffle_epi32(vFactorial,_MM_SHUFFLE(2,3,0,1)));
+		vFactorial = _mm_add_epi32(vFactorial,_mm_shuffle_epi32(vFactorial,_MM_SHUFFLE(1,0,3,2)));
+		uFactorial = static_cast<Word32>(_mm_cvtsi128_si32(vFactorial));
+		uAdditive %= LARGESTPRIME;
+		uFactorial %= LARGESTPRIME;
+	}
+	uAdler16 = static_cast<Word>((uFactorial<<8U)+uAdditive);
+	// Finish the remainder
+	if (uInputLength) {
+		uAdler16 = Adler16Generic(uAdler16,pInput,uInputLength);
+	}
+	return uAdler16;
+}
+
+static BURGER_TARGET_AVX2 Word BURGER_API Adler16AVX2(Word uAdler16,const Word8 *pInput,WordPtr uInputLength) BURGER_NOEXCEPT
+{
+	Word32 uAdditive = static_cast<Word8>(uAdler16);
+	Word32 uFactorial = static_cast<Word8>(uAdler16>>8U);
+	WordPtr uBlocks = uInputLength/g_uBlockSize;
+	uInputLength -= uBlocks*g_uBlockSize;
+
+	const __m256i vTap = _mm256_setr_epi8(32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17,
+		16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1);
+	const __m256i vZero = _mm256_setzero_si256();
+	const __m256i vOnes = _mm256_set1_epi16(1);
+
+	while (uBlocks) {
+		WordPtr uCount = g_uBlocksPerPass;
+		if (uBlocks<uCount) {
+			uCount = uBlocks;
+		}
+		uBlocks -= uCount;
+
+		__m256i vPrevious = _mm256_setr_epi32(static_cast<int>(uAdditive*uCount),0,0,0,0,0,0,0);
+		__m256i vFactorial = _mm256_setr_epi32(static_cast<int>(uFactorial),0,0,0,0,0,0,0);
+		__m256i vAdditive = vZero;
+		do {
+			__m256i vBytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pInput));
+			vPrevious = _mm256_add_epi32(vPrevious,vAdditive);
+			vAdditive = _mm256_add_epi32(vAdditive,_mm256_sad_epu8(vBytes,vZero));
+			vFactorial = _mm256_add_epi32(vFactorial,_mm256_madd_epi16(_mm256_maddubs_epi16(vBytes,vTap),vOnes));
+			pInput += g_uBlockSize;
+		} while (--uCount);
+		vFactorial = _mm256_add_epi32(vFactorial,_mm256_slli_epi32(vPrevious,5));
+
+		// Sum the lanes
+		__m128i vSum = _mm_add_epi32(_mm256_castsi256_si128(vAdditive),_mm256_extracti128_si256(vAdditive,1));
+		vSum = _mm_add_epi32(vSum,_mm_shuffle_epi32(vSum,_MM_SHUFFLE(2,3,0,1)));
+		vSum = _mm_add_epi32(vSum,_mm_shuffle_epi32(vSum,_MM_SHUFFLE(1,0,3,2)));
+		uAdditive += static_cast<Word32>(_mm_cvtsi128_si32(vSum));
+		vSum = _mm_add_epi32(_mm256_castsi256_si128(vFactorial),_mm256_extracti128_si256(vFactorial,1));
+		vSum = _mm_add_epi32(vSum,_mm_shuffle_epi32(vSum,_MM_SHUFFLE(2,3,0,1)));
+		vSum = _mm_add_epi32(vSum,_mm_shuffle_epi32(vSum,_MM_SHUFFLE(1,0,3,2)));
+		uFactorial = static_cast<Word32>(_mm_cvtsi128_si32(vSum));
+		uAdditive %= LARGESTPRIME;
+		uFactorial %= LARGESTPRIME;
+	}
+	uAdler16 = static_cast<Word>((uFactorial<<8U)+uAdditive);
+	// Finish the remainder
+	if (uInputLength) {
+		uAdler16 = Adler16Generic(uAdler16,pInput,uInputLength);
+	}
+	return uAdler16;
+}
+
+static const Burger::CPUDispatch::Variant_t g_Adler16Variants[] = {
+	{BURGER_CPU_DISPATCH_PROC(Adler16AVX2),Burger::CPUDispatch::kAVX2,"AVX2"},
+	{BURGER_CPU_DISPATCH_PROC(Adler16SSSE3),Burger::CPUDispatch::kSSSE3,"SSSE3"},
+	{BURGER_CPU_DISPATCH_PROC(Adler16Generic),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_Adler16Dispatch,Burger::CPUDispatch::kFamilyHash,g_Adler16Variants);
+
+#define Adler16Kernel g_Adler16Dispatch.Get<Adler16Proc>()
+#else
+#define Adler16Kernel Adler16Generic
+#endif
 #endif
 
 /*! ************************************
@@ -46,6 +211,9 @@
 	The upper 8 bits is a factorial additive checksum based on the
 	additive checksum with a starting value of 0
 
+	On x86 CPUs with SSSE3 or AVX2, 32 bytes are summed at a time with
+	vector instructions. The choice is made by CPUDispatch.
+
 	\param pInput Pointer to a buffer to be checksummed
 	\param uInputLength Number of bytes in the buffer to be checksummed
 	\param uAdler16 Alder-16 from previous calculations or one if a new checksum is desired
@@ -60,31 +228,7 @@ Word BURGER_API Burger::CalcAdler16(const void *pInput,WordPtr uInputLength,Word
 {
 	// Anything to process?
 	if (pInput && uInputLength) {
-
-		Word32 uAdditive = static_cast<Word8>(uAdler16);		// Get the additive checksum
-		Word32 uFactorial = static_cast<Word8>(uAdler16>>8U);	// Get the factorial checksum
-		do {
-			// Get the chunk size to process
-			Word uCount = LARGESTBLOCK;
-			if (uInputLength<LARGESTBLOCK) {
-				// Truncate to the remainder
-				uCount = static_cast<Word>(uInputLength);
-			}
-			// Remove the count from the processed list
-			uInputLength -= uCount;
-			do {
-				// Add to the additive checksum
-				uAdditive += static_cast<const Word8 *>(pInput)[0];
-				pInput = static_cast<const Word8 *>(pInput)+1;
-				// Add the checksum to the factorial
-				uFactorial += uAdditive;
-			} while (--uCount);
-			uAdditive %= LARGESTPRIME;		// Force to fit in a byte
-			uFactorial %= LARGESTPRIME;		// Force to fit in a byte
-		} while (uInputLength);				// All done?
-		// Blend the final 16 bit result
-		uAdler16 = static_cast<Word>((uFactorial<<8U)+uAdditive);
+		uAdler16 = Adler16Kernel(uAdler16,static_cast<const Word8 *>(pInput),uInputLength);
 	}
 	return uAdler16;
 }
-
@@ -19,6 +19,11 @@
 ***************************************/
 
 #include "bradler32.h"
+#include "brcpudispatch.h"
+
+#if defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
 
 #if !defined(DOXYGEN)
 // Note : Do NOT alter these defines or the checksum
@@ -27,6 +32,165 @@
 
 #define LARGESTPRIME 65521U // The largest prime smaller than 65536
 #define LARGESTBLOCK 5552U	// This is the largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1
+
+typedef Word32 (BURGER_API *AdlerProc)(Word32 uAdler32,const Word8 *pInput,WordPtr uInputLength);
+
+//
+// Process a byte at a time
+//
+
+static Word32 BURGER_API Adler32Generic(Word32 uAdler32,const Word8 *pInput,WordPtr uInputLength) BURGER_NOEXCEPT
+{
+	Word32 uAdditive = static_cast<Word16>(uAdler32);	// Get the additive checksum
+	uAdler32 = static_cast<Word16>(uAdler32>>16U);	 	// Get the factorial checksum
+	do {
+		Word uCount = LARGESTBLOCK;						// Assume maximum
+		if (uInputLength<LARGESTBLOCK) {				// Not enough
+			uCount = static_cast<Word>(uInputLength);	// Use the length
+		}
+		// Remove the length
+		uInputLength -= uCount;
+		do {
+			// Add to the additive checksum
+			uAdditive += pInput[0];
+			++pInput;
+			// Add the checksum to the factorial
+			uAdler32 += uAdditive;
+		} while (--uCount);
+		uAdditive %= LARGESTPRIME;	// Force to fit in a short
+		uAdler32 %= LARGESTPRIME;	// Force to fit in a short
+	} while (uInputLength);			// All done?
+	return (uAdler32<<16U)+uAdditive;	// Blend
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+//
+// SIMD versions process 32 byte blocks. For each block, the additive sum
+// is the sum of the bytes (psadbw) and the factorial sum gains 32 times
+// the additive sum from before the block plus the bytes weighted 32 to 1
+// (pmaddubsw). The blocks per pass is capped so the 32 bit lanes can't
+// overflow before the modulo is applied.
+//
+
+static const WordPtr g_uBlockSize = 32U;
+static const WordPtr g_uBlocksPerPass = LARGESTBLOCK/g_uBlockSize;
+
+static BURGER_TARGET_SSSE3 Word32 BURGER_API Adler32SSSE3(Word32 uAdler32,const Word8 *pInput,WordPtr uInputLength) BURGER_NOEXCEPT
+{
+	Word32 uAdditive = static_cast<Word16>(uAdler32);
+	Word32 uFactorial = static_cast<Word16>(uAdler32>>16U);
+	WordPtr uBlocks = uInputLength/g_uBlockSize;
+	uInputLength -= uBlocks*g_uBlockSize;
+
+	const __m128i vTap1 = _mm_setr_epi8(32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17);
+	const __m128i vTap2 = _mm_setr_epi8(16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1);
+	const __m128i vZero = _mm_setzero_si128();
+	const __m128i vOnes = _mm_set1_epi16(1);
+
+	while (uBlocks) {
+		WordPtr uCount = g_uBlocksPerPass;
+		if (uBlocks<uCount) {
+			uCount = uBlocks;
+		}
+		uBlocks -= uCount;
+
+		// Previous additive sums, times 32 at the end
+		__m128i vPrevious = _mm_cvtsi32_si128(static_cast<int>(uAdditive*uCount));
+		__m128i vFactorial = _mm_cvtsi32_si128(static_cast<int>(uFactorial));
+		__m128i vAdditive = vZero;
+		do {
+			__m128i vBytes1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput));
+			__m128i vBytes2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput+16));
+			vPrevious = _mm_add_epi32(vPrevious,vAdditive);
+			vAdditive = _mm_add_epi32(vAdditive,_mm_sad_epu8(vBytes1,vZero));
+			vFactorial = _mm_add_epi32(vFactorial,_mm_madd_epi16(_mm_maddubs_epi16(vBytes1,vTap1),vOnes));
+			vAdditive = _mm_add_epi32(vAdditive,_mm_sad_epu8(vBytes2,vZero));
+			vFactorial = _mm_add_epi32(vFactorial,_mm_madd_epi16(_mm_maddubs_epi16(vBytes2,vTap2),vOnes));
+			pInput += g_uBlockSize;
+		} while (--uCount);
+		vFactorial = _mm_add_epi32(vFactorial,_mm_slli_epi32(vPrevious,5));
+
+		// Sum the lanes
+		vAdditive = _mm_add_epi32(vAdditive,_mm_shuffle_epi32(vAdditive,_MM_SHUFFLE(2,3,0,1)));
+		vAdditive = _mm_add_epi32(vAdditive,_mm_shuffle_epi32(vAdditive,_MM_SHUFFLE(1,0,3,2)));
+		uAdditive += static_cast<Word32>(_mm_cvtsi128_si32(vAdditive));
+		vFactorial = _mm_add_epi32(vFactorial,_mm_shuffle_epi32(vFactorial,_MM_SHUFFLE(2,3,0,1)));
+		vFactorial = _mm_add_epi32(vFactorial,_mm_shuffle_epi32(vFactorial,_MM_SHUFFLE(1,0,3,2)));
+		uFactorial = static_cast<Word32>(_mm_cvtsi128_si32(vFactorial));
+		uAdditive %= LARGESTPRIME;
+		uFactorial %= LARGESTPRIME;
+	}
+	uAdler32 = (uFactorial<<16U)+uAdditive;
+	// Finish the remainder
+	if (uInputLength) {
+		uAdler32 = Adler32Generic(uAdler32,pInput,uInputLength);
+	}
+	return uAdler32;
+}
+
+static BURGER_TARGET_AVX2 Word32 BURGER_API Adler32AVX2(Word32 uAdler32,const Word8 *pInput,WordPtr uInputLength) BURGER_NOEXCEPT
+{
+	Word32 uAdditive = static_cast<Word16>(uAdler32);
+	Word32 uFactorial = static_cast<Word16>(uAdler32>>16U);
+	WordPtr uBlocks = uInputLength/g_uBlockSize;
+	uInputLength -= uBlocks*g_uBlockSize;
+
+	const __m256i vTap = _mm256_setr_epi8(32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17,
+		16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1);
+	const __m256i vZero = _mm256_setzero_si256();
+	const __m256i vOnes = _mm256_set1_epi16(1);
+
+	while (uBlocks) {
+		WordPtr uCount = g_uBlocksPerPass;
+		if (uBlocks<uCount) {
+			uCount = uBlocks;
+		}
+		uBlocks -= uCount;
+
+		__m256i vPrevious = _mm256_setr_epi32(static_cast<int>(uAdditive*uCount),0,0,0,0,0,0,0);
+		__m256i vFactorial = _mm256_setr_epi32(static_cast<int>(uFactorial),0,0,0,0,0,0,0);
+		__m256i vAdditive = vZero;
+		do {
+			__m256i vBytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pInput));
+			vPrevious = _mm256_add_epi32(vPrevious,vAdditive);
+			vAdditive = _mm256_add_epi32(vAdditive,_mm256_sad_epu8(vBytes,vZero));
+			vFactorial = _mm256_add_epi32(vFactorial,_mm256_madd_epi16(_mm256_maddubs_epi16(vBytes,vTap),vOnes));
+			pInput += g_uBlockSize;
+		} while (--uCount);
+		vFactorial = _mm256_add_epi32(vFactorial,_mm256_slli_epi32(vPrevious,5));
+
+		// Sum the lanes
+		__m128i vSum = _mm_add_epi32(_mm256_castsi256_si128(vAdditive),_mm256_extracti128_si256(vAdditive,1));
+		vSum = _mm_add_epi32(vSum,_mm_shuffle_epi32(vSum,_MM_SHUFFLE(2,3,0,1)));
+		vSum = _mm_add_epi32(vSum,_mm_shuffle_epi32(vSum,_MM_SHUFFLE(1,0,3,2)));
+		uAdditive += static_cast<Word32>(_mm_cvtsi128_si32(vSum));
+		vSum = _mm_add_epi32(_mm256_castsi256_si128(vFactorial),_mm256_extracti128_si256(vFactorial,1));
+		vSum = _mm_add_epi32(vSum,_mm_shuffle_epi32(vSum,_MM_SHUFFLE(2,3,0,1)));
+		vSum = _mm_add_epi32(vSum,_mm_shuffle_epi32(vSum,_MM_SHUFFLE(1,0,3,2)));
+		uFactorial = static_cast<Word32>(_mm_cvtsi128_si32(vSum));
+		uAdditive %= LARGESTPRIME;
+		uFactorial %= LARGESTPRIME;
+	}
+	uAdler32 = (uFactorial<<16U)+uAdditive;
+	// Finish the remainder
+	if (uInputLength) {
+		uAdler32 = Adler32Generic(uAdler32,pInput,uInputLength);
+	}
+	return uAdler32;
+}
+
+static const Burger::CPUDispatch::Variant_t g_Adler32Variants[] = {
+	{BURGER_CPU_DISPATCH_PROC(Adler32AVX2),Burger::CPUDispatch::kAVX2,"AVX2"},
+	{BURGER_CPU_DISPATCH_PROC(Adler32SSSE3),Burger::CPUDispatch::kSSSE3,"SSSE3"},
+	{BURGER_CPU_DISPATCH_PROC(Adler32Generic),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_Adler32Dispatch,Burger::CPUDispatch::kFamilyHash,g_Adler32Variants);
+
+#define Adler32Kernel g_Adler32Dispatch.Get<AdlerProc>()
+#else
+#define Adler32Kernel Adler32Generic
+#endif
 #endif
 
 /*! ************************************
@@ -43,6 +207,9 @@
 	The upper 16 bits is a factorial additive checksum based on the
 	additive checksum with a starting value of 0
 
+	On x86 CPUs with SSSE3 or AVX2, 32 bytes are summed at a time with
+	vector instructions. The choice is made by CPUDispatch.
+
 	\param pInput Pointer to a buffer to be checksummed
 	\param uInputLength Number of bytes in the buffer to be checksummed
 	\param uAdler32 Alder-32 from previous calculations or one if a new checksum is desired
@@ -57,26 +224,7 @@ Word32 BURGER_API Burger::CalcAdler32(const void *pInput,WordPtr uInputLength,Wo
 {
 	// Any data to process?
 	if (pInput && uInputLength) {
-		Word32 uAdditive = static_cast<Word16>(uAdler32);	// Get the additive checksum
-		uAdler32 = static_cast<Word16>(uAdler32>>16U);	 	// Get the factorial checksum
-		do {
-			Word uCount = LARGESTBLOCK;						// Assume maximum
-			if (uInputLength<LARGESTBLOCK) {				// Not enough
-				uCount = static_cast<Word>(uInputLength);	// Use the length
-			}
-			// Remove the length
-			uInputLength -= uCount;
-			do {
-				// Add to the additive checksum
-				uAdditive += static_cast<const Word8 *>(pInput)[0];
-				pInput = static_cast<const Word8 *>(pInput)+1;
-				// Add the checksum to the factorial
-				uAdler32 += uAdditive;
-			} while (--uCount);
-			uAdditive %= LARGESTPRIME;	// Force to fit in a short
-			uAdler32 %= LARGESTPRIME;	// Force to fit in a short
-		} while (uInputLength);			// All done?
-		uAdler32 = (uAdler32<<16U)+uAdditive;	// Blend
+		uAdler32 = Adler32Kernel(uAdler32,static_cast<const Word8 *>(pInput),uInputLength);
 	}
 	// Return the result
 	return uAdler32;
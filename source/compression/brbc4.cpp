@@ -0,0 +1,277 @@
+/***************************************
+
+	BC4 decompressor
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brbc4.h"
+#include "brdxt1.h"
+#include "brcpudispatch.h"
+
+#if defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
+
+/*! ************************************
+
+	\struct Burger::Bc4Packet_t
+	\brief Data structure for a BC4 compressed texture block
+
+	This structure is a 1:1 mapping of an 8 byte BC4 encoded
+	data block used by many modern video cards. It holds a single
+	channel for a 4x4 block, encoded the same way as the alpha of
+	a DXT5 block. Only the unsigned variant is supported.
+
+	\sa Burger::Bc5Packet_t and Burger::Dxt5Packet_t
+
+***************************************/
+
+#if !defined(DOXYGEN)
+
+// Decode the 16 intensities of a block
+typedef void (BURGER_API *Bc4ValuesProc)(Word8 *pOutput,const Word8 *pInput);
+
+// Decode a row of blocks into the output bitmap
+typedef void (BURGER_API *Bc4RowProc)(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Burger::Bc4Packet_t *pInput,Word uBlocks);
+
+static void BURGER_API Bc4ValuesGeneric(Word8 *pOutput,const Word8 *pInput)
+{
+	// Build the 8 entry palette, same as DXT5 alpha
+	Word8 Values[8];
+	Word uRed1 = pInput[0];
+	Word uRed2 = pInput[1];
+	Values[0] = static_cast<Word8>(uRed1);
+	Values[1] = static_cast<Word8>(uRed2);
+	if (uRed1<=uRed2) {
+		Values[2] = static_cast<Word8>(((4U*uRed1)+(uRed2))/5U);
+		Values[3] = static_cast<Word8>(((3U*uRed1)+(2U*uRed2))/5U);
+		Values[4] = static_cast<Word8>(((2U*uRed1)+(3U*uRed2))/5U);
+		Values[5] = static_cast<Word8>(((uRed1)+(4U*uRed2))/5U);
+		Values[6] = 0;
+		Values[7] = 255;
+	} else {
+		Values[2] = static_cast<Word8>(((6U*uRed1)+(uRed2))/7U);
+		Values[3] = static_cast<Word8>(((5U*uRed1)+(2U*uRed2))/7U);
+		Values[4] = static_cast<Word8>(((4U*uRed1)+(3U*uRed2))/7U);
+		Values[5] = static_cast<Word8>(((3U*uRed1)+(4U*uRed2))/7U);
+		Values[6] = static_cast<Word8>(((2U*uRed1)+(5U*uRed2))/7U);
+		Values[7] = static_cast<Word8>(((uRed1)+(6U*uRed2))/7U);
+	}
+
+	// Two 24 bit groups of 3 bit indexes, 8 pixels each
+	pInput += 2;
+	Word i = 2;
+	do {
+		Word32 uIndexes = static_cast<Word32>(pInput[0])|(static_cast<Word32>(pInput[1])<<8U)|(static_cast<Word32>(pInput[2])<<16U);
+		Word j = 8;
+		do {
+			pOutput[0] = Values[uIndexes&7U];
+			uIndexes >>= 3U;
+			++pOutput;
+		} while (--j);
+		pInput += 3;
+	} while (--i);
+}
+
+static void BURGER_API Bc4RowGeneric(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Burger::Bc4Packet_t *pInput,Word uBlocks)
+{
+	do {
+		pInput->Decompress(pOutput,uOutputStride);
+		pOutput += 4;
+		++pInput;
+	} while (--uBlocks);
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+//
+// The palette is built with 16 bit multiplies, the divide by 7 or 5
+// is a multiply by 9363/65536 or 13108/65536, which is exact for these
+// ranges. Each 3 bit index is gathered into a 16 bit lane with a byte
+// shuffle, moved to the top of the lane with a multiply and shifted
+// down. The indexes then shuffle the palette.
+//
+
+static BURGER_TARGET_SSSE3 BURGER_INLINE __m128i Bc4LoadValues(const Word8 *pInput)
+{
+	__m128i vBlock = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(pInput));
+	Word uRed1 = pInput[0];
+	Word uRed2 = pInput[1];
+	__m128i vRed1 = _mm_set1_epi16(static_cast<short>(uRed1));
+	__m128i vRed2 = _mm_set1_epi16(static_cast<short>(uRed2));
+	__m128i vPalette;
+	if (uRed1<=uRed2) {
+		vPalette = _mm_add_epi16(_mm_mullo_epi16(vRed1,_mm_setr_epi16(5,0,4,3,2,1,0,0)),
+			_mm_mullo_epi16(vRed2,_mm_setr_epi16(0,5,1,2,3,4,0,0)));
+		vPalette = _mm_mulhi_epu16(vPalette,_mm_set1_epi16(13108));
+		vPalette = _mm_or_si128(vPalette,_mm_setr_epi16(0,0,0,0,0,0,0,255));
+	} else {
+		vPalette = _mm_add_epi16(_mm_mullo_epi16(vRed1,_mm_setr_epi16(7,0,6,5,4,3,2,1)),
+			_mm_mullo_epi16(vRed2,_mm_setr_epi16(0,7,1,2,3,4,5,6)));
+		vPalette = _mm_mulhi_epu16(vPalette,_mm_set1_epi16(9363));
+	}
+	vPalette = _mm_packus_epi16(vPalette,vPalette);
+
+	const __m128i vShifts = _mm_setr_epi16(1<<13,1<<10,1<<7,1<<12,1<<9,1<<6,1<<11,1<<8);
+	__m128i vLow = _mm_shuffle_epi8(vBlock,_mm_setr_epi8(2,3,2,3,2,3,3,4,3,4,3,4,4,-128,4,-128));
+	__m128i vHigh = _mm_shuffle_epi8(vBlock,_mm_setr_epi8(5,6,5,6,5,6,6,7,6,7,6,7,7,-128,7,-128));
+	vLow = _mm_srli_epi16(_mm_mullo_epi16(vLow,vShifts),13);
+	vHigh = _mm_srli_epi16(_mm_mullo_epi16(vHigh,vShifts),13);
+	return _mm_shuffle_epi8(vPalette,_mm_packus_epi16(vLow,vHigh));
+}
+
+static BURGER_TARGET_SSSE3 void BURGER_API Bc4ValuesSSSE3(Word8 *pOutput,const Word8 *pInput)
+{
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput),Bc4LoadValues(pInput));
+}
+
+static BURGER_TARGET_SSSE3 void BURGER_API Bc4RowSSSE3(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Burger::Bc4Packet_t *pInput,Word uBlocks)
+{
+	const __m128i vZero = _mm_setzero_si128();
+	// Blue of zero and alpha of 0xFF
+	const __m128i vAlpha = _mm_set1_epi16(static_cast<short>(0xFF00));
+	do {
+		__m128i vValues = Bc4LoadValues(&pInput->m_uRed1);
+		__m128i vLow = _mm_unpacklo_epi8(vValues,vZero);
+		__m128i vHigh = _mm_unpackhi_epi8(vValues,vZero);
+		Word8 *pRow = reinterpret_cast<Word8 *>(pOutput);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pRow),_mm_unpacklo_epi16(vLow,vAlpha));
+		pRow += uOutputStride;
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pRow),_mm_unpackhi_epi16(vLow,vAlpha));
+		pRow += uOutputStride;
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pRow),_mm_unpacklo_epi16(vHigh,vAlpha));
+		pRow += uOutputStride;
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pRow),_mm_unpackhi_epi16(vHigh,vAlpha));
+		pOutput += 4;
+		++pInput;
+	} while (--uBlocks);
+}
+
+static const Burger::CPUDispatch::Variant_t g_Bc4ValuesVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(Bc4ValuesSSSE3),Burger::CPUDispatch::kSSSE3,"SSSE3"},
+	{BURGER_CPU_DISPATCH_PROC(Bc4ValuesGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_Bc4ValuesDispatch,Burger::CPUDispatch::kFamilyPixel,g_Bc4ValuesVariants);
+#define Bc4Values g_Bc4ValuesDispatch.Get<Bc4ValuesProc>()
+
+static const Burger::CPUDispatch::Variant_t g_Bc4RowVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(Bc4RowSSSE3),Burger::CPUDispatch::kSSSE3,"SSSE3"},
+	{BURGER_CPU_DISPATCH_PROC(Bc4RowGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_Bc4RowDispatch,Burger::CPUDispatch::kFamilyPixel,g_Bc4RowVariants);
+#define Bc4Row g_Bc4RowDispatch.Get<Bc4RowProc>()
+#else
+#define Bc4Values Bc4ValuesGeneric
+#define Bc4Row Bc4RowGeneric
+#endif
+
+//
+// Wrappers so DecompressDxtImage() can decode BC4 blocks
+//
+
+static void BURGER_API DecompressBc4Row(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const void *pInput,Word uBlocks)
+{
+	Bc4Row(pOutput,uOutputStride,static_cast<const Burger::Bc4Packet_t *>(pInput),uBlocks);
+}
+
+static void BURGER_API DecompressBc4Block(Burger::RGBAWord8_t *pOutput,const void *pInput)
+{
+	static_cast<const Burger::Bc4Packet_t *>(pInput)->Decompress(pOutput);
+}
+
+#endif
+
+/*! ************************************
+
+	\brief Decompress the intensities of a 4x4 block compressed with BC4
+
+	Given an 8 byte block of BC4 compressed data, extract the sixteen
+	8 bit values in rows of four.
+
+	On x86 CPUs, an SSSE3 version is selected by CPUDispatch.
+
+	\param pOutput Pointer to an array of sixteen bytes
+
+	\sa Decompress(RGBAWord8_t *,WordPtr) const
+
+***************************************/
+
+void Burger::Bc4Packet_t::Decompress(Word8 *pOutput) const
+{
+	Bc4Values(pOutput,&m_uRed1);
+}
+
+/*! ************************************
+
+	\brief Decompress a single 4x4 block compressed with BC4
+
+	Given an 8 byte block of BC4 compressed data, extract the 4x4 RGBA
+	color block. The value is stored in red, green and blue are
+	zero and alpha is 0xFF, which is how the video card samples it.
+
+	\param pOutput Pointer to the start of an array of sixteen \ref RGBAWord8_t encoded 32 bit
+	pixels
+	\param uStride Byte width of each scan line for the block of uncompressed data. The default
+	is sizeof(\ref RGBAWord8_t)*4 to create a single array of 16 RGBAWord8_t pixels in a linear row.
+
+	\sa Decompress(Word8 *) const
+
+***************************************/
+
+void Burger::Bc4Packet_t::Decompress(RGBAWord8_t *pOutput,WordPtr uStride) const
+{
+	Word8 Values[16];
+	Bc4Values(Values,&m_uRed1);
+	const Word8 *pValues = Values;
+	Word i = 4;
+	do {
+		Word j = 0;
+		do {
+			pOutput[j].m_uRed = pValues[j];
+			pOutput[j].m_uGreen = 0;
+			pOutput[j].m_uBlue = 0;
+			pOutput[j].m_uAlpha = 255;
+		} while (++j<4);
+		pValues += 4;
+		pOutput = reinterpret_cast<RGBAWord8_t *>(reinterpret_cast<Word8 *>(pOutput)+uStride);
+	} while (--i);
+}
+
+/*! ************************************
+
+	\brief Decompress an array of 4x4 block compressed with BC4
+
+	Given an array of 8 byte blocks of BC4 compressed data, extract the 4x4 RGBA
+	color blocks into a bit map.
+
+	Whole blocks are decoded directly into the output, so pOutput can point
+	into a larger strided buffer, such as a locked texture. On x86 CPUs,
+	an SSSE3 version is selected by CPUDispatch.
+
+	\note This function will handle clipping if the destination bitmap is not divisible by
+	four in the width or height
+
+	\param pOutput Pointer to the start of a bitmap in the size of uWidth and uHeight \ref RGBAWord8_t encoded 32 bit
+	pixels.
+	\param uOutputStride Number of bytes per scan line of the output bit map (Usually it's uWidth*4)
+	\param uWidth Width of the output bitmap in pixels
+	\param uHeight Height of the output bitmap in pixels
+	\param pInput Pointer to a matching bitmap of BC4 compressed pixels
+	\param uInputStride Byte width of each scan line for the block of compressed data. (Usually it's ((uWidth+3)/4)*8)
+	\param uThreadCount Maximum number of threads to use
+
+	\sa DecompressDxtImage() or Bc4Packet_t::Decompress(RGBAWord8_t *,WordPtr) const
+
+***************************************/
+
+void BURGER_API Burger::DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Bc4Packet_t *pInput,WordPtr uInputStride,Word uThreadCount)
+{
+	DecompressDxtImage(pOutput,uOutputStride,uWidth,uHeight,pInput,uInputStride,sizeof(Bc4Packet_t),DecompressBc4Row,DecompressBc4Block,uThreadCount);
+}
@@ -0,0 +1,38 @@
+/***************************************
+
+	BC4 decompressor
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRBC4_H__
+#define __BRBC4_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRPALETTE_H__
+#include "brpalette.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+struct Bc4Packet_t {
+	Word8 m_uRed1;					///< First endpoint in 8 bit intensity
+	Word8 m_uRed2;					///< Second endpoint in 8 bit intensity
+	Word8 m_uRedIndexes[2][3];		///< Two 24 bit little endian values that contain 3 bits per pixel indexes for the 4x4 tile
+	void Decompress(Word8 *pOutput) const;
+	void Decompress(RGBAWord8_t *pOutput,WordPtr uStride = sizeof(RGBAWord8_t)*4) const;
+};
+extern void BURGER_API DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Bc4Packet_t *pInput,WordPtr uInputStride,Word uThreadCount = 1);
+}
+/* END */
+
+#endif
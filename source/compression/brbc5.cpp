@@ -0,0 +1,174 @@
+/***************************************
+
+	BC5 decompressor
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brbc5.h"
+#include "brdxt1.h"
+#include "brcpudispatch.h"
+
+#if defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
+
+/*! ************************************
+
+	\struct Burger::Bc5Packet_t
+	\brief Data structure for a BC5 compressed texture block
+
+	This structure is a 1:1 mapping of a 16 byte BC5 encoded
+	data block used by many modern video cards. It's two BC4
+	blocks, the first is the red channel and the second is
+	green. It's usually used for normal maps, where the blue
+	channel is calculated from the other two by the shader.
+
+	\sa Burger::Bc4Packet_t
+
+***************************************/
+
+#if !defined(DOXYGEN)
+
+// Decode a row of blocks into the output bitmap
+typedef void (BURGER_API *Bc5RowProc)(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Burger::Bc5Packet_t *pInput,Word uBlocks);
+
+static void BURGER_API Bc5RowGeneric(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Burger::Bc5Packet_t *pInput,Word uBlocks)
+{
+	do {
+		pInput->Decompress(pOutput,uOutputStride);
+		pOutput += 4;
+		++pInput;
+	} while (--uBlocks);
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+//
+// The channels are decoded by the BC4 decoder and interleaved
+//
+
+static BURGER_TARGET_SSE2 void BURGER_API Bc5RowSSE2(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Burger::Bc5Packet_t *pInput,Word uBlocks)
+{
+	// Blue of zero and alpha of 0xFF
+	const __m128i vAlpha = _mm_set1_epi16(static_cast<short>(0xFF00));
+	do {
+		BURGER_ALIGN(Word8,Red[16],16);
+		BURGER_ALIGN(Word8,Green[16],16);
+		pInput->m_Red.Decompress(Red);
+		pInput->m_Green.Decompress(Green);
+		__m128i vRed = _mm_load_si128(reinterpret_cast<const __m128i *>(Red));
+		__m128i vGreen = _mm_load_si128(reinterpret_cast<const __m128i *>(Green));
+		__m128i vLow = _mm_unpacklo_epi8(vRed,vGreen);
+		__m128i vHigh = _mm_unpackhi_epi8(vRed,vGreen);
+		Word8 *pRow = reinterpret_cast<Word8 *>(pOutput);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pRow),_mm_unpacklo_epi16(vLow,vAlpha));
+		pRow += uOutputStride;
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pRow),_mm_unpackhi_epi16(vLow,vAlpha));
+		pRow += uOutputStride;
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pRow),_mm_unpacklo_epi16(vHigh,vAlpha));
+		pRow += uOutputStride;
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pRow),_mm_unpackhi_epi16(vHigh,vAlpha));
+		pOutput += 4;
+		++pInput;
+	} while (--uBlocks);
+}
+
+static const Burger::CPUDispatch::Variant_t g_Bc5RowVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(Bc5RowSSE2),Burger::CPUDispatch::kSSE2,"SSE2"},
+	{BURGER_CPU_DISPATCH_PROC(Bc5RowGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_Bc5RowDispatch,Burger::CPUDispatch::kFamilyPixel,g_Bc5RowVariants);
+#define Bc5Row g_Bc5RowDispatch.Get<Bc5RowProc>()
+#else
+#define Bc5Row Bc5RowGeneric
+#endif
+
+//
+// Wrappers so DecompressDxtImage() can decode BC5 blocks
+//
+
+static void BURGER_API DecompressBc5Row(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const void *pInput,Word uBlocks)
+{
+	Bc5Row(pOutput,uOutputStride,static_cast<const Burger::Bc5Packet_t *>(pInput),uBlocks);
+}
+
+static void BURGER_API DecompressBc5Block(Burger::RGBAWord8_t *pOutput,const void *pInput)
+{
+	static_cast<const Burger::Bc5Packet_t *>(pInput)->Decompress(pOutput);
+}
+
+#endif
+
+/*! ************************************
+
+	\brief Decompress a single 4x4 block compressed with BC5
+
+	Given a 16 byte block of BC5 compressed data, extract the 4x4 RGBA
+	color block. Blue is zero and alpha is 0xFF, which is how the
+	video card samples it.
+
+	\param pOutput Pointer to the start of an array of sixteen \ref RGBAWord8_t encoded 32 bit
+	pixels
+	\param uStride Byte width of each scan line for the block of uncompressed data. The default
+	is sizeof(\ref RGBAWord8_t)*4 to create a single array of 16 RGBAWord8_t pixels in a linear row.
+
+***************************************/
+
+void Burger::Bc5Packet_t::Decompress(RGBAWord8_t *pOutput,WordPtr uStride) const
+{
+	Word8 Red[16];
+	Word8 Green[16];
+	m_Red.Decompress(Red);
+	m_Green.Decompress(Green);
+	Word i = 0;
+	do {
+		Word j = 0;
+		do {
+			pOutput[j].m_uRed = Red[i+j];
+			pOutput[j].m_uGreen = Green[i+j];
+			pOutput[j].m_uBlue = 0;
+			pOutput[j].m_uAlpha = 255;
+		} while (++j<4);
+		pOutput = reinterpret_cast<RGBAWord8_t *>(reinterpret_cast<Word8 *>(pOutput)+uStride);
+		i += 4;
+	} while (i<16);
+}
+
+/*! ************************************
+
+	\brief Decompress an array of 4x4 block compressed with BC5
+
+	Given an array of 16 byte blocks of BC5 compressed data, extract the 4x4 RGBA
+	color blocks into a bit map.
+
+	Whole blocks are decoded directly into the output, so pOutput can point
+	into a larger strided buffer, such as a locked texture. On x86 CPUs,
+	an SSE2 version is selected by CPUDispatch.
+
+	\note This function will handle clipping if the destination bitmap is not divisible by
+	four in the width or height
+
+	\param pOutput Pointer to the start of a bitmap in the size of uWidth and uHeight \ref RGBAWord8_t encoded 32 bit
+	pixels.
+	\param uOutputStride Number of bytes per scan line of the output bit map (Usually it's uWidth*4)
+	\param uWidth Width of the output bitmap in pixels
+	\param uHeight Height of the output bitmap in pixels
+	\param pInput Pointer to a matching bitmap of BC5 compressed pixels
+	\param uInputStride Byte width of each scan line for the block of compressed data. (Usually it's ((uWidth+3)/4)*16)
+	\param uThreadCount Maximum number of threads to use
+
+	\sa DecompressDxtImage() or Bc5Packet_t::Decompress(RGBAWord8_t *,WordPtr) const
+
+***************************************/
+
+void BURGER_API Burger::DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Bc5Packet_t *pInput,WordPtr uInputStride,Word uThreadCount)
+{
+	DecompressDxtImage(pOutput,uOutputStride,uWidth,uHeight,pInput,uInputStride,sizeof(Bc5Packet_t),DecompressBc5Row,DecompressBc5Block,uThreadCount);
+}
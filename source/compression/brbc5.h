@@ -0,0 +1,36 @@
+/***************************************
+
+	BC5 decompressor
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRBC5_H__
+#define __BRBC5_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRBC4_H__
+#include "brbc4.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+struct Bc5Packet_t {
+	Bc4Packet_t m_Red;				///< Red channel, compressed the same way as BC4
+	Bc4Packet_t m_Green;			///< Green channel, compressed the same way as BC4
+	void Decompress(RGBAWord8_t *pOutput,WordPtr uStride = sizeof(RGBAWord8_t)*4) const;
+};
+extern void BURGER_API DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Bc5Packet_t *pInput,WordPtr uInputStride,Word uThreadCount = 1);
+}
+/* END */
+
+#endif
@@ -0,0 +1,497 @@
+/***************************************
+
+	BC7 decompressor
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brbc7.h"
+#include "brdxt1.h"
+#include "brendian.h"
+#include "brmemoryfunctions.h"
+#include "brcpudispatch.h"
+
+#if defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
+
+/*! ************************************
+
+	\struct Burger::Bc7Packet_t
+	\brief Data structure for a BC7 compressed texture block
+
+	This structure is a 1:1 mapping of a 16 byte BC7 encoded
+	data block used by many modern video cards. The block is a
+	little endian bit stream. The lowest set bit of the first
+	byte selects one of eight modes, which differ in the number of
+	subsets, the precision of the endpoints and indexes and how
+	alpha is stored.
+
+	\sa Burger::Dxt5Packet_t
+
+***************************************/
+
+#if !defined(DOXYGEN)
+
+//
+// Layout of each of the eight modes
+//
+
+struct Bc7Mode_t {
+	Word8 m_uSubsets;			// Number of subsets with their own endpoints
+	Word8 m_uPartitionBits;		// Bits for the partition number
+	Word8 m_uRotationBits;		// Bits to swap alpha with a color channel
+	Word8 m_uIndexSelectionBits;	// Bits to swap the color and alpha indexes
+	Word8 m_uColorBits;			// Bits per color endpoint component
+	Word8 m_uAlphaBits;			// Bits per alpha endpoint, zero for opaque
+	Word8 m_uEndpointPBits;		// TRUE if each endpoint has a low bit
+	Word8 m_uSharedPBits;		// TRUE if each subset has a shared low bit
+	Word8 m_uIndexBits;			// Bits per primary index
+	Word8 m_uIndexBits2;		// Bits per secondary index, zero if none
+};
+
+static const Bc7Mode_t g_Bc7Modes[8] = {
+	{3,4,0,0,4,0,1,0,3,0},
+	{2,6,0,0,6,0,0,1,3,0},
+	{3,6,0,0,5,0,0,0,2,0},
+	{2,6,0,0,7,0,1,0,2,0},
+	{1,0,2,1,5,6,0,0,2,3},
+	{1,0,2,0,7,8,0,0,2,2},
+	{1,0,0,0,7,7,1,0,4,0},
+	{2,6,0,0,5,5,1,0,2,0}
+};
+
+// Subset of each pixel for the 2 subset partitions, one bit per pixel
+static const Word16 g_Bc7Partitions2[64] = {
+	0xCCCC,0x8888,0xEEEE,0xECC8,0xC880,0xFEEC,0xFEC8,0xEC80,
+	0xC800,0xFFEC,0xFE80,0xE800,0xFFE8,0xFF00,0xFFF0,0xF000,
+	0xF710,0x008E,0x7100,0x08CE,0x008C,0x7310,0x3100,0x8CCE,
+	0x088C,0x3110,0x6666,0x366C,0x17E8,0x0FF0,0x718E,0x399C,
+	0xAAAA,0xF0F0,0x5A5A,0x33CC,0x3C3C,0x55AA,0x9696,0xA55A,
+	0x73CE,0x13C8,0x324C,0x3BDC,0x6996,0xC33C,0x9966,0x0660,
+	0x0272,0x04E4,0x4E40,0x2720,0xC936,0x936C,0x39C6,0x639C,
+	0x9336,0x9CC6,0x817E,0xE718,0xCCF0,0x0FCC,0x7744,0xEE22
+};
+
+// Subset of each pixel for the 3 subset partitions, two bits per pixel
+static const Word32 g_Bc7Partitions3[64] = {
+	0xAA685050,0x6A5A5040,0x5A5A4200,0x5450A0A8,0xA5A50000,0xA0A05050,0x5555A0A0,0x5A5A5050,
+	0xAA550000,0xAA555500,0xAAAA5500,0x90909090,0x94949494,0xA4A4A4A4,0xA9A59450,0x2A0A4250,
+	0xA5945040,0x0A425054,0xA5A5A500,0x55A0A0A0,0xA8A85454,0x6A6A4040,0xA4A45000,0x1A1A0500,
+	0x0050A4A4,0xAAA59090,0x14696914,0x69691400,0xA08585A0,0xAA821414,0x50A4A450,0x6A5A0200,
+	0xA9A58000,0x5090A0A8,0xA8A09050,0x24242424,0x00AA5500,0x24924924,0x24499224,0x50A50A50,
+	0x500AA550,0xAAAA4444,0x66660000,0xA5A0A5A0,0x50A050A0,0x69286928,0x44AAAA44,0x66666600,
+	0xAA444444,0x54A854A8,0x95809580,0x96969600,0xA85454A8,0x80959580,0xAA141414,0x96960000,
+	0xAAAA1414,0xA05050A0,0xA0A5A5A0,0x96000000,0x40804080,0xA9A8A9A8,0xAAAAAA44,0x2A4A5254
+};
+
+// Pixel of the second subset that has an implied high index bit of zero
+static const Word8 g_Bc7Anchors2[64] = {
+	15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,
+	15, 2, 8, 2, 2, 8, 8,15, 2, 8, 2, 2, 8, 8, 2, 2,
+	15,15, 6, 8, 2, 8,15,15, 2, 8, 2, 2, 2,15,15, 6,
+	 6, 2, 6, 8,15,15, 2, 2,15,15,15,15,15, 2, 2,15
+};
+
+// Anchor pixels of the second and third subsets of 3 subset partitions
+static const Word8 g_Bc7Anchors3[2][64] = {{
+	 3, 3,15,15, 8, 3,15,15, 8, 8, 6, 6, 6, 5, 3, 3,
+	 3, 3, 8,15, 3, 3, 6,10, 5, 8, 8, 6, 8, 5,15,15,
+	 8,15, 3, 5, 6,10, 8,15,15, 3,15, 5,15,15,15,15,
+	 3,15, 5, 5, 5, 8, 5,10, 5,10, 8,13,15,12, 3, 3
+},{
+	15, 8, 8, 3,15,15, 3, 8,15,15,15,15,15,15,15, 8,
+	15, 8,15, 3,15, 8,15, 8, 3,15, 6,10,15,15,10, 8,
+	15, 3,15,10,10, 8, 9,10, 6,15, 8,15, 3, 6, 6, 8,
+	15, 3,15,15,15,15,15,15,15,15,15,15, 3,15,15, 8
+}};
+
+// Interpolation weights in 1/64ths for 2, 3 and 4 bit indexes
+static const Word8 g_Bc7Weights2[4] = {0,21,43,64};
+static const Word8 g_Bc7Weights3[8] = {0,9,18,27,37,46,55,64};
+static const Word8 g_Bc7Weights4[16] = {0,4,9,13,17,21,26,30,34,38,43,47,51,55,60,64};
+
+//
+// A block with the bit stream decoded, ready to be interpolated
+//
+
+struct Bc7Unpacked_t {
+	Word32 m_Endpoints[3][2];	// RGBA endpoints for each subset
+	Word8 m_Subsets[16];		// Subset of each pixel
+	Word8 m_Weights[16][4];		// Weight of the second endpoint for each pixel and channel
+};
+
+// Interpolate the pixels of an unpacked block
+typedef void (BURGER_API *Bc7InterpolateProc)(Burger::RGBAWord8_t *pOutput,WordPtr uStride,const Bc7Unpacked_t *pUnpacked);
+
+//
+// Read bits from the 128 bit little endian stream
+//
+
+struct Bc7Bits_t {
+	Word64 m_uLow;				// First 64 bits of the block
+	Word64 m_uHigh;				// Last 64 bits of the block
+	Word m_uPosition;			// Bit to read next
+};
+
+static Word BURGER_API Bc7GetBits(Bc7Bits_t *pBits,Word uCount)
+{
+	Word uPosition = pBits->m_uPosition;
+	pBits->m_uPosition = uPosition+uCount;
+	Word64 uValue;
+	if (uPosition>=64) {
+		uValue = pBits->m_uHigh>>(uPosition-64);
+	} else {
+		uValue = pBits->m_uLow>>uPosition;
+		if (uPosition && ((uPosition+uCount)>64)) {
+			uValue |= pBits->m_uHigh<<(64-uPosition);
+		}
+	}
+	return static_cast<Word>(uValue)&((1U<<uCount)-1U);
+}
+
+//
+// Expand an endpoint component to 8 bits by replicating the high bits
+//
+
+static BURGER_INLINE Word Bc7Expand(Word uValue,Word uBits)
+{
+	uValue <<= (8-uBits);
+	return uValue|(uValue>>uBits);
+}
+
+//
+// Decode the bit stream, returns FALSE for the reserved mode
+//
+
+static Word BURGER_API Bc7Unpack(Bc7Unpacked_t *pUnpacked,const Word8 *pInput)
+{
+	Word uModeByte = pInput[0];
+	if (!uModeByte) {
+		return FALSE;
+	}
+	Word uMode = 0;
+	while (!(uModeByte&(1U<<uMode))) {
+		++uMode;
+	}
+	const Bc7Mode_t *pMode = &g_Bc7Modes[uMode];
+
+	Bc7Bits_t Bits;
+	Bits.m_uLow = Burger::LittleEndian::LoadAny(reinterpret_cast<const Word64 *>(pInput));
+	Bits.m_uHigh = Burger::LittleEndian::LoadAny(reinterpret_cast<const Word64 *>(pInput+8));
+	Bits.m_uPosition = uMode+1;
+	Word uPartition = Bc7GetBits(&Bits,pMode->m_uPartitionBits);
+	Word uRotation = Bc7GetBits(&Bits,pMode->m_uRotationBits);
+	Word uIndexSelection = Bc7GetBits(&Bits,pMode->m_uIndexSelectionBits);
+
+	// Endpoints are stored as all the reds, then greens, blues and alphas
+	Word uSubsets = pMode->m_uSubsets;
+	Word uEndpointCount = uSubsets*2;
+	Word Endpoints[6][4];
+	Word uBits = pMode->m_uColorBits;
+	Word i = 0;
+	do {
+		Word j = 0;
+		do {
+			Endpoints[j][i] = Bc7GetBits(&Bits,uBits);
+		} while (++j<uEndpointCount);
+	} while (++i<3);
+	Word uAlphaBits = pMode->m_uAlphaBits;
+	i = 0;
+	do {
+		Endpoints[i][3] = uAlphaBits ? Bc7GetBits(&Bits,uAlphaBits) : 255U;
+	} while (++i<uEndpointCount);
+
+	// Append the low bits, if any
+	if (pMode->m_uEndpointPBits || pMode->m_uSharedPBits) {
+		Word PBits[6];
+		if (pMode->m_uEndpointPBits) {
+			i = 0;
+			do {
+				PBits[i] = Bc7GetBits(&Bits,1);
+			} while (++i<uEndpointCount);
+		} else {
+			i = 0;
+			do {
+				PBits[i*2] = PBits[(i*2)+1] = Bc7GetBits(&Bits,1);
+			} while (++i<uSubsets);
+		}
+		i = 0;
+		do {
+			Word j = 0;
+			do {
+				Endpoints[i][j] = (Endpoints[i][j]<<1U)|PBits[i];
+			} while (++j<3);
+			if (uAlphaBits) {
+				Endpoints[i][3] = (Endpoints[i][3]<<1U)|PBits[i];
+			}
+		} while (++i<uEndpointCount);
+		++uBits;
+		if (uAlphaBits) {
+			++uAlphaBits;
+		}
+	}
+
+	// Expand to 8 bits
+	i = 0;
+	do {
+		Word j = 0;
+		do {
+			Endpoints[i][j] = Bc7Expand(Endpoints[i][j],uBits);
+		} while (++j<3);
+		if (uAlphaBits) {
+			Endpoints[i][3] = Bc7Expand(Endpoints[i][3],uAlphaBits);
+		}
+	} while (++i<uEndpointCount);
+
+	// Alpha is swapped with a color channel after interpolation,
+	// so swap the endpoints now and the weights later
+	if (uRotation) {
+		i = 0;
+		do {
+			Word uTemp = Endpoints[i][uRotation-1];
+			Endpoints[i][uRotation-1] = Endpoints[i][3];
+			Endpoints[i][3] = uTemp;
+		} while (++i<uEndpointCount);
+	}
+	i = 0;
+	do {
+		pUnpacked->m_Endpoints[i>>1U][i&1U] = static_cast<Word32>(Endpoints[i][0])|(static_cast<Word32>(Endpoints[i][1])<<8U)|
+			(static_cast<Word32>(Endpoints[i][2])<<16U)|(static_cast<Word32>(Endpoints[i][3])<<24U);
+	} while (++i<uEndpointCount);
+
+	// Find the subset and the anchors
+	Word uAnchor2 = 0;
+	Word uAnchor3 = 0;
+	i = 0;
+	if (uSubsets==1) {
+		do {
+			pUnpacked->m_Subsets[i] = 0;
+		} while (++i<16);
+	} else if (uSubsets==2) {
+		Word uMask = g_Bc7Partitions2[uPartition];
+		do {
+			pUnpacked->m_Subsets[i] = static_cast<Word8>((uMask>>i)&1U);
+		} while (++i<16);
+		uAnchor2 = g_Bc7Anchors2[uPartition];
+	} else {
+		Word32 uMask = g_Bc7Partitions3[uPartition];
+		do {
+			pUnpacked->m_Subsets[i] = static_cast<Word8>((uMask>>(i*2))&3U);
+		} while (++i<16);
+		uAnchor2 = g_Bc7Anchors3[0][uPartition];
+		uAnchor3 = g_Bc7Anchors3[1][uPartition];
+	}
+
+	// Anchor pixels have one less bit since the high bit is always zero
+	Word uIndexBits = pMode->m_uIndexBits;
+	const Word8 *pWeights = (uIndexBits==2) ? g_Bc7Weights2 : ((uIndexBits==3) ? g_Bc7Weights3 : g_Bc7Weights4);
+	Word8 ColorWeights[16];
+	i = 0;
+	do {
+		Word uCount = uIndexBits;
+		if (!i || (i==uAnchor2) || (i==uAnchor3)) {
+			--uCount;
+		}
+		ColorWeights[i] = pWeights[Bc7GetBits(&Bits,uCount)];
+	} while (++i<16);
+
+	// Modes 4 and 5 have a second set of indexes for alpha
+	const Word8 *pAlphaWeights = ColorWeights;
+	Word8 AlphaWeights[16];
+	Word uIndexBits2 = pMode->m_uIndexBits2;
+	if (uIndexBits2) {
+		pWeights = (uIndexBits2==2) ? g_Bc7Weights2 : g_Bc7Weights3;
+		i = 0;
+		do {
+			AlphaWeights[i] = pWeights[Bc7GetBits(&Bits,i ? uIndexBits2 : uIndexBits2-1)];
+		} while (++i<16);
+		pAlphaWeights = AlphaWeights;
+	}
+	const Word8 *pColorWeights = ColorWeights;
+	if (uIndexSelection) {
+		pColorWeights = pAlphaWeights;
+		pAlphaWeights = ColorWeights;
+	}
+
+	i = 0;
+	do {
+		Word8 *pOutput = pUnpacked->m_Weights[i];
+		pOutput[0] = pColorWeights[i];
+		pOutput[1] = pColorWeights[i];
+		pOutput[2] = pColorWeights[i];
+		pOutput[3] = pAlphaWeights[i];
+		if (uRotation) {
+			pOutput[3] = pColorWeights[i];
+			pOutput[uRotation-1] = pAlphaWeights[i];
+		}
+	} while (++i<16);
+	return TRUE;
+}
+
+static void BURGER_API Bc7InterpolateGeneric(Burger::RGBAWord8_t *pOutput,WordPtr uStride,const Bc7Unpacked_t *pUnpacked)
+{
+	const Word8 *pSubsets = pUnpacked->m_Subsets;
+	const Word8 (*pWeights)[4] = pUnpacked->m_Weights;
+	Word i = 4;
+	do {
+		Word j = 0;
+		do {
+			const Word32 *pEndpoints = pUnpacked->m_Endpoints[pSubsets[j]];
+			Word32 uFirst = pEndpoints[0];
+			Word32 uSecond = pEndpoints[1];
+			Word8 *pPixel = reinterpret_cast<Word8 *>(&pOutput[j]);
+			Word k = 0;
+			do {
+				Word uWeight = pWeights[j][k];
+				pPixel[k] = static_cast<Word8>((((64U-uWeight)*(uFirst&0xFFU))+(uWeight*(uSecond&0xFFU))+32U)>>6U);
+				uFirst >>= 8U;
+				uSecond >>= 8U;
+			} while (++k<4);
+		} while (++j<4);
+		pSubsets += 4;
+		pWeights += 4;
+		pOutput = reinterpret_cast<Burger::RGBAWord8_t *>(reinterpret_cast<Word8 *>(pOutput)+uStride);
+	} while (--i);
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+//
+// Interpolate a row of four pixels at a time in 16 bit lanes
+//
+
+static BURGER_TARGET_SSE2 void BURGER_API Bc7InterpolateSSE2(Burger::RGBAWord8_t *pOutput,WordPtr uStride,const Bc7Unpacked_t *pUnpacked)
+{
+	const __m128i vZero = _mm_setzero_si128();
+	const __m128i v64 = _mm_set1_epi16(64);
+	const __m128i vRound = _mm_set1_epi16(32);
+	const Word8 *pSubsets = pUnpacked->m_Subsets;
+	Word8 *pRow = reinterpret_cast<Word8 *>(pOutput);
+	Word i = 0;
+	do {
+		const Word32 (*pEndpoints)[2] = pUnpacked->m_Endpoints;
+		__m128i vFirst = _mm_setr_epi32(static_cast<int>(pEndpoints[pSubsets[0]][0]),static_cast<int>(pEndpoints[pSubsets[1]][0]),
+			static_cast<int>(pEndpoints[pSubsets[2]][0]),static_cast<int>(pEndpoints[pSubsets[3]][0]));
+		__m128i vSecond = _mm_setr_epi32(static_cast<int>(pEndpoints[pSubsets[0]][1]),static_cast<int>(pEndpoints[pSubsets[1]][1]),
+			static_cast<int>(pEndpoints[pSubsets[2]][1]),static_cast<int>(pEndpoints[pSubsets[3]][1]));
+		__m128i vWeights = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pUnpacked->m_Weights[i]));
+
+		__m128i vWeight = _mm_unpacklo_epi8(vWeights,vZero);
+		__m128i vLow = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(v64,vWeight),_mm_unpacklo_epi8(vFirst,vZero)),
+			_mm_mullo_epi16(vWeight,_mm_unpacklo_epi8(vSecond,vZero)));
+		vWeight = _mm_unpackhi_epi8(vWeights,vZero);
+		__m128i vHigh = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(v64,vWeight),_mm_unpackhi_epi8(vFirst,vZero)),
+			_mm_mullo_epi16(vWeight,_mm_unpackhi_epi8(vSecond,vZero)));
+		vLow = _mm_srli_epi16(_mm_add_epi16(vLow,vRound),6);
+		vHigh = _mm_srli_epi16(_mm_add_epi16(vHigh,vRound),6);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pRow),_mm_packus_epi16(vLow,vHigh));
+		pSubsets += 4;
+		pRow += uStride;
+		i += 4;
+	} while (i<16);
+}
+
+static const Burger::CPUDispatch::Variant_t g_Bc7InterpolateVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(Bc7InterpolateSSE2),Burger::CPUDispatch::kSSE2,"SSE2"},
+	{BURGER_CPU_DISPATCH_PROC(Bc7InterpolateGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_Bc7InterpolateDispatch,Burger::CPUDispatch::kFamilyPixel,g_Bc7InterpolateVariants);
+#define Bc7Interpolate g_Bc7InterpolateDispatch.Get<Bc7InterpolateProc>()
+#else
+#define Bc7Interpolate Bc7InterpolateGeneric
+#endif
+
+//
+// Wrappers so DecompressDxtImage() can decode BC7 blocks
+//
+
+static void BURGER_API DecompressBc7Row(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const void *pInput,Word uBlocks)
+{
+	const Burger::Bc7Packet_t *pPacket = static_cast<const Burger::Bc7Packet_t *>(pInput);
+	Bc7InterpolateProc pInterpolate = Bc7Interpolate;
+	do {
+		Bc7Unpacked_t Unpacked;
+		if (Bc7Unpack(&Unpacked,pPacket->m_uData)) {
+			pInterpolate(pOutput,uOutputStride,&Unpacked);
+		} else {
+			pPacket->Decompress(pOutput,uOutputStride);
+		}
+		pOutput += 4;
+		++pPacket;
+	} while (--uBlocks);
+}
+
+static void BURGER_API DecompressBc7Block(Burger::RGBAWord8_t *pOutput,const void *pInput)
+{
+	static_cast<const Burger::Bc7Packet_t *>(pInput)->Decompress(pOutput);
+}
+
+#endif
+
+/*! ************************************
+
+	\brief Decompress a single 4x4 block compressed with BC7
+
+	Given a 16 byte block of BC7 compressed data, extract the 4x4 RGBA
+	color block. Blocks with the reserved mode decode as transparent black.
+
+	The interpolation uses SSE2 on x86 CPUs, chosen by CPUDispatch.
+
+	\param pOutput Pointer to the start of an array of sixteen \ref RGBAWord8_t encoded 32 bit
+	pixels
+	\param uStride Byte width of each scan line for the block of uncompressed data. The default
+	is sizeof(\ref RGBAWord8_t)*4 to create a single array of 16 RGBAWord8_t pixels in a linear row.
+
+***************************************/
+
+void Burger::Bc7Packet_t::Decompress(RGBAWord8_t *pOutput,WordPtr uStride) const
+{
+	Bc7Unpacked_t Unpacked;
+	if (Bc7Unpack(&Unpacked,m_uData)) {
+		Bc7Interpolate(pOutput,uStride,&Unpacked);
+	} else {
+		Word i = 4;
+		do {
+			MemoryClear(pOutput,sizeof(RGBAWord8_t)*4);
+			pOutput = reinterpret_cast<RGBAWord8_t *>(reinterpret_cast<Word8 *>(pOutput)+uStride);
+		} while (--i);
+	}
+}
+
+/*! ************************************
+
+	\brief Decompress an array of 4x4 block compressed with BC7
+
+	Given an array of 16 byte blocks of BC7 compressed data, extract the 4x4 RGBA
+	color blocks into a bit map.
+
+	Whole blocks are decoded directly into the output, so pOutput can point
+	into a larger strided buffer, such as a locked texture.
+
+	\note This function will handle clipping if the destination bitmap is not divisible by
+	four in the width or height
+
+	\param pOutput Pointer to the start of a bitmap in the size of uWidth and uHeight \ref RGBAWord8_t encoded 32 bit
+	pixels.
+	\param uOutputStride Number of bytes per scan line of the output bit map (Usually it's uWidth*4)
+	\param uWidth Width of the output bitmap in pixels
+	\param uHeight Height of the output bitmap in pixels
+	\param pInput Pointer to a matching bitmap of BC7 compressed pixels
+	\param uInputStride Byte width of each scan line for the block of compressed data. (Usually it's ((uWidth+3)/4)*16)
+	\param uThreadCount Maximum number of threads to use
+
+	\sa DecompressDxtImage() or Bc7Packet_t::Decompress(RGBAWord8_t *,WordPtr) const
+
+***************************************/
+
+void BURGER_API Burger::DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Bc7Packet_t *pInput,WordPtr uInputStride,Word uThreadCount)
+{
+	DecompressDxtImage(pOutput,uOutputStride,uWidth,uHeight,pInput,uInputStride,sizeof(Bc7Packet_t),DecompressBc7Row,DecompressBc7Block,uThreadCount);
+}
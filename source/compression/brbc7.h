@@ -0,0 +1,35 @@
+/***************************************
+
+	BC7 decompressor
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRBC7_H__
+#define __BRBC7_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRPALETTE_H__
+#include "brpalette.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+struct Bc7Packet_t {
+	Word8 m_uData[16];				///< 128 bit little endian block, the low bits select one of eight modes
+	void Decompress(RGBAWord8_t *pOutput,WordPtr uStride = sizeof(RGBAWord8_t)*4) const;
+};
+extern void BURGER_API DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Bc7Packet_t *pInput,WordPtr uInputStride,Word uThreadCount = 1);
+}
+/* END */
+
+#endif
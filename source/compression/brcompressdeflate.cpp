@@ -15,6 +15,9 @@
 #include "brcompressdeflate.h"
 #include "bradler32.h"
 #include "brstringfunctions.h"
+#include "brglobalmemorymanager.h"
+#include "brcriticalsection.h"
+#include "brendian.h"
 
 #if !defined(DOXYGEN)
 BURGER_CREATE_STATICRTTI_PARENT(Burger::CompressDeflate,Burger::Compress);
@@ -287,6 +290,26 @@ const Burger::CompressDeflate::StaticTreeDesc_t Burger::CompressDeflate::g_Stati
 	NULL,g_ExtraBitLengthBits,0,BL_CODES, MAX_BL_BITS
 };
 
+//
+// Values for max_lazy_match, good_match, nice_match and max_chain_length
+// for each compression level, same as zlib. Levels 1-3 use a greedy
+// matcher, 4-9 use lazy matching.
+//
+
+const Burger::CompressDeflate::Config_t Burger::CompressDeflate::g_ConfigurationTable[10] = {
+	//  good lazy nice chain
+	{0,   0,   0,    0,&Burger::CompressDeflate::DeflateStored},	// 0 store only
+	{4,   4,   8,    4,&Burger::CompressDeflate::DeflateFast},	// 1 max speed, no lazy matches
+	{4,   5,  16,    8,&Burger::CompressDeflate::DeflateFast},	// 2
+	{4,   6,  32,   32,&Burger::CompressDeflate::DeflateFast},	// 3
+	{4,   4,  16,   16,&Burger::CompressDeflate::DeflateSlow},	// 4 lazy matches
+	{8,  16,  32,   32,&Burger::CompressDeflate::DeflateSlow},	// 5
+	{8,  16, 128,  128,&Burger::CompressDeflate::DeflateSlow},	// 6
+	{8,  32, 128,  256,&Burger::CompressDeflate::DeflateSlow},	// 7
+	{32,128, 258, 1024,&Burger::CompressDeflate::DeflateSlow},	// 8
+	{32,258, 258, 4096,&Burger::CompressDeflate::DeflateSlow}	// 9 max compression
+};
+
 /*! ************************************
 
 	\brief Insert a 16 bit value in the output stream in Big Endian order
@@ -1093,32 +1116,34 @@ void Burger::CompressDeflate::FlushBlock(const Word8 *buf,Word32 stored_len,Word
     int max_blindex = 0;  /* index of last bit length code of non zero freq */
 
     /* Build the Huffman trees unless a stored block is forced */
+	if (m_uLevel) {
+		 /* Check if the file is ascii or binary */
+		if (m_eDataType == Z_UNKNOWN) {
+			SetDataType();
+		}
+		/* Construct the literal and distance trees */
+		BuildTree(&m_LiteralDescription);
 
-	 /* Check if the file is ascii or binary */
-	if (m_eDataType == Z_UNKNOWN) {
-		SetDataType();
-	}
-	/* Construct the literal and distance trees */
-	BuildTree(&m_LiteralDescription);
-
-	BuildTree(&m_DistanceDescription);
-	/* At this point, opt_len and static_len are the total bit lengths of
-	 * the compressed block data, excluding the tree representations.
-	 */
-
-	/* Build the bit length tree for the above two trees, and get the index
-	 * in bl_order of the last bit length code to send.
-	 */
-	max_blindex = BuildBitLengthTree();
+		BuildTree(&m_DistanceDescription);
+		/* At this point, opt_len and static_len are the total bit lengths of
+		 * the compressed block data, excluding the tree representations.
+		 */
 
-	/* Determine the best encoding. Compute first the block length in bytes*/
-	opt_lenb = (m_uOptimalLength+3+7)>>3;
-	static_lenb = (m_uStaticLength+3+7)>>3;
+		/* Build the bit length tree for the above two trees, and get the index
+		 * in bl_order of the last bit length code to send.
+		 */
+		max_blindex = BuildBitLengthTree();
 
+		/* Determine the best encoding. Compute first the block length in bytes*/
+		opt_lenb = (m_uOptimalLength+3+7)>>3;
+		static_lenb = (m_uStaticLength+3+7)>>3;
 
-	if (static_lenb <= opt_lenb) {
-		opt_lenb = static_lenb;
-    }
+		if (static_lenb <= opt_lenb) {
+			opt_lenb = static_lenb;
+		}
+	} else {
+		opt_lenb = static_lenb = stored_len + 5; /* force a stored block */
+	}
 
     if (stored_len+4 <= opt_lenb && buf != NULL) {
                        /* 4: two words for the lengths */
@@ -1182,12 +1207,12 @@ void Burger::CompressDeflate::FlushPending(void)
 
 Word Burger::CompressDeflate::LongestMatch(Word cur_match)
 {
-    unsigned chain_length = c_uMaxChainLength;/* max hash chain length */
+    unsigned chain_length = m_uMaxChainLength;/* max hash chain length */
     Word8 *scan = m_Window + m_uStringStart; /* current string */
     Word8 *match;                       /* matched string */
     int len;                           /* length of current match */
     int best_len = static_cast<int>(m_uPreviousLength);              /* best match length so far */
-    int nice_match = c_iNiceMatch;             /* stop if match long enough */
+    int nice_match = static_cast<int>(m_uNiceMatch);             /* stop if match long enough */
     Word limit = m_uStringStart > (Word)(c_uWSize-MIN_LOOKAHEAD) ?
         m_uStringStart - (Word)(c_uWSize-MIN_LOOKAHEAD) : 0;
     /* Stop when cur_match becomes <= limit. To simplify the code,
@@ -1209,7 +1234,7 @@ Word Burger::CompressDeflate::LongestMatch(Word cur_match)
      */
 
     /* Do not waste too much time if we already have a good match: */
-    if (m_uPreviousLength >= c_uGoodMatch) {
+    if (m_uPreviousLength >= m_uGoodMatch) {
         chain_length >>= 2;
     }
     /* Do not look for matches beyond the end of the input. This is necessary
@@ -1268,6 +1293,139 @@ Word Burger::CompressDeflate::LongestMatch(Word cur_match)
     return m_uLookAhead;
 }
 
+/* ===========================================================================
+ * Copy without compression as much as possible from the input stream, return
+ * the current block state.
+ * This function does not insert new strings in the dictionary since
+ * uncompressible data is probably not useful. This function is used
+ * only for the level=0 compression option.
+ */
+Burger::CompressDeflate::eBlockState Burger::CompressDeflate::DeflateStored(int flush)
+{
+    /* Stored blocks are limited to 0xffff bytes, pending_buf is limited
+     * to pending_buf_size, and each stored block has a 5 byte header:
+     */
+    Word32 max_block_size = 0xffff;
+    if (max_block_size > c_uPendingBufferSize - 5) {
+        max_block_size = c_uPendingBufferSize - 5;
+    }
+
+    /* Copy as much as possible from input to output: */
+    for (;;) {
+        /* Fill the window as much as possible: */
+        if (m_uLookAhead <= 1) {
+            FillWindow();
+            if (m_uLookAhead == 0 && flush == Z_NO_FLUSH) {
+                return STATE_NEEDMORE;
+            }
+            if (m_uLookAhead == 0) break; /* flush the current block */
+        }
+        m_uStringStart += m_uLookAhead;
+        m_uLookAhead = 0;
+
+        /* Emit a stored block if pending_buf will be full: */
+        Word32 max_start = static_cast<Word32>(m_iBlockStart) + max_block_size;
+        if (m_uStringStart == 0 || m_uStringStart >= max_start) {
+            /* strstart == 0 is possible when wraparound on 16-bit machine */
+            m_uLookAhead = m_uStringStart - max_start;
+            m_uStringStart = max_start;
+            FlushBlock(0);
+        }
+        /* Flush if we may have to slide, otherwise block_start may become
+         * negative and the data will be gone:
+         */
+        if (m_uStringStart - static_cast<Word>(m_iBlockStart) >= (c_uWSize-MIN_LOOKAHEAD)) {
+            FlushBlock(0);
+        }
+    }
+    FlushBlock(flush == Z_FINISH);
+    return flush == Z_FINISH ? STATE_FINISHDONE : STATE_BLOCKDONE;
+}
+
+/* ===========================================================================
+ * Compress as much as possible from the input stream, return the current
+ * block state.
+ * This function does not perform lazy evaluation of matches and inserts
+ * new strings in the dictionary only for unmatched strings or for short
+ * matches. It is used only for the fast compression options.
+ */
+Burger::CompressDeflate::eBlockState Burger::CompressDeflate::DeflateFast(int flush)
+{
+    Word hash_head = 0;    /* head of the hash chain */
+    int bflush;            /* set if current block must be flushed */
+
+    for (;;) {
+        /* Make sure that we always have enough lookahead, except
+         * at the end of the input file. We need MAX_MATCH bytes
+         * for the next match, plus MIN_MATCH bytes to insert the
+         * string following the next match.
+         */
+        if (m_uLookAhead < MIN_LOOKAHEAD) {
+            FillWindow();
+            if (m_uLookAhead < MIN_LOOKAHEAD && flush == Z_NO_FLUSH) {
+                return STATE_NEEDMORE;
+            }
+            if (m_uLookAhead == 0) break; /* flush the current block */
+        }
+
+        /* Insert the string window[strstart .. strstart+2] in the
+         * dictionary, and set hash_head to the head of the hash chain:
+         */
+        if (m_uLookAhead >= MIN_MATCH) {
+            hash_head = InsertString(m_uStringStart);
+        }
+
+        /* Find the longest match, discarding those <= prev_length.
+         * At this point we have always match_length < MIN_MATCH
+         */
+        if (hash_head != 0 && m_uStringStart - hash_head <= (c_uWSize-MIN_LOOKAHEAD)) {
+            /* To simplify the code, we prevent matches with the string
+             * of window index 0 (in particular we have to avoid a match
+             * of the string with itself at the start of the input file).
+             */
+            m_uMatchLength = LongestMatch(hash_head);
+            /* longest_match() sets match_start */
+        }
+        if (m_uMatchLength >= MIN_MATCH) {
+            bflush = static_cast<int>(TallyDistance(m_uStringStart - m_uMatchStart,m_uMatchLength - MIN_MATCH));
+
+            m_uLookAhead -= m_uMatchLength;
+
+            /* Insert new strings in the hash table only if the match length
+             * is not too large. This saves time but degrades compression.
+             */
+            if (m_uMatchLength <= m_uMaxLazyMatch && m_uLookAhead >= MIN_MATCH) {
+                m_uMatchLength--; /* string at strstart already in hash table */
+                do {
+                    m_uStringStart++;
+                    hash_head = InsertString(m_uStringStart);
+                    /* strstart never exceeds WSIZE-MAX_MATCH, so there are
+                     * always MIN_MATCH bytes ahead.
+                     */
+                } while (--m_uMatchLength != 0);
+                m_uStringStart++;
+            } else {
+                m_uStringStart += m_uMatchLength;
+                m_uMatchLength = 0;
+                m_uInsertHash = UpdateHash(m_Window[m_uStringStart],m_Window[m_uStringStart+1]);
+                /* If lookahead < MIN_MATCH, ins_h is garbage, but it does not
+                 * matter since it will be recomputed at next deflate call.
+                 */
+            }
+        } else {
+            /* No match, output a literal byte */
+            bflush = static_cast<int>(TallyLiteral(m_Window[m_uStringStart]));
+            m_uLookAhead--;
+            m_uStringStart++;
+        }
+        if (bflush) {
+            FlushBlock(0);
+        }
+    }
+    FlushBlock(flush == Z_FINISH);
+    return flush == Z_FINISH ? STATE_FINISHDONE : STATE_BLOCKDONE;
+}
+
 /* ===========================================================================
  * Same as above, but achieves better compression. We use a lazy
  * evaluation for matches: a match is finally adopted only if there is
@@ -1306,7 +1464,7 @@ Burger::CompressDeflate::eBlockState Burger::CompressDeflate::DeflateSlow(int fl
 		m_uPreviousMatch = m_uMatchStart;
         m_uMatchLength = MIN_MATCH-1;
 
-        if (hash_head != 0 && m_uPreviousLength < c_uMaxLazyMatch &&
+        if (hash_head != 0 && m_uPreviousLength < m_uMaxLazyMatch &&
             m_uStringStart - hash_head <= (c_uWSize-MIN_LOOKAHEAD)) {
             /* To simplify the code, we prevent matches with the string
              * of window index 0 (in particular we have to avoid a match
@@ -1430,6 +1588,12 @@ void Burger::CompressDeflate::LongestMatchInit(void)
 
     /* Set the default configuration parameters:
      */
+	const Config_t *pConfig = &g_ConfigurationTable[m_uLevel];
+	m_uMaxLazyMatch = pConfig->m_uMaxLazy;
+	m_uGoodMatch = pConfig->m_uGoodLength;
+	m_uNiceMatch = pConfig->m_uNiceLength;
+	m_uMaxChainLength = pConfig->m_uMaxChain;
+	m_pDeflate = pConfig->m_pDeflate;
 
 	m_uStringStart = 0;
 	m_iBlockStart = 0L;
@@ -1515,6 +1679,68 @@ int Burger::CompressDeflate::DeflateInit(void)
     return DeflateReset();
 }
 
+/* ===========================================================================
+ * Create the two byte zlib stream header for the current compression level
+ */
+Word Burger::CompressDeflate::ZLibHeader(Word bDictionary) const
+{
+	Word header = (Z_DEFLATED + ((c_uWBits-8)<<4)) << 8;
+	Word level_flags;
+	if (m_uLevel < 2) {
+		level_flags = 0;
+	} else if (m_uLevel < 6) {
+		level_flags = 1;
+	} else if (m_uLevel == 6) {
+		level_flags = 2;
+	} else {
+		level_flags = 3;
+	}
+	header |= (level_flags << 6);
+	if (bDictionary) header |= PRESET_DICT;
+	header += 31 - (header % 31);
+	return header;
+}
+
+/* ===========================================================================
+ * Initializes the compression dictionary from the given byte sequence
+ * without producing any compressed output. Only the last MAX_DIST bytes
+ * are used, since older data can't be referenced.
+ */
+void Burger::CompressDeflate::DeflateSetDictionary(const Word8 *pDictionary,WordPtr uLength)
+{
+	if (!m_bNoHeader) {
+		m_uAdler = CalcAdler32(pDictionary,uLength,m_uAdler);
+	}
+	if (uLength < MIN_MATCH) {
+		return;
+	}
+	if (uLength > (c_uWSize-MIN_LOOKAHEAD)) {
+		pDictionary += uLength - (c_uWSize-MIN_LOOKAHEAD);
+		uLength = c_uWSize-MIN_LOOKAHEAD; /* use the tail of the dictionary */
+	}
+	MemoryCopy(m_Window,pDictionary,uLength);
+	m_uStringStart = static_cast<Word>(uLength);
+	m_iBlockStart = static_cast<IntPtr>(uLength);
+
+	/* Insert dictionary into window and hash
+	 */
+	m_uInsertHash = UpdateHash(m_Window[0],m_Window[1]);
+	Word n = 0;
+	do {
+		InsertString(n);
+	} while (++n <= (uLength - MIN_MATCH));
+}
+
+/* ===========================================================================
+ * Prime a new stream with the preset dictionary, if there is one
+ */
+void Burger::CompressDeflate::DeflateInitDictionary(void)
+{
+	if (m_uDictionaryLength) {
+		DeflateSetDictionary(m_pDictionary,m_uDictionaryLength);
+	}
+}
+
 /* ========================================================================= */
 int Burger::CompressDeflate::PerformDeflate(int flush)
 {
@@ -1534,13 +1760,7 @@ int Burger::CompressDeflate::PerformDeflate(int flush)
 	/* Write the zlib header */
 	if (m_eState == INIT_STATE) {
 
-		Word header = (Z_DEFLATED + ((c_uWBits-8)<<4)) << 8;
-		Word level_flags = (Z_BEST_COMPRESSION-1) >> 1;
-
-		if (level_flags > 3) level_flags = 3;
-		header |= (level_flags << 6);
-		if (m_uStringStart != 0) header |= PRESET_DICT;
-		header += 31 - (header % 31);
+		Word header = ZLibHeader(m_uStringStart != 0);
 
 		m_eState = BUSY_STATE;
 		OutputBigEndian16(header);
@@ -1577,7 +1797,7 @@ int Burger::CompressDeflate::PerformDeflate(int flush)
 		(flush != Z_NO_FLUSH && m_eState != FINISH_STATE)) {
 		eBlockState bstate;
 
-		bstate = DeflateSlow(flush);
+		bstate = (this->*m_pDeflate)(flush);
 
 		if (bstate == STATE_FINISHSTARTED || bstate == STATE_FINISHDONE) {
 			m_eState = FINISH_STATE;
@@ -1626,17 +1846,133 @@ int Burger::CompressDeflate::PerformDeflate(int flush)
 
 	\brief Default constructor
 
-	Initializes the cache buffer.
+	Initializes the cache buffer. Data is compressed
+	with \ref Z_BEST_COMPRESSION.
 
 ***************************************/
 
 Burger::CompressDeflate::CompressDeflate() :
 	Compress(),
-	m_bInitialized(FALSE)
+	m_pDictionary(NULL),
+	m_uDictionaryLength(0),
+	m_bInitialized(FALSE),
+	m_uLevel(Z_BEST_COMPRESSION)
 {
 	m_uSignature = Signature;
 }
 
+/*! ************************************
+
+	\brief Constructor with a compression level
+
+	Initializes the cache buffer and sets the compression level.
+
+	\param uLevel Compression level from \ref Z_NO_COMPRESSION to \ref Z_BEST_COMPRESSION
+	\sa SetLevel(Word)
+
+***************************************/
+
+Burger::CompressDeflate::CompressDeflate(Word uLevel) :
+	Compress(),
+	m_pDictionary(NULL),
+	m_uDictionaryLength(0),
+	m_bInitialized(FALSE),
+	m_uLevel(Z_BEST_COMPRESSION)
+{
+	m_uSignature = Signature;
+	SetLevel(uLevel);
+}
+
+/*! ************************************
+
+	\brief Set the compression level
+
+	Levels follow zlib. Level 0 stores the data without compression,
+	levels 1 through 3 use a greedy matcher that takes the first
+	match that is long enough and levels 4 through 9 use lazy matching
+	with progressively longer hash chain searches. Level 9 is the default.
+
+	The new level takes effect on the next call to Init() and values
+	above 9 are clamped to 9.
+
+	\param uLevel Compression level from \ref Z_NO_COMPRESSION to \ref Z_BEST_COMPRESSION
+	\sa GetLevel(void) const
+
+***************************************/
+
+void BURGER_API Burger::CompressDeflate::SetLevel(Word uLevel)
+{
+	if (uLevel>Z_BEST_COMPRESSION) {
+		uLevel = Z_BEST_COMPRESSION;
+	}
+	m_uLevel = uLevel;
+}
+
+/*! ************************************
+
+	\fn Word Burger::CompressDeflate::GetLevel(void) const
+	\brief Get the compression level
+
+	\return Compression level from \ref Z_NO_COMPRESSION to \ref Z_BEST_COMPRESSION
+	\sa SetLevel(Word)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Set a preset dictionary
+
+	Small buffers compress poorly because there is no history
+	for matches to reference. A dictionary of data that's typical
+	for the input, such as one made by TrainDeflateDictionary(),
+	is loaded into the window before compression starts, so
+	even the first bytes can be matched.
+
+	The zlib header of the output is flagged with \ref PRESET_DICT
+	and the Adler32 of the dictionary, so DecompressDeflate can
+	find the same dictionary to decompress it. Only the last
+	32K of the dictionary is used.
+
+	The data is not copied, it must remain valid while
+	compressing. The dictionary takes effect on the next call
+	to Init(). Pass \ref NULL or a zero length to compress
+	without a dictionary.
+
+	\param pDictionary Pointer to the dictionary
+	\param uLength Size of the dictionary in bytes
+	\sa DecompressDeflate::AddDictionary(const void *,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::CompressDeflate::SetDictionary(const void *pDictionary,WordPtr uLength)
+{
+	if (!pDictionary) {
+		uLength = 0;
+	}
+	m_pDictionary = static_cast<const Word8 *>(pDictionary);
+	m_uDictionaryLength = uLength;
+}
+
+/*! ************************************
+
+	\fn const void *Burger::CompressDeflate::GetDictionary(void) const
+	\brief Get the preset dictionary
+
+	\return Pointer to the preset dictionary or \ref NULL if none
+	\sa SetDictionary(const void *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::CompressDeflate::GetDictionaryLength(void) const
+	\brief Get the size of the preset dictionary
+
+	\return Size in bytes of the preset dictionary, zero if none
+	\sa SetDictionary(const void *,WordPtr)
+
+***************************************/
+
 /*! ************************************
 
 	\brief Reset the RLE compressor
@@ -1649,6 +1985,7 @@ Burger::Compress::eError Burger::CompressDeflate::Init(void)
 {
 	m_Output.Clear();
 	if (DeflateInit()==Z_OK) {
+		DeflateInitDictionary();
 		return Compress::COMPRESS_OKAY;
 	}
 	return Compress::COMPRESS_OUTOFMEMORY;
@@ -1669,6 +2006,7 @@ Burger::Compress::eError Burger::CompressDeflate::Process(const void *pInput,Wor
 		if (DeflateInit()!=Z_OK) {
 			return Compress::COMPRESS_OUTOFMEMORY;
 		}
+		DeflateInitDictionary();
 	}
 	eError Error = COMPRESS_OKAY;
 	if (uInputLength) {
@@ -1703,6 +2041,415 @@ Burger::Compress::eError Burger::CompressDeflate::Finalize(void)
 	return COMPRESS_OKAY;
 }
 
+#if !defined(DOXYGEN)
+
+// Maximum number of threads for CompressParallel()
+static const Word g_uMaxDeflateThreads = 16;
+
+//
+// Each thread compresses every m_uBlockStep'th block starting
+// with m_uFirstBlock using its own compressor
+//
+
+struct Burger::CompressDeflate::ParallelJob_t {
+	CompressDeflate *m_pEngine;		// Compressor for this thread
+	const Word8 *m_pInput;			// Start of the data to compress
+	WordPtr m_uInputLength;			// Size of the data to compress
+	WordPtr m_uBlockSize;			// Size of each block
+	WordPtr m_uBlockCount;			// Number of blocks in the input
+	WordPtr m_uFirstBlock;			// First block for this thread
+	WordPtr m_uBlockStep;			// Number of threads
+	Word8 **m_ppOutputs;			// Compressed data for each block
+	WordPtr *m_pOutputLengths;		// Size of the compressed data for each block
+};
+
+#endif
+
+/*! ************************************
+
+	\brief Compress the blocks assigned to a thread
+
+	Each block is compressed as raw deflate data primed with the
+	32K of input that precedes it. Every block but the last one ends
+	with a sync flush so it stops on a byte boundary and the blocks
+	can be concatenated into a single stream.
+
+	\param pData Pointer to a ParallelJob_t
+	\return Zero
+
+***************************************/
+
+WordPtr BURGER_API Burger::CompressDeflate::ParallelThread(void *pData)
+{
+	ParallelJob_t *pJob = static_cast<ParallelJob_t *>(pData);
+	CompressDeflate *pEngine = pJob->m_pEngine;
+	WordPtr uBlock = pJob->m_uFirstBlock;
+	while (uBlock<pJob->m_uBlockCount) {
+		WordPtr uStart = uBlock*pJob->m_uBlockSize;
+		WordPtr uLength = pJob->m_uInputLength-uStart;
+		Word bLast = (uLength<=pJob->m_uBlockSize);
+		if (!bLast) {
+			uLength = pJob->m_uBlockSize;
+		}
+
+		pEngine->m_Output.Clear();
+		pEngine->DeflateInit();
+		// Raw deflate data, the zlib header and trailer are written by the caller
+		pEngine->m_bNoHeader = 1;
+		pEngine->m_eState = BUSY_STATE;
+
+		// Allow matches to reach back into the previous block
+		if (uStart) {
+			WordPtr uDictionary = (uStart<c_uWSize) ? uStart : c_uWSize;
+			pEngine->DeflateSetDictionary(pJob->m_pInput+(uStart-uDictionary),uDictionary);
+		} else {
+			// The first block starts with the preset dictionary
+			pEngine->DeflateInitDictionary();
+		}
+		pEngine->m_pInput = pJob->m_pInput+uStart;
+		pEngine->m_uInputLength = uLength;
+		pEngine->PerformDeflate(bLast ? Z_FINISH : Z_SYNC_FLUSH);
+		pEngine->m_bInitialized = FALSE;
+		pJob->m_ppOutputs[uBlock] = static_cast<Word8 *>(pEngine->m_Output.Flatten(&pJob->m_pOutputLengths[uBlock]));
+		uBlock += pJob->m_uBlockStep;
+	}
+	return 0;
+}
+
+/*! ************************************
+
+	\brief Compress a buffer using several threads
+
+	Compress an entire buffer in a single call, replacing the
+	calls to Init(), Process() and Finalize(). The input is split
+	into blocks of uBlockSize bytes that are compressed
+	independently on up to uThreadCount threads and stitched
+	together into one zlib stream that DecompressDeflate, or any
+	other inflater, can decode.
+
+	Each block is primed with the last 32K of the block before it,
+	so matches can still cross the splits and the loss in compression
+	is only a few bytes per block for the flush markers. The output
+	is the same regardless of the number of threads used.
+	The first block is primed with the preset dictionary, if one
+	was set with SetDictionary(const void *,WordPtr).
+
+	The compression level set with SetLevel(Word) is used. The
+	compressed data is retrieved with GetOutput() as usual.
+
+	\param pInput Pointer to the data to compress
+	\param uInputLength Number of bytes to compress
+	\param uThreadCount Maximum number of threads to use
+	\param uBlockSize Number of bytes in each block, minimum of 32K
+	\return \ref COMPRESS_OKAY or \ref COMPRESS_OUTOFMEMORY
+
+***************************************/
+
+Burger::Compress::eError BURGER_API Burger::CompressDeflate::CompressParallel(const void *pInput,WordPtr uInputLength,Word uThreadCount,WordPtr uBlockSize)
+{
+	// Empty input is handled by the streaming compressor
+	if (!uInputLength) {
+		eError Error = Init();
+		if (Error==COMPRESS_OKAY) {
+			Error = Finalize();
+		}
+		return Error;
+	}
+
+	m_Output.Clear();
+	// Force Process() to start a new stream if called after this
+	m_bInitialized = FALSE;
+
+	if (uBlockSize<c_uWSize) {
+		uBlockSize = c_uWSize;
+	}
+	WordPtr uBlockCount = ((uInputLength-1)/uBlockSize)+1;
+	if (uThreadCount>uBlockCount) {
+		uThreadCount = static_cast<Word>(uBlockCount);
+	}
+	if (uThreadCount>g_uMaxDeflateThreads) {
+		uThreadCount = g_uMaxDeflateThreads;
+	}
+	if (!uThreadCount) {
+		uThreadCount = 1;
+	}
+
+	// Allocate the output records and a compressor for each thread
+	eError Error = COMPRESS_OUTOFMEMORY;
+	Word8 **ppOutputs = static_cast<Word8 **>(AllocClear(uBlockCount*(sizeof(Word8 *)+sizeof(WordPtr))));
+	if (ppOutputs) {
+		WordPtr *pOutputLengths = reinterpret_cast<WordPtr *>(ppOutputs+uBlockCount);
+		ParallelJob_t Jobs[g_uMaxDeflateThreads];
+		Word uJobCount = 0;
+		do {
+			void *pMemory = Alloc(sizeof(CompressDeflate));
+			if (!pMemory) {
+				break;
+			}
+			ParallelJob_t *pJob = &Jobs[uJobCount];
+			pJob->m_pEngine = new (pMemory) CompressDeflate(m_uLevel);
+			pJob->m_pEngine->SetDictionary(m_pDictionary,m_uDictionaryLength);
+			pJob->m_pInput = static_cast<const Word8 *>(pInput);
+			pJob->m_uInputLength = uInputLength;
+			pJob->m_uBlockSize = uBlockSize;
+			pJob->m_uBlockCount = uBlockCount;
+			pJob->m_uFirstBlock = uJobCount;
+			pJob->m_uBlockStep = uThreadCount;
+			pJob->m_ppOutputs = ppOutputs;
+			pJob->m_pOutputLengths = pOutputLengths;
+		} while (++uJobCount<uThreadCount);
+
+		if (uJobCount==uThreadCount) {
+			RunThreadJobs(ParallelThread,Jobs,sizeof(ParallelJob_t),uJobCount);
+
+			// Stitch the blocks together into a zlib stream
+			Error = COMPRESS_OKAY;
+			// The dictionary is only flagged if it was actually used
+			if (m_uDictionaryLength>=MIN_MATCH) {
+				m_Output.BigEndianAppend(static_cast<Word16>(ZLibHeader(TRUE)));
+				m_Output.BigEndianAppend(CalcAdler32(m_pDictionary,m_uDictionaryLength));
+			} else {
+				m_Output.BigEndianAppend(static_cast<Word16>(ZLibHeader(FALSE)));
+			}
+			WordPtr i = 0;
+			do {
+				if (!ppOutputs[i]) {
+					Error = COMPRESS_OUTOFMEMORY;
+					break;
+				}
+				m_Output.Append(ppOutputs[i],pOutputLengths[i]);
+			} while (++i<uBlockCount);
+			m_Output.BigEndianAppend(CalcAdler32(pInput,uInputLength));
+			if (m_Output.GetError()) {
+				Error = COMPRESS_OUTOFMEMORY;
+			}
+		}
+
+		// Release everything
+		while (uJobCount) {
+			--uJobCount;
+			Delete(Jobs[uJobCount].m_pEngine);
+		}
+		WordPtr i = 0;
+		do {
+			Free(ppOutputs[i]);
+		} while (++i<uBlockCount);
+		Free(ppOutputs);
+	}
+	if (Error!=COMPRESS_OKAY) {
+		m_Output.Clear();
+	}
+	return Error;
+}
+
+#if !defined(DOXYGEN)
+
+// Bytes hashed to find strings shared between samples
+static const WordPtr g_uTrainMatchSize = 6;
+// Bytes of sample data copied into the dictionary at a time
+static const WordPtr g_uTrainSegmentSize = 64;
+// Size of the string frequency table
+static const Word g_uTrainHashBits = 18;
+
+// Segment picked for the dictionary
+struct TrainSegment_t {
+	const Word8 *m_pData;		// Start of the segment in the sample
+	Word32 m_uScore;			// Value of the strings in the segment
+};
+
+static BURGER_INLINE Word TrainHash(const Word8 *pInput)
+{
+	Word32 uHash = (Burger::NativeEndian::LoadAny(reinterpret_cast<const Word32 *>(pInput))*0x9E3779B1U)^
+		(static_cast<Word32>(Burger::NativeEndian::LoadAny(reinterpret_cast<const Word16 *>(pInput+4)))*0x85EBCA6BU);
+	return static_cast<Word>(uHash>>(32U-g_uTrainHashBits));
+}
+
+// Add up the value of every string in a segment
+static Word32 TrainScore(const Word32 *pWeights,const Word8 *pInput)
+{
+	Word32 uScore = 0;
+	WordPtr i = g_uTrainSegmentSize-g_uTrainMatchSize+1;
+	do {
+		uScore += pWeights[TrainHash(pInput)];
+		++pInput;
+	} while (--i);
+	return uScore;
+}
+
+#endif
+
+/*! ************************************
+
+	\brief Build a preset dictionary from sample data
+
+	Given a set of small buffers that are typical of the data that
+	will be compressed, such as a collection of JSON, XML or script
+	files, build a dictionary for SetDictionary(const void *,WordPtr)
+	and DecompressDeflate::AddDictionary(const void *,WordPtr).
+
+	Every six byte string in the samples is counted once per sample it
+	appears in, strings that only appear in one sample have no value.
+	The samples are then split into as many equal sized ranges as
+	there are 64 byte segments in the dictionary, and the segment in
+	each range that holds the most valuable strings is copied into
+	the dictionary. Once picked, those strings are no longer counted,
+	so the same text isn't copied twice.
+
+	The segments are stored with the most valuable ones at the end
+	of the dictionary, since they are the closest to the data being
+	compressed and will have the shortest match distances.
+
+	\note Samples shorter than 64 bytes contribute to the string counts
+	but are not copied into the dictionary.
+
+	\param pOutput Buffer to receive the dictionary
+	\param uOutputSize Size of the buffer, only \ref c_uMaxDictionarySize bytes can be used
+	\param ppSamples Pointer to an array of pointers to the samples
+	\param pSampleLengths Pointer to an array with the size of each sample in bytes
+	\param uSampleCount Number of samples
+	\return Size of the dictionary in bytes, zero if one couldn't be built
+
+	\sa SetDictionary(const void *,WordPtr)
+
+***************************************/
+
+WordPtr BURGER_API Burger::CompressDeflate::TrainDictionary(void *pOutput,WordPtr uOutputSize,const void * const *ppSamples,const WordPtr *pSampleLengths,WordPtr uSampleCount)
+{
+	if (uOutputSize>c_uMaxDictionarySize) {
+		uOutputSize = c_uMaxDictionarySize;
+	}
+	WordPtr uSegmentCount = uOutputSize/g_uTrainSegmentSize;
+	WordPtr uTotal = 0;
+	WordPtr i = 0;
+	while (i<uSampleCount) {
+		uTotal += pSampleLengths[i];
+		++i;
+	}
+	if (!uSegmentCount || (uTotal<g_uTrainSegmentSize)) {
+		return 0;
+	}
+
+	// Weights of each string and the last sample each string was found in
+	Word32 *pWeights = static_cast<Word32 *>(AllocClear((sizeof(Word32)*2)<<g_uTrainHashBits));
+	if (!pWeights) {
+		return 0;
+	}
+	TrainSegment_t *pSegments = static_cast<TrainSegment_t *>(Alloc(sizeof(TrainSegment_t)*uSegmentCount));
+	if (!pSegments) {
+		Free(pWeights);
+		return 0;
+	}
+	Word32 *pLastSample = pWeights+(1U<<g_uTrainHashBits);
+
+	// Count the number of samples each string appears in
+	i = 0;
+	while (i<uSampleCount) {
+		WordPtr uLength = pSampleLengths[i];
+		if (uLength>=g_uTrainMatchSize) {
+			const Word8 *pInput = static_cast<const Word8 *>(ppSamples[i]);
+			Word32 uMark = static_cast<Word32>(i+1);
+			uLength -= g_uTrainMatchSize-1;
+			do {
+				Word uHash = TrainHash(pInput);
+				if (pLastSample[uHash]!=uMark) {
+					pLastSample[uHash] = uMark;
+					++pWeights[uHash];
+				}
+				++pInput;
+			} while (--uLength);
+		}
+		++i;
+	}
+	// A string in only one sample is worthless
+	Word j = 0;
+	do {
+		if (pWeights[j]) {
+			--pWeights[j];
+		}
+	} while (++j<(1U<<g_uTrainHashBits));
+
+	// Pick the best segment from each range of the samples
+	WordPtr uEpochLength = uTotal/uSegmentCount;
+	if (uEpochLength<g_uTrainSegmentSize) {
+		uEpochLength = g_uTrainSegmentSize;
+	}
+	WordPtr uEpochEnd = uEpochLength;
+	WordPtr uFound = 0;
+	WordPtr uOffset = 0;
+	TrainSegment_t Best;
+	Best.m_pData = NULL;
+	Best.m_uScore = 0;
+	i = 0;
+	while ((i<uSampleCount) && (uFound<uSegmentCount)) {
+		WordPtr uLength = pSampleLengths[i];
+		if (uLength>=g_uTrainSegmentSize) {
+			const Word8 *pInput = static_cast<const Word8 *>(ppSamples[i]);
+			WordPtr uPositions = uLength-g_uTrainSegmentSize+1;
+			Word32 uScore = TrainScore(pWeights,pInput);
+			WordPtr k = 0;
+			for (;;) {
+				if ((uOffset+k)>=uEpochEnd) {
+					uEpochEnd += uEpochLength;
+					if (Best.m_uScore) {
+						// Save the segment and remove its strings from the count
+						pSegments[uFound] = Best;
+						const Word8 *pSegment = Best.m_pData;
+						WordPtr m = g_uTrainSegmentSize-g_uTrainMatchSize+1;
+						do {
+							pWeights[TrainHash(pSegment)] = 0;
+							++pSegment;
+						} while (--m);
+						Best.m_uScore = 0;
+						if (++uFound>=uSegmentCount) {
+							break;
+						}
+						uScore = TrainScore(pWeights,pInput+k);
+					}
+				}
+				if (uScore>Best.m_uScore) {
+					Best.m_pData = pInput+k;
+					Best.m_uScore = uScore;
+				}
+				if (++k>=uPositions) {
+					break;
+				}
+				// Slide the window one byte
+				uScore += pWeights[TrainHash(pInput+k+(g_uTrainSegmentSize-g_uTrainMatchSize))];
+				uScore -= pWeights[TrainHash(pInput+k-1)];
+			}
+		}
+		uOffset += uLength;
+		++i;
+	}
+	if (Best.m_uScore && (uFound<uSegmentCount)) {
+		pSegments[uFound] = Best;
+		++uFound;
+	}
+
+	// Sort by score so the best segments are at the end
+	i = 1;
+	while (i<uFound) {
+		TrainSegment_t Temp = pSegments[i];
+		WordPtr k = i;
+		while (k && (pSegments[k-1].m_uScore>Temp.m_uScore)) {
+			pSegments[k] = pSegments[k-1];
+			--k;
+		}
+		pSegments[k] = Temp;
+		++i;
+	}
+	Word8 *pDest = static_cast<Word8 *>(pOutput);
+	i = 0;
+	while (i<uFound) {
+		MemoryCopy(pDest,pSegments[i].m_pData,g_uTrainSegmentSize);
+		pDest += g_uTrainSegmentSize;
+		++i;
+	}
+	Free(pSegments);
+	Free(pWeights);
+	return uFound*g_uTrainSegmentSize;
+}
+
 /*! ************************************
 
 	\var const Burger::StaticRTTI Burger::CompressDeflate::g_StaticRTTI
@@ -68,7 +68,6 @@ protected:
 	enum {
 		MAX_WBITS=15,			///< Number of bits deep a huffman entry can be
 		MAX_MEM_LEVEL=9,		///< Memory level
-		Z_BEST_COMPRESSION=9,	///< Compression level
 		Z_DEFLATED=8,			///< ZLIB token for Deflate
 		SMALLEST=1,				///< Index within the heap array of least frequent node in the Huffman tree
 		MIN_MATCH=3,			///< Minimum number of bytes of data to compress in a packet
@@ -116,6 +115,16 @@ protected:
 		int m_iMaximumCode;					///< Largest code with non zero frequency
 	};
 
+	typedef eBlockState (CompressDeflate::*DeflateProc)(int flush);
+
+	struct Config_t {
+		Word16 m_uGoodLength;		///< Reduce lazy search above this match length
+		Word16 m_uMaxLazy;			///< Do not perform lazy search above this match length
+		Word16 m_uNiceLength;		///< Quit search above this match length
+		Word16 m_uMaxChain;			///< Maximum number of hash chain entries to search
+		DeflateProc m_pDeflate;		///< Block compressor for this level
+	};
+
 	static const Word c_uBufSize = static_cast<Word>(8 * 2*sizeof(Word8));	///< Number of bits used within bi_buf. (bi_buf might be implemented on more than 16 bits on some systems.)
 	static const Word c_uWBits = MAX_WBITS;				///< log2(c_uWSize) (8..16)
 	static const Word c_uWSize = 1 << c_uWBits;			///< LZ77 window size (32K by default)
@@ -126,12 +135,11 @@ protected:
 	static const Word c_uHashShift = ((c_uHashBits+MIN_MATCH-1)/MIN_MATCH);		///< Number of bits by which m_uInsertHash must be shifted at each input step. It must be such that after MIN_MATCH steps, the oldest byte no longer takes part in the hash key, that is: hash_shift * MIN_MATCH >= hash_bits
 	static const Word c_uLiteralBufferSize = 1 << (MAX_MEM_LEVEL + 6);	///< 16K elements by default
 	static const Word c_uWindowSize = 2*c_uWSize;		///< Actual size of window: 2*wSize, except when the user input buffer is directly used as sliding window.
-	static const Word c_uMaxLazyMatch = 258;	///< Attempt to find a better match only when the current match is strictly smaller than this value. This mechanism is used only for compression levels >= 4.
-	static const Word c_uGoodMatch = 32;
-	static const int c_iNiceMatch = 258;		///< Stop searching when current match exceeds this
-	static const Word c_uMaxChainLength = 4096;	///< To speed up deflation, hash chains are never searched beyond this length.  A higher limit improves compression ratio but degrades the speed.
+	static const Word c_uPendingBufferSize = c_uLiteralBufferSize*4;	///< Size of the output buffer for a single block, large enough for the worst case encoding of a full literal buffer
 
 	const Word8 *m_pInput;		///< Next input byte
+	const Word8 *m_pDictionary;	///< Preset dictionary (Or \ref NULL)
+	WordPtr m_uDictionaryLength;	///< Size of the preset dictionary in bytes
 	Word8 *m_pPendingOutput;	///< Next pending byte to output to the stream
 	WordPtr m_uInputLength;		///< Number of bytes available at next_in
 	IntPtr m_iBlockStart;		///< Window position at the beginning of the current output block. Gets negative when the window is moved backwards.
@@ -152,6 +160,12 @@ protected:
 	Word m_uBitIndexValid;		///< Number of bits in the output buffer
 	Word m_bInitialized;		///< \ref TRUE if initialized
 	Word m_uLastEOBLength;		///< bit length of EOB code for last block
+	Word m_uLevel;				///< Compression level 0-9
+	Word m_uMaxLazyMatch;		///< Attempt to find a better match only when the current match is strictly smaller than this value. For levels 1-3, this is the longest match that is inserted into the hash table.
+	Word m_uGoodMatch;			///< Use a faster search when the previous match is longer than this
+	Word m_uNiceMatch;			///< Stop searching when current match exceeds this
+	Word m_uMaxChainLength;		///< To speed up deflation, hash chains are never searched beyond this length. A higher limit improves compression ratio but degrades the speed.
+	DeflateProc m_pDeflate;		///< Block compressor for the current level
 	int m_iPending;				///< Number of bytes in the pending buffer
 	int m_bNoHeader;			///< Suppress zlib header and adler32
 	int m_iLastFlush;			///< Value of flush param for previous deflate call
@@ -174,7 +188,7 @@ protected:
 	Word16 m_BitLengthCount[MAX_BITS+1];		///< MAX_BITS = 15, so this is long aligned
 	Word16 m_DataBuffer[c_uLiteralBufferSize];		///< Buffer for distances. To simplify the code, d_buf and l_buf have the same number of elements. To use different lengths, an extra flag array would be necessary.
 	Word8 m_LiteralBuffer[c_uLiteralBufferSize];	///< buffer for literals or lengths
-	Word8 m_PendingBuffer[c_uLiteralBufferSize];	///< Output still pending
+	Word8 m_PendingBuffer[c_uPendingBufferSize];	///< Output still pending
 	Word8 m_Depth[2*L_CODES+1];					///< Depth of each subtree used as tie breaker for trees of equal frequency
 	Word8 m_Window[c_uWSize*2];					///< Sliding window. Input bytes are read into the second half of the window, and move to the first half later to keep a dictionary of at least wSize bytes. With this organization, matches are limited to a distance of wSize-MAX_MATCH bytes, but this ensures that IO is always performed with a length multiple of the block size. 
 
@@ -300,13 +314,20 @@ protected:
 	void FlushBlock(const Word8 *buf,Word32 stored_len,Word bEOF);
 	void FlushPending(void);
 	Word LongestMatch(Word cur_match);
+	eBlockState DeflateStored(int flush);
+	eBlockState DeflateFast(int flush);
 	eBlockState DeflateSlow(int flush);
 	void Align(void);
 	int DeflateEnd(void);
 	void LongestMatchInit(void);
 	int DeflateReset(void);
 	int DeflateInit(void);
+	void DeflateInitDictionary(void);
+	Word ZLibHeader(Word bDictionary) const;
+	void DeflateSetDictionary(const Word8 *pDictionary,WordPtr uLength);
 	int PerformDeflate(int flush);
+	struct ParallelJob_t;
+	static WordPtr BURGER_API ParallelThread(void *pData);
 
 	static const int g_ExtraLengthBits[LENGTH_CODES];
 	static const int g_ExtraDistanceBits[D_CODES];
@@ -321,12 +342,29 @@ protected:
 	static const StaticTreeDesc_t g_StaticBitLengthDescription;
 	static const Word8 g_DistanceCodes[DIST_CODE_LEN];
 	static const Word8 g_LengthCodes[MAX_MATCH-MIN_MATCH+1];
+	static const Config_t g_ConfigurationTable[10];
 public:
+	enum {
+		Z_NO_COMPRESSION=0,		///< Only store the data
+		Z_BEST_SPEED=1,			///< Fastest compression level
+		Z_DEFAULT_COMPRESSION=6,	///< zlib's default balance of speed and size
+		Z_BEST_COMPRESSION=9	///< Smallest output, slowest compression
+	};
 	static const Word32 Signature = 0x5A4C4942;		///< 'ZLIB'
+	static const WordPtr c_uParallelBlockSize = 0x20000;	///< Default block size for CompressParallel()
+	static const WordPtr c_uMaxDictionarySize = (1<<MAX_WBITS)-MIN_LOOKAHEAD;	///< Largest preset dictionary that can be fully used
 	CompressDeflate(void);
+	CompressDeflate(Word uLevel);
+	void BURGER_API SetLevel(Word uLevel);
+	BURGER_INLINE Word GetLevel(void) const { return m_uLevel; }
+	void BURGER_API SetDictionary(const void *pDictionary,WordPtr uLength);
+	BURGER_INLINE const void *GetDictionary(void) const { return m_pDictionary; }
+	BURGER_INLINE WordPtr GetDictionaryLength(void) const { return m_uDictionaryLength; }
 	eError Init(void) BURGER_OVERRIDE;
 	eError Process(const void *pInput, uintptr_t uInputLength) BURGER_OVERRIDE;
 	eError Finalize(void) BURGER_OVERRIDE;
+	eError BURGER_API CompressParallel(const void *pInput,WordPtr uInputLength,Word uThreadCount,WordPtr uBlockSize=c_uParallelBlockSize);
+	static WordPtr BURGER_API TrainDictionary(void *pOutput,WordPtr uOutputSize,const void * const *ppSamples,const WordPtr *pSampleLengths,WordPtr uSampleCount);
 };
 }
 /* END */
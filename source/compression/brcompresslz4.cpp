@@ -0,0 +1,453 @@
+/***************************************
+
+	Compress using LZ4
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brcompresslz4.h"
+#include "brendian.h"
+#include "brmemoryfunctions.h"
+
+#if !defined(DOXYGEN)
+BURGER_CREATE_STATICRTTI_PARENT(Burger::CompressLZ4,Burger::Compress);
+#endif
+
+/*! ************************************
+
+	\class Burger::CompressLZ4
+	\brief Compress data using LZ4 encoding
+
+	LZ4 is a byte oriented LZ77 format that trades compression ratio
+	for decompression speed. There are no bit fields or huffman codes,
+	so the decoder is little more than a pair of memory copies per
+	match. It's documented here.
+
+	https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+
+	The data is split into blocks of up to 64K of uncompressed data.
+	Each block starts with a 32 bit little endian header with the size
+	of the block data. If the high bit is set, the data is stored
+	uncompressed. Otherwise, it is a standard LZ4 block with matches
+	reaching as far back as 65535 bytes, into previous blocks if needed.
+	A header of zero ends the stream.
+
+	Each sequence in a block has a token byte, with the upper 4 bits
+	holding the number of literals (15 means more lengths bytes follow)
+	and the lower 4 bits holding the match length minus 4. The literals
+	follow, then a 16 bit little endian offset and any extra length bytes
+	for the match. The last sequence of a block only has literals.
+
+	By default, a single entry hash table is used to find matches, which
+	is very fast. In high compression mode, hash chains are searched for
+	the longest match, which is slower to compress but decompresses just
+	as quickly.
+
+	\sa Burger::DecompressLZ4
+
+***************************************/
+
+#if !defined(DOXYGEN)
+
+//
+// Hash the next four bytes into CompressLZ4::HASHBITS bits
+//
+
+static BURGER_INLINE Word HashLZ4(const Word8 *pInput)
+{
+	return static_cast<Word>((Burger::NativeEndian::LoadAny(reinterpret_cast<const Word32 *>(pInput))*2654435761U)>>(32U-14U));
+}
+
+//
+// Count the number of matching bytes
+//
+
+static WordPtr CountMatchLZ4(const Word8 *pInput,const Word8 *pMatch,const Word8 *pInputLimit)
+{
+	const Word8 *pStart = pInput;
+	while ((pInput+8)<=pInputLimit) {
+		if (Burger::NativeEndian::LoadAny(reinterpret_cast<const Word64 *>(pInput))!=
+			Burger::NativeEndian::LoadAny(reinterpret_cast<const Word64 *>(pMatch))) {
+			break;
+		}
+		pInput+=8;
+		pMatch+=8;
+	}
+	while ((pInput<pInputLimit) && (pInput[0]==pMatch[0])) {
+		++pInput;
+		++pMatch;
+	}
+	return static_cast<WordPtr>(pInput-pStart);
+}
+
+//
+// Write a length extension for a literal or match count
+//
+
+static BURGER_INLINE Word8 *StoreLengthLZ4(Word8 *pOutput,WordPtr uLength)
+{
+	while (uLength>=255) {
+		pOutput[0] = 255;
+		++pOutput;
+		uLength-=255;
+	}
+	pOutput[0] = static_cast<Word8>(uLength);
+	return pOutput+1;
+}
+
+#endif
+
+/*! ************************************
+
+	\brief Initialize the compressor to defaults
+
+	Use the fast compression mode.
+
+***************************************/
+
+Burger::CompressLZ4::CompressLZ4(void) :
+	Compress(),
+	m_bHighCompression(FALSE)
+{
+	m_uSignature = Signature;
+	Reset();
+}
+
+/*! ************************************
+
+	\brief Initialize the compressor with a compression mode
+
+	\param bHighCompression \ref TRUE to search hash chains for the longest match
+
+***************************************/
+
+Burger::CompressLZ4::CompressLZ4(Word bHighCompression) :
+	Compress(),
+	m_bHighCompression(bHighCompression!=0)
+{
+	m_uSignature = Signature;
+	Reset();
+}
+
+/*! ************************************
+
+	\brief Clear the history and the match tables
+
+***************************************/
+
+void BURGER_API Burger::CompressLZ4::Reset(void)
+{
+	m_uBufferLength = 0;
+	m_uBlockStart = 0;
+	m_uNextInsert = 0;
+	MemoryClear(m_HashTable,sizeof(m_HashTable));
+	MemoryFill(m_ChainTable,0xFF,sizeof(m_ChainTable));
+}
+
+/*! ************************************
+
+	\brief Find the longest match with the hash chains
+
+	Add every offset up to and including uIndex to the hash chains and
+	then walk the chain for uIndex for the longest match.
+
+	\param uIndex Offset in the buffer to find a match for
+	\param uMatchLimit Offset where the match must end
+	\param pMatchIndex Pointer to receive the offset of the match
+	\return Length of the match or zero if there isn't one
+
+***************************************/
+
+WordPtr BURGER_API Burger::CompressLZ4::FindMatchHigh(WordPtr uIndex,WordPtr uMatchLimit,WordPtr *pMatchIndex)
+{
+	const Word8 *pBuffer = m_Buffer;
+	WordPtr uInsert = m_uNextInsert;
+	while (uInsert<=uIndex) {
+		Word uHash = HashLZ4(pBuffer+uInsert);
+		WordPtr uDelta = uInsert-m_HashTable[uHash];
+		// Nothing before it? End the chain
+		if (!uDelta || (uDelta>0xFFFFU)) {
+			uDelta = 0xFFFFU;
+		}
+		m_ChainTable[uInsert&(WINDOWSIZE-1)] = static_cast<Word16>(uDelta);
+		m_HashTable[uHash] = static_cast<Word32>(uInsert);
+		++uInsert;
+	}
+	m_uNextInsert = uInsert;
+
+	Word32 uValue = NativeEndian::LoadAny(reinterpret_cast<const Word32 *>(pBuffer+uIndex));
+	WordPtr uBestLength = 0;
+	WordPtr uCandidate = uIndex;
+	Word uAttempts = HIGHATTEMPTS;
+	do {
+		// 0xFFFF marks the end of the chain
+		WordPtr uDelta = m_ChainTable[uCandidate&(WINDOWSIZE-1)];
+		if ((uDelta==0xFFFFU) || (uDelta>uCandidate)) {
+			break;
+		}
+		uCandidate -= uDelta;
+		if ((uIndex-uCandidate)>=WINDOWSIZE) {
+			break;
+		}
+		// Test the byte that would make it longer first
+		if ((pBuffer[uCandidate+uBestLength]==pBuffer[uIndex+uBestLength]) &&
+			(NativeEndian::LoadAny(reinterpret_cast<const Word32 *>(pBuffer+uCandidate))==uValue)) {
+			WordPtr uLength = MINMATCHLENGTH+CountMatchLZ4(pBuffer+uIndex+MINMATCHLENGTH,pBuffer+uCandidate+MINMATCHLENGTH,pBuffer+uMatchLimit);
+			if (uLength>uBestLength) {
+				uBestLength = uLength;
+				pMatchIndex[0] = uCandidate;
+				// Can't do any better
+				if ((uIndex+uLength)>=uMatchLimit) {
+					break;
+				}
+			}
+		}
+	} while (--uAttempts);
+	return uBestLength;
+}
+
+/*! ************************************
+
+	\brief Compress the pending block
+
+	Compress the data from m_uBlockStart to m_uBufferLength and append
+	it to the output. If the buffer is full afterwards, the last 64K
+	is moved to the start to be the history for the next block.
+
+***************************************/
+
+void BURGER_API Burger::CompressLZ4::CompressBlock(void)
+{
+	const Word8 *pBuffer = m_Buffer;
+	WordPtr uIndex = m_uBlockStart;
+	WordPtr uAnchor = uIndex;
+	WordPtr uEnd = m_uBufferLength;
+	Word8 *pOutput = m_BlockOutput;
+
+	// Is the block big enough to have a match?
+	if ((uEnd-uIndex)>MATCHFINDLIMIT) {
+		WordPtr uMatchFindLimit = uEnd-MATCHFINDLIMIT;
+		WordPtr uMatchLimit = uEnd-LASTLITERALS;
+		Word uMisses = 0;
+		do {
+			WordPtr uMatch = 0;
+			WordPtr uLength;
+			if (m_bHighCompression) {
+				uLength = FindMatchHigh(uIndex,uMatchLimit,&uMatch);
+				// Is the match one byte later better?
+				if (uLength && (uIndex<uMatchFindLimit)) {
+					WordPtr uNextMatch = 0;
+					WordPtr uNextLength = FindMatchHigh(uIndex+1,uMatchLimit,&uNextMatch);
+					if (uNextLength>uLength) {
+						++uIndex;
+						uLength = uNextLength;
+						uMatch = uNextMatch;
+					}
+				}
+			} else {
+				Word32 uValue = NativeEndian::LoadAny(reinterpret_cast<const Word32 *>(pBuffer+uIndex));
+				Word uHash = HashLZ4(pBuffer+uIndex);
+				uMatch = m_HashTable[uHash];
+				m_HashTable[uHash] = static_cast<Word32>(uIndex);
+				uLength = 0;
+				if ((uMatch<uIndex) && ((uIndex-uMatch)<WINDOWSIZE) &&
+					(NativeEndian::LoadAny(reinterpret_cast<const Word32 *>(pBuffer+uMatch))==uValue)) {
+					uLength = MINMATCHLENGTH+CountMatchLZ4(pBuffer+uIndex+MINMATCHLENGTH,pBuffer+uMatch+MINMATCHLENGTH,pBuffer+uMatchLimit);
+				}
+			}
+			if (!uLength) {
+				// Skip faster through data that doesn't compress
+				uIndex += 1+(uMisses>>6U);
+				++uMisses;
+				continue;
+			}
+			uMisses = 0;
+
+			// Catch up over any matching literals
+			while ((uIndex>uAnchor) && uMatch && (pBuffer[uIndex-1]==pBuffer[uMatch-1])) {
+				--uIndex;
+				--uMatch;
+				++uLength;
+			}
+
+			// Token, literals, offset and match length
+			WordPtr uLiterals = uIndex-uAnchor;
+			Word8 *pToken = pOutput;
+			++pOutput;
+			Word uToken;
+			if (uLiterals>=15) {
+				uToken = 15U<<4U;
+				pOutput = StoreLengthLZ4(pOutput,uLiterals-15);
+			} else {
+				uToken = static_cast<Word>(uLiterals<<4U);
+			}
+			MemoryCopy(pOutput,pBuffer+uAnchor,uLiterals);
+			pOutput += uLiterals;
+			WordPtr uOffset = uIndex-uMatch;
+			pOutput[0] = static_cast<Word8>(uOffset);
+			pOutput[1] = static_cast<Word8>(uOffset>>8U);
+			pOutput+=2;
+			WordPtr uExtra = uLength-MINMATCHLENGTH;
+			if (uExtra>=15) {
+				uToken |= 15U;
+				pOutput = StoreLengthLZ4(pOutput,uExtra-15);
+			} else {
+				uToken |= static_cast<Word>(uExtra);
+			}
+			pToken[0] = static_cast<Word8>(uToken);
+
+			uIndex += uLength;
+			uAnchor = uIndex;
+			// Seed the table with the tail of the match
+			if (!m_bHighCompression && (uIndex<=uMatchFindLimit)) {
+				m_HashTable[HashLZ4(pBuffer+uIndex-2)] = static_cast<Word32>(uIndex-2);
+			}
+		} while (uIndex<=uMatchFindLimit);
+	}
+
+	// The last sequence is only literals
+	WordPtr uLiterals = uEnd-uAnchor;
+	if (uLiterals>=15) {
+		pOutput[0] = 15U<<4U;
+		pOutput = StoreLengthLZ4(pOutput+1,uLiterals-15);
+	} else {
+		pOutput[0] = static_cast<Word8>(uLiterals<<4U);
+		++pOutput;
+	}
+	MemoryCopy(pOutput,pBuffer+uAnchor,uLiterals);
+	pOutput += uLiterals;
+
+	// Store it raw if it didn't compress
+	WordPtr uRawSize = uEnd-m_uBlockStart;
+	WordPtr uPackedSize = static_cast<WordPtr>(pOutput-m_BlockOutput);
+	if (uPackedSize>=uRawSize) {
+		m_Output.Append(static_cast<Word32>(uRawSize|0x80000000U));
+		m_Output.Append(pBuffer+m_uBlockStart,uRawSize);
+	} else {
+		m_Output.Append(static_cast<Word32>(uPackedSize));
+		m_Output.Append(m_BlockOutput,uPackedSize);
+	}
+
+	// Slide the history down when the buffer is full
+	m_uBlockStart = uEnd;
+	if (uEnd==(WINDOWSIZE+BLOCKSIZE)) {
+		MemoryCopy(m_Buffer,m_Buffer+BLOCKSIZE,WINDOWSIZE);
+		Word32 *pHash = m_HashTable;
+		WordPtr uCount = BURGER_ARRAYSIZE(m_HashTable);
+		do {
+			Word32 uValue = pHash[0];
+			pHash[0] = (uValue>=BLOCKSIZE) ? uValue-BLOCKSIZE : 0;
+			++pHash;
+		} while (--uCount);
+		m_uBufferLength = WINDOWSIZE;
+		m_uBlockStart = WINDOWSIZE;
+		m_uNextInsert = (m_uNextInsert>=BLOCKSIZE) ? m_uNextInsert-BLOCKSIZE : 0;
+	}
+}
+
+/*! ************************************
+
+	\brief Set the compression mode
+
+	Takes effect with the next block that's compressed.
+
+	\param bHighCompression \ref TRUE to search hash chains for the longest match
+	\sa GetHighCompression(void) const
+
+***************************************/
+
+void BURGER_API Burger::CompressLZ4::SetHighCompression(Word bHighCompression)
+{
+	m_bHighCompression = (bHighCompression!=0);
+}
+
+/*! ************************************
+
+	\fn Word Burger::CompressLZ4::GetHighCompression(void) const
+	\brief Get the compression mode
+
+	\return \ref TRUE if high compression mode is enabled
+	\sa SetHighCompression(Word)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Reset the LZ4 compressor
+
+	Discard the history and any previous output.
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressLZ4::Init(void)
+{
+	m_Output.Clear();
+	Reset();
+	return COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Compress the input data using LZ4
+
+	Data is cached until a complete 64K block is present, then
+	the block is compressed into the OutputMemoryStream.
+
+	\param pInput Pointer to the data to compress
+	\param uInputLength Number of bytes to compress
+	\return Zero if no error, non-zero on error
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressLZ4::Process(const void *pInput,WordPtr uInputLength)
+{
+	while (uInputLength) {
+		WordPtr uChunk = (m_uBlockStart+BLOCKSIZE)-m_uBufferLength;
+		if (uChunk>uInputLength) {
+			uChunk = uInputLength;
+		}
+		MemoryCopy(m_Buffer+m_uBufferLength,pInput,uChunk);
+		pInput = static_cast<const Word8 *>(pInput)+uChunk;
+		uInputLength -= uChunk;
+		m_uBufferLength += uChunk;
+		if (m_uBufferLength==(m_uBlockStart+BLOCKSIZE)) {
+			CompressBlock();
+		}
+	}
+	return m_Output.GetError() ? COMPRESS_OUTOFMEMORY : COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Finalize LZ4 compression
+
+	Compress any cached data and append the end of stream marker.
+
+	\return Zero if no error, non-zero on error
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressLZ4::Finalize(void)
+{
+	if (m_uBufferLength!=m_uBlockStart) {
+		CompressBlock();
+	}
+	m_Output.Append(static_cast<Word32>(0));
+	return m_Output.GetError() ? COMPRESS_OUTOFMEMORY : COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\var const Burger::StaticRTTI Burger::CompressLZ4::g_StaticRTTI
+	\brief The global description of the class
+
+	This record contains the name of this class and a
+	reference to the parent
+
+***************************************/
@@ -0,0 +1,73 @@
+/***************************************
+
+	Compress using LZ4
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRCOMPRESSLZ4_H__
+#define __BRCOMPRESSLZ4_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRBASE_H__
+#include "brbase.h"
+#endif
+
+#ifndef __BROUTPUTMEMORYSTREAM_H__
+#include "broutputmemorystream.h"
+#endif
+
+#ifndef __BRCOMPRESS_H__
+#include "brcompress.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class CompressLZ4 : public Compress {
+	BURGER_RTTI_IN_CLASS();
+protected:
+	static const Word BLOCKSIZE=0x10000;		///< Largest block of uncompressed data
+	static const Word WINDOWSIZE=0x10000;		///< Size of the history (Largest offset is WINDOWSIZE-1)
+	static const Word MINMATCHLENGTH=4;			///< Shortest match that can be encoded
+	static const Word MATCHFINDLIMIT=12;		///< The last match must start this many bytes before the end of a block
+	static const Word LASTLITERALS=5;			///< The last bytes of a block are always literals
+	static const Word HASHBITS=14;				///< Bits in the hash table index
+	static const Word HIGHATTEMPTS=128;			///< Number of hash chain entries tested in high compression mode
+	static const Word BLOCKOUTPUTSIZE=BLOCKSIZE+(BLOCKSIZE/255)+16;	///< Worst case size of a compressed block
+
+	WordPtr m_uBufferLength;			///< Number of bytes in m_Buffer
+	WordPtr m_uBlockStart;				///< Offset in m_Buffer of the data not yet compressed
+	WordPtr m_uNextInsert;				///< Next offset in m_Buffer to add to the hash chains
+	Word m_bHighCompression;			///< \ref TRUE if hash chains are searched for the longest match
+	Word32 m_HashTable[1<<HASHBITS];	///< Latest offset in m_Buffer for each hash
+	Word16 m_ChainTable[WINDOWSIZE];	///< Distance to the previous offset with the same hash
+	Word8 m_Buffer[WINDOWSIZE+BLOCKSIZE];	///< History followed by the block being compressed
+	Word8 m_BlockOutput[BLOCKOUTPUTSIZE];	///< Compressed block before it's appended to the output
+
+	void BURGER_API Reset(void);
+	WordPtr BURGER_API FindMatchHigh(WordPtr uIndex,WordPtr uMatchLimit,WordPtr *pMatchIndex);
+	void BURGER_API CompressBlock(void);
+public:
+	static const Word32 Signature = 0x4C5A3420;		///< 'LZ4 '
+	CompressLZ4(void);
+	CompressLZ4(Word bHighCompression);
+	void BURGER_API SetHighCompression(Word bHighCompression);
+	BURGER_INLINE Word GetHighCompression(void) const { return m_bHighCompression; }
+	eError Init(void) BURGER_OVERRIDE;
+	eError Process(const void *pInput, uintptr_t uInputLength) BURGER_OVERRIDE;
+	eError Finalize(void) BURGER_OVERRIDE;
+};
+}
+/* END */
+
+#endif
+
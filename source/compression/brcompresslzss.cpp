@@ -12,9 +12,21 @@
 ***************************************/
 
 #include "brcompresslzss.h"
+#include "brglobalmemorymanager.h"
+#include "brmemoryfunctions.h"
 
 #if !defined(DOXYGEN)
 BURGER_CREATE_STATICRTTI_PARENT(Burger::CompressLZSS,Burger::Compress);
+
+//
+// Hash the next three bytes for the hash chains
+//
+
+static BURGER_INLINE Word HashLZSS(const Word8 *pInput)
+{
+	Word32 uValue = static_cast<Word32>(pInput[0])|(static_cast<Word32>(pInput[1])<<8U)|(static_cast<Word32>(pInput[2])<<16U);
+	return static_cast<Word>((uValue*2654435761U)>>(32U-15U));
+}
 #endif
 
 /*! ************************************
@@ -41,6 +53,20 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::CompressLZSS,Burger::Compress);
 	and added to the current output pointer and the bytes are 
 	copied from the previously decompressed data to the current buffer
 
+	By default, matches are found with a binary tree of the strings in
+	the 4096 byte ring buffer. SetSearchDepth() switches to hash chains,
+	which are much faster on large files, and with a larger depth, can
+	find better matches. The output is still read by DecompressLZSS.
+
+	SetLargeWindow() enables a variant of the format that can only be
+	read by DecompressLZSS with its large window flag set. The bit masks
+	are the same, and the 16 bit token has the upper 4 bits as the
+	length minus 2 (3-17) and the lower 12 bits as the distance minus
+	one (1-4096). If the upper 4 bits are zero, the token is followed
+	by a byte with bits 12-15 of the distance minus one (1-65536 in
+	total) and a byte with the length minus 3 (3-258). It always uses
+	the hash chains.
+
 	\sa Burger::DecompressLZSS
 
 ***************************************/
@@ -265,12 +291,304 @@ void Burger::CompressLZSS::InitTrees(void)
 ***************************************/
 
 Burger::CompressLZSS::CompressLZSS() :
-	Compress()
+	Compress(),
+	m_pHashChain(NULL),
+	m_uChainLength(0),
+	m_uChainIndex(0),
+	m_uChainInsert(0),
+	m_uSearchDepth(0),
+	m_bLargeWindow(FALSE),
+	m_bHashChains(FALSE)
 {
 	m_uSignature = Signature;
 	InitTrees();
 }
 
+/*! ************************************
+
+	\brief Release the hash chain data
+
+***************************************/
+
+Burger::CompressLZSS::~CompressLZSS()
+{
+	Free(m_pHashChain);
+}
+
+/*! ************************************
+
+	\brief Find the longest match with the hash chains
+
+	Add every offset up to and including uIndex to the hash chains and
+	then walk the chain for uIndex for the longest match. The
+	data at uIndex must have at least 3 bytes.
+
+	\param uIndex Offset in the buffer to find a match for
+	\param uMatchLimit Offset where the match must end
+	\param pDistance Pointer to receive the distance back to the match
+	\return Length of the match or zero if there isn't one
+
+***************************************/
+
+WordPtr BURGER_API Burger::CompressLZSS::FindMatchChain(WordPtr uIndex,WordPtr uMatchLimit,WordPtr *pDistance)
+{
+	HashChain_t *pHashChain = m_pHashChain;
+	const Word8 *pBuffer = pHashChain->m_Buffer;
+	WordPtr uInsert = m_uChainInsert;
+	while (uInsert<=uIndex) {
+		Word uHash = HashLZSS(pBuffer+uInsert);
+		WordPtr uDelta = uInsert-pHashChain->m_HashTable[uHash];
+		// Nothing before it? End the chain
+		if (uDelta>0xFFFFU) {
+			uDelta = 0;
+		}
+		pHashChain->m_ChainTable[uInsert&(CHAINHISTORYSIZE-1)] = static_cast<Word16>(uDelta);
+		pHashChain->m_HashTable[uHash] = static_cast<Word32>(uInsert);
+		++uInsert;
+	}
+	m_uChainInsert = uInsert;
+
+	WordPtr uWindow = m_bLargeWindow ? LARGEWINDOWSIZE : RINGBUFFERSIZE;
+	const Word8 *pInput = pBuffer+uIndex;
+	WordPtr uMaxLength = uMatchLimit-uIndex;
+	WordPtr uBestLength = 0;
+	// Length minus the extra bytes of a long token
+	WordPtr uBestScore = 0;
+	WordPtr uCandidate = uIndex;
+	Word uAttempts = m_uSearchDepth;
+	do {
+		WordPtr uDelta = pHashChain->m_ChainTable[uCandidate&(CHAINHISTORYSIZE-1)];
+		if (!uDelta || (uDelta>uCandidate)) {
+			break;
+		}
+		uCandidate -= uDelta;
+		WordPtr uDistance = uIndex-uCandidate;
+		if (uDistance>uWindow) {
+			break;
+		}
+		const Word8 *pMatch = pBuffer+uCandidate;
+		// Test the byte that would make it better first
+		if ((pMatch[uBestScore]==pInput[uBestScore]) && (pMatch[0]==pInput[0]) &&
+			(pMatch[1]==pInput[1]) && (pMatch[2]==pInput[2])) {
+			WordPtr uLength = 3;
+			while ((uLength<uMaxLength) && (pMatch[uLength]==pInput[uLength])) {
+				++uLength;
+			}
+			WordPtr uScore = uLength;
+			// Long tokens are 2 bytes larger
+			if (m_bLargeWindow && ((uDistance>RINGBUFFERSIZE) || (uLength>=MAXMATCHLENGTH))) {
+				// Not worth it?
+				if (uLength<LARGEMINFARLENGTH) {
+					continue;
+				}
+				uScore -= 2;
+			}
+			if (uScore>uBestScore) {
+				uBestScore = uScore;
+				uBestLength = uLength;
+				pDistance[0] = uDistance;
+				// Can't do any better
+				if (uLength>=uMaxLength) {
+					break;
+				}
+			}
+		}
+	} while (--uAttempts);
+	return uBestLength;
+}
+
+/*! ************************************
+
+	\brief Add a byte to the output
+
+	Add a bit mask byte to the output if needed and then
+	store the byte
+
+	\param uByte Byte to store in the output
+	\sa EmitMatch(WordPtr,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::CompressLZSS::EmitLiteral(Word uByte)
+{
+	if (!m_bOrMask) {
+		m_uBitMaskOffset = m_Output.GetSize();
+		m_Output.Append(static_cast<Word8>(0));
+		m_bOrMask = 1;
+		m_bBitMask = 0;
+	}
+	m_bBitMask |= m_bOrMask;		// 'send one byte' flag
+	m_Output.Append(static_cast<Word8>(uByte));
+	m_bOrMask <<= 1;
+	// All filled?
+	if (!m_bOrMask) {
+		m_Output.Overwrite(&m_bBitMask,1,m_uBitMaskOffset);
+	}
+}
+
+/*! ************************************
+
+	\brief Add a match token to the output
+
+	Add a bit mask byte to the output if needed and then store the
+	match in the format selected by SetLargeWindow(Word)
+
+	\param uDistance Number of bytes back to the start of the match
+	\param uLength Length of the match
+	\sa EmitLiteral(Word)
+
+***************************************/
+
+void BURGER_API Burger::CompressLZSS::EmitMatch(WordPtr uDistance,WordPtr uLength)
+{
+	if (!m_bOrMask) {
+		m_uBitMaskOffset = m_Output.GetSize();
+		m_Output.Append(static_cast<Word8>(0));
+		m_bOrMask = 1;
+		m_bBitMask = 0;
+	}
+	if (m_bLargeWindow) {
+		WordPtr uDistanceCode = uDistance-1;
+		if ((uDistance<=RINGBUFFERSIZE) && (uLength<=(MAXMATCHLENGTH-1))) {
+			// Short token
+			m_Output.Append(static_cast<Word16>(uDistanceCode|((uLength-MINMATCHLENGTH)<<12U)));
+		} else {
+			// Long token
+			m_Output.Append(static_cast<Word16>(uDistanceCode&0xFFFU));
+			m_Output.Append(static_cast<Word8>(uDistanceCode>>12U));
+			m_Output.Append(static_cast<Word8>(uLength-(MINMATCHLENGTH+1)));
+		}
+	} else {
+		Word uNewToken = static_cast<Word>(0U-uDistance)&0xFFFU;
+		uNewToken = uNewToken|static_cast<Word>((uLength-(MINMATCHLENGTH+1))<<12U);
+		// Note: This is put in the stream as little endian!!
+		m_Output.Append(static_cast<Word16>(uNewToken));
+	}
+	m_bOrMask <<= 1;
+	// All filled?
+	if (!m_bOrMask) {
+		m_Output.Overwrite(&m_bBitMask,1,m_uBitMaskOffset);
+	}
+}
+
+/*! ************************************
+
+	\brief Compress the data in the hash chain buffer
+
+	Encode the data from CompressLZSS::m_uChainIndex. Unless
+	it's the end of the data, the last bytes are kept so they
+	can be matched against the data that follows. If the buffer
+	is full afterwards, the last 64K is moved to the start.
+
+	\param bFinal \ref TRUE if there is no more data
+
+***************************************/
+
+void BURGER_API Burger::CompressLZSS::CompressChains(Word bFinal)
+{
+	const Word8 *pBuffer = m_pHashChain->m_Buffer;
+	WordPtr uEnd = m_uChainLength;
+	WordPtr uMaxMatchLength = m_bLargeWindow ? LARGEMAXMATCHLENGTH : MAXMATCHLENGTH;
+	WordPtr uLimit = uEnd;
+	if (!bFinal) {
+		uLimit = (uEnd>uMaxMatchLength) ? uEnd-uMaxMatchLength : 0;
+	}
+	WordPtr uIndex = m_uChainIndex;
+	while (uIndex<uLimit) {
+		WordPtr uLength = 0;
+		WordPtr uDistance = 0;
+		if ((uEnd-uIndex)>=(MINMATCHLENGTH+1)) {
+			WordPtr uMatchLimit = uIndex+uMaxMatchLength;
+			if (uMatchLimit>uEnd) {
+				uMatchLimit = uEnd;
+			}
+			uLength = FindMatchChain(uIndex,uMatchLimit,&uDistance);
+		}
+		if (uLength>=(MINMATCHLENGTH+1)) {
+			EmitMatch(uDistance,uLength);
+			uIndex += uLength;
+		} else {
+			EmitLiteral(pBuffer[uIndex]);
+			++uIndex;
+		}
+	}
+	m_uChainIndex = uIndex;
+
+	// Slide the history down when the buffer is full
+	if (uEnd==(CHAINHISTORYSIZE+CHAINBLOCKSIZE)) {
+		HashChain_t *pHashChain = m_pHashChain;
+		MemoryCopy(pHashChain->m_Buffer,pHashChain->m_Buffer+CHAINBLOCKSIZE,CHAINHISTORYSIZE);
+		Word32 *pHash = pHashChain->m_HashTable;
+		WordPtr uCount = BURGER_ARRAYSIZE(pHashChain->m_HashTable);
+		do {
+			Word32 uValue = pHash[0];
+			pHash[0] = (uValue>=CHAINBLOCKSIZE) ? uValue-CHAINBLOCKSIZE : 0;
+			++pHash;
+		} while (--uCount);
+		m_uChainLength = CHAINHISTORYSIZE;
+		m_uChainIndex -= CHAINBLOCKSIZE;
+		m_uChainInsert = (m_uChainInsert>=CHAINBLOCKSIZE) ? m_uChainInsert-CHAINBLOCKSIZE : 0;
+	}
+}
+
+/*! ************************************
+
+	\brief Set the hash chain search depth
+
+	If non-zero, hash chains are used to find matches instead of the
+	binary tree and this is the number of earlier strings tested for
+	each match. Zero uses the binary tree, which creates the same
+	output as earlier versions of this class. Takes effect with the
+	next call to Init().
+
+	\param uSearchDepth Number of chain entries to test, zero for the binary tree
+	\sa GetSearchDepth(void) const or SetLargeWindow(Word)
+
+***************************************/
+
+void BURGER_API Burger::CompressLZSS::SetSearchDepth(Word uSearchDepth)
+{
+	m_uSearchDepth = uSearchDepth;
+}
+
+/*! ************************************
+
+	\fn Word Burger::CompressLZSS::GetSearchDepth(void) const
+	\brief Get the hash chain search depth
+
+	\return Number of chain entries tested, zero if the binary tree is used
+	\sa SetSearchDepth(Word)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Enable the large window format
+
+	Output matches of up to 258 bytes, up to 65536 bytes back. The
+	data must be decompressed with DecompressLZSS with the large
+	window flag set. Takes effect with the next call to Init().
+
+	\param bLargeWindow \ref TRUE to use the large window format
+	\sa GetLargeWindow(void) const or SetSearchDepth(Word)
+
+***************************************/
+
+void BURGER_API Burger::CompressLZSS::SetLargeWindow(Word bLargeWindow)
+{
+	m_bLargeWindow = (bLargeWindow!=0);
+}
+
+/*! ************************************
+
+	\fn Word Burger::CompressLZSS::GetLargeWindow(void) const
+	\brief Get the format of the compressed data
+
+	\return \ref TRUE if the large window format is used
+	\sa SetLargeWindow(Word)
+
+***************************************/
+
 /***************************************
 
 	Initialize
@@ -282,6 +600,27 @@ Burger::CompressLZSS::eError Burger::CompressLZSS::Init(void)
 	// Clear any previous output
 	m_Output.Clear();
 	InitTrees();
+
+	// Large windows only work with hash chains
+	if (m_bLargeWindow && !m_uSearchDepth) {
+		m_uSearchDepth = DEFAULTSEARCHDEPTH;
+	}
+	m_bHashChains = (m_uSearchDepth!=0);
+	if (m_bHashChains) {
+		if (!m_pHashChain) {
+			m_pHashChain = static_cast<HashChain_t *>(Alloc(sizeof(HashChain_t)));
+			if (!m_pHashChain) {
+				m_bHashChains = FALSE;
+				return COMPRESS_OUTOFMEMORY;
+			}
+		}
+		MemoryClear(m_pHashChain->m_HashTable,sizeof(m_pHashChain->m_HashTable));
+		m_uChainLength = 0;
+		m_uChainIndex = 0;
+		m_uChainInsert = 0;
+		m_bOrMask = 0;
+		m_bBitMask = 0;
+	}
 	return COMPRESS_OKAY;
 }
 
@@ -293,6 +632,27 @@ Burger::CompressLZSS::eError Burger::CompressLZSS::Init(void)
 
 Burger::CompressLZSS::eError Burger::CompressLZSS::Process(const void *pInput,WordPtr uInputLength)
 {
+	if (m_bHashChains) {
+		// Fill the buffer and compress whenever it's full
+		while (uInputLength) {
+			WordPtr uCount = (CHAINHISTORYSIZE+CHAINBLOCKSIZE)-m_uChainLength;
+			if (uCount>uInputLength) {
+				uCount = uInputLength;
+			}
+			MemoryCopy(m_pHashChain->m_Buffer+m_uChainLength,pInput,uCount);
+			pInput = static_cast<const Word8 *>(pInput)+uCount;
+			uInputLength -= uCount;
+			m_uChainLength += uCount;
+			if (m_uChainLength==(CHAINHISTORYSIZE+CHAINBLOCKSIZE)) {
+				CompressChains(FALSE);
+			}
+		}
+		if (m_Output.GetError()) {
+			return COMPRESS_OUTOFMEMORY;
+		}
+		return COMPRESS_OKAY;
+	}
+
 	if (uInputLength) {
 
 		// Read MAXMATCHLENGTH bytes into the last MAXMATCHLENGTH bytes of the buffer
@@ -412,6 +772,18 @@ Burger::CompressLZSS::eError Burger::CompressLZSS::Process(const void *pInput,Wo
 
 Burger::CompressLZSS::eError Burger::CompressLZSS::Finalize(void)
 {
+	if (m_bHashChains) {
+		CompressChains(TRUE);
+		// Store the last partial bit mask
+		if (m_bOrMask) {
+			m_Output.Overwrite(&m_bBitMask,1,m_uBitMaskOffset);
+		}
+		if (m_Output.GetError()) {
+			return COMPRESS_OUTOFMEMORY;
+		}
+		return COMPRESS_OKAY;
+	}
+
 	// Finally, insert the whole string just read. The
 	// global variables MatchSize and MatchOffset are set.
 	if (m_uCachedLength) {
@@ -39,6 +39,20 @@ protected:
 	static const Word MAXMATCHLENGTH=18;		///< Largest size of a string to match
 	static const Word MINMATCHLENGTH=2;			///< Encode string into position and length
 	static const Word NOTUSED=RINGBUFFERSIZE;	///< Index for root of binary search trees
+	static const Word LARGEWINDOWSIZE=0x10000;	///< Largest offset of the large window format
+	static const Word LARGEMAXMATCHLENGTH=258;	///< Largest string to match in the large window format
+	static const Word LARGEMINFARLENGTH=5;		///< Shortest match that needs a long token in the large window format
+	static const Word CHAINHASHBITS=15;			///< Bits in the hash chain hash table index
+	static const Word CHAINHISTORYSIZE=0x10000;	///< History kept in the hash chain buffer
+	static const Word CHAINBLOCKSIZE=0x10000;	///< Data added to the hash chain buffer before sliding it down
+	static const Word DEFAULTSEARCHDEPTH=32;	///< Search depth used for the large window format if none was set
+
+	/** Data for the hash chain match finder */
+	struct HashChain_t {
+		Word32 m_HashTable[1<<CHAINHASHBITS];	///< Latest offset in m_Buffer for each hash
+		Word16 m_ChainTable[CHAINHISTORYSIZE];	///< Distance to the previous offset with the same hash, zero ends the chain
+		Word8 m_Buffer[CHAINHISTORYSIZE+CHAINBLOCKSIZE];	///< History followed by the data being compressed
+	};
 
 	WordPtr m_uBitMaskOffset;					///< Location in the output stream to store any bit masks
 	Word m_uSourceIndex;						///< Index to insert nodes into
@@ -54,13 +68,29 @@ protected:
 	Word8 m_bBitMask;							///< Bit field to store in the output stream
 	Word8 m_bOrMask;							///< Bit mask for which bit is currently being modified
 	Word8 m_RingBuffer[RINGBUFFERSIZE+MAXMATCHLENGTH-1];	///< Ring buffer of size RINGBUFFERSIZE, with extra MAXMATCHLENGTH-1 bytes to facilitate string comparison
+	HashChain_t *m_pHashChain;					///< Hash chain match finder data, allocated on first use
+	WordPtr m_uChainLength;						///< Number of bytes in HashChain_t::m_Buffer
+	WordPtr m_uChainIndex;						///< Offset in HashChain_t::m_Buffer of the next byte to encode
+	WordPtr m_uChainInsert;						///< Next offset in HashChain_t::m_Buffer to add to the hash chains
+	Word m_uSearchDepth;						///< Hash chain entries tested per match, zero for the binary tree
+	Word m_bLargeWindow;						///< \ref TRUE if the large window format is requested
+	Word m_bHashChains;							///< \ref TRUE if the hash chain match finder is in use
 
 	void DeleteNode(WordPtr uNodeNumber);
 	void InsertNode(WordPtr uNodeNumber);
 	void InitTrees(void);
+	WordPtr BURGER_API FindMatchChain(WordPtr uIndex,WordPtr uMatchLimit,WordPtr *pDistance);
+	void BURGER_API EmitLiteral(Word uByte);
+	void BURGER_API EmitMatch(WordPtr uDistance,WordPtr uLength);
+	void BURGER_API CompressChains(Word bFinal);
 public:
 	static const Word32 Signature = 0x4C5A5353;		///< 'LZSS'
 	CompressLZSS(void);
+	~CompressLZSS();
+	void BURGER_API SetSearchDepth(Word uSearchDepth);
+	BURGER_INLINE Word GetSearchDepth(void) const { return m_uSearchDepth; }
+	void BURGER_API SetLargeWindow(Word bLargeWindow);
+	BURGER_INLINE Word GetLargeWindow(void) const { return m_bLargeWindow; }
 	eError Init(void) BURGER_OVERRIDE;
 	eError Process(const void *pInput, uintptr_t uInputLength) BURGER_OVERRIDE;
 	eError Finalize(void) BURGER_OVERRIDE;
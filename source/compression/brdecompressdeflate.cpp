@@ -15,6 +15,7 @@
 #include "bradler32.h"
 #include "brmemoryfunctions.h"
 #include "brglobalmemorymanager.h"
+#include "brendian.h"
 
 #if !defined(DOXYGEN)
 BURGER_CREATE_STATICRTTI_PARENT(Burger::DecompressDeflate,Burger::Decompress);
@@ -340,14 +341,73 @@ int Burger::DecompressDeflate::Flush(int iErrorCode)
 	return iErrorCode;
 }
 
+/*! ************************************
+
+	\brief Build the multiple literal lookup table
+
+	Fill in a table of 2^\ref FAST_LITERALBITS entries so one or two
+	literals can be decoded with a single lookup.
+
+	Each entry holds the number of bits consumed in bits 0-7, the first
+	literal in bits 8-15, the second literal in bits 16-23 and the
+	number of literals in bits 24-31. An entry of zero means the bits
+	start a length, end of block or long code and the huffman tree has
+	to be walked.
+
+	A literal whose code is shorter than the first level of the tree
+	is replicated across every entry sharing its low bits, so a second
+	literal can be looked up with the unknown upper bits set to zero as
+	long as its code fits in the remaining bits.
+
+	\param pTable Pointer to the table to fill in
+	\param uBitLength Bits decoded by the first level of the literal/length tree
+	\param pHuffmanLength Pointer to the literal/length huffman tree
+
+***************************************/
+
+void BURGER_API Burger::DecompressDeflate::BuildFastLiteralTable(Word32 *pTable,Word uBitLength,const DeflateHuft_t *pHuffmanLength)
+{
+	if (uBitLength>FAST_LITERALBITS) {
+		// Codes too long to be indexed, always walk the tree
+		MemoryClear(pTable,sizeof(Word32)<<FAST_LITERALBITS);
+	} else {
+		Word uMaskLength = g_DeflateMask[uBitLength];
+		Word uIndex = 0;
+		do {
+			const DeflateHuft_t *pHuffman = pHuffmanLength + (uIndex & uMaskLength);
+			Word32 uEntry = 0;
+			if (!pHuffman->m_bExtraOperation) {
+				Word uBitCount = pHuffman->m_bBitCount;
+				uEntry = 0x01000000U | (static_cast<Word32>(pHuffman->m_uBase)<<8U) | uBitCount;
+				// Is there a second literal in the remaining bits?
+				const DeflateHuft_t *pSecond = pHuffmanLength + ((uIndex>>uBitCount) & uMaskLength);
+				if (!pSecond->m_bExtraOperation && ((uBitCount+pSecond->m_bBitCount)<=FAST_LITERALBITS)) {
+					uEntry = 0x02000000U | (static_cast<Word32>(pSecond->m_uBase)<<16U) |
+						(static_cast<Word32>(pHuffman->m_uBase)<<8U) | (uBitCount+pSecond->m_bBitCount);
+				}
+			}
+			pTable[uIndex] = uEntry;
+		} while (++uIndex<(1U<<FAST_LITERALBITS));
+	}
+}
+
 /*! ************************************
 
 	\brief Optimized decompression code
 
-	Called with number of bytes left to write in window at least 258
-	(the maximum string length) and number of input bytes available
-	at least ten. The ten bytes are six bytes for the longest length/
-	distance pair plus four bytes for overloading the bit buffer.
+	Called with number of bytes left to write in window at least
+	\ref FAST_WINDOWMINIMUM (the maximum string length plus room
+	for the last eight byte copy to overrun) and number of input bytes
+	available at least \ref FAST_INPUTMINIMUM.
+
+	The bit bucket is 64 bits wide and is refilled once per symbol
+	with an unaligned eight byte load, which is always enough for a
+	complete length/distance pair. Runs of literals are decoded one or
+	two at a time with m_FastLiteralTable and matches that don't
+	overlap by less than eight bytes are copied eight bytes at a time.
+
+	When the input or the window runs low, ProcessCodes() takes
+	over with its byte at a time decoder.
 
 	\param uBitLength Length of the bit stream
 	\param uBitDistance Bit distance for huffman decoding
@@ -360,10 +420,17 @@ int Burger::DecompressDeflate::Flush(int iErrorCode)
 
 int Burger::DecompressDeflate::Fast(Word uBitLength,Word uBitDistance,const DeflateHuft_t *pHuffmanLength,const DeflateHuft_t *pHuffmanDistance)
 {
+	// Build the literal table on first use for this tree
+	if (m_pFastLiteralTree!=pHuffmanLength) {
+		BuildFastLiteralTable(m_FastLiteralTable,uBitLength,pHuffmanLength);
+		m_pFastLiteralTree = pHuffmanLength;
+	}
+	const Word32 *pFastTable = m_FastLiteralTable;
+
 	// load input, output, bit values
 	const Word8 *pInput=m_pInput;
 	WordPtr uInputLength=m_uInputChunkLength;
-	Word32 uBitBucket=m_uBitBucket;
+	Word64 uBitBucket=m_uBitBucket;
 	Word uBitCount=m_uBitCount;
 	Word8 *pWindowWrite=m_pWindowWrite;
 	WordPtr uRemainingWindow=static_cast<WordPtr>(pWindowWrite<m_pWindowRead?(m_pWindowRead-pWindowWrite-1):&m_WindowBuffer[1<<MAX_WBITS]-pWindowWrite);
@@ -374,17 +441,31 @@ int Burger::DecompressDeflate::Fast(Word uBitLength,Word uBitDistance,const Defl
 
 	int iErrorCode;
 	// do until not enough input or output space for fast loop
-	do {		
-		// assume called with m >= 258 && n >= 10
-		// get literal/length code
-		while (uBitCount<20) {
-			--uInputLength;
-			uBitBucket|=(static_cast<Word32>(pInput[0]))<<uBitCount;
-			++pInput;
-			uBitCount+=8;
+	do {
+		// Top off the bit bucket to at least 56 bits. Bits above uBitCount
+		// may hold part of the next byte, which is reloaded in place on
+		// the next refill
+		uBitBucket |= LittleEndian::LoadAny(reinterpret_cast<const Word64 *>(pInput))<<uBitCount;
+		WordPtr uStep = (63U-uBitCount)>>3U;
+		pInput += uStep;
+		uInputLength -= uStep;
+		uBitCount |= 56U;
+
+		// One or two literals?
+		Word32 uFast = pFastTable[static_cast<Word>(uBitBucket) & ((1U<<FAST_LITERALBITS)-1U)];
+		if (uFast) {
+			uBitBucket>>=(uFast&0xFFU);
+			uBitCount-=(uFast&0xFFU);
+			pWindowWrite[0] = static_cast<Word8>(uFast>>8U);
+			pWindowWrite[1] = static_cast<Word8>(uFast>>16U);
+			uFast >>= 24U;
+			pWindowWrite += uFast;
+			uRemainingWindow -= uFast;
+			continue;
 		}
+
 		// max bits for literal/length code
-		const DeflateHuft_t *pHuffman = pHuffmanLength + (uBitBucket & uMaskLength);
+		const DeflateHuft_t *pHuffman = pHuffmanLength + (static_cast<Word>(uBitBucket) & uMaskLength);
 		Word uExtra = pHuffman->m_bExtraOperation;
 		if (!uExtra) {
 			// Literal code
@@ -402,34 +483,21 @@ int Burger::DecompressDeflate::Fast(Word uBitLength,Word uBitDistance,const Defl
 			if (uExtra & 0x10) {
 				// Get extra bits for length
 				uExtra &= 0xF;
-				WordPtr uBytesToCopy = pHuffman->m_uBase + (uBitBucket & g_DeflateMask[uExtra]);
+				WordPtr uBytesToCopy = pHuffman->m_uBase + (static_cast<Word>(uBitBucket) & g_DeflateMask[uExtra]);
 				uBitBucket>>=uExtra;
 				uBitCount-=uExtra;
 
-				// Decode distance base of block to copy
-				while (uBitCount<15) {
-					--uInputLength;
-					uBitBucket|=static_cast<Word32>(pInput[0])<<uBitCount;
-					++pInput;
-					uBitCount+=8;
-				}
-				// max bits for distance code
-				pHuffman = pHuffmanDistance + (uBitBucket & uMaskDistance);
+				// max bits for distance code (No refill needed, a length/distance
+				// pair is at most 48 bits)
+				pHuffman = pHuffmanDistance + (static_cast<Word>(uBitBucket) & uMaskDistance);
 				uExtra = pHuffman->m_bExtraOperation;
 				for (;;) {
 					uBitBucket>>=pHuffman->m_bBitCount;
 					uBitCount-=pHuffman->m_bBitCount;
 					if (uExtra & 0x10) {
-						// get extra bits to add to distance base
+						// get extra bits (up to 13) to add to distance base
 						uExtra &= 0xF;
-						while (uBitCount<uExtra) {
-							--uInputLength;
-							uBitBucket|=static_cast<Word32>(pInput[0])<<uBitCount;
-							++pInput;
-							uBitCount+=8;
-						}
-						// get extra bits (up to 13)
-						WordPtr uDistance = pHuffman->m_uBase + (uBitBucket & g_DeflateMask[uExtra]);
+						WordPtr uDistance = pHuffman->m_uBase + (static_cast<Word>(uBitBucket) & g_DeflateMask[uExtra]);
 						uBitBucket>>= uExtra;
 						uBitCount-=uExtra;
 
@@ -438,13 +506,27 @@ int Burger::DecompressDeflate::Fast(Word uBitLength,Word uBitDistance,const Defl
 						const Word8 *pSourceCopy;
 						// offset before dest
 						if (static_cast<WordPtr>(pWindowWrite - m_WindowBuffer) >= uDistance) {
-							// just copy
 							pSourceCopy = pWindowWrite - uDistance;
+							if (uDistance>=8) {
+								// Eight bytes at a time, the source is always
+								// at least eight bytes behind so every load
+								// reads finished data. The overrun is covered
+								// by FAST_WINDOWMINIMUM.
+								Word8 *pEnd = pWindowWrite+uBytesToCopy;
+								do {
+									NativeEndian::StoreAny(reinterpret_cast<Word64 *>(pWindowWrite),
+										NativeEndian::LoadAny(reinterpret_cast<const Word64 *>(pSourceCopy)));
+									pSourceCopy+=8;
+									pWindowWrite+=8;
+								} while (pWindowWrite<pEnd);
+								pWindowWrite = pEnd;
+								break;
+							}
 							pWindowWrite[0] = pSourceCopy[0];		// minimum count is three,
 							pWindowWrite[1] = pSourceCopy[1];		// so unroll loop a little
 							pSourceCopy+=2;
 							pWindowWrite+=2;
-							uBytesToCopy-=2;				
+							uBytesToCopy-=2;
 						} else {
 							// else offset after destination
 							// bytes from offset to end
@@ -472,7 +554,7 @@ int Burger::DecompressDeflate::Fast(Word uBitLength,Word uBitDistance,const Defl
 						iErrorCode = Z_DATA_ERROR;
 						goto ByeBye;
 					}
-					pHuffman = pHuffman + pHuffman->m_uBase + (uBitBucket & g_DeflateMask[uExtra]);
+					pHuffman = pHuffman + pHuffman->m_uBase + (static_cast<Word>(uBitBucket) & g_DeflateMask[uExtra]);
 					uExtra = pHuffman->m_bExtraOperation;
 				}
 				break;
@@ -485,7 +567,7 @@ int Burger::DecompressDeflate::Fast(Word uBitLength,Word uBitDistance,const Defl
 				iErrorCode = Z_DATA_ERROR;
 				goto ByeBye;
 			}
-			pHuffman = pHuffman + pHuffman->m_uBase + (uBitBucket & g_DeflateMask[uExtra]);
+			pHuffman = pHuffman + pHuffman->m_uBase + (static_cast<Word>(uBitBucket) & g_DeflateMask[uExtra]);
 			uExtra = pHuffman->m_bExtraOperation;
 			if (!uExtra) {
 				uBitBucket>>=pHuffman->m_bBitCount;
@@ -496,17 +578,20 @@ int Burger::DecompressDeflate::Fast(Word uBitLength,Word uBitDistance,const Defl
 				break;
 			}
 		}
-	} while ((uRemainingWindow >= 258) && (uInputLength >= 10));
+	} while ((uRemainingWindow >= FAST_WINDOWMINIMUM) && (uInputLength >= FAST_INPUTMINIMUM));
 
 	// Not enough input or output--restore pointers and return
 	iErrorCode = Z_OK;
 ByeBye:;
+	// Return whole unused bytes that came from this input chunk. What's left
+	// is never more than the 32 bits the bucket held on entry.
 	WordPtr uUsed = static_cast<WordPtr>(m_uInputChunkLength-uInputLength);
 	uUsed = (uBitCount>>3U) < uUsed ? (uBitCount>>3U) : uUsed;
 	uInputLength+=uUsed;
 	pInput-=uUsed;
 	uBitCount-=static_cast<Word>(uUsed)<<3U;
-	m_uBitBucket=uBitBucket;
+	// Discard any partial byte above the valid bits
+	m_uBitBucket=static_cast<Word32>(uBitBucket & ((static_cast<Word64>(1U)<<uBitCount)-1U));
 	m_uBitCount=uBitCount;
 	m_uInputChunkLength=uInputLength;
 	m_pInput=pInput;
@@ -543,7 +628,7 @@ int Burger::DecompressDeflate::ProcessCodes(int iErrorCode)
 		// Starting?
 		case CODES_START:
 			// Fast decompression?
-			if ((uRemainingWindow >= 258) && (uInputLength >= 10)) {
+			if ((uRemainingWindow >= FAST_WINDOWMINIMUM) && (uInputLength >= FAST_INPUTMINIMUM)) {
 				m_uBitBucket=uBitBucket;
 				m_uBitCount=uBitCount;
 				m_uInputChunkLength=uInputLength;
@@ -781,6 +866,11 @@ void Burger::DecompressDeflate::CodesReset(Word bCodeLengthBits,Word bCodeDistan
 	m_uCodeCopyDistance = 0;
 	m_pCodeTreeLength = pCodeTreeLength;
 	m_pCodeTreeDistance = pCodeTreeDistance;
+	// Dynamic trees reuse m_HuffmanTable, so only the fixed tree's
+	// literal table survives to the next block
+	if (pCodeTreeLength!=s_FixedTreeLiteral) {
+		m_pFastLiteralTree = NULL;
+	}
 	m_bCodeLengthBits = static_cast<Word8>(bCodeLengthBits);
 	m_bCodeDistanceBits = static_cast<Word8>(bCodeDistanceBits);
 }
@@ -1172,6 +1262,7 @@ void Burger::DecompressDeflate::BlocksReset(void)
 	m_uBitBucket = 0;
 	m_pWindowRead = m_WindowBuffer;
 	m_pWindowWrite = m_WindowBuffer;
+	m_pFastLiteralTree = NULL;
 	m_uAlder32Checksum = 1;
 }
 
@@ -1501,11 +1592,66 @@ Burger::DecompressDeflate::DecompressDeflate() :
 	Decompress(),
 	m_pInput(NULL),
 	m_pOutput(NULL),
-	m_pTreesLengths(NULL)
+	m_pTreesLengths(NULL),
+	m_uDictionaryCount(0)
 {
 	Reset();
 }
 
+/*! ************************************
+
+	\brief Add a preset dictionary
+
+	Streams created with CompressDeflate::SetDictionary() start
+	with the Adler32 of the dictionary that was used. When one of
+	these streams is decompressed, the matching dictionary is found
+	in the list and loaded into the window before the first block,
+	so matches can reference it.
+
+	The data is not copied, it must remain valid until
+	ClearDictionaries() is called or this class is destroyed.
+	Dictionaries persist across calls to Reset().
+
+	\param pDictionary Pointer to the dictionary
+	\param uLength Size of the dictionary in bytes
+	\return Zero if successful, non-zero if the dictionary list is full
+
+	\sa ClearDictionaries() or CompressDeflate::SetDictionary(const void *,WordPtr)
+
+***************************************/
+
+Word BURGER_API Burger::DecompressDeflate::AddDictionary(const void *pDictionary,WordPtr uLength)
+{
+	Word uCount = m_uDictionaryCount;
+	if (uCount>=MAXDICTIONARIES) {
+		return TRUE;
+	}
+	Dictionary_t *pEntry = &m_Dictionaries[uCount];
+	pEntry->m_pData = static_cast<const Word8 *>(pDictionary);
+	pEntry->m_uLength = uLength;
+	pEntry->m_uID = CalcAdler32(pDictionary,uLength);
+	m_uDictionaryCount = uCount+1;
+	return FALSE;
+}
+
+/*! ************************************
+
+	\fn void Burger::DecompressDeflate::ClearDictionaries(void)
+	\brief Remove all preset dictionaries
+
+	\sa AddDictionary(const void *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::DecompressDeflate::GetDictionaryCount(void) const
+	\brief Return the number of preset dictionaries
+
+	\return Number of dictionaries added with AddDictionary(const void *,WordPtr)
+
+***************************************/
+
 /*! ************************************
 
 	\brief Release any allocated memory
@@ -1647,13 +1793,37 @@ Burger::Decompress::eError Burger::DecompressDeflate::Process(void *pOutput,Word
 				m_uChecksumInStream += static_cast<Word32>(static_cast<const Word8 *>(pInput)[0]);
 				pInput = static_cast<const Word8 *>(pInput)+1;
 				m_eState = STATE_DICT0;
-				iError = Z_NEED_DICT;
-				break;
 
+			// Find the dictionary the data was compressed with
 			case STATE_DICT0:
-				m_eState = STATE_ABORT;
-				iError = Z_STREAM_ERROR;
-				break;
+				{
+					const Dictionary_t *pDictionary = m_Dictionaries;
+					Word uCount = m_uDictionaryCount;
+					while (uCount && (pDictionary->m_uID!=m_uChecksumInStream)) {
+						++pDictionary;
+						--uCount;
+					}
+					if (!uCount) {
+						m_eState = STATE_ABORT;
+						iError = Z_NEED_DICT;
+						break;
+					}
+					// Preload the window as if the dictionary was
+					// already decompressed, only the last 32K can be
+					// referenced
+					WordPtr uLength = pDictionary->m_uLength;
+					const Word8 *pData = pDictionary->m_pData;
+					if (uLength>((1U<<MAX_WBITS)-1U)) {
+						pData += uLength-((1U<<MAX_WBITS)-1U);
+						uLength = (1U<<MAX_WBITS)-1U;
+					}
+					MemoryCopy(m_WindowBuffer,pData,uLength);
+					m_pWindowRead = m_WindowBuffer+uLength;
+					m_pWindowWrite = m_WindowBuffer+uLength;
+				}
+				m_eState = STATE_BLOCKS;
+				iError = Z_OK;
+				continue;
 
 			// Decompress with blocks
 
@@ -1768,12 +1938,47 @@ Burger::Decompress::eError Burger::DecompressDeflate::Process(void *pOutput,Word
 }
 
 
+#if !defined(DOXYGEN)
+
+//
+// Top off a 64 bit bit bucket to at least 56 bits. Past the end of the
+// input, zeros are inserted and counted in uOverread so truncated data
+// can be detected
+//
+
+static BURGER_INLINE void OneShotRefill(Word64 &uBitBucket,Word &uBitCount,const Word8 *&pInput,const Word8 *pInputEnd,WordPtr &uOverread)
+{
+	if (static_cast<WordPtr>(pInputEnd-pInput)>=8) {
+		uBitBucket |= Burger::LittleEndian::LoadAny(reinterpret_cast<const Word64 *>(pInput))<<uBitCount;
+		pInput += (63U-uBitCount)>>3U;
+		uBitCount |= 56U;
+	} else {
+		while (uBitCount<=56) {
+			if (pInput<pInputEnd) {
+				uBitBucket |= static_cast<Word64>(pInput[0])<<uBitCount;
+				++pInput;
+			} else {
+				++uOverread;
+			}
+			uBitCount+=8;
+		}
+	}
+}
+
+#endif
+
 /*! ************************************
 
 	\brief Decompress data using Deflate compression
 
 	Using the Deflate (ZLIB) compression algorithm, decompress the data in one pass
 
+	Since the entire compressed and decompressed buffers are present, the
+	output buffer is used as the history for matches, so unlike
+	DecompressDeflate::Process() there is no 32K sliding window to
+	allocate or to copy the data through. Only the space for the huffman
+	trees is allocated.
+
 	\param pOutput Pointer to the buffer to accept the decompressed data
 	\param uOutputChunkLength Number of bytes in the output buffer
 	\param pInput Pointer to data to compress
@@ -1786,11 +1991,320 @@ Burger::Decompress::eError Burger::DecompressDeflate::Process(void *pOutput,Word
 
 Burger::Decompress::eError BURGER_API Burger::SimpleDecompressDeflate(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
 {
-	DecompressDeflate *pDecompress = New<DecompressDeflate>();
-	pDecompress->DecompressDeflate::Reset();
-	Decompress::eError uError = pDecompress->DecompressDeflate::Process(pOutput,uOutputChunkLength,pInput,uInputChunkLength);
-	Delete(pDecompress);
-	return uError;
+	const Word8 *pWork = static_cast<const Word8 *>(pInput);
+	const Word8 *pInputEnd = pWork+uInputChunkLength;
+	Word8 *pOutputStart = static_cast<Word8 *>(pOutput);
+	Word8 *pDest = pOutputStart;
+	Word8 *pDestEnd = pOutputStart+uOutputChunkLength;
+
+	// Parse the zlib header, preset dictionaries are not supported
+	if (uInputChunkLength<2) {
+		return Decompress::DECOMPRESS_OUTPUTUNDERRUN;
+	}
+	Word uMethod = pWork[0];
+	Word uFlag = pWork[1];
+	if (((uMethod & 0xf) != DecompressDeflate::Z_DEFLATED) ||
+		(((uMethod >> 4U) + 8U) > DecompressDeflate::MAX_WBITS) ||
+		(((uMethod << 8U) + uFlag) % 31U) ||
+		(uFlag & DecompressDeflate::PRESET_DICT)) {
+		return Decompress::DECOMPRESS_BADINPUT;
+	}
+	pWork+=2;
+
+	// Tree space is all that's needed
+	DecompressDeflate::OneShot_t *pTrees = static_cast<DecompressDeflate::OneShot_t *>(Alloc(sizeof(DecompressDeflate::OneShot_t)));
+	if (!pTrees) {
+		return Decompress::DECOMPRESS_BADINPUT;
+	}
+	const DecompressDeflate::DeflateHuft_t *pFastTree = NULL;
+
+	Word64 uBitBucket = 0;
+	Word uBitCount = 0;
+	WordPtr uOverread = 0;
+	Decompress::eError uResult = Decompress::DECOMPRESS_OKAY;
+	Word bLastBlock;
+	do {
+		OneShotRefill(uBitBucket,uBitCount,pWork,pInputEnd,uOverread);
+		bLastBlock = static_cast<Word>(uBitBucket) & 1U;
+		Word uType = (static_cast<Word>(uBitBucket)>>1U) & 3U;
+		uBitBucket>>=3U;
+		uBitCount-=3;
+
+		// Stored block?
+		if (!uType) {
+			// Go to the byte boundary and give back the whole bytes
+			uBitCount &= (~7U);
+			WordPtr uReturn = uBitCount>>3U;
+			if (uReturn<uOverread) {
+				uResult = Decompress::DECOMPRESS_OUTPUTUNDERRUN;
+				break;
+			}
+			pWork -= uReturn-uOverread;
+			uBitBucket = 0;
+			uBitCount = 0;
+			uOverread = 0;
+			if (static_cast<WordPtr>(pInputEnd-pWork)<4) {
+				uResult = Decompress::DECOMPRESS_OUTPUTUNDERRUN;
+				break;
+			}
+			Word uLength = LittleEndian::LoadAny(reinterpret_cast<const Word16 *>(pWork));
+			if ((uLength^0xFFFFU) != static_cast<Word>(LittleEndian::LoadAny(reinterpret_cast<const Word16 *>(pWork+2)))) {
+				uResult = Decompress::DECOMPRESS_BADINPUT;
+				break;
+			}
+			pWork+=4;
+			if (static_cast<WordPtr>(pInputEnd-pWork)<uLength) {
+				uResult = Decompress::DECOMPRESS_OUTPUTUNDERRUN;
+				break;
+			}
+			if (static_cast<WordPtr>(pDestEnd-pDest)<uLength) {
+				uResult = Decompress::DECOMPRESS_OUTPUTOVERRUN;
+				break;
+			}
+			MemoryCopy(pDest,pWork,uLength);
+			pDest+=uLength;
+			pWork+=uLength;
+			continue;
+		}
+
+		const DecompressDeflate::DeflateHuft_t *pHuffmanLength;
+		const DecompressDeflate::DeflateHuft_t *pHuffmanDistance;
+		Word uBitLength;
+		Word uBitDistance;
+		if (uType==1) {
+			// Fixed trees
+			pHuffmanLength = DecompressDeflate::s_FixedTreeLiteral;
+			pHuffmanDistance = DecompressDeflate::s_FixedTreeDistance;
+			uBitLength = DecompressDeflate::FIXED_BLOCKLENGTH;
+			uBitDistance = DecompressDeflate::FIXED_BLOCKDISTANCE;
+		} else if (uType==2) {
+			// Dynamic trees, get the table lengths (14 bits)
+			Word uTable = static_cast<Word>(uBitBucket) & 0x3fffU;
+			uBitBucket>>=14U;
+			uBitCount-=14;
+			if (((uTable & 0x1f) > 29) || (((uTable >> 5) & 0x1f) > 29)) {
+				uResult = Decompress::DECOMPRESS_BADINPUT;
+				break;
+			}
+			Word *pLengths = pTrees->m_TreesLengths;
+			Word uCount = 4 + (uTable >> 10);
+			Word i = 0;
+			do {
+				if (uBitCount<3) {
+					OneShotRefill(uBitBucket,uBitCount,pWork,pInputEnd,uOverread);
+				}
+				pLengths[g_DeflateBorder[i]] = static_cast<Word>(uBitBucket) & 7U;
+				uBitBucket>>=3U;
+				uBitCount-=3;
+			} while (++i<uCount);
+			do {
+				pLengths[g_DeflateBorder[i]] = 0;
+			} while (++i<19);
+
+			Word uDepth = 7;
+			DecompressDeflate::DeflateHuft_t *pTreesHuffman;
+			if (DecompressDeflate::TreesBits(pLengths,&uDepth,&pTreesHuffman,pTrees->m_HuffmanTable) != Z_OK) {
+				uResult = Decompress::DECOMPRESS_BADINPUT;
+				break;
+			}
+
+			// Decode the literal/length and distance code lengths
+			uCount = 258 + (uTable & 0x1f) + ((uTable >> 5) & 0x1f);
+			i = 0;
+			do {
+				OneShotRefill(uBitBucket,uBitCount,pWork,pInputEnd,uOverread);
+				const DecompressDeflate::DeflateHuft_t *pHuffman = pTreesHuffman + (static_cast<Word>(uBitBucket) & g_DeflateMask[uDepth]);
+				Word uBits = pHuffman->m_bBitCount;
+				Word uCode = pHuffman->m_uBase;
+				uBitBucket>>=uBits;
+				uBitCount-=uBits;
+				if (uCode < 16) {
+					pLengths[i++] = uCode;
+				} else {
+					// 16 repeats the previous length, 17 and 18 repeat zero
+					Word uExtraBits;
+					Word uRepeat;
+					if (uCode==18) {
+						uExtraBits = 7;
+						uRepeat = 11;
+					} else {
+						uExtraBits = uCode-14U;
+						uRepeat = 3;
+					}
+					uRepeat += static_cast<Word>(uBitBucket) & g_DeflateMask[uExtraBits];
+					uBitBucket>>=uExtraBits;
+					uBitCount-=uExtraBits;
+					if (((i+uRepeat) > uCount) || ((uCode == 16) && !i)) {
+						break;
+					}
+					Word uValue = (uCode == 16) ? pLengths[i-1] : 0;
+					do {
+						pLengths[i++] = uValue;
+					} while (--uRepeat);
+				}
+			} while (i<uCount);
+			if (i!=uCount) {
+				uResult = Decompress::DECOMPRESS_BADINPUT;
+				break;
+			}
+			DecompressDeflate::DeflateHuft_t *pNewLength;
+			DecompressDeflate::DeflateHuft_t *pNewDistance;
+			uBitLength = 9;
+			uBitDistance = 6;
+			if (DecompressDeflate::TreesDynamic(257 + (uTable & 0x1f),1 + ((uTable >> 5) & 0x1f),pLengths,&uBitLength,&uBitDistance,&pNewLength,&pNewDistance,pTrees->m_HuffmanTable) != Z_OK) {
+				uResult = Decompress::DECOMPRESS_BADINPUT;
+				break;
+			}
+			pHuffmanLength = pNewLength;
+			pHuffmanDistance = pNewDistance;
+			// The literal table is always rebuilt for a dynamic tree
+			pFastTree = NULL;
+		} else {
+			uResult = Decompress::DECOMPRESS_BADINPUT;
+			break;
+		}
+
+		if (pFastTree!=pHuffmanLength) {
+			DecompressDeflate::BuildFastLiteralTable(pTrees->m_FastLiteralTable,uBitLength,pHuffmanLength);
+			pFastTree = pHuffmanLength;
+		}
+		const Word32 *pFastTable = pTrees->m_FastLiteralTable;
+		Word uMaskLength = g_DeflateMask[uBitLength];
+		Word uMaskDistance = g_DeflateMask[uBitDistance];
+
+		// Decode the symbols, a refill is enough for a length/distance pair
+		for (;;) {
+			OneShotRefill(uBitBucket,uBitCount,pWork,pInputEnd,uOverread);
+			if (uOverread>8) {
+				// Ran past the end of the input
+				uResult = Decompress::DECOMPRESS_OUTPUTUNDERRUN;
+				break;
+			}
+			WordPtr uRemaining = static_cast<WordPtr>(pDestEnd-pDest);
+			if (uRemaining>=DecompressDeflate::FAST_WINDOWMINIMUM) {
+				// One or two literals?
+				Word32 uFast = pFastTable[static_cast<Word>(uBitBucket) & ((1U<<DecompressDeflate::FAST_LITERALBITS)-1U)];
+				if (uFast) {
+					uBitBucket>>=(uFast&0xFFU);
+					uBitCount-=(uFast&0xFFU);
+					pDest[0] = static_cast<Word8>(uFast>>8U);
+					pDest[1] = static_cast<Word8>(uFast>>16U);
+					pDest += uFast>>24U;
+					continue;
+				}
+			}
+
+			// Walk the literal/length tree
+			const DecompressDeflate::DeflateHuft_t *pHuffman = pHuffmanLength + (static_cast<Word>(uBitBucket) & uMaskLength);
+			Word uExtra = pHuffman->m_bExtraOperation;
+			while (uExtra && !(uExtra & 0x50)) {
+				uBitBucket>>=pHuffman->m_bBitCount;
+				uBitCount-=pHuffman->m_bBitCount;
+				pHuffman = pHuffman + pHuffman->m_uBase + (static_cast<Word>(uBitBucket) & g_DeflateMask[uExtra]);
+				uExtra = pHuffman->m_bExtraOperation;
+			}
+			uBitBucket>>=pHuffman->m_bBitCount;
+			uBitCount-=pHuffman->m_bBitCount;
+			if (!uExtra) {
+				// Literal
+				if (!uRemaining) {
+					uResult = Decompress::DECOMPRESS_OUTPUTOVERRUN;
+					break;
+				}
+				pDest[0] = static_cast<Word8>(pHuffman->m_uBase);
+				++pDest;
+				continue;
+			}
+			if (!(uExtra & 0x10)) {
+				// End of block or invalid code
+				if (!(uExtra & 0x20)) {
+					uResult = Decompress::DECOMPRESS_BADINPUT;
+				}
+				break;
+			}
+			uExtra &= 0xF;
+			WordPtr uBytesToCopy = pHuffman->m_uBase + (static_cast<Word>(uBitBucket) & g_DeflateMask[uExtra]);
+			uBitBucket>>=uExtra;
+			uBitCount-=uExtra;
+
+			// Walk the distance tree
+			pHuffman = pHuffmanDistance + (static_cast<Word>(uBitBucket) & uMaskDistance);
+			uExtra = pHuffman->m_bExtraOperation;
+			while (uExtra && !(uExtra & 0x50)) {
+				uBitBucket>>=pHuffman->m_bBitCount;
+				uBitCount-=pHuffman->m_bBitCount;
+				pHuffman = pHuffman + pHuffman->m_uBase + (static_cast<Word>(uBitBucket) & g_DeflateMask[uExtra]);
+				uExtra = pHuffman->m_bExtraOperation;
+			}
+			uBitBucket>>=pHuffman->m_bBitCount;
+			uBitCount-=pHuffman->m_bBitCount;
+			if (!(uExtra & 0x10)) {
+				uResult = Decompress::DECOMPRESS_BADINPUT;
+				break;
+			}
+			uExtra &= 0xF;
+			WordPtr uDistance = pHuffman->m_uBase + (static_cast<Word>(uBitBucket) & g_DeflateMask[uExtra]);
+			uBitBucket>>=uExtra;
+			uBitCount-=uExtra;
+
+			// The history is the output buffer
+			if (uDistance>static_cast<WordPtr>(pDest-pOutputStart)) {
+				uResult = Decompress::DECOMPRESS_BADINPUT;
+				break;
+			}
+			if (uBytesToCopy>uRemaining) {
+				uResult = Decompress::DECOMPRESS_OUTPUTOVERRUN;
+				break;
+			}
+			const Word8 *pSourceCopy = pDest-uDistance;
+			if ((uDistance>=8) && (uRemaining>=DecompressDeflate::FAST_WINDOWMINIMUM)) {
+				// Eight bytes at a time, overrun is covered by the slack
+				Word8 *pEnd = pDest+uBytesToCopy;
+				do {
+					NativeEndian::StoreAny(reinterpret_cast<Word64 *>(pDest),
+						NativeEndian::LoadAny(reinterpret_cast<const Word64 *>(pSourceCopy)));
+					pSourceCopy+=8;
+					pDest+=8;
+				} while (pDest<pEnd);
+				pDest = pEnd;
+			} else {
+				do {
+					pDest[0] = pSourceCopy[0];
+					++pSourceCopy;
+					++pDest;
+				} while (--uBytesToCopy);
+			}
+		}
+	} while ((uResult==Decompress::DECOMPRESS_OKAY) && !bLastBlock);
+	Free(pTrees);
+
+	// Give back the whole bytes still in the bit bucket
+	WordPtr uReturn = uBitCount>>3U;
+	if (uReturn<uOverread) {
+		// Zeros past the end of the input were used, it was truncated
+		return Decompress::DECOMPRESS_OUTPUTUNDERRUN;
+	}
+	if (uResult!=Decompress::DECOMPRESS_OKAY) {
+		return uResult;
+	}
+	pWork -= uReturn-uOverread;
+
+	// Test the checksum
+	if (static_cast<WordPtr>(pInputEnd-pWork)<4) {
+		return Decompress::DECOMPRESS_OUTPUTUNDERRUN;
+	}
+	if (CalcAdler32(pOutputStart,static_cast<WordPtr>(pDest-pOutputStart)) != BigEndian::LoadAny(reinterpret_cast<const Word32 *>(pWork))) {
+		return Decompress::DECOMPRESS_BADINPUT;
+	}
+	// Output buffer not big enough?
+	if (pDest!=pDestEnd) {
+		return Decompress::DECOMPRESS_OUTPUTUNDERRUN;
+	}
+	// Input data remaining?
+	if ((pWork+4)!=pInputEnd) {
+		return Decompress::DECOMPRESS_OUTPUTOVERRUN;
+	}
+	return Decompress::DECOMPRESS_OKAY;
 }
 
 /*! ************************************
@@ -34,7 +34,7 @@ protected:
 		STATE_DICT3,	///< Three dictionary check bytes to go
 		STATE_DICT2,	///< Two dictionary check bytes to go
 		STATE_DICT1,	///< One dictionary check byte to go
-		STATE_DICT0,	///< Waiting for inflateSetDictionary
+		STATE_DICT0,	///< Looking up the preset dictionary
 		STATE_BLOCKS,	///< Decompressing blocks
 		STATE_CHECK4,	///< Four check bytes to go
 		STATE_CHECK3,	///< Three check bytes to go
@@ -75,7 +75,17 @@ protected:
 		MAX_WBITS=15,				///< Maximum bits for the depth of the huffman tree
 		MAXTREEDYNAMICSIZE=1440,	///< Maximum size of the dynamic tree
 		PRESET_DICT=0x20,			///< Preset dictionary flag in zlib header
-		Z_DEFLATED=8				///< ZLib flag for deflation decompression
+		Z_DEFLATED=8,				///< ZLib flag for deflation decompression
+		FAST_LITERALBITS=11,		///< Bits decoded per lookup in the multiple literal table
+		FAST_WINDOWMINIMUM=258+8,	///< Window space needed by Fast() (Longest match plus word copy overrun)
+		FAST_INPUTMINIMUM=8,		///< Input bytes needed by Fast() (One 64 bit refill)
+		MAXDICTIONARIES=8			///< Maximum number of preset dictionaries
+	};
+
+	struct Dictionary_t {
+		const Word8 *m_pData;		///< Pointer to the dictionary
+		WordPtr m_uLength;			///< Size of the dictionary in bytes
+		Word32 m_uID;				///< Adler32 of the dictionary, as found in the zlib header
 	};
 
 	struct DeflateHuft_t {
@@ -84,6 +94,12 @@ protected:
 		Word16 m_uBase;				///< Literal, length base, distance base, or table offset
 	};
 
+	struct OneShot_t {
+		DeflateHuft_t m_HuffmanTable[MAXTREEDYNAMICSIZE];	///< Tree space for dynamic blocks
+		Word32 m_FastLiteralTable[1<<FAST_LITERALBITS];	///< One or two literals per lookup
+		Word m_TreesLengths[258+31+31];	///< Bit lengths of the dynamic codes
+	};
+
 	const Word8 *m_pInput;		///< Packed data pointer
 	Word8 *m_pOutput;			///< Output data pointer
 	const Word8 *m_pWindowRead;	///< Window read pointer
@@ -91,6 +107,7 @@ protected:
 	const DeflateHuft_t *m_pCodeTree;	///< Pointer into tree
 	const DeflateHuft_t *m_pCodeTreeLength;	///< Pointer to literal/length/eob tree
 	const DeflateHuft_t *m_pCodeTreeDistance;	///< Pointer distance tree
+	const DeflateHuft_t *m_pFastLiteralTree;	///< Tree m_FastLiteralTable was built from, or \ref NULL if stale
 	Word *m_pTreesLengths;			///< Pointer to bit lengths of codes
 	DeflateHuft_t *m_pTreesHuffman;	///< Pointer to bit length decoding tree
 
@@ -118,14 +135,18 @@ protected:
 	Word m_uTreesDepth;			///< Bit length tree depth
 	Word8 m_bCodeLengthBits;	///< Length tree bits decoded per branch
 	Word8 m_bCodeDistanceBits;	///< Distance tree bits decoder per branch
+	Word m_uDictionaryCount;	///< Number of valid entries in m_Dictionaries
+	Dictionary_t m_Dictionaries[MAXDICTIONARIES];	///< Preset dictionaries for streams with a dictionary ID
 
 	Word8 m_WindowBuffer[1<<MAX_WBITS];	///< Sliding window
 	DeflateHuft_t m_HuffmanTable[MAXTREEDYNAMICSIZE];	///< Single data chunk for tree space
+	Word32 m_FastLiteralTable[1<<FAST_LITERALBITS];	///< One or two literals per lookup for Fast()
 
 	static const DeflateHuft_t s_FixedTreeLiteral[];
 	static const DeflateHuft_t s_FixedTreeDistance[];
 
 	int Flush(int iErrorCode);
+	static void BURGER_API BuildFastLiteralTable(Word32 *pTable,Word uBitLength,const DeflateHuft_t *pHuffmanLength);
 	int Fast(Word uBitLength,Word uBitDistance,const DeflateHuft_t *pHuffmanLength,const DeflateHuft_t *pHuffmanDistance);
 	int ProcessCodes(int iErrorCode);
 	void CodesReset(Word bCodeLengthBits,Word bCodeDistanceBits,const DeflateHuft_t *pCodeTreeLength,const DeflateHuft_t *pCodeTreeDistance);
@@ -134,12 +155,16 @@ protected:
 	static int TreesDynamic(Word uNumberSamples,Word uNumberDistance,const Word *pSampleCounts,Word *pNewTreeSize,Word *pNewDistanceSize,DeflateHuft_t **ppNewTree,DeflateHuft_t **ppNewDistance,DeflateHuft_t *pExistingTree);
 	void BlocksReset(void);
 	int ProcessBlocks(int iErrorCode);
+	friend Decompress::eError BURGER_API SimpleDecompressDeflate(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
 public:
 	static const Word32 Signature = 0x5A4C4942;		///< 'ZLIB'
 	DecompressDeflate();
 	virtual ~DecompressDeflate();
 	eError Reset(void) BURGER_OVERRIDE;
 	eError Process(void *pOutput, uintptr_t uOutputChunkLength,const void *pInput, uintptr_t uInputChunkLength) BURGER_OVERRIDE;
+	Word BURGER_API AddDictionary(const void *pDictionary,WordPtr uLength);
+	BURGER_INLINE void ClearDictionaries(void) { m_uDictionaryCount = 0; }
+	BURGER_INLINE Word GetDictionaryCount(void) const { return m_uDictionaryCount; }
 };
 extern Decompress::eError BURGER_API SimpleDecompressDeflate(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
 }
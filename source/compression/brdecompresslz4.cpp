@@ -0,0 +1,408 @@
+/***************************************
+
+	Decompression manager version of LZ4
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brdecompresslz4.h"
+#include "brendian.h"
+#include "brmemoryfunctions.h"
+
+#if !defined(DOXYGEN)
+BURGER_CREATE_STATICRTTI_PARENT(Burger::DecompressLZ4,Burger::Decompress);
+
+// Input needed for the fast path, a token, 16 bytes of literals read
+// at once and the offset, rounded up
+static const WordPtr g_uLZ4FastInput = 32;
+
+// Output needed for the fast path, 16 bytes of literals and 24 bytes of
+// match written at once, rounded up
+static const WordPtr g_uLZ4FastOutput = 64;
+#endif
+
+/*! ************************************
+
+	\class Burger::DecompressLZ4
+	\brief Decompress LZ4 format
+
+	Decompress data in LZ4 format (Documented here Burger::CompressLZ4 )
+
+	Like DecompressLZSS, matches are copied from the data already
+	decompressed, so if the output is split into several chunks,
+	the chunks must be contiguous in memory.
+
+	This decompressor can be registered with RezFile::LogDecompressor().
+
+	\sa Burger::Decompress and Burger::CompressLZ4
+
+***************************************/
+
+/*! ************************************
+
+	\brief Default constructor
+
+	Initializes the defaults
+
+***************************************/
+
+Burger::DecompressLZ4::DecompressLZ4() :
+	m_uBlockRemaining(0),
+	m_uLiteralLength(0),
+	m_uMatchLength(0),
+	m_uOffset(0),
+	m_uHeader(0),
+	m_uHeaderBytes(0),
+	m_eState(STATE_HEADER)
+{
+	m_uSignature = Signature;
+}
+
+/*! ************************************
+
+	\brief Reset the LZ4 decompression
+
+	\return Decompress::DECOMPRESS_OKAY (No error is possible)
+
+***************************************/
+
+Burger::Decompress::eError Burger::DecompressLZ4::Reset(void)
+{
+	m_uTotalOutput = 0;
+	m_uTotalInput = 0;
+	m_uBlockRemaining = 0;
+	m_uLiteralLength = 0;
+	m_uMatchLength = 0;
+	m_uOffset = 0;
+	m_uHeader = 0;
+	m_uHeaderBytes = 0;
+	m_eState = STATE_HEADER;
+	return DECOMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Decompress data using LZ4 compression
+
+	Using the LZ4 compression algorithm, decompress the data
+
+	When there is enough input and output space for a whole short
+	sequence, literals and matches are copied eight bytes at a time
+	without checking each state.
+
+	\param pOutput Pointer to the buffer to accept the decompressed data
+	\param uOutputChunkLength Number of bytes in the output buffer
+	\param pInput Pointer to data to compress
+	\param uInputChunkLength Number of bytes in the data to decompress
+
+	\return Decompress::eError code with zero if no failure, non-zero is an error code
+	\sa Burger::SimpleDecompressLZ4()
+
+***************************************/
+
+Burger::Decompress::eError Burger::DecompressLZ4::Process(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
+{
+	m_uInputLength = uInputChunkLength;
+	m_uOutputLength = uOutputChunkLength;
+
+	Word8 *pDest = static_cast<Word8 *>(pOutput);
+	const Word8 *pSource = static_cast<const Word8 *>(pInput);
+	// Data decompressed before this call
+	WordPtr uHistory = m_uTotalOutput-reinterpret_cast<WordPtr>(pDest);
+	eState MyState = m_eState;
+	for (;;) {
+		Word uTemp;
+		WordPtr uCount;
+		switch (MyState) {
+		case STATE_HEADER:
+			do {
+				if (!uInputChunkLength) {
+					goto Exit;
+				}
+				m_uHeader |= static_cast<Word32>(pSource[0])<<(m_uHeaderBytes<<3U);
+				++pSource;
+				--uInputChunkLength;
+			} while (++m_uHeaderBytes<4);
+			m_uHeaderBytes = 0;
+			// End of the stream?
+			if (!m_uHeader) {
+				MyState = STATE_COMPLETE;
+				goto Exit;
+			}
+			m_uBlockRemaining = m_uHeader&0x7FFFFFFFU;
+			MyState = (m_uHeader&0x80000000U) ? STATE_STORED : STATE_TOKEN;
+			m_uHeader = 0;
+			break;
+
+		case STATE_STORED:
+			uCount = m_uBlockRemaining;
+			if (uCount>uInputChunkLength) {
+				uCount = uInputChunkLength;
+			}
+			if (uCount>uOutputChunkLength) {
+				uCount = uOutputChunkLength;
+			}
+			MemoryCopy(pDest,pSource,uCount);
+			pDest += uCount;
+			pSource += uCount;
+			uInputChunkLength -= uCount;
+			uOutputChunkLength -= uCount;
+			m_uBlockRemaining -= uCount;
+			if (m_uBlockRemaining) {
+				goto Exit;
+			}
+			MyState = STATE_HEADER;
+			break;
+
+		case STATE_TOKEN:
+			// Decode whole sequences with short literal runs without
+			// going through each state. There's enough block data
+			// left that the sequence can't be the last one.
+			while ((m_uBlockRemaining>=g_uLZ4FastInput) &&
+				(uInputChunkLength>=g_uLZ4FastInput) &&
+				(uOutputChunkLength>=g_uLZ4FastOutput)) {
+				uTemp = pSource[0];
+				WordPtr uLiterals = uTemp>>4U;
+				if (uLiterals==15) {
+					break;
+				}
+				NativeEndian::StoreAny(reinterpret_cast<Word64 *>(pDest),NativeEndian::LoadAny(reinterpret_cast<const Word64 *>(pSource+1)));
+				NativeEndian::StoreAny(reinterpret_cast<Word64 *>(pDest+8),NativeEndian::LoadAny(reinterpret_cast<const Word64 *>(pSource+9)));
+				pDest += uLiterals;
+				pSource += uLiterals+1;
+				WordPtr uOffset = LittleEndian::LoadAny(reinterpret_cast<const Word16 *>(pSource));
+				pSource += 2;
+				m_uBlockRemaining -= uLiterals+3;
+				uInputChunkLength -= uLiterals+3;
+				uOutputChunkLength -= uLiterals;
+				if (!uOffset || (uOffset>(uHistory+reinterpret_cast<WordPtr>(pDest)))) {
+					goto Abort;
+				}
+				WordPtr uLength = uTemp&15U;
+				if (uLength==15) {
+					// Long match, let the states handle it
+					m_uOffset = uOffset;
+					m_uMatchLength = uLength;
+					MyState = STATE_MATCHLENGTH;
+					break;
+				}
+				uLength += 4;
+				const Word8 *pMatch = pDest-uOffset;
+				if (uOffset>=8) {
+					NativeEndian::StoreAny(reinterpret_cast<Word64 *>(pDest),NativeEndian::LoadAny(reinterpret_cast<const Word64 *>(pMatch)));
+					NativeEndian::StoreAny(reinterpret_cast<Word64 *>(pDest+8),NativeEndian::LoadAny(reinterpret_cast<const Word64 *>(pMatch+8)));
+					NativeEndian::StoreAny(reinterpret_cast<Word64 *>(pDest+16),NativeEndian::LoadAny(reinterpret_cast<const Word64 *>(pMatch+16)));
+				} else {
+					uCount = uLength;
+					Word8 *pTemp = pDest;
+					do {
+						pTemp[0] = pMatch[0];
+						++pMatch;
+						++pTemp;
+					} while (--uCount);
+				}
+				pDest += uLength;
+				uOutputChunkLength -= uLength;
+			}
+			if (MyState!=STATE_TOKEN) {
+				break;
+			}
+
+			if (!uInputChunkLength) {
+				goto Exit;
+			}
+			if (!m_uBlockRemaining) {
+				goto Abort;
+			}
+			uTemp = pSource[0];
+			++pSource;
+			--uInputChunkLength;
+			--m_uBlockRemaining;
+			m_uLiteralLength = uTemp>>4U;
+			m_uMatchLength = uTemp&15U;
+			if (m_uLiteralLength!=15) {
+				MyState = STATE_LITERALS;
+				break;
+			}
+			MyState = STATE_LITERALLENGTH;
+		case STATE_LITERALLENGTH:
+			do {
+				if (!uInputChunkLength) {
+					goto Exit;
+				}
+				if (!m_uBlockRemaining) {
+					goto Abort;
+				}
+				uTemp = pSource[0];
+				++pSource;
+				--uInputChunkLength;
+				--m_uBlockRemaining;
+				m_uLiteralLength += uTemp;
+			} while (uTemp==255);
+			MyState = STATE_LITERALS;
+		case STATE_LITERALS:
+			if (m_uLiteralLength) {
+				if (m_uLiteralLength>m_uBlockRemaining) {
+					goto Abort;
+				}
+				uCount = m_uLiteralLength;
+				if (uCount>uInputChunkLength) {
+					uCount = uInputChunkLength;
+				}
+				if (uCount>uOutputChunkLength) {
+					uCount = uOutputChunkLength;
+				}
+				MemoryCopy(pDest,pSource,uCount);
+				pDest += uCount;
+				pSource += uCount;
+				uInputChunkLength -= uCount;
+				uOutputChunkLength -= uCount;
+				m_uBlockRemaining -= uCount;
+				m_uLiteralLength -= uCount;
+				if (m_uLiteralLength) {
+					goto Exit;
+				}
+			}
+			// The last sequence of a block has no match
+			if (!m_uBlockRemaining) {
+				MyState = STATE_HEADER;
+				break;
+			}
+			m_uOffset = 0;
+			MyState = STATE_OFFSET;
+		case STATE_OFFSET:
+			do {
+				if (!uInputChunkLength) {
+					goto Exit;
+				}
+				if (!m_uBlockRemaining) {
+					goto Abort;
+				}
+				m_uOffset |= static_cast<WordPtr>(pSource[0])<<(m_uHeaderBytes<<3U);
+				++pSource;
+				--uInputChunkLength;
+				--m_uBlockRemaining;
+			} while (++m_uHeaderBytes<2);
+			m_uHeaderBytes = 0;
+			if (!m_uOffset || (m_uOffset>(uHistory+reinterpret_cast<WordPtr>(pDest)))) {
+				goto Abort;
+			}
+			if (m_uMatchLength!=15) {
+				m_uMatchLength += 4;
+				MyState = STATE_MATCH;
+				break;
+			}
+			MyState = STATE_MATCHLENGTH;
+		case STATE_MATCHLENGTH:
+			do {
+				if (!uInputChunkLength) {
+					goto Exit;
+				}
+				if (!m_uBlockRemaining) {
+					goto Abort;
+				}
+				uTemp = pSource[0];
+				++pSource;
+				--uInputChunkLength;
+				--m_uBlockRemaining;
+				m_uMatchLength += uTemp;
+			} while (uTemp==255);
+			m_uMatchLength += 4;
+			MyState = STATE_MATCH;
+		case STATE_MATCH:
+			uCount = m_uMatchLength;
+			if (uCount>uOutputChunkLength) {
+				uCount = uOutputChunkLength;
+			}
+			if (uCount) {
+				const Word8 *pMatch = pDest-m_uOffset;
+				if (m_uOffset>=uCount) {
+					MemoryCopy(pDest,pMatch,uCount);
+				} else {
+					// Overlapping copy, it's a repeating pattern
+					Word8 *pTemp = pDest;
+					WordPtr i = uCount;
+					do {
+						pTemp[0] = pMatch[0];
+						++pMatch;
+						++pTemp;
+					} while (--i);
+				}
+				pDest += uCount;
+				uOutputChunkLength -= uCount;
+				m_uMatchLength -= uCount;
+			}
+			if (m_uMatchLength) {
+				goto Exit;
+			}
+			MyState = m_uBlockRemaining ? STATE_TOKEN : STATE_HEADER;
+			break;
+
+		case STATE_COMPLETE:
+			goto Exit;
+		default:
+			goto Abort;
+		}
+	}
+Abort:;
+	MyState = STATE_ABORT;
+Exit:;
+	m_eState = MyState;
+
+	// How did the decompression go?
+
+	m_uOutputLength -= uOutputChunkLength;
+	m_uInputLength -= uInputChunkLength;
+	m_uTotalOutput += m_uOutputLength;
+	m_uTotalInput += m_uInputLength;
+
+	if (MyState==STATE_ABORT) {
+		return DECOMPRESS_BADINPUT;
+	}
+	// Output buffer not big enough?
+	if (uOutputChunkLength) {
+		return DECOMPRESS_OUTPUTUNDERRUN;
+	}
+	// Input data remaining?
+	if (uInputChunkLength) {
+		return DECOMPRESS_OUTPUTOVERRUN;
+	}
+	// End of stream marker not found yet?
+	if (MyState!=STATE_COMPLETE) {
+		return DECOMPRESS_OUTPUTUNDERRUN;
+	}
+	// Decompression is complete
+	return DECOMPRESS_OKAY;
+}
+
+/***************************************
+
+	Decompress using LZ4.
+	I assume I can decompress in one pass.
+	With everything present, nearly all of the
+	data goes through the fast path.
+
+***************************************/
+
+Burger::Decompress::eError BURGER_API Burger::SimpleDecompressLZ4(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
+{
+	Burger::DecompressLZ4 Local;
+	Local.DecompressLZ4::Reset();
+	return Local.DecompressLZ4::Process(pOutput,uOutputChunkLength,pInput,uInputChunkLength);
+}
+
+/*! ************************************
+
+	\var const Burger::StaticRTTI Burger::DecompressLZ4::g_StaticRTTI
+	\brief The global description of the class
+
+	This record contains the name of this class and a
+	reference to the parent
+
+***************************************/
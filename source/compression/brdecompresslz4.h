@@ -0,0 +1,60 @@
+/***************************************
+
+	Decompression manager version of LZ4
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRDECOMPRESSLZ4_H__
+#define __BRDECOMPRESSLZ4_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRDECOMPRESS_H__
+#include "brdecompress.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class DecompressLZ4 : public Decompress {
+	BURGER_RTTI_IN_CLASS();
+protected:
+	enum eState {
+		STATE_HEADER,			///< Get the 32 bit block header
+		STATE_TOKEN,			///< Get the literal and match length token
+		STATE_LITERALLENGTH,	///< Get extra literal length bytes
+		STATE_LITERALS,			///< Copying literals
+		STATE_OFFSET,			///< Get the 16 bit match offset
+		STATE_MATCHLENGTH,		///< Get extra match length bytes
+		STATE_MATCH,			///< Copying a match
+		STATE_STORED,			///< Copying an uncompressed block
+		STATE_COMPLETE,			///< End of stream marker found
+		STATE_ABORT				///< Bad data found (Fatal)
+	};
+	WordPtr m_uBlockRemaining;	///< Bytes left in the current block
+	WordPtr m_uLiteralLength;	///< Literals left to copy
+	WordPtr m_uMatchLength;		///< Match bytes left to copy
+	WordPtr m_uOffset;			///< Distance back to copy the match from
+	Word32 m_uHeader;			///< Block header being assembled
+	Word m_uHeaderBytes;		///< Number of bytes in m_uHeader or m_uOffset
+	eState m_eState;			///< State of the decompression
+public:
+	static const Word32 Signature = 0x4C5A3420;		///< 'LZ4 '
+	DecompressLZ4();
+	eError Reset(void) BURGER_OVERRIDE;
+	eError Process(void *pOutput, uintptr_t uOutputChunkLength,const void *pInput, uintptr_t uInputChunkLength) BURGER_OVERRIDE;
+};
+extern Decompress::eError BURGER_API SimpleDecompressLZ4(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
+}
+/* END */
+
+#endif
+
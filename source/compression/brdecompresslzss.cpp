@@ -12,9 +12,167 @@
 ***************************************/
 
 #include "brdecompresslzss.h"
+#include "brendian.h"
 
 #if !defined(DOXYGEN)
 BURGER_CREATE_STATICRTTI_PARENT(Burger::DecompressLZSS,Burger::Decompress);
+
+// Number of consecutive literal flags in a nibble
+static const Word8 g_LiteralRunLZSS[16] = {
+	0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4
+};
+
+//
+// Copy 8 bytes of literals at once and return the number of literal
+// flags in a row (1-8)
+//
+
+static BURGER_INLINE Word CopyLiteralsLZSS(Word8 *pOutput,const Word8 *pInput,Word uFlags)
+{
+	Burger::NativeEndian::StoreAny(reinterpret_cast<Word64 *>(pOutput),Burger::NativeEndian::LoadAny(reinterpret_cast<const Word64 *>(pInput)));
+	Word uRun = g_LiteralRunLZSS[uFlags&15U];
+	if (uRun==4) {
+		uRun += g_LiteralRunLZSS[(uFlags>>4U)&15U];
+	}
+	return uRun;
+}
+
+//
+// Copy a match from earlier in the output. Distances of 8 or more
+// are copied 8 bytes at a time, so up to 7 bytes past the end of the
+// match are written.
+//
+
+static BURGER_INLINE void CopyMatchLZSS(Word8 *pOutput,WordPtr uDistance,WordPtr uLength)
+{
+	const Word8 *pMatch = pOutput-uDistance;
+	if (uDistance>=8) {
+		do {
+			Burger::NativeEndian::StoreAny(reinterpret_cast<Word64 *>(pOutput),Burger::NativeEndian::LoadAny(reinterpret_cast<const Word64 *>(pMatch)));
+			pOutput+=8;
+			pMatch+=8;
+			if (uLength<=8) {
+				break;
+			}
+			uLength-=8;
+		} while (1);
+	} else {
+		// Overlapping copy, it's a repeating pattern
+		do {
+			pOutput[0] = pMatch[0];
+			++pMatch;
+			++pOutput;
+		} while (--uLength);
+	}
+}
+
+//
+// Decode whole groups of 8 tokens in the original format while there's
+// room for the largest group. Each group reads at most 17 bytes plus
+// the overrun of an 8 byte literal copy and writes at most 8*18 bytes
+// plus the overrun of the last 8 byte copy.
+//
+
+static void DecodeGroupsLZSS(Word8 **ppOutput,WordPtr *pOutputLength,const Word8 **ppInput,WordPtr *pInputLength)
+{
+	WordPtr uOutputLength = pOutputLength[0];
+	WordPtr uInputLength = pInputLength[0];
+	if ((uOutputLength>=((8*18)+8)) && (uInputLength>=(1+(8*2)+8))) {
+		Word8 *pOutput = ppOutput[0];
+		const Word8 *pInput = ppInput[0];
+		const Word8 *pInputLimit = pInput+(uInputLength-(1+(8*2)+8));
+		const Word8 *pOutputLimit = pOutput+(uOutputLength-((8*18)+8));
+		do {
+			Word uFlags = pInput[0];
+			++pInput;
+			Word uCount = 8;
+			do {
+				if (uFlags&1U) {
+					// Bits past the group are zero, so the run stops there
+					Word uRun = CopyLiteralsLZSS(pOutput,pInput,uFlags);
+					pInput+=uRun;
+					pOutput+=uRun;
+					uFlags>>=uRun;
+					uCount-=uRun;
+				} else {
+					Word uToken = Burger::LittleEndian::LoadAny(reinterpret_cast<const Word16 *>(pInput));
+					pInput+=2;
+					WordPtr uLength = (uToken>>12U)+3;
+					CopyMatchLZSS(pOutput,0x1000U-(uToken&0xFFFU),uLength);
+					pOutput+=uLength;
+					uFlags>>=1U;
+					--uCount;
+				}
+			} while (uCount);
+		} while ((pInput<=pInputLimit) && (pOutput<=pOutputLimit));
+		pOutputLength[0] = uOutputLength-static_cast<WordPtr>(pOutput-ppOutput[0]);
+		pInputLength[0] = uInputLength-static_cast<WordPtr>(pInput-ppInput[0]);
+		ppOutput[0] = pOutput;
+		ppInput[0] = pInput;
+	}
+}
+
+//
+// Decode whole groups of 8 tokens in the large window format. Each
+// group reads at most 33 bytes plus the overrun of an 8 byte literal
+// copy and writes at most 8*258 bytes plus the overrun of the last 8
+// byte copy. Returns TRUE if a match
+// reaches before the start of the data
+//
+
+static Word DecodeGroupsLZSSLarge(Word8 **ppOutput,WordPtr *pOutputLength,const Word8 **ppInput,WordPtr *pInputLength,WordPtr uHistory)
+{
+	Word uResult = FALSE;
+	WordPtr uOutputLength = pOutputLength[0];
+	WordPtr uInputLength = pInputLength[0];
+	if ((uOutputLength>=((8*258)+8)) && (uInputLength>=(1+(8*4)+8))) {
+		Word8 *pOutput = ppOutput[0];
+		const Word8 *pInput = ppInput[0];
+		const Word8 *pInputLimit = pInput+(uInputLength-(1+(8*4)+8));
+		const Word8 *pOutputLimit = pOutput+(uOutputLength-((8*258)+8));
+		do {
+			Word uFlags = pInput[0];
+			++pInput;
+			Word uCount = 8;
+			do {
+				if (uFlags&1U) {
+					// Bits past the group are zero, so the run stops there
+					Word uRun = CopyLiteralsLZSS(pOutput,pInput,uFlags);
+					pInput+=uRun;
+					pOutput+=uRun;
+					uFlags>>=uRun;
+					uCount-=uRun;
+				} else {
+					WordPtr uDistance = Burger::LittleEndian::LoadAny(reinterpret_cast<const Word16 *>(pInput));
+					WordPtr uLength = uDistance>>12U;
+					if (uLength) {
+						// Short token
+						uDistance = (uDistance&0xFFFU)+1;
+						uLength += 2;
+						pInput+=2;
+					} else {
+						uDistance = (uDistance|(static_cast<WordPtr>(pInput[2])<<12U))+1;
+						uLength = static_cast<WordPtr>(pInput[3])+3;
+						pInput+=4;
+					}
+					if (uDistance>(uHistory+reinterpret_cast<WordPtr>(pOutput))) {
+						uResult = TRUE;
+						break;
+					}
+					CopyMatchLZSS(pOutput,uDistance,uLength);
+					pOutput+=uLength;
+					uFlags>>=1U;
+					--uCount;
+				}
+			} while (uCount);
+		} while (!uResult && (pInput<=pInputLimit) && (pOutput<=pOutputLimit));
+		pOutputLength[0] = uOutputLength-static_cast<WordPtr>(pOutput-ppOutput[0]);
+		pInputLength[0] = uInputLength-static_cast<WordPtr>(pInput-ppInput[0]);
+		ppOutput[0] = pOutput;
+		ppInput[0] = pInput;
+	}
+	return uResult;
+}
 #endif
 
 /*! ************************************
@@ -24,6 +182,10 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::DecompressLZSS,Burger::Decompress);
 	
 	Decompress data in LZSS format (Documented here Burger::CompressLZSS )
 
+	Data created with CompressLZSS::SetLargeWindow(Word) set to \ref TRUE
+	needs the large window flag set with SetLargeWindow(Word) or the
+	constructor.
+
 	\sa Burger::Decompress and Burger::CompressLZSS
 
 ***************************************/
@@ -38,11 +200,55 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::DecompressLZSS,Burger::Decompress);
 
 Burger::DecompressLZSS::DecompressLZSS() :
 	m_uBitBucket(1),
+	m_bLargeWindow(FALSE),
 	m_eState(STATE_INIT)
 {
 	m_uSignature = Signature;
 }
 
+/*! ************************************
+
+	\brief Constructor with the data format
+
+	\param bLargeWindow \ref TRUE if the data is in the large window format
+	\sa SetLargeWindow(Word)
+
+***************************************/
+
+Burger::DecompressLZSS::DecompressLZSS(Word bLargeWindow) :
+	m_uBitBucket(1),
+	m_bLargeWindow(bLargeWindow!=0),
+	m_eState(STATE_INIT)
+{
+	m_uSignature = Signature;
+}
+
+/*! ************************************
+
+	\brief Set the format of the compressed data
+
+	Call Reset() after changing the format.
+
+	\param bLargeWindow \ref TRUE if the data was created by CompressLZSS in the large window format
+	\sa GetLargeWindow(void) const
+
+***************************************/
+
+void BURGER_API Burger::DecompressLZSS::SetLargeWindow(Word bLargeWindow)
+{
+	m_bLargeWindow = (bLargeWindow!=0);
+}
+
+/*! ************************************
+
+	\fn Word Burger::DecompressLZSS::GetLargeWindow(void) const
+	\brief Get the format of the compressed data
+
+	\return \ref TRUE if the large window format is expected
+	\sa SetLargeWindow(Word)
+
+***************************************/
+
 /*! ************************************
 
 	\brief Reset the LZSS decompression
@@ -66,6 +272,12 @@ Burger::Decompress::eError Burger::DecompressLZSS::Reset(void)
 
 	Using the LZSS compression algorithm, decompress the data
 
+	Whenever a new group of 8 tokens starts and there's enough input
+	and output for a whole group, such as when the entire
+	buffers are passed to SimpleDecompressLZSS() or by RezFile,
+	groups are decoded without checking the buffer sizes for every
+	token. The state machine only handles the end of the data.
+
 	\param pOutput Pointer to the buffer to accept the decompressed data
 	\param uOutputChunkLength Number of bytes in the output buffer
 	\param pInput Pointer to data to compress
@@ -78,6 +290,10 @@ Burger::Decompress::eError Burger::DecompressLZSS::Reset(void)
 
 Burger::Decompress::eError Burger::DecompressLZSS::Process(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
 {
+	// Three byte tokens are handled elsewhere
+	if (m_bLargeWindow) {
+		return ProcessLargeWindow(pOutput,uOutputChunkLength,pInput,uInputChunkLength);
+	}
 	m_uInputLength = uInputChunkLength;
 	m_uOutputLength = uOutputChunkLength;
 
@@ -123,6 +339,15 @@ Burger::Decompress::eError Burger::DecompressLZSS::Process(void *pOutput,WordPtr
 			} while (--uRunCount);
 			uBitBucket = uBitBucket>>1;
 		}
+
+		// At the start of a group? Decode as much as possible quickly
+		if (uBitBucket==1) {
+			Word8 *pDest = static_cast<Word8 *>(pOutput);
+			const Word8 *pSource = static_cast<const Word8 *>(pInput);
+			DecodeGroupsLZSS(&pDest,&uOutputChunkLength,&pSource,&uInputChunkLength);
+			pOutput = pDest;
+			pInput = pSource;
+		}
 	
 		// Normal decompression entry
 		do {
@@ -261,6 +486,168 @@ Exit:
 	return DECOMPRESS_OKAY;
 }
 
+/*! ************************************
+
+	\brief Decompress data in the large window format
+
+	The bit masks are the same as the original format, but matches
+	can have a sixteen bit distance and a length byte following
+	the token.
+
+	\param pOutput Pointer to the buffer to accept the decompressed data
+	\param uOutputChunkLength Number of bytes in the output buffer
+	\param pInput Pointer to data to compress
+	\param uInputChunkLength Number of bytes in the data to decompress
+
+	\return Decompress::eError code with zero if no failure, non-zero is an error code
+	\sa Process(void *,uintptr_t,const void *,uintptr_t)
+
+***************************************/
+
+Burger::Decompress::eError BURGER_API Burger::DecompressLZSS::ProcessLargeWindow(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
+{
+	m_uInputLength = uInputChunkLength;
+	m_uOutputLength = uOutputChunkLength;
+
+	Word8 *pDest = static_cast<Word8 *>(pOutput);
+	const Word8 *pSource = static_cast<const Word8 *>(pInput);
+	// Data decompressed before this call
+	WordPtr uHistory = m_uTotalOutput-reinterpret_cast<WordPtr>(pDest);
+	Word uBitBucket = m_uBitBucket;
+	WordPtr uRunCount = m_uRunCount;
+	eState MyState = m_eState;
+	for (;;) {
+		if (MyState==STATE_RUN) {
+			WordPtr uCount = uRunCount;
+			if (uCount>uOutputChunkLength) {
+				uCount = uOutputChunkLength;
+			}
+			if (uCount) {
+				uOutputChunkLength -= uCount;
+				uRunCount -= uCount;
+				const Word8 *pMatch = pDest-m_uOffset;
+				do {
+					pDest[0] = pMatch[0];
+					++pMatch;
+					++pDest;
+				} while (--uCount);
+			}
+			// Output full?
+			if (uRunCount) {
+				break;
+			}
+			uBitBucket>>=1;
+			MyState = STATE_INIT;
+		}
+		if (MyState==STATE_INIT) {
+			if (!uOutputChunkLength) {
+				break;
+			}
+			if (uBitBucket==1) {
+				// Decode as much as possible quickly
+				if (DecodeGroupsLZSSLarge(&pDest,&uOutputChunkLength,&pSource,&uInputChunkLength,uHistory)) {
+					MyState = STATE_ABORT;
+					break;
+				}
+				if (!uOutputChunkLength) {
+					break;
+				}
+				// No input?
+				if (!uInputChunkLength) {
+					break;
+				}
+				// Grab the next bit bucket
+				uBitBucket = static_cast<Word>(pSource[0])|0x100U;
+				++pSource;
+				--uInputChunkLength;
+			}
+			if (!uInputChunkLength) {
+				break;
+			}
+			if (uBitBucket&1U) {
+				// Copy a byte
+				pDest[0] = pSource[0];
+				++pSource;
+				++pDest;
+				--uInputChunkLength;
+				--uOutputChunkLength;
+				uBitBucket>>=1;
+				continue;
+			}
+			uRunCount = pSource[0];
+			++pSource;
+			--uInputChunkLength;
+			MyState = STATE_16BIT2;
+		}
+		if (MyState==STATE_16BIT2) {
+			if (!uInputChunkLength) {
+				break;
+			}
+			uRunCount |= static_cast<WordPtr>(pSource[0])<<8U;
+			++pSource;
+			--uInputChunkLength;
+			// Short token?
+			if (uRunCount>=0x1000U) {
+				m_uOffset = (uRunCount&0xFFFU)+1;
+				uRunCount = (uRunCount>>12U)+2;
+				MyState = STATE_RUN;
+				goto Validate;
+			}
+			MyState = STATE_DISTANCE;
+		}
+		if (MyState==STATE_DISTANCE) {
+			if (!uInputChunkLength) {
+				break;
+			}
+			uRunCount |= static_cast<WordPtr>(pSource[0])<<12U;
+			++pSource;
+			--uInputChunkLength;
+			MyState = STATE_LENGTH;
+		}
+		if (MyState!=STATE_LENGTH) {
+			// STATE_ABORT
+			break;
+		}
+		if (!uInputChunkLength) {
+			break;
+		}
+		m_uOffset = uRunCount+1;
+		uRunCount = static_cast<WordPtr>(pSource[0])+3;
+		++pSource;
+		--uInputChunkLength;
+		MyState = STATE_RUN;
+Validate:
+		// Does the match start before the data?
+		if (m_uOffset>(uHistory+reinterpret_cast<WordPtr>(pDest))) {
+			MyState = STATE_ABORT;
+			break;
+		}
+	}
+	m_uBitBucket = uBitBucket;
+	m_uRunCount = uRunCount;
+	m_eState = MyState;
+
+	// How did the decompression go?
+
+	m_uOutputLength -= uOutputChunkLength;
+	m_uInputLength -= uInputChunkLength;
+	m_uTotalOutput += m_uOutputLength;
+	m_uTotalInput += m_uInputLength;
+	if (MyState==STATE_ABORT) {
+		return DECOMPRESS_BADINPUT;
+	}
+	// Output buffer not big enough?
+	if (uOutputChunkLength) {
+		return DECOMPRESS_OUTPUTUNDERRUN;
+	}
+	// Input data remaining?
+	if (uInputChunkLength || (MyState==STATE_RUN)) {
+		return DECOMPRESS_OUTPUTOVERRUN;
+	}
+	// Decompression is complete
+	return DECOMPRESS_OKAY;
+}
+
 /***************************************
 
 	Decompress using LZSS.
@@ -276,6 +663,20 @@ Burger::Decompress::eError BURGER_API Burger::SimpleDecompressLZSS(void *pOutput
 	return Local.DecompressLZSS::Process(pOutput,uOutputChunkLength,pInput,uInputChunkLength);
 }
 
+/***************************************
+
+	Decompress using the large window LZSS format
+	in one pass.
+
+***************************************/
+
+Burger::Decompress::eError BURGER_API Burger::SimpleDecompressLZSSLargeWindow(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
+{
+	Burger::DecompressLZSS Local(TRUE);
+	Local.DecompressLZSS::Reset();
+	return Local.DecompressLZSS::Process(pOutput,uOutputChunkLength,pInput,uInputChunkLength);
+}
+
 /*! ************************************
 
 	\var const Burger::StaticRTTI Burger::DecompressLZSS::g_StaticRTTI
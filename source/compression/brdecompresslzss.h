@@ -30,19 +30,28 @@ protected:
 	enum eState {
 		STATE_INIT,			///< Start of a compression token	
 		STATE_16BIT2,		///< Grab the 2nd half of a 16 bit run token
-		STATE_RUN			///< Memory copy in progress
+		STATE_RUN,			///< Memory copy in progress
+		STATE_DISTANCE,		///< Grab the upper distance bits of a large window token
+		STATE_LENGTH,		///< Grab the length byte of a large window token
+		STATE_ABORT			///< Bad data found (Fatal)
 	};
 	WordPtr m_uRunCount;	///< Previous 16 bit token (Half)
 	WordPtr m_uOffset;		///< Previous destination pointer
 	Word m_uBitBucket;		///< Previous bit bucket
+	Word m_bLargeWindow;	///< \ref TRUE if the data is in the large window format
 	eState m_eState;		///< State of the decompression
+	eError BURGER_API ProcessLargeWindow(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
 public:
 	static const Word32 Signature = 0x4C5A5353;		///< 'LZSS'
 	DecompressLZSS();
+	DecompressLZSS(Word bLargeWindow);
+	void BURGER_API SetLargeWindow(Word bLargeWindow);
+	BURGER_INLINE Word GetLargeWindow(void) const { return m_bLargeWindow; }
 	eError Reset(void) BURGER_OVERRIDE;
 	eError Process(void *pOutput, uintptr_t uOutputChunkLength,const void *pInput, uintptr_t uInputChunkLength) BURGER_OVERRIDE;
 };
 extern Decompress::eError BURGER_API SimpleDecompressLZSS(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
+extern Decompress::eError BURGER_API SimpleDecompressLZSSLargeWindow(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
 }
 /* END */
 
@@ -0,0 +1,429 @@
+/***************************************
+
+	Pull based streaming decompression
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brdecompressstream.h"
+#include "brfile.h"
+#include "brinputmemorystream.h"
+#include "brglobalmemorymanager.h"
+
+/*! ************************************
+
+	\class Burger::DecompressStream
+	\brief Pull compressed data through a Decompress class
+
+	Decompress::Process() is push based, the caller has to feed it
+	chunks of compressed data and handle the
+	Decompress::DECOMPRESS_OUTPUTUNDERRUN state by hand. This class does that
+	work so decompressed data can be read like a file, a piece
+	at a time, without inflating the whole thing into memory first.
+	This is useful for large compressed rez entries or streaming audio.
+
+	The compressed data can come from a File or an InputMemoryStream.
+	Memory streams are decompressed in place. Files are read in chunks
+	and if requested, the next chunk is read on a background thread while
+	the current one is being decompressed.
+
+	\code
+	Burger::DecompressDeflate Inflater;
+	Burger::DecompressStream Stream;
+	if (!Stream.Open(&Inflater,&MyFile,uCompressedLength,Burger::DecompressStream::DefaultBufferSize,TRUE)) {
+		Word8 Buffer[4096];
+		WordPtr uLength;
+		while ((uLength = Stream.Read(Buffer,sizeof(Buffer)))!=0) {
+			ProcessData(Buffer,uLength);
+		}
+		Stream.Close();
+	}
+	\endcode
+
+	\note The Decompress and source classes are not owned by this class, they
+	must remain valid until Close() is called.
+
+	\sa Burger::Decompress
+
+***************************************/
+
+/*! ************************************
+
+	\brief Initialize to a closed state
+
+	\sa Open(Decompress *,File *,WordPtr,WordPtr,Word) or Open(Decompress *,InputMemoryStream *,WordPtr)
+
+***************************************/
+
+Burger::DecompressStream::DecompressStream() :
+	m_pDecompress(NULL),
+	m_pFile(NULL),
+	m_pStream(NULL),
+	m_pInput(NULL),
+	m_uInputLength(0),
+	m_uSourceRemaining(0),
+	m_uBufferSize(0),
+	m_uPrefetchLength(0),
+	m_uActiveBuffer(0),
+	m_bPrefetch(FALSE),
+	m_bPrefetchPending(FALSE),
+	m_bPrefetchDone(FALSE),
+	m_bEndOfStream(TRUE),
+	m_bReadFailure(FALSE),
+	m_eError(Decompress::DECOMPRESS_OKAY)
+{
+	m_pBuffers[0] = NULL;
+	m_pBuffers[1] = NULL;
+}
+
+/*! ************************************
+
+	\brief Release the read buffers
+
+	\sa Close()
+
+***************************************/
+
+Burger::DecompressStream::~DecompressStream()
+{
+	Close();
+}
+
+/*! ************************************
+
+	\brief Read the next buffer from the File
+
+	This is the entry point for the prefetch thread. It's also
+	called directly if the thread couldn't be started.
+
+	\param pThis Pointer to the DecompressStream
+	\return Zero
+
+***************************************/
+
+WordPtr BURGER_API Burger::DecompressStream::PrefetchProc(void *pThis)
+{
+	DecompressStream *pStream = static_cast<DecompressStream *>(pThis);
+	WordPtr uLength = pStream->m_uSourceRemaining;
+	if (uLength>pStream->m_uBufferSize) {
+		uLength = pStream->m_uBufferSize;
+	}
+	pStream->m_uPrefetchLength = pStream->m_pFile->Read(pStream->m_pBuffers[pStream->m_uActiveBuffer^1U],uLength);
+	pStream->m_bPrefetchDone = TRUE;
+	return 0;
+}
+
+/*! ************************************
+
+	\brief Start reading the next buffer on the background thread
+
+	If all of the source data has already been read, do nothing.
+
+	\sa FillInput()
+
+***************************************/
+
+void BURGER_API Burger::DecompressStream::StartPrefetch(void)
+{
+	if (m_uSourceRemaining) {
+		m_bPrefetchDone = FALSE;
+		m_bPrefetchPending = TRUE;
+		m_Thread.Start(PrefetchProc,this);
+	}
+}
+
+/*! ************************************
+
+	\brief Refill the input from the source
+
+	For a File, wait for the prefetch thread (Or read the data directly)
+	and switch to the newly filled buffer. If prefetching is enabled,
+	the read of the following buffer is started before returning.
+
+	If the file couldn't supply all of the requested data, the
+	source is marked as exhausted and IsReadFailure() will
+	return \ref TRUE.
+
+	\sa StartPrefetch()
+
+***************************************/
+
+void BURGER_API Burger::DecompressStream::FillInput(void)
+{
+	WordPtr uRequested = m_uSourceRemaining;
+	if (uRequested>m_uBufferSize) {
+		uRequested = m_uBufferSize;
+	}
+	if (m_bPrefetchPending) {
+		m_Thread.Wait();
+		m_bPrefetchPending = FALSE;
+		// If the thread didn't run, read it here
+		if (!m_bPrefetchDone) {
+			PrefetchProc(this);
+		}
+		m_uActiveBuffer ^= 1U;
+	} else {
+		m_uPrefetchLength = m_pFile->Read(m_pBuffers[m_uActiveBuffer],uRequested);
+	}
+	WordPtr uLength = m_uPrefetchLength;
+	m_pInput = m_pBuffers[m_uActiveBuffer];
+	m_uInputLength = uLength;
+	m_uSourceRemaining -= uRequested;
+	if (uLength!=uRequested) {
+		// The file is shorter than promised
+		m_bReadFailure = TRUE;
+		m_uSourceRemaining = 0;
+	}
+	if (m_bPrefetch) {
+		StartPrefetch();
+	}
+}
+
+/*! ************************************
+
+	\brief Attach a decompressor to compressed data in a File
+
+	Reset the decompressor and prepare to decompress uCompressedLength
+	bytes starting from the File's current mark. The data is read
+	in chunks of uBufferSize bytes.
+
+	If bPrefetch is \ref TRUE, two buffers are allocated and while one
+	is being decompressed, the other is filled by a background thread.
+	On platforms without thread support, the read is performed
+	when the data is needed.
+
+	\note The File must not be accessed by anything else until Close()
+	is called.
+
+	\param pDecompress Pointer to the decompressor to use
+	\param pFile Pointer to an open File
+	\param uCompressedLength Number of bytes of compressed data in the file
+	\param uBufferSize Size in bytes of each read buffer
+	\param bPrefetch \ref TRUE to read ahead on a background thread
+	\return Zero on success, kErrorInvalidParameter if pDecompress or pFile is \ref NULL,
+		or kErrorOutOfMemory if the buffers couldn't be allocated
+
+	\sa Open(Decompress *,InputMemoryStream *,WordPtr) or Close()
+
+***************************************/
+
+Burger::eError BURGER_API Burger::DecompressStream::Open(Decompress *pDecompress,File *pFile,WordPtr uCompressedLength,WordPtr uBufferSize,Word bPrefetch)
+{
+	Close();
+	if (!pDecompress || !pFile) {
+		return kErrorInvalidParameter;
+	}
+	if (!uBufferSize) {
+		uBufferSize = DefaultBufferSize;
+	}
+	// Don't allocate more than is needed
+	if (uBufferSize>uCompressedLength) {
+		uBufferSize = uCompressedLength;
+		// It will fit in one buffer, so there's nothing to prefetch
+		bPrefetch = FALSE;
+	}
+	if (uBufferSize) {
+		Word8 *pBuffer = static_cast<Word8 *>(Alloc(bPrefetch ? uBufferSize*2 : uBufferSize));
+		if (!pBuffer) {
+			return kErrorOutOfMemory;
+		}
+		m_pBuffers[0] = pBuffer;
+		if (bPrefetch) {
+			m_pBuffers[1] = pBuffer+uBufferSize;
+		}
+	}
+	pDecompress->Reset();
+	m_pDecompress = pDecompress;
+	m_pFile = pFile;
+	m_uSourceRemaining = uCompressedLength;
+	m_uBufferSize = uBufferSize;
+	m_bPrefetch = bPrefetch;
+	m_bEndOfStream = FALSE;
+	// Start reading right away
+	if (bPrefetch) {
+		StartPrefetch();
+	}
+	return kErrorNone;
+}
+
+/*! ************************************
+
+	\brief Attach a decompressor to compressed data in memory
+
+	Reset the decompressor and prepare to decompress uCompressedLength
+	bytes starting from the stream's current position. The data is
+	decompressed directly from the stream's buffer and the position
+	is advanced as data is consumed.
+
+	If there are fewer than uCompressedLength bytes remaining in the
+	stream, only the remaining bytes are used.
+
+	\param pDecompress Pointer to the decompressor to use
+	\param pStream Pointer to an InputMemoryStream
+	\param uCompressedLength Number of bytes of compressed data in the stream
+	\return Zero on success or kErrorInvalidParameter if pDecompress or pStream is \ref NULL
+
+	\sa Open(Decompress *,File *,WordPtr,WordPtr,Word) or Close()
+
+***************************************/
+
+Burger::eError BURGER_API Burger::DecompressStream::Open(Decompress *pDecompress,InputMemoryStream *pStream,WordPtr uCompressedLength)
+{
+	Close();
+	if (!pDecompress || !pStream) {
+		return kErrorInvalidParameter;
+	}
+	WordPtr uRemaining = pStream->BytesRemaining();
+	if (uCompressedLength>uRemaining) {
+		uCompressedLength = uRemaining;
+	}
+	pDecompress->Reset();
+	m_pDecompress = pDecompress;
+	m_pStream = pStream;
+	m_pInput = pStream->GetPtr();
+	m_uInputLength = uCompressedLength;
+	m_bEndOfStream = FALSE;
+	return kErrorNone;
+}
+
+/*! ************************************
+
+	\brief Detach from the decompressor and the source
+
+	Wait for any pending read to complete and release the
+	read buffers. The Decompress and the source are not
+	released.
+
+	\sa Open(Decompress *,File *,WordPtr,WordPtr,Word) or Open(Decompress *,InputMemoryStream *,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::DecompressStream::Close(void)
+{
+	if (m_bPrefetchPending) {
+		m_Thread.Wait();
+		m_bPrefetchPending = FALSE;
+	}
+	Free(m_pBuffers[0]);
+	m_pBuffers[0] = NULL;
+	m_pBuffers[1] = NULL;
+	m_pDecompress = NULL;
+	m_pFile = NULL;
+	m_pStream = NULL;
+	m_pInput = NULL;
+	m_uInputLength = 0;
+	m_uSourceRemaining = 0;
+	m_uBufferSize = 0;
+	m_uPrefetchLength = 0;
+	m_uActiveBuffer = 0;
+	m_bPrefetch = FALSE;
+	m_bPrefetchDone = FALSE;
+	m_bEndOfStream = TRUE;
+	m_bReadFailure = FALSE;
+	m_eError = Decompress::DECOMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Read decompressed data
+
+	Decompress data into the buffer, refilling the input from the
+	source as needed. If fewer bytes than requested are returned,
+	the end of the decompressed data was reached or an error
+	occurred.
+
+	Once the end is reached, IsEndOfStream() will return \ref TRUE.
+	GetError() will return Decompress::DECOMPRESS_BADINPUT if the
+	data was corrupt and IsReadFailure() will return \ref TRUE if
+	the File ended early.
+
+	\param pOutput Pointer to the buffer to receive the decompressed data
+	\param uLength Number of bytes to read
+	\return Number of bytes actually read
+
+	\sa IsEndOfStream() or GetError()
+
+***************************************/
+
+WordPtr BURGER_API Burger::DecompressStream::Read(void *pOutput,WordPtr uLength)
+{
+	WordPtr uTotal = 0;
+	while (uLength && !m_bEndOfStream) {
+		if (!m_uInputLength && m_uSourceRemaining) {
+			FillInput();
+		}
+		Decompress::eError uError = m_pDecompress->Process(pOutput,uLength,m_pInput,m_uInputLength);
+		m_eError = uError;
+		WordPtr uInput = m_pDecompress->GetProcessedInputSize();
+		WordPtr uOutput = m_pDecompress->GetProcessedOutputSize();
+		m_pInput += uInput;
+		m_uInputLength -= uInput;
+		if (m_pStream) {
+			m_pStream->SkipForward(uInput);
+		}
+		pOutput = static_cast<Word8 *>(pOutput)+uOutput;
+		uLength -= uOutput;
+		uTotal += uOutput;
+		if (uError==Decompress::DECOMPRESS_BADINPUT) {
+			m_bEndOfStream = TRUE;
+		// If nothing moved and no more data is coming, it's over
+		} else if (!(uInput|uOutput) && (m_uInputLength || !m_uSourceRemaining)) {
+			m_bEndOfStream = TRUE;
+		}
+	}
+	return uTotal;
+}
+
+/*! ************************************
+
+	\fn Word Burger::DecompressStream::IsOpened(void) const
+	\brief Return \ref TRUE if a decompressor is attached
+
+	\return \ref TRUE if Open() was successful and Close() wasn't called yet.
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::DecompressStream::IsEndOfStream(void) const
+	\brief Return \ref TRUE if no more data can be read
+
+	\return \ref TRUE if the end of the data was reached, an error occurred or the stream isn't open.
+	\sa Read(void *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::DecompressStream::IsReadFailure(void) const
+	\brief Return \ref TRUE if the File ended early
+
+	\return \ref TRUE if the File couldn't supply all of the compressed data.
+	\sa Read(void *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Decompress::eError Burger::DecompressStream::GetError(void) const
+	\brief Return the result of the last decompression pass
+
+	\return The value returned by the last call to Decompress::Process().
+	\sa Read(void *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::DecompressStream::GetTotalOutputSize(void) const
+	\brief Return the number of bytes decompressed so far
+
+	\return Total number of bytes returned by Read(void *,WordPtr) since Open() was called.
+
+***************************************/
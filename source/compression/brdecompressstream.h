@@ -0,0 +1,78 @@
+/***************************************
+
+	Pull based streaming decompression
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRDECOMPRESSSTREAM_H__
+#define __BRDECOMPRESSSTREAM_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRERROR_H__
+#include "brerror.h"
+#endif
+
+#ifndef __BRDECOMPRESS_H__
+#include "brdecompress.h"
+#endif
+
+#ifndef __BRCRITICALSECTION_H__
+#include "brcriticalsection.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class File;
+class InputMemoryStream;
+
+class DecompressStream {
+	BURGER_DISABLE_COPY(DecompressStream);
+protected:
+	Decompress *m_pDecompress;		///< Decompressor the data is pulled through
+	File *m_pFile;					///< File with the compressed data (Or \ref NULL)
+	InputMemoryStream *m_pStream;	///< Memory stream with the compressed data (Or \ref NULL)
+	Word8 *m_pBuffers[2];			///< Read buffers for a File source
+	const Word8 *m_pInput;			///< Compressed data not yet given to the decompressor
+	WordPtr m_uInputLength;			///< Number of bytes at m_pInput
+	WordPtr m_uSourceRemaining;		///< Compressed bytes not yet read from the source
+	WordPtr m_uBufferSize;			///< Size in bytes of each read buffer
+	WordPtr m_uPrefetchLength;		///< Number of bytes read by the prefetch thread
+	Thread m_Thread;				///< Background thread that reads the next buffer
+	Word m_uActiveBuffer;			///< Index of the buffer being decompressed
+	Word m_bPrefetch;				///< \ref TRUE if the next buffer is read on a background thread
+	Word m_bPrefetchPending;		///< \ref TRUE if the prefetch thread was started
+	Word m_bPrefetchDone;			///< \ref TRUE when the prefetch thread has finished the read
+	Word m_bEndOfStream;			///< \ref TRUE when no more data can be decompressed
+	Word m_bReadFailure;			///< \ref TRUE if the File couldn't supply all of the compressed data
+	Decompress::eError m_eError;	///< Result of the last call to Decompress::Process()
+	static WordPtr BURGER_API PrefetchProc(void *pThis);
+	void BURGER_API StartPrefetch(void);
+	void BURGER_API FillInput(void);
+public:
+	static const WordPtr DefaultBufferSize = 0x10000;	///< Default size of each File read buffer
+	DecompressStream();
+	~DecompressStream();
+	eError BURGER_API Open(Decompress *pDecompress,File *pFile,WordPtr uCompressedLength,WordPtr uBufferSize=DefaultBufferSize,Word bPrefetch=FALSE);
+	eError BURGER_API Open(Decompress *pDecompress,InputMemoryStream *pStream,WordPtr uCompressedLength);
+	void BURGER_API Close(void);
+	WordPtr BURGER_API Read(void *pOutput,WordPtr uLength);
+	BURGER_INLINE Word IsOpened(void) const { return m_pDecompress!=NULL; }
+	BURGER_INLINE Word IsEndOfStream(void) const { return m_bEndOfStream; }
+	BURGER_INLINE Word IsReadFailure(void) const { return m_bReadFailure; }
+	BURGER_INLINE Decompress::eError GetError(void) const { return m_eError; }
+	BURGER_INLINE WordPtr GetTotalOutputSize(void) const { return m_pDecompress ? m_pDecompress->GetTotalOutputSize() : 0; }
+};
+}
+/* END */
+
+#endif
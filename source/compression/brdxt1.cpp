@@ -13,6 +13,13 @@
 
 #include "brdxt1.h"
 #include "brendian.h"
+#include "brfloatingpoint.h"
+#include "brcriticalsection.h"
+#include "brcpudispatch.h"
+
+#if defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
 
 /*! ************************************
 
@@ -124,34 +131,1065 @@ void Burger::Dxt1Packet_t::Decompress(RGBAWord8_t *pOutput,WordPtr uStride) cons
 	} while (--i);
 }
 
-#if 0
+#if !defined(DOXYGEN)
+
+//
+// Encoders pick two R5:G6:B5 endpoints with one of two fits, build
+// the palette exactly as the decoder would and then select the closest
+// palette entry for each pixel. The candidate with the smallest squared
+// error wins.
+//
+// Range fit projects the pixels onto the principal axis of the color
+// distribution and uses the two extremes as the endpoints.
+//
+// Cluster fit sorts the pixels along the principal axis and tries every
+// way to split the ordered list into 3 or 4 runs. Each split assigns a
+// palette weight to every pixel, so the endpoints that best fit it are
+// found with least squares.
+//
+
+static const Word g_uMaxDxtThreads = 16;		// Maximum number of threads for CompressDxtImage()
+static const Word g_uMinBlocksPerThread = 256;	// Don't bother spawning a thread for less than this
+
+// Select palette entries for 16 pixels, return the squared error
+typedef Word32 (BURGER_API *DxtColorIndexesProc)(Word32 *pIndexes,const Burger::RGBAWord8_t *pPixels,const Burger::RGBAWord8_t *pPalette,Word uAlphaThreshold);
+
+// Find the best split of sorted points, return the endpoints and error
+typedef float (BURGER_API *DxtClusterSearchProc)(float *pStart,float *pEnd,const float (*pSums)[4],Word uCount,Word bThreeColor);
+
+//
+// Pixels with an alpha below uAlphaThreshold get index 3 and add no error
+//
+
+static Word32 BURGER_API DxtColorIndexesGeneric(Word32 *pIndexes,const Burger::RGBAWord8_t *pPixels,const Burger::RGBAWord8_t *pPalette,Word uAlphaThreshold)
+{
+	Word32 uError = 0;
+	Word32 uIndexes = 0;
+	Word i = 0;
+	do {
+		Word32 uBest = 3;
+		if (pPixels->m_uAlpha>=uAlphaThreshold) {
+			Word32 uBestError = 0xFFFFFFFFU;
+			Word j = 0;
+			do {
+				int iRed = static_cast<int>(pPixels->m_uRed)-static_cast<int>(pPalette[j].m_uRed);
+				int iGreen = static_cast<int>(pPixels->m_uGreen)-static_cast<int>(pPalette[j].m_uGreen);
+				int iBlue = static_cast<int>(pPixels->m_uBlue)-static_cast<int>(pPalette[j].m_uBlue);
+				Word32 uTemp = static_cast<Word32>((iRed*iRed)+(iGreen*iGreen)+(iBlue*iBlue));
+				if (uTemp<uBestError) {
+					uBestError = uTemp;
+					uBest = j;
+				}
+			} while (++j<4);
+			uError += uBestError;
+		}
+		uIndexes |= uBest<<(i*2U);
+		++pPixels;
+	} while (++i<16);
+	pIndexes[0] = uIndexes;
+	return uError;
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+//
+// Four pixels per register. The channels are widened to 16 bits so
+// pmaddwd can square and add them, the alpha channel is cleared so
+// it doesn't contribute.
+//
+
+static BURGER_TARGET_SSE2 Word32 BURGER_API DxtColorIndexesSSE2(Word32 *pIndexes,const Burger::RGBAWord8_t *pPixels,const Burger::RGBAWord8_t *pPalette,Word uAlphaThreshold)
+{
+	const __m128i vZero = _mm_setzero_si128();
+	const __m128i vRGBMask = _mm_set1_epi32(0x00FFFFFF);
+	const __m128i vThreshold = _mm_set1_epi32(static_cast<int>(uAlphaThreshold)-1);
+	const __m128i vScale = _mm_setr_epi32(1,4,16,64);
+
+	__m128i vPalette[4];
+	Word j = 0;
+	do {
+		__m128i vColor = _mm_set1_epi32(static_cast<int>(pPalette[j].m_uRed|(pPalette[j].m_uGreen<<8U)|(pPalette[j].m_uBlue<<16U)));
+		vPalette[j] = _mm_unpacklo_epi8(vColor,vZero);
+	} while (++j<4);
+
+	__m128i vErrorSum = vZero;
+	Word32 uIndexes = 0;
+	Word i = 0;
+	do {
+		__m128i vPixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pPixels));
+		__m128i vValid = _mm_cmpgt_epi32(_mm_srli_epi32(vPixels,24),vThreshold);
+		vPixels = _mm_and_si128(vPixels,vRGBMask);
+		__m128i vLow = _mm_unpacklo_epi8(vPixels,vZero);
+		__m128i vHigh = _mm_unpackhi_epi8(vPixels,vZero);
+
+		__m128i vBestError = vZero;
+		__m128i vBest = vZero;
+		j = 0;
+		do {
+			__m128i vDeltaLow = _mm_sub_epi16(vLow,vPalette[j]);
+			__m128i vDeltaHigh = _mm_sub_epi16(vHigh,vPalette[j]);
+			vDeltaLow = _mm_madd_epi16(vDeltaLow,vDeltaLow);
+			vDeltaHigh = _mm_madd_epi16(vDeltaHigh,vDeltaHigh);
+			// Add red+green to blue for each pixel
+			__m128 fLow = _mm_castsi128_ps(vDeltaLow);
+			__m128 fHigh = _mm_castsi128_ps(vDeltaHigh);
+			__m128i vError = _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(fLow,fHigh,_MM_SHUFFLE(2,0,2,0))),
+				_mm_castps_si128(_mm_shuffle_ps(fLow,fHigh,_MM_SHUFFLE(3,1,3,1))));
+			if (!j) {
+				vBestError = vError;
+			} else {
+				__m128i vLess = _mm_cmplt_epi32(vError,vBestError);
+				vBestError = _mm_or_si128(_mm_and_si128(vLess,vError),_mm_andnot_si128(vLess,vBestError));
+				vBest = _mm_or_si128(_mm_and_si128(vLess,_mm_set1_epi32(static_cast<int>(j))),_mm_andnot_si128(vLess,vBest));
+			}
+		} while (++j<4);
+
+		// Transparent pixels use index 3
+		vBest = _mm_or_si128(_mm_and_si128(vValid,vBest),_mm_andnot_si128(vValid,_mm_set1_epi32(3)));
+		vErrorSum = _mm_add_epi32(vErrorSum,_mm_and_si128(vValid,vBestError));
+
+		// Shift each index into place and merge them
+		vBest = _mm_madd_epi16(vBest,vScale);
+		vBest = _mm_or_si128(vBest,_mm_shuffle_epi32(vBest,_MM_SHUFFLE(2,3,0,1)));
+		vBest = _mm_or_si128(vBest,_mm_shuffle_epi32(vBest,_MM_SHUFFLE(1,0,3,2)));
+		uIndexes |= static_cast<Word32>(_mm_cvtsi128_si32(vBest))<<(i*8U);
+		pPixels += 4;
+	} while (++i<4);
+
+	vErrorSum = _mm_add_epi32(vErrorSum,_mm_shuffle_epi32(vErrorSum,_MM_SHUFFLE(2,3,0,1)));
+	vErrorSum = _mm_add_epi32(vErrorSum,_mm_shuffle_epi32(vErrorSum,_MM_SHUFFLE(1,0,3,2)));
+	pIndexes[0] = uIndexes;
+	return static_cast<Word32>(_mm_cvtsi128_si32(vErrorSum));
+}
+
+static const Burger::CPUDispatch::Variant_t g_DxtColorIndexesVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(DxtColorIndexesSSE2),Burger::CPUDispatch::kSSE2,"SSE2"},
+	{BURGER_CPU_DISPATCH_PROC(DxtColorIndexesGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_DxtColorIndexesDispatch,Burger::CPUDispatch::kFamilyPixel,g_DxtColorIndexesVariants);
+
+#define DxtColorIndexes g_DxtColorIndexesDispatch.Get<DxtColorIndexesProc>()
+#else
+#define DxtColorIndexes DxtColorIndexesGeneric
+#endif
+
+//
+// Pixels being fit and the best packet found so far
+//
+
+struct DxtColorFit_t {
+	Burger::RGBAWord8_t m_Pixels[16];	// Pixels to encode
+	float m_Points[16][3];		// Colors of the pixels in the fit, sorted along m_Axis for cluster fit
+	float m_Mean[3];			// Average of m_Points
+	float m_Axis[3];			// Principal axis of m_Points
+	DxtColorIndexesProc m_pIndexes;	// Palette index selector
+	DxtClusterSearchProc m_pClusterSearch;	// Cluster fit split finder
+	Word32 m_uBestError;		// Squared error of the best packet
+	Word m_uBestColor1;			// First endpoint of the best packet
+	Word m_uBestColor2;			// Second endpoint of the best packet
+	Word32 m_uBestIndexes;		// Indexes of the best packet
+	Word m_uCount;				// Number of entries in m_Points
+	Word m_uAlphaThreshold;		// Pixels with alpha less than this are transparent
+	Word m_bFourColorOnly;		// TRUE if the decoder always uses four colors (DXT3/DXT5)
+};
+
+//
+// Convert a floating point color to R5:G6:B5 with rounding
+//
+
+static Word BURGER_API DxtTo565(const float *pColor)
+{
+	float fRed = pColor[0];
+	float fGreen = pColor[1];
+	float fBlue = pColor[2];
+	fRed = (fRed<0.0f) ? 0.0f : ((fRed>255.0f) ? 255.0f : fRed);
+	fGreen = (fGreen<0.0f) ? 0.0f : ((fGreen>255.0f) ? 255.0f : fGreen);
+	fBlue = (fBlue<0.0f) ? 0.0f : ((fBlue>255.0f) ? 255.0f : fBlue);
+	Word uRed = static_cast<Word>((fRed*(31.0f/255.0f))+0.5f);
+	Word uGreen = static_cast<Word>((fGreen*(63.0f/255.0f))+0.5f);
+	Word uBlue = static_cast<Word>((fBlue*(31.0f/255.0f))+0.5f);
+	return (uRed<<11U)|(uGreen<<5U)|uBlue;
+}
+
+//
+// Snap a floating point color to the closest color the decoder can create
+//
+
+static void BURGER_API DxtSnap565(float *pOutput,const float *pColor)
+{
+	Burger::RGBWord8_t Color;
+	Burger::Palette::FromRGB16(&Color,DxtTo565(pColor));
+	pOutput[0] = static_cast<float>(Color.m_uRed);
+	pOutput[1] = static_cast<float>(Color.m_uGreen);
+	pOutput[2] = static_cast<float>(Color.m_uBlue);
+}
+
+//
+// pSums has the running sums of the sorted points, the fourth entry
+// is the number of points. Runs are [0,i) [i,j) [j,k) [k,uCount)
+// from the second endpoint to the first. In three color mode, k is
+// always uCount.
+//
+
+static float BURGER_API DxtClusterSearchGeneric(float *pStart,float *pEnd,const float (*pSums)[4],Word uCount,Word bThreeColor)
+{
+	float fBestError = 3.402823466e+38f;
+	Word i = 0;
+	do {
+		Word j = i;
+		do {
+			Word k = bThreeColor ? uCount : j;
+			do {
+				float fCount0 = static_cast<float>(i);
+				float fCount1 = static_cast<float>(j-i);
+				float fCount2 = static_cast<float>(k-j);
+				float fCount3 = static_cast<float>(uCount-k);
+				float fAlpha2,fBeta2,fAlphaBeta;
+				float fAlphaX[3];
+				float fBetaX[3];
+				Word c = 0;
+				if (bThreeColor) {
+					// Weights are 0, 1/2 and 1
+					fAlpha2 = (fCount1*0.25f)+fCount2;
+					fBeta2 = fCount0+(fCount1*0.25f);
+					fAlphaBeta = fCount1*0.25f;
+					do {
+						float fRun0 = pSums[i][c];
+						float fRun1 = pSums[j][c]-pSums[i][c];
+						float fRun2 = pSums[uCount][c]-pSums[j][c];
+						fAlphaX[c] = (fRun1*0.5f)+fRun2;
+						fBetaX[c] = fRun0+(fRun1*0.5f);
+					} while (++c<3);
+				} else {
+					// Weights are 0, 1/3, 2/3 and 1
+					fAlpha2 = ((fCount1+(fCount2*4.0f))*(1.0f/9.0f))+fCount3;
+					fBeta2 = fCount0+(((fCount1*4.0f)+fCount2)*(1.0f/9.0f));
+					fAlphaBeta = (fCount1+fCount2)*(2.0f/9.0f);
+					do {
+						float fRun0 = pSums[i][c];
+						float fRun1 = pSums[j][c]-pSums[i][c];
+						float fRun2 = pSums[k][c]-pSums[j][c];
+						float fRun3 = pSums[uCount][c]-pSums[k][c];
+						fAlphaX[c] = (fRun1*(1.0f/3.0f))+(fRun2*(2.0f/3.0f))+fRun3;
+						fBetaX[c] = fRun0+(fRun1*(2.0f/3.0f))+(fRun2*(1.0f/3.0f));
+					} while (++c<3);
+				}
+				float fDeterminant = (fAlpha2*fBeta2)-(fAlphaBeta*fAlphaBeta);
+				// All the points in one run is handled by the range fit
+				if (fDeterminant>0.0001f) {
+					fDeterminant = 1.0f/fDeterminant;
+					float fStart[3];
+					float fEnd[3];
+					c = 0;
+					do {
+						fStart[c] = ((fAlphaX[c]*fBeta2)-(fBetaX[c]*fAlphaBeta))*fDeterminant;
+						fEnd[c] = ((fBetaX[c]*fAlpha2)-(fAlphaX[c]*fAlphaBeta))*fDeterminant;
+					} while (++c<3);
+					// At the least squares solution, the squared error less the
+					// constant sum of the squared points is this. Snapping to
+					// R5:G6:B5 can only make it worse, so skip the split if it
+					// can't win.
+					float fError = 0.0f;
+					c = 0;
+					do {
+						fError -= (fStart[c]*fAlphaX[c])+(fEnd[c]*fBetaX[c]);
+					} while (++c<3);
+					if (fError<fBestError) {
+						DxtSnap565(fStart,fStart);
+						DxtSnap565(fEnd,fEnd);
+						fError = 0.0f;
+						c = 0;
+						do {
+							fError += (fStart[c]*fStart[c]*fAlpha2)+(fEnd[c]*fEnd[c]*fBeta2)+
+								(2.0f*((fStart[c]*fEnd[c]*fAlphaBeta)-(fStart[c]*fAlphaX[c])-(fEnd[c]*fBetaX[c])));
+						} while (++c<3);
+						if (fError<fBestError) {
+							fBestError = fError;
+							pStart[0] = fStart[0];
+							pStart[1] = fStart[1];
+							pStart[2] = fStart[2];
+							pEnd[0] = fEnd[0];
+							pEnd[1] = fEnd[1];
+							pEnd[2] = fEnd[2];
+						}
+					}
+				}
+			} while (++k<=uCount);
+		} while (++j<=uCount);
+	} while (++i<=uCount);
+	return fBestError;
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+//
+// Same as the generic version with red, green and blue in one register.
+// The fourth entry of each running sum is the count, so the run sizes
+// come for free.
+//
+
+static BURGER_TARGET_SSE2 BURGER_INLINE float DxtHorizontalAdd3(__m128 vInput)
+{
+	__m128 vSum = _mm_add_ss(vInput,_mm_shuffle_ps(vInput,vInput,_MM_SHUFFLE(1,1,1,1)));
+	return _mm_cvtss_f32(_mm_add_ss(vSum,_mm_movehl_ps(vInput,vInput)));
+}
+
+static BURGER_TARGET_SSE2 float BURGER_API DxtClusterSearchSSE2(float *pStart,float *pEnd,const float (*pSums)[4],Word uCount,Word bThreeColor)
+{
+	const __m128 vZero = _mm_setzero_ps();
+	const __m128 vMax = _mm_setr_ps(255.0f,255.0f,255.0f,0.0f);
+	const __m128 vScale = _mm_setr_ps(31.0f/255.0f,63.0f/255.0f,31.0f/255.0f,0.0f);
+	const __m128 vHalf = _mm_set1_ps(0.5f);
+	// Bit replication, 5 bits is (x<<3)|(x>>2) and 6 bits is (x<<2)|(x>>4)
+	const __m128i vShiftLeft = _mm_setr_epi32(8,4,8,0);
+	const __m128i vShiftRight = _mm_setr_epi32(0x4000,0x1000,0x4000,0);
+	const __m128 vThird = _mm_set1_ps(1.0f/3.0f);
+	const __m128 vTwoThirds = _mm_set1_ps(2.0f/3.0f);
+	const __m128 vTotal = _mm_loadu_ps(pSums[uCount]);
+
+	float fBestError = 3.402823466e+38f;
+	__m128 vBestStart = vZero;
+	__m128 vBestEnd = vZero;
+	Word i = 0;
+	do {
+		__m128 vSumI = _mm_loadu_ps(pSums[i]);
+		Word j = i;
+		do {
+			__m128 vSumJ = _mm_loadu_ps(pSums[j]);
+			__m128 vRun1 = _mm_sub_ps(vSumJ,vSumI);
+			Word k = bThreeColor ? uCount : j;
+			do {
+				__m128 vAlphaX,vBetaX,vAlpha2,vBeta2,vAlphaBeta;
+				if (bThreeColor) {
+					__m128 vRun2 = _mm_sub_ps(vTotal,vSumJ);
+					__m128 vHalfRun1 = _mm_mul_ps(vRun1,vHalf);
+					vAlphaX = _mm_add_ps(vHalfRun1,vRun2);
+					vBetaX = _mm_add_ps(vSumI,vHalfRun1);
+					__m128 vCount1 = _mm_shuffle_ps(vRun1,vRun1,_MM_SHUFFLE(3,3,3,3));
+					vAlphaBeta = _mm_mul_ps(vCount1,_mm_set1_ps(0.25f));
+					vAlpha2 = _mm_add_ps(vAlphaBeta,_mm_shuffle_ps(vRun2,vRun2,_MM_SHUFFLE(3,3,3,3)));
+					vBeta2 = _mm_add_ps(vAlphaBeta,_mm_shuffle_ps(vSumI,vSumI,_MM_SHUFFLE(3,3,3,3)));
+				} else {
+					__m128 vSumK = _mm_loadu_ps(pSums[k]);
+					__m128 vRun2 = _mm_sub_ps(vSumK,vSumJ);
+					__m128 vRun3 = _mm_sub_ps(vTotal,vSumK);
+					vAlphaX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vRun1,vThird),_mm_mul_ps(vRun2,vTwoThirds)),vRun3);
+					vBetaX = _mm_add_ps(_mm_add_ps(vSumI,_mm_mul_ps(vRun1,vTwoThirds)),_mm_mul_ps(vRun2,vThird));
+					__m128 vCount1 = _mm_shuffle_ps(vRun1,vRun1,_MM_SHUFFLE(3,3,3,3));
+					__m128 vCount2 = _mm_shuffle_ps(vRun2,vRun2,_MM_SHUFFLE(3,3,3,3));
+					vAlpha2 = _mm_add_ps(_mm_mul_ps(_mm_add_ps(vCount1,_mm_mul_ps(vCount2,_mm_set1_ps(4.0f))),_mm_set1_ps(1.0f/9.0f)),
+						_mm_shuffle_ps(vRun3,vRun3,_MM_SHUFFLE(3,3,3,3)));
+					vBeta2 = _mm_add_ps(_mm_shuffle_ps(vSumI,vSumI,_MM_SHUFFLE(3,3,3,3)),
+						_mm_mul_ps(_mm_add_ps(_mm_mul_ps(vCount1,_mm_set1_ps(4.0f)),vCount2),_mm_set1_ps(1.0f/9.0f)));
+					vAlphaBeta = _mm_mul_ps(_mm_add_ps(vCount1,vCount2),_mm_set1_ps(2.0f/9.0f));
+				}
+				__m128 vDeterminant = _mm_sub_ss(_mm_mul_ss(vAlpha2,vBeta2),_mm_mul_ss(vAlphaBeta,vAlphaBeta));
+				// All the points in one run is handled by the range fit
+				if (_mm_comigt_ss(vDeterminant,_mm_set_ss(0.0001f))) {
+					vDeterminant = _mm_div_ss(_mm_set_ss(1.0f),vDeterminant);
+					vDeterminant = _mm_shuffle_ps(vDeterminant,vDeterminant,_MM_SHUFFLE(0,0,0,0));
+					__m128 vStart = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(vAlphaX,vBeta2),_mm_mul_ps(vBetaX,vAlphaBeta)),vDeterminant);
+					__m128 vEnd = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(vBetaX,vAlpha2),_mm_mul_ps(vAlphaX,vAlphaBeta)),vDeterminant);
+					// Lower bound of the error, see the generic version
+					__m128 vError = _mm_sub_ps(vZero,_mm_add_ps(_mm_mul_ps(vStart,vAlphaX),_mm_mul_ps(vEnd,vBetaX)));
+					if (DxtHorizontalAdd3(vError)<fBestError) {
+						// Snap to R5:G6:B5
+						vStart = _mm_min_ps(_mm_max_ps(vStart,vZero),vMax);
+						vEnd = _mm_min_ps(_mm_max_ps(vEnd,vZero),vMax);
+						__m128i vStartBits = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(vStart,vScale),vHalf));
+						__m128i vEndBits = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(vEnd,vScale),vHalf));
+						vStart = _mm_cvtepi32_ps(_mm_or_si128(_mm_mullo_epi16(vStartBits,vShiftLeft),_mm_mulhi_epu16(vStartBits,vShiftRight)));
+						vEnd = _mm_cvtepi32_ps(_mm_or_si128(_mm_mullo_epi16(vEndBits,vShiftLeft),_mm_mulhi_epu16(vEndBits,vShiftRight)));
+						vError = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(vStart,vStart),vAlpha2),_mm_mul_ps(_mm_mul_ps(vEnd,vEnd),vBeta2)),
+							_mm_mul_ps(_mm_set1_ps(2.0f),_mm_sub_ps(_mm_mul_ps(_mm_mul_ps(vStart,vEnd),vAlphaBeta),
+							_mm_add_ps(_mm_mul_ps(vStart,vAlphaX),_mm_mul_ps(vEnd,vBetaX)))));
+						float fError = DxtHorizontalAdd3(vError);
+						if (fError<fBestError) {
+							fBestError = fError;
+							vBestStart = vStart;
+							vBestEnd = vEnd;
+						}
+					}
+				}
+			} while (++k<=uCount);
+		} while (++j<=uCount);
+	} while (++i<=uCount);
+	float Temp[4];
+	_mm_storeu_ps(Temp,vBestStart);
+	pStart[0] = Temp[0];
+	pStart[1] = Temp[1];
+	pStart[2] = Temp[2];
+	_mm_storeu_ps(Temp,vBestEnd);
+	pEnd[0] = Temp[0];
+	pEnd[1] = Temp[1];
+	pEnd[2] = Temp[2];
+	return fBestError;
+}
+
+static const Burger::CPUDispatch::Variant_t g_DxtClusterSearchVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(DxtClusterSearchSSE2),Burger::CPUDispatch::kSSE2,"SSE2"},
+	{BURGER_CPU_DISPATCH_PROC(DxtClusterSearchGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_DxtClusterSearchDispatch,Burger::CPUDispatch::kFamilyPixel,g_DxtClusterSearchVariants);
+
+#define DxtClusterSearch g_DxtClusterSearchDispatch.Get<DxtClusterSearchProc>()
+#else
+#define DxtClusterSearch DxtClusterSearchGeneric
+#endif
+
+//
+// Build the four color palette from the two R5:G6:B5 endpoints
+//
+
+static void BURGER_API DxtBuildPalette(Burger::RGBAWord8_t *pColors,Word uColor1,Word uColor2,Word bFourColorOnly)
+{
+	Burger::Palette::FromRGB16(&pColors[0],uColor1);
+	Burger::Palette::FromRGB16(&pColors[1],uColor2);
+	if (bFourColorOnly || (uColor1>uColor2)) {
+		pColors[2].m_uRed = static_cast<Word8>(((pColors[0].m_uRed*2U)+pColors[1].m_uRed)/3U);
+		pColors[2].m_uGreen = static_cast<Word8>(((pColors[0].m_uGreen*2U)+pColors[1].m_uGreen)/3U);
+		pColors[2].m_uBlue = static_cast<Word8>(((pColors[0].m_uBlue*2U)+pColors[1].m_uBlue)/3U);
+		pColors[2].m_uAlpha = 255;
+		pColors[3].m_uRed = static_cast<Word8>((pColors[0].m_uRed+(pColors[1].m_uRed*2U))/3U);
+		pColors[3].m_uGreen = static_cast<Word8>((pColors[0].m_uGreen+(pColors[1].m_uGreen*2U))/3U);
+		pColors[3].m_uBlue = static_cast<Word8>((pColors[0].m_uBlue+(pColors[1].m_uBlue*2U))/3U);
+		pColors[3].m_uAlpha = 255;
+	} else {
+		pColors[2].m_uRed = static_cast<Word8>((pColors[0].m_uRed+pColors[1].m_uRed)/2U);
+		pColors[2].m_uGreen = static_cast<Word8>((pColors[0].m_uGreen+pColors[1].m_uGreen)/2U);
+		pColors[2].m_uBlue = static_cast<Word8>((pColors[0].m_uBlue+pColors[1].m_uBlue)/2U);
+		pColors[2].m_uAlpha = 255;
+		// Transparent black
+		pColors[3].m_uRed = 0;
+		pColors[3].m_uGreen = 0;
+		pColors[3].m_uBlue = 0;
+		pColors[3].m_uAlpha = 0;
+	}
+}
+
+//
+// Evaluate a pair of endpoints and keep them if they beat the best so far
+//
+
+static void BURGER_API DxtTryEndpoints(DxtColorFit_t *pFit,Word uColor1,Word uColor2,Word bThreeColor)
+{
+	// Order the endpoints to select the palette mode
+	if (bThreeColor ? (uColor1>uColor2) : (uColor1<uColor2)) {
+		Word uTemp = uColor1;
+		uColor1 = uColor2;
+		uColor2 = uTemp;
+	}
+
+	// Build the palette the same way the decoder does
+	Burger::RGBAWord8_t Colors[4];
+	DxtBuildPalette(Colors,uColor1,uColor2,pFit->m_bFourColorOnly);
+	if (!pFit->m_bFourColorOnly && (uColor1<=uColor2)) {
+		// Index 3 is transparent black, so opaque pixels can't use it
+		Colors[3] = Colors[2];
+	}
+
+	Word32 uIndexes;
+	Word32 uError = pFit->m_pIndexes(&uIndexes,pFit->m_Pixels,Colors,pFit->m_uAlphaThreshold);
+	if (uError<pFit->m_uBestError) {
+		pFit->m_uBestError = uError;
+		pFit->m_uBestColor1 = uColor1;
+		pFit->m_uBestColor2 = uColor2;
+		pFit->m_uBestIndexes = uIndexes;
+	}
+}
+
+//
+// Find the mean and principal axis of the points
+//
+
+static void BURGER_API DxtPrincipalAxis(DxtColorFit_t *pFit)
+{
+	Word uCount = pFit->m_uCount;
+	float fMean[3] = {0.0f,0.0f,0.0f};
+	Word i = 0;
+	do {
+		fMean[0] += pFit->m_Points[i][0];
+		fMean[1] += pFit->m_Points[i][1];
+		fMean[2] += pFit->m_Points[i][2];
+	} while (++i<uCount);
+	float fScale = 1.0f/static_cast<float>(uCount);
+	fMean[0] *= fScale;
+	fMean[1] *= fScale;
+	fMean[2] *= fScale;
+
+	// Covariance matrix, it's symmetrical so only 6 entries are needed
+	float fCovariance[6] = {0.0f,0.0f,0.0f,0.0f,0.0f,0.0f};
+	i = 0;
+	do {
+		float fRed = pFit->m_Points[i][0]-fMean[0];
+		float fGreen = pFit->m_Points[i][1]-fMean[1];
+		float fBlue = pFit->m_Points[i][2]-fMean[2];
+		fCovariance[0] += fRed*fRed;
+		fCovariance[1] += fRed*fGreen;
+		fCovariance[2] += fRed*fBlue;
+		fCovariance[3] += fGreen*fGreen;
+		fCovariance[4] += fGreen*fBlue;
+		fCovariance[5] += fBlue*fBlue;
+	} while (++i<uCount);
+
+	// Power iteration, starting with the row with the largest variance
+	float fAxis[3];
+	if ((fCovariance[0]>=fCovariance[3]) && (fCovariance[0]>=fCovariance[5])) {
+		fAxis[0] = fCovariance[0];
+		fAxis[1] = fCovariance[1];
+		fAxis[2] = fCovariance[2];
+	} else if (fCovariance[3]>=fCovariance[5]) {
+		fAxis[0] = fCovariance[1];
+		fAxis[1] = fCovariance[3];
+		fAxis[2] = fCovariance[4];
+	} else {
+		fAxis[0] = fCovariance[2];
+		fAxis[1] = fCovariance[4];
+		fAxis[2] = fCovariance[5];
+	}
+	i = 0;
+	do {
+		float fRed = (fAxis[0]*fCovariance[0])+(fAxis[1]*fCovariance[1])+(fAxis[2]*fCovariance[2]);
+		float fGreen = (fAxis[0]*fCovariance[1])+(fAxis[1]*fCovariance[3])+(fAxis[2]*fCovariance[4]);
+		float fBlue = (fAxis[0]*fCovariance[2])+(fAxis[1]*fCovariance[4])+(fAxis[2]*fCovariance[5]);
+		// Normalize to the largest component to prevent overflow
+		float fLargest = (fRed<0.0f) ? -fRed : fRed;
+		float fTemp = (fGreen<0.0f) ? -fGreen : fGreen;
+		if (fTemp>fLargest) {
+			fLargest = fTemp;
+		}
+		fTemp = (fBlue<0.0f) ? -fBlue : fBlue;
+		if (fTemp>fLargest) {
+			fLargest = fTemp;
+		}
+		if (fLargest<=0.0f) {
+			break;
+		}
+		fLargest = 1.0f/fLargest;
+		fAxis[0] = fRed*fLargest;
+		fAxis[1] = fGreen*fLargest;
+		fAxis[2] = fBlue*fLargest;
+	} while (++i<8);
+
+	// Make it a unit vector (Or zero if all the points are the same)
+	float fLength = (fAxis[0]*fAxis[0])+(fAxis[1]*fAxis[1])+(fAxis[2]*fAxis[2]);
+	if (fLength>0.0f) {
+		fLength = 1.0f/Burger::Sqrt(fLength);
+	}
+	pFit->m_Mean[0] = fMean[0];
+	pFit->m_Mean[1] = fMean[1];
+	pFit->m_Mean[2] = fMean[2];
+	pFit->m_Axis[0] = fAxis[0]*fLength;
+	pFit->m_Axis[1] = fAxis[1]*fLength;
+	pFit->m_Axis[2] = fAxis[2]*fLength;
+}
+
+//
+// Use the extremes of the projection onto the principal axis
+//
+
+static void BURGER_API DxtRangeFit(DxtColorFit_t *pFit,Word bThreeColor)
+{
+	float fMin = 0.0f;
+	float fMax = 0.0f;
+	Word i = 0;
+	do {
+		float fProjection = ((pFit->m_Points[i][0]-pFit->m_Mean[0])*pFit->m_Axis[0])+
+			((pFit->m_Points[i][1]-pFit->m_Mean[1])*pFit->m_Axis[1])+
+			((pFit->m_Points[i][2]-pFit->m_Mean[2])*pFit->m_Axis[2]);
+		if (fProjection<fMin) {
+			fMin = fProjection;
+		}
+		if (fProjection>fMax) {
+			fMax = fProjection;
+		}
+	} while (++i<pFit->m_uCount);
+	float fStart[3];
+	float fEnd[3];
+	i = 0;
+	do {
+		fStart[i] = pFit->m_Mean[i]+(pFit->m_Axis[i]*fMax);
+		fEnd[i] = pFit->m_Mean[i]+(pFit->m_Axis[i]*fMin);
+	} while (++i<3);
+	DxtTryEndpoints(pFit,DxtTo565(fStart),DxtTo565(fEnd),bThreeColor);
+}
+
+//
+// Sort the points along the principal axis and try every split into 3 or 4 runs
+//
+
+static void BURGER_API DxtClusterFit(DxtColorFit_t *pFit,Word bThreeColor)
+{
+	Word uCount = pFit->m_uCount;
+
+	// Sort the points by their projection on the principal axis
+	float fProjections[16];
+	Word i = 0;
+	do {
+		float fProjection = (pFit->m_Points[i][0]*pFit->m_Axis[0])+
+			(pFit->m_Points[i][1]*pFit->m_Axis[1])+
+			(pFit->m_Points[i][2]*pFit->m_Axis[2]);
+		float fPoint[3];
+		fPoint[0] = pFit->m_Points[i][0];
+		fPoint[1] = pFit->m_Points[i][1];
+		fPoint[2] = pFit->m_Points[i][2];
+		Word j = i;
+		while (j && (fProjections[j-1]>fProjection)) {
+			fProjections[j] = fProjections[j-1];
+			pFit->m_Points[j][0] = pFit->m_Points[j-1][0];
+			pFit->m_Points[j][1] = pFit->m_Points[j-1][1];
+			pFit->m_Points[j][2] = pFit->m_Points[j-1][2];
+			--j;
+		}
+		fProjections[j] = fProjection;
+		pFit->m_Points[j][0] = fPoint[0];
+		pFit->m_Points[j][1] = fPoint[1];
+		pFit->m_Points[j][2] = fPoint[2];
+	} while (++i<uCount);
+
+	// Running sums so each run's total is a subtraction
+	float fSums[17][4];
+	fSums[0][0] = 0.0f;
+	fSums[0][1] = 0.0f;
+	fSums[0][2] = 0.0f;
+	fSums[0][3] = 0.0f;
+	i = 0;
+	do {
+		fSums[i+1][0] = fSums[i][0]+pFit->m_Points[i][0];
+		fSums[i+1][1] = fSums[i][1]+pFit->m_Points[i][1];
+		fSums[i+1][2] = fSums[i][2]+pFit->m_Points[i][2];
+		fSums[i+1][3] = static_cast<float>(i+1);
+	} while (++i<uCount);
+
+	float fStart[3];
+	float fEnd[3];
+	if (pFit->m_pClusterSearch(fStart,fEnd,fSums,uCount,bThreeColor)<3.402823466e+38f) {
+		DxtTryEndpoints(pFit,DxtTo565(fStart),DxtTo565(fEnd),bThreeColor);
+	}
+}
+
+//
+// Wrapper so CompressDxtImage() can call the DXT1 encoder
+//
+
+static void BURGER_API CompressDxt1Block(void *pOutput,const Burger::RGBAWord8_t *pInput,WordPtr uStride,Word bClusterFit)
+{
+	static_cast<Burger::Dxt1Packet_t *>(pOutput)->Compress(pInput,uStride,bClusterFit);
+}
+
+//
+// Threaded image compression, each thread encodes a run of block rows
+//
+
+struct DxtImageJob_t {
+	Word8 *m_pOutput;				// First packet for this job
+	WordPtr m_uOutputStride;		// Bytes per row of packets
+	WordPtr m_uPacketSize;			// Bytes per packet
+	const Burger::RGBAWord8_t *m_pInput;	// First pixel for this job
+	WordPtr m_uInputStride;			// Bytes per row of pixels
+	Burger::DxtCompressBlockProc m_pProc;	// Block encoder
+	Word m_uWidth;					// Width in pixels
+	Word m_uHeight;					// Height of this job in pixels
+	Word m_bClusterFit;				// TRUE for the cluster fit
+};
+
+static WordPtr BURGER_API DxtImageThread(void *pData)
+{
+	DxtImageJob_t *pJob = static_cast<DxtImageJob_t *>(pData);
+	Word8 *pOutput = pJob->m_pOutput;
+	const Word8 *pInput = reinterpret_cast<const Word8 *>(pJob->m_pInput);
+	WordPtr uInputStride = pJob->m_uInputStride;
+	Word uHeight = pJob->m_uHeight;
+	do {
+		Word8 *pDest = pOutput;
+		const Burger::RGBAWord8_t *pSource = reinterpret_cast<const Burger::RGBAWord8_t *>(pInput);
+		Word uWidth = pJob->m_uWidth;
+		do {
+			if ((uWidth<4) || (uHeight<4)) {
+				// Replicate the edge pixels to fill the block
+				Burger::RGBAWord8_t LocalPixels[16];
+				Word y = 0;
+				do {
+					const Burger::RGBAWord8_t *pRow = reinterpret_cast<const Burger::RGBAWord8_t *>(reinterpret_cast<const Word8 *>(pSource)+
+						(uInputStride*((y<uHeight) ? y : (uHeight-1))));
+					Word x = 0;
+					do {
+						LocalPixels[(y*4)+x] = pRow[(x<uWidth) ? x : (uWidth-1)];
+					} while (++x<4);
+				} while (++y<4);
+				pJob->m_pProc(pDest,LocalPixels,sizeof(Burger::RGBAWord8_t)*4,pJob->m_bClusterFit);
+				if (uWidth<4) {
+					break;
+				}
+			} else {
+				pJob->m_pProc(pDest,pSource,uInputStride,pJob->m_bClusterFit);
+			}
+			pDest += pJob->m_uPacketSize;
+			pSource += 4;
+			uWidth -= 4;
+		} while (uWidth);
+		if (uHeight<4) {
+			break;
+		}
+		uHeight -= 4;
+		pOutput += pJob->m_uOutputStride;
+		pInput += uInputStride*4;
+	} while (uHeight);
+	return 0;
+}
+
+//
+// Threaded image decompression uses bigger jobs, decoding is much
+// faster than encoding
+//
+
+static const Word g_uMinDecodeBlocksPerThread = 4096;
+
+// Decode a run of color blocks into the output bitmap
+typedef void (BURGER_API *DxtColorsProc)(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Word8 *pInput,WordPtr uPacketSize,Word uBlocks,Word bFourColorOnly);
+
+static void BURGER_API DxtColorsGeneric(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Word8 *pInput,WordPtr uPacketSize,Word uBlocks,Word bFourColorOnly)
+{
+	do {
+		Burger::RGBAWord8_t Colors[4];
+		DxtBuildPalette(Colors,Burger::LittleEndian::LoadAny(reinterpret_cast<const Word16 *>(pInput)),
+			Burger::LittleEndian::LoadAny(reinterpret_cast<const Word16 *>(pInput+2)),bFourColorOnly);
+		Burger::RGBAWord8_t *pRow = pOutput;
+		Word i = 0;
+		do {
+			Word uIndex = pInput[4+i];
+			pRow[0] = Colors[uIndex&3U];
+			pRow[1] = Colors[(uIndex>>2U)&3U];
+			pRow[2] = Colors[(uIndex>>4U)&3U];
+			pRow[3] = Colors[uIndex>>6U];
+			pRow = reinterpret_cast<Burger::RGBAWord8_t *>(reinterpret_cast<Word8 *>(pRow)+uOutputStride);
+		} while (++i<4);
+		pOutput += 4;
+		pInput += uPacketSize;
+	} while (--uBlocks);
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+//
+// Build the palette as four 32 bit RGBA pixels. The divide by 3 is a
+// multiply by 0xAAAB/0x20000, which is exact for sums up to 765
+//
+
+static BURGER_TARGET_SSE2 BURGER_INLINE __m128i DxtPaletteSSE2(const Word8 *pInput,Word bFourColorOnly)
+{
+	Word uColor1 = Burger::LittleEndian::LoadAny(reinterpret_cast<const Word16 *>(pInput));
+	Word uColor2 = Burger::LittleEndian::LoadAny(reinterpret_cast<const Word16 *>(pInput+2));
+	Burger::RGBAWord8_t Ends[2];
+	Burger::Palette::FromRGB16(&Ends[0],uColor1);
+	Burger::Palette::FromRGB16(&Ends[1],uColor2);
+	__m128i vEnds = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(Ends));
+	// 16 bit components, c1 in the low half, c2 in the high half
+	__m128i vZero = _mm_setzero_si128();
+	__m128i vFirst = _mm_unpacklo_epi8(vEnds,vZero);
+	__m128i vSecond = _mm_shuffle_epi32(vFirst,_MM_SHUFFLE(1,0,3,2));
+	__m128i vMiddle;
+	if (bFourColorOnly || (uColor1>uColor2)) {
+		// (2*c1+c2)/3 and (c1+2*c2)/3
+		vMiddle = _mm_add_epi16(_mm_add_epi16(vFirst,vFirst),vSecond);
+		vMiddle = _mm_srli_epi16(_mm_mulhi_epu16(vMiddle,_mm_set1_epi16(static_cast<short>(0xAAAB))),1);
+	} else {
+		// (c1+c2)/2 and transparent black
+		vMiddle = _mm_srli_epi16(_mm_add_epi16(vFirst,vSecond),1);
+		vMiddle = _mm_unpacklo_epi64(vMiddle,vZero);
+	}
+	return _mm_unpacklo_epi64(vEnds,_mm_packus_epi16(vMiddle,vZero));
+}
+
+//
+// One block per pass, each row of indexes selects the palette entries
+// with compare masks
+//
+
+static BURGER_TARGET_SSE2 void BURGER_API DxtColorsSSE2(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Word8 *pInput,WordPtr uPacketSize,Word uBlocks,Word bFourColorOnly)
+{
+	const __m128i vIndexMask = _mm_setr_epi32(3,3<<2,3<<4,3<<6);
+	const __m128i vIndex1 = _mm_setr_epi32(1,1<<2,1<<4,1<<6);
+	const __m128i vIndex2 = _mm_setr_epi32(2,2<<2,2<<4,2<<6);
+	const __m128i vZero = _mm_setzero_si128();
+	do {
+		__m128i vPalette = DxtPaletteSSE2(pInput,bFourColorOnly);
+		__m128i vColor0 = _mm_shuffle_epi32(vPalette,0x00);
+		__m128i vColor1 = _mm_shuffle_epi32(vPalette,0x55);
+		__m128i vColor2 = _mm_shuffle_epi32(vPalette,0xAA);
+		__m128i vColor3 = _mm_shuffle_epi32(vPalette,0xFF);
+		__m128i vIndexes = _mm_set1_epi32(static_cast<int>(Burger::LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pInput+4))));
+		Word8 *pRow = reinterpret_cast<Word8 *>(pOutput);
+		Word i = 4;
+		do {
+			__m128i vRow = _mm_and_si128(vIndexes,vIndexMask);
+			__m128i vPixels = _mm_or_si128(
+				_mm_or_si128(_mm_and_si128(_mm_cmpeq_epi32(vRow,vZero),vColor0),_mm_and_si128(_mm_cmpeq_epi32(vRow,vIndex1),vColor1)),
+				_mm_or_si128(_mm_and_si128(_mm_cmpeq_epi32(vRow,vIndex2),vColor2),_mm_and_si128(_mm_cmpeq_epi32(vRow,vIndexMask),vColor3)));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pRow),vPixels);
+			vIndexes = _mm_srli_epi32(vIndexes,8);
+			pRow += uOutputStride;
+		} while (--i);
+		pOutput += 4;
+		pInput += uPacketSize;
+	} while (--uBlocks);
+}
+
+//
+// Two blocks per pass, one in each 128 bit lane. The indexes are turned
+// into byte shuffles of the palette, so a row of eight pixels is one
+// shuffle and one store
+//
+
+static BURGER_TARGET_AVX2 void BURGER_API DxtColorsAVX2(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Word8 *pInput,WordPtr uPacketSize,Word uBlocks,Word bFourColorOnly)
+{
+	if (uBlocks>=2) {
+		const __m256i vShifts = _mm256_setr_epi32(0,2,4,6,0,2,4,6);
+		const __m256i vThree = _mm256_set1_epi32(3);
+		const __m256i vSpread = _mm256_setr_epi8(0,0,0,0,4,4,4,4,8,8,8,8,12,12,12,12,0,0,0,0,4,4,4,4,8,8,8,8,12,12,12,12);
+		const __m256i vBytes = _mm256_set1_epi32(0x03020100);
+		do {
+			__m256i vPalette = _mm256_inserti128_si256(_mm256_castsi128_si256(DxtPaletteSSE2(pInput,bFourColorOnly)),
+				DxtPaletteSSE2(pInput+uPacketSize,bFourColorOnly),1);
+			__m256i vIndexes = _mm256_inserti128_si256(
+				_mm256_castsi128_si256(_mm_set1_epi32(static_cast<int>(Burger::LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pInput+4))))),
+				_mm_set1_epi32(static_cast<int>(Burger::LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pInput+uPacketSize+4)))),1);
+			vIndexes = _mm256_srlv_epi32(vIndexes,vShifts);
+			Word8 *pRow = reinterpret_cast<Word8 *>(pOutput);
+			Word i = 4;
+			do {
+				// Index*4 in every byte of the pixel, plus 0,1,2,3
+				__m256i vSelect = _mm256_slli_epi32(_mm256_and_si256(vIndexes,vThree),2);
+				vSelect = _mm256_add_epi8(_mm256_shuffle_epi8(vSelect,vSpread),vBytes);
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(pRow),_mm256_shuffle_epi8(vPalette,vSelect));
+				vIndexes = _mm256_srli_epi32(vIndexes,8);
+				pRow += uOutputStride;
+			} while (--i);
+			pOutput += 8;
+			pInput += uPacketSize*2;
+			uBlocks -= 2;
+		} while (uBlocks>=2);
+	}
+	if (uBlocks) {
+		DxtColorsSSE2(pOutput,uOutputStride,pInput,uPacketSize,uBlocks,bFourColorOnly);
+	}
+}
+
+static const Burger::CPUDispatch::Variant_t g_DxtColorsVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(DxtColorsAVX2),Burger::CPUDispatch::kAVX2,"AVX2"},
+	{BURGER_CPU_DISPATCH_PROC(DxtColorsSSE2),Burger::CPUDispatch::kSSE2,"SSE2"},
+	{BURGER_CPU_DISPATCH_PROC(DxtColorsGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_DxtColorsDispatch,Burger::CPUDispatch::kFamilyPixel,g_DxtColorsVariants);
+#define DxtColors g_DxtColorsDispatch.Get<DxtColorsProc>()
+#else
+#define DxtColors DxtColorsGeneric
+#endif
+
+//
+// Wrapper so DecompressDxtImage() can decode a row of DXT1 blocks
+//
+
+static void BURGER_API DecompressDxt1Row(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const void *pInput,Word uBlocks)
+{
+	Burger::DecompressDxtColors(pOutput,uOutputStride,pInput,sizeof(Burger::Dxt1Packet_t),uBlocks,FALSE);
+}
+
+static void BURGER_API DecompressDxt1Block(Burger::RGBAWord8_t *pOutput,const void *pInput)
+{
+	static_cast<const Burger::Dxt1Packet_t *>(pInput)->Decompress(pOutput);
+}
+
+//
+// Threaded image decompression, each thread decodes a run of block rows
+//
+
+struct DxtDecodeJob_t {
+	Burger::RGBAWord8_t *m_pOutput;	// First pixel for this job
+	WordPtr m_uOutputStride;		// Bytes per row of pixels
+	const Word8 *m_pInput;			// First packet for this job
+	WordPtr m_uInputStride;			// Bytes per row of packets
+	WordPtr m_uPacketSize;			// Bytes per packet
+	Burger::DxtDecompressRowProc m_pRowProc;	// Decoder for a row of whole blocks
+	Burger::DxtDecompressBlockProc m_pBlockProc;	// Decoder for a single clipped block
+	Word m_uWidth;					// Width in pixels
+	Word m_uHeight;					// Height of this job in pixels
+};
+
+static WordPtr BURGER_API DxtDecodeThread(void *pData)
+{
+	DxtDecodeJob_t *pJob = static_cast<DxtDecodeJob_t *>(pData);
+	Word8 *pOutput = reinterpret_cast<Word8 *>(pJob->m_pOutput);
+	WordPtr uOutputStride = pJob->m_uOutputStride;
+	const Word8 *pInput = pJob->m_pInput;
+	Word uWidth = pJob->m_uWidth;
+	Word uWholeBlocks = uWidth>>2U;
+	Word uHeight = pJob->m_uHeight;
+	do {
+		Word uBlockHeight = (uHeight<4) ? uHeight : 4;
+		Burger::RGBAWord8_t *pDest = reinterpret_cast<Burger::RGBAWord8_t *>(pOutput);
+		const Word8 *pSource = pInput;
+		Word uClipWidth = uWidth&3U;
+		if (uBlockHeight==4) {
+			// Decode the whole blocks directly into the output
+			if (uWholeBlocks) {
+				pJob->m_pRowProc(pDest,uOutputStride,pSource,uWholeBlocks);
+				pDest += uWholeBlocks*4;
+				pSource += uWholeBlocks*pJob->m_uPacketSize;
+			}
+		} else {
+			// All the blocks are clipped on the bottom row
+			uClipWidth = uWidth;
+		}
+
+		// Decode clipped blocks locally and copy the part inside the image
+		while (uClipWidth) {
+			Burger::RGBAWord8_t LocalPixels[16];
+			pJob->m_pBlockProc(LocalPixels,pSource);
+			Word uBlockWidth = (uClipWidth<4) ? uClipWidth : 4;
+			const Burger::RGBAWord8_t *pLocal = LocalPixels;
+			Burger::RGBAWord8_t *pDest2 = pDest;
+			Word y = uBlockHeight;
+			do {
+				Word x = 0;
+				do {
+					pDest2[x] = pLocal[x];
+				} while (++x<uBlockWidth);
+				pLocal += 4;
+				pDest2 = reinterpret_cast<Burger::RGBAWord8_t *>(reinterpret_cast<Word8 *>(pDest2)+uOutputStride);
+			} while (--y);
+			pDest += uBlockWidth;
+			pSource += pJob->m_uPacketSize;
+			uClipWidth -= uBlockWidth;
+		}
+		uHeight -= uBlockHeight;
+		pOutput += uOutputStride*4;
+		pInput += pJob->m_uInputStride;
+	} while (uHeight);
+	return 0;
+}
+
+#endif
+
 /*! ************************************
 
 	\brief Compress a single 4x4 block with DXT1
 
-	Given an 8 byte block of RGBA data, compress it into a 4x4 DXT1
-	color block. 
+	Given a 4x4 block of RGBA pixels, compress it into an 8 byte DXT1
+	color block.
+
+	If any pixel has an alpha less than 128, the block is encoded with three
+	colors and the transparent pixels use the fourth, which the decoder
+	returns as transparent black.
 
 	\param pInput Pointer to the start of an array of sixteen \ref RGBAWord8_t encoded 32 bit
 	pixels
 	\param uStride Byte width of each scan line for the block of uncompressed data. The default
 	is sizeof(\ref RGBAWord8_t)*4 to create a single array of 16 RGBAWord8_t pixels in a linear row.
+	\param bClusterFit \ref FALSE for the fast range fit, \ref TRUE for the slower
+	and higher quality cluster fit
+
+	\sa CompressColors(const RGBAWord8_t *,WordPtr,Word,Word) or Decompress(RGBAWord8_t *,WordPtr) const
 
 ***************************************/
 
-void Burger::Dxt1Packet_t::Compress(const RGBAWord8_t *pInput,WordPtr uStride)
+void Burger::Dxt1Packet_t::Compress(const RGBAWord8_t *pInput,WordPtr uStride,Word bClusterFit)
 {
-	// No alpha detected
-	Word Unique[16];
-	Word uUnique = 0;
-	Word uAlpha = FALSE;
-	Word i=4;
+	CompressColors(pInput,uStride,bClusterFit,TRUE);
+}
+
+/*! ************************************
+
+	\brief Compress the colors of a 4x4 block
+
+	Choose the endpoints and color indexes for a 4x4 block of pixels.
+	The range fit uses the extremes of the pixels along their principal axis.
+	The cluster fit also tries every split of the pixels, sorted along the
+	axis, into runs that share a palette entry and fits the endpoints to each
+	split with least squares. It's about ten times slower.
+
+	The palette index selection uses SSE2 on x86 CPUs, chosen by CPUDispatch.
+
+	\param pInput Pointer to the start of an array of sixteen \ref RGBAWord8_t encoded 32 bit
+	pixels
+	\param uStride Byte width of each scan line for the block of uncompressed data.
+	\param bClusterFit \ref FALSE for the fast range fit, \ref TRUE for the slower
+	and higher quality cluster fit
+	\param bPunchThrough \ref TRUE for DXT1, where pixels with alpha less than 128
+	are stored as transparent. \ref FALSE for the color part of DXT3 and DXT5
+	blocks, where alpha is ignored and the decoder always uses four colors.
+
+	\sa Compress(const RGBAWord8_t *,WordPtr,Word)
+
+***************************************/
+
+void Burger::Dxt1Packet_t::CompressColors(const RGBAWord8_t *pInput,WordPtr uStride,Word bClusterFit,Word bPunchThrough)
+{
+	DxtColorFit_t Fit;
+	Fit.m_pIndexes = DxtColorIndexes;
+	Fit.m_pClusterSearch = DxtClusterSearch;
+	Fit.m_uBestError = 0xFFFFFFFFU;
+	Fit.m_uBestColor1 = 0;
+	Fit.m_uBestColor2 = 0;
+	Fit.m_uBestIndexes = 0xFFFFFFFFU;
+	Fit.m_bFourColorOnly = !bPunchThrough;
+	Fit.m_uAlphaThreshold = 0;
+
+	// Copy the pixels and check for transparency
+	Word uTransparent = 0;
+	Word i = 0;
 	do {
-		Word uColor = Palette::ToRGB16(pInput);
+		Word j = 0;
+		do {
+			Fit.m_Pixels[(i*4)+j] = pInput[j];
+			if (pInput[j].m_uAlpha<128U) {
+				++uTransparent;
+			}
+		} while (++j<4);
 		pInput = reinterpret_cast<const RGBAWord8_t *>(reinterpret_cast<const Word8 *>(pInput)+uStride);
-	} while (--i);
+	} while (++i<4);
+
+	Word bThreeColor = FALSE;
+	if (bPunchThrough && uTransparent) {
+		bThreeColor = TRUE;
+		Fit.m_uAlphaThreshold = 128;
+	}
+
+	// Only the visible pixels are fit
+	Word uCount = 0;
+	i = 0;
+	do {
+		if (Fit.m_Pixels[i].m_uAlpha>=Fit.m_uAlphaThreshold) {
+			Fit.m_Points[uCount][0] = static_cast<float>(Fit.m_Pixels[i].m_uRed);
+			Fit.m_Points[uCount][1] = static_cast<float>(Fit.m_Pixels[i].m_uGreen);
+			Fit.m_Points[uCount][2] = static_cast<float>(Fit.m_Pixels[i].m_uBlue);
+			++uCount;
+		}
+	} while (++i<16);
+	Fit.m_uCount = uCount;
+
+	// Fully transparent blocks use the defaults
+	if (uCount) {
+		DxtPrincipalAxis(&Fit);
+		DxtRangeFit(&Fit,bThreeColor);
+		if (bClusterFit) {
+			DxtClusterFit(&Fit,bThreeColor);
+			// Opaque DXT1 blocks may do better with three colors
+			if (bPunchThrough && !bThreeColor) {
+				DxtRangeFit(&Fit,TRUE);
+				DxtClusterFit(&Fit,TRUE);
+			}
+		}
+	}
+
+	LittleEndian::Store(&m_uRGB565Color1,static_cast<Word16>(Fit.m_uBestColor1));
+	LittleEndian::Store(&m_uRGB565Color2,static_cast<Word16>(Fit.m_uBestColor2));
+	Word32 uIndexes = Fit.m_uBestIndexes;
+	m_uColorIndexes[0] = static_cast<Word8>(uIndexes);
+	m_uColorIndexes[1] = static_cast<Word8>(uIndexes>>8U);
+	m_uColorIndexes[2] = static_cast<Word8>(uIndexes>>16U);
+	m_uColorIndexes[3] = static_cast<Word8>(uIndexes>>24U);
 }
-#endif
 
 /*! ************************************
 
@@ -160,6 +1198,9 @@ void Burger::Dxt1Packet_t::Compress(const RGBAWord8_t *pInput,WordPtr uStride)
 	Given an array of 8 byte blocks of DXT1 compressed data, extract the 4x4 RGBA
 	color blocks into a bit map. 
 
+	Whole blocks are decoded directly into the output, so pOutput can point
+	into a larger strided buffer, such as a locked texture.
+
 	\note This function will handle clipping if the destination bitmap is not divisible by
 	four in the width or height
 
@@ -170,62 +1211,208 @@ void Burger::Dxt1Packet_t::Compress(const RGBAWord8_t *pInput,WordPtr uStride)
 	\param uHeight Height of the output bitmap in pixels
 	\param pInput Pointer to a matching bitmap of DXT1 compressed pixels
 	\param uInputStride Byte width of each scan line for the block of compressed data. (Usually it's uWidth*4)
+	\param uThreadCount Maximum number of threads to use
+
+	\sa DecompressDxtImage() or Dxt1Packet_t::Decompress(RGBAWord8_t *,WordPtr) const
+
+***************************************/
+
+void BURGER_API Burger::DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Dxt1Packet_t *pInput,WordPtr uInputStride,Word uThreadCount)
+{
+	DecompressDxtImage(pOutput,uOutputStride,uWidth,uHeight,pInput,uInputStride,sizeof(Dxt1Packet_t),DecompressDxt1Row,DecompressDxt1Block,uThreadCount);
+}
+
+/*! ************************************
+
+	\brief Decompress the colors of a row of DXT blocks
+
+	Decode the color part of uBlocks adjacent blocks into a strip of pixels
+	four scan lines high. The alpha of every pixel is set to 0xFF, except for
+	index 3 of three color DXT1 blocks, which is transparent black.
+
+	On x86 CPUs, CPUDispatch selects an AVX2 version that decodes two blocks at
+	a time or an SSE2 version that decodes one.
+
+	\param pOutput Pointer to the first pixel of the strip
+	\param uOutputStride Number of bytes per scan line of the output bit map
+	\param pInput Pointer to the color part of the first block
+	\param uPacketSize Bytes from one block to the next, 8 for DXT1, 16 for DXT3 and DXT5
+	\param uBlocks Number of blocks to decode, must not be zero
+	\param bFourColorOnly \ref FALSE for DXT1, \ref TRUE for DXT3 and DXT5,
+		which always use four colors
+
+	\sa DecompressDxtImage()
 
 ***************************************/
 
-void BURGER_API Burger::DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Dxt1Packet_t *pInput,WordPtr uInputStride)
+void BURGER_API Burger::DecompressDxtColors(RGBAWord8_t *pOutput,WordPtr uOutputStride,const void *pInput,WordPtr uPacketSize,Word uBlocks,Word bFourColorOnly)
+{
+	DxtColors(pOutput,uOutputStride,static_cast<const Word8 *>(pInput),uPacketSize,uBlocks,bFourColorOnly);
+}
+
+/*! ************************************
+
+	\brief Decompress an array of DXT blocks into a bitmap
+
+	Shared by the DXT1, DXT3 and DXT5 image decoders. Rows of whole blocks
+	are handed to pRowProc, which writes directly into the output. Blocks that
+	cross the right or bottom edge are decoded with pBlockProc into a
+	temporary block and only the pixels inside the image are copied.
+
+	The rows of blocks are split evenly between up to uThreadCount threads.
+	If a thread can't be started, its rows are decoded on the calling thread.
+
+	\param pOutput Pointer to the start of a bitmap in the size of uWidth and uHeight
+	\param uOutputStride Number of bytes per scan line of the output bit map
+	\param uWidth Width of the output bitmap in pixels
+	\param uHeight Height of the output bitmap in pixels
+	\param pInput Pointer to the first compressed block
+	\param uInputStride Byte width of each row of compressed blocks
+	\param uPacketSize Size in bytes of each compressed block
+	\param pRowProc Function to decode a row of whole blocks
+	\param pBlockProc Function to decode a single block into 16 pixels
+	\param uThreadCount Maximum number of threads to use
+
+	\sa DecompressImage(RGBAWord8_t *,WordPtr,Word,Word,const Dxt1Packet_t *,WordPtr,Word)
+
+***************************************/
+
+void BURGER_API Burger::DecompressDxtImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const void *pInput,WordPtr uInputStride,WordPtr uPacketSize,DxtDecompressRowProc pRowProc,DxtDecompressBlockProc pBlockProc,Word uThreadCount)
 {
 	// Anything to process?
 	if (uWidth && uHeight) {
-		// Process a line of blocks
+		Word uBlockRows = (uHeight+3)>>2U;
+		Word uMax = (((uWidth+3)>>2U)*uBlockRows)/g_uMinDecodeBlocksPerThread;
+		if (uThreadCount>uMax) {
+			uThreadCount = uMax;
+		}
+		if (uThreadCount>uBlockRows) {
+			uThreadCount = uBlockRows;
+		}
+		if (uThreadCount>g_uMaxDxtThreads) {
+			uThreadCount = g_uMaxDxtThreads;
+		}
+		if (!uThreadCount) {
+			uThreadCount = 1;
+		}
+
+		DxtDecodeJob_t Jobs[g_uMaxDxtThreads];
+		Word uJobCount = 0;
+		Word uRow = 0;
 		do {
-			// Init the steppers
-			Word uTempWidth = uWidth;
-			const Dxt1Packet_t *pDXTInput = pInput;
-			RGBAWord8_t *pDest = pOutput;
-			do {
-				// Handle clipping
-				if ((uTempWidth<4) || (uHeight<4)) {
-					// Decompress the block locally
-					RGBAWord8_t LocalPixels[16];
-					pDXTInput->Decompress(LocalPixels,sizeof(RGBAWord8_t)*4);
-					// Write the decompressed pixels to the correct image locations
-					const RGBAWord8_t *pLocal = LocalPixels;
-					RGBAWord8_t *pDest2 = pDest;
-					Word uHeightTemp = uHeight;
-					do {
-						Word uTempWidth2 = uTempWidth;
-						do {
-							// Copy the pixel value
-							pDest2[0] = pLocal[0];
-							// skip this pixel as its outside the image
-							++pLocal;
-							++pDest2;
-						} while (--uTempWidth2);
-						pLocal = pLocal+(4-uTempWidth);
-						pDest2 = reinterpret_cast<RGBAWord8_t *>(reinterpret_cast<Word8 *>(pDest2)+uOutputStride)-(4-uTempWidth);
-					} while (--uHeightTemp);
-					if (uTempWidth<4) {
-						break;
-					}
-				} else {
-					// Decompress directly into the output
-					pDXTInput->Decompress(pDest,uOutputStride);
-				}
-				++pDXTInput;		// Next cell
-				pDest+=4;			// Skip 4 pixels
-				uTempWidth-=4;
-			} while (uTempWidth);
-
-			// Clipped?
-			if (uHeight<4) {
-				break;
-			}
-			uHeight -= 4;
-			// Step to the next line of compressed pixels
-			pInput = reinterpret_cast<const Dxt1Packet_t *>(reinterpret_cast<const Word8 *>(pInput)+uInputStride);
-			// Step to the next 4 lines
-			pOutput = reinterpret_cast<RGBAWord8_t *>(reinterpret_cast<Word8 *>(pOutput)+(uOutputStride*4));
-		} while (uHeight);
+			// Spread the block rows evenly
+			Word uEnd = (uBlockRows*(uJobCount+1))/uThreadCount;
+			DxtDecodeJob_t *pJob = &Jobs[uJobCount];
+			pJob->m_pOutput = reinterpret_cast<RGBAWord8_t *>(reinterpret_cast<Word8 *>(pOutput)+(uOutputStride*uRow*4));
+			pJob->m_uOutputStride = uOutputStride;
+			pJob->m_pInput = static_cast<const Word8 *>(pInput)+(uInputStride*uRow);
+			pJob->m_uInputStride = uInputStride;
+			pJob->m_uPacketSize = uPacketSize;
+			pJob->m_pRowProc = pRowProc;
+			pJob->m_pBlockProc = pBlockProc;
+			pJob->m_uWidth = uWidth;
+			pJob->m_uHeight = ((uEnd==uBlockRows) ? uHeight : (uEnd*4))-(uRow*4);
+			++uJobCount;
+			uRow = uEnd;
+		} while (uJobCount<uThreadCount);
+
+		RunThreadJobs(DxtDecodeThread,Jobs,sizeof(DxtDecodeJob_t),uJobCount);
 	}
-}
\ No newline at end of file
+}
+
+/*! ************************************
+
+	\brief Compress a bitmap into an array of DXT1 blocks
+
+	Given an RGBA bitmap, compress it into 8 byte DXT1 blocks, each
+	one holding a 4x4 block of pixels.
+
+	\note This function will handle images that are not divisible by four in
+	the width or height, the edge pixels are repeated to fill out the blocks.
+
+	\param pOutput Pointer to the buffer to receive the DXT1 compressed blocks
+	\param uOutputStride Byte width of each row of compressed blocks. (Usually it's ((uWidth+3)/4)*8)
+	\param uWidth Width of the input bitmap in pixels
+	\param uHeight Height of the input bitmap in pixels
+	\param pInput Pointer to the start of the bitmap of \ref RGBAWord8_t encoded 32 bit pixels
+	\param uInputStride Number of bytes per scan line of the input bitmap (Usually it's uWidth*4)
+	\param bClusterFit \ref FALSE for the fast range fit, \ref TRUE for the slower
+	and higher quality cluster fit
+	\param uThreadCount Maximum number of threads to use
+
+	\sa CompressDxtImage(), Dxt1Packet_t::Compress(const RGBAWord8_t *,WordPtr,Word) or
+		DecompressImage(RGBAWord8_t *,WordPtr,Word,Word,const Dxt1Packet_t *,WordPtr,Word)
+
+***************************************/
+
+void BURGER_API Burger::CompressImage(Dxt1Packet_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const RGBAWord8_t *pInput,WordPtr uInputStride,Word bClusterFit,Word uThreadCount)
+{
+	CompressDxtImage(pOutput,uOutputStride,sizeof(Dxt1Packet_t),uWidth,uHeight,pInput,uInputStride,CompressDxt1Block,bClusterFit,uThreadCount);
+}
+
+/*! ************************************
+
+	\brief Compress a bitmap into an array of DXT blocks
+
+	Shared by the DXT1, DXT3 and DXT5 image encoders. The rows of blocks
+	are split evenly between up to uThreadCount threads, since every
+	block is encoded independently. If a thread can't be started, its
+	rows are encoded on the calling thread.
+
+	\param pOutput Pointer to the buffer to receive the compressed blocks
+	\param uOutputStride Byte width of each row of compressed blocks
+	\param uPacketSize Size in bytes of each compressed block
+	\param uWidth Width of the input bitmap in pixels
+	\param uHeight Height of the input bitmap in pixels
+	\param pInput Pointer to the start of the bitmap of \ref RGBAWord8_t encoded 32 bit pixels
+	\param uInputStride Number of bytes per scan line of the input bitmap
+	\param pProc Function to compress a single 4x4 block
+	\param bClusterFit Passed to pProc
+	\param uThreadCount Maximum number of threads to use
+
+	\sa CompressImage(Dxt1Packet_t *,WordPtr,Word,Word,const RGBAWord8_t *,WordPtr,Word,Word)
+
+***************************************/
+
+void BURGER_API Burger::CompressDxtImage(void *pOutput,WordPtr uOutputStride,WordPtr uPacketSize,Word uWidth,Word uHeight,const RGBAWord8_t *pInput,WordPtr uInputStride,DxtCompressBlockProc pProc,Word bClusterFit,Word uThreadCount)
+{
+	// Anything to process?
+	if (uWidth && uHeight) {
+		Word uBlockRows = (uHeight+3)>>2U;
+		Word uMax = (((uWidth+3)>>2U)*uBlockRows)/g_uMinBlocksPerThread;
+		if (uThreadCount>uMax) {
+			uThreadCount = uMax;
+		}
+		if (uThreadCount>uBlockRows) {
+			uThreadCount = uBlockRows;
+		}
+		if (uThreadCount>g_uMaxDxtThreads) {
+			uThreadCount = g_uMaxDxtThreads;
+		}
+		if (!uThreadCount) {
+			uThreadCount = 1;
+		}
+
+		DxtImageJob_t Jobs[g_uMaxDxtThreads];
+		Word uJobCount = 0;
+		Word uRow = 0;
+		do {
+			// Spread the block rows evenly
+			Word uEnd = (uBlockRows*(uJobCount+1))/uThreadCount;
+			DxtImageJob_t *pJob = &Jobs[uJobCount];
+			pJob->m_pOutput = static_cast<Word8 *>(pOutput)+(uOutputStride*uRow);
+			pJob->m_uOutputStride = uOutputStride;
+			pJob->m_uPacketSize = uPacketSize;
+			pJob->m_pInput = reinterpret_cast<const RGBAWord8_t *>(reinterpret_cast<const Word8 *>(pInput)+(uInputStride*uRow*4));
+			pJob->m_uInputStride = uInputStride;
+			pJob->m_pProc = pProc;
+			pJob->m_uWidth = uWidth;
+			pJob->m_uHeight = ((uEnd==uBlockRows) ? uHeight : (uEnd*4))-(uRow*4);
+			pJob->m_bClusterFit = bClusterFit;
+			++uJobCount;
+			uRow = uEnd;
+		} while (uJobCount<uThreadCount);
+
+		RunThreadJobs(DxtImageThread,Jobs,sizeof(DxtImageJob_t),uJobCount);
+	}
+}
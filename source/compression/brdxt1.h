@@ -29,9 +29,17 @@ struct Dxt1Packet_t {
 	Word16 m_uRGB565Color2;			///< Second color endpoint in R5:G6:B5 little endian format
 	Word8 m_uColorIndexes[4];		///< 2 bits per pixel color indexes for 4x4 tile
 	void Decompress(RGBAWord8_t *pOutput,WordPtr uStride = sizeof(RGBAWord8_t)*4) const;
-	void Compress(const RGBAWord8_t *pInput,WordPtr uStride = sizeof(RGBAWord8_t)*4);
+	void Compress(const RGBAWord8_t *pInput,WordPtr uStride = sizeof(RGBAWord8_t)*4,Word bClusterFit = FALSE);
+	void CompressColors(const RGBAWord8_t *pInput,WordPtr uStride,Word bClusterFit,Word bPunchThrough);
 };
-extern void BURGER_API DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Dxt1Packet_t *pInput,WordPtr uInputStride);
+typedef void (BURGER_API *DxtCompressBlockProc)(void *pOutput,const RGBAWord8_t *pInput,WordPtr uStride,Word bClusterFit);
+typedef void (BURGER_API *DxtDecompressRowProc)(RGBAWord8_t *pOutput,WordPtr uOutputStride,const void *pInput,Word uBlocks);
+typedef void (BURGER_API *DxtDecompressBlockProc)(RGBAWord8_t *pOutput,const void *pInput);
+extern void BURGER_API DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Dxt1Packet_t *pInput,WordPtr uInputStride,Word uThreadCount = 1);
+extern void BURGER_API DecompressDxtColors(RGBAWord8_t *pOutput,WordPtr uOutputStride,const void *pInput,WordPtr uPacketSize,Word uBlocks,Word bFourColorOnly);
+extern void BURGER_API DecompressDxtImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const void *pInput,WordPtr uInputStride,WordPtr uPacketSize,DxtDecompressRowProc pRowProc,DxtDecompressBlockProc pBlockProc,Word uThreadCount);
+extern void BURGER_API CompressImage(Dxt1Packet_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const RGBAWord8_t *pInput,WordPtr uInputStride,Word bClusterFit = FALSE,Word uThreadCount = 1);
+extern void BURGER_API CompressDxtImage(void *pOutput,WordPtr uOutputStride,WordPtr uPacketSize,Word uWidth,Word uHeight,const RGBAWord8_t *pInput,WordPtr uInputStride,DxtCompressBlockProc pProc,Word bClusterFit,Word uThreadCount);
 }
 /* END */
 
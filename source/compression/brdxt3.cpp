@@ -12,7 +12,13 @@
 ***************************************/
 
 #include "brdxt3.h"
+#include "brdxt1.h"
 #include "brendian.h"
+#include "brcpudispatch.h"
+
+#if defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
 
 /*! ************************************
 
@@ -115,6 +121,148 @@ void Burger::Dxt3Packet_t::Decompress(RGBAWord8_t *pOutput,WordPtr uStride) cons
 	} while (--j);
 }
 
+/*! ************************************
+
+	\brief Compress a single 4x4 block with DXT3
+
+	Given a 4x4 block of RGBA pixels, compress it into a 16 byte DXT3
+	block. Alpha is rounded to 4 bits per pixel and the color is
+	compressed the same way as a DXT1 block without transparency.
+
+	\param pInput Pointer to the start of an array of sixteen \ref RGBAWord8_t encoded 32 bit
+	pixels
+	\param uStride Byte width of each scan line for the block of uncompressed data. The default
+	is sizeof(\ref RGBAWord8_t)*4 to create a single array of 16 RGBAWord8_t pixels in a linear row.
+	\param bClusterFit \ref FALSE for the fast range fit, \ref TRUE for the slower
+	and higher quality cluster fit
+
+	\sa Dxt1Packet_t::CompressColors(const RGBAWord8_t *,WordPtr,Word,Word) or Decompress(RGBAWord8_t *,WordPtr) const
+
+***************************************/
+
+void Burger::Dxt3Packet_t::Compress(const RGBAWord8_t *pInput,WordPtr uStride,Word bClusterFit)
+{
+	// Round the alpha to the nearest 4 bit value (The decoder multiplies by 17)
+	Word8 *pAlpha = m_uAlpha;
+	const RGBAWord8_t *pRow = pInput;
+	Word i = 4;
+	do {
+		pAlpha[0] = static_cast<Word8>(((pRow[0].m_uAlpha+8U)/17U)|(((pRow[1].m_uAlpha+8U)/17U)<<4U));
+		pAlpha[1] = static_cast<Word8>(((pRow[2].m_uAlpha+8U)/17U)|(((pRow[3].m_uAlpha+8U)/17U)<<4U));
+		pAlpha += 2;
+		pRow = reinterpret_cast<const RGBAWord8_t *>(reinterpret_cast<const Word8 *>(pRow)+uStride);
+	} while (--i);
+
+	// The color block is the same as DXT1 without transparency
+	Dxt1Packet_t Color;
+	Color.CompressColors(pInput,uStride,bClusterFit,FALSE);
+	m_uRGB565Color1 = Color.m_uRGB565Color1;
+	m_uRGB565Color2 = Color.m_uRGB565Color2;
+	m_uColorIndexes[0] = Color.m_uColorIndexes[0];
+	m_uColorIndexes[1] = Color.m_uColorIndexes[1];
+	m_uColorIndexes[2] = Color.m_uColorIndexes[2];
+	m_uColorIndexes[3] = Color.m_uColorIndexes[3];
+}
+
+#if !defined(DOXYGEN)
+
+// Blocks decoded per pass, so the alpha pass finds the colors still in the cache
+static const Word g_uDxt3ChunkBlocks = 64;
+
+// Replace the alpha of a row of decoded blocks
+typedef void (BURGER_API *Dxt3AlphasProc)(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Burger::Dxt3Packet_t *pInput,Word uBlocks);
+
+static void BURGER_API Dxt3AlphasGeneric(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Burger::Dxt3Packet_t *pInput,Word uBlocks)
+{
+	do {
+		const Word8 *pAlpha = pInput->m_uAlpha;
+		Burger::RGBAWord8_t *pRow = pOutput;
+		Word i = 4;
+		do {
+			Word uAlpha = pAlpha[0];
+			pRow[0].m_uAlpha = static_cast<Word8>((uAlpha&0xFU)|(uAlpha<<4U));
+			pRow[1].m_uAlpha = static_cast<Word8>((uAlpha>>4U)|(uAlpha&0xF0U));
+			uAlpha = pAlpha[1];
+			pRow[2].m_uAlpha = static_cast<Word8>((uAlpha&0xFU)|(uAlpha<<4U));
+			pRow[3].m_uAlpha = static_cast<Word8>((uAlpha>>4U)|(uAlpha&0xF0U));
+			pAlpha += 2;
+			pRow = reinterpret_cast<Burger::RGBAWord8_t *>(reinterpret_cast<Word8 *>(pRow)+uOutputStride);
+		} while (--i);
+		pOutput += 4;
+		++pInput;
+	} while (--uBlocks);
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+//
+// Expand the 16 nibbles in one go and merge each row of four
+// alphas into the top byte of the pixels
+//
+
+static BURGER_TARGET_SSE2 void BURGER_API Dxt3AlphasSSE2(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Burger::Dxt3Packet_t *pInput,Word uBlocks)
+{
+	const __m128i vNibble = _mm_set1_epi8(0x0F);
+	const __m128i vColorMask = _mm_set1_epi32(0x00FFFFFF);
+	const __m128i vZero = _mm_setzero_si128();
+	do {
+		__m128i vPacked = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(pInput->m_uAlpha));
+		__m128i vAlphas = _mm_unpacklo_epi8(_mm_and_si128(vPacked,vNibble),_mm_and_si128(_mm_srli_epi16(vPacked,4),vNibble));
+		vAlphas = _mm_or_si128(vAlphas,_mm_slli_epi16(vAlphas,4));
+		// Move each alpha to the top byte of a 32 bit pixel
+		__m128i vLow = _mm_unpacklo_epi8(vZero,vAlphas);
+		__m128i vHigh = _mm_unpackhi_epi8(vZero,vAlphas);
+		__m128i vRows[4];
+		vRows[0] = _mm_unpacklo_epi16(vZero,vLow);
+		vRows[1] = _mm_unpackhi_epi16(vZero,vLow);
+		vRows[2] = _mm_unpacklo_epi16(vZero,vHigh);
+		vRows[3] = _mm_unpackhi_epi16(vZero,vHigh);
+		Word8 *pRow = reinterpret_cast<Word8 *>(pOutput);
+		Word i = 0;
+		do {
+			__m128i *pPixels = reinterpret_cast<__m128i *>(pRow);
+			_mm_storeu_si128(pPixels,_mm_or_si128(_mm_and_si128(_mm_loadu_si128(pPixels),vColorMask),vRows[i]));
+			pRow += uOutputStride;
+		} while (++i<4);
+		pOutput += 4;
+		++pInput;
+	} while (--uBlocks);
+}
+
+static const Burger::CPUDispatch::Variant_t g_Dxt3AlphasVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(Dxt3AlphasSSE2),Burger::CPUDispatch::kSSE2,"SSE2"},
+	{BURGER_CPU_DISPATCH_PROC(Dxt3AlphasGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_Dxt3AlphasDispatch,Burger::CPUDispatch::kFamilyPixel,g_Dxt3AlphasVariants);
+#define Dxt3Alphas g_Dxt3AlphasDispatch.Get<Dxt3AlphasProc>()
+#else
+#define Dxt3Alphas Dxt3AlphasGeneric
+#endif
+
+//
+// Decode the colors and then the alpha of a chunk of blocks
+//
+
+static void BURGER_API DecompressDxt3Row(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const void *pInput,Word uBlocks)
+{
+	const Burger::Dxt3Packet_t *pPacket = static_cast<const Burger::Dxt3Packet_t *>(pInput);
+	do {
+		Word uCount = (uBlocks<g_uDxt3ChunkBlocks) ? uBlocks : g_uDxt3ChunkBlocks;
+		Burger::DecompressDxtColors(pOutput,uOutputStride,&pPacket->m_uRGB565Color1,sizeof(Burger::Dxt3Packet_t),uCount,TRUE);
+		Dxt3Alphas(pOutput,uOutputStride,pPacket,uCount);
+		pOutput += uCount*4;
+		pPacket += uCount;
+		uBlocks -= uCount;
+	} while (uBlocks);
+}
+
+static void BURGER_API DecompressDxt3Block(Burger::RGBAWord8_t *pOutput,const void *pInput)
+{
+	static_cast<const Burger::Dxt3Packet_t *>(pInput)->Decompress(pOutput);
+}
+
+#endif
+
 /*! ************************************
 
 	\brief Decompress an array of 4x4 block compressed with DXT3
@@ -122,6 +270,9 @@ void Burger::Dxt3Packet_t::Decompress(RGBAWord8_t *pOutput,WordPtr uStride) cons
 	Given an array of 16 byte blocks of DXT3 compressed data, extract the 4x4 RGBA
 	color blocks into a bit map. 
 
+	Whole blocks are decoded directly into the output, so pOutput can point
+	into a larger strided buffer, such as a locked texture.
+
 	\note This function will handle clipping if the destination bitmap is not divisible by
 	four in the width or height
 
@@ -132,62 +283,50 @@ void Burger::Dxt3Packet_t::Decompress(RGBAWord8_t *pOutput,WordPtr uStride) cons
 	\param uHeight Height of the output bitmap in pixels
 	\param pInput Pointer to a matching bitmap of DXT3 compressed pixels
 	\param uInputStride Byte width of each scan line for the block of compressed data. (Usually it's uWidth*4)
+	\param uThreadCount Maximum number of threads to use
+
+	\sa DecompressDxtImage() or Dxt3Packet_t::Decompress(RGBAWord8_t *,WordPtr) const
 
 ***************************************/
 
-void BURGER_API Burger::DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Dxt3Packet_t *pInput,WordPtr uInputStride)
+void BURGER_API Burger::DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Dxt3Packet_t *pInput,WordPtr uInputStride,Word uThreadCount)
 {
-	// Anything to process?
-	if (uWidth && uHeight) {
-		// Process a line of blocks
-		do {
-			// Init the steppers
-			Word uTempWidth = uWidth;
-			const Dxt3Packet_t *pDXTInput = pInput;
-			RGBAWord8_t *pDest = pOutput;
-			do {
-				// Handle clipping
-				if ((uTempWidth<4) || (uHeight<4)) {
-					// Decompress the block locally
-					RGBAWord8_t LocalPixels[16];
-					pDXTInput->Decompress(LocalPixels,sizeof(RGBAWord8_t)*4);
-					// Write the decompressed pixels to the correct image locations
-					const RGBAWord8_t *pLocal = LocalPixels;
-					RGBAWord8_t *pDest2 = pDest;
-					Word uHeightTemp = uHeight;
-					do {
-						Word uTempWidth2 = uTempWidth;
-						do {
-							// Copy the pixel value
-							pDest2[0] = pLocal[0];
-							// skip this pixel as its outside the image
-							++pLocal;
-							++pDest2;
-						} while (--uTempWidth2);
-						pLocal = pLocal+(4-uTempWidth);
-						pDest2 = reinterpret_cast<RGBAWord8_t *>(reinterpret_cast<Word8 *>(pDest2)+uOutputStride)-(4-uTempWidth);
-					} while (--uHeightTemp);
-					if (uTempWidth<4) {
-						break;
-					}
-				} else {
-					// Decompress directly into the output
-					pDXTInput->Decompress(pDest,uOutputStride);
-				}
-				++pDXTInput;		// Next cell
-				pDest+=4;			// Skip 4 pixels
-				uTempWidth-=4;
-			} while (uTempWidth);
-
-			// Clipped?
-			if (uHeight<4) {
-				break;
-			}
-			uHeight -= 4;
-			// Step to the next line of compressed pixels
-			pInput = reinterpret_cast<const Dxt3Packet_t *>(reinterpret_cast<const Word8 *>(pInput)+uInputStride);
-			// Step to the next 4 lines
-			pOutput = reinterpret_cast<RGBAWord8_t *>(reinterpret_cast<Word8 *>(pOutput)+(uOutputStride*4));
-		} while (uHeight);
-	}
-}
\ No newline at end of file
+	DecompressDxtImage(pOutput,uOutputStride,uWidth,uHeight,pInput,uInputStride,sizeof(Dxt3Packet_t),DecompressDxt3Row,DecompressDxt3Block,uThreadCount);
+}
+
+#if !defined(DOXYGEN)
+static void BURGER_API CompressDxt3Block(void *pOutput,const Burger::RGBAWord8_t *pInput,WordPtr uStride,Word bClusterFit)
+{
+	static_cast<Burger::Dxt3Packet_t *>(pOutput)->Compress(pInput,uStride,bClusterFit);
+}
+#endif
+
+/*! ************************************
+
+	\brief Compress a bitmap into an array of DXT3 blocks
+
+	Given an RGBA bitmap, compress it into 16 byte DXT3 blocks, each
+	one holding a 4x4 block of pixels.
+
+	\note This function will handle images that are not divisible by four in
+	the width or height, the edge pixels are repeated to fill out the blocks.
+
+	\param pOutput Pointer to the buffer to receive the DXT3 compressed blocks
+	\param uOutputStride Byte width of each row of compressed blocks. (Usually it's ((uWidth+3)/4)*16)
+	\param uWidth Width of the input bitmap in pixels
+	\param uHeight Height of the input bitmap in pixels
+	\param pInput Pointer to the start of the bitmap of \ref RGBAWord8_t encoded 32 bit pixels
+	\param uInputStride Number of bytes per scan line of the input bitmap (Usually it's uWidth*4)
+	\param bClusterFit \ref FALSE for the fast range fit, \ref TRUE for the slower
+	and higher quality cluster fit
+	\param uThreadCount Maximum number of threads to use
+
+	\sa CompressDxtImage(), Dxt3Packet_t::Compress(const RGBAWord8_t *,WordPtr,Word) or
+		DecompressImage(RGBAWord8_t *,WordPtr,Word,Word,const Dxt3Packet_t *,WordPtr,Word)
+
+***************************************/
+
+void BURGER_API Burger::CompressImage(Dxt3Packet_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const RGBAWord8_t *pInput,WordPtr uInputStride,Word bClusterFit,Word uThreadCount)
+{
+	CompressDxtImage(pOutput,uOutputStride,sizeof(Dxt3Packet_t),uWidth,uHeight,pInput,uInputStride,CompressDxt3Block,bClusterFit,uThreadCount);
+}
@@ -12,7 +12,13 @@
 ***************************************/
 
 #include "brdxt5.h"
+#include "brdxt1.h"
 #include "brendian.h"
+#include "brcpudispatch.h"
+
+#if defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
 
 /*! ************************************
 
@@ -140,6 +146,361 @@ void Burger::Dxt5Packet_t::Decompress(RGBAWord8_t *pOutput,WordPtr uStride) cons
 	} while (--i);
 }
 
+#if !defined(DOXYGEN)
+
+//
+// Build the eight entry alpha palette from the two endpoints
+//
+
+static void BURGER_API DxtBuildAlphaPalette(Word8 *pAlphas,Word uAlpha1,Word uAlpha2)
+{
+	pAlphas[0] = static_cast<Word8>(uAlpha1);
+	pAlphas[1] = static_cast<Word8>(uAlpha2);
+	if (uAlpha1<=uAlpha2) {
+		pAlphas[2] = static_cast<Word8>(((4U*uAlpha1)+(uAlpha2))/5U);
+		pAlphas[3] = static_cast<Word8>(((3U*uAlpha1)+(2U*uAlpha2))/5U);
+		pAlphas[4] = static_cast<Word8>(((2U*uAlpha1)+(3U*uAlpha2))/5U);
+		pAlphas[5] = static_cast<Word8>(((uAlpha1)+(4U*uAlpha2))/5U);
+		pAlphas[6] = 0;
+		pAlphas[7] = 255;
+	} else {
+		pAlphas[2] = static_cast<Word8>(((6U*uAlpha1)+(uAlpha2))/7U);
+		pAlphas[3] = static_cast<Word8>(((5U*uAlpha1)+(2U*uAlpha2))/7U);
+		pAlphas[4] = static_cast<Word8>(((4U*uAlpha1)+(3U*uAlpha2))/7U);
+		pAlphas[5] = static_cast<Word8>(((3U*uAlpha1)+(4U*uAlpha2))/7U);
+		pAlphas[6] = static_cast<Word8>(((2U*uAlpha1)+(5U*uAlpha2))/7U);
+		pAlphas[7] = static_cast<Word8>(((uAlpha1)+(6U*uAlpha2))/7U);
+	}
+}
+
+// Select alpha palette entries for 16 pixels, return the squared error
+typedef Word32 (BURGER_API *DxtAlphaIndexesProc)(Word8 *pIndexes,const Word8 *pAlphas,const Word8 *pPalette);
+
+static Word32 BURGER_API DxtAlphaIndexesGeneric(Word8 *pIndexes,const Word8 *pAlphas,const Word8 *pPalette)
+{
+	Word32 uError = 0;
+	Word i = 0;
+	do {
+		Word uAlpha = pAlphas[i];
+		Word uBest = 0;
+		Word uBestError = 256;
+		Word j = 0;
+		do {
+			Word uTemp = pPalette[j];
+			uTemp = (uTemp>uAlpha) ? (uTemp-uAlpha) : (uAlpha-uTemp);
+			if (uTemp<uBestError) {
+				uBestError = uTemp;
+				uBest = j;
+			}
+		} while (++j<8);
+		pIndexes[i] = static_cast<Word8>(uBest);
+		uError += uBestError*uBestError;
+	} while (++i<16);
+	return uError;
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+//
+// All 16 alphas fit in one register
+//
+
+static BURGER_TARGET_SSE2 Word32 BURGER_API DxtAlphaIndexesSSE2(Word8 *pIndexes,const Word8 *pAlphas,const Word8 *pPalette)
+{
+	const __m128i vZero = _mm_setzero_si128();
+	__m128i vAlphas = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pAlphas));
+	__m128i vEntry = _mm_set1_epi8(static_cast<char>(pPalette[0]));
+	__m128i vBestError = _mm_or_si128(_mm_subs_epu8(vAlphas,vEntry),_mm_subs_epu8(vEntry,vAlphas));
+	__m128i vBest = vZero;
+	Word j = 1;
+	do {
+		vEntry = _mm_set1_epi8(static_cast<char>(pPalette[j]));
+		__m128i vError = _mm_or_si128(_mm_subs_epu8(vAlphas,vEntry),_mm_subs_epu8(vEntry,vAlphas));
+		// Keep the previous index unless the new error is smaller
+		__m128i vKeep = _mm_cmpeq_epi8(_mm_subs_epu8(vBestError,vError),vZero);
+		vBestError = _mm_min_epu8(vBestError,vError);
+		vBest = _mm_or_si128(_mm_and_si128(vKeep,vBest),_mm_andnot_si128(vKeep,_mm_set1_epi8(static_cast<char>(j))));
+	} while (++j<8);
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(pIndexes),vBest);
+
+	// Sum the squares of the errors
+	__m128i vLow = _mm_unpacklo_epi8(vBestError,vZero);
+	__m128i vHigh = _mm_unpackhi_epi8(vBestError,vZero);
+	__m128i vSum = _mm_add_epi32(_mm_madd_epi16(vLow,vLow),_mm_madd_epi16(vHigh,vHigh));
+	vSum = _mm_add_epi32(vSum,_mm_shuffle_epi32(vSum,_MM_SHUFFLE(2,3,0,1)));
+	vSum = _mm_add_epi32(vSum,_mm_shuffle_epi32(vSum,_MM_SHUFFLE(1,0,3,2)));
+	return static_cast<Word32>(_mm_cvtsi128_si32(vSum));
+}
+
+static const Burger::CPUDispatch::Variant_t g_DxtAlphaIndexesVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(DxtAlphaIndexesSSE2),Burger::CPUDispatch::kSSE2,"SSE2"},
+	{BURGER_CPU_DISPATCH_PROC(DxtAlphaIndexesGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_DxtAlphaIndexesDispatch,Burger::CPUDispatch::kFamilyPixel,g_DxtAlphaIndexesVariants);
+
+#define DxtAlphaIndexes g_DxtAlphaIndexesDispatch.Get<DxtAlphaIndexesProc>()
+#else
+#define DxtAlphaIndexes DxtAlphaIndexesGeneric
+#endif
+
+//
+// Best alpha endpoints found so far
+//
+
+struct DxtAlphaFit_t {
+	Word8 m_Alphas[16];			// Alphas to encode
+	Word8 m_BestIndexes[16];	// Indexes of the best endpoints
+	DxtAlphaIndexesProc m_pIndexes;	// Palette index selector
+	Word32 m_uBestError;		// Squared error of the best endpoints
+	Word m_uBestAlpha1;			// First endpoint
+	Word m_uBestAlpha2;			// Second endpoint
+};
+
+//
+// Evaluate a pair of endpoints, the order selects the palette mode
+//
+
+static void BURGER_API DxtTryAlphas(DxtAlphaFit_t *pFit,Word uAlpha1,Word uAlpha2)
+{
+	// Build the palette the same way the decoder does
+	Word8 Alphas[8];
+	DxtBuildAlphaPalette(Alphas,uAlpha1,uAlpha2);
+	Word8 Indexes[16];
+	Word32 uError = pFit->m_pIndexes(Indexes,pFit->m_Alphas,Alphas);
+	if (uError<pFit->m_uBestError) {
+		pFit->m_uBestError = uError;
+		pFit->m_uBestAlpha1 = uAlpha1;
+		pFit->m_uBestAlpha2 = uAlpha2;
+		Word i = 0;
+		do {
+			pFit->m_BestIndexes[i] = Indexes[i];
+		} while (++i<16);
+	}
+}
+
+//
+// Fit the endpoints to the current best indexes with least squares
+// and try them. Returns FALSE if the fit didn't change the endpoints.
+//
+
+static Word BURGER_API DxtRefineAlphas(DxtAlphaFit_t *pFit)
+{
+	// Weight of the first endpoint for each index
+	static const float g_Weights8[8] = {1.0f,0.0f,6.0f/7.0f,5.0f/7.0f,4.0f/7.0f,3.0f/7.0f,2.0f/7.0f,1.0f/7.0f};
+	static const float g_Weights6[8] = {1.0f,0.0f,4.0f/5.0f,3.0f/5.0f,2.0f/5.0f,1.0f/5.0f,0.0f,0.0f};
+
+	Word uAlpha1 = pFit->m_uBestAlpha1;
+	Word uAlpha2 = pFit->m_uBestAlpha2;
+	Word bSix = (uAlpha1<=uAlpha2);
+	const float *pWeights = bSix ? g_Weights6 : g_Weights8;
+	float fAlpha2 = 0.0f;
+	float fBeta2 = 0.0f;
+	float fAlphaBeta = 0.0f;
+	float fAlphaX = 0.0f;
+	float fBetaX = 0.0f;
+	Word i = 0;
+	do {
+		Word uIndex = pFit->m_BestIndexes[i];
+		// The constant 0 and 255 entries don't depend on the endpoints
+		if (!bSix || (uIndex<6)) {
+			float fAlpha = pWeights[uIndex];
+			float fBeta = 1.0f-fAlpha;
+			float fValue = static_cast<float>(pFit->m_Alphas[i]);
+			fAlpha2 += fAlpha*fAlpha;
+			fBeta2 += fBeta*fBeta;
+			fAlphaBeta += fAlpha*fBeta;
+			fAlphaX += fAlpha*fValue;
+			fBetaX += fBeta*fValue;
+		}
+	} while (++i<16);
+	float fDeterminant = (fAlpha2*fBeta2)-(fAlphaBeta*fAlphaBeta);
+	if (fDeterminant<=0.0001f) {
+		return FALSE;
+	}
+	fDeterminant = 1.0f/fDeterminant;
+	float fStart = ((fAlphaX*fBeta2)-(fBetaX*fAlphaBeta))*fDeterminant;
+	float fEnd = ((fBetaX*fAlpha2)-(fAlphaX*fAlphaBeta))*fDeterminant;
+	fStart = (fStart<0.0f) ? 0.0f : ((fStart>255.0f) ? 255.0f : fStart);
+	fEnd = (fEnd<0.0f) ? 0.0f : ((fEnd>255.0f) ? 255.0f : fEnd);
+	Word uStart = static_cast<Word>(fStart+0.5f);
+	Word uEnd = static_cast<Word>(fEnd+0.5f);
+
+	// Keep the endpoint order for the palette mode in use
+	if (bSix ? (uStart>uEnd) : (uStart<uEnd)) {
+		Word uTemp = uStart;
+		uStart = uEnd;
+		uEnd = uTemp;
+	}
+	if ((uStart==uAlpha1) && (uEnd==uAlpha2)) {
+		return FALSE;
+	}
+	Word32 uError = pFit->m_uBestError;
+	DxtTryAlphas(pFit,uStart,uEnd);
+	return pFit->m_uBestError<uError;
+}
+
+#endif
+
+/*! ************************************
+
+	\brief Compress a single 4x4 block with DXT5
+
+	Given a 4x4 block of RGBA pixels, compress it into a 16 byte DXT5
+	block. The alpha endpoints are taken from the range of the alphas,
+	trying both the eight alpha and the six alpha with 0 and 255 palettes.
+	The cluster fit also refines the alpha endpoints with least squares.
+	The color is compressed the same way as a DXT1 block without
+	transparency.
+
+	\param pInput Pointer to the start of an array of sixteen \ref RGBAWord8_t encoded 32 bit
+	pixels
+	\param uStride Byte width of each scan line for the block of uncompressed data. The default
+	is sizeof(\ref RGBAWord8_t)*4 to create a single array of 16 RGBAWord8_t pixels in a linear row.
+	\param bClusterFit \ref FALSE for the fast range fit, \ref TRUE for the slower
+	and higher quality cluster fit
+
+	\sa Dxt1Packet_t::CompressColors(const RGBAWord8_t *,WordPtr,Word,Word) or Decompress(RGBAWord8_t *,WordPtr) const
+
+***************************************/
+
+void Burger::Dxt5Packet_t::Compress(const RGBAWord8_t *pInput,WordPtr uStride,Word bClusterFit)
+{
+	DxtAlphaFit_t Fit;
+	Fit.m_pIndexes = DxtAlphaIndexes;
+	Fit.m_uBestError = 0xFFFFFFFFU;
+	Fit.m_uBestAlpha1 = 0;
+	Fit.m_uBestAlpha2 = 0;
+
+	// Get the range of the alphas, with and without 0 and 255
+	Word uMin = 255;
+	Word uMax = 0;
+	Word uMinInner = 255;
+	Word uMaxInner = 0;
+	const RGBAWord8_t *pRow = pInput;
+	Word i = 0;
+	do {
+		Word j = 0;
+		do {
+			Word uAlpha = pRow[j].m_uAlpha;
+			Fit.m_Alphas[(i*4)+j] = static_cast<Word8>(uAlpha);
+			if (uAlpha<uMin) {
+				uMin = uAlpha;
+			}
+			if (uAlpha>uMax) {
+				uMax = uAlpha;
+			}
+			if (uAlpha && (uAlpha!=255)) {
+				if (uAlpha<uMinInner) {
+					uMinInner = uAlpha;
+				}
+				if (uAlpha>uMaxInner) {
+					uMaxInner = uAlpha;
+				}
+			}
+		} while (++j<4);
+		pRow = reinterpret_cast<const RGBAWord8_t *>(reinterpret_cast<const Word8 *>(pRow)+uStride);
+	} while (++i<4);
+
+	// Eight alphas use the first endpoint as the larger one
+	DxtTryAlphas(&Fit,uMax,uMin);
+	// Six alphas, with 0 and 255 available for free
+	if (Fit.m_uBestError && (uMinInner<=uMaxInner)) {
+		DxtTryAlphas(&Fit,uMinInner,uMaxInner);
+	}
+	if (bClusterFit) {
+		i = 0;
+		while (Fit.m_uBestError && (i<4) && DxtRefineAlphas(&Fit)) {
+			++i;
+		}
+	}
+
+	// Store the alpha block, two 24 bit runs of 3 bit indexes
+	m_uAlpha1 = static_cast<Word8>(Fit.m_uBestAlpha1);
+	m_uAlpha2 = static_cast<Word8>(Fit.m_uBestAlpha2);
+	const Word8 *pIndexes = Fit.m_BestIndexes;
+	i = 0;
+	do {
+		Word uBits = 0;
+		Word j = 0;
+		do {
+			uBits |= static_cast<Word>(pIndexes[j])<<(j*3U);
+		} while (++j<8);
+		m_uAlphaIndexes[i][0] = static_cast<Word8>(uBits);
+		m_uAlphaIndexes[i][1] = static_cast<Word8>(uBits>>8U);
+		m_uAlphaIndexes[i][2] = static_cast<Word8>(uBits>>16U);
+		pIndexes += 8;
+	} while (++i<2);
+
+	// The color block is the same as DXT1 without transparency
+	Dxt1Packet_t Color;
+	Color.CompressColors(pInput,uStride,bClusterFit,FALSE);
+	m_uRGB565Color1 = Color.m_uRGB565Color1;
+	m_uRGB565Color2 = Color.m_uRGB565Color2;
+	m_uColorIndexes[0] = Color.m_uColorIndexes[0];
+	m_uColorIndexes[1] = Color.m_uColorIndexes[1];
+	m_uColorIndexes[2] = Color.m_uColorIndexes[2];
+	m_uColorIndexes[3] = Color.m_uColorIndexes[3];
+}
+
+#if !defined(DOXYGEN)
+
+// Blocks decoded per pass, so the alpha pass finds the colors still in the cache
+static const Word g_uDxt5ChunkBlocks = 64;
+
+//
+// Replace the alpha of a row of decoded blocks
+//
+
+static void BURGER_API Dxt5Alphas(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const Burger::Dxt5Packet_t *pInput,Word uBlocks)
+{
+	do {
+		Word8 Alphas[8];
+		DxtBuildAlphaPalette(Alphas,pInput->m_uAlpha1,pInput->m_uAlpha2);
+		Burger::RGBAWord8_t *pRow = pOutput;
+		Word i = 0;
+		do {
+			// Two rows from each 24 bit group of 3 bit indexes
+			const Word8 *pIndexes = pInput->m_uAlphaIndexes[i];
+			Word32 uIndexes = static_cast<Word32>(pIndexes[0])|(static_cast<Word32>(pIndexes[1])<<8U)|(static_cast<Word32>(pIndexes[2])<<16U);
+			Word j = 2;
+			do {
+				pRow[0].m_uAlpha = Alphas[uIndexes&7U];
+				pRow[1].m_uAlpha = Alphas[(uIndexes>>3U)&7U];
+				pRow[2].m_uAlpha = Alphas[(uIndexes>>6U)&7U];
+				pRow[3].m_uAlpha = Alphas[(uIndexes>>9U)&7U];
+				uIndexes >>= 12U;
+				pRow = reinterpret_cast<Burger::RGBAWord8_t *>(reinterpret_cast<Word8 *>(pRow)+uOutputStride);
+			} while (--j);
+		} while (++i<2);
+		pOutput += 4;
+		++pInput;
+	} while (--uBlocks);
+}
+
+//
+// Decode the colors and then the alpha of a chunk of blocks
+//
+
+static void BURGER_API DecompressDxt5Row(Burger::RGBAWord8_t *pOutput,WordPtr uOutputStride,const void *pInput,Word uBlocks)
+{
+	const Burger::Dxt5Packet_t *pPacket = static_cast<const Burger::Dxt5Packet_t *>(pInput);
+	do {
+		Word uCount = (uBlocks<g_uDxt5ChunkBlocks) ? uBlocks : g_uDxt5ChunkBlocks;
+		Burger::DecompressDxtColors(pOutput,uOutputStride,&pPacket->m_uRGB565Color1,sizeof(Burger::Dxt5Packet_t),uCount,TRUE);
+		Dxt5Alphas(pOutput,uOutputStride,pPacket,uCount);
+		pOutput += uCount*4;
+		pPacket += uCount;
+		uBlocks -= uCount;
+	} while (uBlocks);
+}
+
+static void BURGER_API DecompressDxt5Block(Burger::RGBAWord8_t *pOutput,const void *pInput)
+{
+	static_cast<const Burger::Dxt5Packet_t *>(pInput)->Decompress(pOutput);
+}
+
+#endif
+
 /*! ************************************
 
 	\brief Decompress an array of 4x4 block compressed with DXT5
@@ -147,6 +508,9 @@ void Burger::Dxt5Packet_t::Decompress(RGBAWord8_t *pOutput,WordPtr uStride) cons
 	Given an array of 16 byte blocks of DXT5 compressed data, extract the 4x4 RGBA
 	color blocks into a bit map. 
 
+	Whole blocks are decoded directly into the output, so pOutput can point
+	into a larger strided buffer, such as a locked texture.
+
 	\note This function will handle clipping if the destination bitmap is not divisible by
 	four in the width or height
 
@@ -157,62 +521,50 @@ void Burger::Dxt5Packet_t::Decompress(RGBAWord8_t *pOutput,WordPtr uStride) cons
 	\param uHeight Height of the output bitmap in pixels
 	\param pInput Pointer to a matching bitmap of DXT5 compressed pixels
 	\param uInputStride Byte width of each scan line for the block of compressed data. (Usually it's uWidth*4)
+	\param uThreadCount Maximum number of threads to use
+
+	\sa DecompressDxtImage() or Dxt5Packet_t::Decompress(RGBAWord8_t *,WordPtr) const
 
 ***************************************/
 
-void BURGER_API Burger::DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Dxt5Packet_t *pInput,WordPtr uInputStride)
+void BURGER_API Burger::DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Dxt5Packet_t *pInput,WordPtr uInputStride,Word uThreadCount)
 {
-	// Anything to process?
-	if (uWidth && uHeight) {
-		// Process a line of blocks
-		do {
-			// Init the steppers
-			Word uTempWidth = uWidth;
-			const Dxt5Packet_t *pDXTInput = pInput;
-			RGBAWord8_t *pDest = pOutput;
-			do {
-				// Handle clipping
-				if ((uTempWidth<4) || (uHeight<4)) {
-					// Decompress the block locally
-					RGBAWord8_t LocalPixels[16];
-					pDXTInput->Decompress(LocalPixels,sizeof(RGBAWord8_t)*4);
-					// Write the decompressed pixels to the correct image locations
-					const RGBAWord8_t *pLocal = LocalPixels;
-					RGBAWord8_t *pDest2 = pDest;
-					Word uHeightTemp = uHeight;
-					do {
-						Word uTempWidth2 = uTempWidth;
-						do {
-							// Copy the pixel value
-							pDest2[0] = pLocal[0];
-							// skip this pixel as its outside the image
-							++pLocal;
-							++pDest2;
-						} while (--uTempWidth2);
-						pLocal = pLocal+(4-uTempWidth);
-						pDest2 = reinterpret_cast<RGBAWord8_t *>(reinterpret_cast<Word8 *>(pDest2)+uOutputStride)-(4-uTempWidth);
-					} while (--uHeightTemp);
-					if (uTempWidth<4) {
-						break;
-					}
-				} else {
-					// Decompress directly into the output
-					pDXTInput->Decompress(pDest,uOutputStride);
-				}
-				++pDXTInput;		// Next cell
-				pDest+=4;			// Skip 4 pixels
-				uTempWidth-=4;
-			} while (uTempWidth);
-
-			// Clipped?
-			if (uHeight<4) {
-				break;
-			}
-			uHeight -= 4;
-			// Step to the next line of compressed pixels
-			pInput = reinterpret_cast<const Dxt5Packet_t *>(reinterpret_cast<const Word8 *>(pInput)+uInputStride);
-			// Step to the next 4 lines
-			pOutput = reinterpret_cast<RGBAWord8_t *>(reinterpret_cast<Word8 *>(pOutput)+(uOutputStride*4));
-		} while (uHeight);
-	}
-}
\ No newline at end of file
+	DecompressDxtImage(pOutput,uOutputStride,uWidth,uHeight,pInput,uInputStride,sizeof(Dxt5Packet_t),DecompressDxt5Row,DecompressDxt5Block,uThreadCount);
+}
+
+#if !defined(DOXYGEN)
+static void BURGER_API CompressDxt5Block(void *pOutput,const Burger::RGBAWord8_t *pInput,WordPtr uStride,Word bClusterFit)
+{
+	static_cast<Burger::Dxt5Packet_t *>(pOutput)->Compress(pInput,uStride,bClusterFit);
+}
+#endif
+
+/*! ************************************
+
+	\brief Compress a bitmap into an array of DXT5 blocks
+
+	Given an RGBA bitmap, compress it into 16 byte DXT5 blocks, each
+	one holding a 4x4 block of pixels.
+
+	\note This function will handle images that are not divisible by four in
+	the width or height, the edge pixels are repeated to fill out the blocks.
+
+	\param pOutput Pointer to the buffer to receive the DXT5 compressed blocks
+	\param uOutputStride Byte width of each row of compressed blocks. (Usually it's ((uWidth+3)/4)*16)
+	\param uWidth Width of the input bitmap in pixels
+	\param uHeight Height of the input bitmap in pixels
+	\param pInput Pointer to the start of the bitmap of \ref RGBAWord8_t encoded 32 bit pixels
+	\param uInputStride Number of bytes per scan line of the input bitmap (Usually it's uWidth*4)
+	\param bClusterFit \ref FALSE for the fast range fit, \ref TRUE for the slower
+	and higher quality cluster fit
+	\param uThreadCount Maximum number of threads to use
+
+	\sa CompressDxtImage(), Dxt5Packet_t::Compress(const RGBAWord8_t *,WordPtr,Word) or
+		DecompressImage(RGBAWord8_t *,WordPtr,Word,Word,const Dxt5Packet_t *,WordPtr,Word)
+
+***************************************/
+
+void BURGER_API Burger::CompressImage(Dxt5Packet_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const RGBAWord8_t *pInput,WordPtr uInputStride,Word bClusterFit,Word uThreadCount)
+{
+	CompressDxtImage(pOutput,uOutputStride,sizeof(Dxt5Packet_t),uWidth,uHeight,pInput,uInputStride,CompressDxt5Block,bClusterFit,uThreadCount);
+}
@@ -32,9 +32,10 @@ struct Dxt5Packet_t {
 	Word16 m_uRGB565Color2;			///< Second color endpoint in R5:G6:B5 little endian format
 	Word8 m_uColorIndexes[4];		///< 2 bits per pixel color indexes for 4x4 tile
 	void Decompress(RGBAWord8_t *pOutput,WordPtr uStride = sizeof(RGBAWord8_t)*4) const;
-	void Compress(const RGBAWord8_t *pInput,WordPtr uStride = sizeof(RGBAWord8_t)*4);
+	void Compress(const RGBAWord8_t *pInput,WordPtr uStride = sizeof(RGBAWord8_t)*4,Word bClusterFit = FALSE);
 };
-extern void BURGER_API DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Dxt5Packet_t *pInput,WordPtr uInputStride);
+extern void BURGER_API DecompressImage(RGBAWord8_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const Dxt5Packet_t *pInput,WordPtr uInputStride,Word uThreadCount = 1);
+extern void BURGER_API CompressImage(Dxt5Packet_t *pOutput,WordPtr uOutputStride,Word uWidth,Word uHeight,const RGBAWord8_t *pInput,WordPtr uInputStride,Word bClusterFit = FALSE,Word uThreadCount = 1);
 }
 /* END */
 
@@ -0,0 +1,755 @@
+/***************************************
+
+	Multi-buffer MD5 and SHA-1 hashing
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+	MD5 and SHA-1 process each 64 byte block in a strict sequence, so
+	a single message can't be sped up with SIMD. Independent messages
+	can, by placing one message in each 32 bit lane of a vector register
+	and running the rounds on all the lanes at once.
+
+	Each lane is fed the blocks of its message followed by the padding
+	blocks. When a lane finishes, the next message is started in that
+	lane, so messages of different lengths keep all the lanes busy.
+
+***************************************/
+
+#include "brmultihash.h"
+#include "brendian.h"
+#include "brmemoryfunctions.h"
+#include "brfixedpoint.h"
+#include "brcriticalsection.h"
+#include "brcpudispatch.h"
+
+#if defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
+
+#if !defined(DOXYGEN)
+
+static const Word g_uMaxLanes = 8;				// Largest number of SIMD lanes
+static const Word g_uMaxHashThreads = 16;		// Maximum number of threads for HashBatch()
+static const WordPtr g_uMinBytesPerThread = 0x40000;	// Don't bother spawning a thread for less than this
+
+//
+// Description of the hash being performed
+//
+
+struct MultiHashInfo_t {
+	const Word32 *m_pInitial;	// Initial hash values
+	Word m_uWords;				// Number of 32 bit words in the hash
+	Word m_bBigEndian;			// TRUE if the hash is stored big endian
+};
+
+static const Word32 g_MD5Initial[4] = {
+	0x67452301U,0xEFCDAB89U,0x98BADCFEU,0x10325476U
+};
+
+static const Word32 g_SHA1Initial[5] = {
+	0x67452301U,0xEFCDAB89U,0x98BADCFEU,0x10325476U,0xC3D2E1F0U
+};
+
+static const MultiHashInfo_t g_MD5Info = {g_MD5Initial,4,FALSE};
+static const MultiHashInfo_t g_SHA1Info = {g_SHA1Initial,5,TRUE};
+
+//
+// State of a single lane
+//
+
+struct HashLane_t {
+	const Word8 *m_pInput;		// Next full block of the message
+	WordPtr m_uBlocks;			// Number of full blocks left
+	WordPtr m_uMessage;			// Index of the message being hashed
+	Word m_uTailBlocks;			// Number of padding blocks (1 or 2)
+	Word m_uTailIndex;			// Next padding block to process
+	Word m_bActive;				// TRUE if a message is in this lane
+	Word8 m_Tail[128];			// Last partial block and the padding
+};
+
+// Block fed to lanes that have no message
+static const Word8 g_ZeroBlock[64] = {0};
+
+// Process one block in every lane, state is stored as [word][lane]
+typedef void (BURGER_API *HashLanesProc)(Word32 *pState,const Word8 * const *ppBlocks);
+
+// Hash a group of messages
+typedef void (BURGER_API *HashMultipleProc)(Word8 *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount);
+
+//
+// Assign a message to a lane
+//
+
+static void BURGER_API StartLane(const MultiHashInfo_t *pInfo,HashLane_t *pLane,Word32 *pState,Word uLanes,const void *pInput,WordPtr uLength)
+{
+	pLane->m_pInput = static_cast<const Word8 *>(pInput);
+	pLane->m_uBlocks = uLength>>6U;
+	pLane->m_uTailIndex = 0;
+	pLane->m_bActive = TRUE;
+
+	// Create the final padded blocks
+	WordPtr uRemainder = uLength&63U;
+	Burger::MemoryCopy(pLane->m_Tail,pLane->m_pInput+(uLength-uRemainder),uRemainder);
+	pLane->m_Tail[uRemainder] = 0x80;
+	WordPtr uTailSize = (uRemainder<56) ? 64U : 128U;
+	pLane->m_uTailBlocks = static_cast<Word>(uTailSize>>6U);
+	Burger::MemoryClear(pLane->m_Tail+uRemainder+1,(uTailSize-8)-(uRemainder+1));
+	Word64 uBits = static_cast<Word64>(uLength)<<3U;
+	Word64 *pBits = reinterpret_cast<Word64 *>(pLane->m_Tail+(uTailSize-8));
+	if (pInfo->m_bBigEndian) {
+		Burger::BigEndian::StoreAny(pBits,uBits);
+	} else {
+		Burger::LittleEndian::StoreAny(pBits,uBits);
+	}
+
+	// Initialize the hash
+	Word i = 0;
+	do {
+		pState[i*uLanes] = pInfo->m_pInitial[i];
+	} while (++i<pInfo->m_uWords);
+}
+
+//
+// Hash a list of messages using a kernel that processes uLanes
+// messages at once
+//
+
+static void BURGER_API HashLanes(const MultiHashInfo_t *pInfo,HashLanesProc pKernel,Word uLanes,
+	Word8 *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount)
+{
+	HashLane_t Lanes[g_uMaxLanes];
+	Word32 State[5*g_uMaxLanes];
+	const Word8 *Blocks[g_uMaxLanes];
+	WordPtr uOutputSize = pInfo->m_uWords*4U;
+
+	Word i = 0;
+	do {
+		Lanes[i].m_bActive = FALSE;
+	} while (++i<uLanes);
+
+	WordPtr uNext = 0;
+	for (;;) {
+		// Refill any empty lanes and gather the next block of each lane
+		Word uActive = 0;
+		i = 0;
+		do {
+			HashLane_t *pLane = &Lanes[i];
+			if (!pLane->m_bActive && (uNext<uCount)) {
+				StartLane(pInfo,pLane,State+i,uLanes,ppInputs[uNext],pLengths[uNext]);
+				pLane->m_uMessage = uNext;
+				++uNext;
+			}
+			if (pLane->m_bActive) {
+				++uActive;
+				if (pLane->m_uBlocks) {
+					Blocks[i] = pLane->m_pInput;
+				} else {
+					Blocks[i] = pLane->m_Tail+(pLane->m_uTailIndex<<6U);
+				}
+			} else {
+				Blocks[i] = g_ZeroBlock;
+			}
+		} while (++i<uLanes);
+
+		// All done?
+		if (!uActive) {
+			break;
+		}
+		pKernel(State,Blocks);
+
+		// Advance the lanes and output the finished hashes
+		i = 0;
+		do {
+			HashLane_t *pLane = &Lanes[i];
+			if (pLane->m_bActive) {
+				if (pLane->m_uBlocks) {
+					--pLane->m_uBlocks;
+					pLane->m_pInput += 64;
+				} else {
+					++pLane->m_uTailIndex;
+				}
+				if (!pLane->m_uBlocks && (pLane->m_uTailIndex==pLane->m_uTailBlocks)) {
+					Word32 *pHash = reinterpret_cast<Word32 *>(pOutput+(pLane->m_uMessage*uOutputSize));
+					Word j = 0;
+					do {
+						if (pInfo->m_bBigEndian) {
+							Burger::BigEndian::StoreAny(pHash+j,State[(j*uLanes)+i]);
+						} else {
+							Burger::LittleEndian::StoreAny(pHash+j,State[(j*uLanes)+i]);
+						}
+					} while (++j<pInfo->m_uWords);
+					pLane->m_bActive = FALSE;
+				}
+			}
+		} while (++i<uLanes);
+	}
+}
+
+//
+// Generic versions, one message at a time
+//
+
+static void BURGER_API MD5MultipleGeneric(Word8 *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount)
+{
+	while (uCount) {
+		Burger::Hash(reinterpret_cast<Burger::MD5_t *>(pOutput),ppInputs[0],pLengths[0]);
+		pOutput += sizeof(Burger::MD5_t);
+		++ppInputs;
+		++pLengths;
+		--uCount;
+	}
+}
+
+static void BURGER_API SHA1MultipleGeneric(Word8 *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount)
+{
+	while (uCount) {
+		Burger::Hash(reinterpret_cast<Burger::SHA1_t *>(pOutput),ppInputs[0],pLengths[0]);
+		pOutput += sizeof(Burger::SHA1_t);
+		++ppInputs;
+		++pLengths;
+		--uCount;
+	}
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+// MD5 additive constants and rotations
+
+static const Word32 g_MD5Constants[64] = {
+	0xD76AA478U,0xE8C7B756U,0x242070DBU,0xC1BDCEEEU,0xF57C0FAFU,0x4787C62AU,0xA8304613U,0xFD469501U,
+	0x698098D8U,0x8B44F7AFU,0xFFFF5BB1U,0x895CD7BEU,0x6B901122U,0xFD987193U,0xA679438EU,0x49B40821U,
+	0xF61E2562U,0xC040B340U,0x265E5A51U,0xE9B6C7AAU,0xD62F105DU,0x02441453U,0xD8A1E681U,0xE7D3FBC8U,
+	0x21E1CDE6U,0xC33707D6U,0xF4D50D87U,0x455A14EDU,0xA9E3E905U,0xFCEFA3F8U,0x676F02D9U,0x8D2A4C8AU,
+	0xFFFA3942U,0x8771F681U,0x6D9D6122U,0xFDE5380CU,0xA4BEEA44U,0x4BDECFA9U,0xF6BB4B60U,0xBEBFBC70U,
+	0x289B7EC6U,0xEAA127FAU,0xD4EF3085U,0x04881D05U,0xD9D4D039U,0xE6DB99E5U,0x1FA27CF8U,0xC4AC5665U,
+	0xF4292244U,0x432AFF97U,0xAB9423A7U,0xFC93A039U,0x655B59C3U,0x8F0CCC92U,0xFFEFF47DU,0x85845DD1U,
+	0x6FA87E4FU,0xFE2CE6E0U,0xA3014314U,0x4E0811A1U,0xF7537E82U,0xBD3AF235U,0x2AD7D2BBU,0xEB86D391U
+};
+
+static const Word8 g_MD5Shifts[16] = {
+	7,12,17,22,5,9,14,20,4,11,16,23,6,10,15,21
+};
+
+//
+// Each lane has its own message so the words are gathered one lane at a time
+//
+
+#define LOADLE(uLane,uIndex) static_cast<int>(Burger::LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(ppBlocks[uLane])+(uIndex)))
+#define LOADBE(uLane,uIndex) static_cast<int>(Burger::BigEndian::LoadAny(reinterpret_cast<const Word32 *>(ppBlocks[uLane])+(uIndex)))
+
+//
+// MD5, 4 lanes with SSE2
+//
+
+#define ROTATE128(x,s) _mm_or_si128(_mm_sll_epi32(x,_mm_cvtsi32_si128(s)),_mm_srl_epi32(x,_mm_cvtsi32_si128(32-(s))))
+
+static BURGER_TARGET_SSE2 void BURGER_API MD5LanesSSE2(Word32 *pState,const Word8 * const *ppBlocks) BURGER_NOEXCEPT
+{
+	__m128i X[16];
+	Word i = 0;
+	do {
+		X[i] = _mm_set_epi32(LOADLE(3,i),LOADLE(2,i),LOADLE(1,i),LOADLE(0,i));
+	} while (++i<16);
+
+	__m128i *pState128 = reinterpret_cast<__m128i *>(pState);
+	__m128i a = _mm_loadu_si128(pState128);
+	__m128i b = _mm_loadu_si128(pState128+1);
+	__m128i c = _mm_loadu_si128(pState128+2);
+	__m128i d = _mm_loadu_si128(pState128+3);
+	const __m128i vOnes = _mm_set1_epi32(-1);
+
+	// Round 1, (b&c)|(~b&d)
+	i = 0;
+	do {
+		__m128i vF = _mm_xor_si128(d,_mm_and_si128(b,_mm_xor_si128(c,d)));
+		vF = _mm_add_epi32(_mm_add_epi32(vF,a),_mm_add_epi32(_mm_set1_epi32(static_cast<int>(g_MD5Constants[i])),X[i]));
+		a = d;
+		d = c;
+		c = b;
+		b = _mm_add_epi32(b,ROTATE128(vF,g_MD5Shifts[i&3]));
+	} while (++i<16);
+
+	// Round 2, (b&d)|(c&~d)
+	do {
+		__m128i vF = _mm_xor_si128(c,_mm_and_si128(d,_mm_xor_si128(b,c)));
+		vF = _mm_add_epi32(_mm_add_epi32(vF,a),_mm_add_epi32(_mm_set1_epi32(static_cast<int>(g_MD5Constants[i])),X[((5*i)+1)&15]));
+		a = d;
+		d = c;
+		c = b;
+		b = _mm_add_epi32(b,ROTATE128(vF,g_MD5Shifts[4+(i&3)]));
+	} while (++i<32);
+
+	// Round 3, b^c^d
+	do {
+		__m128i vF = _mm_xor_si128(_mm_xor_si128(b,c),d);
+		vF = _mm_add_epi32(_mm_add_epi32(vF,a),_mm_add_epi32(_mm_set1_epi32(static_cast<int>(g_MD5Constants[i])),X[((3*i)+5)&15]));
+		a = d;
+		d = c;
+		c = b;
+		b = _mm_add_epi32(b,ROTATE128(vF,g_MD5Shifts[8+(i&3)]));
+	} while (++i<48);
+
+	// Round 4, c^(b|~d)
+	do {
+		__m128i vF = _mm_xor_si128(c,_mm_or_si128(b,_mm_xor_si128(d,vOnes)));
+		vF = _mm_add_epi32(_mm_add_epi32(vF,a),_mm_add_epi32(_mm_set1_epi32(static_cast<int>(g_MD5Constants[i])),X[(7*i)&15]));
+		a = d;
+		d = c;
+		c = b;
+		b = _mm_add_epi32(b,ROTATE128(vF,g_MD5Shifts[12+(i&3)]));
+	} while (++i<64);
+
+	_mm_storeu_si128(pState128,_mm_add_epi32(_mm_loadu_si128(pState128),a));
+	_mm_storeu_si128(pState128+1,_mm_add_epi32(_mm_loadu_si128(pState128+1),b));
+	_mm_storeu_si128(pState128+2,_mm_add_epi32(_mm_loadu_si128(pState128+2),c));
+	_mm_storeu_si128(pState128+3,_mm_add_epi32(_mm_loadu_si128(pState128+3),d));
+}
+
+//
+// MD5, 8 lanes with AVX2
+//
+
+#define ROTATE256(x,s) _mm256_or_si256(_mm256_sll_epi32(x,_mm_cvtsi32_si128(s)),_mm256_srl_epi32(x,_mm_cvtsi32_si128(32-(s))))
+
+static BURGER_TARGET_AVX2 void BURGER_API MD5LanesAVX2(Word32 *pState,const Word8 * const *ppBlocks) BURGER_NOEXCEPT
+{
+	__m256i X[16];
+	Word i = 0;
+	do {
+		X[i] = _mm256_set_epi32(LOADLE(7,i),LOADLE(6,i),LOADLE(5,i),LOADLE(4,i),
+			LOADLE(3,i),LOADLE(2,i),LOADLE(1,i),LOADLE(0,i));
+	} while (++i<16);
+
+	__m256i *pState256 = reinterpret_cast<__m256i *>(pState);
+	__m256i a = _mm256_loadu_si256(pState256);
+	__m256i b = _mm256_loadu_si256(pState256+1);
+	__m256i c = _mm256_loadu_si256(pState256+2);
+	__m256i d = _mm256_loadu_si256(pState256+3);
+	const __m256i vOnes = _mm256_set1_epi32(-1);
+
+	// Round 1, (b&c)|(~b&d)
+	i = 0;
+	do {
+		__m256i vF = _mm256_xor_si256(d,_mm256_and_si256(b,_mm256_xor_si256(c,d)));
+		vF = _mm256_add_epi32(_mm256_add_epi32(vF,a),_mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(g_MD5Constants[i])),X[i]));
+		a = d;
+		d = c;
+		c = b;
+		b = _mm256_add_epi32(b,ROTATE256(vF,g_MD5Shifts[i&3]));
+	} while (++i<16);
+
+	// Round 2, (b&d)|(c&~d)
+	do {
+		__m256i vF = _mm256_xor_si256(c,_mm256_and_si256(d,_mm256_xor_si256(b,c)));
+		vF = _mm256_add_epi32(_mm256_add_epi32(vF,a),_mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(g_MD5Constants[i])),X[((5*i)+1)&15]));
+		a = d;
+		d = c;
+		c = b;
+		b = _mm256_add_epi32(b,ROTATE256(vF,g_MD5Shifts[4+(i&3)]));
+	} while (++i<32);
+
+	// Round 3, b^c^d
+	do {
+		__m256i vF = _mm256_xor_si256(_mm256_xor_si256(b,c),d);
+		vF = _mm256_add_epi32(_mm256_add_epi32(vF,a),_mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(g_MD5Constants[i])),X[((3*i)+5)&15]));
+		a = d;
+		d = c;
+		c = b;
+		b = _mm256_add_epi32(b,ROTATE256(vF,g_MD5Shifts[8+(i&3)]));
+	} while (++i<48);
+
+	// Round 4, c^(b|~d)
+	do {
+		__m256i vF = _mm256_xor_si256(c,_mm256_or_si256(b,_mm256_xor_si256(d,vOnes)));
+		vF = _mm256_add_epi32(_mm256_add_epi32(vF,a),_mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(g_MD5Constants[i])),X[(7*i)&15]));
+		a = d;
+		d = c;
+		c = b;
+		b = _mm256_add_epi32(b,ROTATE256(vF,g_MD5Shifts[12+(i&3)]));
+	} while (++i<64);
+
+	_mm256_storeu_si256(pState256,_mm256_add_epi32(_mm256_loadu_si256(pState256),a));
+	_mm256_storeu_si256(pState256+1,_mm256_add_epi32(_mm256_loadu_si256(pState256+1),b));
+	_mm256_storeu_si256(pState256+2,_mm256_add_epi32(_mm256_loadu_si256(pState256+2),c));
+	_mm256_storeu_si256(pState256+3,_mm256_add_epi32(_mm256_loadu_si256(pState256+3),d));
+}
+
+//
+// SHA-1, 4 lanes with SSE2
+//
+
+#define ROTATE128I(x,s) _mm_or_si128(_mm_slli_epi32(x,s),_mm_srli_epi32(x,32-(s)))
+
+// Expand the message schedule in place
+#define SCHEDULE128(t) W[(t)&15] = ROTATE128I(_mm_xor_si128(_mm_xor_si128(W[((t)+13)&15],W[((t)+8)&15]),_mm_xor_si128(W[((t)+2)&15],W[(t)&15])),1)
+
+#define SHA1ROUND128(vF,vK,t) { \
+	__m128i vTemp = _mm_add_epi32(_mm_add_epi32(ROTATE128I(a,5),vF),_mm_add_epi32(_mm_add_epi32(e,vK),W[(t)&15])); \
+	e = d; \
+	d = c; \
+	c = ROTATE128I(b,30); \
+	b = a; \
+	a = vTemp; }
+
+static BURGER_TARGET_SSE2 void BURGER_API SHA1LanesSSE2(Word32 *pState,const Word8 * const *ppBlocks) BURGER_NOEXCEPT
+{
+	__m128i W[16];
+	Word i = 0;
+	do {
+		W[i] = _mm_set_epi32(LOADBE(3,i),LOADBE(2,i),LOADBE(1,i),LOADBE(0,i));
+	} while (++i<16);
+
+	__m128i *pState128 = reinterpret_cast<__m128i *>(pState);
+	__m128i a = _mm_loadu_si128(pState128);
+	__m128i b = _mm_loadu_si128(pState128+1);
+	__m128i c = _mm_loadu_si128(pState128+2);
+	__m128i d = _mm_loadu_si128(pState128+3);
+	__m128i e = _mm_loadu_si128(pState128+4);
+
+	// Rounds 0-19, (b&c)|(~b&d)
+	__m128i vK = _mm_set1_epi32(0x5A827999);
+	i = 0;
+	do {
+		if (i>=16) {
+			SCHEDULE128(i);
+		}
+		__m128i vF = _mm_xor_si128(d,_mm_and_si128(b,_mm_xor_si128(c,d)));
+		SHA1ROUND128(vF,vK,i);
+	} while (++i<20);
+
+	// Rounds 20-39, b^c^d
+	vK = _mm_set1_epi32(0x6ED9EBA1);
+	do {
+		SCHEDULE128(i);
+		__m128i vF = _mm_xor_si128(_mm_xor_si128(b,c),d);
+		SHA1ROUND128(vF,vK,i);
+	} while (++i<40);
+
+	// Rounds 40-59, majority
+	vK = _mm_set1_epi32(static_cast<int>(0x8F1BBCDCU));
+	do {
+		SCHEDULE128(i);
+		__m128i vF = _mm_or_si128(_mm_and_si128(b,c),_mm_and_si128(d,_mm_or_si128(b,c)));
+		SHA1ROUND128(vF,vK,i);
+	} while (++i<60);
+
+	// Rounds 60-79, b^c^d
+	vK = _mm_set1_epi32(static_cast<int>(0xCA62C1D6U));
+	do {
+		SCHEDULE128(i);
+		__m128i vF = _mm_xor_si128(_mm_xor_si128(b,c),d);
+		SHA1ROUND128(vF,vK,i);
+	} while (++i<80);
+
+	_mm_storeu_si128(pState128,_mm_add_epi32(_mm_loadu_si128(pState128),a));
+	_mm_storeu_si128(pState128+1,_mm_add_epi32(_mm_loadu_si128(pState128+1),b));
+	_mm_storeu_si128(pState128+2,_mm_add_epi32(_mm_loadu_si128(pState128+2),c));
+	_mm_storeu_si128(pState128+3,_mm_add_epi32(_mm_loadu_si128(pState128+3),d));
+	_mm_storeu_si128(pState128+4,_mm_add_epi32(_mm_loadu_si128(pState128+4),e));
+}
+
+//
+// SHA-1, 8 lanes with AVX2
+//
+
+#define ROTATE256I(x,s) _mm256_or_si256(_mm256_slli_epi32(x,s),_mm256_srli_epi32(x,32-(s)))
+
+#define SCHEDULE256(t) W[(t)&15] = ROTATE256I(_mm256_xor_si256(_mm256_xor_si256(W[((t)+13)&15],W[((t)+8)&15]),_mm256_xor_si256(W[((t)+2)&15],W[(t)&15])),1)
+
+#define SHA1ROUND256(vF,vK,t) { \
+	__m256i vTemp = _mm256_add_epi32(_mm256_add_epi32(ROTATE256I(a,5),vF),_mm256_add_epi32(_mm256_add_epi32(e,vK),W[(t)&15])); \
+	e = d; \
+	d = c; \
+	c = ROTATE256I(b,30); \
+	b = a; \
+	a = vTemp; }
+
+static BURGER_TARGET_AVX2 void BURGER_API SHA1LanesAVX2(Word32 *pState,const Word8 * const *ppBlocks) BURGER_NOEXCEPT
+{
+	__m256i W[16];
+	Word i = 0;
+	do {
+		W[i] = _mm256_set_epi32(LOADBE(7,i),LOADBE(6,i),LOADBE(5,i),LOADBE(4,i),
+			LOADBE(3,i),LOADBE(2,i),LOADBE(1,i),LOADBE(0,i));
+	} while (++i<16);
+
+	__m256i *pState256 = reinterpret_cast<__m256i *>(pState);
+	__m256i a = _mm256_loadu_si256(pState256);
+	__m256i b = _mm256_loadu_si256(pState256+1);
+	__m256i c = _mm256_loadu_si256(pState256+2);
+	__m256i d = _mm256_loadu_si256(pState256+3);
+	__m256i e = _mm256_loadu_si256(pState256+4);
+
+	// Rounds 0-19, (b&c)|(~b&d)
+	__m256i vK = _mm256_set1_epi32(0x5A827999);
+	i = 0;
+	do {
+		if (i>=16) {
+			SCHEDULE256(i);
+		}
+		__m256i vF = _mm256_xor_si256(d,_mm256_and_si256(b,_mm256_xor_si256(c,d)));
+		SHA1ROUND256(vF,vK,i);
+	} while (++i<20);
+
+	// Rounds 20-39, b^c^d
+	vK = _mm256_set1_epi32(0x6ED9EBA1);
+	do {
+		SCHEDULE256(i);
+		__m256i vF = _mm256_xor_si256(_mm256_xor_si256(b,c),d);
+		SHA1ROUND256(vF,vK,i);
+	} while (++i<40);
+
+	// Rounds 40-59, majority
+	vK = _mm256_set1_epi32(static_cast<int>(0x8F1BBCDCU));
+	do {
+		SCHEDULE256(i);
+		__m256i vF = _mm256_or_si256(_mm256_and_si256(b,c),_mm256_and_si256(d,_mm256_or_si256(b,c)));
+		SHA1ROUND256(vF,vK,i);
+	} while (++i<60);
+
+	// Rounds 60-79, b^c^d
+	vK = _mm256_set1_epi32(static_cast<int>(0xCA62C1D6U));
+	do {
+		SCHEDULE256(i);
+		__m256i vF = _mm256_xor_si256(_mm256_xor_si256(b,c),d);
+		SHA1ROUND256(vF,vK,i);
+	} while (++i<80);
+
+	_mm256_storeu_si256(pState256,_mm256_add_epi32(_mm256_loadu_si256(pState256),a));
+	_mm256_storeu_si256(pState256+1,_mm256_add_epi32(_mm256_loadu_si256(pState256+1),b));
+	_mm256_storeu_si256(pState256+2,_mm256_add_epi32(_mm256_loadu_si256(pState256+2),c));
+	_mm256_storeu_si256(pState256+3,_mm256_add_epi32(_mm256_loadu_si256(pState256+3),d));
+	_mm256_storeu_si256(pState256+4,_mm256_add_epi32(_mm256_loadu_si256(pState256+4),e));
+}
+
+//
+// Bind the lane kernels to the driver
+//
+
+static void BURGER_API MD5MultipleSSE2(Word8 *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount)
+{
+	HashLanes(&g_MD5Info,MD5LanesSSE2,4,pOutput,ppInputs,pLengths,uCount);
+}
+
+static void BURGER_API MD5MultipleAVX2(Word8 *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount)
+{
+	HashLanes(&g_MD5Info,MD5LanesAVX2,8,pOutput,ppInputs,pLengths,uCount);
+}
+
+static void BURGER_API SHA1MultipleSSE2(Word8 *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount)
+{
+	HashLanes(&g_SHA1Info,SHA1LanesSSE2,4,pOutput,ppInputs,pLengths,uCount);
+}
+
+static void BURGER_API SHA1MultipleAVX2(Word8 *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount)
+{
+	HashLanes(&g_SHA1Info,SHA1LanesAVX2,8,pOutput,ppInputs,pLengths,uCount);
+}
+
+static const Burger::CPUDispatch::Variant_t g_MD5MultipleVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(MD5MultipleAVX2),Burger::CPUDispatch::kAVX2,"AVX2 8 lanes"},
+	{BURGER_CPU_DISPATCH_PROC(MD5MultipleSSE2),Burger::CPUDispatch::kSSE2,"SSE2 4 lanes"},
+	{BURGER_CPU_DISPATCH_PROC(MD5MultipleGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_MD5MultipleDispatch,Burger::CPUDispatch::kFamilyHash,g_MD5MultipleVariants);
+
+// With the SHA extensions, a single stream is as fast as 8 lanes of AVX2
+static const Burger::CPUDispatch::Variant_t g_SHA1MultipleVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(SHA1MultipleGeneric),Burger::CPUDispatch::kSHA|Burger::CPUDispatch::kSSE41,"SHA-NI"},
+	{BURGER_CPU_DISPATCH_PROC(SHA1MultipleAVX2),Burger::CPUDispatch::kAVX2,"AVX2 8 lanes"},
+	{BURGER_CPU_DISPATCH_PROC(SHA1MultipleSSE2),Burger::CPUDispatch::kSSE2,"SSE2 4 lanes"},
+	{BURGER_CPU_DISPATCH_PROC(SHA1MultipleGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_SHA1MultipleDispatch,Burger::CPUDispatch::kFamilyHash,g_SHA1MultipleVariants);
+
+#define MD5Multiple g_MD5MultipleDispatch.Get<HashMultipleProc>()
+#define SHA1Multiple g_SHA1MultipleDispatch.Get<HashMultipleProc>()
+#else
+#define MD5Multiple MD5MultipleGeneric
+#define SHA1Multiple SHA1MultipleGeneric
+#endif
+
+//
+// Threaded batches, each thread hashes a run of messages
+//
+
+struct HashBatchJob_t {
+	HashMultipleProc m_pProc;		// Multi-buffer hasher
+	Word8 *m_pOutput;				// First hash for this job
+	const void * const *m_ppInputs;	// First message for this job
+	const WordPtr *m_pLengths;		// First length for this job
+	WordPtr m_uCount;				// Number of messages
+};
+
+static WordPtr BURGER_API HashBatchThread(void *pData)
+{
+	HashBatchJob_t *pJob = static_cast<HashBatchJob_t *>(pData);
+	pJob->m_pProc(pJob->m_pOutput,pJob->m_ppInputs,pJob->m_pLengths,pJob->m_uCount);
+	return 0;
+}
+
+//
+// Split the messages into runs with about the same number of bytes
+// and execute one thread per run
+// If a thread can't be started, the run is hashed on this thread
+//
+
+static void BURGER_API RunHashBatch(HashMultipleProc pProc,WordPtr uOutputSize,Word8 *pOutput,
+	const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount,Word uThreadCount)
+{
+	WordPtr uTotal = 0;
+	WordPtr i = 0;
+	while (i<uCount) {
+		uTotal += pLengths[i];
+		++i;
+	}
+	WordPtr uMax = uTotal/g_uMinBytesPerThread;
+	if (uThreadCount>uMax) {
+		uThreadCount = static_cast<Word>(uMax);
+	}
+	if (uThreadCount>uCount) {
+		uThreadCount = static_cast<Word>(uCount);
+	}
+	if (uThreadCount>g_uMaxHashThreads) {
+		uThreadCount = g_uMaxHashThreads;
+	}
+	if (uThreadCount<2) {
+		pProc(pOutput,ppInputs,pLengths,uCount);
+		return;
+	}
+
+	HashBatchJob_t Jobs[g_uMaxHashThreads];
+	WordPtr uTarget = uTotal/uThreadCount;
+	WordPtr uStart = 0;
+	Word uJobCount = 0;
+	do {
+		// Take messages until this run has its share of the bytes
+		WordPtr uEnd = uStart;
+		WordPtr uBytes = 0;
+		if (uJobCount==(uThreadCount-1)) {
+			uEnd = uCount;
+		} else {
+			while ((uEnd<uCount) && (uBytes<uTarget)) {
+				uBytes += pLengths[uEnd];
+				++uEnd;
+			}
+		}
+		HashBatchJob_t *pJob = &Jobs[uJobCount];
+		pJob->m_pProc = pProc;
+		pJob->m_pOutput = pOutput+(uStart*uOutputSize);
+		pJob->m_ppInputs = ppInputs+uStart;
+		pJob->m_pLengths = pLengths+uStart;
+		pJob->m_uCount = uEnd-uStart;
+		++uJobCount;
+		uStart = uEnd;
+	} while ((uJobCount<uThreadCount) && (uStart<uCount));
+
+	Burger::RunThreadJobs(HashBatchThread,Jobs,sizeof(HashBatchJob_t),uJobCount);
+}
+
+#endif
+
+/*! ************************************
+
+	\brief Create MD5 keys for several buffers at once
+
+	Hash uCount independent messages. On x86 CPUs with SSE2 or AVX2,
+	4 or 8 messages are hashed at the same time, one per vector lane,
+	which is much faster than hashing them one by one when there are
+	many small messages, such as the files in an asset manifest.
+
+	\param pOutput Pointer to an array of uCount MD5_t structures to receive the hashes
+	\param ppInputs Pointer to an array of uCount pointers to the messages
+	\param pLengths Pointer to an array of uCount message lengths in bytes
+	\param uCount Number of messages to hash
+
+	\sa HashBatch(MD5_t *,const void * const *,const WordPtr *,WordPtr,Word) or Hash(MD5_t *,const void *,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::HashMultiple(MD5_t *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount)
+{
+	if (uCount) {
+		MD5Multiple(pOutput->m_Hash,ppInputs,pLengths,uCount);
+	}
+}
+
+/*! ************************************
+
+	\brief Create SHA-1 keys for several buffers at once
+
+	Hash uCount independent messages. On x86 CPUs with SSE2 or AVX2,
+	4 or 8 messages are hashed at the same time, one per vector lane,
+	which is much faster than hashing them one by one when there are
+	many small messages, such as the files in an asset manifest.
+
+	\param pOutput Pointer to an array of uCount SHA1_t structures to receive the hashes
+	\param ppInputs Pointer to an array of uCount pointers to the messages
+	\param pLengths Pointer to an array of uCount message lengths in bytes
+	\param uCount Number of messages to hash
+
+	\sa HashBatch(SHA1_t *,const void * const *,const WordPtr *,WordPtr,Word) or Hash(SHA1_t *,const void *,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::HashMultiple(SHA1_t *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount)
+{
+	if (uCount) {
+		SHA1Multiple(pOutput->m_Hash,ppInputs,pLengths,uCount);
+	}
+}
+
+/*! ************************************
+
+	\brief Create MD5 keys for many buffers using several threads
+
+	The messages are split into runs of about the same number of
+	bytes and each run is hashed with HashMultiple(MD5_t *,const void * const *,const WordPtr *,WordPtr)
+	on its own thread. Small batches are hashed on the calling thread.
+
+	\param pOutput Pointer to an array of uCount MD5_t structures to receive the hashes
+	\param ppInputs Pointer to an array of uCount pointers to the messages
+	\param pLengths Pointer to an array of uCount message lengths in bytes
+	\param uCount Number of messages to hash
+	\param uThreadCount Maximum number of threads to use
+
+	\sa HashMultiple(MD5_t *,const void * const *,const WordPtr *,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::HashBatch(MD5_t *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount,Word uThreadCount)
+{
+	if (uCount) {
+		RunHashBatch(MD5Multiple,sizeof(MD5_t),pOutput->m_Hash,ppInputs,pLengths,uCount,uThreadCount);
+	}
+}
+
+/*! ************************************
+
+	\brief Create SHA-1 keys for many buffers using several threads
+
+	The messages are split into runs of about the same number of
+	bytes and each run is hashed with HashMultiple(SHA1_t *,const void * const *,const WordPtr *,WordPtr)
+	on its own thread. Small batches are hashed on the calling thread.
+
+	\param pOutput Pointer to an array of uCount SHA1_t structures to receive the hashes
+	\param ppInputs Pointer to an array of uCount pointers to the messages
+	\param pLengths Pointer to an array of uCount message lengths in bytes
+	\param uCount Number of messages to hash
+	\param uThreadCount Maximum number of threads to use
+
+	\sa HashMultiple(SHA1_t *,const void * const *,const WordPtr *,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::HashBatch(SHA1_t *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount,Word uThreadCount)
+{
+	if (uCount) {
+		RunHashBatch(SHA1Multiple,sizeof(SHA1_t),pOutput->m_Hash,ppInputs,pLengths,uCount,uThreadCount);
+	}
+}
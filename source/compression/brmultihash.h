@@ -0,0 +1,38 @@
+/***************************************
+
+	Multi-buffer MD5 and SHA-1 hashing
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRMULTIHASH_H__
+#define __BRMULTIHASH_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRMD5_H__
+#include "brmd5.h"
+#endif
+
+#ifndef __BRSHA1_H__
+#include "brsha1.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+extern void BURGER_API HashMultiple(MD5_t *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount);
+extern void BURGER_API HashMultiple(SHA1_t *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount);
+extern void BURGER_API HashBatch(MD5_t *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount,Word uThreadCount);
+extern void BURGER_API HashBatch(SHA1_t *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount,Word uThreadCount);
+}
+/* END */
+
+#endif
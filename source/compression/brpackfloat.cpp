@@ -12,6 +12,11 @@
 ***************************************/
 
 #include "brpackfloat.h"
+#include "brcpudispatch.h"
+
+#if defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
 
 /*! ************************************
 
@@ -177,4 +182,435 @@ Int16 BURGER_API Burger::PackFloatTo16(float fInput,Word32 uBaseExponent)
 	}
 	uResult |= (uInput>>16)&0x8000;			// Apply the sign
 	return static_cast<Int16>(uResult);
-}
\ No newline at end of file
+}
+
+/*! ************************************
+
+	\brief Convert an IEEE half precision float into a float
+
+	Expand a 16 bit IEEE 754 half precision float into a 32 bit float.
+	Denormals are converted exactly, infinities keep their sign and
+	NaNs are returned as quiet NaNs with the same payload, which is
+	how the F16C instruction vcvtph2ps behaves.
+
+	\param uInput 16 bit half precision float
+	\return Input expanded into a 32 bit float.
+	\sa PackFloatToHalf(float) or UnpackHalfToFloats(float *,const Word16 *,WordPtr)
+
+***************************************/
+
+float BURGER_API Burger::UnpackHalfToFloat(Word16 uInput)
+{
+	Word32 uValue = (static_cast<Word32>(uInput)&0x7FFFU)<<13U;	// Exponent and mantissa in float position
+	Word32 uExponent = uValue&0x0F800000U;
+	union {
+		float f;
+		Word32 u;
+	} Result;
+	Result.u = uValue+0x38000000U;			// Adjust the exponent bias from 15 to 127
+	if (uExponent==0x0F800000U) {
+		Result.u += 0x38000000U;			// Infinity or NaN, max out the exponent
+		if (uValue!=0x0F800000U) {
+			Result.u |= 0x00400000U;		// NaNs are always quiet
+		}
+	} else if (!uExponent) {
+		Result.u += 0x00800000U;			// Zero or denormal, let the FPU normalize it
+		Result.f -= 6.103515625e-05f;		// 2^-14
+	}
+	Result.u |= (static_cast<Word32>(uInput)&0x8000U)<<16U;	// Apply the sign
+	return Result.f;
+}
+
+/*! ************************************
+
+	\brief Convert a float into an IEEE half precision float
+
+	Convert a 32 bit float into a 16 bit IEEE 754 half precision
+	float using round to nearest even. Values too large become infinity,
+	values too small become denormals or zero and NaNs are returned as quiet
+	NaNs with the upper bits of the payload. The results are identical to
+	the F16C instruction vcvtps2ph.
+
+	\param fInput 32 bit floating point number
+	\return 16 bit half precision version of the 32 bit number.
+	\sa UnpackHalfToFloat(Word16) or PackFloatsToHalf(Word16 *,const float *,WordPtr)
+
+***************************************/
+
+Word16 BURGER_API Burger::PackFloatToHalf(float fInput)
+{
+	union {
+		float f;
+		Word32 u;
+	} Value;
+	Value.f = fInput;
+	Word32 uSign = (Value.u>>16U)&0x8000U;
+	Word32 uInput = Value.u&0x7FFFFFFFU;	// Remove the sign
+	Word32 uResult;
+	if (uInput>=0x477FF000U) {				// Rounds to 65536 or higher?
+		uResult = 0x7C00U;					// Infinity
+		if (uInput>0x7F800000U) {
+			uResult = 0x7E00U|((uInput>>13U)&0x3FFU);	// Quiet NaN
+		}
+	} else if (uInput<0x38800000U) {		// Less than 2^-14?
+		Value.u = uInput;					// Adding 0.5 makes the FPU round the
+		Value.f += 0.5f;					// denormal into the low mantissa bits
+		uResult = Value.u-0x3F000000U;
+	} else {
+		// Adjust the exponent bias from 127 to 15 and round to nearest even
+		uResult = (uInput+0xC8000FFFU+((uInput>>13U)&1U))>>13U;
+	}
+	return static_cast<Word16>(uResult|uSign);			// Apply the sign
+}
+
+#if !defined(DOXYGEN)
+
+//
+// Convert arrays one value at a time
+//
+
+typedef void (BURGER_API *UnpackFloatsProc)(float *pOutput,const Int16 *pInput,WordPtr uCount,Word32 uBaseExponent);
+typedef void (BURGER_API *PackFloatsProc)(Int16 *pOutput,const float *pInput,WordPtr uCount,Word32 uBaseExponent);
+typedef void (BURGER_API *UnpackHalfsProc)(float *pOutput,const Word16 *pInput,WordPtr uCount);
+typedef void (BURGER_API *PackHalfsProc)(Word16 *pOutput,const float *pInput,WordPtr uCount);
+
+static void BURGER_API Unpack16ToFloatsGeneric(float *pOutput,const Int16 *pInput,WordPtr uCount,Word32 uBaseExponent)
+{
+	if (uCount) {
+		do {
+			pOutput[0] = Burger::Unpack16ToFloat(pInput[0],uBaseExponent);
+			++pInput;
+			++pOutput;
+		} while (--uCount);
+	}
+}
+
+static void BURGER_API PackFloatsTo16Generic(Int16 *pOutput,const float *pInput,WordPtr uCount,Word32 uBaseExponent)
+{
+	if (uCount) {
+		do {
+			pOutput[0] = Burger::PackFloatTo16(pInput[0],uBaseExponent);
+			++pInput;
+			++pOutput;
+		} while (--uCount);
+	}
+}
+
+static void BURGER_API UnpackHalfToFloatsGeneric(float *pOutput,const Word16 *pInput,WordPtr uCount)
+{
+	if (uCount) {
+		do {
+			pOutput[0] = Burger::UnpackHalfToFloat(pInput[0]);
+			++pInput;
+			++pOutput;
+		} while (--uCount);
+	}
+}
+
+static void BURGER_API PackFloatsToHalfGeneric(Word16 *pOutput,const float *pInput,WordPtr uCount)
+{
+	if (uCount) {
+		do {
+			pOutput[0] = Burger::PackFloatToHalf(pInput[0]);
+			++pInput;
+			++pOutput;
+		} while (--uCount);
+	}
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+//
+// SSE2 versions of the bit manipulation above, eight values per pass
+//
+
+static BURGER_INLINE BURGER_TARGET_SSE2 __m128i Unpack16ToFloatSSE2(__m128i vInput,__m128i vBaseExponent)
+{
+	__m128i vValue = _mm_and_si128(vInput,_mm_set1_epi32(0x7FFF));
+	__m128i vResult = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(vInput,_mm_set1_epi32(0x7FF)),1),
+		_mm_add_epi32(_mm_slli_epi32(vValue,12),vBaseExponent));
+	vResult = _mm_andnot_si128(_mm_cmpeq_epi32(vValue,_mm_setzero_si128()),vResult);
+	return _mm_or_si128(vResult,_mm_slli_epi32(_mm_and_si128(vInput,_mm_set1_epi32(0x8000)),16));
+}
+
+static BURGER_TARGET_SSE2 void BURGER_API Unpack16ToFloatsSSE2(float *pOutput,const Int16 *pInput,WordPtr uCount,Word32 uBaseExponent)
+{
+	WordPtr uGroups = uCount>>3U;
+	if (uGroups) {
+		const __m128i vZero = _mm_setzero_si128();
+		const __m128i vBaseExponent = _mm_set1_epi32(static_cast<int>(uBaseExponent<<23U));
+		do {
+			__m128i vInput = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput),Unpack16ToFloatSSE2(_mm_unpacklo_epi16(vInput,vZero),vBaseExponent));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput+4),Unpack16ToFloatSSE2(_mm_unpackhi_epi16(vInput,vZero),vBaseExponent));
+			pInput += 8;
+			pOutput += 8;
+		} while (--uGroups);
+	}
+	Unpack16ToFloatsGeneric(pOutput,pInput,uCount&7U,uBaseExponent);
+}
+
+static BURGER_INLINE BURGER_TARGET_SSE2 __m128i PackFloatTo16SSE2(__m128i vInput,__m128i vBaseExponent,__m128i vLimit)
+{
+	const __m128i vAbsMask = _mm_set1_epi32(0x7FFFFFFF);
+	__m128i vAbs = _mm_and_si128(vInput,vAbsMask);
+	// Unsigned compare against the largest value
+	__m128i vInRange = _mm_cmplt_epi32(_mm_xor_si128(vAbs,_mm_set1_epi32(static_cast<int>(0x80000000U))),vLimit);
+	__m128i vDelta = _mm_sub_epi32(vAbs,vBaseExponent);
+	__m128i vResult = _mm_and_si128(_mm_cmpgt_epi32(vDelta,_mm_setzero_si128()),_mm_srli_epi32(vDelta,12));
+	vResult = _mm_or_si128(_mm_and_si128(vInRange,vResult),_mm_andnot_si128(vInRange,_mm_set1_epi32(0x7FFF)));
+	return _mm_or_si128(vResult,_mm_srli_epi32(_mm_andnot_si128(vAbsMask,vInput),16));
+}
+
+static BURGER_TARGET_SSE2 void BURGER_API PackFloatsTo16SSE2(Int16 *pOutput,const float *pInput,WordPtr uCount,Word32 uBaseExponent)
+{
+	WordPtr uGroups = uCount>>3U;
+	if (uGroups) {
+		const __m128i vBaseExponent = _mm_set1_epi32(static_cast<int>(uBaseExponent<<23U));
+		const __m128i vLimit = _mm_set1_epi32(static_cast<int>(((uBaseExponent+16U)<<23U)^0x80000000U));
+		do {
+			__m128i vLow = PackFloatTo16SSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput)),vBaseExponent,vLimit);
+			__m128i vHigh = PackFloatTo16SSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput+4)),vBaseExponent,vLimit);
+			// Sign extend so the signed saturation doesn't alter the bits
+			vLow = _mm_srai_epi32(_mm_slli_epi32(vLow,16),16);
+			vHigh = _mm_srai_epi32(_mm_slli_epi32(vHigh,16),16);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput),_mm_packs_epi32(vLow,vHigh));
+			pInput += 8;
+			pOutput += 8;
+		} while (--uGroups);
+	}
+	PackFloatsTo16Generic(pOutput,pInput,uCount&7U,uBaseExponent);
+}
+
+static BURGER_INLINE BURGER_TARGET_SSE2 __m128i UnpackHalfToFloatSSE2(__m128i vInput)
+{
+	const __m128i vInfinity = _mm_set1_epi32(0x0F800000);
+	__m128i vValue = _mm_slli_epi32(_mm_and_si128(vInput,_mm_set1_epi32(0x7FFF)),13);
+	__m128i vExponent = _mm_and_si128(vValue,vInfinity);
+	__m128i vResult = _mm_add_epi32(vValue,_mm_set1_epi32(0x38000000));
+	// Infinity and NaN
+	vResult = _mm_add_epi32(vResult,_mm_and_si128(_mm_cmpeq_epi32(vExponent,vInfinity),_mm_set1_epi32(0x38000000)));
+	vResult = _mm_or_si128(vResult,_mm_and_si128(_mm_cmpgt_epi32(vValue,vInfinity),_mm_set1_epi32(0x00400000)));
+	// Zero and denormals
+	__m128i vDenormal = _mm_cmpeq_epi32(vExponent,_mm_setzero_si128());
+	__m128i vFixed = _mm_castps_si128(_mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(vResult,_mm_set1_epi32(0x00800000))),
+		_mm_set1_ps(6.103515625e-05f)));
+	vResult = _mm_or_si128(_mm_and_si128(vDenormal,vFixed),_mm_andnot_si128(vDenormal,vResult));
+	return _mm_or_si128(vResult,_mm_slli_epi32(_mm_and_si128(vInput,_mm_set1_epi32(0x8000)),16));
+}
+
+static BURGER_TARGET_SSE2 void BURGER_API UnpackHalfToFloatsSSE2(float *pOutput,const Word16 *pInput,WordPtr uCount)
+{
+	WordPtr uGroups = uCount>>3U;
+	if (uGroups) {
+		const __m128i vZero = _mm_setzero_si128();
+		do {
+			__m128i vInput = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput),UnpackHalfToFloatSSE2(_mm_unpacklo_epi16(vInput,vZero)));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput+4),UnpackHalfToFloatSSE2(_mm_unpackhi_epi16(vInput,vZero)));
+			pInput += 8;
+			pOutput += 8;
+		} while (--uGroups);
+	}
+	UnpackHalfToFloatsGeneric(pOutput,pInput,uCount&7U);
+}
+
+static BURGER_INLINE BURGER_TARGET_SSE2 __m128i PackFloatToHalfSSE2(__m128i vInput)
+{
+	const __m128i vAbsMask = _mm_set1_epi32(0x7FFFFFFF);
+	__m128i vAbs = _mm_and_si128(vInput,vAbsMask);
+	// Round to nearest even
+	__m128i vOdd = _mm_and_si128(_mm_srli_epi32(vAbs,13),_mm_set1_epi32(1));
+	__m128i vResult = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(vAbs,_mm_set1_epi32(static_cast<int>(0xC8000FFFU))),vOdd),13);
+	// Denormals are rounded by the FPU
+	__m128i vDenormal = _mm_cmplt_epi32(vAbs,_mm_set1_epi32(0x38800000));
+	__m128i vFixed = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(vAbs),_mm_set1_ps(0.5f))),_mm_set1_epi32(0x3F000000));
+	vResult = _mm_or_si128(_mm_and_si128(vDenormal,vFixed),_mm_andnot_si128(vDenormal,vResult));
+	// Infinity, NaN and overflow
+	__m128i vInfinity = _mm_cmpgt_epi32(vAbs,_mm_set1_epi32(0x477FEFFF));
+	__m128i vNaN = _mm_and_si128(_mm_cmpgt_epi32(vAbs,_mm_set1_epi32(0x7F800000)),
+		_mm_or_si128(_mm_set1_epi32(0x200),_mm_and_si128(_mm_srli_epi32(vAbs,13),_mm_set1_epi32(0x3FF))));
+	vResult = _mm_or_si128(_mm_and_si128(vInfinity,_mm_or_si128(vNaN,_mm_set1_epi32(0x7C00))),_mm_andnot_si128(vInfinity,vResult));
+	// Sign extend so the signed saturation doesn't alter the bits
+	return _mm_srai_epi32(_mm_or_si128(_mm_slli_epi32(vResult,16),_mm_andnot_si128(vAbsMask,vInput)),16);
+}
+
+static BURGER_TARGET_SSE2 void BURGER_API PackFloatsToHalfSSE2(Word16 *pOutput,const float *pInput,WordPtr uCount)
+{
+	WordPtr uGroups = uCount>>3U;
+	if (uGroups) {
+		do {
+			__m128i vLow = PackFloatToHalfSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput)));
+			__m128i vHigh = PackFloatToHalfSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput+4)));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput),_mm_packs_epi32(vLow,vHigh));
+			pInput += 8;
+			pOutput += 8;
+		} while (--uGroups);
+	}
+	PackFloatsToHalfGeneric(pOutput,pInput,uCount&7U);
+}
+
+//
+// F16C does the conversion in hardware
+//
+
+static BURGER_TARGET_F16C void BURGER_API UnpackHalfToFloatsF16C(float *pOutput,const Word16 *pInput,WordPtr uCount)
+{
+	WordPtr uGroups = uCount>>3U;
+	if (uGroups) {
+		do {
+			_mm256_storeu_ps(pOutput,_mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput))));
+			pInput += 8;
+			pOutput += 8;
+		} while (--uGroups);
+	}
+	UnpackHalfToFloatsGeneric(pOutput,pInput,uCount&7U);
+}
+
+static BURGER_TARGET_F16C void BURGER_API PackFloatsToHalfF16C(Word16 *pOutput,const float *pInput,WordPtr uCount)
+{
+	WordPtr uGroups = uCount>>3U;
+	if (uGroups) {
+		do {
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput),_mm256_cvtps_ph(_mm256_loadu_ps(pInput),_MM_FROUND_TO_NEAREST_INT));
+			pInput += 8;
+			pOutput += 8;
+		} while (--uGroups);
+	}
+	PackFloatsToHalfGeneric(pOutput,pInput,uCount&7U);
+}
+
+static const Burger::CPUDispatch::Variant_t g_Unpack16ToFloatsVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(Unpack16ToFloatsSSE2),Burger::CPUDispatch::kSSE2,"SSE2"},
+	{BURGER_CPU_DISPATCH_PROC(Unpack16ToFloatsGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_Unpack16ToFloatsDispatch,Burger::CPUDispatch::kFamilyMath,g_Unpack16ToFloatsVariants);
+#define Unpack16ToFloatsProc g_Unpack16ToFloatsDispatch.Get<UnpackFloatsProc>()
+
+static const Burger::CPUDispatch::Variant_t g_PackFloatsTo16Variants[] = {
+	{BURGER_CPU_DISPATCH_PROC(PackFloatsTo16SSE2),Burger::CPUDispatch::kSSE2,"SSE2"},
+	{BURGER_CPU_DISPATCH_PROC(PackFloatsTo16Generic),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_PackFloatsTo16Dispatch,Burger::CPUDispatch::kFamilyMath,g_PackFloatsTo16Variants);
+#define PackFloatsTo16Proc g_PackFloatsTo16Dispatch.Get<PackFloatsProc>()
+
+static const Burger::CPUDispatch::Variant_t g_UnpackHalfToFloatsVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(UnpackHalfToFloatsF16C),Burger::CPUDispatch::kAVX|Burger::CPUDispatch::kF16C,"F16C"},
+	{BURGER_CPU_DISPATCH_PROC(UnpackHalfToFloatsSSE2),Burger::CPUDispatch::kSSE2,"SSE2"},
+	{BURGER_CPU_DISPATCH_PROC(UnpackHalfToFloatsGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_UnpackHalfToFloatsDispatch,Burger::CPUDispatch::kFamilyMath,g_UnpackHalfToFloatsVariants);
+#define UnpackHalfToFloatsProc g_UnpackHalfToFloatsDispatch.Get<UnpackHalfsProc>()
+
+static const Burger::CPUDispatch::Variant_t g_PackFloatsToHalfVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(PackFloatsToHalfF16C),Burger::CPUDispatch::kAVX|Burger::CPUDispatch::kF16C,"F16C"},
+	{BURGER_CPU_DISPATCH_PROC(PackFloatsToHalfSSE2),Burger::CPUDispatch::kSSE2,"SSE2"},
+	{BURGER_CPU_DISPATCH_PROC(PackFloatsToHalfGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_PackFloatsToHalfDispatch,Burger::CPUDispatch::kFamilyMath,g_PackFloatsToHalfVariants);
+#define PackFloatsToHalfProc g_PackFloatsToHalfDispatch.Get<PackHalfsProc>()
+
+#else
+#define Unpack16ToFloatsProc Unpack16ToFloatsGeneric
+#define PackFloatsTo16Proc PackFloatsTo16Generic
+#define UnpackHalfToFloatsProc UnpackHalfToFloatsGeneric
+#define PackFloatsToHalfProc PackFloatsToHalfGeneric
+#endif
+#endif
+
+/*! ************************************
+
+	\brief Decompress an array of packed floating point numbers.
+
+	Convert an array of 16 bit values created by PackFloatTo16(float,Word32)
+	or PackFloatsTo16(Int16 *,const float *,WordPtr,Word32) back into floats.
+	The results are identical to calling Unpack16ToFloat(Int16,Word32)
+	on each entry.
+
+	On x86 CPUs, an SSE2 version that converts eight values at a time
+	is selected by CPUDispatch.
+
+	\param pOutput Pointer to the array of floats to receive the results
+	\param pInput Pointer to the array of 16 bit packed floats
+	\param uCount Number of entries to convert
+	\param uBaseExponent Minimum exponent, should match the value used to apply compression (111 is used for a max value of 0.999999).
+	\sa Unpack16ToFloat(Int16,Word32) or PackFloatsTo16(Int16 *,const float *,WordPtr,Word32)
+
+***************************************/
+
+void BURGER_API Burger::Unpack16ToFloats(float *pOutput,const Int16 *pInput,WordPtr uCount,Word32 uBaseExponent)
+{
+	Unpack16ToFloatsProc(pOutput,pInput,uCount,uBaseExponent);
+}
+
+/*! ************************************
+
+	\brief Compress an array of floats into packed 16 bit values.
+
+	Convert an array of floats into 16 bit values with the same
+	rules as PackFloatTo16(float,Word32). Use
+	Unpack16ToFloats(float *,const Int16 *,WordPtr,Word32) to reconstruct
+	the numbers.
+
+	On x86 CPUs, an SSE2 version that converts eight values at a time
+	is selected by CPUDispatch.
+
+	\param pOutput Pointer to the array to receive the 16 bit packed floats
+	\param pInput Pointer to the array of floats to compress
+	\param uCount Number of entries to convert
+	\param uBaseExponent Minimum acceptable exponent, (111 is used for a max value of 0.999999).
+	\sa PackFloatTo16(float,Word32) or Unpack16ToFloats(float *,const Int16 *,WordPtr,Word32)
+
+***************************************/
+
+void BURGER_API Burger::PackFloatsTo16(Int16 *pOutput,const float *pInput,WordPtr uCount,Word32 uBaseExponent)
+{
+	PackFloatsTo16Proc(pOutput,pInput,uCount,uBaseExponent);
+}
+
+/*! ************************************
+
+	\brief Convert an array of IEEE half precision floats into floats
+
+	Expand an array of 16 bit IEEE 754 half precision floats, such as
+	those found in vertex and animation streams, into 32 bit floats.
+	The results are identical to calling UnpackHalfToFloat(Word16)
+	on each entry.
+
+	On x86 CPUs, the F16C instruction vcvtph2ps is used if present,
+	otherwise an SSE2 version is selected by CPUDispatch.
+
+	\param pOutput Pointer to the array of floats to receive the results
+	\param pInput Pointer to the array of half precision floats
+	\param uCount Number of entries to convert
+	\sa UnpackHalfToFloat(Word16) or PackFloatsToHalf(Word16 *,const float *,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::UnpackHalfToFloats(float *pOutput,const Word16 *pInput,WordPtr uCount)
+{
+	UnpackHalfToFloatsProc(pOutput,pInput,uCount);
+}
+
+/*! ************************************
+
+	\brief Convert an array of floats into IEEE half precision floats
+
+	Convert an array of 32 bit floats into 16 bit IEEE 754 half
+	precision floats using round to nearest even. The results are
+	identical to calling PackFloatToHalf(float) on each entry.
+
+	On x86 CPUs, the F16C instruction vcvtps2ph is used if present,
+	otherwise an SSE2 version is selected by CPUDispatch.
+
+	\param pOutput Pointer to the array to receive the half precision floats
+	\param pInput Pointer to the array of floats to convert
+	\param uCount Number of entries to convert
+	\sa PackFloatToHalf(float) or UnpackHalfToFloats(float *,const Word16 *,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::PackFloatsToHalf(Word16 *pOutput,const float *pInput,WordPtr uCount)
+{
+	PackFloatsToHalfProc(pOutput,pInput,uCount);
+}
@@ -24,6 +24,12 @@ extern float BURGER_API Unpack16ToFloat(Int16 iInput);
 extern Int16 BURGER_API PackFloatTo16(float fInput);
 extern float BURGER_API Unpack16ToFloat(Int16 iInput,Word32 uBaseExponent);
 extern Int16 BURGER_API PackFloatTo16(float fInput,Word32 uBaseExponent);
+extern void BURGER_API Unpack16ToFloats(float *pOutput,const Int16 *pInput,WordPtr uCount,Word32 uBaseExponent=111);
+extern void BURGER_API PackFloatsTo16(Int16 *pOutput,const float *pInput,WordPtr uCount,Word32 uBaseExponent=111);
+extern float BURGER_API UnpackHalfToFloat(Word16 uInput);
+extern Word16 BURGER_API PackFloatToHalf(float fInput);
+extern void BURGER_API UnpackHalfToFloats(float *pOutput,const Word16 *pInput,WordPtr uCount);
+extern void BURGER_API PackFloatsToHalf(Word16 *pOutput,const float *pInput,WordPtr uCount);
 }
 /* END */
 
@@ -19,6 +19,11 @@
 #include "brendian.h"
 #include "brmemoryfunctions.h"
 #include "brfixedpoint.h"
+#include "brcpudispatch.h"
+
+#if defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
 
 /*! ************************************
 
@@ -89,44 +94,38 @@ void BURGER_API Burger::SHA1Hasher_t::Init(void)
 	m_uByteCount = 0;
 }
 
-/*! ************************************
-
-	\brief Process a single 64 byte block of data
-
-	MD5 data is processed in 64 byte chunks. This function
-	will process 64 bytes on input and update the hash and checksum
+#if !defined(DOXYGEN)
 
-	\param pBlock Pointer to a buffer of 64 bytes of data to hash
-	\sa Process(const void *,WordPtr), Finalize(void) or Init(void)
+typedef void (BURGER_API *SHA1BlockProc)(Word8 *pHash,const Word8 *pBlock);
 
-***************************************/
+//
+// Process a block with integer math
+//
 
-void BURGER_API Burger::SHA1Hasher_t::Process(const Word8 *pBlock)
+static void BURGER_API SHA1BlockGeneric(Word8 *pHash,const Word8 *pBlock) BURGER_NOEXCEPT
 {
 	Word32 DataBlock[16];
 	WordPtr i = 0;
 	const Word32 *pBlock32 = static_cast<const Word32 *>(static_cast<const void *>(pBlock));
 	do {
-		DataBlock[i] = BigEndian::LoadAny(pBlock32+i);
+		DataBlock[i] = Burger::BigEndian::LoadAny(pBlock32+i);
 	} while (++i<16);
 
 	// Make a copy of the hash integers 
-	Word32 a = BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+0)));
-	Word32 b = BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+4)));
-	Word32 c = BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+8)));
-	Word32 d = BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+12)));
-	Word32 e = BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+16)));
+	Word32 a = Burger::BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(pHash+0)));
+	Word32 b = Burger::BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(pHash+4)));
+	Word32 c = Burger::BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(pHash+8)));
+	Word32 d = Burger::BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(pHash+12)));
+	Word32 e = Burger::BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(pHash+16)));
 
-#if !defined(DOXYGEN)
-#define blk(i) (DataBlock[i&15] = RotateLeft(DataBlock[(i+13)&15] ^ DataBlock[(i+8)&15] ^ DataBlock[(i+2)&15] ^ DataBlock[i&15],1))
+#define blk(i) (DataBlock[i&15] = Burger::RotateLeft(DataBlock[(i+13)&15] ^ DataBlock[(i+8)&15] ^ DataBlock[(i+2)&15] ^ DataBlock[i&15],1))
 
 	// (R0+R1), R2, R3, R4 are the different operations used in SHA1
-#define R0(v,w,x,y,z,i) z += RotateLeft(v,5); z+= 0x5a827999; z+= DataBlock[i]; z+= (((x^y)&w)^y); w=RotateLeft(w,30)
-#define R1(v,w,x,y,z,i) z += RotateLeft(v,5); z+= 0x5a827999; z+= blk(i); z+= (((x^y)&w)^y); w=RotateLeft(w,30)
-#define R2(v,w,x,y,z,i) z += RotateLeft(v,5); z+= 0x6ed9eba1; z+= blk(i); z+= (w^x^y); w=RotateLeft(w,30)
-#define R3(v,w,x,y,z,i) z += RotateLeft(v,5); z+= 0x8f1bbcdc; z+= blk(i); z+= (((w|x)&y)|(w&x)); w=RotateLeft(w,30)
-#define R4(v,w,x,y,z,i) z += RotateLeft(v,5); z+= 0xca62c1d6; z+= blk(i); z+= (w^x^y); w=RotateLeft(w,30)
-#endif
+#define R0(v,w,x,y,z,i) z += Burger::RotateLeft(v,5); z+= 0x5a827999; z+= DataBlock[i]; z+= (((x^y)&w)^y); w=Burger::RotateLeft(w,30)
+#define R1(v,w,x,y,z,i) z += Burger::RotateLeft(v,5); z+= 0x5a827999; z+= blk(i); z+= (((x^y)&w)^y); w=Burger::RotateLeft(w,30)
+#define R2(v,w,x,y,z,i) z += Burger::RotateLeft(v,5); z+= 0x6ed9eba1; z+= blk(i); z+= (w^x^y); w=Burger::RotateLeft(w,30)
+#define R3(v,w,x,y,z,i) z += Burger::RotateLeft(v,5); z+= 0x8f1bbcdc; z+= blk(i); z+= (((w|x)&y)|(w&x)); w=Burger::RotateLeft(w,30)
+#define R4(v,w,x,y,z,i) z += Burger::RotateLeft(v,5); z+= 0xca62c1d6; z+= blk(i); z+= (w^x^y); w=Burger::RotateLeft(w,30)
 
 	// 4 rounds of 20 operations each. Loop unrolled.
 	R0(a,b,c,d,e, 0);
@@ -217,14 +216,117 @@ void BURGER_API Burger::SHA1Hasher_t::Process(const Word8 *pBlock)
 	// Add in the adjusted hash (Store in big endian format)
 
 	{
-		BigEndian::Store(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+0)),BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+0)))+a);
-		BigEndian::Store(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+4)),BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+4)))+b);
-		BigEndian::Store(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+8)),BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+8)))+c);
-		BigEndian::Store(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+12)),BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+12)))+d);
-		BigEndian::Store(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+16)),BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash+16)))+e);
+		Burger::BigEndian::Store(static_cast<Word32 *>(static_cast<void *>(pHash+0)),Burger::BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(pHash+0)))+a);
+		Burger::BigEndian::Store(static_cast<Word32 *>(static_cast<void *>(pHash+4)),Burger::BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(pHash+4)))+b);
+		Burger::BigEndian::Store(static_cast<Word32 *>(static_cast<void *>(pHash+8)),Burger::BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(pHash+8)))+c);
+		Burger::BigEndian::Store(static_cast<Word32 *>(static_cast<void *>(pHash+12)),Burger::BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(pHash+12)))+d);
+		Burger::BigEndian::Store(static_cast<Word32 *>(static_cast<void *>(pHash+16)),Burger::BigEndian::Load(static_cast<Word32 *>(static_cast<void *>(pHash+16)))+e);
 	}
 }
 
+#if defined(BURGER_CPU_DISPATCH)
+
+//
+// Process a block with the SHA extension instructions
+//
+// The hash is kept as a big endian byte array, reversing all 16 bytes
+// of A-D converts to native endian and puts A in the highest lane,
+// which is the order sha1rnds4 expects.
+//
+// Each group of 4 rounds finishes the expansion of the message words
+// for a later group, using the 4 registers as a rolling window.
+//
+
+#define SHA1NI_GROUP(g,vE,vENext,vM0,vM1,vM2,vM3,uFunc) \
+	vE = _mm_sha1nexte_epu32(vE,vM0); \
+	vENext = vABCD; \
+	if ((g)>=3 && (g)<=18) { vM1 = _mm_sha1msg2_epu32(vM1,vM0); } \
+	vABCD = _mm_sha1rnds4_epu32(vABCD,vE,uFunc); \
+	if ((g)>=1 && (g)<=16) { vM3 = _mm_sha1msg1_epu32(vM3,vM0); } \
+	if ((g)>=2 && (g)<=17) { vM2 = _mm_xor_si128(vM2,vM0); }
+
+static BURGER_TARGET_SHA void BURGER_API SHA1BlockSHANI(Word8 *pHash,const Word8 *pBlock) BURGER_NOEXCEPT
+{
+	const __m128i vMask = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+
+	__m128i vABCD = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pHash)),vMask);
+	__m128i vE0 = _mm_set_epi32(static_cast<int>(Burger::BigEndian::LoadAny(reinterpret_cast<const Word32 *>(pHash+16))),0,0,0);
+	__m128i vABCDSave = vABCD;
+	__m128i vESave = vE0;
+
+	// Message words with W[0] in the highest lane
+	__m128i vM0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pBlock)),vMask);
+	__m128i vM1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pBlock+16)),vMask);
+	__m128i vM2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pBlock+32)),vMask);
+	__m128i vM3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pBlock+48)),vMask);
+	__m128i vE1;
+
+	// Rounds 0-3
+	vE0 = _mm_add_epi32(vE0,vM0);
+	vE1 = vABCD;
+	vABCD = _mm_sha1rnds4_epu32(vABCD,vE0,0);
+
+	// Rounds 4-79
+	SHA1NI_GROUP(1,vE1,vE0,vM1,vM2,vM3,vM0,0)
+	SHA1NI_GROUP(2,vE0,vE1,vM2,vM3,vM0,vM1,0)
+	SHA1NI_GROUP(3,vE1,vE0,vM3,vM0,vM1,vM2,0)
+	SHA1NI_GROUP(4,vE0,vE1,vM0,vM1,vM2,vM3,0)
+	SHA1NI_GROUP(5,vE1,vE0,vM1,vM2,vM3,vM0,1)
+	SHA1NI_GROUP(6,vE0,vE1,vM2,vM3,vM0,vM1,1)
+	SHA1NI_GROUP(7,vE1,vE0,vM3,vM0,vM1,vM2,1)
+	SHA1NI_GROUP(8,vE0,vE1,vM0,vM1,vM2,vM3,1)
+	SHA1NI_GROUP(9,vE1,vE0,vM1,vM2,vM3,vM0,1)
+	SHA1NI_GROUP(10,vE0,vE1,vM2,vM3,vM0,vM1,2)
+	SHA1NI_GROUP(11,vE1,vE0,vM3,vM0,vM1,vM2,2)
+	SHA1NI_GROUP(12,vE0,vE1,vM0,vM1,vM2,vM3,2)
+	SHA1NI_GROUP(13,vE1,vE0,vM1,vM2,vM3,vM0,2)
+	SHA1NI_GROUP(14,vE0,vE1,vM2,vM3,vM0,vM1,2)
+	SHA1NI_GROUP(15,vE1,vE0,vM3,vM0,vM1,vM2,3)
+	SHA1NI_GROUP(16,vE0,vE1,vM0,vM1,vM2,vM3,3)
+	SHA1NI_GROUP(17,vE1,vE0,vM1,vM2,vM3,vM0,3)
+	SHA1NI_GROUP(18,vE0,vE1,vM2,vM3,vM0,vM1,3)
+	SHA1NI_GROUP(19,vE1,vE0,vM3,vM0,vM1,vM2,3)
+
+	// Add in the previous hash
+	vE0 = _mm_sha1nexte_epu32(vE0,vESave);
+	vABCD = _mm_add_epi32(vABCD,vABCDSave);
+
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(pHash),_mm_shuffle_epi8(vABCD,vMask));
+	Burger::BigEndian::StoreAny(reinterpret_cast<Word32 *>(pHash+16),static_cast<Word32>(_mm_extract_epi32(vE0,3)));
+}
+
+static const Burger::CPUDispatch::Variant_t g_SHA1BlockVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(SHA1BlockSHANI),Burger::CPUDispatch::kSHA|Burger::CPUDispatch::kSSE41,"SHA-NI"},
+	{BURGER_CPU_DISPATCH_PROC(SHA1BlockGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_SHA1BlockDispatch,Burger::CPUDispatch::kFamilyHash,g_SHA1BlockVariants);
+
+#define SHA1BlockKernel g_SHA1BlockDispatch.Get<SHA1BlockProc>()
+#else
+#define SHA1BlockKernel SHA1BlockGeneric
+#endif
+#endif
+
+/*! ************************************
+
+	\brief Process a single 64 byte block of data
+
+	MD5 data is processed in 64 byte chunks. This function
+	will process 64 bytes on input and update the hash and checksum
+
+	On x86 CPUs with the SHA extensions, the block is processed with the
+	sha1rnds4 family of instructions. The choice is made by CPUDispatch.
+
+	\param pBlock Pointer to a buffer of 64 bytes of data to hash
+	\sa Process(const void *,WordPtr), Finalize(void) or Init(void)
+
+***************************************/
+
+void BURGER_API Burger::SHA1Hasher_t::Process(const Word8 *pBlock)
+{
+	SHA1BlockKernel(m_Hash.m_Hash,pBlock);
+}
+
 /*! ************************************
 
 	\brief Process an arbitrary number of input bytes
@@ -0,0 +1,461 @@
+/***************************************
+
+	SHA-256 hash manager
+
+	Implemented following the documentation found in
+	http://en.wikipedia.org/wiki/SHA-2
+	and http://tools.ietf.org/html/rfc6234
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brsha256.h"
+#include "brendian.h"
+#include "brmemoryfunctions.h"
+#include "brglobalmemorymanager.h"
+#include "brfixedpoint.h"
+#include "brfile.h"
+#include "brinputmemorystream.h"
+#include "brcpudispatch.h"
+
+#if defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
+
+/*! ************************************
+
+	\struct Burger::SHA256_t
+	\brief 32 byte array to contain a SHA-256 hash
+
+	Full documentation on this hash format can be found here
+	http://en.wikipedia.org/wiki/SHA-2
+
+	\sa Hash(SHA256_t *,const void *,WordPtr) and Burger::SHA256Hasher_t
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::SHA256Hasher_t
+	\brief Multi-pass SHA-256 hash generator
+
+	This structure is needed to perform a multi-pass SHA-256 hash
+	and contains cached data and a running checksum.
+	\code
+		Burger::SHA256Hasher_t Context;
+		// Initialize
+		Context.Init();
+		// Process data in passes
+		Context.Process(Buffer1,sizeof(Buffer1));
+		Context.Process(Buffer2,sizeof(Buffer2));
+		Context.Process(Buffer3,sizeof(Buffer3));
+		// Wrap up the processing
+		Context.Finalize();
+		// Return the resulting hash
+		MemoryCopy(pOutput,&Context.m_Hash,32);
+	\endcode
+
+	\sa Burger::SHA256_t or Hash(SHA256_t *,const void *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Initialize the SHA-256 hasher
+
+	Call this function before any hashing is performed
+
+	\sa Process(const void *,WordPtr) or Finalize(void)
+
+***************************************/
+
+void BURGER_API Burger::SHA256Hasher_t::Init(void)
+{
+	// Load magic initialization constants.
+
+	Word32 *pHash32 = static_cast<Word32 *>(static_cast<void *>(m_Hash.m_Hash));
+	BigEndian::Store(pHash32,0x6A09E667U);
+	BigEndian::Store(pHash32+1,0xBB67AE85U);
+	BigEndian::Store(pHash32+2,0x3C6EF372U);
+	BigEndian::Store(pHash32+3,0xA54FF53AU);
+	BigEndian::Store(pHash32+4,0x510E527FU);
+	BigEndian::Store(pHash32+5,0x9B05688CU);
+	BigEndian::Store(pHash32+6,0x1F83D9ABU);
+	BigEndian::Store(pHash32+7,0x5BE0CD19U);
+	m_uByteCount = 0;
+}
+
+#if !defined(DOXYGEN)
+
+// Round constants, the first 32 bits of the fractional parts
+// of the cube roots of the first 64 primes
+
+static const Word32 g_SHA256Constants[64] = {
+	0x428A2F98U,0x71374491U,0xB5C0FBCFU,0xE9B5DBA5U,0x3956C25BU,0x59F111F1U,0x923F82A4U,0xAB1C5ED5U,
+	0xD807AA98U,0x12835B01U,0x243185BEU,0x550C7DC3U,0x72BE5D74U,0x80DEB1FEU,0x9BDC06A7U,0xC19BF174U,
+	0xE49B69C1U,0xEFBE4786U,0x0FC19DC6U,0x240CA1CCU,0x2DE92C6FU,0x4A7484AAU,0x5CB0A9DCU,0x76F988DAU,
+	0x983E5152U,0xA831C66DU,0xB00327C8U,0xBF597FC7U,0xC6E00BF3U,0xD5A79147U,0x06CA6351U,0x14292967U,
+	0x27B70A85U,0x2E1B2138U,0x4D2C6DFCU,0x53380D13U,0x650A7354U,0x766A0ABBU,0x81C2C92EU,0x92722C85U,
+	0xA2BFE8A1U,0xA81A664BU,0xC24B8B70U,0xC76C51A3U,0xD192E819U,0xD6990624U,0xF40E3585U,0x106AA070U,
+	0x19A4C116U,0x1E376C08U,0x2748774CU,0x34B0BCB5U,0x391C0CB3U,0x4ED8AA4AU,0x5B9CCA4FU,0x682E6FF3U,
+	0x748F82EEU,0x78A5636FU,0x84C87814U,0x8CC70208U,0x90BEFFFAU,0xA4506CEBU,0xBEF9A3F7U,0xC67178F2U
+};
+
+typedef void (BURGER_API *SHA256BlockProc)(Word8 *pHash,const Word8 *pBlock);
+
+//
+// Process a block with integer math
+//
+
+static void BURGER_API SHA256BlockGeneric(Word8 *pHash,const Word8 *pBlock) BURGER_NOEXCEPT
+{
+	// Expand the message
+	Word32 W[64];
+	const Word32 *pBlock32 = static_cast<const Word32 *>(static_cast<const void *>(pBlock));
+	WordPtr i = 0;
+	do {
+		W[i] = Burger::BigEndian::LoadAny(pBlock32+i);
+	} while (++i<16);
+	do {
+		Word32 uS0 = Burger::RotateRight(W[i-15],7)^Burger::RotateRight(W[i-15],18)^(W[i-15]>>3U);
+		Word32 uS1 = Burger::RotateRight(W[i-2],17)^Burger::RotateRight(W[i-2],19)^(W[i-2]>>10U);
+		W[i] = W[i-16]+uS0+W[i-7]+uS1;
+	} while (++i<64);
+
+	// Make a copy of the hash integers
+	Word32 *pHash32 = static_cast<Word32 *>(static_cast<void *>(pHash));
+	Word32 a = Burger::BigEndian::Load(pHash32);
+	Word32 b = Burger::BigEndian::Load(pHash32+1);
+	Word32 c = Burger::BigEndian::Load(pHash32+2);
+	Word32 d = Burger::BigEndian::Load(pHash32+3);
+	Word32 e = Burger::BigEndian::Load(pHash32+4);
+	Word32 f = Burger::BigEndian::Load(pHash32+5);
+	Word32 g = Burger::BigEndian::Load(pHash32+6);
+	Word32 h = Burger::BigEndian::Load(pHash32+7);
+
+	// 64 rounds
+	i = 0;
+	do {
+		Word32 uS1 = Burger::RotateRight(e,6)^Burger::RotateRight(e,11)^Burger::RotateRight(e,25);
+		Word32 uTemp1 = h+uS1+((e&f)^((~e)&g))+g_SHA256Constants[i]+W[i];
+		Word32 uS0 = Burger::RotateRight(a,2)^Burger::RotateRight(a,13)^Burger::RotateRight(a,22);
+		Word32 uTemp2 = uS0+((a&b)^(a&c)^(b&c));
+		h = g;
+		g = f;
+		f = e;
+		e = d+uTemp1;
+		d = c;
+		c = b;
+		b = a;
+		a = uTemp1+uTemp2;
+	} while (++i<64);
+
+	// Add in the adjusted hash (Store in big endian format)
+	Burger::BigEndian::Store(pHash32,Burger::BigEndian::Load(pHash32)+a);
+	Burger::BigEndian::Store(pHash32+1,Burger::BigEndian::Load(pHash32+1)+b);
+	Burger::BigEndian::Store(pHash32+2,Burger::BigEndian::Load(pHash32+2)+c);
+	Burger::BigEndian::Store(pHash32+3,Burger::BigEndian::Load(pHash32+3)+d);
+	Burger::BigEndian::Store(pHash32+4,Burger::BigEndian::Load(pHash32+4)+e);
+	Burger::BigEndian::Store(pHash32+5,Burger::BigEndian::Load(pHash32+5)+f);
+	Burger::BigEndian::Store(pHash32+6,Burger::BigEndian::Load(pHash32+6)+g);
+	Burger::BigEndian::Store(pHash32+7,Burger::BigEndian::Load(pHash32+7)+h);
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+//
+// Process a block with the SHA extension instructions
+//
+// sha256rnds2 keeps the state as ABEF and CDGH and performs two
+// rounds at a time, so each group of 4 rounds is two instructions.
+// Each group also finishes the expansion of the message words for
+// a later group, using the 4 registers as a rolling window.
+//
+
+#define SHA256NI_GROUP(g,vM0,vM1,vM3) \
+	vMsg = _mm_add_epi32(vM0,_mm_loadu_si128(reinterpret_cast<const __m128i *>(g_SHA256Constants+((g)*4)))); \
+	vState1 = _mm_sha256rnds2_epu32(vState1,vState0,vMsg); \
+	if ((g)>=3 && (g)<=14) { \
+		vM1 = _mm_sha256msg2_epu32(_mm_add_epi32(vM1,_mm_alignr_epi8(vM0,vM3,4)),vM0); \
+	} \
+	vMsg = _mm_shuffle_epi32(vMsg,0x0E); \
+	vState0 = _mm_sha256rnds2_epu32(vState0,vState1,vMsg); \
+	if ((g)>=1 && (g)<=12) { \
+		vM3 = _mm_sha256msg1_epu32(vM3,vM0); \
+	}
+
+static BURGER_TARGET_SHA void BURGER_API SHA256BlockSHANI(Word8 *pHash,const Word8 *pBlock) BURGER_NOEXCEPT
+{
+	// Swap the endian of each 32 bit word
+	const __m128i vMask = _mm_set_epi8(12,13,14,15,8,9,10,11,4,5,6,7,0,1,2,3);
+
+	// Convert ABCD and EFGH into ABEF and CDGH
+	__m128i vTemp = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pHash)),vMask);
+	__m128i vState1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pHash+16)),vMask);
+	vTemp = _mm_shuffle_epi32(vTemp,0xB1);
+	vState1 = _mm_shuffle_epi32(vState1,0x1B);
+	__m128i vState0 = _mm_alignr_epi8(vTemp,vState1,8);
+	vState1 = _mm_blend_epi16(vState1,vTemp,0xF0);
+	__m128i vSave0 = vState0;
+	__m128i vSave1 = vState1;
+
+	__m128i vM0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pBlock)),vMask);
+	__m128i vM1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pBlock+16)),vMask);
+	__m128i vM2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pBlock+32)),vMask);
+	__m128i vM3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pBlock+48)),vMask);
+	__m128i vMsg;
+
+	SHA256NI_GROUP(0,vM0,vM1,vM3)
+	SHA256NI_GROUP(1,vM1,vM2,vM0)
+	SHA256NI_GROUP(2,vM2,vM3,vM1)
+	SHA256NI_GROUP(3,vM3,vM0,vM2)
+	SHA256NI_GROUP(4,vM0,vM1,vM3)
+	SHA256NI_GROUP(5,vM1,vM2,vM0)
+	SHA256NI_GROUP(6,vM2,vM3,vM1)
+	SHA256NI_GROUP(7,vM3,vM0,vM2)
+	SHA256NI_GROUP(8,vM0,vM1,vM3)
+	SHA256NI_GROUP(9,vM1,vM2,vM0)
+	SHA256NI_GROUP(10,vM2,vM3,vM1)
+	SHA256NI_GROUP(11,vM3,vM0,vM2)
+	SHA256NI_GROUP(12,vM0,vM1,vM3)
+	SHA256NI_GROUP(13,vM1,vM2,vM0)
+	SHA256NI_GROUP(14,vM2,vM3,vM1)
+	SHA256NI_GROUP(15,vM3,vM0,vM2)
+
+	// Add in the previous hash
+	vState0 = _mm_add_epi32(vState0,vSave0);
+	vState1 = _mm_add_epi32(vState1,vSave1);
+
+	// Convert ABEF and CDGH back into ABCD and EFGH
+	vTemp = _mm_shuffle_epi32(vState0,0x1B);
+	vState1 = _mm_shuffle_epi32(vState1,0xB1);
+	vState0 = _mm_blend_epi16(vTemp,vState1,0xF0);
+	vState1 = _mm_alignr_epi8(vState1,vTemp,8);
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(pHash),_mm_shuffle_epi8(vState0,vMask));
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(pHash+16),_mm_shuffle_epi8(vState1,vMask));
+}
+
+static const Burger::CPUDispatch::Variant_t g_SHA256BlockVariants[] = {
+	{BURGER_CPU_DISPATCH_PROC(SHA256BlockSHANI),Burger::CPUDispatch::kSHA|Burger::CPUDispatch::kSSE41,"SHA-NI"},
+	{BURGER_CPU_DISPATCH_PROC(SHA256BlockGeneric),0,"Generic"}
+};
+static BURGER_CPU_DISPATCH_DEFINE(g_SHA256BlockDispatch,Burger::CPUDispatch::kFamilyHash,g_SHA256BlockVariants);
+
+#define SHA256BlockKernel g_SHA256BlockDispatch.Get<SHA256BlockProc>()
+#else
+#define SHA256BlockKernel SHA256BlockGeneric
+#endif
+
+// Size of the reads when hashing a file
+static const WordPtr g_uFileChunkSize = 0x100000;
+
+#endif
+
+/*! ************************************
+
+	\brief Process a single 64 byte block of data
+
+	SHA-256 data is processed in 64 byte chunks. This function
+	will process 64 bytes on input and update the hash and checksum
+
+	On x86 CPUs with the SHA extensions, the block is processed with the
+	sha256rnds2 family of instructions. The choice is made by CPUDispatch.
+
+	\param pBlock Pointer to a buffer of 64 bytes of data to hash
+	\sa Process(const void *,WordPtr), Finalize(void) or Init(void)
+
+***************************************/
+
+void BURGER_API Burger::SHA256Hasher_t::Process(const Word8 *pBlock)
+{
+	SHA256BlockKernel(m_Hash.m_Hash,pBlock);
+}
+
+/*! ************************************
+
+	\brief Process an arbitrary number of input bytes
+
+	Process input data into the hash. If data chunks are not
+	a multiple of 64 bytes, the excess will be cached and
+	a future call will continue the hashing where it left
+	off.
+
+	\param pInput Pointer to a buffer of data to hash
+	\param uLength Number of bytes to hash
+	\sa Process(const Word8 *), Finalize(void)
+
+***************************************/
+
+void BURGER_API Burger::SHA256Hasher_t::Process(const void *pInput,WordPtr uLength)
+{
+	// Compute number of bytes mod 64
+	WordPtr index = static_cast<WordPtr>(m_uByteCount) & 0x3FU;
+
+	// Update number of bits (Perform a 64 bit add)
+	m_uByteCount += uLength;
+
+	WordPtr i = 64 - index;
+
+	// Transform as many times as possible.
+
+	if (uLength >= i) {		// Should I copy or pack?
+
+		MemoryCopy(&m_CacheBuffer[index],pInput,i);
+		Process(m_CacheBuffer);
+
+		// Perform the checksum directly on the memory buffers
+
+		if ((i+63)<uLength) {
+			SHA256BlockProc pKernel = SHA256BlockKernel;
+			do {
+				pKernel(m_Hash.m_Hash,static_cast<const Word8 *>(pInput)+i);
+				i += 64;
+			} while ((i+63) < uLength);
+		}
+		index = 0;
+	} else {
+		i = 0;
+	}
+
+	// Buffer remaining input
+	MemoryCopy(&m_CacheBuffer[index],static_cast<const Word8 *>(pInput)+i,uLength-i);
+}
+
+/*! ************************************
+
+	\brief Finalize the hashing
+
+	When multi-pass hashing is performed, this call is necessary to
+	finalize the hash so that the generated checksum can
+	be applied into the hash
+
+	\sa Init(void), Process(const void *,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::SHA256Hasher_t::Finalize(void)
+{
+	Word8 Padding[64];		// Pad array, first byte is 0x80, rest 0
+	Padding[0] = 0x80;
+	MemoryClear(&Padding[1],63);
+
+	// Save number of bits
+
+	Word64 uBitCountBE = BigEndian::Load(m_uByteCount<<3);
+
+	// Pad out to 56 mod 64.
+	// Convert to 1-64
+	WordPtr uPadLen = ((55-static_cast<WordPtr>(m_uByteCount))&0x3f)+1;
+	Process(Padding,uPadLen);
+
+	// Append length (before padding)
+	Process(&uBitCountBE,8);
+}
+
+/*! ************************************
+
+	\brief Quickly create a SHA-256 key
+
+	Given a buffer of data, generate the SHA-256 hash key
+
+	\param pOutput Pointer to an uninitialized SHA256_t structure
+	\param pInput Pointer to a buffer of data to hash
+	\param uLength Number of bytes to hash
+
+	\sa Burger::SHA256Hasher_t
+
+***************************************/
+
+void BURGER_API Burger::Hash(SHA256_t *pOutput,const void *pInput,WordPtr uLength)
+{
+	SHA256Hasher_t Context;
+	// Initialize
+	Context.Init();
+	// Process all of the data
+	Context.Process(pInput,uLength);
+	// Wrap up the processing
+	Context.Finalize();
+	// Return the resulting hash
+	MemoryCopy(pOutput,&Context.m_Hash,32);
+}
+
+/*! ************************************
+
+	\brief Create a SHA-256 key from the contents of a file
+
+	Hash the file from the current mark to the end of the file. The
+	file is read in one megabyte chunks, so files of any size can
+	be hashed without loading them into memory.
+
+	\param pOutput Pointer to an uninitialized SHA256_t structure
+	\param pInput Pointer to an open File
+
+	\return Zero if successful, kErrorOutOfMemory if the read buffer
+		couldn't be allocated or kErrorReadFailure if the file couldn't
+		be read. pOutput is not valid on error.
+
+	\sa Hash(SHA256_t *,InputMemoryStream *) or Burger::SHA256Hasher_t
+
+***************************************/
+
+Burger::eError BURGER_API Burger::Hash(SHA256_t *pOutput,File *pInput)
+{
+	WordPtr uLength = pInput->GetSize();
+	WordPtr uMark = pInput->GetMark();
+	uLength = (uLength>uMark) ? uLength-uMark : 0;
+
+	SHA256Hasher_t Context;
+	Context.Init();
+	eError uResult = kErrorNone;
+	if (uLength) {
+		WordPtr uMaxChunk = (uLength<g_uFileChunkSize) ? uLength : g_uFileChunkSize;
+		Word8 *pBuffer = static_cast<Word8 *>(Alloc(uMaxChunk));
+		if (!pBuffer) {
+			return kErrorOutOfMemory;
+		}
+		do {
+			WordPtr uChunk = uLength;	// Base chunk
+			if (uChunk>uMaxChunk) {
+				uChunk = uMaxChunk;		// Only hash the chunk
+			}
+			if (pInput->Read(pBuffer,uChunk)!=uChunk) {
+				uResult = kErrorReadFailure;
+				break;
+			}
+			Context.Process(pBuffer,uChunk);
+			uLength -= uChunk;
+		} while (uLength);			// Any data left?
+		Free(pBuffer);
+	}
+	Context.Finalize();
+	MemoryCopy(pOutput,&Context.m_Hash,32);
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Create a SHA-256 key from the rest of a memory stream
+
+	Hash the data from the current position to the end of the stream
+	and move the position to the end. The data is hashed in place
+	without being copied.
+
+	\param pOutput Pointer to an uninitialized SHA256_t structure
+	\param pInput Pointer to an InputMemoryStream
+
+	\sa Hash(SHA256_t *,File *) or Burger::SHA256Hasher_t
+
+***************************************/
+
+void BURGER_API Burger::Hash(SHA256_t *pOutput,InputMemoryStream *pInput)
+{
+	WordPtr uLength = pInput->BytesRemaining();
+	Hash(pOutput,pInput->GetPtr(),uLength);
+	pInput->SkipForward(uLength);
+}
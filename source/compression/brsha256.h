@@ -0,0 +1,57 @@
+/***************************************
+
+	SHA-256 hash manager
+
+	Implemented following the documentation found in
+	http://en.wikipedia.org/wiki/SHA-2
+	and http://tools.ietf.org/html/rfc6234
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRSHA256_H__
+#define __BRSHA256_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRERROR_H__
+#include "brerror.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class File;
+class InputMemoryStream;
+
+struct SHA256_t {
+	Word8 m_Hash[32];	///< 256 bit hash value in RFC 6234 SHA-256 format
+};
+
+struct SHA256Hasher_t {
+	Word64 m_uByteCount;		///< Number of bytes processed (64 bit value)
+	SHA256_t m_Hash;			///< Current 256 bit value
+	Word8 m_CacheBuffer[64];	///< input buffer for processing
+
+	void BURGER_API Init(void);
+	void BURGER_API Process(const Word8 *pBlock);
+	void BURGER_API Process(const void *pInput,WordPtr uLength);
+	void BURGER_API Finalize(void);
+};
+
+extern void BURGER_API Hash(SHA256_t *pOutput,const void *pInput,WordPtr uLength);
+extern eError BURGER_API Hash(SHA256_t *pOutput,File *pInput);
+extern void BURGER_API Hash(SHA256_t *pOutput,InputMemoryStream *pInput);
+
+}
+/* END */
+
+
+#endif
@@ -434,8 +434,9 @@ Word BURGER_API Burger::FileBMP::Load(Image *pOutput,InputMemoryStream *pInput)
 				do {
 					Word j = uWidth;		// Pixel count
 					Word8 *pDest = pData;
+					pInput->GetShortArray(reinterpret_cast<Word16 *>(pDest),j);
 					do {
-						reinterpret_cast<Word16 *>(pDest)[0] = static_cast<Word16>(pInput->GetShort()&0x7FFF);
+						reinterpret_cast<Word16 *>(pDest)[0] = static_cast<Word16>(reinterpret_cast<Word16 *>(pDest)[0]&0x7FFFU);
 						pDest=pDest+2;		// Next pixel
 					} while (--j);			// Count down
 					pInput->SkipForward(uBMPPadding);	// Handle padding
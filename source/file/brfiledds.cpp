@@ -44,6 +44,31 @@
 #define DDS_DXT3 0x33545844		// 'DXT3'
 #define DDS_DXT4 0x34545844		// 'DXT4'
 #define DDS_DXT5 0x35545844		// 'DXT5'
+#define DDS_ATI1 0x31495441		// 'ATI1'
+#define DDS_BC4U 0x55344342		// 'BC4U'
+#define DDS_ATI2 0x32495441		// 'ATI2'
+#define DDS_BC5U 0x55354342		// 'BC5U'
+#define DDS_DX10 0x30315844		// 'DX10' followed by a DDSHeaderDX10
+
+// DXGI_FORMAT values found in a DDSHeaderDX10
+#define DXGI_FORMAT_BC1_TYPELESS 70
+#define DXGI_FORMAT_BC1_UNORM 71
+#define DXGI_FORMAT_BC1_UNORM_SRGB 72
+#define DXGI_FORMAT_BC2_TYPELESS 73
+#define DXGI_FORMAT_BC2_UNORM 74
+#define DXGI_FORMAT_BC2_UNORM_SRGB 75
+#define DXGI_FORMAT_BC3_TYPELESS 76
+#define DXGI_FORMAT_BC3_UNORM 77
+#define DXGI_FORMAT_BC3_UNORM_SRGB 78
+#define DXGI_FORMAT_BC4_TYPELESS 79
+#define DXGI_FORMAT_BC4_UNORM 80
+#define DXGI_FORMAT_BC5_TYPELESS 82
+#define DXGI_FORMAT_BC5_UNORM 83
+#define DXGI_FORMAT_BC7_TYPELESS 97
+#define DXGI_FORMAT_BC7_UNORM 98
+#define DXGI_FORMAT_BC7_UNORM_SRGB 99
+
+#define DDS_DIMENSION_TEXTURE2D 3		// D3D10_RESOURCE_DIMENSION_TEXTURE2D
 
 struct DDS_PIXELFORMAT {
 	Word32 m_uSize;
@@ -78,6 +103,14 @@ struct DDSHeader {			// This is the header for a DDS file
 	Word32 m_uReserved2[3];
 };
 
+struct DDSHeaderDX10 {		// Follows DDSHeader if the four CC is 'DX10' (20 bytes)
+	Word32 m_uDXGIFormat;	// DXGI_FORMAT of the pixels
+	Word32 m_uResourceDimension;	// 3 for a 2D texture
+	Word32 m_uMiscFlag;		// Cube map flag
+	Word32 m_uArraySize;	// Number of textures in the array
+	Word32 m_uMiscFlags2;	// Alpha mode
+};
+
 #endif
 
 /*! ************************************
@@ -102,8 +135,10 @@ Burger::FileDDS::FileDDS()
 
 	Read in a DDS file and set the extra variables
 
-	Will parse 16, 24, 32 bit uncompressed and DXT compressed DDS files only.
-	Other formats are not supported
+	Will parse 16, 24, 32 bit uncompressed and DXT, BC4, BC5 and BC7
+	compressed DDS files only. BC4 and BC5 are found with the 'ATI1', 'BC4U',
+	'ATI2' and 'BC5U' codes and BC7 requires the extended 'DX10' header.
+	Other formats, including the signed BC4 and BC5 variants, are not supported
 
 	\note A descriptive error message is passed to Debug::Warning()
 
@@ -142,10 +177,7 @@ Burger::Image * Burger::FileDDS::Load(InputMemoryStream *pInput)
 			/* Word32 uPitchOrLinearSize = */ pInput->GetWord32();
 			/* Word32 uVolumeDepth = */ pInput->GetWord32();		// Z for 3D textures
 			uMipMapCount = pInput->GetWord32();
-			WordPtr i = 0;
-			do {
-				m_uReserved[i] = pInput->GetWord32();
-			} while (++i<BURGER_ARRAYSIZE(m_uReserved));
+			pInput->GetWord32Array(m_uReserved,BURGER_ARRAYSIZE(m_uReserved));
 			
 			// Read in the Pixel format
 			Word32 uPixelFormatSize = pInput->GetWord32();
@@ -241,6 +273,64 @@ Burger::Image * Burger::FileDDS::Load(InputMemoryStream *pInput)
 					case DDS_DXT5:
 						eType = Image::PIXELTYPEDXT5;
 						break;
+					case DDS_ATI1:
+					case DDS_BC4U:
+						eType = Image::PIXELTYPEBC4;
+						break;
+					case DDS_ATI2:
+					case DDS_BC5U:
+						eType = Image::PIXELTYPEBC5;
+						break;
+
+					// The format is in the extended header
+					case DDS_DX10:
+						if (pInput->BytesRemaining()<20) {
+							pBadNews = "Insufficient data for DX10 header.";
+						} else {
+							Word32 uDXGIFormat = pInput->GetWord32();
+							/* Word32 uResourceDimension = */ pInput->GetWord32();
+							/* Word32 uMiscFlag = */ pInput->GetWord32();
+							Word32 uArraySize = pInput->GetWord32();
+							/* Word32 uMiscFlags2 = */ pInput->GetWord32();
+							if (uArraySize>1) {
+								pBadNews = "Texture arrays are not supported.";
+							} else {
+								switch (uDXGIFormat) {
+								default:
+									pBadNews = "Unsupported DXGI format.";
+									break;
+								case DXGI_FORMAT_BC1_TYPELESS:
+								case DXGI_FORMAT_BC1_UNORM:
+								case DXGI_FORMAT_BC1_UNORM_SRGB:
+									eType = Image::PIXELTYPEDXT1;
+									break;
+								case DXGI_FORMAT_BC2_TYPELESS:
+								case DXGI_FORMAT_BC2_UNORM:
+								case DXGI_FORMAT_BC2_UNORM_SRGB:
+									eType = Image::PIXELTYPEDXT3;
+									break;
+								case DXGI_FORMAT_BC3_TYPELESS:
+								case DXGI_FORMAT_BC3_UNORM:
+								case DXGI_FORMAT_BC3_UNORM_SRGB:
+									eType = Image::PIXELTYPEDXT5;
+									break;
+								case DXGI_FORMAT_BC4_TYPELESS:
+								case DXGI_FORMAT_BC4_UNORM:
+									eType = Image::PIXELTYPEBC4;
+									break;
+								case DXGI_FORMAT_BC5_TYPELESS:
+								case DXGI_FORMAT_BC5_UNORM:
+									eType = Image::PIXELTYPEBC5;
+									break;
+								case DXGI_FORMAT_BC7_TYPELESS:
+								case DXGI_FORMAT_BC7_UNORM:
+								case DXGI_FORMAT_BC7_UNORM_SRGB:
+									eType = Image::PIXELTYPEBC7;
+									break;
+								}
+							}
+						}
+						break;
 					}
 				} else {
 					pBadNews = "Unknown pixel format.";
@@ -258,17 +348,16 @@ Burger::Image * Burger::FileDDS::Load(InputMemoryStream *pInput)
 				// Copy in one shot!
 				pInput->Get(pDest,uLength);
 			} else if (uDepth == 16) {			// 16 bit
-				Word16 uMask;
+				// Read all the pixels in one pass
+				uLength >>= 1;
+				pInput->GetShortArray(reinterpret_cast<Word16 *>(pDest),uLength);
 				if (eType==Image::PIXELTYPE555) {
-					uMask = 0x7FFF;
-				} else {
-					uMask = 0xFFFFU;
+					// Remove the alpha bit
+					do {
+						reinterpret_cast<Word16 *>(pDest)[0] = static_cast<Word16>(reinterpret_cast<Word16 *>(pDest)[0]&0x7FFFU);
+						pDest=pDest+2;
+					} while (--uLength);		// All done?
 				}
-				do {
-					reinterpret_cast<Word16 *>(pDest)[0] = static_cast<Word16>(pInput->GetShort()&uMask);	// Save pixel
-					pDest=pDest+2;
-					uLength-=2;
-				} while (uLength);		// All done?
 			} else if (eType==Image::PIXELTYPE888) {
 				do {
 					pDest[2] = pInput->GetByte();	// Blue
@@ -290,7 +379,7 @@ Burger::Image * Burger::FileDDS::Load(InputMemoryStream *pInput)
 					uLength -= 4;
 				} while (uLength);				// All done?
 			} else {
-				// DXT1-5 just copies down
+				// DXT1-5 and BC4-7 just copies down
 				pInput->Get(pDest,uLength);
 			}
 		}
@@ -310,7 +399,8 @@ Burger::Image * Burger::FileDDS::Load(InputMemoryStream *pInput)
 	\brief Write an Image structure out as a DDS file image
 
 	Given an image in true color and DXT compressed formats, write it out as a DDS
-	file.
+	file. BC4 and BC5 are written with the 'ATI1' and 'ATI2' codes that
+	older tools understand and BC7 is written with a 'DX10' extended header.
 
 	\param pOutput Pointer to the output stream to store the file image
 	\param pImage Pointer to a valid Image structure containing the image data
@@ -406,6 +496,18 @@ Word Burger::FileDDS::Save(OutputMemoryStream *pOutput,const Image *pImage)
 		uFourCC = DDS_DXT5;
 		uPixelFlags = DDS_FOURCC;
 		break;
+	case Image::PIXELTYPEBC4:
+		uFourCC = DDS_ATI1;
+		uPixelFlags = DDS_FOURCC;
+		break;
+	case Image::PIXELTYPEBC5:
+		uFourCC = DDS_ATI2;
+		uPixelFlags = DDS_FOURCC;
+		break;
+	case Image::PIXELTYPEBC7:
+		uFourCC = DDS_DX10;
+		uPixelFlags = DDS_FOURCC;
+		break;
 	default:
 		return 10;
 	}
@@ -414,8 +516,8 @@ Word Burger::FileDDS::Save(OutputMemoryStream *pOutput,const Image *pImage)
 	pOutput->Append(static_cast<Word32>(DDS_MAGIC));	// DDS ID
 	pOutput->Append(static_cast<Word32>(124));			// Size of the structure
 	pOutput->Append(static_cast<Word32>(DDS_HEADER_FLAGS_TEXTURE));	// Texture
+	pOutput->Append(uHeight);							// Height comes first
 	pOutput->Append(uWidth);
-	pOutput->Append(uHeight);
 	pOutput->Append(static_cast<Word32>(0));			// PitchOrLinearSize
 	pOutput->Append(static_cast<Word32>(0));			// Z Depth
 	pOutput->Append(static_cast<Word32>(0));			// Mip Map count
@@ -440,6 +542,15 @@ Word Burger::FileDDS::Save(OutputMemoryStream *pOutput,const Image *pImage)
 	pOutput->Append(static_cast<Word32>(0));			// Reserved
 	pOutput->Append(static_cast<Word32>(0));			// Reserved
 
+	// BC7 has no four CC code of its own
+	if (uFourCC==DDS_DX10) {
+		pOutput->Append(static_cast<Word32>(DXGI_FORMAT_BC7_UNORM));	// DXGI format
+		pOutput->Append(static_cast<Word32>(DDS_DIMENSION_TEXTURE2D));	// Resource dimension
+		pOutput->Append(static_cast<Word32>(0));			// Misc flags
+		pOutput->Append(static_cast<Word32>(1));			// Array size
+		pOutput->Append(static_cast<Word32>(0));			// Alpha mode
+	}
+
 	if (uWidth && uHeight) {
 		const Word8 *pData = pImage->GetImage();
 		WordPtr uStride = pImage->GetStride();
@@ -510,6 +621,9 @@ Word Burger::FileDDS::Save(OutputMemoryStream *pOutput,const Image *pImage)
 		case Image::PIXELTYPEDXT3:
 		case Image::PIXELTYPEDXT4:
 		case Image::PIXELTYPEDXT5:
+		case Image::PIXELTYPEBC4:
+		case Image::PIXELTYPEBC5:
+		case Image::PIXELTYPEBC7:
 			{
 				uHeight = (uHeight+3)>>2;
 				WordPtr uLine = Image::GetSuggestedStride(uWidth,eType);
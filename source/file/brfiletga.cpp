@@ -458,8 +458,9 @@ Word BURGER_API Burger::FileTGA::Load(Image *pOutput,InputMemoryStream *pInput)
 
 				if (uBitDepth == 15) {				// 16 bit
 					if (uImageType == TGA_RGB) {	// Unpacked?
+						pInput->GetShortArray(reinterpret_cast<Word16 *>(pDest),uLength);
 						do {
-							reinterpret_cast<Word16 *>(pDest)[0] = static_cast<Word16>(pInput->GetShort()&0x7FFF);	// Save pixel
+							reinterpret_cast<Word16 *>(pDest)[0] = static_cast<Word16>(reinterpret_cast<Word16 *>(pDest)[0]&0x7FFFU);	// Remove the alpha bit
 							pDest=pDest+2;
 						} while (--uLength);		// All done?
 					} else {
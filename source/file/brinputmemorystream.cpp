@@ -935,6 +935,240 @@ WordPtr BURGER_API Burger::InputMemoryStream::Get(void *pOutput,WordPtr uOutputS
 	return uResult;
 }
 
+#if !defined(DOXYGEN)
+// Convert directly from the stream if the data is aligned, otherwise copy
+// first and then convert in place since not all CPUs can perform unaligned
+// reads. Entries past the end of the stream are zeroed to match the single
+// element getters.
+template<class E,typename T>
+static BURGER_INLINE void CopyArray(T *pOutput,const T *pInput,WordPtr uCount,WordPtr uRequested) BURGER_NOEXCEPT
+{
+	if (!(reinterpret_cast<WordPtr>(pInput)&(sizeof(T)-1))) {
+		E::ConvertArray(pOutput,pInput,uCount);
+	} else {
+		Burger::MemoryCopy(pOutput,pInput,uCount*sizeof(T));
+		E::FixupArray(pOutput,uCount);
+	}
+	if (uCount<uRequested) {
+		Burger::MemoryClear(pOutput+uCount,(uRequested-uCount)*sizeof(T));
+	}
+}
+#endif
+
+/*! ************************************
+
+	\brief Reserve an array of elements from the input stream
+
+	Clamp the requested number of elements to the number of whole elements
+	remaining in the stream and skip past them. If the stream didn't have
+	enough data for the entire request, the stream is marked as empty, the
+	same way the single element getters behave.
+
+	\param pCount Pointer to the number of elements requested, updated with the number available
+	\param uElementSize Size in bytes of each element
+	\return Pointer to the first element in the stream
+
+***************************************/
+
+const Word8 * BURGER_API Burger::InputMemoryStream::GetArrayPtr(WordPtr *pCount,WordPtr uElementSize) BURGER_NOEXCEPT
+{
+	const Word8 *pWork = m_pWork;
+	WordPtr uAvailable = static_cast<WordPtr>(m_pEndOfBuffer-pWork)/uElementSize;
+	WordPtr uCount = pCount[0];
+	if (uAvailable<uCount) {
+		uCount = uAvailable;
+		pCount[0] = uCount;
+		m_pWork = m_pEndOfBuffer;
+	} else {
+		m_pWork = pWork+(uCount*uElementSize);
+	}
+	return pWork;
+}
+
+/*! ************************************
+
+	\brief Read an array of 16 bit little endian integers from the data stream
+
+	The data is copied and converted to native endian using
+	LittleEndian::ConvertArray(), which is much faster than calling
+	GetShort(void) for each entry.
+
+	\param pOutput Pointer to the array to receive the data
+	\param uCount Number of entries to read
+	\return The number of entries read, less than uCount if the stream ran out of data. Unread entries are set to zero.
+	\sa GetShort(void)
+
+***************************************/
+
+WordPtr BURGER_API Burger::InputMemoryStream::GetShortArray(Word16 *pOutput,WordPtr uCount) BURGER_NOEXCEPT
+{
+	WordPtr uRequested = uCount;
+	const Word16 *pInput = reinterpret_cast<const Word16 *>(GetArrayPtr(&uCount,sizeof(Word16)));
+	CopyArray<LittleEndian>(pOutput,pInput,uCount,uRequested);
+	return uCount;
+}
+
+/*! ************************************
+
+	\brief Read an array of 16 bit big endian integers from the data stream
+
+	The data is copied and converted to native endian using
+	BigEndian::ConvertArray(), which is much faster than calling
+	GetBigShort(void) for each entry.
+
+	\param pOutput Pointer to the array to receive the data
+	\param uCount Number of entries to read
+	\return The number of entries read, less than uCount if the stream ran out of data. Unread entries are set to zero.
+	\sa GetBigShort(void)
+
+***************************************/
+
+WordPtr BURGER_API Burger::InputMemoryStream::GetBigShortArray(Word16 *pOutput,WordPtr uCount) BURGER_NOEXCEPT
+{
+	WordPtr uRequested = uCount;
+	const Word16 *pInput = reinterpret_cast<const Word16 *>(GetArrayPtr(&uCount,sizeof(Word16)));
+	CopyArray<BigEndian>(pOutput,pInput,uCount,uRequested);
+	return uCount;
+}
+
+/*! ************************************
+
+	\brief Read an array of 32 bit little endian integers from the data stream
+
+	The data is copied and converted to native endian using
+	LittleEndian::ConvertArray(), which is much faster than calling
+	GetWord32(void) for each entry.
+
+	\param pOutput Pointer to the array to receive the data
+	\param uCount Number of entries to read
+	\return The number of entries read, less than uCount if the stream ran out of data. Unread entries are set to zero.
+	\sa GetWord32(void)
+
+***************************************/
+
+WordPtr BURGER_API Burger::InputMemoryStream::GetWord32Array(Word32 *pOutput,WordPtr uCount) BURGER_NOEXCEPT
+{
+	WordPtr uRequested = uCount;
+	const Word32 *pInput = reinterpret_cast<const Word32 *>(GetArrayPtr(&uCount,sizeof(Word32)));
+	CopyArray<LittleEndian>(pOutput,pInput,uCount,uRequested);
+	return uCount;
+}
+
+/*! ************************************
+
+	\brief Read an array of 32 bit big endian integers from the data stream
+
+	The data is copied and converted to native endian using
+	BigEndian::ConvertArray(), which is much faster than calling
+	GetBigWord32(void) for each entry.
+
+	\param pOutput Pointer to the array to receive the data
+	\param uCount Number of entries to read
+	\return The number of entries read, less than uCount if the stream ran out of data. Unread entries are set to zero.
+	\sa GetBigWord32(void)
+
+***************************************/
+
+WordPtr BURGER_API Burger::InputMemoryStream::GetBigWord32Array(Word32 *pOutput,WordPtr uCount) BURGER_NOEXCEPT
+{
+	WordPtr uRequested = uCount;
+	const Word32 *pInput = reinterpret_cast<const Word32 *>(GetArrayPtr(&uCount,sizeof(Word32)));
+	CopyArray<BigEndian>(pOutput,pInput,uCount,uRequested);
+	return uCount;
+}
+
+/*! ************************************
+
+	\brief Read an array of 64 bit little endian integers from the data stream
+
+	The data is copied and converted to native endian using
+	LittleEndian::ConvertArray(), which is much faster than calling
+	GetWord64(void) for each entry.
+
+	\param pOutput Pointer to the array to receive the data
+	\param uCount Number of entries to read
+	\return The number of entries read, less than uCount if the stream ran out of data. Unread entries are set to zero.
+	\sa GetWord64(void)
+
+***************************************/
+
+WordPtr BURGER_API Burger::InputMemoryStream::GetWord64Array(Word64 *pOutput,WordPtr uCount) BURGER_NOEXCEPT
+{
+	WordPtr uRequested = uCount;
+	const Word64 *pInput = reinterpret_cast<const Word64 *>(GetArrayPtr(&uCount,sizeof(Word64)));
+	CopyArray<LittleEndian>(pOutput,pInput,uCount,uRequested);
+	return uCount;
+}
+
+/*! ************************************
+
+	\brief Read an array of 64 bit big endian integers from the data stream
+
+	The data is copied and converted to native endian using
+	BigEndian::ConvertArray(), which is much faster than calling
+	GetBigWord64(void) for each entry.
+
+	\param pOutput Pointer to the array to receive the data
+	\param uCount Number of entries to read
+	\return The number of entries read, less than uCount if the stream ran out of data. Unread entries are set to zero.
+	\sa GetBigWord64(void)
+
+***************************************/
+
+WordPtr BURGER_API Burger::InputMemoryStream::GetBigWord64Array(Word64 *pOutput,WordPtr uCount) BURGER_NOEXCEPT
+{
+	WordPtr uRequested = uCount;
+	const Word64 *pInput = reinterpret_cast<const Word64 *>(GetArrayPtr(&uCount,sizeof(Word64)));
+	CopyArray<BigEndian>(pOutput,pInput,uCount,uRequested);
+	return uCount;
+}
+
+/*! ************************************
+
+	\brief Read an array of 32 bit little endian floats from the data stream
+
+	The data is copied and converted to native endian using
+	LittleEndian::ConvertArray(), which is much faster than calling
+	GetFloat(void) for each entry.
+
+	\param pOutput Pointer to the array to receive the data
+	\param uCount Number of entries to read
+	\return The number of entries read, less than uCount if the stream ran out of data. Unread entries are set to zero.
+	\sa GetFloat(void)
+
+***************************************/
+
+WordPtr BURGER_API Burger::InputMemoryStream::GetFloatArray(float *pOutput,WordPtr uCount) BURGER_NOEXCEPT
+{
+	WordPtr uRequested = uCount;
+	const float *pInput = reinterpret_cast<const float *>(GetArrayPtr(&uCount,sizeof(float)));
+	CopyArray<LittleEndian>(pOutput,pInput,uCount,uRequested);
+	return uCount;
+}
+
+/*! ************************************
+
+	\brief Read an array of 32 bit big endian floats from the data stream
+
+	The data is copied and converted to native endian using
+	BigEndian::ConvertArray(), which is much faster than calling
+	GetBigFloat(void) for each entry.
+
+	\param pOutput Pointer to the array to receive the data
+	\param uCount Number of entries to read
+	\return The number of entries read, less than uCount if the stream ran out of data. Unread entries are set to zero.
+	\sa GetBigFloat(void)
+
+***************************************/
+
+WordPtr BURGER_API Burger::InputMemoryStream::GetBigFloatArray(float *pOutput,WordPtr uCount) BURGER_NOEXCEPT
+{
+	WordPtr uRequested = uCount;
+	const float *pInput = reinterpret_cast<const float *>(GetArrayPtr(&uCount,sizeof(float)));
+	CopyArray<BigEndian>(pOutput,pInput,uCount,uRequested);
+	return uCount;
+}
+
 /*! ************************************
 
 	\brief Extract an R,G,B color from the input stream
@@ -51,6 +51,8 @@ protected:
     uintptr_t m_uBufferSize;       ///< Size of the buffer
     uint_t m_bDontFree; ///< \ref TRUE if the memory isn't released on Clear()
     BURGER_DISABLE_COPY(InputMemoryStream);
+    const uint8_t* BURGER_API GetArrayPtr(
+        uintptr_t* pCount, uintptr_t uElementSize) BURGER_NOEXCEPT;
 
 public:
     InputMemoryStream();
@@ -104,6 +106,22 @@ public:
     double BURGER_API GetDouble(void);
     double BURGER_API GetBigDouble(void);
     uintptr_t BURGER_API Get(void* pOutput, uintptr_t uOutputSize);
+    uintptr_t BURGER_API GetShortArray(
+        uint16_t* pOutput, uintptr_t uCount) BURGER_NOEXCEPT;
+    uintptr_t BURGER_API GetBigShortArray(
+        uint16_t* pOutput, uintptr_t uCount) BURGER_NOEXCEPT;
+    uintptr_t BURGER_API GetWord32Array(
+        uint32_t* pOutput, uintptr_t uCount) BURGER_NOEXCEPT;
+    uintptr_t BURGER_API GetBigWord32Array(
+        uint32_t* pOutput, uintptr_t uCount) BURGER_NOEXCEPT;
+    uintptr_t BURGER_API GetWord64Array(
+        uint64_t* pOutput, uintptr_t uCount) BURGER_NOEXCEPT;
+    uintptr_t BURGER_API GetBigWord64Array(
+        uint64_t* pOutput, uintptr_t uCount) BURGER_NOEXCEPT;
+    uintptr_t BURGER_API GetFloatArray(
+        float* pOutput, uintptr_t uCount) BURGER_NOEXCEPT;
+    uintptr_t BURGER_API GetBigFloatArray(
+        float* pOutput, uintptr_t uCount) BURGER_NOEXCEPT;
     Word BURGER_API Get(RGBWord8_t* pOutput);
     Word BURGER_API Get(RGBAWord8_t* pOutput);
     Word BURGER_API Get(Vector2D_t* pOutput);
@@ -17,6 +17,7 @@
 #include "brglobalmemorymanager.h"
 #include "brfilemanager.h"
 #include "brfile.h"
+#include "brdecompressdeflate.h"
 #include "brfileansihelpers.h"
 #include "brglobals.h"
 #include <stdlib.h>
@@ -34,6 +35,18 @@
 	where the data is coming from and how it's cached in memory
 	for performance
 
+	Resources compressed with deflate can share preset dictionaries,
+	which greatly improves the compression of small files such as
+	scripts or JSON data. The dictionaries are appended to the end of the
+	header block, so rez files with them can still be read by older
+	versions of this class. The layout of the trailer is the dictionary
+	data, followed by a little endian 32 bit length for each dictionary, a
+	little endian 32 bit count of dictionaries and the four bytes 'DICT'.
+	The dictionaries are given to every DecompressDeflate codec logged
+	with LogDecompressor(Word,Decompress *).
+
+	\sa CompressDeflate::TrainDictionary(void *,WordPtr,const void * const *,const WordPtr *,WordPtr)
+
 ***************************************/
 
 /*! ************************************
@@ -79,6 +92,7 @@
 ***************************************/
 
 const char Burger::RezFile::g_RezFileSignature[] = {'B','R','G','R'};
+const char Burger::RezFile::g_RezFileDictionarySignature[] = {'D','I','C','T'};
 
 /***************************************
 
@@ -337,7 +351,7 @@ Word BURGER_API Burger::RezFile::FindName(const char *pRezName,Burger::RezFile::
 	old games like Killing Time can use the new burgerlib
 	without having to update the .REZ files.
 
-	\param pData Pointer to the Rez File image
+	\param pData Pointer to the Rez File image, the group and entry records are converted to native endian in place
 	\param pHeader Pointer to the parsed file header
 	\param uSwapFlag \ref TRUE if endian should be swapped
 	\param uStartOffset Number of bytes the header was from the start of file (For data index offset adjustments)
@@ -346,7 +360,7 @@ Word BURGER_API Burger::RezFile::FindName(const char *pRezName,Burger::RezFile::
 
 ***************************************/
 
-Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeader(const Word8 *pData,const RootHeader_t *pHeader,Word uSwapFlag,Word32 uStartOffset)
+Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeader(Word8 *pData,const RootHeader_t *pHeader,Word uSwapFlag,Word32 uStartOffset)
 {
 	// Get the number of groups to parse
 	Word uGroupCount = pHeader->m_uGroupCount;
@@ -359,15 +373,26 @@ Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeader(con
 
 		// This is how many bytes I'm going to need
 		WordPtr uNewLength = 0;
+		// The group records can't run past the end of the header
+		WordPtr uRemaining = pHeader->m_uMemSize;
 		// Parse the old way?
 		if (uSwapFlag&OLDFORMAT) {
 			do {
+				if (uRemaining<(sizeof(Word32)*3)) {
+					return NULL;
+				}
+				uRemaining -= sizeof(Word32)*3;
 				Word uOldCount;
 				if (uSwapFlag&SWAPENDIAN) {
 					uOldCount = SwapEndian::Load(reinterpret_cast<const Word32 *>(pWork+8));		/* Fix endian if needed */
 				} else {
 					uOldCount = reinterpret_cast<const Word32 *>(pWork)[2];		// Get the count
 				}
+				// Do the entries fit?
+				if (uOldCount>(uRemaining/(sizeof(Word32)*3))) {
+					return NULL;
+				}
+				uRemaining -= uOldCount*(sizeof(Word32)*3);
 				// Number of bytes needed to store this record
 				uNewLength += (((uOldCount-1)*sizeof(RezEntry_t))+sizeof(RezGroup_t));
 				// Index to the next record
@@ -376,7 +401,16 @@ Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeader(con
 		} else {
 		// Parse the new way
 			do {
+				if (uRemaining<(sizeof(Word32)*2)) {
+					return NULL;
+				}
+				uRemaining -= sizeof(Word32)*2;
 				Word uNewCount = LittleEndian::Load(&reinterpret_cast<const FileRezGroup_t *>(pWork)->m_uCount);	/* Get the count */
+				// Do the entries fit?
+				if (uNewCount>(uRemaining/(sizeof(Word32)*4))) {
+					return NULL;
+				}
+				uRemaining -= uNewCount*(sizeof(Word32)*4);
 				// Number of bytes needed to store this record
 				uNewLength += (uNewCount*sizeof(RezEntry_t))+(sizeof(RezGroup_t)-sizeof(RezEntry_t));
 				// Next group
@@ -385,6 +419,21 @@ Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeader(con
 		}
 		// How many bytes until the end of the data
 		WordPtr uAdjust = static_cast<WordPtr>(pWork-pData);
+		// Corrupt group counts, don't convert past the end of the header
+		if (uAdjust>pHeader->m_uMemSize) {
+			return NULL;
+		}
+
+		// The group and entry records are all 32 bit values, convert
+		// them to native endian in one pass so the second pass can
+		// read them directly
+		if (uSwapFlag&OLDFORMAT) {
+			if (uSwapFlag&SWAPENDIAN) {
+				SwapEndian::FixupArray(reinterpret_cast<Word32 *>(pData),uAdjust/sizeof(Word32));
+			}
+		} else {
+			LittleEndian::FixupArray(reinterpret_cast<Word32 *>(pData),uAdjust/sizeof(Word32));
+		}
 		// Determine the amount of memory the filenames need
 		WordPtr uTextLength = pHeader->m_uMemSize - uAdjust;
 		uAdjust = uNewLength-uAdjust;
@@ -405,15 +454,9 @@ Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeader(con
 					// Old rez files had a type record
 					Word32 uType;
 					// Load the type, base and count
-					if (uSwapFlag&SWAPENDIAN) {
-						uType = SwapEndian::Load(reinterpret_cast<const Word32 *>(pWork));
-						pGroup->m_uBaseRezNum = SwapEndian::Load(&reinterpret_cast<const Word32 *>(pWork)[1]);
-						pGroup->m_uCount = SwapEndian::Load(&reinterpret_cast<const Word32 *>(pWork)[2]);
-					} else {
-						uType = reinterpret_cast<const Word32 *>(pWork)[0];
-						pGroup->m_uBaseRezNum = reinterpret_cast<const Word32 *>(pWork)[1];
-						pGroup->m_uCount = reinterpret_cast<const Word32 *>(pWork)[2];
-					}
+					uType = reinterpret_cast<const Word32 *>(pWork)[0];
+					pGroup->m_uBaseRezNum = reinterpret_cast<const Word32 *>(pWork)[1];
+					pGroup->m_uCount = reinterpret_cast<const Word32 *>(pWork)[2];
 					pWork += sizeof(Word32)*3;
 					// Patch in sound files in Killing Time
 					// Type 5 is now ID+5000
@@ -427,18 +470,9 @@ Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeader(con
 					RezEntry_t *pEntry = pGroup->m_Array;
 					if (uCount) {
 						do {
-							Word uFileOffset;
-							Word uLength;
-							Word uNameOffset;
-							if (uSwapFlag&SWAPENDIAN) {
-								uFileOffset = SwapEndian::Load(&reinterpret_cast<const Word32*>(pWork)[0]);
-								uLength = SwapEndian::Load(&reinterpret_cast<const Word32*>(pWork)[1]);
-								uNameOffset = SwapEndian::Load(&reinterpret_cast<const Word32*>(pWork)[2]);
-							} else {
-								uFileOffset = reinterpret_cast<const Word32*>(pWork)[0];
-								uLength = reinterpret_cast<const Word32*>(pWork)[1];
-								uNameOffset = reinterpret_cast<const Word32*>(pWork)[2];
-							}
+							Word uFileOffset = reinterpret_cast<const Word32*>(pWork)[0];
+							Word uLength = reinterpret_cast<const Word32*>(pWork)[1];
+							Word uNameOffset = reinterpret_cast<const Word32*>(pWork)[2];
 							// Initialize the structure
 							Word uFlags = 0;
 							pEntry->m_ppData = NULL;
@@ -477,8 +511,8 @@ Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeader(con
 
 				do {
 					// Get the base resource number and the resource count
-					pGroup->m_uBaseRezNum = LittleEndian::Load(&reinterpret_cast<const FileRezGroup_t*>(pWork)->m_uBaseRezNum);
-					pGroup->m_uCount = LittleEndian::Load(&reinterpret_cast<const FileRezGroup_t*>(pWork)->m_uCount);
+					pGroup->m_uBaseRezNum = reinterpret_cast<const FileRezGroup_t*>(pWork)->m_uBaseRezNum;
+					pGroup->m_uCount = reinterpret_cast<const FileRezGroup_t*>(pWork)->m_uCount;
 					pWork += (sizeof(Word32)*2);
 				
 					// Process each resource entry
@@ -490,10 +524,10 @@ Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeader(con
 							pEntry->m_ppData = NULL;
 							pEntry->m_pRezName = NULL;
 							// Adjust the file offset from the start of the file image
-							pEntry->m_uFileOffset = LittleEndian::Load(&reinterpret_cast<const FileRezEntry_t *>(pWork)->m_uFileOffset)+uStartOffset;
-							pEntry->m_uLength = LittleEndian::Load(&reinterpret_cast<const FileRezEntry_t *>(pWork)->m_uLength);
-							Word uNameOffset = LittleEndian::Load(&reinterpret_cast<const FileRezEntry_t *>(pWork)->m_uNameOffset);
-							pEntry->m_uCompressedLength = LittleEndian::Load(&reinterpret_cast<const FileRezEntry_t *>(pWork)->m_uCompressedLength);
+							pEntry->m_uFileOffset = reinterpret_cast<const FileRezEntry_t *>(pWork)->m_uFileOffset+uStartOffset;
+							pEntry->m_uLength = reinterpret_cast<const FileRezEntry_t *>(pWork)->m_uLength;
+							Word uNameOffset = reinterpret_cast<const FileRezEntry_t *>(pWork)->m_uNameOffset;
+							pEntry->m_uCompressedLength = reinterpret_cast<const FileRezEntry_t *>(pWork)->m_uCompressedLength;
 							// Next 4 longwords (Rigid)
 							pWork += (sizeof(Word32)*4);
 							if (uNameOffset&ENTRYFLAGSNAMEOFFSETMASK) {
@@ -655,6 +689,159 @@ void BURGER_API Burger::RezFile::FixupFilenames(char *pText)
 	ProcessRezNames();
 }
 
+/*! ************************************
+
+	\brief Extract the preset dictionaries from a rez file header
+
+	If the header block ends with a 'DICT' trailer, copy the
+	dictionaries into their own memory block so they survive
+	the release of the header.
+
+	\param pData Pointer to the header block as loaded from the file
+	\param uMemSize Size of the header block in bytes
+	\return Size of the header block without the dictionary trailer
+
+***************************************/
+
+WordPtr BURGER_API Burger::RezFile::LoadDictionaries(const Word8 *pData,WordPtr uMemSize)
+{
+	if ((uMemSize>=(sizeof(Word32)*2)) &&
+		!MemoryCompare(pData+uMemSize-4,g_RezFileDictionarySignature,4)) {
+		WordPtr uCount = LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pData+uMemSize-8));
+		// Is the length table inside the header?
+		if (uCount && (uCount<((uMemSize/sizeof(Word32))-1))) {
+			WordPtr uTrailer = (uCount+2)*sizeof(Word32);
+			const Word8 *pLengths = pData+uMemSize-uTrailer;
+			// Space in front of the length table for the dictionary data
+			WordPtr uRemaining = uMemSize-uTrailer;
+			WordPtr uDataSize = 0;
+			WordPtr i = 0;
+			do {
+				WordPtr uLength = LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pLengths+(i*sizeof(Word32))));
+				// Test each length so the sum can't wrap around
+				if (uLength>(uRemaining-uDataSize)) {
+					break;
+				}
+				uDataSize += uLength;
+			} while (++i<uCount);
+			// Does all of the dictionary data fit?
+			if (i==uCount) {
+				// Keep the data and the length table, drop the signature
+				WordPtr uSize = uDataSize+uTrailer-4;
+				Word8 *pDictionaries = static_cast<Word8 *>(Alloc(uSize));
+				if (pDictionaries) {
+					MemoryCopy(pDictionaries,pLengths-uDataSize,uSize);
+					m_pDictionaries = pDictionaries;
+					m_uDictionariesSize = uSize;
+					m_uDictionaryCount = static_cast<Word>(uCount);
+					return uMemSize-uTrailer-uDataSize;
+				}
+			}
+		}
+	}
+	return uMemSize;
+}
+
+/*! ************************************
+
+	\brief Give or remove the preset dictionaries to a decompressor
+
+	If the codec is a DecompressDeflate, either add all of
+	the dictionaries loaded from the rez file or remove all
+	dictionaries from it.
+
+	\param pProc Pointer to a decompression codec, can be \ref NULL
+	\param bAttach \ref TRUE to add the dictionaries, \ref FALSE to remove them
+
+***************************************/
+
+void BURGER_API Burger::RezFile::AttachDictionaries(Decompress *pProc,Word bAttach) const
+{
+	Word uCount = m_uDictionaryCount;
+	if (uCount) {
+		DecompressDeflate *pDeflate = BURGER_RTTICAST(DecompressDeflate,pProc);
+		if (pDeflate) {
+			if (!bAttach) {
+				pDeflate->ClearDictionaries();
+			} else {
+				const Word8 *pData = m_pDictionaries;
+				const Word8 *pLengths = pData+m_uDictionariesSize-((uCount+1)*sizeof(Word32));
+				do {
+					WordPtr uLength = LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pLengths));
+					pDeflate->AddDictionary(pData,uLength);
+					pData += uLength;
+					pLengths += sizeof(Word32);
+				} while (--uCount);
+			}
+		}
+	}
+}
+
+/*! ************************************
+
+	\brief Memory map the rez file
+
+	On platforms that support it, map the entire rez file
+	into the address space so stored entries can be
+	accessed without a read or a copy.
+
+	The mapping is private and copy on write, so data
+	can be modified in place without changing the file.
+
+	\note On platforms without memory mapped file support,
+	this function does nothing and returns \ref TRUE
+
+	\param pFileName Pointer to "C" string of the filename of the rez file
+	\return \ref FALSE if the file was mapped, non-zero on error
+	\sa UnmapFile(void)
+
+***************************************/
+
+#if !defined(BURGER_LINUX) || defined(DOXYGEN)
+Word BURGER_API Burger::RezFile::MapFile(const char * /* pFileName */)
+{
+	return TRUE;
+}
+
+/*! ************************************
+
+	\brief Release the memory mapped rez file
+
+	If the rez file was memory mapped, release the
+	mapping. All pointers given out from the mapping
+	are invalid after this call.
+
+	\sa MapFile(const char *)
+
+***************************************/
+
+void BURGER_API Burger::RezFile::UnmapFile(void)
+{
+}
+#endif
+
+/*! ************************************
+
+	\brief Return a pointer into the memory mapped rez file
+
+	If the rez file is memory mapped and the requested
+	range is inside of the mapping, return a pointer to
+	the data.
+
+	\param uOffset Offset in bytes from the start of the file
+	\param uLength Length in bytes of the data requested
+	\return Pointer to the data or \ref NULL if not available
+
+***************************************/
+
+const Word8 * BURGER_API Burger::RezFile::GetMappedData(WordPtr uOffset,WordPtr uLength) const
+{
+	const Word8 *pMappedFile = m_pMappedFile;
+	if (pMappedFile && (uOffset<=m_uMappedFileSize) && (uLength<=(m_uMappedFileSize-uOffset))) {
+		return pMappedFile+uOffset;
+	}
+	return NULL;
+}
 
 /*! ************************************
 
@@ -674,7 +861,13 @@ Burger::RezFile::RezFile(Burger::MemoryManagerHandle *pMemoryManager) :
 	m_uRezNameCount(0),
 	m_pGroups(NULL),
 	m_pRezNames(NULL),
-	m_bExternalFileEnabled(TRUE)
+	m_pDictionaries(NULL),
+	m_uDictionariesSize(0),
+	m_uDictionaryCount(0),
+	m_pMappedFile(NULL),
+	m_uMappedFileSize(0),
+	m_bExternalFileEnabled(TRUE),
+	m_bMappedFileEnabled(FALSE)
 {
 	Word i=0;
 	do {
@@ -736,6 +929,10 @@ Burger::RezFile * BURGER_API Burger::RezFile::New(Burger::MemoryManagerHandle *p
 
 	\brief Open a resource file for reading
 
+	If memory mapping was enabled with SetMappedFlag(Word),
+	the file is also mapped into memory. If the mapping fails,
+	the data is read from the file as normal.
+
 	\param pFileName Pointer to "C" string of the filename to open
 	\param uStartOffset Offset from the start of the file where the rezfile image resides. Normally zero.
 
@@ -786,6 +983,10 @@ Word BURGER_API Burger::RezFile::Init(const char *pFileName,Word32 uStartOffset)
 					if (pData) {
 						// Read in the file header
 						if (m_File.Read(pData,MyHeader.m_uMemSize)==MyHeader.m_uMemSize) {
+							// Only the new format can have preset dictionaries
+							if (!uSwapFlag) {
+								MyHeader.m_uMemSize = static_cast<Word32>(LoadDictionaries(pData,MyHeader.m_uMemSize));
+							}
 							RezGroup_t *pRezGroup = ParseRezFileHeader(pData,&MyHeader,uSwapFlag,uStartOffset);
 							if (pRezGroup) {
 								// Dispose of the loaded data
@@ -795,6 +996,15 @@ Word BURGER_API Burger::RezFile::Init(const char *pFileName,Word32 uStartOffset)
 								m_pGroups = pRezGroup;	// Get the memory
 								m_bExternalFileEnabled = TRUE;	// External files are ok
 								ProcessRezNames();		// Make the initial name hash
+								// Map the file if requested, on failure, use file reads
+								if (m_bMappedFileEnabled) {
+									MapFile(pFileName);
+								}
+								// Give the dictionaries to the codecs
+								Word i = 0;
+								do {
+									AttachDictionaries(m_Decompressors[i],TRUE);
+								} while (++i<MAXCODECS);
 								return FALSE;
 							}
 						}
@@ -816,7 +1026,8 @@ Word BURGER_API Burger::RezFile::Init(const char *pFileName,Word32 uStartOffset)
 	\brief Dispose of the contents of a resource file
 
 	Release all resources allocated by a resource file. All pointers that have
-	been given to the application are now all invalid.
+	been given to the application are now all invalid. This includes pointers
+	into the memory mapped file that were released with Detach().
 
 ***************************************/
 
@@ -824,6 +1035,8 @@ void BURGER_API Burger::RezFile::Shutdown(void)
 {
 	// Is there an open file?
 	m_File.Close();
+	// Release the mapping
+	UnmapFile();
 
 	// Dispose of any resources in memory
 	// Any valid entries?
@@ -854,6 +1067,17 @@ void BURGER_API Burger::RezFile::Shutdown(void)
 	Free(m_pGroups);
 	// Release the name list
 	Free(m_pRezNames);
+	// Release the preset dictionaries, the codecs can't use them anymore
+	if (m_uDictionaryCount) {
+		Word i = 0;
+		do {
+			AttachDictionaries(m_Decompressors[i],FALSE);
+		} while (++i<MAXCODECS);
+		Free(m_pDictionaries);
+		m_pDictionaries = NULL;
+		m_uDictionariesSize = 0;
+		m_uDictionaryCount = 0;
+	}
 	m_pGroups = NULL;
 	m_pRezNames = NULL;
 	m_uRezNameCount = 0;
@@ -941,11 +1165,80 @@ Word BURGER_API Burger::RezFile::SetExternalFlag(Word bEnable)
 
 ***************************************/
 
+/*! ************************************
+
+	\brief Enable or disable memory mapping of the rez file
+
+	When enabled, Init() maps the rez file into memory and
+	Load() returns pointers directly into the mapping for
+	uncompressed entries instead of allocating a handle
+	and copying the data. Compressed entries are decompressed
+	straight from the mapping.
+
+	The mapping is private, so the returned data can be
+	modified in place. These changes are kept until
+	Shutdown(), even if the entry is released or killed.
+
+	The new state takes effect on the next call to Init().
+	Memory mapping is disabled by default and is ignored
+	on platforms that don't support it.
+
+	\param bEnable \ref TRUE to enable memory mapping, \ref FALSE to disable
+	\return Previous flag state
+	\sa GetMappedFlag(void) const or IsMapped(void) const
+
+***************************************/
+
+Word BURGER_API Burger::RezFile::SetMappedFlag(Word bEnable)
+{
+	Word uOldFlag = m_bMappedFileEnabled;
+	m_bMappedFileEnabled = bEnable;
+	return uOldFlag;
+}
+
+/*! ************************************
+
+	\fn Word Burger::RezFile::GetMappedFlag(void) const
+	\brief Return the state of memory mapping the rez file
+
+	\return Current flag state, \ref TRUE or \ref FALSE
+	\sa SetMappedFlag(Word) or IsMapped(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::RezFile::IsMapped(void) const
+	\brief Return \ref TRUE if the open rez file is memory mapped
+
+	\return \ref TRUE if the data is read from a memory mapped file
+	\sa SetMappedFlag(Word)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::RezFile::GetDictionaryCount(void) const
+	\brief Return the number of preset dictionaries
+
+	\return Number of deflate preset dictionaries found in the rez file header
+	\sa LogDecompressor(Word,Decompress *)
+
+***************************************/
+
 /*! ************************************
 
 	\brief Log a resource decompressor
+
+	Any Decompress codec that accepts data in chunks can be used,
+	such as DecompressLZ4 for resources that need to load quickly.
+
+	If the rez file has preset dictionaries and the codec is
+	a DecompressDeflate, the dictionaries are added to it.
+
 	\param uCompressID Compressor ID (1-3)
 	\param pProc Pointer to a decompression codec
+	\sa DecompressLZSS, DecompressDeflate or DecompressLZ4
 
 ***************************************/
 
@@ -953,8 +1246,11 @@ void BURGER_API Burger::RezFile::LogDecompressor(Word uCompressID,Burger::Decomp
 {
 	// Allowable?
 	if (--uCompressID<MAXCODECS) {	
+		// Release the dictionaries from the previous codec
+		AttachDictionaries(m_Decompressors[uCompressID],FALSE);
 		// Save the function pointer
 		m_Decompressors[uCompressID] = pProc;
+		AttachDictionaries(pProc,TRUE);
 	}
 #if defined(_DEBUG)
 	else {
@@ -1534,7 +1830,8 @@ Word BURGER_API Burger::RezFile::GetIDFromPointer(const void *pRez,Word *pRezNum
 				// Check the entries for this handle
 				
 				do {
-					if (pEntry->m_ppData && (pEntry->m_ppData[0] == pRez)) {		// Is it a match?
+					if ((pEntry->m_ppData && (pEntry->m_ppData[0] == pRez)) ||
+						((pEntry->m_uFlags&ENTRYFLAGSMAPPED) && ((m_pMappedFile+pEntry->m_uFileOffset) == pRez))) {		// Is it a match?
 						if (pRezNum) {						// Do I want the ID number?
 							pRezNum[0] = (pGroups->m_uBaseRezNum+pGroups->m_uCount)-uCount;
 						}
@@ -1650,7 +1947,11 @@ void ** BURGER_API Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 		pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);	// Kill the ref count
 		return NULL;
 	}
-	m_File.SetMark(uFileOffset);						// Seek into the file
+	// If the file is mapped, get the data from memory
+	const Word8 *pMapped = GetMappedData(uFileOffset,pEntry->m_uCompressedLength);
+	if (!pMapped) {
+		m_File.SetMark(uFileOffset);					// Seek into the file
+	}
 
 	Word32 DataLength = pEntry->m_uLength;				// Preload the length
 	Word32 PackedLength = pEntry->m_uCompressedLength;
@@ -1664,7 +1965,12 @@ void ** BURGER_API Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 
 		// The old format had the data length in the compressed data
 		if (!DataLength) {
-			DataLength = m_File.ReadLittleWord32();		// Get the length
+			if (pMapped) {
+				DataLength = LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pMapped));
+				pMapped += 4;
+			} else {
+				DataLength = m_File.ReadLittleWord32();		// Get the length
+			}
 			pEntry->m_uLength = DataLength;
 			pEntry->m_uFileOffset += 4;
 			pEntry->m_uCompressedLength -= 4;
@@ -1676,35 +1982,48 @@ void ** BURGER_API Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 			return NULL;
 		}
 		m_pMemoryManager->SetID(ppData,uRezNum);		// Set the ID to the handle
-		Word32 BufferSize = (PackedLength<MAXBUFFER) ? PackedLength : MAXBUFFER;
-		Word8 *PackedPtr = static_cast<Word8 *>(Alloc(BufferSize));	// Get Buffer
-		if (!PackedPtr) {				// No compressed data buffer?
-			m_pMemoryManager->FreeHandle(ppData);
-			pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);		// Kill the ref count
-			return NULL;
-		}
-		pDecompressor->Reset();
-		WordPtr PackedHeader = DataLength;
-		WordPtr PackedSize = PackedLength;
-		Word8 *pOutput = (Word8 *)m_pMemoryManager->Lock(ppData);
-		do {		/* Loop for decompression */
-			WordPtr ChunkSize = (BufferSize<PackedSize) ? BufferSize : PackedSize;
-			if (m_File.Read(PackedPtr,ChunkSize)!=ChunkSize) {
+		if (pMapped) {
+			// Decompress straight from the mapped file
+			pDecompressor->Reset();
+			Decompress::eError uError = pDecompressor->Process(m_pMemoryManager->Lock(ppData),DataLength,pMapped,pEntry->m_uCompressedLength);
+			WordPtr uProcessed = pDecompressor->GetProcessedOutputSize();
+			pDecompressor->Reset();		// Force a shutdown
+			if ((uError==Decompress::DECOMPRESS_BADINPUT) || (uProcessed!=DataLength)) {
 				m_pMemoryManager->FreeHandle(ppData);
 				pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);		// Kill the ref count
 				return NULL;
 			}
-			if (pDecompressor->Process(pOutput,PackedHeader,PackedPtr,ChunkSize)==Decompress::DECOMPRESS_BADINPUT) {
+		} else {
+			Word32 BufferSize = (PackedLength<MAXBUFFER) ? PackedLength : MAXBUFFER;
+			Word8 *PackedPtr = static_cast<Word8 *>(Alloc(BufferSize));	// Get Buffer
+			if (!PackedPtr) {				// No compressed data buffer?
 				m_pMemoryManager->FreeHandle(ppData);
 				pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);		// Kill the ref count
 				return NULL;
 			}
-			PackedHeader -= pDecompressor->GetProcessedOutputSize();
-			pOutput += pDecompressor->GetProcessedOutputSize();
-			PackedSize -= ChunkSize;
-		} while (PackedSize);
-		pDecompressor->Reset();		// Force a shutdown
-		Free(PackedPtr);	/* Release the temp buffer */
+			pDecompressor->Reset();
+			WordPtr PackedHeader = DataLength;
+			WordPtr PackedSize = PackedLength;
+			Word8 *pOutput = (Word8 *)m_pMemoryManager->Lock(ppData);
+			do {		/* Loop for decompression */
+				WordPtr ChunkSize = (BufferSize<PackedSize) ? BufferSize : PackedSize;
+				if (m_File.Read(PackedPtr,ChunkSize)!=ChunkSize) {
+					m_pMemoryManager->FreeHandle(ppData);
+					pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);		// Kill the ref count
+					return NULL;
+				}
+				if (pDecompressor->Process(pOutput,PackedHeader,PackedPtr,ChunkSize)==Decompress::DECOMPRESS_BADINPUT) {
+					m_pMemoryManager->FreeHandle(ppData);
+					pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);		// Kill the ref count
+					return NULL;
+				}
+				PackedHeader -= pDecompressor->GetProcessedOutputSize();
+				pOutput += pDecompressor->GetProcessedOutputSize();
+				PackedSize -= ChunkSize;
+			} while (PackedSize);
+			pDecompressor->Reset();		// Force a shutdown
+			Free(PackedPtr);	/* Release the temp buffer */
+		}
 		m_pMemoryManager->Unlock(ppData);
 		if (pLoadedFlag) {
 			pLoadedFlag[0] = TRUE;		/* Data is new */
@@ -1727,7 +2046,11 @@ void ** BURGER_API Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 	ppData = m_pMemoryManager->AllocHandle(DataLength,uHandleFlags);	// Get the memory
 	if (ppData) {		/* Memory ok? */
 		m_pMemoryManager->SetID(ppData,uRezNum);		// Set the ID to the handle
-		if (m_File.Read(m_pMemoryManager->Lock(ppData),DataLength)==DataLength) {	/* Read it in */
+		void *pOutput = m_pMemoryManager->Lock(ppData);
+		if (pMapped) {
+			MemoryCopy(pOutput,pMapped,DataLength);		// Copy from the mapped file
+		}
+		if (pMapped || (m_File.Read(pOutput,DataLength)==DataLength)) {	/* Read it in */
 			m_pMemoryManager->Unlock(ppData);
 			if (pLoadedFlag) {
 				pLoadedFlag[0] = TRUE;		/* Data is new */
@@ -1785,6 +2108,13 @@ void ** BURGER_API Burger::RezFile::LoadHandle(const char *pRezName,Word *pLoade
 /*! ************************************
 
 	\brief Load in a resource
+
+	If the rez file is memory mapped and the resource is
+	stored uncompressed, a pointer directly into the mapping
+	is returned and no memory is allocated. The loaded
+	flag is only set the first time the data is given out,
+	since changes made to the data are kept in the mapping.
+
 	\param uRezNum Resource number
 	\param pLoadedFlag Pointer to a \ref Word that's
 		set to \ref TRUE if the data was freshly loaded
@@ -1795,6 +2125,34 @@ void ** BURGER_API Burger::RezFile::LoadHandle(const char *pRezName,Word *pLoade
 
 void * BURGER_API Burger::RezFile::Load(Word uRezNum,Word *pLoadedFlag)
 {
+	if (m_pMappedFile) {
+		RezEntry_t *pEntry = Find(uRezNum);
+		// Only uncompressed data that's not in a handle can be used in place
+		if (pEntry && !pEntry->m_ppData && !(pEntry->m_uFlags&ENTRYFLAGSDECOMPMASK)) {
+			Word32 uFlags = pEntry->m_uFlags;
+			// Has the external file been checked for?
+			if (pEntry->m_pRezName && m_bExternalFileEnabled && !(uFlags&ENTRYFLAGSTESTED)) {
+				uFlags |= ENTRYFLAGSTESTED;
+				if (FileManager::DoesFileExist(pEntry->m_pRezName)) {
+					uFlags |= ENTRYFLAGSFILEFOUND;
+				}
+				pEntry->m_uFlags = uFlags;
+			}
+			// External files have priority over the rez file
+			if (!pEntry->m_pRezName || !m_bExternalFileEnabled || !(uFlags&ENTRYFLAGSFILEFOUND)) {
+				const Word8 *pMapped = GetMappedData(pEntry->m_uFileOffset,pEntry->m_uLength);
+				if (pEntry->m_uFileOffset && pMapped) {
+					if (pLoadedFlag) {
+						// Only new if it was never given out before
+						pLoadedFlag[0] = !(uFlags&ENTRYFLAGSMAPPED);
+					}
+					// Increase the reference count
+					pEntry->m_uFlags = (uFlags|ENTRYFLAGSMAPPED)+ENTRYFLAGSREFADD;
+					return const_cast<Word8 *>(pMapped);
+				}
+			}
+		}
+	}
 	// Load the handle and dereference it
 	return m_pMemoryManager->Lock(LoadHandle(uRezNum,pLoadedFlag));
 }
@@ -1812,8 +2170,18 @@ void * BURGER_API Burger::RezFile::Load(Word uRezNum,Word *pLoadedFlag)
 
 void * BURGER_API Burger::RezFile::Load(const char *pRezName,Word *pLoadedFlag)
 {
-	// Load the handle and dereference it
-	return m_pMemoryManager->Lock(LoadHandle(pRezName,pLoadedFlag));
+	// Get the index number
+	Word uRezNum = GetRezNum(pRezName);
+	if (uRezNum == INVALIDREZNUM) {
+		uRezNum = AddName(pRezName);	// Try to add it
+		if (uRezNum==INVALIDREZNUM) {	// No good?
+			if (pLoadedFlag) {
+				pLoadedFlag[0] = FALSE;
+			}
+			return NULL;				// Bad news
+		}
+	}
+	return Load(uRezNum,pLoadedFlag);			// Load the file
 }
 
 /*! ************************************
@@ -1831,15 +2199,15 @@ Word BURGER_API Burger::RezFile::Read(Word uRezNum,void *pBuffer,WordPtr uBuffer
 {	
 	// Assume failure
 	Word uResult = TRUE;
-	void **ppData = LoadHandle(uRezNum);	// Load it in
-	if (ppData) {							// Ok?
+	const void *pData = Load(uRezNum);		// Load it in
+	if (pData) {							// Ok?
 		RezEntry_t *pEntry = Find(uRezNum);
 		WordPtr uLength = pEntry->m_uLength;	// How much memory does this take?
 		if (uBufferSize>=uLength) {			// Is the output buffer big enough?
 			uBufferSize = uLength;			// Use the smaller
 			uResult = FALSE;				// It's ok
 		}
-		MemoryCopy(pBuffer,ppData[0],uBufferSize);	// Copy the data
+		MemoryCopy(pBuffer,pData,uBufferSize);	// Copy the data
 		Release(uRezNum);	// Release the data
 	}
 	// Return FALSE if OK
@@ -1948,7 +2316,9 @@ void BURGER_API Burger::RezFile::Release(const char *pRezName)
 
 	\brief Destroy the data associated with a resource
 
-	Release all memory associated with this specific resource
+	Release all memory associated with this specific resource.
+	Data given out from a memory mapped file has no memory
+	to release, so only the reference count is cleared.
 
 	\param uRezNum Resource number
 
@@ -1969,6 +2339,9 @@ void BURGER_API Burger::RezFile::Kill(Word uRezNum)
 			}
 #endif
 			m_pMemoryManager->FreeHandle(ppData);
+		} else if (pEntry->m_uFlags&ENTRYFLAGSMAPPED) {
+			// Data in the mapped file has no memory to release
+			pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);
 		}
 	}
 }
@@ -1977,7 +2350,9 @@ void BURGER_API Burger::RezFile::Kill(Word uRezNum)
 
 	\brief Destroy the data associated with a resource
 
-	Release all memory associated with this specific resource
+	Release all memory associated with this specific resource.
+	Data given out from a memory mapped file has no memory
+	to release, so only the reference count is cleared.
 
 	\param pRezName Resource name
 
@@ -2000,6 +2375,9 @@ void BURGER_API Burger::RezFile::Kill(const char *pRezName)
 				}
 #endif
 				m_pMemoryManager->FreeHandle(ppData);
+			} else if (pEntry->m_uFlags&ENTRYFLAGSMAPPED) {
+				// Data in the mapped file has no memory to release
+				pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);
 			}
 		}
 	}
@@ -2011,6 +2389,9 @@ void BURGER_API Burger::RezFile::Kill(const char *pRezName)
 
 	Release responsibilty for this resource to the application.
 
+	\note Data given out from a memory mapped file remains
+	valid only until Shutdown() is called.
+
 	\param uRezNum Resource number
 
 ***************************************/
@@ -2036,6 +2417,9 @@ void BURGER_API Burger::RezFile::Detach(Word uRezNum)
 
 	Release responsibilty for this resource to the application.
 
+	\note Data given out from a memory mapped file remains
+	valid only until Shutdown() is called.
+
 	\param pRezName Resource name
 
 ***************************************/
@@ -2071,7 +2455,7 @@ void BURGER_API Burger::RezFile::Detach(const char *pRezName)
 
 void BURGER_API Burger::RezFile::Preload(Word uRezNum)
 {
-	if (LoadHandle(uRezNum)) {	// Get the handle
+	if (Load(uRezNum)) {		// Get the data
 		Release(uRezNum);		// Release the resource
 	}
 }
@@ -2098,7 +2482,7 @@ void BURGER_API Burger::RezFile::Preload(const char *pRezName)
 			return;						// Bad news!
 		}
 	}
-	if (LoadHandle(uRezNum)) {	// Get the handle
+	if (Load(uRezNum)) {		// Get the data
 		Release(uRezNum);		// Release it
 	}
 }
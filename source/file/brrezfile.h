@@ -36,6 +36,7 @@ class RezFile {
     BURGER_DISABLE_COPY(RezFile);
 public:
 	static const char g_RezFileSignature[4];		///< 'BRGR'
+	static const char g_RezFileDictionarySignature[4];	///< 'DICT'
 	enum {
 		MAXCODECS=3,			///< Maximum number of compression codecs available
 		ROOTHEADERSIZE = static_cast<int>(sizeof(Word32)*2)+(MAXCODECS*4)+4,	///< Size of RootHeader_t on disk
@@ -81,6 +82,7 @@ private:
 		// Defines for the bits in m_uFileOffset on disk
 		ENTRYFLAGSTESTED=0x00000001,		///< True if the filename was checked
 		ENTRYFLAGSFILEFOUND=0x0000002,		///< True if a file was found
+		ENTRYFLAGSMAPPED=0x00000004,		///< True if the data was given out from the mapped file
 		// Used by the rez file parser
 		SWAPENDIAN=0x01,					///< Manually swap endian
 		OLDFORMAT=0x02						///< Parsing an old rez file format
@@ -113,16 +115,27 @@ private:
 	Word32 m_uRezNameCount;				///< Number of resource names in m_pRezNames
 	RezGroup_t *m_pGroups;				///< Array of resource groups
 	FilenameToRezNum_t *m_pRezNames;	///< Pointer to sorted resource names if present
+	Word8 *m_pDictionaries;				///< Preset dictionaries from the rez file header, or \ref NULL
+	WordPtr m_uDictionariesSize;		///< Size in bytes of m_pDictionaries
+	Word m_uDictionaryCount;			///< Number of preset dictionaries in m_pDictionaries
+	Word8 *m_pMappedFile;				///< Memory mapped image of the rez file, or \ref NULL
+	WordPtr m_uMappedFileSize;			///< Size in bytes of m_pMappedFile
 	Word m_bExternalFileEnabled;		///< \ref TRUE if external file access is enabled
+	Word m_bMappedFileEnabled;			///< \ref TRUE if the rez file is memory mapped by Init()
 
 	static int BURGER_ANSIAPI QSortNames(const void *pFirst,const void *pSecond);
 	WordPtr BURGER_API GetRezGroupBytes(void) const;
 	void BURGER_API AdjustNamePointers(WordPtr uAdjust);
 	RezEntry_t * BURGER_API Find(Word uRezNum) const;
 	Word BURGER_API FindName(const char *pRezName,FilenameToRezNum_t **ppOutput) const;
-	static RezGroup_t * BURGER_API ParseRezFileHeader(const Word8 *pData,const RootHeader_t *pHeader,Word uSwapFlag,Word32 uStartOffset);
+	static RezGroup_t * BURGER_API ParseRezFileHeader(Word8 *pData,const RootHeader_t *pHeader,Word uSwapFlag,Word32 uStartOffset);
 	void BURGER_API ProcessRezNames(void);
 	void BURGER_API FixupFilenames(char *pText);
+	WordPtr BURGER_API LoadDictionaries(const Word8 *pData,WordPtr uMemSize);
+	void BURGER_API AttachDictionaries(Decompress *pProc,Word bAttach) const;
+	Word BURGER_API MapFile(const char *pFileName);
+	void BURGER_API UnmapFile(void);
+	const Word8 * BURGER_API GetMappedData(WordPtr uOffset,WordPtr uLength) const;
 public:
 	RezFile(MemoryManagerHandle *pMemoryManager);
 	~RezFile();
@@ -132,7 +145,11 @@ public:
 	void BURGER_API PurgeCache(void);
 	Word BURGER_API SetExternalFlag(Word bEnable);
 	Word BURGER_INLINE GetExternalFlag(void) const { return m_bExternalFileEnabled; }
+	Word BURGER_API SetMappedFlag(Word bEnable);
+	BURGER_INLINE Word GetMappedFlag(void) const { return m_bMappedFileEnabled; }
+	BURGER_INLINE Word IsMapped(void) const { return m_pMappedFile!=NULL; }
 	void BURGER_API LogDecompressor(Word uCompressID,Decompress *pProc);
+	BURGER_INLINE Word GetDictionaryCount(void) const { return m_uDictionaryCount; }
 	Word BURGER_API GetRezNum(const char *pRezName) const;
 	Word BURGER_API GetName(Word uRezNum,char *pBuffer,WordPtr uBufferSize) const;
 	Word BURGER_API AddName(const char *pRezName);
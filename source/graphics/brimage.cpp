@@ -19,6 +19,12 @@
 #include "brfilegif.h"
 #include "brfilebmp.h"
 #include "brfiletga.h"
+#include "brdxt1.h"
+#include "brdxt3.h"
+#include "brdxt5.h"
+#include "brbc4.h"
+#include "brbc5.h"
+#include "brbc7.h"
 
 /*! ************************************
 
@@ -388,8 +394,8 @@ Word Burger::Image::Init(const Image *pInput)
 				// Adjust the height by 4x4 cells
 				uHeight = (uHeight+3)>>2;
 				uPixels = uPixels*16;
-				if (m_eType==PIXELTYPEDXT1) {
-					// DXT1 only uses 8 bytes per cell, not 16
+				if ((m_eType==PIXELTYPEDXT1) || (m_eType==PIXELTYPEBC4)) {
+					// DXT1 and BC4 only use 8 bytes per cell, not 16
 					uPixels>>=1U;
 				}
 			}
@@ -1241,6 +1247,9 @@ Word BURGER_API Burger::Image::GetBytesPerPixel(ePixelTypes eType)
 	case PIXELTYPEDXT3:			// Compressed with DXT3
 	case PIXELTYPEDXT4:			// Compressed with DXT4
 	case PIXELTYPEDXT5:			// Compressed with DXT5
+	case PIXELTYPEBC4:			// Compressed with BC4
+	case PIXELTYPEBC5:			// Compressed with BC5
+	case PIXELTYPEBC7:			// Compressed with BC7
 		uResult = 0;
 		break;
 	case PIXELTYPE332:			// 8 bits per pixel R:3, G:3, B:2
@@ -1320,6 +1329,9 @@ Word BURGER_API Burger::Image::GetBitsPerPixel(ePixelTypes eType)
 	case PIXELTYPEDXT3:			// Compressed with DXT3
 	case PIXELTYPEDXT4:			// Compressed with DXT4
 	case PIXELTYPEDXT5:			// Compressed with DXT5
+	case PIXELTYPEBC4:			// Compressed with BC4
+	case PIXELTYPEBC5:			// Compressed with BC5
+	case PIXELTYPEBC7:			// Compressed with BC7
 		uStride = 0;
 		break;
 
@@ -1393,12 +1405,15 @@ WordPtr BURGER_API Burger::Image::GetSuggestedStride(Word uWidth,ePixelTypes eTy
 	case PIXELTYPEDXT3:			// Compressed with DXT3
 	case PIXELTYPEDXT4:			// Compressed with DXT4
 	case PIXELTYPEDXT5:			// Compressed with DXT5
+	case PIXELTYPEBC4:			// Compressed with BC4
+	case PIXELTYPEBC5:			// Compressed with BC5
+	case PIXELTYPEBC7:			// Compressed with BC7
 		{
 			// Calculate the number of 4x4 pixel blocks needed
 			Word uBlockWidth = (uWidth+3)>>2;
 			uStride = uBlockWidth*16;
-			if (eType==PIXELTYPEDXT1) {
-				// DXT1 only uses 8 bytes per cell, not 16
+			if ((eType==PIXELTYPEDXT1) || (eType==PIXELTYPEBC4)) {
+				// DXT1 and BC4 only use 8 bytes per cell, not 16
 				uStride>>=1U;
 			}
 		}
@@ -1481,14 +1496,17 @@ WordPtr BURGER_API Burger::Image::GetSuggestedBufferSize(Word uWidth,Word uHeigh
 	case PIXELTYPEDXT3:			// Compressed with DXT3
 	case PIXELTYPEDXT4:			// Compressed with DXT4
 	case PIXELTYPEDXT5:			// Compressed with DXT5
+	case PIXELTYPEBC4:			// Compressed with BC4
+	case PIXELTYPEBC5:			// Compressed with BC5
+	case PIXELTYPEBC7:			// Compressed with BC7
 		{
 			// Calculate the number of 4x4 pixel blocks needed
 			Word uBlockWidth = (uWidth+3)>>2;
 			Word uBlockHeight = (uHeight+3)>>2;
 			Word uTotalBlocks = uBlockWidth*uBlockHeight;
 			uStride = uTotalBlocks*16;
-			if (eType==PIXELTYPEDXT1) {
-				// DXT1 only uses 8 bytes per cell, not 16
+			if ((eType==PIXELTYPEDXT1) || (eType==PIXELTYPEBC4)) {
+				// DXT1 and BC4 only use 8 bytes per cell, not 16
 				uStride>>=1U;
 			}
 		}
@@ -1584,6 +1602,9 @@ WordPtr Burger::Image::GetImageSize(Word uMipMap) const
 	case PIXELTYPEDXT3:			// Compressed with DXT3
 	case PIXELTYPEDXT4:			// Compressed with DXT4
 	case PIXELTYPEDXT5:			// Compressed with DXT5
+	case PIXELTYPEBC4:			// Compressed with BC4
+	case PIXELTYPEBC5:			// Compressed with BC5
+	case PIXELTYPEBC7:			// Compressed with BC7
 		if (uMipMap) {
 			// Any mip maps available?
 			Word uMaxMip = m_uFlags&FLAGS_MIPMAPMASK;
@@ -1600,7 +1621,7 @@ WordPtr Burger::Image::GetImageSize(Word uMipMap) const
 		uHeight = (uHeight+3U)>>2U;
 		uResult = uHeight*uStride;
 		if (uHeight) {
-			if (m_eType==PIXELTYPEDXT1) {
+			if ((m_eType==PIXELTYPEDXT1) || (m_eType==PIXELTYPEBC4)) {
 				if (uResult<8) {
 					uResult = 8;
 				}
@@ -1690,8 +1711,8 @@ void Burger::Image::ClearBitmap(void)
 				// Adjust the height by 4x4 cells
 				uHeight = (uHeight+3)>>2;
 				uPixels = uPixels*16;
-				if (m_eType==PIXELTYPEDXT1) {
-					// DXT1 only uses 8 bytes per cell, not 16
+				if ((m_eType==PIXELTYPEDXT1) || (m_eType==PIXELTYPEBC4)) {
+					// DXT1 and BC4 only use 8 bytes per cell, not 16
 					uPixels>>=1U;
 				}
 			}
@@ -1865,7 +1886,10 @@ Word Burger::Image::HorizontalFlip(void)
 	if not.
 	
 	\note Supported input formats are PIXELTYPE8BIT, PIXELTYPE4444,
-		PIXELTYPE1555, PIXELTYPE555, PIXELTYPE565, PIXELTYPE888 and PIXELTYPE8888
+		PIXELTYPE1555, PIXELTYPE555, PIXELTYPE565, PIXELTYPE888, PIXELTYPE8888,
+		PIXELTYPEDXT1, PIXELTYPEDXT3, PIXELTYPEDXT5, PIXELTYPEBC4, PIXELTYPEBC5
+		and PIXELTYPEBC7. Only the first mip map level of compressed
+		formats is decoded.
 
 	\param pInput Pointer to an image to convert from
 	\param pPalette Optional color palette if converting from an 8 bit format
@@ -2058,10 +2082,88 @@ Word Burger::Image::Store8888(const Image *pInput,const RGBAWord8_t *pPalette)
 			}
 			break;
 
+		// Compressed formats are decoded directly into the bitmap
+		case PIXELTYPEDXT1:
+			DecompressImage(reinterpret_cast<RGBAWord8_t *>(m_pImage),m_uStride,m_uWidth,m_uHeight,reinterpret_cast<const Dxt1Packet_t *>(pInput->m_pImage),pInput->m_uStride);
+			uResult = 0;
+			break;
+		case PIXELTYPEDXT3:
+			DecompressImage(reinterpret_cast<RGBAWord8_t *>(m_pImage),m_uStride,m_uWidth,m_uHeight,reinterpret_cast<const Dxt3Packet_t *>(pInput->m_pImage),pInput->m_uStride);
+			uResult = 0;
+			break;
+		case PIXELTYPEDXT5:
+			DecompressImage(reinterpret_cast<RGBAWord8_t *>(m_pImage),m_uStride,m_uWidth,m_uHeight,reinterpret_cast<const Dxt5Packet_t *>(pInput->m_pImage),pInput->m_uStride);
+			uResult = 0;
+			break;
+		case PIXELTYPEBC4:
+			DecompressImage(reinterpret_cast<RGBAWord8_t *>(m_pImage),m_uStride,m_uWidth,m_uHeight,reinterpret_cast<const Bc4Packet_t *>(pInput->m_pImage),pInput->m_uStride);
+			uResult = 0;
+			break;
+		case PIXELTYPEBC5:
+			DecompressImage(reinterpret_cast<RGBAWord8_t *>(m_pImage),m_uStride,m_uWidth,m_uHeight,reinterpret_cast<const Bc5Packet_t *>(pInput->m_pImage),pInput->m_uStride);
+			uResult = 0;
+			break;
+		case PIXELTYPEBC7:
+			DecompressImage(reinterpret_cast<RGBAWord8_t *>(m_pImage),m_uStride,m_uWidth,m_uHeight,reinterpret_cast<const Bc7Packet_t *>(pInput->m_pImage),pInput->m_uStride);
+			uResult = 0;
+			break;
+
+		// Not supported
+		default:
+			break;
+		}
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Compress an image into DXT1, DXT3 or DXT5 format
+
+	Assume that the Image is already a PIXELTYPEDXT1, PIXELTYPEDXT3 or
+	PIXELTYPEDXT5 format shape with the same size as the input and a
+	buffer is present. Return an error if not.
+
+	\note The only supported input format is PIXELTYPE8888. Only the
+		first mip map level is compressed.
+
+	\param pInput Pointer to an image to convert from
+	\param bClusterFit \ref FALSE for the fast range fit, \ref TRUE for the slower
+		and higher quality cluster fit
+	\param uThreadCount Maximum number of threads to use
+
+	\return Zero on success, non-zero on error
+
+	\sa CompressImage(Dxt1Packet_t *,WordPtr,Word,Word,const RGBAWord8_t *,WordPtr,Word,Word)
+
+***************************************/
+
+Word Burger::Image::StoreDXT(const Image *pInput,Word bClusterFit,Word uThreadCount)
+{
+	Word uResult = 10;
+	if ((pInput->m_eType==PIXELTYPE8888) &&
+		(m_uWidth==pInput->m_uWidth) &&
+		(m_uHeight==pInput->m_uHeight) &&
+		(m_uWidth && m_uHeight) &&
+		m_pImage) {
+		const RGBAWord8_t *pSource = reinterpret_cast<const RGBAWord8_t *>(pInput->m_pImage);
+		switch (m_eType) {
+		case PIXELTYPEDXT1:
+			CompressImage(reinterpret_cast<Dxt1Packet_t *>(m_pImage),m_uStride,m_uWidth,m_uHeight,pSource,pInput->m_uStride,bClusterFit,uThreadCount);
+			uResult = 0;
+			break;
+		case PIXELTYPEDXT3:
+			CompressImage(reinterpret_cast<Dxt3Packet_t *>(m_pImage),m_uStride,m_uWidth,m_uHeight,pSource,pInput->m_uStride,bClusterFit,uThreadCount);
+			uResult = 0;
+			break;
+		case PIXELTYPEDXT5:
+			CompressImage(reinterpret_cast<Dxt5Packet_t *>(m_pImage),m_uStride,m_uWidth,m_uHeight,pSource,pInput->m_uStride,bClusterFit,uThreadCount);
+			uResult = 0;
+			break;
 		// Not supported
 		default:
 			break;
 		}
 	}
 	return uResult;
-}
\ No newline at end of file
+}
@@ -50,7 +50,10 @@ public:
 		PIXELTYPEDXT3=19,			///< Compressed with DXT3
 		PIXELTYPEDXT4=20,			///< Compressed with DXT4
 		PIXELTYPEDXT5=21,			///< Compressed with DXT5
+		PIXELTYPEBC4=22,			///< Compressed with BC4, single red channel
+		PIXELTYPEBC5=23,			///< Compressed with BC5, red and green channels
 		PIXELTYPE888=24,			///< 24 bits per pixel in bytes of R:8, G:8 and B:8
+		PIXELTYPEBC7=25,			///< Compressed with BC7
 		PIXELTYPE1010102=31,		///< 32 bits per pixel in bytes of R:10, G:10, B:10 and A:2 in that order
 		PIXELTYPE8888=32			///< 32 bits per pixel in bytes of R:8, G:8, B:8 and A:8 in that order
 	};
@@ -116,6 +119,7 @@ public:
 	Word VerticleFlip(void);
 	Word HorizontalFlip(void);
 	Word Store8888(const Image *pInput,const RGBAWord8_t *pPalette);
+	Word StoreDXT(const Image *pInput,Word bClusterFit=FALSE,Word uThreadCount=1);
 };
 }
 /* END */
@@ -0,0 +1,481 @@
+/***************************************
+
+	Class to handle critical sections, Linux version
+
+	Copyright (c) 1995-2018 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE for
+	license details. Yes, you can use it in a commercial title without paying
+	anything, just give me a credit.
+
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brcriticalsection.h"
+
+#if defined(BURGER_LINUX)
+#include "bratomic.h"
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/time.h>
+
+/***************************************
+
+	Initialize the CriticalSection
+
+***************************************/
+
+Burger::CriticalSection::CriticalSection()
+{
+	// Safety switch to verify the declaration in brlinuxtypes.h matches the real thing
+	BURGER_STATIC_ASSERT(sizeof(Burgerpthread_mutex_t)==sizeof(pthread_mutex_t));
+
+	pthread_mutex_init(reinterpret_cast<pthread_mutex_t *>(&m_Lock),NULL);
+}
+
+Burger::CriticalSection::~CriticalSection()
+{
+	pthread_mutex_destroy(reinterpret_cast<pthread_mutex_t *>(&m_Lock));
+}
+
+/***************************************
+
+	Lock the CriticalSection
+
+***************************************/
+
+void Burger::CriticalSection::Lock(void)
+{
+	pthread_mutex_lock(reinterpret_cast<pthread_mutex_t *>(&m_Lock));
+}
+
+/***************************************
+
+	Try to lock the CriticalSection
+
+***************************************/
+
+Word Burger::CriticalSection::TryLock(void)
+{
+	return pthread_mutex_trylock(reinterpret_cast<pthread_mutex_t *>(&m_Lock))!=EBUSY;
+}
+
+/***************************************
+
+	Unlock the CriticalSection
+
+***************************************/
+
+void Burger::CriticalSection::Unlock(void)
+{
+	pthread_mutex_unlock(reinterpret_cast<pthread_mutex_t *>(&m_Lock));
+}
+
+/***************************************
+
+	Initialize the semaphore
+
+***************************************/
+
+Burger::Semaphore::Semaphore(Word32 uCount) :
+	m_bInitialized(FALSE),
+	m_uCount(uCount)
+{
+	// Safety switch to verify the declaration in brlinuxtypes.h matches the real thing
+	BURGER_STATIC_ASSERT(sizeof(Burgersem_t)==sizeof(sem_t));
+
+	// Initialize the semaphore
+	if (!sem_init(reinterpret_cast<sem_t *>(&m_Semaphore),0,uCount)) {
+		m_bInitialized = TRUE;
+	}
+}
+
+/***************************************
+
+	Release the semaphore
+
+***************************************/
+
+Burger::Semaphore::~Semaphore()
+{
+	if (m_bInitialized) {
+		sem_destroy(reinterpret_cast<sem_t *>(&m_Semaphore));
+		m_bInitialized = FALSE;
+	}
+	m_uCount = 0;
+}
+
+/***************************************
+
+	Attempt to acquire the semaphore
+
+***************************************/
+
+Word BURGER_API Burger::Semaphore::TryAcquire(Word uMilliseconds)
+{
+	// Assume failure
+	Word uResult = 10;
+	if (m_bInitialized) {
+		// No wait?
+		if (!uMilliseconds) {
+			// Use the fast function
+			if (!sem_trywait(reinterpret_cast<sem_t *>(&m_Semaphore))) {
+				// Got it!
+				uResult = 0;
+			}
+		} else if (uMilliseconds==BURGER_MAXUINT) {
+
+			// Use the special function for halt until acquired
+			int iSemResult;
+			do {
+				iSemResult = sem_wait(reinterpret_cast<sem_t *>(&m_Semaphore));
+				// Got it?
+				if (!iSemResult) {
+					// Exit now
+					uResult = 0;
+					break;
+				}
+				// If the error was because of a system interrupt, try again
+			} while ((iSemResult == -1) && (errno == EINTR));
+		} else {
+			// Posix doesn't use relative time. It uses
+			// literal time.
+
+			timeval CurrentTime;
+			// Get the current time
+			gettimeofday(&CurrentTime,NULL);
+
+			// Split between seconds and MICROseconds
+			Word uSeconds = uMilliseconds/1000U;
+			uMilliseconds = (uMilliseconds - (uSeconds * 1000U)) * 1000U;
+
+			uMilliseconds += static_cast<Word>(CurrentTime.tv_usec);
+			// Handle wrap around
+			if (uMilliseconds>=1000000U) {
+				uMilliseconds-=1000000U;
+				++uSeconds;
+			}
+
+			// Seconds and MICROseconds are ready.
+			// Of course, timespec wants NANOseconds!
+
+			timespec TimeSpecTimeOut;
+			TimeSpecTimeOut.tv_sec = CurrentTime.tv_sec+static_cast<time_t>(uSeconds);
+			TimeSpecTimeOut.tv_nsec = static_cast<long>(uMilliseconds * 1000U);
+
+			// Wait for the semaphore
+			int iTest;
+			do {
+				iTest = sem_timedwait(reinterpret_cast<sem_t *>(&m_Semaphore),&TimeSpecTimeOut);
+				// Loop only on interrupts
+			} while ((iTest == -1) && (errno == EINTR));
+			// Success?
+			if (!iTest) {
+				uResult = 0;
+			}
+		}
+		// If the lock was acquired, decrement the count
+		if (!uResult) {
+			AtomicPreDecrement(&m_uCount);
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Release the semaphore
+
+***************************************/
+
+Word BURGER_API Burger::Semaphore::Release(void)
+{
+	Word uResult = 10;
+	if (m_bInitialized) {
+		// Release the count immediately, because it's
+		// possible that another thread, waiting for this semaphore,
+		// can execute before the call to sem_post()
+		// returns
+		AtomicPreIncrement(&m_uCount);
+		if (sem_post(reinterpret_cast<sem_t *>(&m_Semaphore))) {
+			// Error!!! Undo the AtomicPreIncrement()
+			AtomicPreDecrement(&m_uCount);
+		} else {
+			// A-Okay!
+			uResult = 0;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Initialize the condition variable
+
+***************************************/
+
+Burger::ConditionVariable::ConditionVariable() :
+	m_bInitialized(FALSE)
+{
+	// Safety switch to verify the declaration in brlinuxtypes.h matches the real thing
+	BURGER_STATIC_ASSERT(sizeof(Burgerpthread_cond_t)==sizeof(pthread_cond_t));
+
+	if (!pthread_cond_init(reinterpret_cast<pthread_cond_t *>(&m_ConditionVariable),NULL)) {
+		m_bInitialized = TRUE;
+	}
+}
+
+/***************************************
+
+	Release the resources
+
+***************************************/
+
+Burger::ConditionVariable::~ConditionVariable()
+{
+	if (m_bInitialized) {
+		pthread_cond_destroy(reinterpret_cast<pthread_cond_t *>(&m_ConditionVariable));
+		m_bInitialized = FALSE;
+	}
+}
+
+/***************************************
+
+	Signal a waiting thread
+
+***************************************/
+
+Word BURGER_API Burger::ConditionVariable::Signal(void)
+{
+	Word uResult = 10;
+	if (m_bInitialized) {
+		if (!pthread_cond_signal(reinterpret_cast<pthread_cond_t *>(&m_ConditionVariable))) {
+			uResult = 0;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Signal all waiting threads
+
+***************************************/
+
+Word BURGER_API Burger::ConditionVariable::Broadcast(void)
+{
+	Word uResult = 10;
+	if (m_bInitialized) {
+		if (!pthread_cond_broadcast(reinterpret_cast<pthread_cond_t *>(&m_ConditionVariable))) {
+			uResult = 0;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Wait for a signal (With timeout)
+
+***************************************/
+
+Word BURGER_API Burger::ConditionVariable::Wait(CriticalSection *pCriticalSection,Word uMilliseconds)
+{
+	Word uResult = 10;
+	if (m_bInitialized) {
+		if (uMilliseconds==BURGER_MAXUINT) {
+			if (!pthread_cond_wait(reinterpret_cast<pthread_cond_t *>(&m_ConditionVariable),reinterpret_cast<pthread_mutex_t *>(&pCriticalSection->m_Lock))) {
+				uResult = 0;
+			}
+		} else {
+
+			// Use a timeout
+
+			// Get the current time
+			timeval CurrentTime;
+			gettimeofday(&CurrentTime,NULL);
+
+			// Determine the time in the future to timeout at
+			Word uSeconds = uMilliseconds/1000;
+			// Get the remainder in NANOSECONDS
+			uMilliseconds = (uMilliseconds-(uSeconds*1000))*1000000;
+
+			// Add to the current time
+			uMilliseconds += static_cast<Word>(CurrentTime.tv_usec)*1000U;
+			// Handle wrap around
+			if (uMilliseconds>=1000000000) {
+				uMilliseconds-=1000000000;
+				++uSeconds;
+			}
+			timespec StopTimeHere;
+			StopTimeHere.tv_sec = CurrentTime.tv_sec+static_cast<time_t>(uSeconds);
+			StopTimeHere.tv_nsec = static_cast<long>(uMilliseconds);
+			int iResult;
+			do {
+				// Send the signal and possibly time out
+				iResult = pthread_cond_timedwait(reinterpret_cast<pthread_cond_t *>(&m_ConditionVariable),reinterpret_cast<pthread_mutex_t *>(&pCriticalSection->m_Lock),&StopTimeHere);
+				// Interrupted?
+			} while (iResult == EINTR);
+
+			// W00t! We're good!
+			if (!iResult) {
+				uResult = 0;
+
+			// Time out?
+			} else if (iResult == ETIMEDOUT) {
+				uResult = 1;
+			}
+			// Otherwise, leave uResult as an error
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	This code fragment calls the Run function that has permission to access the
+	members
+
+***************************************/
+
+static void *Dispatcher(void *pThis)
+{
+	Burger::Thread::Run(pThis);
+	return NULL;
+}
+
+/***************************************
+
+	Initialize a thread to a dormant state
+
+***************************************/
+
+Burger::Thread::Thread() :
+	m_pFunction(NULL),
+	m_pData(NULL),
+	m_pSemaphore(NULL),
+	m_uThreadHandle(0),
+	m_uResult(BURGER_MAXUINT)
+{
+	// Safety switch to verify the declaration in brlinuxtypes.h matches the real thing
+	BURGER_STATIC_ASSERT(sizeof(Burgerpthread_t)==sizeof(pthread_t));
+}
+
+/***************************************
+
+	Initialize a thread and begin execution
+
+***************************************/
+
+Burger::Thread::Thread(FunctionPtr pFunction,void *pData) :
+	m_pFunction(NULL),
+	m_pData(NULL),
+	m_pSemaphore(NULL),
+	m_uThreadHandle(0),
+	m_uResult(BURGER_MAXUINT)
+{
+	Start(pFunction,pData);
+}
+
+/***************************************
+
+	Release resources
+
+***************************************/
+
+Burger::Thread::~Thread()
+{
+	Kill();
+}
+
+/***************************************
+
+	Launch a new thread if one isn't already started
+
+***************************************/
+
+Word BURGER_API Burger::Thread::Start(FunctionPtr pFunction,void *pData)
+{
+	Word uResult = 10;
+	if (!m_uThreadHandle) {
+		m_pFunction = pFunction;
+		m_pData = pData;
+		// Use this temporary semaphore to force synchronization
+		Semaphore Temp(0);
+		m_pSemaphore = &Temp;
+		pthread_attr_t Attributes;
+		if (!pthread_attr_init(&Attributes)) {
+			pthread_attr_setdetachstate(&Attributes,PTHREAD_CREATE_JOINABLE);
+			pthread_t ThreadHandle;
+			if (!pthread_create(&ThreadHandle,&Attributes,Dispatcher,this)) {
+				m_uThreadHandle = static_cast<Burgerpthread_t>(ThreadHandle);
+				// Wait until the thread has started
+				Temp.Acquire();
+				// All good!
+				uResult = 0;
+			}
+			pthread_attr_destroy(&Attributes);
+		}
+		// Kill the dangling pointer
+		m_pSemaphore = NULL;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Wait until the thread has completed execution
+
+***************************************/
+
+Word BURGER_API Burger::Thread::Wait(void)
+{
+	Word uResult = 10;
+	if (m_uThreadHandle) {
+		// Wait until the thread completes execution
+		pthread_join(static_cast<pthread_t>(m_uThreadHandle),NULL);
+		// Allow restarting
+		m_uThreadHandle = 0;
+		uResult = 0;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Invoke the nuclear option to kill a thread
+	NOT RECOMMENDED!
+
+***************************************/
+
+Word BURGER_API Burger::Thread::Kill(void)
+{
+	Word uResult = 0;
+	if (m_uThreadHandle) {
+		// Cancel only this thread, a signal would take down the process
+		pthread_t ThreadHandle = static_cast<pthread_t>(m_uThreadHandle);
+		if (pthread_cancel(ThreadHandle)) {
+			uResult = 10;
+		}
+		pthread_join(ThreadHandle,NULL);
+		m_uThreadHandle = 0;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Synchronize and then execute the thread and save the result if any
+
+***************************************/
+
+void BURGER_API Burger::Thread::Run(void *pThis)
+{
+	Thread *pThread = static_cast<Thread *>(pThis);
+	pThread->m_pSemaphore->Release();
+	pThread->m_uResult = pThread->m_pFunction(pThread->m_pData);
+}
+
+#endif
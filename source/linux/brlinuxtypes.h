@@ -22,27 +22,32 @@
 /* BEGIN */
 #if defined(BURGER_LINUX) && !defined(DOXYGEN)
 
+// Sizes match glibc, WordPtr arrays keep the natural alignment
+
 struct Burgerpthread_mutex_t {
-    int volatile value;
-#if defined(BURGER_64BITCPU)
-    char __reserved[36];
+#if defined(BURGER_ARM64)
+    WordPtr m_Opaque[48 / sizeof(WordPtr)];
+#elif defined(BURGER_64BITCPU)
+    WordPtr m_Opaque[40 / sizeof(WordPtr)];
+#else
+    WordPtr m_Opaque[24 / sizeof(WordPtr)];
 #endif
 };
 
 struct Burgersem_t {
-    volatile unsigned int count;
 #if defined(BURGER_64BITCPU)
-    int __reserved[3];
+    WordPtr m_Opaque[32 / sizeof(WordPtr)];
+#else
+    WordPtr m_Opaque[16 / sizeof(WordPtr)];
 #endif
 };
 
 struct Burgerpthread_cond_t {
-    int volatile value;
-#if defined(BURGER_64BITCPU)
-    char __reserved[44];
-#endif
+    Word64 m_Opaque[48 / sizeof(Word64)];
 };
 
+typedef WordPtr Burgerpthread_t;
+
 #endif
 /* END */
 
@@ -0,0 +1,70 @@
+/***************************************
+
+	Linux version
+
+	Copyright (c) 1995-2018 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brrezfile.h"
+
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+#include "brfilename.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/***************************************
+
+	Map the entire rez file into memory as private
+	copy on write pages
+
+***************************************/
+
+Word BURGER_API Burger::RezFile::MapFile(const char *pFileName)
+{
+	UnmapFile();
+	Word uResult = TRUE;
+	Filename MyFilename(pFileName);
+	int fp = open(MyFilename.GetNative(),O_RDONLY,0);
+	if (fp!=-1) {
+		struct stat MyStat;
+		if ((fstat(fp,&MyStat)!=-1) && (MyStat.st_size>0)) {
+			WordPtr uSize = static_cast<WordPtr>(MyStat.st_size);
+			// Private mapping, so data can be fixed up in place
+			void *pData = mmap(NULL,uSize,PROT_READ|PROT_WRITE,MAP_PRIVATE,fp,0);
+			if (pData!=MAP_FAILED) {
+				m_pMappedFile = static_cast<Word8 *>(pData);
+				m_uMappedFileSize = uSize;
+				uResult = FALSE;
+			}
+		}
+		// The mapping remains valid after the close
+		close(fp);
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Release the memory mapped rez file
+
+***************************************/
+
+void BURGER_API Burger::RezFile::UnmapFile(void)
+{
+	void *pData = m_pMappedFile;
+	if (pData) {
+		munmap(pData,m_uMappedFileSize);
+		m_pMappedFile = NULL;
+		m_uMappedFileSize = 0;
+	}
+}
+
+#endif
@@ -376,6 +376,38 @@ Word BURGER_API Burger::AtomicSetIfMatch(volatile Word64 *pInput,Word64 uBefore,
 #endif
 #endif
 
+/*! ************************************
+
+	\fn Word32 Burger::AtomicGetAcquire(volatile Word32 *pInput)
+	\brief Load a 32 bit value with acquire ordering
+
+	Read a value that another thread wrote with AtomicSetRelease() or
+	one of the other atomic functions. No memory access that follows
+	this load in the program can be moved in front of it, so data
+	published before the value was stored is visible once the value
+	is seen.
+
+	\param pInput Pointer to a 32 bit aligned memory location to load from
+	\return Value that was stored in the variable
+	\sa AtomicSetRelease(volatile Word32 *,Word32)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::AtomicSetRelease(volatile Word32 *pOutput,Word32 uInput)
+	\brief Store a 32 bit value with release ordering
+
+	No memory access that comes before this store in the program can be
+	moved after it, so a thread that loads the value with
+	AtomicGetAcquire() also sees everything written before it.
+
+	\param pOutput Pointer to a 32 bit aligned memory location to store to
+	\param uInput 32 bit value to store
+	\sa AtomicGetAcquire(volatile Word32 *)
+
+***************************************/
+
 /*! ************************************
 
 	\brief Return \ref TRUE if the instruction CPUID is present
@@ -682,6 +714,121 @@ BURGER_DECLSPECNAKED Word BURGER_API Burger::IsCPUIDPresent(void)
 
 ***************************************/
 
+/*! ************************************
+
+	\fn BURGER_INLINE Word Burger::CPUID_t::HasPCLMULQDQ(void) const
+	\brief Returns non-zero if the PCLMULQDQ instruction is available
+
+	https://en.wikipedia.org/wiki/CLMUL_instruction_set
+
+	\note This structure only matters on systems with an x86 or x64 CPU
+
+	\return Non-zero if the PCLMULQDQ instruction is available, zero if not.
+	\sa void CPUID(CPUID_t *) or BURGER_INTEL
+
+***************************************/
+
+/*! ************************************
+
+	\fn BURGER_INLINE Word Burger::CPUID_t::HasPOPCNT(void) const
+	\brief Returns non-zero if the POPCNT instruction is available
+
+	http://www.felixcloutier.com/x86/POPCNT.html
+
+	\note This structure only matters on systems with an x86 or x64 CPU
+
+	\return Non-zero if the POPCNT instruction is available, zero if not.
+	\sa void CPUID(CPUID_t *) or BURGER_INTEL
+
+***************************************/
+
+/*! ************************************
+
+	\fn BURGER_INLINE Word Burger::CPUID_t::HasOSXSAVE(void) const
+	\brief Returns non-zero if the operating system uses XSAVE to save extended registers
+
+	https://en.wikipedia.org/wiki/CPUID
+
+	If this is set, XGETBV can be used to check if the operating system
+	preserves the AVX registers on a context switch.
+
+	\note This structure only matters on systems with an x86 or x64 CPU
+
+	\return Non-zero if XSAVE is enabled by the operating system, zero if not.
+	\sa void CPUID(CPUID_t *) or BURGER_INTEL
+
+***************************************/
+
+/*! ************************************
+
+	\fn BURGER_INLINE Word Burger::CPUID_t::HasAVX2(void) const
+	\brief Returns non-zero if AVX2 instructions are available
+
+	https://en.wikipedia.org/wiki/Advanced_Vector_Extensions#Advanced_Vector_Extensions_2
+
+	\note This structure only matters on systems with an x86 or x64 CPU
+
+	\return Non-zero if the instructions are available, zero if not.
+	\sa void CPUID(CPUID_t *) or BURGER_INTEL
+
+***************************************/
+
+/*! ************************************
+
+	\fn BURGER_INLINE Word Burger::CPUID_t::HasBMI1(void) const
+	\brief Returns non-zero if BMI1 instructions are available
+
+	https://en.wikipedia.org/wiki/Bit_Manipulation_Instruction_Sets
+
+	\note This structure only matters on systems with an x86 or x64 CPU
+
+	\return Non-zero if the instructions are available, zero if not.
+	\sa void CPUID(CPUID_t *) or BURGER_INTEL
+
+***************************************/
+
+/*! ************************************
+
+	\fn BURGER_INLINE Word Burger::CPUID_t::HasBMI2(void) const
+	\brief Returns non-zero if BMI2 instructions are available
+
+	https://en.wikipedia.org/wiki/Bit_Manipulation_Instruction_Sets
+
+	\note This structure only matters on systems with an x86 or x64 CPU
+
+	\return Non-zero if the instructions are available, zero if not.
+	\sa void CPUID(CPUID_t *) or BURGER_INTEL
+
+***************************************/
+
+/*! ************************************
+
+	\fn BURGER_INLINE Word Burger::CPUID_t::HasAVX512F(void) const
+	\brief Returns non-zero if AVX-512 foundation instructions are available
+
+	https://en.wikipedia.org/wiki/AVX-512
+
+	\note This structure only matters on systems with an x86 or x64 CPU
+
+	\return Non-zero if the instructions are available, zero if not.
+	\sa void CPUID(CPUID_t *) or BURGER_INTEL
+
+***************************************/
+
+/*! ************************************
+
+	\fn BURGER_INLINE Word Burger::CPUID_t::HasSHA(void) const
+	\brief Returns non-zero if SHA extension instructions are available
+
+	https://en.wikipedia.org/wiki/Intel_SHA_extensions
+
+	\note This structure only matters on systems with an x86 or x64 CPU
+
+	\return Non-zero if the instructions are available, zero if not.
+	\sa void CPUID(CPUID_t *) or BURGER_INTEL
+
+***************************************/
+
 /*! ************************************
 
 	\fn BURGER_INLINE Word Burger::CPUID_t::HasFMA4(void) const
@@ -101,6 +101,14 @@ struct CPUID_t {
 	BURGER_INLINE Word HasCMPXCHG16B(void) const BURGER_NOEXCEPT { return m_uCPUID1ECX & 0x00002000U; }
 	BURGER_INLINE Word HasF16C(void) const BURGER_NOEXCEPT { return m_uCPUID1ECX & 0x20000000U; }
 	BURGER_INLINE Word HasFMA3(void) const BURGER_NOEXCEPT { return m_uCPUID1ECX & 0x00001000U; }
+	BURGER_INLINE Word HasPCLMULQDQ(void) const BURGER_NOEXCEPT { return m_uCPUID1ECX & 0x00000002U; }
+	BURGER_INLINE Word HasPOPCNT(void) const BURGER_NOEXCEPT { return m_uCPUID1ECX & 0x00800000U; }
+	BURGER_INLINE Word HasOSXSAVE(void) const BURGER_NOEXCEPT { return m_uCPUID1ECX & 0x08000000U; }
+	BURGER_INLINE Word HasAVX2(void) const BURGER_NOEXCEPT { return m_uCPUID7EBX & 0x00000020U; }
+	BURGER_INLINE Word HasBMI1(void) const BURGER_NOEXCEPT { return m_uCPUID7EBX & 0x00000008U; }
+	BURGER_INLINE Word HasBMI2(void) const BURGER_NOEXCEPT { return m_uCPUID7EBX & 0x00000100U; }
+	BURGER_INLINE Word HasAVX512F(void) const BURGER_NOEXCEPT { return m_uCPUID7EBX & 0x00010000U; }
+	BURGER_INLINE Word HasSHA(void) const BURGER_NOEXCEPT { return m_uCPUID7EBX & 0x20000000U; }
 	BURGER_INLINE Word HasFMA4(void) const BURGER_NOEXCEPT { return m_uCPUID80000001ECX&0x00010000U; }
 	BURGER_INLINE Word HasLAHFSAHF(void) const BURGER_NOEXCEPT { return m_uCPUID80000001ECX&0x00000001U; }
 	BURGER_INLINE Word HasPrefetchW(void) const BURGER_NOEXCEPT { return m_uCPUID80000001ECX&0x00000100U; }
@@ -510,7 +518,7 @@ BURGER_INLINE Word32 AtomicPreDecrement(volatile Word32 *pInput) { return __sync
 BURGER_INLINE Word32 AtomicPostDecrement(volatile Word32 *pInput) { return __sync_fetch_and_sub(pInput,1); }
 BURGER_INLINE Word32 AtomicAdd(volatile Word32 *pInput,Word32 uValue) { return __sync_fetch_and_add(pInput,uValue); }
 BURGER_INLINE Word32 AtomicSubtract(volatile Word32 *pInput,Word32 uValue) { return __sync_fetch_and_sub(pInput,uValue); }
-BURGER_INLINE Word AtomicSetIfMatch(volatile Word32 *pInput,Word32 uBefore,Word32 uAfter) { return __sync_bool_compare_and_swap(pInput,uAfter,uBefore); }
+BURGER_INLINE Word AtomicSetIfMatch(volatile Word32 *pInput,Word32 uBefore,Word32 uAfter) { return __sync_bool_compare_and_swap(pInput,uBefore,uAfter); }
 
 BURGER_INLINE Word64 AtomicSwap(volatile Word64 *pOutput,Word64 uInput) { Word64 uTemp; do { uTemp = pOutput[0]; } while(__sync_val_compare_and_swap(pOutput,uTemp,uInput)!=uTemp); return uTemp;}
 BURGER_INLINE Word64 AtomicPreIncrement(volatile Word64 *pInput) { return __sync_add_and_fetch(pInput,1); }
@@ -519,7 +527,7 @@ BURGER_INLINE Word64 AtomicPreDecrement(volatile Word64 *pInput) { return __sync
 BURGER_INLINE Word64 AtomicPostDecrement(volatile Word64 *pInput) { return __sync_fetch_and_sub(pInput,1); }
 BURGER_INLINE Word64 AtomicAdd(volatile Word64 *pInput,Word64 uValue) { return __sync_fetch_and_add(pInput,uValue); }
 BURGER_INLINE Word64 AtomicSubtract(volatile Word64 *pInput,Word64 uValue) { return __sync_fetch_and_sub(pInput,uValue); }
-BURGER_INLINE Word AtomicSetIfMatch(volatile Word64 *pInput,Word64 uBefore,Word64 uAfter) { return __sync_bool_compare_and_swap(pInput,uAfter,uBefore); }
+BURGER_INLINE Word AtomicSetIfMatch(volatile Word64 *pInput,Word64 uBefore,Word64 uAfter) { return __sync_bool_compare_and_swap(pInput,uBefore,uAfter); }
 	
 #elif (defined(BURGER_GNUC) && (BURGER_GNUC <= 40100) && defined(BURGER_MACOSX)) || defined(DOXYGEN)
 	
@@ -565,6 +573,20 @@ BURGER_INLINE Word64 AtomicSubtract(volatile Word64 *pInput,Word64 uValue) { Wor
 BURGER_INLINE Word AtomicSetIfMatch(volatile Word64 *pInput,Word64 uBefore,Word64 uAfter) { Word uTemp = (pInput[0]==uBefore); if (uTemp) { pInput[0] = uAfter; } return uTemp; }
 #endif
 
+#endif
+
+// Loads and stores ordered against the memory accesses around them
+#if (BURGER_GNUC >= 40700) || (BURGER_CLANG >= 30100)
+BURGER_INLINE Word32 AtomicGetAcquire(volatile Word32 *pInput) { return __atomic_load_n(pInput,__ATOMIC_ACQUIRE); }
+BURGER_INLINE void AtomicSetRelease(volatile Word32 *pOutput,Word32 uInput) { __atomic_store_n(pOutput,uInput,__ATOMIC_RELEASE); }
+#elif defined(BURGER_MSVC) && defined(BURGER_INTEL)
+// x86 and x64 don't reorder loads with loads or stores with stores, only the compiler has to be stopped
+BURGER_INLINE Word32 AtomicGetAcquire(volatile Word32 *pInput) { Word32 uTemp = pInput[0]; _ReadWriteBarrier(); return uTemp; }
+BURGER_INLINE void AtomicSetRelease(volatile Word32 *pOutput,Word32 uInput) { _ReadWriteBarrier(); pOutput[0] = uInput; }
+#else
+// Use the full memory barrier of the atomic operations
+BURGER_INLINE Word32 AtomicGetAcquire(volatile Word32 *pInput) { return AtomicAdd(pInput,0); }
+BURGER_INLINE void AtomicSetRelease(volatile Word32 *pOutput,Word32 uInput) { AtomicSwap(pOutput,uInput); }
 #endif
 }
 /* END */
@@ -0,0 +1,1408 @@
+/***************************************
+
+	Dynamic bounding box tree
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brboundingboxtree.h"
+#include "brfixedpoint.h"
+#include "brfloatingpoint.h"
+#include "brglobalmemorymanager.h"
+#include "brmemoryfunctions.h"
+
+/***************************************
+
+	Internal helpers
+
+***************************************/
+
+#if !defined(DOXYGEN)
+
+// Number of bins used by the surface area heuristic in Build()
+static const Word g_uBuildBins = 16;
+
+// Recursion depth where Build() switches to splitting in half
+static const Word g_uMaxBuildDepth = 48;
+
+//
+// Simple stack of node indexes that starts on the stack
+// and only allocates memory for very deep trees
+//
+
+class BoundingBoxTreeStack {
+	Word m_Local[64];	// Initial stack
+	Word *m_pStack;		// Current stack
+	WordPtr m_uCount;	// Number of entries pushed
+	WordPtr m_uSize;	// Number of entries allocated
+public:
+	BoundingBoxTreeStack() : m_pStack(m_Local),m_uCount(0),m_uSize(BURGER_ARRAYSIZE(m_Local)) {}
+	~BoundingBoxTreeStack() { if (m_pStack!=m_Local) { Burger::Free(m_pStack); } }
+	BURGER_INLINE Word IsEmpty(void) const { return !m_uCount; }
+	BURGER_INLINE Word Pop(void) { return m_pStack[--m_uCount]; }
+	Burger::eError Push(Word uNode) {
+		if (m_uCount==m_uSize) {
+			Word *pNew = static_cast<Word *>(Burger::Alloc(sizeof(Word)*m_uSize*2));
+			if (!pNew) {
+				// Leave the stack intact so the caller can give up
+				return Burger::kErrorOutOfMemory;
+			}
+			Burger::MemoryCopy(pNew,m_pStack,sizeof(Word)*m_uSize);
+			if (m_pStack!=m_Local) {
+				Burger::Free(m_pStack);
+			}
+			m_pStack = pNew;
+			m_uSize *= 2;
+		}
+		m_pStack[m_uCount++] = uNode;
+		return Burger::kErrorNone;
+	}
+	Burger::eError Push(Word uNode1,Word uNode2) {
+		Burger::eError uResult = Push(uNode1);
+		if (!uResult) {
+			uResult = Push(uNode2);
+		}
+		return uResult;
+	}
+};
+
+static BURGER_INLINE void CombineBounds(Burger::Vector4D_t *pOutput,const Burger::Vector4D_t *pA,const Burger::Vector4D_t *pB)
+{
+	pOutput->x = Burger::Min(pA->x,pB->x);
+	pOutput->y = Burger::Min(pA->y,pB->y);
+	pOutput->z = Burger::Max(pA->z,pB->z);
+	pOutput->w = Burger::Max(pA->w,pB->w);
+}
+
+// 2D version of the surface area, which is proportional to the perimeter
+static BURGER_INLINE float GetPerimeter(const Burger::Vector4D_t *pInput)
+{
+	return ((pInput->z-pInput->x)+(pInput->w-pInput->y))*2.0f;
+}
+
+static BURGER_INLINE Word ContainsBounds(const Burger::Vector4D_t *pOuter,const Burger::Vector4D_t *pInner)
+{
+	return (pOuter->x<=pInner->x) && (pOuter->y<=pInner->y) &&
+		(pOuter->z>=pInner->z) && (pOuter->w>=pInner->w);
+}
+
+static BURGER_INLINE Word OverlapsBounds(const Burger::Vector4D_t *pA,const Burger::Vector4D_t *pB)
+{
+	return (pA->x<=pB->z) && (pA->z>=pB->x) && (pA->y<=pB->w) && (pA->w>=pB->y);
+}
+
+static BURGER_INLINE Word ContainsPoint(const Burger::Vector4D_t *pBounds,const Burger::Vector2D_t *pPoint)
+{
+	return (pPoint->x>=pBounds->x) && (pPoint->x<=pBounds->z) &&
+		(pPoint->y>=pBounds->y) && (pPoint->y<=pBounds->w);
+}
+
+static BURGER_INLINE void GetCenter(Burger::Vector2D_t *pOutput,const Burger::Vector4D_t *pInput)
+{
+	pOutput->x = (pInput->x+pInput->z)*0.5f;
+	pOutput->y = (pInput->y+pInput->w)*0.5f;
+}
+
+//
+// Slab test of a ray against a box. The ray is Start+(Delta*t)
+// where t is 0.0f to fMaxFraction. Returns TRUE and the entry
+// fraction on a hit
+//
+
+static Word BURGER_API RayHitsBounds(float *pEnter,const Burger::Vector4D_t *pBounds,const Burger::Vector2D_t *pStart,
+	const Burger::Vector2D_t *pDelta,float fMaxFraction)
+{
+	float fMin = 0.0f;
+	float fMax = fMaxFraction;
+	if (pDelta->x==0.0f) {
+		if ((pStart->x<pBounds->x) || (pStart->x>pBounds->z)) {
+			return FALSE;
+		}
+	} else {
+		float fInverse = 1.0f/pDelta->x;
+		float fT1 = (pBounds->x-pStart->x)*fInverse;
+		float fT2 = (pBounds->z-pStart->x)*fInverse;
+		if (fT1>fT2) {
+			float fTemp = fT1;
+			fT1 = fT2;
+			fT2 = fTemp;
+		}
+		fMin = Burger::Max(fMin,fT1);
+		fMax = Burger::Min(fMax,fT2);
+		if (fMin>fMax) {
+			return FALSE;
+		}
+	}
+	if (pDelta->y==0.0f) {
+		if ((pStart->y<pBounds->y) || (pStart->y>pBounds->w)) {
+			return FALSE;
+		}
+	} else {
+		float fInverse = 1.0f/pDelta->y;
+		float fT1 = (pBounds->y-pStart->y)*fInverse;
+		float fT2 = (pBounds->w-pStart->y)*fInverse;
+		if (fT1>fT2) {
+			float fTemp = fT1;
+			fT1 = fT2;
+			fT2 = fTemp;
+		}
+		fMin = Burger::Max(fMin,fT1);
+		fMax = Burger::Min(fMax,fT2);
+		if (fMin>fMax) {
+			return FALSE;
+		}
+	}
+	pEnter[0] = fMin;
+	return TRUE;
+}
+
+//
+// Test a box against a set of planes.
+// Returns 0 if outside, 1 if intersecting, 2 if fully inside
+//
+
+static Word BURGER_API ClassifyBounds(const Burger::Vector4D_t *pBounds,const Burger::Vector3D_t *pPlanes,Word uPlaneCount)
+{
+	Word uResult = 2;
+	do {
+		float fNX = pPlanes->x;
+		float fNY = pPlanes->y;
+		// Distance of the corner furthest along the normal
+		float fMax = (fNX*((fNX>=0.0f) ? pBounds->z : pBounds->x)) +
+			(fNY*((fNY>=0.0f) ? pBounds->w : pBounds->y)) + pPlanes->z;
+		if (fMax<0.0f) {
+			return 0;
+		}
+		// Distance of the corner furthest against the normal
+		float fMin = (fNX*((fNX>=0.0f) ? pBounds->x : pBounds->z)) +
+			(fNY*((fNY>=0.0f) ? pBounds->y : pBounds->w)) + pPlanes->z;
+		if (fMin<0.0f) {
+			uResult = 1;
+		}
+		++pPlanes;
+	} while (--uPlaneCount);
+	return uResult;
+}
+
+#endif
+
+/*! ************************************
+
+	\class Burger::BoundingBoxTree
+	\brief Dynamic bounding volume hierarchy of 2D boxes
+
+	GridIndexBox works well when all of the objects are about the
+	same size and the world isn't very large, because it uses a single
+	cell size for the whole grid. This class stores the same
+	Vector4D_t bounds and Word payloads in a binary tree of bounding
+	boxes instead, so it adapts to objects of any size in a world of
+	any size.
+
+	Each item is a leaf in the tree and is referred to by a proxy
+	index that remains valid until the item is removed. Leaves store
+	a box enlarged by a margin so small movements don't require the
+	tree to be changed. Leaves are inserted with the same perimeter
+	cost heuristic used by the surface area heuristic and the tree is
+	kept balanced with tree rotations.
+
+	For static data, Build(const Vector4D_t *,const Word *,WordPtr,Word *)
+	creates a tree from scratch using a binned surface area heuristic, which
+	results in faster queries than incremental insertion.
+
+	\sa GridIndexBox
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::BoundingBoxTree::Node_t
+	\brief Node in a BoundingBoxTree
+
+	Nodes are either leaves that hold an item or internal
+	nodes with exactly two children.
+
+	\sa BoundingBoxTree
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::BoundingBoxTree::Node_t::IsLeaf(void) const
+	\brief Return \ref TRUE if this node is a leaf
+
+	\return \ref TRUE if this node holds an item, \ref FALSE if it has children
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::BoundingBoxTree::Pair_t
+	\brief Pair of overlapping items
+
+	\sa QueryPairs(SimpleArray<Pair_t> *) const
+
+***************************************/
+
+/*! ************************************
+
+	\brief Initialize an empty tree
+
+	\param fMargin Amount to enlarge the bounds of each item so
+		small movements with Move(Word,const Vector4D_t *) don't
+		change the tree.
+
+***************************************/
+
+Burger::BoundingBoxTree::BoundingBoxTree(float fMargin) :
+	m_pNodes(NULL),
+	m_uRoot(cNullNode),
+	m_uNodeCount(0),
+	m_uNodeCapacity(0),
+	m_uFreeList(cNullNode),
+	m_fMargin(fMargin)
+{
+}
+
+/*! ************************************
+
+	\brief Dispose of all allocated memory
+
+	Standard destructor
+
+***************************************/
+
+Burger::BoundingBoxTree::~BoundingBoxTree()
+{
+	Free(m_pNodes);
+}
+
+/*! ************************************
+
+	\brief Ensure a minimum number of free nodes
+
+	Grow the node array so that at least uCount nodes can
+	be allocated with AllocateNode() without failing.
+
+	\param uCount Number of free nodes needed
+	\return kErrorNone on success or kErrorOutOfMemory
+
+***************************************/
+
+Burger::eError BURGER_API Burger::BoundingBoxTree::GrowNodes(Word uCount)
+{
+	Word uNeeded = m_uNodeCount+uCount;
+	if (uNeeded>m_uNodeCapacity) {
+		Word uNewCapacity = Max(m_uNodeCapacity*2,16U);
+		if (uNewCapacity<uNeeded) {
+			uNewCapacity = uNeeded;
+		}
+		Node_t *pNodes = static_cast<Node_t *>(Realloc(m_pNodes,sizeof(Node_t)*uNewCapacity));
+		if (!pNodes) {
+			return kErrorOutOfMemory;
+		}
+		m_pNodes = pNodes;
+		// Link the new nodes into the free list, in ascending order
+		Word i = uNewCapacity;
+		do {
+			--i;
+			pNodes[i].m_uParent = m_uFreeList;
+			pNodes[i].m_iHeight = -1;
+			m_uFreeList = i;
+		} while (i>m_uNodeCapacity);
+		m_uNodeCapacity = uNewCapacity;
+	}
+	return kErrorNone;
+}
+
+/*! ************************************
+
+	\brief Get a node from the free list
+
+	\note GrowNodes(Word) must have been called to ensure there
+	is a free node.
+
+	\return Index of the new node
+
+***************************************/
+
+Word BURGER_API Burger::BoundingBoxTree::AllocateNode(void)
+{
+	Word uNode = m_uFreeList;
+	BURGER_ASSERT(uNode!=cNullNode);
+	Node_t *pNode = &m_pNodes[uNode];
+	m_uFreeList = pNode->m_uParent;
+	pNode->m_uParent = cNullNode;
+	pNode->m_uChild1 = cNullNode;
+	pNode->m_uChild2 = cNullNode;
+	pNode->m_iHeight = 0;
+	pNode->m_uValue = 0;
+	++m_uNodeCount;
+	return uNode;
+}
+
+/*! ************************************
+
+	\brief Return a node to the free list
+
+	\param uNode Index of the node to release
+
+***************************************/
+
+void BURGER_API Burger::BoundingBoxTree::FreeNode(Word uNode)
+{
+	BURGER_ASSERT(uNode<m_uNodeCapacity);
+	BURGER_ASSERT(m_uNodeCount);
+	m_pNodes[uNode].m_uParent = m_uFreeList;
+	m_pNodes[uNode].m_iHeight = -1;
+	m_uFreeList = uNode;
+	--m_uNodeCount;
+}
+
+/*! ************************************
+
+	\brief Insert a leaf into the tree
+
+	Walk down the tree choosing the child that results in the
+	smallest increase in perimeter, pair the leaf with the node
+	found and rebalance the tree on the way back up.
+
+	\note A free node must be available for the new parent.
+
+	\param uLeaf Index of the leaf to insert
+
+***************************************/
+
+void BURGER_API Burger::BoundingBoxTree::InsertLeaf(Word uLeaf)
+{
+	if (m_uRoot==cNullNode) {
+		m_uRoot = uLeaf;
+		m_pNodes[uLeaf].m_uParent = cNullNode;
+		return;
+	}
+
+	// Find the best sibling for this node
+	Vector4D_t LeafBounds = m_pNodes[uLeaf].m_Bounds;
+	Word uIndex = m_uRoot;
+	while (!m_pNodes[uIndex].IsLeaf()) {
+		const Node_t *pNode = &m_pNodes[uIndex];
+		Word uChild1 = pNode->m_uChild1;
+		Word uChild2 = pNode->m_uChild2;
+
+		float fArea = GetPerimeter(&pNode->m_Bounds);
+		Vector4D_t Combined;
+		CombineBounds(&Combined,&pNode->m_Bounds,&LeafBounds);
+		float fCombinedArea = GetPerimeter(&Combined);
+
+		// Cost of creating a new parent for this node and the new leaf
+		float fCost = 2.0f*fCombinedArea;
+		// Minimum cost of pushing the leaf further down the tree
+		float fInheritanceCost = 2.0f*(fCombinedArea-fArea);
+
+		// Cost of descending into each child
+		CombineBounds(&Combined,&m_pNodes[uChild1].m_Bounds,&LeafBounds);
+		float fCost1 = GetPerimeter(&Combined)+fInheritanceCost;
+		if (!m_pNodes[uChild1].IsLeaf()) {
+			fCost1 -= GetPerimeter(&m_pNodes[uChild1].m_Bounds);
+		}
+		CombineBounds(&Combined,&m_pNodes[uChild2].m_Bounds,&LeafBounds);
+		float fCost2 = GetPerimeter(&Combined)+fInheritanceCost;
+		if (!m_pNodes[uChild2].IsLeaf()) {
+			fCost2 -= GetPerimeter(&m_pNodes[uChild2].m_Bounds);
+		}
+
+		// Stop here?
+		if ((fCost<fCost1) && (fCost<fCost2)) {
+			break;
+		}
+		uIndex = (fCost1<fCost2) ? uChild1 : uChild2;
+	}
+
+	// Create a new parent for the sibling and the leaf
+	Word uSibling = uIndex;
+	Word uOldParent = m_pNodes[uSibling].m_uParent;
+	Word uNewParent = AllocateNode();
+	Node_t *pNewParent = &m_pNodes[uNewParent];
+	pNewParent->m_uParent = uOldParent;
+	CombineBounds(&pNewParent->m_Bounds,&LeafBounds,&m_pNodes[uSibling].m_Bounds);
+	pNewParent->m_iHeight = m_pNodes[uSibling].m_iHeight+1;
+	pNewParent->m_uChild1 = uSibling;
+	pNewParent->m_uChild2 = uLeaf;
+	m_pNodes[uSibling].m_uParent = uNewParent;
+	m_pNodes[uLeaf].m_uParent = uNewParent;
+
+	if (uOldParent!=cNullNode) {
+		// The sibling was not the root
+		if (m_pNodes[uOldParent].m_uChild1==uSibling) {
+			m_pNodes[uOldParent].m_uChild1 = uNewParent;
+		} else {
+			m_pNodes[uOldParent].m_uChild2 = uNewParent;
+		}
+	} else {
+		// The sibling was the root
+		m_uRoot = uNewParent;
+	}
+
+	// Walk back up the tree fixing heights and bounds
+	uIndex = m_pNodes[uLeaf].m_uParent;
+	while (uIndex!=cNullNode) {
+		uIndex = Balance(uIndex);
+		Node_t *pNode = &m_pNodes[uIndex];
+		const Node_t *pChild1 = &m_pNodes[pNode->m_uChild1];
+		const Node_t *pChild2 = &m_pNodes[pNode->m_uChild2];
+		pNode->m_iHeight = 1+Max(pChild1->m_iHeight,pChild2->m_iHeight);
+		CombineBounds(&pNode->m_Bounds,&pChild1->m_Bounds,&pChild2->m_Bounds);
+		uIndex = pNode->m_uParent;
+	}
+}
+
+/*! ************************************
+
+	\brief Remove a leaf from the tree
+
+	The leaf's parent is released and the leaf's sibling takes
+	its place. The tree is rebalanced on the way back to the root.
+	The leaf node itself is not released.
+
+	\param uLeaf Index of the leaf to remove
+
+***************************************/
+
+void BURGER_API Burger::BoundingBoxTree::RemoveLeaf(Word uLeaf)
+{
+	if (uLeaf==m_uRoot) {
+		m_uRoot = cNullNode;
+		return;
+	}
+
+	Word uParent = m_pNodes[uLeaf].m_uParent;
+	Word uGrandParent = m_pNodes[uParent].m_uParent;
+	Word uSibling = (m_pNodes[uParent].m_uChild1==uLeaf) ? m_pNodes[uParent].m_uChild2 : m_pNodes[uParent].m_uChild1;
+
+	if (uGrandParent!=cNullNode) {
+		// Destroy the parent and connect the sibling to the grand parent
+		if (m_pNodes[uGrandParent].m_uChild1==uParent) {
+			m_pNodes[uGrandParent].m_uChild1 = uSibling;
+		} else {
+			m_pNodes[uGrandParent].m_uChild2 = uSibling;
+		}
+		m_pNodes[uSibling].m_uParent = uGrandParent;
+		FreeNode(uParent);
+
+		// Adjust the ancestor bounds
+		Word uIndex = uGrandParent;
+		while (uIndex!=cNullNode) {
+			uIndex = Balance(uIndex);
+			Node_t *pNode = &m_pNodes[uIndex];
+			const Node_t *pChild1 = &m_pNodes[pNode->m_uChild1];
+			const Node_t *pChild2 = &m_pNodes[pNode->m_uChild2];
+			CombineBounds(&pNode->m_Bounds,&pChild1->m_Bounds,&pChild2->m_Bounds);
+			pNode->m_iHeight = 1+Max(pChild1->m_iHeight,pChild2->m_iHeight);
+			uIndex = pNode->m_uParent;
+		}
+	} else {
+		m_uRoot = uSibling;
+		m_pNodes[uSibling].m_uParent = cNullNode;
+		FreeNode(uParent);
+	}
+}
+
+/*! ************************************
+
+	\brief Perform a tree rotation if a node is out of balance
+
+	If the heights of the two children differ by more than one,
+	the taller child is rotated up to replace this node.
+
+	\param uNodeA Index of the node to balance
+	\return Index of the node that is now at uNodeA's position
+
+***************************************/
+
+Word BURGER_API Burger::BoundingBoxTree::Balance(Word uNodeA)
+{
+	Node_t *pA = &m_pNodes[uNodeA];
+	if (pA->IsLeaf() || (pA->m_iHeight<2)) {
+		return uNodeA;
+	}
+
+	Word uNodeB = pA->m_uChild1;
+	Word uNodeC = pA->m_uChild2;
+	Node_t *pB = &m_pNodes[uNodeB];
+	Node_t *pC = &m_pNodes[uNodeC];
+	Int iBalance = pC->m_iHeight-pB->m_iHeight;
+
+	// Rotate C up
+	if (iBalance>1) {
+		Word uNodeF = pC->m_uChild1;
+		Word uNodeG = pC->m_uChild2;
+		Node_t *pF = &m_pNodes[uNodeF];
+		Node_t *pG = &m_pNodes[uNodeG];
+
+		// Swap A and C
+		pC->m_uChild1 = uNodeA;
+		pC->m_uParent = pA->m_uParent;
+		pA->m_uParent = uNodeC;
+
+		// A's old parent should point to C
+		if (pC->m_uParent!=cNullNode) {
+			if (m_pNodes[pC->m_uParent].m_uChild1==uNodeA) {
+				m_pNodes[pC->m_uParent].m_uChild1 = uNodeC;
+			} else {
+				m_pNodes[pC->m_uParent].m_uChild2 = uNodeC;
+			}
+		} else {
+			m_uRoot = uNodeC;
+		}
+
+		// Rotate
+		if (pF->m_iHeight>pG->m_iHeight) {
+			pC->m_uChild2 = uNodeF;
+			pA->m_uChild2 = uNodeG;
+			pG->m_uParent = uNodeA;
+			CombineBounds(&pA->m_Bounds,&pB->m_Bounds,&pG->m_Bounds);
+			CombineBounds(&pC->m_Bounds,&pA->m_Bounds,&pF->m_Bounds);
+			pA->m_iHeight = 1+Max(pB->m_iHeight,pG->m_iHeight);
+			pC->m_iHeight = 1+Max(pA->m_iHeight,pF->m_iHeight);
+		} else {
+			pC->m_uChild2 = uNodeG;
+			pA->m_uChild2 = uNodeF;
+			pF->m_uParent = uNodeA;
+			CombineBounds(&pA->m_Bounds,&pB->m_Bounds,&pF->m_Bounds);
+			CombineBounds(&pC->m_Bounds,&pA->m_Bounds,&pG->m_Bounds);
+			pA->m_iHeight = 1+Max(pB->m_iHeight,pF->m_iHeight);
+			pC->m_iHeight = 1+Max(pA->m_iHeight,pG->m_iHeight);
+		}
+		return uNodeC;
+	}
+
+	// Rotate B up
+	if (iBalance<-1) {
+		Word uNodeD = pB->m_uChild1;
+		Word uNodeE = pB->m_uChild2;
+		Node_t *pD = &m_pNodes[uNodeD];
+		Node_t *pE = &m_pNodes[uNodeE];
+
+		// Swap A and B
+		pB->m_uChild1 = uNodeA;
+		pB->m_uParent = pA->m_uParent;
+		pA->m_uParent = uNodeB;
+
+		// A's old parent should point to B
+		if (pB->m_uParent!=cNullNode) {
+			if (m_pNodes[pB->m_uParent].m_uChild1==uNodeA) {
+				m_pNodes[pB->m_uParent].m_uChild1 = uNodeB;
+			} else {
+				m_pNodes[pB->m_uParent].m_uChild2 = uNodeB;
+			}
+		} else {
+			m_uRoot = uNodeB;
+		}
+
+		// Rotate
+		if (pD->m_iHeight>pE->m_iHeight) {
+			pB->m_uChild2 = uNodeD;
+			pA->m_uChild1 = uNodeE;
+			pE->m_uParent = uNodeA;
+			CombineBounds(&pA->m_Bounds,&pC->m_Bounds,&pE->m_Bounds);
+			CombineBounds(&pB->m_Bounds,&pA->m_Bounds,&pD->m_Bounds);
+			pA->m_iHeight = 1+Max(pC->m_iHeight,pE->m_iHeight);
+			pB->m_iHeight = 1+Max(pA->m_iHeight,pD->m_iHeight);
+		} else {
+			pB->m_uChild2 = uNodeE;
+			pA->m_uChild1 = uNodeD;
+			pD->m_uParent = uNodeA;
+			CombineBounds(&pA->m_Bounds,&pC->m_Bounds,&pD->m_Bounds);
+			CombineBounds(&pB->m_Bounds,&pA->m_Bounds,&pE->m_Bounds);
+			pA->m_iHeight = 1+Max(pC->m_iHeight,pD->m_iHeight);
+			pB->m_iHeight = 1+Max(pA->m_iHeight,pE->m_iHeight);
+		}
+		return uNodeB;
+	}
+	return uNodeA;
+}
+
+/*! ************************************
+
+	\brief Recalculate the bounds of all ancestors of a node
+
+	Unlike InsertLeaf(Word), no rotations are performed.
+
+	\param uNode Index of the first node to recalculate
+
+***************************************/
+
+void BURGER_API Burger::BoundingBoxTree::RefitParents(Word uNode)
+{
+	while (uNode!=cNullNode) {
+		Node_t *pNode = &m_pNodes[uNode];
+		const Node_t *pChild1 = &m_pNodes[pNode->m_uChild1];
+		const Node_t *pChild2 = &m_pNodes[pNode->m_uChild2];
+		CombineBounds(&pNode->m_Bounds,&pChild1->m_Bounds,&pChild2->m_Bounds);
+		pNode->m_iHeight = 1+Max(pChild1->m_iHeight,pChild2->m_iHeight);
+		uNode = pNode->m_uParent;
+	}
+}
+
+/*! ************************************
+
+	\brief Remove all items from the tree
+
+	All proxies are invalidated, but the memory for the nodes
+	is retained for reuse.
+
+***************************************/
+
+void BURGER_API Burger::BoundingBoxTree::Clear(void)
+{
+	m_uRoot = cNullNode;
+	m_uNodeCount = 0;
+	m_uFreeList = cNullNode;
+	Word i = m_uNodeCapacity;
+	if (i) {
+		Node_t *pNodes = m_pNodes;
+		do {
+			--i;
+			pNodes[i].m_uParent = m_uFreeList;
+			pNodes[i].m_iHeight = -1;
+			m_uFreeList = i;
+		} while (i);
+	}
+}
+
+/*! ************************************
+
+	\brief Insert an item into the tree
+
+	\param pBounds Pointer to the bounds of the item
+	\param uValue Payload of the item
+	\return Proxy index of the item or \ref cNullNode if out of memory
+
+	\sa Remove(Word) or Move(Word,const Vector4D_t *)
+
+***************************************/
+
+Word BURGER_API Burger::BoundingBoxTree::Insert(const Vector4D_t *pBounds,Word uValue)
+{
+	// A leaf and its new parent
+	if (GrowNodes(2)) {
+		return cNullNode;
+	}
+	Word uProxy = AllocateNode();
+	Node_t *pNode = &m_pNodes[uProxy];
+	float fMargin = m_fMargin;
+	pNode->m_ItemBounds = pBounds[0];
+	pNode->m_Bounds.x = pBounds->x-fMargin;
+	pNode->m_Bounds.y = pBounds->y-fMargin;
+	pNode->m_Bounds.z = pBounds->z+fMargin;
+	pNode->m_Bounds.w = pBounds->w+fMargin;
+	pNode->m_uValue = uValue;
+	InsertLeaf(uProxy);
+	return uProxy;
+}
+
+/*! ************************************
+
+	\brief Remove an item from the tree
+
+	\param uProxy Proxy index returned by Insert(const Vector4D_t *,Word)
+
+	\sa Insert(const Vector4D_t *,Word)
+
+***************************************/
+
+void BURGER_API Burger::BoundingBoxTree::Remove(Word uProxy)
+{
+	BURGER_ASSERT(uProxy<m_uNodeCapacity);
+	BURGER_ASSERT(m_pNodes[uProxy].IsLeaf());
+	RemoveLeaf(uProxy);
+	FreeNode(uProxy);
+}
+
+/*! ************************************
+
+	\brief Update the bounds of an item
+
+	If the new bounds are still inside the enlarged bounds stored
+	in the tree, only the item's bounds are updated. Otherwise the
+	leaf is removed and reinserted.
+
+	\param uProxy Proxy index returned by Insert(const Vector4D_t *,Word)
+	\param pBounds Pointer to the new bounds of the item
+	\return \ref TRUE if the leaf was reinserted
+
+	\sa Refit(Word,const Vector4D_t *)
+
+***************************************/
+
+Word BURGER_API Burger::BoundingBoxTree::Move(Word uProxy,const Vector4D_t *pBounds)
+{
+	BURGER_ASSERT(uProxy<m_uNodeCapacity);
+	BURGER_ASSERT(m_pNodes[uProxy].IsLeaf());
+	Node_t *pNode = &m_pNodes[uProxy];
+	pNode->m_ItemBounds = pBounds[0];
+	if (ContainsBounds(&pNode->m_Bounds,pBounds)) {
+		return FALSE;
+	}
+	RemoveLeaf(uProxy);
+	float fMargin = m_fMargin;
+	pNode->m_Bounds.x = pBounds->x-fMargin;
+	pNode->m_Bounds.y = pBounds->y-fMargin;
+	pNode->m_Bounds.z = pBounds->z+fMargin;
+	pNode->m_Bounds.w = pBounds->w+fMargin;
+	// RemoveLeaf() released a node, so one is available for InsertLeaf()
+	InsertLeaf(uProxy);
+	return TRUE;
+}
+
+/*! ************************************
+
+	\brief Update the bounds of an item in place
+
+	Set the new bounds of the item and enlarge the bounds of all
+	of its ancestors without changing the structure of the tree.
+	This is faster than Move(Word,const Vector4D_t *) for items that
+	move in a coherent fashion, such as animated objects, but the
+	quality of the tree will degrade if the items move far from
+	where they were inserted.
+
+	\param uProxy Proxy index returned by Insert(const Vector4D_t *,Word)
+	\param pBounds Pointer to the new bounds of the item
+
+	\sa Move(Word,const Vector4D_t *)
+
+***************************************/
+
+void BURGER_API Burger::BoundingBoxTree::Refit(Word uProxy,const Vector4D_t *pBounds)
+{
+	BURGER_ASSERT(uProxy<m_uNodeCapacity);
+	BURGER_ASSERT(m_pNodes[uProxy].IsLeaf());
+	Node_t *pNode = &m_pNodes[uProxy];
+	float fMargin = m_fMargin;
+	pNode->m_ItemBounds = pBounds[0];
+	pNode->m_Bounds.x = pBounds->x-fMargin;
+	pNode->m_Bounds.y = pBounds->y-fMargin;
+	pNode->m_Bounds.z = pBounds->z+fMargin;
+	pNode->m_Bounds.w = pBounds->w+fMargin;
+	RefitParents(pNode->m_uParent);
+}
+
+/*! ************************************
+
+	\brief Build a subtree from a range of leaves
+
+	The leaves are split with a binned surface area heuristic along
+	the axis with the largest spread of centers. If the tree gets too
+	deep or all of the centers are the same, the leaves are split
+	in half to bound the recursion.
+
+	\param pLeaves Pointer to the array of leaf indexes, will be reordered
+	\param uCount Number of leaves in the array
+	\param uDepth Current recursion depth
+	\return Index of the root of the subtree
+
+***************************************/
+
+Word BURGER_API Burger::BoundingBoxTree::BuildRange(Word *pLeaves,WordPtr uCount,Word uDepth)
+{
+	if (uCount==1) {
+		return pLeaves[0];
+	}
+
+	// Get the bounds of the centers
+	Vector2D_t Center;
+	GetCenter(&Center,&m_pNodes[pLeaves[0]].m_Bounds);
+	Vector4D_t CenterBounds;
+	CenterBounds.x = Center.x;
+	CenterBounds.y = Center.y;
+	CenterBounds.z = Center.x;
+	CenterBounds.w = Center.y;
+	WordPtr i = 1;
+	do {
+		GetCenter(&Center,&m_pNodes[pLeaves[i]].m_Bounds);
+		CenterBounds.x = Min(CenterBounds.x,Center.x);
+		CenterBounds.y = Min(CenterBounds.y,Center.y);
+		CenterBounds.z = Max(CenterBounds.z,Center.x);
+		CenterBounds.w = Max(CenterBounds.w,Center.y);
+	} while (++i<uCount);
+
+	// Split on the longest axis
+	Word bYAxis = (CenterBounds.w-CenterBounds.y) > (CenterBounds.z-CenterBounds.x);
+	float fMin = bYAxis ? CenterBounds.y : CenterBounds.x;
+	float fExtent = bYAxis ? (CenterBounds.w-CenterBounds.y) : (CenterBounds.z-CenterBounds.x);
+
+	// If no split is found, split in half to keep the recursion bounded
+	WordPtr uLeftCount = uCount>>1U;
+	if ((fExtent>0.0f) && (uDepth<g_uMaxBuildDepth)) {
+		// Bin the leaves by their centers
+		Vector4D_t BinBounds[g_uBuildBins];
+		WordPtr BinCounts[g_uBuildBins];
+		Word uBin = 0;
+		do {
+			BinCounts[uBin] = 0;
+		} while (++uBin<g_uBuildBins);
+
+		float fScale = static_cast<float>(static_cast<int>(g_uBuildBins))/fExtent;
+		i = 0;
+		do {
+			const Vector4D_t *pBounds = &m_pNodes[pLeaves[i]].m_Bounds;
+			GetCenter(&Center,pBounds);
+			uBin = static_cast<Word>(static_cast<int>(((bYAxis ? Center.y : Center.x)-fMin)*fScale));
+			if (uBin>=g_uBuildBins) {
+				uBin = g_uBuildBins-1;
+			}
+			if (!BinCounts[uBin]) {
+				BinBounds[uBin] = pBounds[0];
+			} else {
+				CombineBounds(&BinBounds[uBin],&BinBounds[uBin],pBounds);
+			}
+			++BinCounts[uBin];
+		} while (++i<uCount);
+
+		// Sweep from the right to get the cost of the right side of each split
+		float RightCosts[g_uBuildBins];
+		Vector4D_t Accumulated;
+		Accumulated.Zero();
+		WordPtr uAccumulated = 0;
+		uBin = g_uBuildBins-1;
+		do {
+			if (BinCounts[uBin]) {
+				if (!uAccumulated) {
+					Accumulated = BinBounds[uBin];
+				} else {
+					CombineBounds(&Accumulated,&Accumulated,&BinBounds[uBin]);
+				}
+				uAccumulated += BinCounts[uBin];
+			}
+			RightCosts[uBin] = uAccumulated ? GetPerimeter(&Accumulated)*static_cast<float>(static_cast<IntPtr>(uAccumulated)) : 0.0f;
+		} while (--uBin);
+
+		// Sweep from the left to find the cheapest split
+		float fBestCost = 0.0f;
+		Word uBestSplit = 0;
+		uAccumulated = 0;
+		uBin = 0;
+		do {
+			if (BinCounts[uBin]) {
+				if (!uAccumulated) {
+					Accumulated = BinBounds[uBin];
+				} else {
+					CombineBounds(&Accumulated,&Accumulated,&BinBounds[uBin]);
+				}
+				uAccumulated += BinCounts[uBin];
+			}
+			// Only splits with leaves on both sides count
+			if (uAccumulated && (uAccumulated<uCount)) {
+				float fCost = (GetPerimeter(&Accumulated)*static_cast<float>(static_cast<IntPtr>(uAccumulated)))+RightCosts[uBin+1];
+				if (!uBestSplit || (fCost<fBestCost)) {
+					fBestCost = fCost;
+					uBestSplit = uBin+1;
+				}
+			}
+		} while (++uBin<(g_uBuildBins-1));
+
+		if (uBestSplit) {
+			// Partition the leaves, bins below uBestSplit go to the left
+			WordPtr uLeft = 0;
+			WordPtr uRight = uCount;
+			while (uLeft<uRight) {
+				GetCenter(&Center,&m_pNodes[pLeaves[uLeft]].m_Bounds);
+				uBin = static_cast<Word>(static_cast<int>(((bYAxis ? Center.y : Center.x)-fMin)*fScale));
+				if (uBin<uBestSplit) {
+					++uLeft;
+				} else {
+					--uRight;
+					Word uTemp = pLeaves[uLeft];
+					pLeaves[uLeft] = pLeaves[uRight];
+					pLeaves[uRight] = uTemp;
+				}
+			}
+			uLeftCount = uLeft;
+		}
+	}
+
+	// Create the parent of both halves
+	Word uNode = AllocateNode();
+	Word uChild1 = BuildRange(pLeaves,uLeftCount,uDepth+1);
+	Word uChild2 = BuildRange(pLeaves+uLeftCount,uCount-uLeftCount,uDepth+1);
+	Node_t *pNode = &m_pNodes[uNode];
+	pNode->m_uChild1 = uChild1;
+	pNode->m_uChild2 = uChild2;
+	m_pNodes[uChild1].m_uParent = uNode;
+	m_pNodes[uChild2].m_uParent = uNode;
+	CombineBounds(&pNode->m_Bounds,&m_pNodes[uChild1].m_Bounds,&m_pNodes[uChild2].m_Bounds);
+	pNode->m_iHeight = 1+Max(m_pNodes[uChild1].m_iHeight,m_pNodes[uChild2].m_iHeight);
+	return uNode;
+}
+
+/*! ************************************
+
+	\brief Bulk build the tree from an array of items
+
+	All items currently in the tree are removed and a new tree is
+	built top down using a binned surface area heuristic. This creates
+	a higher quality tree than inserting the items one at a time and
+	is much faster.
+
+	Items can still be inserted, moved and removed afterwards.
+
+	\param pBounds Pointer to an array of bounds for each item
+	\param pValues Pointer to an array of payloads, one per item
+	\param uCount Number of items
+	\param pProxies Pointer to an array to receive the proxy index of each item, can be \ref NULL
+	\return kErrorNone on success or kErrorOutOfMemory
+
+	\sa Insert(const Vector4D_t *,Word) or Clear(void)
+
+***************************************/
+
+Burger::eError BURGER_API Burger::BoundingBoxTree::Build(const Vector4D_t *pBounds,const Word *pValues,WordPtr uCount,Word *pProxies)
+{
+	Clear();
+	if (!uCount) {
+		return kErrorNone;
+	}
+	BURGER_ASSERT(uCount<(BURGER_MAXUINT>>1U));
+	// A binary tree with uCount leaves has uCount-1 internal nodes
+	eError uResult = GrowNodes(static_cast<Word>(uCount*2-1));
+	if (!uResult) {
+		Word *pLeaves = static_cast<Word *>(Alloc(sizeof(Word)*uCount));
+		if (!pLeaves) {
+			uResult = kErrorOutOfMemory;
+		} else {
+			float fMargin = m_fMargin;
+			WordPtr i = 0;
+			do {
+				Word uProxy = AllocateNode();
+				Node_t *pNode = &m_pNodes[uProxy];
+				pNode->m_ItemBounds = pBounds[i];
+				pNode->m_Bounds.x = pBounds[i].x-fMargin;
+				pNode->m_Bounds.y = pBounds[i].y-fMargin;
+				pNode->m_Bounds.z = pBounds[i].z+fMargin;
+				pNode->m_Bounds.w = pBounds[i].w+fMargin;
+				pNode->m_uValue = pValues[i];
+				pLeaves[i] = uProxy;
+				if (pProxies) {
+					pProxies[i] = uProxy;
+				}
+			} while (++i<uCount);
+			m_uRoot = BuildRange(pLeaves,uCount,0);
+			m_pNodes[m_uRoot].m_uParent = cNullNode;
+			Free(pLeaves);
+		}
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\fn Word Burger::BoundingBoxTree::GetValue(Word uProxy) const
+	\brief Return the payload of an item
+
+	\param uProxy Proxy index of the item
+	\return Payload passed to Insert(const Vector4D_t *,Word)
+
+***************************************/
+
+/*! ************************************
+
+	\fn const Vector4D_t *Burger::BoundingBoxTree::GetBounds(Word uProxy) const
+	\brief Return the bounds of an item
+
+	\param uProxy Proxy index of the item
+	\return Pointer to the exact bounds of the item
+
+***************************************/
+
+/*! ************************************
+
+	\fn const Vector4D_t *Burger::BoundingBoxTree::GetFatBounds(Word uProxy) const
+	\brief Return the enlarged bounds of an item
+
+	\param uProxy Proxy index of the item
+	\return Pointer to the bounds of the item as stored in the tree
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::BoundingBoxTree::GetRoot(void) const
+	\brief Return the index of the root node
+
+	\return Index of the root node or \ref cNullNode if the tree is empty
+
+***************************************/
+
+/*! ************************************
+
+	\fn const Node_t *Burger::BoundingBoxTree::GetNode(Word uNode) const
+	\brief Return a pointer to a node
+
+	\param uNode Index of the node
+	\return Pointer to the node
+
+***************************************/
+
+/*! ************************************
+
+	\fn Int Burger::BoundingBoxTree::GetHeight(void) const
+	\brief Return the height of the tree
+
+	\return Height of the tree, zero if empty or only a single item
+
+***************************************/
+
+/*! ************************************
+
+	\fn float Burger::BoundingBoxTree::GetMargin(void) const
+	\brief Return the margin used to enlarge leaves
+
+	\return Margin passed to the constructor
+
+***************************************/
+
+/*! ************************************
+
+	\brief Return a metric of the quality of the tree
+
+	The sum of the perimeters of all the nodes divided by the
+	perimeter of the root. Smaller is better.
+
+	\return Ratio of all node perimeters to the root's perimeter
+
+***************************************/
+
+float BURGER_API Burger::BoundingBoxTree::GetAreaRatio(void) const
+{
+	if (m_uRoot==cNullNode) {
+		return 0.0f;
+	}
+	float fRootArea = GetPerimeter(&m_pNodes[m_uRoot].m_Bounds);
+	float fTotalArea = 0.0f;
+	Word i = m_uNodeCapacity;
+	const Node_t *pNode = m_pNodes;
+	do {
+		if (pNode->m_iHeight>=0) {
+			fTotalArea += GetPerimeter(&pNode->m_Bounds);
+		}
+		++pNode;
+	} while (--i);
+	if (fRootArea<=0.0f) {
+		return 0.0f;
+	}
+	return fTotalArea/fRootArea;
+}
+
+/*! ************************************
+
+	\brief Find all items that contain a point
+
+	\note pOutput is cleared before the query is performed
+
+	\param pOutput Pointer to the array to receive the proxy indexes
+	\param pPoint Pointer to the point to test
+	\return kErrorNone on success or kErrorOutOfMemory if the query was stopped early
+
+***************************************/
+
+Burger::eError BURGER_API Burger::BoundingBoxTree::QueryPoint(SimpleArray<Word> *pOutput,const Vector2D_t *pPoint) const
+{
+	pOutput->clear();
+	eError uResult = kErrorNone;
+	if (m_uRoot!=cNullNode) {
+		BoundingBoxTreeStack Stack;
+		Stack.Push(m_uRoot);
+		do {
+			Word uNode = Stack.Pop();
+			const Node_t *pNode = &m_pNodes[uNode];
+			if (ContainsPoint(&pNode->m_Bounds,pPoint)) {
+				if (pNode->IsLeaf()) {
+					if (ContainsPoint(&pNode->m_ItemBounds,pPoint)) {
+						pOutput->push_back(uNode);
+					}
+				} else {
+					uResult = Stack.Push(pNode->m_uChild1,pNode->m_uChild2);
+				}
+			}
+		} while (!uResult && !Stack.IsEmpty());
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Find all items that overlap a box
+
+	\note pOutput is cleared before the query is performed
+
+	\param pOutput Pointer to the array to receive the proxy indexes
+	\param pBounds Pointer to the box to test
+	\return kErrorNone on success or kErrorOutOfMemory if the query was stopped early
+
+***************************************/
+
+Burger::eError BURGER_API Burger::BoundingBoxTree::QueryBox(SimpleArray<Word> *pOutput,const Vector4D_t *pBounds) const
+{
+	pOutput->clear();
+	eError uResult = kErrorNone;
+	if (m_uRoot!=cNullNode) {
+		BoundingBoxTreeStack Stack;
+		Stack.Push(m_uRoot);
+		do {
+			Word uNode = Stack.Pop();
+			const Node_t *pNode = &m_pNodes[uNode];
+			if (OverlapsBounds(&pNode->m_Bounds,pBounds)) {
+				if (pNode->IsLeaf()) {
+					if (OverlapsBounds(&pNode->m_ItemBounds,pBounds)) {
+						pOutput->push_back(uNode);
+					}
+				} else {
+					uResult = Stack.Push(pNode->m_uChild1,pNode->m_uChild2);
+				}
+			}
+		} while (!uResult && !Stack.IsEmpty());
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Find all items inside of a convex area
+
+	The area is the intersection of a set of half planes. Each
+	plane is stored as a Vector3D_t where x and y are the normal
+	and z is the distance, so a point is inside if
+	(x*PointX)+(y*PointY)+z is greater than or equal to zero. This
+	is how the 2D view frustum of a camera can be tested.
+
+	Subtrees that are completely inside of all planes are
+	accepted without further testing.
+
+	\note pOutput is cleared before the query is performed
+
+	\param pOutput Pointer to the array to receive the proxy indexes
+	\param pPlanes Pointer to an array of planes
+	\param uPlaneCount Number of planes
+	\return kErrorNone on success or kErrorOutOfMemory if the query was stopped early
+
+***************************************/
+
+Burger::eError BURGER_API Burger::BoundingBoxTree::QueryFrustum(SimpleArray<Word> *pOutput,const Vector3D_t *pPlanes,Word uPlaneCount) const
+{
+	pOutput->clear();
+	eError uResult = kErrorNone;
+	if (m_uRoot!=cNullNode) {
+		if (!uPlaneCount) {
+			// Everything is inside
+			const Node_t *pNode = m_pNodes;
+			Word i = 0;
+			do {
+				if (!pNode->m_iHeight) {
+					pOutput->push_back(i);
+				}
+				++pNode;
+			} while (++i<m_uNodeCapacity);
+			return kErrorNone;
+		}
+		// The high bit marks a subtree that was found to be completely inside
+		const Word uInside = 0x80000000U;
+		BoundingBoxTreeStack Stack;
+		Stack.Push(m_uRoot);
+		do {
+			Word uNode = Stack.Pop();
+			const Node_t *pNode = &m_pNodes[uNode&(~uInside)];
+			if (uNode&uInside) {
+				if (pNode->IsLeaf()) {
+					pOutput->push_back(uNode&(~uInside));
+				} else {
+					uResult = Stack.Push(pNode->m_uChild1|uInside,pNode->m_uChild2|uInside);
+				}
+			} else {
+				Word uClass = ClassifyBounds(&pNode->m_Bounds,pPlanes,uPlaneCount);
+				if (uClass) {
+					if (pNode->IsLeaf()) {
+						if ((uClass==2) || ClassifyBounds(&pNode->m_ItemBounds,pPlanes,uPlaneCount)) {
+							pOutput->push_back(uNode);
+						}
+					} else {
+						Word uFlag = (uClass==2) ? uInside : 0;
+						uResult = Stack.Push(pNode->m_uChild1|uFlag,pNode->m_uChild2|uFlag);
+					}
+				}
+			}
+		} while (!uResult && !Stack.IsEmpty());
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Find all pairs of items that overlap each other
+
+	Each pair is reported once, with the lower proxy index first.
+
+	\note pOutput is cleared before the query is performed
+
+	\param pOutput Pointer to the array to receive the pairs
+	\return kErrorNone on success or kErrorOutOfMemory if the query was stopped early
+
+***************************************/
+
+Burger::eError BURGER_API Burger::BoundingBoxTree::QueryPairs(SimpleArray<Pair_t> *pOutput) const
+{
+	pOutput->clear();
+	eError uResult = kErrorNone;
+	if (m_uRoot!=cNullNode) {
+		BoundingBoxTreeStack Stack;
+		Word uLeaf = 0;
+		do {
+			const Node_t *pLeaf = &m_pNodes[uLeaf];
+			// Only test leaves
+			if (!pLeaf->m_iHeight) {
+				const Vector4D_t *pBounds = &pLeaf->m_ItemBounds;
+				Stack.Push(m_uRoot);
+				do {
+					Word uNode = Stack.Pop();
+					const Node_t *pNode = &m_pNodes[uNode];
+					if (OverlapsBounds(&pNode->m_Bounds,pBounds)) {
+						if (pNode->IsLeaf()) {
+							// Only report each pair once
+							if ((uNode>uLeaf) && OverlapsBounds(&pNode->m_ItemBounds,pBounds)) {
+								Pair_t Pair;
+								Pair.m_uProxy1 = uLeaf;
+								Pair.m_uProxy2 = uNode;
+								pOutput->push_back(Pair);
+							}
+						} else {
+							uResult = Stack.Push(pNode->m_uChild1,pNode->m_uChild2);
+						}
+					}
+				} while (!uResult && !Stack.IsEmpty());
+			}
+		} while (!uResult && (++uLeaf<m_uNodeCapacity));
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Find the first item hit by a ray
+
+	Cast a ray from pStart to pEnd and return the item whose
+	bounds are entered first. Children are visited closest first
+	and any subtree further away than the closest hit so far is
+	skipped.
+
+	\param pProxy Pointer to receive the proxy index of the item hit or \ref cNullNode if nothing was hit
+	\param pFraction Pointer to receive the fraction from 0.0f to 1.0f along the ray where the hit occurred, can be \ref NULL
+	\param pStart Pointer to the start of the ray
+	\param pEnd Pointer to the end of the ray
+	\return kErrorNone on success or kErrorOutOfMemory if the query was stopped early
+
+	\sa RayCastAll(SimpleArray<Word> *,const Vector2D_t *,const Vector2D_t *) const
+
+***************************************/
+
+Burger::eError BURGER_API Burger::BoundingBoxTree::RayCast(Word *pProxy,float *pFraction,const Vector2D_t *pStart,const Vector2D_t *pEnd) const
+{
+	eError uResult = kErrorNone;
+	Word uHit = cNullNode;
+	float fBest = 1.0f;
+	if (m_uRoot!=cNullNode) {
+		Vector2D_t Delta;
+		Delta.x = pEnd->x-pStart->x;
+		Delta.y = pEnd->y-pStart->y;
+		float fEnter;
+		if (RayHitsBounds(&fEnter,&m_pNodes[m_uRoot].m_Bounds,pStart,&Delta,fBest)) {
+			BoundingBoxTreeStack Stack;
+			Stack.Push(m_uRoot);
+			do {
+				const Node_t *pNode = &m_pNodes[Stack.Pop()];
+				// Test again, a closer hit may have been found since this was pushed
+				if (RayHitsBounds(&fEnter,&pNode->m_Bounds,pStart,&Delta,fBest)) {
+					if (pNode->IsLeaf()) {
+						if (RayHitsBounds(&fEnter,&pNode->m_ItemBounds,pStart,&Delta,fBest)) {
+							if ((uHit==cNullNode) || (fEnter<fBest)) {
+								fBest = fEnter;
+								uHit = static_cast<Word>(pNode-m_pNodes);
+							}
+						}
+					} else {
+						float fEnter1;
+						float fEnter2;
+						Word bHit1 = RayHitsBounds(&fEnter1,&m_pNodes[pNode->m_uChild1].m_Bounds,pStart,&Delta,fBest);
+						Word bHit2 = RayHitsBounds(&fEnter2,&m_pNodes[pNode->m_uChild2].m_Bounds,pStart,&Delta,fBest);
+						// Push the closest last so it's tested first
+						if (bHit1 && bHit2) {
+							if (fEnter1<fEnter2) {
+								uResult = Stack.Push(pNode->m_uChild2,pNode->m_uChild1);
+							} else {
+								uResult = Stack.Push(pNode->m_uChild1,pNode->m_uChild2);
+							}
+						} else if (bHit1) {
+							uResult = Stack.Push(pNode->m_uChild1);
+						} else if (bHit2) {
+							uResult = Stack.Push(pNode->m_uChild2);
+						}
+					}
+				}
+			} while (!uResult && !Stack.IsEmpty());
+		}
+	}
+	pProxy[0] = uHit;
+	if (pFraction) {
+		pFraction[0] = fBest;
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Find all items hit by a ray
+
+	Cast a ray from pStart to pEnd and return every item whose
+	bounds intersect the line segment.
+
+	\note pOutput is cleared before the query is performed
+
+	\param pOutput Pointer to the array to receive the proxy indexes
+	\param pStart Pointer to the start of the ray
+	\param pEnd Pointer to the end of the ray
+	\return kErrorNone on success or kErrorOutOfMemory if the query was stopped early
+
+	\sa RayCast(Word *,float *,const Vector2D_t *,const Vector2D_t *) const
+
+***************************************/
+
+Burger::eError BURGER_API Burger::BoundingBoxTree::RayCastAll(SimpleArray<Word> *pOutput,const Vector2D_t *pStart,const Vector2D_t *pEnd) const
+{
+	pOutput->clear();
+	eError uResult = kErrorNone;
+	if (m_uRoot!=cNullNode) {
+		Vector2D_t Delta;
+		Delta.x = pEnd->x-pStart->x;
+		Delta.y = pEnd->y-pStart->y;
+		float fEnter;
+		BoundingBoxTreeStack Stack;
+		Stack.Push(m_uRoot);
+		do {
+			Word uNode = Stack.Pop();
+			const Node_t *pNode = &m_pNodes[uNode];
+			if (RayHitsBounds(&fEnter,&pNode->m_Bounds,pStart,&Delta,1.0f)) {
+				if (pNode->IsLeaf()) {
+					if (RayHitsBounds(&fEnter,&pNode->m_ItemBounds,pStart,&Delta,1.0f)) {
+						pOutput->push_back(uNode);
+					}
+				} else {
+					uResult = Stack.Push(pNode->m_uChild1,pNode->m_uChild2);
+				}
+			}
+		} while (!uResult && !Stack.IsEmpty());
+	}
+	return uResult;
+}
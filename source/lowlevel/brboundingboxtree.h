@@ -0,0 +1,108 @@
+/***************************************
+
+	Dynamic bounding box tree
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRBOUNDINGBOXTREE_H__
+#define __BRBOUNDINGBOXTREE_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRASSERT_H__
+#include "brassert.h"
+#endif
+
+#ifndef __BRVECTOR2D_H__
+#include "brvector2d.h"
+#endif
+
+#ifndef __BRVECTOR3D_H__
+#include "brvector3d.h"
+#endif
+
+#ifndef __BRVECTOR4D_H__
+#include "brvector4d.h"
+#endif
+
+#ifndef __BRSIMPLEARRAY_H__
+#include "brsimplearray.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class BoundingBoxTree {
+	BURGER_DISABLE_COPY(BoundingBoxTree);
+public:
+	static const Word cNullNode = BURGER_MAXUINT;	///< Invalid node index
+
+	struct Node_t {
+		Vector4D_t m_Bounds;		///< Bounds of the node, enlarged for leaves
+		Vector4D_t m_ItemBounds;	///< Exact bounds of the item (Leaves only)
+		Word m_uParent;				///< Index of the parent node or next free node
+		Word m_uChild1;				///< Index of the first child or \ref cNullNode for leaves
+		Word m_uChild2;				///< Index of the second child or \ref cNullNode for leaves
+		Int m_iHeight;				///< Height of the node, 0 for leaves, -1 for free nodes
+		Word m_uValue;				///< Payload of the item (Leaves only)
+		BURGER_INLINE Word IsLeaf(void) const { return m_uChild1==cNullNode; }
+	};
+
+	struct Pair_t {
+		Word m_uProxy1;				///< First proxy of an overlapping pair
+		Word m_uProxy2;				///< Second proxy of an overlapping pair
+	};
+
+private:
+	Node_t *m_pNodes;				///< Array of nodes
+	Word m_uRoot;					///< Index of the root node
+	Word m_uNodeCount;				///< Number of nodes in use
+	Word m_uNodeCapacity;			///< Number of nodes allocated
+	Word m_uFreeList;				///< Index of the first free node
+	float m_fMargin;				///< Amount to enlarge leaf bounds by
+
+	eError BURGER_API GrowNodes(Word uCount);
+	Word BURGER_API AllocateNode(void);
+	void BURGER_API FreeNode(Word uNode);
+	void BURGER_API InsertLeaf(Word uLeaf);
+	void BURGER_API RemoveLeaf(Word uLeaf);
+	Word BURGER_API Balance(Word uNode);
+	void BURGER_API RefitParents(Word uNode);
+	Word BURGER_API BuildRange(Word *pLeaves,WordPtr uCount,Word uDepth);
+
+public:
+	BoundingBoxTree(float fMargin=0.1f);
+	~BoundingBoxTree();
+	void BURGER_API Clear(void);
+	Word BURGER_API Insert(const Vector4D_t *pBounds,Word uValue);
+	void BURGER_API Remove(Word uProxy);
+	Word BURGER_API Move(Word uProxy,const Vector4D_t *pBounds);
+	void BURGER_API Refit(Word uProxy,const Vector4D_t *pBounds);
+	eError BURGER_API Build(const Vector4D_t *pBounds,const Word *pValues,WordPtr uCount,Word *pProxies=NULL);
+	BURGER_INLINE Word GetValue(Word uProxy) const { BURGER_ASSERT(uProxy<m_uNodeCapacity); return m_pNodes[uProxy].m_uValue; }
+	BURGER_INLINE const Vector4D_t *GetBounds(Word uProxy) const { BURGER_ASSERT(uProxy<m_uNodeCapacity); return &m_pNodes[uProxy].m_ItemBounds; }
+	BURGER_INLINE const Vector4D_t *GetFatBounds(Word uProxy) const { BURGER_ASSERT(uProxy<m_uNodeCapacity); return &m_pNodes[uProxy].m_Bounds; }
+	BURGER_INLINE Word GetRoot(void) const { return m_uRoot; }
+	BURGER_INLINE const Node_t *GetNode(Word uNode) const { BURGER_ASSERT(uNode<m_uNodeCapacity); return &m_pNodes[uNode]; }
+	BURGER_INLINE Int GetHeight(void) const { return (m_uRoot==cNullNode) ? 0 : m_pNodes[m_uRoot].m_iHeight; }
+	BURGER_INLINE float GetMargin(void) const { return m_fMargin; }
+	float BURGER_API GetAreaRatio(void) const;
+	eError BURGER_API QueryPoint(SimpleArray<Word> *pOutput,const Vector2D_t *pPoint) const;
+	eError BURGER_API QueryBox(SimpleArray<Word> *pOutput,const Vector4D_t *pBounds) const;
+	eError BURGER_API QueryFrustum(SimpleArray<Word> *pOutput,const Vector3D_t *pPlanes,Word uPlaneCount) const;
+	eError BURGER_API QueryPairs(SimpleArray<Pair_t> *pOutput) const;
+	eError BURGER_API RayCast(Word *pProxy,float *pFraction,const Vector2D_t *pStart,const Vector2D_t *pEnd) const;
+	eError BURGER_API RayCastAll(SimpleArray<Word> *pOutput,const Vector2D_t *pStart,const Vector2D_t *pEnd) const;
+};
+}
+/* END */
+
+#endif
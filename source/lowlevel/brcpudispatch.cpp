@@ -0,0 +1,435 @@
+/***************************************
+
+    Runtime CPU feature dispatch
+
+    Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+    It is released under an MIT Open Source license. Please see LICENSE for
+    license details. Yes, you can use it in a commercial title without paying
+    anything, just give me a credit.
+
+    Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brcpudispatch.h"
+#include "brassert.h"
+#include "bratomic.h"
+
+#if defined(BURGER_INTEL) && defined(BURGER_MSVC) && defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
+
+/*! ************************************
+
+    \struct Burger::CPUDispatch
+    \brief Select the best implementation of a function at runtime.
+
+    A single x86 or x64 executable may run on anything from an SSE2 only
+    machine to one with AVX2. To take advantage of the newer instructions
+    without requiring them, a kernel is written several times, each version
+    compiled for a specific instruction set with \ref BURGER_TARGET_AVX2 and
+    its siblings, and listed in a table of \ref Variant_t records sorted from
+    the most to the least demanding. The last entry must require no
+    features so it can run anywhere.
+
+    The first call to Get() checks the CPU once with CPUID() and caches the
+    first variant whose features are all present. Later calls only cost a
+    compare and an indirect call.
+
+    Unit tests can call SetFeatureMask() or SetFamilyFeatureMask() to hide
+    features, so every variant of a kernel can be tested on a single machine.
+    Changing a mask causes every kernel to be resolved again on its next use.
+
+    \code
+    typedef uintptr_t (BURGER_API *ScanProc)(const uint8_t *pInput,uintptr_t uLength);
+
+    static const Burger::CPUDispatch::Variant_t g_ScanVariants[] = {
+        {BURGER_CPU_DISPATCH_PROC(ScanAVX2), Burger::CPUDispatch::kAVX2, "AVX2"},
+        {BURGER_CPU_DISPATCH_PROC(ScanSSE2), Burger::CPUDispatch::kSSE2, "SSE2"},
+        {BURGER_CPU_DISPATCH_PROC(ScanGeneric), 0, "Generic"}
+    };
+    static BURGER_CPU_DISPATCH_DEFINE(g_Scan,
+        Burger::CPUDispatch::kFamilyString, g_ScanVariants);
+
+    uintptr_t uResult = g_Scan.Get<ScanProc>()(pInput,uLength);
+    \endcode
+
+    \note Instances are plain data so they are initialized before any
+        constructors run and can be used during static initialization.
+
+    \sa BURGER_CPU_DISPATCH_DEFINE or CPUID_t
+
+***************************************/
+
+/*! ************************************
+
+    \def BURGER_CPU_DISPATCH
+    \brief Defined if runtime CPU dispatch is available.
+
+    If this is defined, the compiler can generate code for instruction sets
+    that are not enabled on the command line, using \ref BURGER_TARGET_AVX2
+    and its siblings, so SIMD variants can be selected with
+    \ref Burger::CPUDispatch.
+
+    On Visual Studio, Visual Studio 2015 or higher is required for the
+    AVX2, F16C and SHA intrinsics.
+
+***************************************/
+
+/*! ************************************
+
+    \def BURGER_TARGET_AVX2
+    \brief Allow a function to use AVX2 instructions.
+
+    Place before a function declaration so the compiler will generate AVX2
+    code and accept AVX2 intrinsics for only that function. The function
+    must only be called if \ref Burger::CPUDispatch::kAVX2 is present.
+
+    \ref BURGER_TARGET_SSE2, BURGER_TARGET_SSSE3, BURGER_TARGET_SSE41,
+    BURGER_TARGET_SSE42, BURGER_TARGET_PCLMUL, BURGER_TARGET_AVX,
+    BURGER_TARGET_F16C and BURGER_TARGET_SHA work the same way for their
+    instruction sets.
+
+    \sa BURGER_CPU_DISPATCH
+
+***************************************/
+
+/*! ************************************
+
+    \def BURGER_CPU_DISPATCH_PROC(x)
+    \brief Cast a function to \ref Burger::CPUDispatch::Proc_t
+
+    \param x Function to place in a \ref Burger::CPUDispatch::Variant_t
+
+***************************************/
+
+/*! ************************************
+
+    \def BURGER_CPU_DISPATCH_DEFINE(x, family, variants)
+    \brief Declare an instance of \ref Burger::CPUDispatch
+
+    \param x Name of the instance
+    \param family \ref Burger::CPUDispatch::eFamily of the kernel
+    \param variants Array of \ref Burger::CPUDispatch::Variant_t, the last
+        entry must have an m_uFeatures of zero. Resolve() asserts this.
+
+***************************************/
+
+#if !defined(DOXYGEN)
+
+// Features detected from the CPU
+static uint32_t g_uCPUFeatures;
+
+// TRUE if g_uCPUFeatures is valid
+static volatile uint_t g_bCPUFeaturesValid;
+
+// Global mask of allowed features
+static uint32_t g_uFeatureMask = Burger::CPUDispatch::kAllFeatures;
+
+// Mask of allowed features for each kernel family
+static uint32_t g_uFamilyFeatureMasks[Burger::CPUDispatch::kFamilyCount] = {
+    Burger::CPUDispatch::kAllFeatures, Burger::CPUDispatch::kAllFeatures,
+    Burger::CPUDispatch::kAllFeatures, Burger::CPUDispatch::kAllFeatures,
+    Burger::CPUDispatch::kAllFeatures, Burger::CPUDispatch::kAllFeatures,
+    Burger::CPUDispatch::kAllFeatures};
+
+#if defined(BURGER_INTEL)
+
+// Read the extended control register 0 to see which registers the operating
+// system saves on a context switch
+static uint32_t BURGER_API GetXCR0(void) BURGER_NOEXCEPT
+{
+#if defined(BURGER_MSVC) && defined(BURGER_CPU_DISPATCH)
+    return static_cast<uint32_t>(_xgetbv(0));
+#elif defined(BURGER_GNUC) || defined(BURGER_CLANG)
+    uint32_t uEAX;
+    uint32_t uEDX;
+    // xgetbv encoded as bytes for older assemblers
+    __asm__ __volatile__(".byte 0x0F,0x01,0xD0"
+                         : "=a"(uEAX), "=d"(uEDX)
+                         : "c"(0));
+    return uEAX;
+#else
+    return 0;
+#endif
+}
+
+#endif
+#endif
+
+volatile uint32_t Burger::CPUDispatch::g_uGeneration = 1;
+
+/*! ************************************
+
+    \brief Return the features the CPU supports
+
+    On the first call, CPUID() is called and the result is converted into
+    a bit mask of \ref eFeature flags. AVX, AVX2, FMA3 and F16C are only
+    reported if the operating system saves the YMM registers on a context
+    switch.
+
+    \note Non x86 CPUs always return zero.
+
+    \return Bit mask of \ref eFeature flags
+    \sa GetFeatures(uint32_t)
+
+***************************************/
+
+uint32_t BURGER_API Burger::CPUDispatch::GetCPUFeatures(void) BURGER_NOEXCEPT
+{
+    if (!g_bCPUFeaturesValid) {
+        uint32_t uFeatures = 0;
+#if defined(BURGER_INTEL)
+        if (IsCPUIDPresent()) {
+            CPUID_t MyID;
+            CPUID(&MyID);
+            if (MyID.HasSSE2()) {
+                uFeatures |= kSSE2;
+            }
+            if (MyID.HasSSE3()) {
+                uFeatures |= kSSE3;
+            }
+            if (MyID.HasSSSE3()) {
+                uFeatures |= kSSSE3;
+            }
+            if (MyID.HasSSE41()) {
+                uFeatures |= kSSE41;
+            }
+            if (MyID.HasSSE42()) {
+                uFeatures |= kSSE42;
+            }
+            if (MyID.HasPCLMULQDQ()) {
+                uFeatures |= kPCLMULQDQ;
+            }
+            if (MyID.HasPOPCNT()) {
+                uFeatures |= kPOPCNT;
+            }
+            if (MyID.HasAES()) {
+                uFeatures |= kAES;
+            }
+            if (MyID.HasSHA()) {
+                uFeatures |= kSHA;
+            }
+            if (MyID.HasBMI1() && MyID.HasBMI2()) {
+                uFeatures |= kBMI;
+            }
+
+            // AVX needs the operating system to save the YMM registers
+            if (MyID.HasOSXSAVE() && ((GetXCR0() & 6U) == 6U)) {
+                if (MyID.HasAVX()) {
+                    uFeatures |= kAVX;
+                    if (MyID.HasAVX2()) {
+                        uFeatures |= kAVX2;
+                    }
+                    if (MyID.HasFMA3()) {
+                        uFeatures |= kFMA3;
+                    }
+                    if (MyID.HasF16C()) {
+                        uFeatures |= kF16C;
+                    }
+                }
+            }
+        }
+#endif
+        g_uCPUFeatures = uFeatures;
+        g_bCPUFeaturesValid = TRUE;
+    }
+    return g_uCPUFeatures;
+}
+
+/*! ************************************
+
+    \brief Return the features a kernel family may use
+
+    Return the features the CPU supports, minus any features removed with
+    SetFeatureMask() or SetFamilyFeatureMask().
+
+    \param uFamily \ref eFamily of the kernel
+    \return Bit mask of \ref eFeature flags
+    \sa GetCPUFeatures(void)
+
+***************************************/
+
+uint32_t BURGER_API Burger::CPUDispatch::GetFeatures(
+    uint32_t uFamily) BURGER_NOEXCEPT
+{
+    uint32_t uFeatures = GetCPUFeatures() & g_uFeatureMask;
+    if (uFamily < kFamilyCount) {
+        uFeatures &= g_uFamilyFeatureMasks[uFamily];
+    }
+    return uFeatures;
+}
+
+/*! ************************************
+
+    \brief Return the global feature mask
+
+    \return Bit mask of \ref eFeature flags allowed for every kernel
+    \sa SetFeatureMask(uint32_t)
+
+***************************************/
+
+uint32_t BURGER_API Burger::CPUDispatch::GetFeatureMask(void) BURGER_NOEXCEPT
+{
+    return g_uFeatureMask;
+}
+
+/*! ************************************
+
+    \brief Limit the features every kernel may use
+
+    Mainly used by unit tests and benchmarks to force the use of a
+    specific variant. Pass \ref kAllFeatures to restore normal operation.
+
+    \param uMask Bit mask of \ref eFeature flags to allow
+    \sa GetFeatureMask(void) or SetFamilyFeatureMask(uint32_t,uint32_t)
+
+***************************************/
+
+void BURGER_API Burger::CPUDispatch::SetFeatureMask(uint32_t uMask) BURGER_NOEXCEPT
+{
+    g_uFeatureMask = uMask;
+    AtomicPreIncrement(&g_uGeneration);
+}
+
+/*! ************************************
+
+    \brief Return the feature mask of a kernel family
+
+    \param uFamily \ref eFamily to query
+    \return Bit mask of \ref eFeature flags allowed for the family
+    \sa SetFamilyFeatureMask(uint32_t,uint32_t)
+
+***************************************/
+
+uint32_t BURGER_API Burger::CPUDispatch::GetFamilyFeatureMask(
+    uint32_t uFamily) BURGER_NOEXCEPT
+{
+    if (uFamily < kFamilyCount) {
+        return g_uFamilyFeatureMasks[uFamily];
+    }
+    return kAllFeatures;
+}
+
+/*! ************************************
+
+    \brief Limit the features a kernel family may use
+
+    \param uFamily \ref eFamily to limit
+    \param uMask Bit mask of \ref eFeature flags to allow
+    \sa GetFamilyFeatureMask(uint32_t) or SetFeatureMask(uint32_t)
+
+***************************************/
+
+void BURGER_API Burger::CPUDispatch::SetFamilyFeatureMask(
+    uint32_t uFamily, uint32_t uMask) BURGER_NOEXCEPT
+{
+    if (uFamily < kFamilyCount) {
+        g_uFamilyFeatureMasks[uFamily] = uMask;
+        AtomicPreIncrement(&g_uGeneration);
+    }
+}
+
+/*! ************************************
+
+    \brief Remove all feature limits
+
+    \sa SetFeatureMask(uint32_t) or SetFamilyFeatureMask(uint32_t,uint32_t)
+
+***************************************/
+
+void BURGER_API Burger::CPUDispatch::ResetFeatureMasks(void) BURGER_NOEXCEPT
+{
+    g_uFeatureMask = kAllFeatures;
+    uintptr_t i = 0;
+    do {
+        g_uFamilyFeatureMasks[i] = kAllFeatures;
+    } while (++i < kFamilyCount);
+    AtomicPreIncrement(&g_uGeneration);
+}
+
+/*! ************************************
+
+    \brief Choose the variant to use
+
+    Scan the variants from best to worst and select the first one whose
+    required features are all available. The last entry must require no
+    features, so a match is always found. A variant whose features are
+    missing is never selected, if a table breaks that rule, \ref NULL is
+    returned. This is called by Get() and does not need to be called
+    directly.
+
+    \note If two threads resolve at the same time, they both store the same
+        result, so no lock is needed.
+
+    \return Pointer to the selected function
+    \sa Get(void)
+
+***************************************/
+
+Burger::CPUDispatch::Proc_t BURGER_API Burger::CPUDispatch::Resolve(
+    void) BURGER_NOEXCEPT
+{
+    // Capture the generation first so a mask change during the scan
+    // forces another pass
+    uint32_t uGeneration = g_uGeneration;
+    uint32_t uFeatures = GetFeatures(m_uFamily);
+
+    uint32_t uCount = m_uVariantCount;
+    // The last variant is the fallback for any CPU
+    BURGER_ASSERT(uCount && !m_pVariants[uCount - 1].m_uFeatures);
+    uint32_t uIndex = 0;
+    while (uIndex < uCount) {
+        if (!(m_pVariants[uIndex].m_uFeatures & ~uFeatures)) {
+            break;
+        }
+        ++uIndex;
+    }
+    // Nothing can run on this CPU?
+    if (uIndex >= uCount) {
+        return NULL;
+    }
+    Proc_t pProc = m_pVariants[uIndex].m_pProc;
+    m_uSelected = uIndex;
+    m_pSelected = pProc;
+    m_uGeneration = uGeneration;
+    return pProc;
+}
+
+/*! ************************************
+
+    \brief Return the name of the variant in use
+
+    Resolve the kernel if needed and return the name of the selected
+    variant, for logging and unit tests.
+
+    \return Pointer to the name of the variant in use, \ref NULL if none
+        can run
+    \sa Get(void)
+
+***************************************/
+
+const char* BURGER_API Burger::CPUDispatch::GetSelectedName(
+    void) BURGER_NOEXCEPT
+{
+    if (!m_pSelected || (m_uGeneration != g_uGeneration)) {
+        if (!Resolve()) {
+            return NULL;
+        }
+    }
+    return m_pVariants[m_uSelected].m_pName;
+}
+
+/*! ************************************
+
+    \fn Burger::CPUDispatch::Get(void)
+    \brief Return the function pointer of the best variant
+
+    If the kernel hasn't been resolved yet or a feature mask has changed,
+    call Resolve() first.
+
+    \tparam T Function pointer type of the kernel
+    \return Function pointer of the variant to call
+
+***************************************/
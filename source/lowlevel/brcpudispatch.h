@@ -0,0 +1,170 @@
+/***************************************
+
+    Runtime CPU feature dispatch
+
+    Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+    It is released under an MIT Open Source license. Please see LICENSE for
+    license details. Yes, you can use it in a commercial title without paying
+    anything, just give me a credit.
+
+    Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRCPUDISPATCH_H__
+#define __BRCPUDISPATCH_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+/* BEGIN */
+#if defined(BURGER_INTEL) && \
+    ((defined(BURGER_GNUC) && (BURGER_GNUC >= 40900)) || \
+        (defined(BURGER_CLANG) && (BURGER_CLANG >= 30800))) && \
+    !defined(DOXYGEN)
+#define BURGER_CPU_DISPATCH
+#define BURGER_TARGET_SSE2 __attribute__((target("sse2")))
+#define BURGER_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define BURGER_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define BURGER_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define BURGER_TARGET_PCLMUL __attribute__((target("sse4.1,pclmul")))
+#define BURGER_TARGET_AVX __attribute__((target("avx")))
+#define BURGER_TARGET_AVX2 __attribute__((target("avx2")))
+#define BURGER_TARGET_F16C __attribute__((target("avx,f16c")))
+#define BURGER_TARGET_SHA __attribute__((target("sse4.1,sha")))
+
+#elif (defined(BURGER_INTEL) && defined(BURGER_MSVC) && \
+          (BURGER_MSVC >= 190000000)) || \
+    defined(DOXYGEN)
+#define BURGER_CPU_DISPATCH
+#define BURGER_TARGET_SSE2
+#define BURGER_TARGET_SSSE3
+#define BURGER_TARGET_SSE41
+#define BURGER_TARGET_SSE42
+#define BURGER_TARGET_PCLMUL
+#define BURGER_TARGET_AVX
+#define BURGER_TARGET_AVX2
+#define BURGER_TARGET_F16C
+#define BURGER_TARGET_SHA
+#endif
+
+namespace Burger {
+
+struct CPUDispatch {
+
+    /** Instruction set extensions that a variant can require */
+    enum eFeature {
+        /** SSE2 instructions */
+        kSSE2 = 0x0001,
+        /** SSE3 instructions */
+        kSSE3 = 0x0002,
+        /** SSSE3 instructions (pshufb) */
+        kSSSE3 = 0x0004,
+        /** SSE 4.1 instructions */
+        kSSE41 = 0x0008,
+        /** SSE 4.2 instructions (crc32) */
+        kSSE42 = 0x0010,
+        /** Carryless multiply instruction */
+        kPCLMULQDQ = 0x0020,
+        /** POPCNT instruction */
+        kPOPCNT = 0x0040,
+        /** AES instructions */
+        kAES = 0x0080,
+        /** SHA extension instructions */
+        kSHA = 0x0100,
+        /** AVX instructions with operating system support */
+        kAVX = 0x0200,
+        /** AVX2 instructions with operating system support */
+        kAVX2 = 0x0400,
+        /** FMA3 instructions with operating system support */
+        kFMA3 = 0x0800,
+        /** Half precision float conversion instructions */
+        kF16C = 0x1000,
+        /** BMI1 and BMI2 instructions */
+        kBMI = 0x2000,
+        /** Every feature, used for masks */
+        kAllFeatures = 0xFFFFFFFF
+    };
+
+    /** Groups of kernels that can be forced as a unit */
+    enum eFamily {
+        /** Memory copies, fills and endian conversion */
+        kFamilyMemory,
+        /** String scanning and conversion */
+        kFamilyString,
+        /** Hashes such as MD5, SHA-1 and Adler */
+        kFamilyHash,
+        /** CRC checksums */
+        kFamilyCRC,
+        /** Pixel and texture format conversion */
+        kFamilyPixel,
+        /** Audio sample conversion and mixing */
+        kFamilyAudio,
+        /** Batched math operations */
+        kFamilyMath,
+        /** Number of kernel families */
+        kFamilyCount
+    };
+
+    /** Generic function pointer, cast to the real type by Get() */
+    typedef void(BURGER_API* Proc_t)(void);
+
+    /** Description of one implementation of a kernel */
+    struct Variant_t {
+        /** Function that implements this variant */
+        Proc_t m_pProc;
+        /** Bit mask of \ref eFeature needed to run it, zero for any CPU */
+        uint32_t m_uFeatures;
+        /** Name of the variant for diagnostics */
+        const char* m_pName;
+    };
+
+    const char* m_pName;          ///< Name of the kernel
+    uint32_t m_uFamily;           ///< \ref eFamily the kernel belongs to
+    const Variant_t* m_pVariants; ///< Variants, sorted from best to worst
+    uint32_t m_uVariantCount;     ///< Number of entries in m_pVariants
+    Proc_t m_pSelected;           ///< Variant in use, \ref NULL if unresolved
+    uint32_t m_uSelected;         ///< Index of the variant in use
+    uint32_t m_uGeneration;       ///< Value of g_uGeneration when resolved
+
+    /** Incremented every time the feature masks change */
+    static volatile uint32_t g_uGeneration;
+
+    Proc_t BURGER_API Resolve(void) BURGER_NOEXCEPT;
+    const char* BURGER_API GetSelectedName(void) BURGER_NOEXCEPT;
+
+    template<class T>
+    BURGER_INLINE T Get(void) BURGER_NOEXCEPT
+    {
+        Proc_t pProc = m_pSelected;
+        if (!pProc || (m_uGeneration != g_uGeneration)) {
+            pProc = Resolve();
+        }
+        return reinterpret_cast<T>(pProc);
+    }
+
+    static uint32_t BURGER_API GetCPUFeatures(void) BURGER_NOEXCEPT;
+    static uint32_t BURGER_API GetFeatures(uint32_t uFamily) BURGER_NOEXCEPT;
+    static uint32_t BURGER_API GetFeatureMask(void) BURGER_NOEXCEPT;
+    static void BURGER_API SetFeatureMask(uint32_t uMask) BURGER_NOEXCEPT;
+    static uint32_t BURGER_API GetFamilyFeatureMask(
+        uint32_t uFamily) BURGER_NOEXCEPT;
+    static void BURGER_API SetFamilyFeatureMask(
+        uint32_t uFamily, uint32_t uMask) BURGER_NOEXCEPT;
+    static void BURGER_API ResetFeatureMasks(void) BURGER_NOEXCEPT;
+};
+
+}
+
+#define BURGER_CPU_DISPATCH_PROC(x) \
+    reinterpret_cast<Burger::CPUDispatch::Proc_t>(x)
+
+#define BURGER_CPU_DISPATCH_DEFINE(x, family, variants) \
+    Burger::CPUDispatch x = {#x, family, variants, \
+        BURGER_ARRAYSIZE(variants), NULL, 0, 0}
+
+/* END */
+
+#endif
@@ -38,7 +38,7 @@
 ***************************************/
 
 #if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_PS3) || \
-	defined(BURGER_PS4) || defined(BURGER_SHIELD) || defined(BURGER_VITA) || \
+	defined(BURGER_PS4) || defined(BURGER_SHIELD) || defined(BURGER_LINUX) || defined(BURGER_VITA) || \
 	defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_MAC)) || defined(DOXYGEN)
 Burger::CriticalSection::CriticalSection()
 {
@@ -255,7 +255,7 @@ Burger::CriticalSectionStatic::~CriticalSectionStatic()
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_ANDROID) || defined(BURGER_VITA) || \
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_ANDROID) || defined(BURGER_LINUX) || defined(BURGER_VITA) || \
 	defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
 
 /*! ************************************
@@ -384,7 +384,7 @@ Word BURGER_API Burger::Semaphore::Release(void)
 
 ***************************************/
 
-#if !(defined(BURGER_SHIELD) || defined(BURGER_VITA) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_SHIELD) || defined(BURGER_LINUX) || defined(BURGER_VITA) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
 Burger::ConditionVariable::ConditionVariable() :
 	m_CriticalSection(),
 	m_WaitSemaphore(0),
@@ -560,7 +560,7 @@ Word BURGER_API Burger::ConditionVariable::Wait(CriticalSection *pCriticalSectio
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_LINUX) || defined(BURGER_VITA) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
 Burger::Thread::Thread() :
 	m_pFunction(NULL),
 	m_pData(NULL),
@@ -729,4 +729,85 @@ void BURGER_API Burger::Thread::Run(void *pThis)
 
 ***************************************/
 
-#endif
\ No newline at end of file
+#endif
+
+#if !defined(DOXYGEN)
+
+// Threads started at a time by RunThreadJobs()
+static const Word g_uMaxThreadJobs = 16;
+
+// Records if the thread executed the job
+struct ThreadJob_t {
+	Burger::Thread::FunctionPtr m_pFunction;	// Job function
+	void *m_pJob;					// Job record
+	Word m_bDone;					// TRUE when the job is complete
+};
+
+static WordPtr BURGER_API ThreadJobDispatcher(void *pData)
+{
+	ThreadJob_t *pJob = static_cast<ThreadJob_t *>(pData);
+	WordPtr uResult = pJob->m_pFunction(pJob->m_pJob);
+	pJob->m_bDone = TRUE;
+	return uResult;
+}
+#endif
+
+/*! ************************************
+
+	\brief Execute an array of jobs, one thread per job
+
+	Call pFunction once for each of the uJobCount records in the array
+	at pJobs and return once they have all finished. The first job
+	is executed on the calling thread and the others are each given
+	a Thread. If a thread can't be started, or the platform
+	has no threads, its job is executed on the calling thread instead,
+	so every job is always executed exactly once.
+
+	No more than 16 jobs are executed at a time, larger counts are
+	processed in groups.
+
+	\param pFunction Function to call with a pointer to each job
+	\param pJobs Pointer to the first job record
+	\param uJobSize Size in bytes of each job record
+	\param uJobCount Number of job records
+
+	\sa Burger::Thread
+
+***************************************/
+
+void BURGER_API Burger::RunThreadJobs(Thread::FunctionPtr pFunction,void *pJobs,WordPtr uJobSize,Word uJobCount)
+{
+	Word8 *pJob = static_cast<Word8 *>(pJobs);
+	while (uJobCount) {
+		Word uCount = uJobCount;
+		if (uCount>g_uMaxThreadJobs) {
+			uCount = g_uMaxThreadJobs;
+		}
+		ThreadJob_t Jobs[g_uMaxThreadJobs];
+		Word i = 0;
+		do {
+			Jobs[i].m_pFunction = pFunction;
+			Jobs[i].m_pJob = pJob+(uJobSize*i);
+			Jobs[i].m_bDone = FALSE;
+		} while (++i<uCount);
+
+		Thread Threads[g_uMaxThreadJobs];
+		// Job 0 is always this thread
+		i = 1;
+		while (i<uCount) {
+			Threads[i].Start(ThreadJobDispatcher,&Jobs[i]);
+			++i;
+		}
+		ThreadJobDispatcher(&Jobs[0]);
+		i = 1;
+		while (i<uCount) {
+			Threads[i].Wait();
+			if (!Jobs[i].m_bDone) {
+				ThreadJobDispatcher(&Jobs[i]);
+			}
+			++i;
+		}
+		pJob += uJobSize*uCount;
+		uJobCount -= uCount;
+	}
+}
@@ -42,6 +42,10 @@
 #include "brvitatypes.h"
 #endif
 
+#if defined(BURGER_LINUX) && !defined(__BRLINUXTYPES_H__)
+#include "brlinuxtypes.h"
+#endif
+
 #if defined(BURGER_MACOSX) && !defined(__BRMACOSXTYPES_H__)
 #include "brmacosxtypes.h"
 #endif
@@ -70,9 +74,9 @@ class CriticalSection {
 	pthread_mutex *m_Lock;		///< Critical section for PS4 (PS4 only)
 #endif
 
-#if (defined(BURGER_SHIELD) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if (defined(BURGER_SHIELD) || defined(BURGER_LINUX) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
 	friend class ConditionVariable;
-	Burgerpthread_mutex_t m_Lock;		///< Critical section for Android/MacOSX/iOS (Android/MacOSX/iOS only)
+	Burgerpthread_mutex_t m_Lock;		///< Critical section for Android/Linux/MacOSX/iOS (Android/Linux/MacOSX/iOS only)
 #endif
 
 #if defined(BURGER_VITA) || defined(DOXYGEN)
@@ -116,8 +120,8 @@ class Semaphore {
 	void *m_pSemaphore;			///< Semaphore HANDLE (Windows only)
 #endif
 
-#if (defined(BURGER_SHIELD)) || defined(DOXYGEN)
-	Burgersem_t m_Semaphore;	///< Semaphore instance (Android)
+#if (defined(BURGER_SHIELD) || defined(BURGER_LINUX)) || defined(DOXYGEN)
+	Burgersem_t m_Semaphore;	///< Semaphore instance (Android/Linux)
 	Word m_bInitialized;		///< \ref TRUE if the semaphore instance successfully initialized
 #endif
 
@@ -143,9 +147,9 @@ public:
 
 class ConditionVariable {
 
-#if (defined(BURGER_SHIELD) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
-	Burgerpthread_cond_t m_ConditionVariable;	///< Condition variable instance (Android/MacOSX/iOS only)
-	Word m_bInitialized;			///< \ref TRUE if the Condition variable instance successfully initialized (Android/MacOSX/iOS only)
+#if (defined(BURGER_SHIELD) || defined(BURGER_LINUX) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+	Burgerpthread_cond_t m_ConditionVariable;	///< Condition variable instance (Android/Linux/MacOSX/iOS only)
+	Word m_bInitialized;			///< \ref TRUE if the Condition variable instance successfully initialized (Android/Linux/MacOSX/iOS only)
 #endif
 
 #if (defined(BURGER_VITA)) || defined(DOXYGEN)
@@ -153,7 +157,7 @@ class ConditionVariable {
 	int m_iMutex;				///< Mutex for the condition variable (Vita only)
 #endif
 
-#if !(defined(BURGER_SHIELD) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_SHIELD) || defined(BURGER_LINUX) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
 	CriticalSection m_CriticalSection;	///< CriticalSection for this class (Non-specialized platforms)
 	Semaphore m_WaitSemaphore;		///< Binary semaphore for forcing thread to wait for a signal (Non-specialized platforms)
 	Semaphore m_SignalsSemaphore;	///< Binary semaphore for the number of pending signals (Non-specialized platforms)
@@ -186,6 +190,10 @@ private:
 	_opaque_pthread_t *m_pThreadHandle;	///< Pointer to the thread data (MacOSX/iOS only)
 #endif
 
+#if (defined(BURGER_LINUX)) || defined(DOXYGEN)
+	Burgerpthread_t m_uThreadHandle;	///< pthread_t of the thread, zero if not running (Linux only)
+#endif
+
 #if (defined(BURGER_VITA)) || defined(DOXYGEN)
 	int m_iThreadID;				///< System ID of the thread (Vita only)
 #endif
@@ -204,6 +212,9 @@ public:
 #if (defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
 	BURGER_INLINE Word IsInitialized(void) const { return m_pThreadHandle!= nullptr; }
 
+#elif defined(BURGER_LINUX)
+	BURGER_INLINE Word IsInitialized(void) const { return m_uThreadHandle!=0; }
+
 #elif defined(BURGER_VITA)
 	BURGER_INLINE Word IsInitialized(void) const { return m_iThreadID>=0; }
 
@@ -211,6 +222,7 @@ public:
 	BURGER_INLINE Word IsInitialized(void) const { return FALSE; }
 #endif
 };
+extern void BURGER_API RunThreadJobs(Thread::FunctionPtr pFunction,void *pJobs,WordPtr uJobSize,Word uJobCount);
 }
 /* END */
 
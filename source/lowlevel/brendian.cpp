@@ -14,6 +14,8 @@
 
 #include "brendian.h"
 #include "brfloatingpoint.h"
+#include "brmemoryfunctions.h"
+#include "brcpudispatch.h"
 
 /*! ************************************
 
@@ -2420,6 +2422,38 @@ void BURGER_API Burger::SwapEndian::FixupAny(uint64_t* pInput) BURGER_NOEXCEPT
 
 ***************************************/
 
+/*! ************************************
+
+    \fn Burger::SwapEndian::ConvertArray(uint32_t* pOutput,const uint32_t* pInput,uintptr_t uCount)
+    \brief Swap the endian of an array of values.
+
+    Copy an array of 16, 32 or 64 bit integers, floats or doubles while
+    reversing the byte order of every entry. The work is performed by
+    ConvertEndian(uint32_t *,const uint32_t *,uintptr_t) and its overloads,
+    which use SIMD instructions where available. The arrays do not need to be
+    aligned and the input and output can be the same array.
+
+    \param pOutput Pointer to the array to receive the swapped data
+    \param pInput Pointer to the array to endian swap
+    \param uCount Number of entries in the array (Not bytes)
+
+    \sa FixupArray(T *,uintptr_t) or NativeEndian::ConvertArray(T *,const T *,uintptr_t)
+
+***************************************/
+
+/*! ************************************
+
+    \fn Burger::SwapEndian::FixupArray(T* pInput,uintptr_t uCount)
+    \brief Swap the endian of an array of values in place.
+
+    \tparam T Type of the array entries.
+    \param pInput Pointer to the array to endian swap
+    \param uCount Number of entries in the array (Not bytes)
+
+    \sa ConvertArray(uint32_t *,const uint32_t *,uintptr_t) or NativeEndian::FixupArray(T *,uintptr_t)
+
+***************************************/
+
 /*! ************************************
 
     \struct Burger::NativeEndian
@@ -3888,6 +3922,61 @@ void BURGER_API Burger::NativeEndian::StoreAny(
 
 ***************************************/
 
+/*! ************************************
+
+    \fn Burger::NativeEndian::ConvertArray(T* pOutput,const T* pInput,uintptr_t uCount)
+    \brief Copy an array of native endian values.
+
+    Since no byte swapping is needed, the array is copied with
+    CopyArray(void *,const void *,uintptr_t). If the input and output are the
+    same array, no work is performed.
+
+    \tparam T Type of the array entries.
+    \param pOutput Pointer to the array to receive the data
+    \param pInput Pointer to the array to copy
+    \param uCount Number of entries in the array (Not bytes)
+
+    \sa SwapEndian::ConvertArray(uint32_t *,const uint32_t *,uintptr_t)
+
+***************************************/
+
+/*! ************************************
+
+    \fn Burger::NativeEndian::FixupArray(T*,uintptr_t)
+    \brief Does nothing.
+
+    Native endian arrays do not need to be endian swapped, so this function
+    will do nothing.
+
+    \tparam T Type of the array entries.
+
+    \sa SwapEndian::FixupArray(T *,uintptr_t)
+
+***************************************/
+
+/*! ************************************
+
+    \brief Copy an array for NativeEndian::ConvertArray()
+
+    If the pointers are the same, nothing is done, otherwise the data is copied
+    with MemoryCopy().
+
+    \param pOutput Pointer to the buffer to receive the data
+    \param pInput Pointer to the buffer to copy
+    \param uLength Number of bytes to copy
+
+    \sa NativeEndian::ConvertArray(T *,const T *,uintptr_t)
+
+***************************************/
+
+void BURGER_API Burger::NativeEndian::CopyArray(
+    void* pOutput, const void* pInput, uintptr_t uLength) BURGER_NOEXCEPT
+{
+    if (pOutput != pInput) {
+        MemoryCopy(pOutput, pInput, uLength);
+    }
+}
+
 /*! ************************************
 
     \struct Burger::BigEndian
@@ -4006,6 +4095,147 @@ void BURGER_API Burger::NativeEndian::StoreAny(
 
 ***************************************/
 
+/***************************************
+
+    SIMD kernels for array endian conversion.
+
+    Unaligned loads and stores are used so the arrays can start on any
+    address. Since each block is loaded before it is stored, the kernels also
+    work when the input and output pointers are the same.
+
+    Each kernel swaps the bytes in 16 or 32 byte chunks and returns the number
+    of bytes processed. The caller handles the remaining bytes with scalar
+    code. The kernel is selected at runtime with CPUDispatch.
+
+***************************************/
+
+#if defined(BURGER_INTEL) && \
+    (defined(BURGER_SSE2) || defined(BURGER_CPU_DISPATCH)) && \
+    !defined(DOXYGEN)
+#define BURGER_ENDIAN_SIMD
+
+#if defined(BURGER_CPU_DISPATCH)
+#include <immintrin.h>
+#else
+#define BURGER_TARGET_SSE2
+#endif
+
+// pshufb masks for 16, 32 and 64 bit elements, indexed by shift-1
+// clang-format off
+static const uint8_t g_SwapShuffles[3][32] = {
+    {1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14,
+    1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14},
+    {3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12,
+    3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12},
+    {7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8,
+    7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8}};
+// clang-format on
+
+typedef uintptr_t(BURGER_API* ConvertEndianProc)(void* pOutput,
+    const void* pInput, uintptr_t uBytes, uint_t uElementShift);
+
+// SSE2 only, reorder the 16 bit words, then swap the bytes within them
+static BURGER_TARGET_SSE2 uintptr_t BURGER_API ConvertEndianSSE2(
+    void* pOutput, const void* pInput, uintptr_t uBytes,
+    uint_t uElementShift) BURGER_NOEXCEPT
+{
+    uint8_t* pDest = static_cast<uint8_t*>(pOutput);
+    const uint8_t* pSource = static_cast<const uint8_t*>(pInput);
+    uintptr_t uProcessed = 0;
+    while ((uBytes - uProcessed) >= 16) {
+        __m128i vData = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pSource + uProcessed));
+        if (uElementShift == 2) {
+            vData = _mm_shufflelo_epi16(vData, _MM_SHUFFLE(2, 3, 0, 1));
+            vData = _mm_shufflehi_epi16(vData, _MM_SHUFFLE(2, 3, 0, 1));
+        } else if (uElementShift == 3) {
+            vData = _mm_shufflelo_epi16(vData, _MM_SHUFFLE(0, 1, 2, 3));
+            vData = _mm_shufflehi_epi16(vData, _MM_SHUFFLE(0, 1, 2, 3));
+        }
+        vData = _mm_or_si128(_mm_slli_epi16(vData, 8), _mm_srli_epi16(vData, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest + uProcessed), vData);
+        uProcessed += 16;
+    }
+    return uProcessed;
+}
+
+#if defined(BURGER_CPU_DISPATCH)
+
+// Single pshufb per 16 bytes
+static BURGER_TARGET_SSSE3 uintptr_t BURGER_API ConvertEndianSSSE3(
+    void* pOutput, const void* pInput, uintptr_t uBytes,
+    uint_t uElementShift) BURGER_NOEXCEPT
+{
+    uint8_t* pDest = static_cast<uint8_t*>(pOutput);
+    const uint8_t* pSource = static_cast<const uint8_t*>(pInput);
+    uintptr_t uProcessed = 0;
+    const __m128i vShuffle = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(g_SwapShuffles[uElementShift - 1]));
+    while ((uBytes - uProcessed) >= 16) {
+        __m128i vData = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pSource + uProcessed));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest + uProcessed),
+            _mm_shuffle_epi8(vData, vShuffle));
+        uProcessed += 16;
+    }
+    return uProcessed;
+}
+
+// 32 bytes at a time with vpshufb, 16 bytes for the remainder
+static BURGER_TARGET_AVX2 uintptr_t BURGER_API ConvertEndianAVX2(
+    void* pOutput, const void* pInput, uintptr_t uBytes,
+    uint_t uElementShift) BURGER_NOEXCEPT
+{
+    uint8_t* pDest = static_cast<uint8_t*>(pOutput);
+    const uint8_t* pSource = static_cast<const uint8_t*>(pInput);
+    uintptr_t uProcessed = 0;
+    const uint8_t* pShuffle = g_SwapShuffles[uElementShift - 1];
+    const __m256i vShuffle =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pShuffle));
+    while ((uBytes - uProcessed) >= 32) {
+        __m256i vData = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(pSource + uProcessed));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDest + uProcessed),
+            _mm256_shuffle_epi8(vData, vShuffle));
+        uProcessed += 32;
+    }
+    if ((uBytes - uProcessed) >= 16) {
+        __m128i vData = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pSource + uProcessed));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest + uProcessed),
+            _mm_shuffle_epi8(vData, _mm256_castsi256_si128(vShuffle)));
+        uProcessed += 16;
+    }
+    return uProcessed;
+}
+
+// No SIMD, let the scalar code do all the work
+static uintptr_t BURGER_API ConvertEndianNone(void* /* pOutput */,
+    const void* /* pInput */, uintptr_t /* uBytes */,
+    uint_t /* uElementShift */) BURGER_NOEXCEPT
+{
+    return 0;
+}
+
+static const Burger::CPUDispatch::Variant_t g_ConvertEndianVariants[] = {
+    {BURGER_CPU_DISPATCH_PROC(ConvertEndianAVX2), Burger::CPUDispatch::kAVX2,
+        "AVX2"},
+    {BURGER_CPU_DISPATCH_PROC(ConvertEndianSSSE3),
+        Burger::CPUDispatch::kSSSE3, "SSSE3"},
+    {BURGER_CPU_DISPATCH_PROC(ConvertEndianSSE2), Burger::CPUDispatch::kSSE2,
+        "SSE2"},
+    {BURGER_CPU_DISPATCH_PROC(ConvertEndianNone), 0, "Generic"}};
+
+static BURGER_CPU_DISPATCH_DEFINE(g_ConvertEndianDispatch,
+    Burger::CPUDispatch::kFamilyMemory, g_ConvertEndianVariants);
+
+#define ConvertEndianSIMD g_ConvertEndianDispatch.Get<ConvertEndianProc>()
+#else
+#define ConvertEndianSIMD ConvertEndianSSE2
+#endif
+
+#endif
+
 /*! ************************************
 
     \brief Reverse the endian of an array of 16-bit integers
@@ -4013,6 +4243,11 @@ void BURGER_API Burger::NativeEndian::StoreAny(
     Given a pointer to an array of 16-bit integers, swap the endian of every
     entry
 
+    On x86 targets, the bulk of the array is swapped 16 or 32 bytes at a
+    time with SSE2, SSSE3 or AVX2, chosen at runtime by CPUDispatch, and the
+    remaining entries are swapped one at a time. The array does not need to
+    be aligned.
+
     \param pInput Pointer to the array to endian swap
     \param uCount Number of entries in the array (Not bytes)
 
@@ -4022,14 +4257,8 @@ void BURGER_API Burger::NativeEndian::StoreAny(
 
 void BURGER_API Burger::ConvertEndian(uint16_t* pInput, uintptr_t uCount)
 {
-    // Any data?
-    if (uCount) {
-        do {
-            // Swap in place
-            SwapEndian::Fixup(pInput);
-            ++pInput;
-        } while (--uCount);
-    }
+    // The vector kernel is safe to use in place
+    ConvertEndian(pInput, pInput, uCount);
 }
 
 /*! ************************************
@@ -4037,7 +4266,10 @@ void BURGER_API Burger::ConvertEndian(uint16_t* pInput, uintptr_t uCount)
     \brief Reverse the endian of a copied array of 16-bit integers
 
     Given a pointer to an array of 16-bit integers, swap the endian of every
-    entry and store the result into another array of equal or greater size
+    entry and store the result into another array of equal or greater size.
+
+    The input and output can be the same array, but otherwise must not
+    overlap.
 
     \param pOutput Pointer to the array to receive the swapped data
     \param pInput Pointer to the array to endian swap
@@ -4050,6 +4282,13 @@ void BURGER_API Burger::ConvertEndian(uint16_t* pInput, uintptr_t uCount)
 void BURGER_API Burger::ConvertEndian(
     uint16_t* pOutput, const uint16_t* pInput, uintptr_t uCount)
 {
+#if defined(BURGER_ENDIAN_SIMD)
+    uintptr_t uDone =
+        ConvertEndianSIMD(pOutput, pInput, uCount << 1U, 1) >> 1U;
+    pOutput += uDone;
+    pInput += uDone;
+    uCount -= uDone;
+#endif
     // Any data?
     if (uCount) {
         do {
@@ -4068,6 +4307,11 @@ void BURGER_API Burger::ConvertEndian(
     Given a pointer to an array of 32-bit integers, swap the endian of every
     entry
 
+    On x86 targets, the bulk of the array is swapped 16 or 32 bytes at a
+    time with SSE2, SSSE3 or AVX2, chosen at runtime by CPUDispatch, and the
+    remaining entries are swapped one at a time. The array does not need to
+    be aligned.
+
     \param pInput Pointer to the array to endian swap
     \param uCount Number of entries in the array (Not bytes)
 
@@ -4077,14 +4321,8 @@ void BURGER_API Burger::ConvertEndian(
 
 void BURGER_API Burger::ConvertEndian(uint32_t* pInput, uintptr_t uCount)
 {
-    // Any data?
-    if (uCount) {
-        do {
-            // Swap in place
-            SwapEndian::Fixup(pInput);
-            ++pInput;
-        } while (--uCount);
-    }
+    // The vector kernel is safe to use in place
+    ConvertEndian(pInput, pInput, uCount);
 }
 
 /*! ************************************
@@ -4092,7 +4330,10 @@ void BURGER_API Burger::ConvertEndian(uint32_t* pInput, uintptr_t uCount)
     \brief Reverse the endian of a copied array of 32-bit integers
 
     Given a pointer to an array of 32-bit integers, swap the endian of every
-    entry and store the result into another array of equal or greater size
+    entry and store the result into another array of equal or greater size.
+
+    The input and output can be the same array, but otherwise must not
+    overlap.
 
     \param pOutput Pointer to the array to receive the swapped data
     \param pInput Pointer to the array to endian swap
@@ -4105,6 +4346,13 @@ void BURGER_API Burger::ConvertEndian(uint32_t* pInput, uintptr_t uCount)
 void BURGER_API Burger::ConvertEndian(
     uint32_t* pOutput, const uint32_t* pInput, uintptr_t uCount)
 {
+#if defined(BURGER_ENDIAN_SIMD)
+    uintptr_t uDone =
+        ConvertEndianSIMD(pOutput, pInput, uCount << 2U, 2) >> 2U;
+    pOutput += uDone;
+    pInput += uDone;
+    uCount -= uDone;
+#endif
     // Any data?
     if (uCount) {
         do {
@@ -4123,6 +4371,11 @@ void BURGER_API Burger::ConvertEndian(
     Given a pointer to an array of 64-bit integers, swap the endian of every
     entry
 
+    On x86 targets, the bulk of the array is swapped 16 or 32 bytes at a
+    time with SSE2, SSSE3 or AVX2, chosen at runtime by CPUDispatch, and the
+    remaining entries are swapped one at a time. The array does not need to
+    be aligned.
+
     \param pInput Pointer to the array to endian swap
     \param uCount Number of entries in the array (Not bytes)
 
@@ -4132,14 +4385,8 @@ void BURGER_API Burger::ConvertEndian(
 
 void BURGER_API Burger::ConvertEndian(uint64_t* pInput, uintptr_t uCount)
 {
-    // Any data?
-    if (uCount) {
-        do {
-            // Swap in place
-            SwapEndian::Fixup(pInput);
-            ++pInput;
-        } while (--uCount);
-    }
+    // The vector kernel is safe to use in place
+    ConvertEndian(pInput, pInput, uCount);
 }
 
 /*! ************************************
@@ -4147,7 +4394,10 @@ void BURGER_API Burger::ConvertEndian(uint64_t* pInput, uintptr_t uCount)
     \brief Reverse the endian of a copied array of 64-bit integers
 
     Given a pointer to an array of 64-bit integers, swap the endian of every
-    entry and store the result into another array of equal or greater size
+    entry and store the result into another array of equal or greater size.
+
+    The input and output can be the same array, but otherwise must not
+    overlap.
 
     \param pOutput Pointer to the array to receive the swapped data
     \param pInput Pointer to the array to endian swap
@@ -4160,6 +4410,13 @@ void BURGER_API Burger::ConvertEndian(uint64_t* pInput, uintptr_t uCount)
 void BURGER_API Burger::ConvertEndian(
     uint64_t* pOutput, const uint64_t* pInput, uintptr_t uCount)
 {
+#if defined(BURGER_ENDIAN_SIMD)
+    uintptr_t uDone =
+        ConvertEndianSIMD(pOutput, pInput, uCount << 3U, 3) >> 3U;
+    pOutput += uDone;
+    pInput += uDone;
+    uCount -= uDone;
+#endif
     // Any data?
     if (uCount) {
         do {
@@ -4181,6 +4438,56 @@ void BURGER_API Burger::ConvertEndian(
     }
 }
 
+/*! ************************************
+
+    \fn Burger::ConvertEndian(float *pInput,uintptr_t uCount)
+    \brief Reverse the endian of an array of floats
+
+    \param pInput Pointer to the array to endian swap
+    \param uCount Number of entries in the array (Not bytes)
+
+    \sa ConvertEndian(uint32_t *,uintptr_t)
+
+***************************************/
+
+/*! ************************************
+
+    \fn Burger::ConvertEndian(float *pOutput,const float *pInput,uintptr_t uCount)
+    \brief Reverse the endian of a copied array of floats
+
+    \param pOutput Pointer to the array to receive the swapped data
+    \param pInput Pointer to the array to endian swap
+    \param uCount Number of entries in the array (Not bytes)
+
+    \sa ConvertEndian(uint32_t *,const uint32_t *,uintptr_t)
+
+***************************************/
+
+/*! ************************************
+
+    \fn Burger::ConvertEndian(double *pInput,uintptr_t uCount)
+    \brief Reverse the endian of an array of doubles
+
+    \param pInput Pointer to the array to endian swap
+    \param uCount Number of entries in the array (Not bytes)
+
+    \sa ConvertEndian(uint64_t *,uintptr_t)
+
+***************************************/
+
+/*! ************************************
+
+    \fn Burger::ConvertEndian(double *pOutput,const double *pInput,uintptr_t uCount)
+    \brief Reverse the endian of a copied array of doubles
+
+    \param pOutput Pointer to the array to receive the swapped data
+    \param pInput Pointer to the array to endian swap
+    \param uCount Number of entries in the array (Not bytes)
+
+    \sa ConvertEndian(uint64_t *,const uint64_t *,uintptr_t)
+
+***************************************/
+
 /*! ************************************
 
     \brief Add 128 to every byte to convert a char to a byte or vice versa
@@ -47,6 +47,27 @@
 
 namespace Burger {
 
+extern void BURGER_API ConvertEndian(uint16_t* pInput, uintptr_t uCount);
+extern void BURGER_API ConvertEndian(
+    uint16_t* pOutput, const uint16_t* pInput, uintptr_t uCount);
+extern void BURGER_API ConvertEndian(uint32_t* pInput, uintptr_t uCount);
+extern void BURGER_API ConvertEndian(
+    uint32_t* pOutput, const uint32_t* pInput, uintptr_t uCount);
+extern void BURGER_API ConvertEndian(uint64_t* pInput, uintptr_t uCount);
+extern void BURGER_API ConvertEndian(
+    uint64_t* pOutput, const uint64_t* pInput, uintptr_t uCount);
+
+// clang-format off
+BURGER_INLINE void ConvertEndian(float* pInput, uintptr_t uCount) BURGER_NOEXCEPT {
+    ConvertEndian(reinterpret_cast<uint32_t*>(pInput), uCount); }
+BURGER_INLINE void ConvertEndian(float* pOutput, const float* pInput, uintptr_t uCount) BURGER_NOEXCEPT {
+    ConvertEndian(reinterpret_cast<uint32_t*>(pOutput), reinterpret_cast<const uint32_t*>(pInput), uCount); }
+BURGER_INLINE void ConvertEndian(double* pInput, uintptr_t uCount) BURGER_NOEXCEPT {
+    ConvertEndian(reinterpret_cast<uint64_t*>(pInput), uCount); }
+BURGER_INLINE void ConvertEndian(double* pOutput, const double* pInput, uintptr_t uCount) BURGER_NOEXCEPT {
+    ConvertEndian(reinterpret_cast<uint64_t*>(pOutput), reinterpret_cast<const uint64_t*>(pInput), uCount); }
+// clang-format on
+
 struct SwapEndian {
 
     // clang-format off
@@ -515,6 +536,25 @@ struct SwapEndian {
     static BURGER_INLINE void FixupAny(signed long*pInput) BURGER_NOEXCEPT {
         FixupAny(reinterpret_cast<ulong2uint_t *>(pInput)); }
 #endif
+    static BURGER_INLINE void ConvertArray(uint16_t* pOutput, const uint16_t* pInput, uintptr_t uCount) BURGER_NOEXCEPT {
+        ConvertEndian(pOutput, pInput, uCount); }
+    static BURGER_INLINE void ConvertArray(int16_t* pOutput, const int16_t* pInput, uintptr_t uCount) BURGER_NOEXCEPT {
+        ConvertEndian(reinterpret_cast<uint16_t*>(pOutput), reinterpret_cast<const uint16_t*>(pInput), uCount); }
+    static BURGER_INLINE void ConvertArray(uint32_t* pOutput, const uint32_t* pInput, uintptr_t uCount) BURGER_NOEXCEPT {
+        ConvertEndian(pOutput, pInput, uCount); }
+    static BURGER_INLINE void ConvertArray(int32_t* pOutput, const int32_t* pInput, uintptr_t uCount) BURGER_NOEXCEPT {
+        ConvertEndian(reinterpret_cast<uint32_t*>(pOutput), reinterpret_cast<const uint32_t*>(pInput), uCount); }
+    static BURGER_INLINE void ConvertArray(uint64_t* pOutput, const uint64_t* pInput, uintptr_t uCount) BURGER_NOEXCEPT {
+        ConvertEndian(pOutput, pInput, uCount); }
+    static BURGER_INLINE void ConvertArray(int64_t* pOutput, const int64_t* pInput, uintptr_t uCount) BURGER_NOEXCEPT {
+        ConvertEndian(reinterpret_cast<uint64_t*>(pOutput), reinterpret_cast<const uint64_t*>(pInput), uCount); }
+    static BURGER_INLINE void ConvertArray(float* pOutput, const float* pInput, uintptr_t uCount) BURGER_NOEXCEPT {
+        ConvertEndian(pOutput, pInput, uCount); }
+    static BURGER_INLINE void ConvertArray(double* pOutput, const double* pInput, uintptr_t uCount) BURGER_NOEXCEPT {
+        ConvertEndian(pOutput, pInput, uCount); }
+    template<typename T>
+    static BURGER_INLINE void FixupArray(T* pInput, uintptr_t uCount) BURGER_NOEXCEPT {
+        ConvertArray(pInput, pInput, uCount); }
     // clang-format on
 };
 
@@ -665,6 +705,21 @@ struct NativeEndian {
     static BURGER_INLINE void FixupAny(T) BURGER_NOEXCEPT
     {
     }
+
+    static void BURGER_API CopyArray(
+        void* pOutput, const void* pInput, uintptr_t uLength) BURGER_NOEXCEPT;
+
+    template<typename T>
+    static BURGER_INLINE void ConvertArray(
+        T* pOutput, const T* pInput, uintptr_t uCount) BURGER_NOEXCEPT
+    {
+        CopyArray(pOutput, pInput, uCount * sizeof(T));
+    }
+
+    template<typename T>
+    static BURGER_INLINE void FixupArray(T*, uintptr_t) BURGER_NOEXCEPT
+    {
+    }
 };
 
 #if (defined(BURGER_METROWERKS) && defined(BURGER_X86))
@@ -700,15 +755,6 @@ struct BigEndian: public NativeEndian {
 
 #endif
 
-extern void BURGER_API ConvertEndian(uint16_t* pInput, uintptr_t uCount);
-extern void BURGER_API ConvertEndian(
-    uint16_t* pOutput, const uint16_t* pInput, uintptr_t uCount);
-extern void BURGER_API ConvertEndian(uint32_t* pInput, uintptr_t uCount);
-extern void BURGER_API ConvertEndian(
-    uint32_t* pOutput, const uint32_t* pInput, uintptr_t uCount);
-extern void BURGER_API ConvertEndian(uint64_t* pInput, uintptr_t uCount);
-extern void BURGER_API ConvertEndian(
-    uint64_t* pOutput, const uint64_t* pInput, uintptr_t uCount);
 extern void BURGER_API SwapCharsToBytes(void* pInput, uintptr_t uLength);
 extern void BURGER_API SwapCharsToBytes(
     void* pOutput, const void* pInput, uintptr_t uLength);
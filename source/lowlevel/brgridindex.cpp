@@ -15,6 +15,246 @@
 
 #include "brgridindex.h"
 #include "brfixedpoint.h"
+#include "brcriticalsection.h"
+#include "brmemoryfunctions.h"
+
+/***************************************
+
+	Bulk build support
+
+	Build() uses a counting sort. The input is split into one
+	chunk per thread, each thread creates a histogram of the cells
+	its chunk touches, the histograms are turned into per thread
+	starting offsets and then each thread scatters its chunk into
+	the packed arrays. Since each thread has its own offsets,
+	no locking is needed and the output is identical to a single
+	threaded build.
+
+***************************************/
+
+#if !defined(DOXYGEN)
+static const Word g_uMaxBuildThreads = 16;		// Maximum number of threads for Build()
+static const WordPtr g_uMinItemsPerThread = 4096;	// Don't bother spawning a thread for less than this
+
+struct GridBuildJob_t {
+	void (BURGER_API *m_pCallback)(GridBuildJob_t *pJob);	// Pass to execute
+	const void *m_pParent;		// GridIndexPoints or GridIndexBox
+	const void *m_pInput;		// Vector2D_t or Vector4D_t input array
+	const Word *m_pValues;		// Input payloads
+	Word *m_pCells;				// Cell index (1 per point, 4 per box)
+	WordPtr *m_pOffsets;		// This thread's histogram, then scatter offsets
+	void *m_pOutput[7];			// Packed output arrays
+	WordPtr m_uStart;			// First item to process
+	WordPtr m_uEnd;				// Item to stop at
+};
+
+static WordPtr BURGER_API GridBuildThread(void *pData)
+{
+	GridBuildJob_t *pJob = static_cast<GridBuildJob_t *>(pData);
+	pJob->m_pCallback(pJob);
+	return 0;
+}
+
+//
+// Execute a pass over all the jobs, one thread per job
+// If a thread can't be started, the pass is run on this thread
+//
+
+static void BURGER_API RunGridBuildJobs(GridBuildJob_t *pJobs,Word uJobCount,void (BURGER_API *pCallback)(GridBuildJob_t *))
+{
+	Word i = 0;
+	do {
+		pJobs[i].m_pCallback = pCallback;
+	} while (++i<uJobCount);
+	Burger::RunThreadJobs(GridBuildThread,pJobs,sizeof(GridBuildJob_t),uJobCount);
+}
+
+//
+// Determine how many threads to use for a build
+//
+
+static Word BURGER_API GetGridBuildThreadCount(WordPtr uCount,Word uThreadCount)
+{
+	WordPtr uMax = uCount/g_uMinItemsPerThread;
+	if (uThreadCount>uMax) {
+		uThreadCount = static_cast<Word>(uMax);
+	}
+	if (uThreadCount>g_uMaxBuildThreads) {
+		uThreadCount = g_uMaxBuildThreads;
+	}
+	if (!uThreadCount) {
+		uThreadCount = 1;
+	}
+	return uThreadCount;
+}
+
+//
+// Convert the per thread histograms into per thread scatter offsets
+// and the cell starting indexes. Cells are processed in order,
+// and threads in order within each cell so the sort is stable
+//
+
+static void BURGER_API PrefixGridHistograms(WordPtr *pCellStarts,GridBuildJob_t *pJobs,Word uJobCount,WordPtr uCellCount)
+{
+	WordPtr uTotal = 0;
+	WordPtr uCell = 0;
+	do {
+		pCellStarts[uCell] = uTotal;
+		Word i = 0;
+		do {
+			WordPtr uTemp = pJobs[i].m_pOffsets[uCell];
+			pJobs[i].m_pOffsets[uCell] = uTotal;
+			uTotal += uTemp;
+		} while (++i<uJobCount);
+	} while (++uCell<uCellCount);
+	pCellStarts[uCellCount] = uTotal;
+}
+
+static void BURGER_API GridPointsCount(GridBuildJob_t *pJob)
+{
+	const Burger::GridIndexPoints *pParent = static_cast<const Burger::GridIndexPoints *>(pJob->m_pParent);
+	const Burger::Vector2D_t *pPoints = static_cast<const Burger::Vector2D_t *>(pJob->m_pInput);
+	Word uXCells = pParent->GetXCells();
+	WordPtr *pHistogram = pJob->m_pOffsets;
+	WordPtr i = pJob->m_uStart;
+	WordPtr uEnd = pJob->m_uEnd;
+	while (i<uEnd) {
+		Burger::Vector2D_t vCell;
+		pParent->GetContainingCellClamped(&vCell,&pPoints[i]);
+		Word uCell = (static_cast<Word>(static_cast<int>(vCell.y))*uXCells)+static_cast<Word>(static_cast<int>(vCell.x));
+		pJob->m_pCells[i] = uCell;
+		++pHistogram[uCell];
+		++i;
+	}
+}
+
+static void BURGER_API GridPointsScatter(GridBuildJob_t *pJob)
+{
+	const Burger::Vector2D_t *pPoints = static_cast<const Burger::Vector2D_t *>(pJob->m_pInput);
+	float *pX = static_cast<float *>(pJob->m_pOutput[0]);
+	float *pY = static_cast<float *>(pJob->m_pOutput[1]);
+	Word *pValues = static_cast<Word *>(pJob->m_pOutput[2]);
+	WordPtr *pOffsets = pJob->m_pOffsets;
+	WordPtr i = pJob->m_uStart;
+	WordPtr uEnd = pJob->m_uEnd;
+	while (i<uEnd) {
+		WordPtr uSlot = pOffsets[pJob->m_pCells[i]]++;
+		pX[uSlot] = pPoints[i].x;
+		pY[uSlot] = pPoints[i].y;
+		pValues[uSlot] = pJob->m_pValues[i];
+		++i;
+	}
+}
+
+static void BURGER_API GridBoxesCount(GridBuildJob_t *pJob)
+{
+	const Burger::GridIndexBox *pParent = static_cast<const Burger::GridIndexBox *>(pJob->m_pParent);
+	const Burger::Vector4D_t *pBoxes = static_cast<const Burger::Vector4D_t *>(pJob->m_pInput);
+	Word uXCells = pParent->GetXCells();
+	WordPtr *pHistogram = pJob->m_pOffsets;
+	WordPtr i = pJob->m_uStart;
+	WordPtr uEnd = pJob->m_uEnd;
+	while (i<uEnd) {
+		Burger::Vector4D_t CellRect;
+		pParent->GetContainingCellsClamped(&CellRect,&pBoxes[i]);
+		Word *pCells = &pJob->m_pCells[i*4];
+		Word uLeft = static_cast<Word>(static_cast<int>(CellRect.x));
+		Word uTop = static_cast<Word>(static_cast<int>(CellRect.y));
+		Word uRight = static_cast<Word>(static_cast<int>(CellRect.z));
+		Word uBottom = static_cast<Word>(static_cast<int>(CellRect.w));
+		pCells[0] = uLeft;
+		pCells[1] = uTop;
+		pCells[2] = uRight;
+		pCells[3] = uBottom;
+		for (Word iy = uTop; iy <= uBottom; iy++) {
+			WordPtr *pRow = &pHistogram[iy*uXCells];
+			for (Word ix = uLeft; ix <= uRight; ix++) {
+				++pRow[ix];
+			}
+		}
+		++i;
+	}
+}
+
+static void BURGER_API GridBoxesScatter(GridBuildJob_t *pJob)
+{
+	const Burger::GridIndexBox *pParent = static_cast<const Burger::GridIndexBox *>(pJob->m_pParent);
+	const Burger::Vector4D_t *pBoxes = static_cast<const Burger::Vector4D_t *>(pJob->m_pInput);
+	Word uXCells = pParent->GetXCells();
+	WordPtr *pItems = static_cast<WordPtr *>(pJob->m_pOutput[0]);
+	float *pLeft = static_cast<float *>(pJob->m_pOutput[1]);
+	float *pTop = static_cast<float *>(pJob->m_pOutput[2]);
+	float *pRight = static_cast<float *>(pJob->m_pOutput[3]);
+	float *pBottom = static_cast<float *>(pJob->m_pOutput[4]);
+	Word *pValues = static_cast<Word *>(pJob->m_pOutput[5]);
+	Word *pFirstCells = static_cast<Word *>(pJob->m_pOutput[6]);
+	WordPtr *pOffsets = pJob->m_pOffsets;
+	WordPtr i = pJob->m_uStart;
+	WordPtr uEnd = pJob->m_uEnd;
+	while (i<uEnd) {
+		// The box data stays in input order, only the indexes are sorted
+		pLeft[i] = pBoxes[i].x;
+		pTop[i] = pBoxes[i].y;
+		pRight[i] = pBoxes[i].z;
+		pBottom[i] = pBoxes[i].w;
+		pValues[i] = pJob->m_pValues[i];
+		const Word *pCells = &pJob->m_pCells[i*4];
+		pFirstCells[i] = (pCells[1]<<16U)+pCells[0];
+		for (Word iy = pCells[1]; iy <= pCells[3]; iy++) {
+			WordPtr *pRow = &pOffsets[iy*uXCells];
+			for (Word ix = pCells[0]; ix <= pCells[2]; ix++) {
+				pItems[pRow[ix]++] = i;
+			}
+		}
+		++i;
+	}
+}
+
+//
+// Split the input into chunks, run the count pass and the prefix sum.
+// Returns kErrorOutOfMemory if the temporary buffers couldn't be allocated.
+// On success, pCellStarts[uCellCount] has the number of slots needed for
+// the packed data
+//
+
+static Burger::eError BURGER_API CountGridIndex(GridBuildJob_t *pJobs,Word uJobCount,WordPtr uCount,WordPtr uCellCount,WordPtr *pCellStarts,
+	Word uCellsPerItem,void (BURGER_API *pCount)(GridBuildJob_t *))
+{
+	Word *pCells = static_cast<Word *>(Burger::Alloc(sizeof(Word)*uCellsPerItem*uCount));
+	WordPtr *pHistograms = static_cast<WordPtr *>(Burger::AllocClear(sizeof(WordPtr)*uCellCount*uJobCount));
+	if (!pCells || !pHistograms) {
+		Burger::Free(pHistograms);
+		Burger::Free(pCells);
+		return Burger::kErrorOutOfMemory;
+	}
+	WordPtr uChunk = uCount/uJobCount;
+	Word i = 0;
+	do {
+		pJobs[i].m_pCells = pCells;
+		pJobs[i].m_pOffsets = &pHistograms[uCellCount*i];
+		pJobs[i].m_uStart = uChunk*i;
+		pJobs[i].m_uEnd = ((i+1)==uJobCount) ? uCount : (uChunk*(i+1));
+	} while (++i<uJobCount);
+
+	RunGridBuildJobs(pJobs,uJobCount,pCount);
+	PrefixGridHistograms(pCellStarts,pJobs,uJobCount,uCellCount);
+	return Burger::kErrorNone;
+}
+
+//
+// Run the scatter pass if requested and release the temporary buffers
+// allocated by CountGridIndex()
+//
+
+static void BURGER_API FinishGridIndex(GridBuildJob_t *pJobs,Word uJobCount,void (BURGER_API *pScatter)(GridBuildJob_t *))
+{
+	if (pScatter) {
+		RunGridBuildJobs(pJobs,uJobCount,pScatter);
+	}
+	Burger::Free(pJobs[0].m_pOffsets);
+	Burger::Free(pJobs[0].m_pCells);
+}
+#endif
 
 /*! ************************************
 
@@ -171,6 +411,11 @@ void BURGER_API Burger::GridIndexPoints::GetContainingCellClamped(Vector2D_t *pO
 
 Burger::GridIndexPoints::GridIndexPoints(const Vector4D_t *pBounds,Word uXCells,Word uYCells) :
 	m_BoundsRect(pBounds[0]),
+	m_pCellStarts(NULL),
+	m_pPackedX(NULL),
+	m_pPackedY(NULL),
+	m_pPackedValues(NULL),
+	m_uPackedCount(0),
 	m_uXCells(uXCells),
 	m_uYCells(uYCells),
 	m_fXCells(static_cast<float>(static_cast<int>(uXCells))),
@@ -204,7 +449,12 @@ Burger::GridIndexPoints::GridIndexPoints(const Vector4D_t *pBounds,Word uXCells,
 ***************************************/
 
 Burger::GridIndexPoints::GridIndexPoints(const Vector4D_t *pBounds,WordPtr uItemCountEstimate,float fGridScale) :
-	m_BoundsRect(pBounds[0])
+	m_BoundsRect(pBounds[0]),
+	m_pCellStarts(NULL),
+	m_pPackedX(NULL),
+	m_pPackedY(NULL),
+	m_pPackedValues(NULL),
+	m_uPackedCount(0)
 {
 	// Figure out the optimum size
 	ChooseGridSize(&m_uXCells,&m_uYCells,pBounds,uItemCountEstimate,fGridScale);
@@ -246,6 +496,7 @@ Burger::GridIndexPoints::~GridIndexPoints()
 		} while (--uCount);
 	}
 	Free(m_ppGrid);
+	ClearPacked();
 }
 
 /*! ************************************
@@ -259,6 +510,24 @@ Burger::GridIndexPoints::~GridIndexPoints()
 
 ***************************************/
 
+/*! ************************************
+
+	\fn Word Burger::GridIndexPoints::GetXCells(void) const
+	\brief Return the width of the grid in cells
+
+	\return Number of cells wide
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::GridIndexPoints::GetYCells(void) const
+	\brief Return the height of the grid in cells
+
+	\return Number of cells high
+
+***************************************/
+
 /*! ************************************
 
 	\struct Burger::GridIndexPoints::iterator
@@ -529,6 +798,313 @@ Burger::GridIndexPoints::iterator Burger::GridIndexPoints::find(const Vector2D_t
 }
 
 
+/*! ************************************
+
+	\struct Burger::GridIndexSpan_t
+	\brief Range of packed entries in a grid
+
+	GridIndexPoints and GridIndexBox can be bulk built into
+	arrays sorted by cell. Queries on the packed data return
+	ranges of these arrays instead of linked entries.
+
+	\sa GridIndexPoints::Build(const Vector2D_t *,const Word *,WordPtr,Word) or
+		GridIndexBox::Build(const Vector4D_t *,const Word *,WordPtr,Word)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Bulk build the packed grid from an array of points
+
+	Instead of linking each point into the grid one at a time with
+	add(const Vector2D_t *,Word), this function sorts all the points
+	by cell with a counting sort and stores them in contiguous arrays
+	of X coordinates, Y coordinates and values. Cells are stored in
+	row major order, so all of the points in a horizontal run of cells
+	are contiguous in memory.
+
+	The points are processed in order, so points within a single cell
+	retain the order they were passed in.
+
+	The packed data is separate from the entries created with add(),
+	and any previously built packed data is discarded.
+
+	\param pPoints Pointer to an array of points
+	\param pValues Pointer to an array of values, one per point
+	\param uCount Number of points to sort into the grid
+	\param uThreadCount Maximum number of threads to use for sorting
+	\return kErrorNone if successful, kErrorOutOfMemory on an allocation failure
+
+	\sa ClearPacked(void) or QueryPoints(GridIndexSpan_t *,const Vector2D_t *,WordPtr) const
+
+***************************************/
+
+Burger::eError BURGER_API Burger::GridIndexPoints::Build(const Vector2D_t *pPoints,const Word *pValues,WordPtr uCount,Word uThreadCount)
+{
+	ClearPacked();
+	WordPtr uCellCount = static_cast<WordPtr>(m_uXCells) * m_uYCells;
+	m_pCellStarts = static_cast<WordPtr *>(AllocClear(sizeof(WordPtr)*(uCellCount+1)));
+	if (!m_pCellStarts) {
+		return kErrorOutOfMemory;
+	}
+	if (!uCount) {
+		return kErrorNone;
+	}
+
+	GridBuildJob_t Jobs[g_uMaxBuildThreads];
+	MemoryClear(Jobs,sizeof(Jobs));
+	Word uJobCount = GetGridBuildThreadCount(uCount,uThreadCount);
+	Word i = 0;
+	do {
+		Jobs[i].m_pParent = this;
+		Jobs[i].m_pInput = pPoints;
+		Jobs[i].m_pValues = pValues;
+	} while (++i<uJobCount);
+
+	eError uResult = CountGridIndex(Jobs,uJobCount,uCount,uCellCount,m_pCellStarts,1,GridPointsCount);
+	if (!uResult) {
+		m_pPackedX = static_cast<float *>(Alloc(sizeof(float)*uCount));
+		m_pPackedY = static_cast<float *>(Alloc(sizeof(float)*uCount));
+		m_pPackedValues = static_cast<Word *>(Alloc(sizeof(Word)*uCount));
+		if (!m_pPackedX || !m_pPackedY || !m_pPackedValues) {
+			FinishGridIndex(Jobs,uJobCount,NULL);
+			uResult = kErrorOutOfMemory;
+		} else {
+			i = 0;
+			do {
+				Jobs[i].m_pOutput[0] = m_pPackedX;
+				Jobs[i].m_pOutput[1] = m_pPackedY;
+				Jobs[i].m_pOutput[2] = m_pPackedValues;
+			} while (++i<uJobCount);
+			FinishGridIndex(Jobs,uJobCount,GridPointsScatter);
+			m_uPackedCount = uCount;
+		}
+	}
+	if (uResult) {
+		ClearPacked();
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Release the packed grid
+
+	Dispose of all memory allocated by Build(const Vector2D_t *,const Word *,WordPtr,Word).
+	Entries added with add(const Vector2D_t *,Word) are not affected.
+
+	\sa Build(const Vector2D_t *,const Word *,WordPtr,Word)
+
+***************************************/
+
+void BURGER_API Burger::GridIndexPoints::ClearPacked(void)
+{
+	Free(m_pCellStarts);
+	m_pCellStarts = NULL;
+	Free(m_pPackedX);
+	m_pPackedX = NULL;
+	Free(m_pPackedY);
+	m_pPackedY = NULL;
+	Free(m_pPackedValues);
+	m_pPackedValues = NULL;
+	m_uPackedCount = 0;
+}
+
+/*! ************************************
+
+	\fn WordPtr Burger::GridIndexPoints::GetPackedCount(void) const
+	\brief Return the number of packed entries
+
+	\return Number of points sorted with Build(const Vector2D_t *,const Word *,WordPtr,Word)
+
+***************************************/
+
+/*! ************************************
+
+	\fn const float *Burger::GridIndexPoints::GetPackedX(void) const
+	\brief Return the packed X coordinates
+
+	\return Pointer to the array of X coordinates sorted by cell
+
+***************************************/
+
+/*! ************************************
+
+	\fn const float *Burger::GridIndexPoints::GetPackedY(void) const
+	\brief Return the packed Y coordinates
+
+	\return Pointer to the array of Y coordinates sorted by cell
+
+***************************************/
+
+/*! ************************************
+
+	\fn const Word *Burger::GridIndexPoints::GetPackedValues(void) const
+	\brief Return the packed values
+
+	\return Pointer to the array of values sorted by cell
+
+***************************************/
+
+/*! ************************************
+
+	\fn GridIndexSpan_t Burger::GridIndexPoints::GetCellSpan(Word uX,Word uY) const
+	\brief Return the range of packed entries in a cell
+
+	\note Build(const Vector2D_t *,const Word *,WordPtr,Word) must have been called.
+
+	\param uX X coordinate in the grid
+	\param uY Y coordinate in the grid
+	\return Span of the packed arrays for this cell
+
+***************************************/
+
+/*! ************************************
+
+	\brief Get the ranges of packed entries that intersect a rectangle
+
+	Since the packed cells are stored in row major order, each row
+	of cells touched by the rectangle is a single range in the packed
+	arrays. Empty rows are skipped.
+
+	The entries in the spans are in cells that overlap the rectangle,
+	but the entries themselves may lie outside of it. Use
+	QueryBoxes(GridIndexSpan_t *,SimpleArray<WordPtr> *,const Vector4D_t *,WordPtr) const
+	for an exact test.
+
+	\param pOutput Pointer to an array of at least GetYCells() spans
+	\param pBounds Pointer to the rectangle to test
+	\return Number of spans written to pOutput
+
+***************************************/
+
+WordPtr BURGER_API Burger::GridIndexPoints::GetRowSpans(GridIndexSpan_t *pOutput,const Vector4D_t *pBounds) const
+{
+	WordPtr uResult = 0;
+	if (m_uPackedCount) {
+		Vector2D_t vTopLeft;
+		Vector2D_t vBottomRight;
+		GetContainingCellClamped(&vTopLeft,pBounds->GetTopLeft());
+		GetContainingCellClamped(&vBottomRight,pBounds->GetBottomRight());
+		Word uLeft = static_cast<Word>(static_cast<int>(vTopLeft.x));
+		Word uRight = static_cast<Word>(static_cast<int>(vBottomRight.x));
+		Word uY = static_cast<Word>(static_cast<int>(vTopLeft.y));
+		Word uBottom = static_cast<Word>(static_cast<int>(vBottomRight.y));
+		do {
+			WordPtr uRow = static_cast<WordPtr>(uY * m_uXCells);
+			WordPtr uStart = m_pCellStarts[uRow+uLeft];
+			WordPtr uEnd = m_pCellStarts[uRow+uRight+1];
+			if (uEnd!=uStart) {
+				pOutput[uResult].m_uStart = uStart;
+				pOutput[uResult].m_uCount = uEnd-uStart;
+				++uResult;
+			}
+		} while (++uY<=uBottom);
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Find the packed entries for a batch of points
+
+	For each point, return the range of packed entries that are
+	in the same cell as the point. The packed arrays can then
+	be scanned for exact matches.
+
+	\param pOutput Pointer to an array of spans, one per point
+	\param pPoints Pointer to the array of points to look up
+	\param uCount Number of points to look up
+
+	\sa Build(const Vector2D_t *,const Word *,WordPtr,Word)
+
+***************************************/
+
+void BURGER_API Burger::GridIndexPoints::QueryPoints(GridIndexSpan_t *pOutput,const Vector2D_t *pPoints,WordPtr uCount) const
+{
+	if (uCount) {
+		do {
+			if (!m_uPackedCount) {
+				pOutput->m_uStart = 0;
+				pOutput->m_uCount = 0;
+			} else {
+				Vector2D_t vCellIndex;
+				GetContainingCellClamped(&vCellIndex,pPoints);
+				WordPtr uIndex = GetCellIndex(&vCellIndex);
+				pOutput->m_uStart = m_pCellStarts[uIndex];
+				pOutput->m_uCount = m_pCellStarts[uIndex+1]-m_pCellStarts[uIndex];
+			}
+			++pPoints;
+			++pOutput;
+		} while (--uCount);
+	}
+}
+
+/*! ************************************
+
+	\brief Find the packed entries inside a batch of rectangles
+
+	For each rectangle, the indexes of all packed entries that are
+	inside of it (Edges inclusive) are appended to pIndexes. The
+	span for each rectangle is the range in pIndexes that holds
+	its results.
+
+	\note pIndexes is cleared before the query is performed
+
+	\param pOutput Pointer to an array of spans, one per rectangle
+	\param pIndexes Pointer to the array to receive the indexes of packed entries
+	\param pBoxes Pointer to the array of rectangles to test
+	\param uCount Number of rectangles to test
+
+	\sa Build(const Vector2D_t *,const Word *,WordPtr,Word)
+
+***************************************/
+
+void BURGER_API Burger::GridIndexPoints::QueryBoxes(GridIndexSpan_t *pOutput,SimpleArray<WordPtr> *pIndexes,const Vector4D_t *pBoxes,WordPtr uCount) const
+{
+	pIndexes->clear();
+	if (uCount) {
+		const float *pX = m_pPackedX;
+		const float *pY = m_pPackedY;
+		do {
+			WordPtr uFirst = pIndexes->size();
+			if (m_uPackedCount) {
+				float fLeft = pBoxes->x;
+				float fTop = pBoxes->y;
+				float fRight = pBoxes->z;
+				float fBottom = pBoxes->w;
+				Vector2D_t vTopLeft;
+				Vector2D_t vBottomRight;
+				GetContainingCellClamped(&vTopLeft,pBoxes->GetTopLeft());
+				GetContainingCellClamped(&vBottomRight,pBoxes->GetBottomRight());
+				Word uLeft = static_cast<Word>(static_cast<int>(vTopLeft.x));
+				Word uRight = static_cast<Word>(static_cast<int>(vBottomRight.x));
+				Word uY = static_cast<Word>(static_cast<int>(vTopLeft.y));
+				Word uBottom = static_cast<Word>(static_cast<int>(vBottomRight.y));
+				do {
+					WordPtr uRow = static_cast<WordPtr>(uY * m_uXCells);
+					WordPtr i = m_pCellStarts[uRow+uLeft];
+					WordPtr uEnd = m_pCellStarts[uRow+uRight+1];
+					// Scan the contiguous run of cells
+					while (i<uEnd) {
+						float fX = pX[i];
+						float fY = pY[i];
+						if ((fX>=fLeft) && (fX<=fRight) && (fY>=fTop) && (fY<=fBottom)) {
+							pIndexes->push_back(i);
+						}
+						++i;
+					}
+				} while (++uY<=uBottom);
+			}
+			pOutput->m_uStart = uFirst;
+			pOutput->m_uCount = pIndexes->size()-uFirst;
+			++pBoxes;
+			++pOutput;
+		} while (--uCount);
+	}
+}
+
+
 
 
 /*! ************************************
@@ -643,6 +1219,15 @@ void BURGER_API Burger::GridIndexBox::GetContainingCellsClamped(Vector4D_t *pOut
 
 Burger::GridIndexBox::GridIndexBox(const Vector4D_t *pBounds,Word uXCells,Word uYCells) :
 	m_BoundsRect(pBounds[0]),
+	m_pCellStarts(NULL),
+	m_pCellItems(NULL),
+	m_pPackedLeft(NULL),
+	m_pPackedTop(NULL),
+	m_pPackedRight(NULL),
+	m_pPackedBottom(NULL),
+	m_pPackedValues(NULL),
+	m_pPackedFirstCells(NULL),
+	m_uPackedCount(0),
 	m_uXCells(uXCells),
 	m_uYCells(uYCells),
 	m_fXCells(static_cast<float>(static_cast<int>(uXCells))),
@@ -678,6 +1263,15 @@ Burger::GridIndexBox::GridIndexBox(const Vector4D_t *pBounds,Word uXCells,Word u
 
 Burger::GridIndexBox::GridIndexBox(const Vector4D_t *pBounds,WordPtr uItemCountEstimate,float fGridScale) :
 	m_BoundsRect(pBounds[0]),
+	m_pCellStarts(NULL),
+	m_pCellItems(NULL),
+	m_pPackedLeft(NULL),
+	m_pPackedTop(NULL),
+	m_pPackedRight(NULL),
+	m_pPackedBottom(NULL),
+	m_pPackedValues(NULL),
+	m_pPackedFirstCells(NULL),
+	m_uPackedCount(0),
 	m_uQueryCount(0)
 {
 	ChooseGridSize(&m_uXCells,&m_uYCells,pBounds,uItemCountEstimate,fGridScale);
@@ -725,6 +1319,7 @@ Burger::GridIndexBox::~GridIndexBox()
 		} while (--uCount);
 	}
 	delete [] m_pGrid;
+	ClearPacked();
 }
 
 /*! ************************************
@@ -745,6 +1340,24 @@ Burger::GridIndexBox::~GridIndexBox()
 
 ***************************************/
 
+/*! ************************************
+
+	\fn Word Burger::GridIndexBox::GetXCells(void) const
+	\brief Return the width of the grid in cells
+
+	\return Number of cells wide
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::GridIndexBox::GetYCells(void) const
+	\brief Return the height of the grid in cells
+
+	\return Number of cells high
+
+***************************************/
+
 
 
 
@@ -1116,4 +1729,320 @@ Burger::GridIndexBox::Entry * BURGER_API Burger::GridIndexBox::FindData(const Ve
 	}
 	// Didn't find it.
 	return NULL;
-}
\ No newline at end of file
+}
+/*! ************************************
+
+	\brief Bulk build the packed grid from an array of boxes
+
+	Instead of inserting each box into the grid one at a time with
+	add(const Vector4D_t *,Word), this function sorts all the boxes
+	by cell with a counting sort. The box coordinates and payloads
+	are stored in separate arrays in the order they were passed in,
+	and each cell has a contiguous run of indexes into these arrays
+	for every box that overlaps it.
+
+	The packed data is separate from the entries created with add(),
+	and any previously built packed data is discarded.
+
+	\param pBounds Pointer to an array of bounding rectangles
+	\param pValues Pointer to an array of payloads, one per rectangle
+	\param uCount Number of rectangles to sort into the grid
+	\param uThreadCount Maximum number of threads to use for sorting
+	\return kErrorNone if successful, kErrorOutOfMemory on an allocation failure
+
+	\sa ClearPacked(void) or QueryBoxes(GridIndexSpan_t *,SimpleArray<WordPtr> *,const Vector4D_t *,WordPtr) const
+
+***************************************/
+
+Burger::eError BURGER_API Burger::GridIndexBox::Build(const Vector4D_t *pBounds,const Word *pValues,WordPtr uCount,Word uThreadCount)
+{
+	ClearPacked();
+	// The first cell of each box is stored as a pair of 16 bit values
+	BURGER_ASSERT(m_uXCells <= 65536U && m_uYCells <= 65536U);
+	WordPtr uCellCount = static_cast<WordPtr>(m_uXCells) * m_uYCells;
+	m_pCellStarts = static_cast<WordPtr *>(AllocClear(sizeof(WordPtr)*(uCellCount+1)));
+	if (!m_pCellStarts) {
+		return kErrorOutOfMemory;
+	}
+	if (!uCount) {
+		return kErrorNone;
+	}
+
+	GridBuildJob_t Jobs[g_uMaxBuildThreads];
+	MemoryClear(Jobs,sizeof(Jobs));
+	Word uJobCount = GetGridBuildThreadCount(uCount,uThreadCount);
+	Word i = 0;
+	do {
+		Jobs[i].m_pParent = this;
+		Jobs[i].m_pInput = pBounds;
+		Jobs[i].m_pValues = pValues;
+	} while (++i<uJobCount);
+
+	eError uResult = CountGridIndex(Jobs,uJobCount,uCount,uCellCount,m_pCellStarts,4,GridBoxesCount);
+	if (!uResult) {
+		// A box can be in several cells, so the index array can be larger than uCount
+		m_pCellItems = static_cast<WordPtr *>(Alloc(sizeof(WordPtr)*m_pCellStarts[uCellCount]));
+		m_pPackedLeft = static_cast<float *>(Alloc(sizeof(float)*uCount));
+		m_pPackedTop = static_cast<float *>(Alloc(sizeof(float)*uCount));
+		m_pPackedRight = static_cast<float *>(Alloc(sizeof(float)*uCount));
+		m_pPackedBottom = static_cast<float *>(Alloc(sizeof(float)*uCount));
+		m_pPackedValues = static_cast<Word *>(Alloc(sizeof(Word)*uCount));
+		m_pPackedFirstCells = static_cast<Word *>(Alloc(sizeof(Word)*uCount));
+		if (!m_pCellItems || !m_pPackedLeft || !m_pPackedTop || !m_pPackedRight ||
+			!m_pPackedBottom || !m_pPackedValues || !m_pPackedFirstCells) {
+			FinishGridIndex(Jobs,uJobCount,NULL);
+			uResult = kErrorOutOfMemory;
+		} else {
+			i = 0;
+			do {
+				Jobs[i].m_pOutput[0] = m_pCellItems;
+				Jobs[i].m_pOutput[1] = m_pPackedLeft;
+				Jobs[i].m_pOutput[2] = m_pPackedTop;
+				Jobs[i].m_pOutput[3] = m_pPackedRight;
+				Jobs[i].m_pOutput[4] = m_pPackedBottom;
+				Jobs[i].m_pOutput[5] = m_pPackedValues;
+				Jobs[i].m_pOutput[6] = m_pPackedFirstCells;
+			} while (++i<uJobCount);
+			FinishGridIndex(Jobs,uJobCount,GridBoxesScatter);
+			m_uPackedCount = uCount;
+		}
+	}
+	if (uResult) {
+		ClearPacked();
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Release the packed grid
+
+	Dispose of all memory allocated by Build(const Vector4D_t *,const Word *,WordPtr,Word).
+	Entries added with add(const Vector4D_t *,Word) are not affected.
+
+	\sa Build(const Vector4D_t *,const Word *,WordPtr,Word)
+
+***************************************/
+
+void BURGER_API Burger::GridIndexBox::ClearPacked(void)
+{
+	Free(m_pCellStarts);
+	m_pCellStarts = NULL;
+	Free(m_pCellItems);
+	m_pCellItems = NULL;
+	Free(m_pPackedLeft);
+	m_pPackedLeft = NULL;
+	Free(m_pPackedTop);
+	m_pPackedTop = NULL;
+	Free(m_pPackedRight);
+	m_pPackedRight = NULL;
+	Free(m_pPackedBottom);
+	m_pPackedBottom = NULL;
+	Free(m_pPackedValues);
+	m_pPackedValues = NULL;
+	Free(m_pPackedFirstCells);
+	m_pPackedFirstCells = NULL;
+	m_uPackedCount = 0;
+}
+
+/*! ************************************
+
+	\fn WordPtr Burger::GridIndexBox::GetPackedCount(void) const
+	\brief Return the number of packed boxes
+
+	\return Number of boxes sorted with Build(const Vector4D_t *,const Word *,WordPtr,Word)
+
+***************************************/
+
+/*! ************************************
+
+	\fn const float *Burger::GridIndexBox::GetPackedLeft(void) const
+	\brief Return the left edges of the packed boxes
+
+	\return Pointer to the array of left edges in the order passed to Build()
+
+***************************************/
+
+/*! ************************************
+
+	\fn const float *Burger::GridIndexBox::GetPackedTop(void) const
+	\brief Return the top edges of the packed boxes
+
+	\return Pointer to the array of top edges in the order passed to Build()
+
+***************************************/
+
+/*! ************************************
+
+	\fn const float *Burger::GridIndexBox::GetPackedRight(void) const
+	\brief Return the right edges of the packed boxes
+
+	\return Pointer to the array of right edges in the order passed to Build()
+
+***************************************/
+
+/*! ************************************
+
+	\fn const float *Burger::GridIndexBox::GetPackedBottom(void) const
+	\brief Return the bottom edges of the packed boxes
+
+	\return Pointer to the array of bottom edges in the order passed to Build()
+
+***************************************/
+
+/*! ************************************
+
+	\fn const Word *Burger::GridIndexBox::GetPackedValues(void) const
+	\brief Return the payloads of the packed boxes
+
+	\return Pointer to the array of payloads in the order passed to Build()
+
+***************************************/
+
+/*! ************************************
+
+	\fn const WordPtr *Burger::GridIndexBox::GetCellItems(void) const
+	\brief Return the packed box indexes sorted by cell
+
+	Each cell has a contiguous run of indexes of the boxes that overlap it.
+	Use GetCellSpan(Word,Word) const to find the run for a cell.
+
+	\return Pointer to the array of indexes into the packed boxes
+
+***************************************/
+
+/*! ************************************
+
+	\fn GridIndexSpan_t Burger::GridIndexBox::GetCellSpan(Word uX,Word uY) const
+	\brief Return the range of packed box indexes in a cell
+
+	\note Build(const Vector4D_t *,const Word *,WordPtr,Word) must have been called.
+
+	\param uX X coordinate in the grid
+	\param uY Y coordinate in the grid
+	\return Span of the array returned by GetCellItems(void) const for this cell
+
+***************************************/
+
+/*! ************************************
+
+	\brief Find the packed boxes that contain a batch of points
+
+	For each point, the indexes of all packed boxes that contain
+	it (Edges inclusive) are appended to pIndexes. The span for
+	each point is the range in pIndexes that holds its results.
+
+	\note pIndexes is cleared before the query is performed
+
+	\param pOutput Pointer to an array of spans, one per point
+	\param pIndexes Pointer to the array to receive the indexes of packed boxes
+	\param pPoints Pointer to the array of points to test
+	\param uCount Number of points to test
+
+	\sa Build(const Vector4D_t *,const Word *,WordPtr,Word)
+
+***************************************/
+
+void BURGER_API Burger::GridIndexBox::QueryPoints(GridIndexSpan_t *pOutput,SimpleArray<WordPtr> *pIndexes,const Vector2D_t *pPoints,WordPtr uCount) const
+{
+	pIndexes->clear();
+	if (uCount) {
+		do {
+			WordPtr uFirst = pIndexes->size();
+			if (m_uPackedCount) {
+				float fX = pPoints->x;
+				float fY = pPoints->y;
+				Vector2D_t vCell;
+				GetContainingCellClamped(&vCell,pPoints);
+				WordPtr uCell = static_cast<WordPtr>(static_cast<Word>(static_cast<int>(vCell.y)) * m_uXCells) +
+					static_cast<Word>(static_cast<int>(vCell.x));
+				WordPtr i = m_pCellStarts[uCell];
+				WordPtr uEnd = m_pCellStarts[uCell+1];
+				while (i<uEnd) {
+					WordPtr uItem = m_pCellItems[i];
+					if ((fX>=m_pPackedLeft[uItem]) && (fX<=m_pPackedRight[uItem]) &&
+						(fY>=m_pPackedTop[uItem]) && (fY<=m_pPackedBottom[uItem])) {
+						pIndexes->push_back(uItem);
+					}
+					++i;
+				}
+			}
+			pOutput->m_uStart = uFirst;
+			pOutput->m_uCount = pIndexes->size()-uFirst;
+			++pPoints;
+			++pOutput;
+		} while (--uCount);
+	}
+}
+
+/*! ************************************
+
+	\brief Find the packed boxes that overlap a batch of rectangles
+
+	For each rectangle, the indexes of all packed boxes that overlap
+	it (Edges inclusive) are appended to pIndexes. The span for
+	each rectangle is the range in pIndexes that holds its results.
+
+	A box is only reported once per rectangle even if it occupies
+	several cells. Instead of marking each box with a query counter
+	like begin(const Vector4D_t *) does, a box is only tested in the top
+	left cell shared by both the box and the query rectangle, so
+	the packed data is never modified and queries can be performed
+	from several threads at once.
+
+	\note pIndexes is cleared before the query is performed
+
+	\param pOutput Pointer to an array of spans, one per rectangle
+	\param pIndexes Pointer to the array to receive the indexes of packed boxes
+	\param pBoxes Pointer to the array of rectangles to test
+	\param uCount Number of rectangles to test
+
+	\sa Build(const Vector4D_t *,const Word *,WordPtr,Word)
+
+***************************************/
+
+void BURGER_API Burger::GridIndexBox::QueryBoxes(GridIndexSpan_t *pOutput,SimpleArray<WordPtr> *pIndexes,const Vector4D_t *pBoxes,WordPtr uCount) const
+{
+	pIndexes->clear();
+	if (uCount) {
+		do {
+			WordPtr uFirst = pIndexes->size();
+			if (m_uPackedCount) {
+				float fLeft = pBoxes->x;
+				float fTop = pBoxes->y;
+				float fRight = pBoxes->z;
+				float fBottom = pBoxes->w;
+				Vector4D_t CellRect;
+				GetContainingCellsClamped(&CellRect,pBoxes);
+				Word uLeft = static_cast<Word>(static_cast<int>(CellRect.x));
+				Word uTop = static_cast<Word>(static_cast<int>(CellRect.y));
+				Word uRight = static_cast<Word>(static_cast<int>(CellRect.z));
+				Word uBottom = static_cast<Word>(static_cast<int>(CellRect.w));
+				for (Word iy = uTop; iy <= uBottom; iy++) {
+					const WordPtr *pRow = &m_pCellStarts[iy*m_uXCells];
+					for (Word ix = uLeft; ix <= uRight; ix++) {
+						WordPtr i = pRow[ix];
+						WordPtr uEnd = pRow[ix+1];
+						while (i<uEnd) {
+							WordPtr uItem = m_pCellItems[i];
+							Word uFirstCell = m_pPackedFirstCells[uItem];
+							Word uFirstX = uFirstCell&0xFFFFU;
+							Word uFirstY = uFirstCell>>16U;
+							// Only test in the first cell shared by the box and the query
+							if ((ix==Max(uFirstX,static_cast<Word>(uLeft))) && (iy==Max(uFirstY,static_cast<Word>(uTop))) &&
+								(m_pPackedLeft[uItem]<=fRight) && (m_pPackedRight[uItem]>=fLeft) &&
+								(m_pPackedTop[uItem]<=fBottom) && (m_pPackedBottom[uItem]>=fTop)) {
+								pIndexes->push_back(uItem);
+							}
+							++i;
+						}
+					}
+				}
+			}
+			pOutput->m_uStart = uFirst;
+			pOutput->m_uCount = pIndexes->size()-uFirst;
+			++pBoxes;
+			++pOutput;
+		} while (--uCount);
+	}
+}
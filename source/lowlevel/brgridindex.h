@@ -52,6 +52,11 @@
 namespace Burger {
 extern void BURGER_API ChooseGridSize(Word* pXCellCount,Word* pYCellCount,const Vector4D_t *pBoundingRect,WordPtr uItemCountEstimate,float fGridScale = 0.707f);
 
+struct GridIndexSpan_t {
+	WordPtr m_uStart;			///< Index of the first entry in the span
+	WordPtr m_uCount;			///< Number of entries in the span
+};
+
 class GridIndexPoints {
 public:
 	struct Entry_t {
@@ -62,6 +67,11 @@ public:
 private:
 	Vector4D_t m_BoundsRect;	///< Rectangle encompassing the area of the grid
 	Entry_t **m_ppGrid;			///< Array of pointers for grid objects
+	WordPtr *m_pCellStarts;		///< Index of the first packed entry for each cell (Built with Build())
+	float *m_pPackedX;			///< Packed X coordinates sorted by cell
+	float *m_pPackedY;			///< Packed Y coordinates sorted by cell
+	Word *m_pPackedValues;		///< Packed values sorted by cell
+	WordPtr m_uPackedCount;		///< Number of packed entries
 	Word m_uXCells;				///< Number of cells wide
 	Word m_uYCells;				///< Number of cells high
 	float m_fXCells;			///< Number of cells wide as a float
@@ -89,6 +99,8 @@ public:
 	GridIndexPoints(const Vector4D_t *pBounds,WordPtr uItemCountEstimate,float fGridScale = 0.707f);
 	~GridIndexPoints();
 	BURGER_INLINE const Vector4D_t *GetBoundsRect(void) const { return &m_BoundsRect; }
+	BURGER_INLINE Word GetXCells(void) const { return m_uXCells; }
+	BURGER_INLINE Word GetYCells(void) const { return m_uYCells; }
 
 	struct iterator {
 		const GridIndexPoints *m_pParent;	///< Pointer to parent class
@@ -118,6 +130,22 @@ public:
 	void BURGER_API add(const Vector2D_t *pPoint,Word uValue);
 	void BURGER_API remove(Entry_t *pEntry);
 	iterator find(const Vector2D_t *pPoint,Word uValue);
+
+	eError BURGER_API Build(const Vector2D_t *pPoints,const Word *pValues,WordPtr uCount,Word uThreadCount=1);
+	void BURGER_API ClearPacked(void);
+	BURGER_INLINE WordPtr GetPackedCount(void) const { return m_uPackedCount; }
+	BURGER_INLINE const float *GetPackedX(void) const { return m_pPackedX; }
+	BURGER_INLINE const float *GetPackedY(void) const { return m_pPackedY; }
+	BURGER_INLINE const Word *GetPackedValues(void) const { return m_pPackedValues; }
+	BURGER_INLINE GridIndexSpan_t GetCellSpan(Word uX,Word uY) const {
+		BURGER_ASSERT(m_pCellStarts);
+		WordPtr uIndex = static_cast<WordPtr>(uY * m_uXCells) + uX;
+		GridIndexSpan_t Result = { m_pCellStarts[uIndex],m_pCellStarts[uIndex+1]-m_pCellStarts[uIndex] };
+		return Result;
+	}
+	WordPtr BURGER_API GetRowSpans(GridIndexSpan_t *pOutput,const Vector4D_t *pBounds) const;
+	void BURGER_API QueryPoints(GridIndexSpan_t *pOutput,const Vector2D_t *pPoints,WordPtr uCount) const;
+	void BURGER_API QueryBoxes(GridIndexSpan_t *pOutput,SimpleArray<WordPtr> *pIndexes,const Vector4D_t *pBoxes,WordPtr uCount) const;
 };
 
 class GridIndexBox {
@@ -131,6 +159,15 @@ public:
 private:
 	Vector4D_t m_BoundsRect;			///< Bounds rectangle for the grid
 	SimpleArray<Entry* > *m_pGrid;		///< Array of pointers to arrays in the grid
+	WordPtr *m_pCellStarts;				///< Index of the first packed slot for each cell (Built with Build())
+	WordPtr *m_pCellItems;				///< Packed item indexes sorted by cell
+	float *m_pPackedLeft;				///< Left edge of each packed box
+	float *m_pPackedTop;				///< Top edge of each packed box
+	float *m_pPackedRight;				///< Right edge of each packed box
+	float *m_pPackedBottom;				///< Bottom edge of each packed box
+	Word *m_pPackedValues;				///< Payload of each packed box
+	Word *m_pPackedFirstCells;			///< Top left cell of each packed box (Y in the upper 16 bits)
+	WordPtr m_uPackedCount;				///< Number of packed boxes
 	Word m_uXCells;						///< Number of cells wide
 	Word m_uYCells;						///< Number of cells high
 	float m_fXCells;					///< Number of cells wide as a float
@@ -151,6 +188,8 @@ public:
 	~GridIndexBox();
 	BURGER_INLINE const Vector4D_t *GetBounds(void) const { return &m_BoundsRect; }
 	BURGER_INLINE Word GetQueryCount(void) const { return m_uQueryCount; }
+	BURGER_INLINE Word GetXCells(void) const { return m_uXCells; }
+	BURGER_INLINE Word GetYCells(void) const { return m_uYCells; }
 	struct iterator {
 		const GridIndexBox *m_pParent;		///< Pointer to parent class
 		Entry *m_pEntry;					///< Current object
@@ -183,6 +222,24 @@ public:
 	void BURGER_API remove(Entry *pEntry);
 	iterator find(const Vector4D_t *pBounds,Word uValue);
 	Entry * BURGER_API FindData(const Vector2D_t *pPoint,Word uValue) const;
+
+	eError BURGER_API Build(const Vector4D_t *pBounds,const Word *pValues,WordPtr uCount,Word uThreadCount=1);
+	void BURGER_API ClearPacked(void);
+	BURGER_INLINE WordPtr GetPackedCount(void) const { return m_uPackedCount; }
+	BURGER_INLINE const float *GetPackedLeft(void) const { return m_pPackedLeft; }
+	BURGER_INLINE const float *GetPackedTop(void) const { return m_pPackedTop; }
+	BURGER_INLINE const float *GetPackedRight(void) const { return m_pPackedRight; }
+	BURGER_INLINE const float *GetPackedBottom(void) const { return m_pPackedBottom; }
+	BURGER_INLINE const Word *GetPackedValues(void) const { return m_pPackedValues; }
+	BURGER_INLINE const WordPtr *GetCellItems(void) const { return m_pCellItems; }
+	BURGER_INLINE GridIndexSpan_t GetCellSpan(Word uX,Word uY) const {
+		BURGER_ASSERT(m_pCellStarts);
+		WordPtr uIndex = static_cast<WordPtr>(uY * m_uXCells) + uX;
+		GridIndexSpan_t Result = { m_pCellStarts[uIndex],m_pCellStarts[uIndex+1]-m_pCellStarts[uIndex] };
+		return Result;
+	}
+	void BURGER_API QueryPoints(GridIndexSpan_t *pOutput,SimpleArray<WordPtr> *pIndexes,const Vector2D_t *pPoints,WordPtr uCount) const;
+	void BURGER_API QueryBoxes(GridIndexSpan_t *pOutput,SimpleArray<WordPtr> *pIndexes,const Vector4D_t *pBoxes,WordPtr uCount) const;
 };
 }
 /* END */
@@ -12,6 +12,110 @@
 ***************************************/
 
 #include "brsmartpointer.h"
+#include "brtick.h"
+
+/*! ************************************
+
+	\class Burger::ReferenceCountNonAtomic
+	\brief Reference count that is not thread safe
+
+	Policy class used by ReferenceCounter to store the reference
+	count. Incrementing and decrementing are simple integer operations,
+	so objects using this policy must only be shared by a single thread.
+
+	\sa ReferenceCountAtomic or ReferenceCounter
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::ReferenceCountNonAtomic::ReferenceCountNonAtomic()
+	\brief Sets the reference count to zero
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::ReferenceCountNonAtomic::Increment(void)
+	\brief Increase the reference count by 1
+
+	\return The new reference count
+	\sa Decrement(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::ReferenceCountNonAtomic::Decrement(void)
+	\brief Decrease the reference count by 1
+
+	\return The new reference count, zero if the last reference was released
+	\sa Increment(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::ReferenceCountNonAtomic::GetCount(void) const
+	\brief Return the reference count
+
+	\return The current reference count
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::ReferenceCountAtomic
+	\brief Reference count that is thread safe
+
+	Policy class used by AtomicReferenceCounter to store the reference
+	count. Incrementing and decrementing are performed with
+	AtomicPreIncrement(volatile Word32 *) and AtomicPreDecrement(volatile Word32 *)
+	so SmartPointer objects to the same object can be created and
+	destroyed by multiple threads.
+
+	\sa ReferenceCountNonAtomic or AtomicReferenceCounter
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::ReferenceCountAtomic::ReferenceCountAtomic()
+	\brief Sets the reference count to zero
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::ReferenceCountAtomic::Increment(void)
+	\brief Atomically increase the reference count by 1
+
+	\return The new reference count
+	\sa Decrement(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::ReferenceCountAtomic::Decrement(void)
+	\brief Atomically decrease the reference count by 1
+
+	\return The new reference count, zero if the last reference was released
+	\sa Increment(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::ReferenceCountAtomic::GetCount(void) const
+	\brief Return the reference count
+
+	\return The current reference count
+
+***************************************/
+
+
+
 
 /*! ************************************
 
@@ -28,6 +132,11 @@
 	been notified of the parent's deletion, the proxy
 	will be disposed of.
 
+	Since every object that has a WeakPointer to it needs one of these,
+	they are allocated in chunks of \ref cProxiesPerChunk from a pool
+	instead of one at a time. The reference count is atomic since the proxy
+	can outlive its parent and be released by any thread.
+
 	This class is not meant to be used as a stand alone
 	class, it's meant to be created by ReferenceCounter objects
 	when a WeakPointer object is requesting a connection.
@@ -38,20 +147,182 @@
 
 /*! ************************************
 
-	\brief Allocate a ProxyReferenceCounter using the global memory manager
+	\struct Burger::ProxyReferenceCounter::Chunk_t
+	\brief Block of ProxyReferenceCounter objects
+
+	Header of a single allocation that is followed by
+	\ref cProxiesPerChunk ProxyReferenceCounter objects.
+
+***************************************/
+
+#if !defined(DOXYGEN)
+struct Burger::ProxyReferenceCounter::Chunk_t {
+	Chunk_t *m_pNext;			// Next chunk with free proxies
+	Chunk_t *m_pPrevious;		// Previous chunk with free proxies
+	void *m_pFreeList;			// First free proxy in this chunk
+	Word m_uUsed;				// Number of proxies in use
+};
+
+// List of chunks that have free proxies
+static Burger::ProxyReferenceCounter::Chunk_t *g_pProxyChunks;
+
+// Number of chunks allocated, full or not
+static Word g_uProxyChunkCount;
+
+// Lock for the proxy pool
+static volatile Word32 g_uProxyPoolLock;
+
+static BURGER_INLINE void LockProxyPool(void)
+{
+	// The lock is only held for a few instructions, so spin a little
+	// before giving the time slice to the thread holding it
+	Word uSpin = 0;
+	while (Burger::AtomicSwap(&g_uProxyPoolLock,1)) {
+		if (++uSpin>=64) {
+			Burger::Sleep(Burger::SLEEP_YIELD);
+			uSpin = 0;
+		}
+	}
+}
+
+static BURGER_INLINE void UnlockProxyPool(void)
+{
+	Burger::AtomicSwap(&g_uProxyPoolLock,0);
+}
+#endif
+
+/*! ************************************
+
+	\brief Allocate a ProxyReferenceCounter from the pool
 
-	Using the GlobalMemoryManager, allocate an instance of this class
-	and return the pointer.
+	Take a ProxyReferenceCounter from a pool chunk that has free
+	entries. If there are no free entries, allocate a new chunk
+	using the global memory manager.
 
 	\return A pointer to a new instance of the ProxyReferenceCounter class
 		or \ref NULL on failure
 
+	\sa Dispose(ProxyReferenceCounter *)
+
 ***************************************/
 
 Burger::ProxyReferenceCounter * BURGER_API Burger::ProxyReferenceCounter::New(void)
 {
+	LockProxyPool();
+	Chunk_t *pChunk = g_pProxyChunks;
+	if (!pChunk) {
+		pChunk = static_cast<Chunk_t *>(Alloc(sizeof(Chunk_t)+(sizeof(ProxyReferenceCounter)*cProxiesPerChunk)));
+		if (!pChunk) {
+			UnlockProxyPool();
+			return NULL;
+		}
+		pChunk->m_pNext = NULL;
+		pChunk->m_pPrevious = NULL;
+		pChunk->m_uUsed = 0;
+
+		// Link all the proxies into the free list
+		ProxyReferenceCounter *pEntry = reinterpret_cast<ProxyReferenceCounter *>(pChunk+1);
+		void *pNext = NULL;
+		Word i = cProxiesPerChunk;
+		do {
+			--i;
+			reinterpret_cast<void **>(&pEntry[i])[0] = pNext;
+			pNext = &pEntry[i];
+		} while (i);
+		pChunk->m_pFreeList = pNext;
+		g_pProxyChunks = pChunk;
+		++g_uProxyChunkCount;
+	}
+
+	// Take the first free entry
+	void *pEntry = pChunk->m_pFreeList;
+	pChunk->m_pFreeList = static_cast<void **>(pEntry)[0];
+	++pChunk->m_uUsed;
+
+	// If the chunk is full, remove it from the list
+	if (!pChunk->m_pFreeList) {
+		g_pProxyChunks = pChunk->m_pNext;
+		if (pChunk->m_pNext) {
+			pChunk->m_pNext->m_pPrevious = NULL;
+		}
+		pChunk->m_pNext = NULL;
+	}
+	UnlockProxyPool();
+
 	// In place new
-	return new(Alloc(sizeof(ProxyReferenceCounter))) ProxyReferenceCounter;
+	ProxyReferenceCounter *pResult = new(pEntry) ProxyReferenceCounter;
+	pResult->m_pChunk = pChunk;
+	return pResult;
+}
+
+/*! ************************************
+
+	\brief Return a ProxyReferenceCounter to the pool
+
+	Called by Release() when the last reference is released. If the
+	pool chunk the proxy came from is now empty, the chunk is released
+	to the global memory manager.
+
+	\param pProxy Pointer to the ProxyReferenceCounter to dispose of
+
+	\sa New(void)
+
+***************************************/
+
+void BURGER_API Burger::ProxyReferenceCounter::Dispose(ProxyReferenceCounter *pProxy)
+{
+	Chunk_t *pChunk = pProxy->m_pChunk;
+	LockProxyPool();
+	void *pFree = pChunk->m_pFreeList;
+	reinterpret_cast<void **>(pProxy)[0] = pFree;
+	pChunk->m_pFreeList = pProxy;
+
+	// The chunk was full, add it back to the list
+	if (!pFree) {
+		pChunk->m_pPrevious = NULL;
+		pChunk->m_pNext = g_pProxyChunks;
+		if (g_pProxyChunks) {
+			g_pProxyChunks->m_pPrevious = pChunk;
+		}
+		g_pProxyChunks = pChunk;
+	}
+
+	// Release empty chunks, so an empty pool holds no memory
+	if (!--pChunk->m_uUsed) {
+		if (pChunk->m_pPrevious) {
+			pChunk->m_pPrevious->m_pNext = pChunk->m_pNext;
+		} else {
+			g_pProxyChunks = pChunk->m_pNext;
+		}
+		if (pChunk->m_pNext) {
+			pChunk->m_pNext->m_pPrevious = pChunk->m_pPrevious;
+		}
+		--g_uProxyChunkCount;
+	} else {
+		pChunk = NULL;
+	}
+	UnlockProxyPool();
+	Free(pChunk);
+}
+
+/*! ************************************
+
+	\brief Return the number of chunks in the proxy pool
+
+	Every chunk holds \ref cProxiesPerChunk ProxyReferenceCounter objects.
+	Chunks are released once all of their proxies are disposed of, so this
+	returns zero when no proxies are in use.
+
+	\return Number of chunks allocated by the pool
+
+***************************************/
+
+Word BURGER_API Burger::ProxyReferenceCounter::GetChunkCount(void)
+{
+	LockProxyPool();
+	Word uResult = g_uProxyChunkCount;
+	UnlockProxyPool();
+	return uResult;
 }
 
 /*! ************************************
@@ -63,6 +334,8 @@ Burger::ProxyReferenceCounter * BURGER_API Burger::ProxyReferenceCounter::New(vo
 	called by applications. Use Burger::ProxyReferenceCounter::New()
 	instead.
 
+	\note New() sets the chunk pointer after construction.
+
 	\sa New()
 
 ***************************************/
@@ -123,12 +396,24 @@ Burger::ProxyReferenceCounter * BURGER_API Burger::ProxyReferenceCounter::New(vo
 
 
 #if !defined(DOXYGEN)
-BURGER_CREATE_STATICRTTI_PARENT(Burger::ReferenceCounter,Burger::Base);
+// The reference counters are templates, so the RTTI records are
+// explicit specializations with the name of the typedef
+#define BURGER_CREATE_STATICRTTI_POLICY(__ClassName,__ParentClass) \
+	template<> const Burger::StaticRTTI* __ClassName::GetStaticRTTI(void) const BURGER_NOEXCEPT { \
+		return &g_StaticRTTI; \
+	} \
+	template<> const Burger::StaticRTTI __ClassName::g_StaticRTTI = { \
+		#__ClassName,&__ParentClass::g_StaticRTTI,nullptr,0,0}; \
+	static const Burger::StaticRTTIRegister BURGER_JOIN( \
+		StaticRTTIRegister,__LINE__)(&__ClassName::g_StaticRTTI)
+
+BURGER_CREATE_STATICRTTI_POLICY(Burger::ReferenceCounter,Burger::Base);
+BURGER_CREATE_STATICRTTI_POLICY(Burger::AtomicReferenceCounter,Burger::Base);
 #endif
 
 /*! ************************************
 
-	\class Burger::ReferenceCounter
+	\class Burger::ReferenceCounterT
 	\brief Class to track an object using SmartPointer
 
 	When using a SmartPointer, it needs to be able to keep track of
@@ -137,32 +422,37 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::ReferenceCounter,Burger::Base);
 	of this object, the reference count will reach zero
 	and this object will immediately self-destruct.
 
-	\sa WeakPointer, ProxyReferenceCounter and SmartPointer
+	The template parameter is the policy class that stores the count.
+	Derive from the typedef ReferenceCounter, which uses
+	ReferenceCountNonAtomic, for objects only used by a single thread,
+	or from AtomicReferenceCounter, which uses ReferenceCountAtomic,
+	if SmartPointer objects to the same object are created and
+	destroyed by different threads.
+
+	\tparam TPolicy ReferenceCountNonAtomic or ReferenceCountAtomic
+	\sa WeakPointer, ProxyReferenceCounter, WeakAndStrongBaseT and SmartPointer
 
 ***************************************/
 
 /*! ************************************
 
-	\fn Burger::ReferenceCounter::ReferenceCounter()
+	\fn Burger::ReferenceCounterT::ReferenceCounterT()
 	\brief Sets the reference count to zero
 	
 ***************************************/
 
 /*! ************************************
 
+	\fn Burger::ReferenceCounterT::~ReferenceCounterT()
 	\brief Destructor.
 	
 	Does absolutely nothing
 	
 ***************************************/
 
-Burger::ReferenceCounter::~ReferenceCounter()
-{
-}
-
 /*! ************************************
 
-	\fn void Burger::ReferenceCounter::AddRef(void)
+	\fn void Burger::ReferenceCounterT::AddRef(void)
 	\brief Increase the reference count by 1
 
 	Take an ownership of this object by calling this function.
@@ -175,7 +465,7 @@ Burger::ReferenceCounter::~ReferenceCounter()
 
 /*! ************************************
 
-	\fn void Burger::ReferenceCounter::Release(void)
+	\fn void Burger::ReferenceCounterT::Release(void)
 	\brief Decrease the reference count by 1
 
 	Give up ownership of this object by calling this function.
@@ -188,16 +478,41 @@ Burger::ReferenceCounter::~ReferenceCounter()
 
 /*! ************************************
 
-	\var const Burger::StaticRTTI Burger::ReferenceCounter::g_StaticRTTI
+	\var const Burger::StaticRTTI Burger::ReferenceCounterT::g_StaticRTTI
 	\brief The global description of the class
 
-	This record contains the name of this class and a
-	reference to the parent
+	This record contains the name of the typedef, either
+	Burger::ReferenceCounter or Burger::AtomicReferenceCounter
+	and a reference to the parent
 
 ***************************************/
 
+/*! ************************************
 
+	\fn Word32 Burger::ReferenceCounterT::GetRefCount(void) const
+	\brief Return the reference count
 
+	\return The number of SmartPointer objects that own this object
+
+***************************************/
+
+/*! ************************************
+
+	\typedef Burger::ReferenceCounter
+	\brief Reference counter for objects used by a single thread
+
+	\sa ReferenceCounterT or AtomicReferenceCounter
+
+***************************************/
+
+/*! ************************************
+
+	\typedef Burger::AtomicReferenceCounter
+	\brief Reference counter for objects shared between threads
+
+	\sa ReferenceCounterT or ReferenceCounter
+
+***************************************/
 
 /*! ************************************
 
@@ -263,7 +578,10 @@ Burger::WeakPointerAnchor::~WeakPointerAnchor()
 
 	There will be only one shared ProxyReferenceCounter
 	object created for each instantiation of this sub
-	class.
+	class. If several threads request the proxy at the
+	same time, the first one to install it with an atomic
+	compare and swap wins and the others release the
+	proxy they created and use the installed one.
 
 	\return Pointer to a valid ProxyReferenceCounter object or \ref NULL on failure
 	\sa BURGER_ALLOW_WEAK_POINTERS()
@@ -275,8 +593,22 @@ Burger::ProxyReferenceCounter* Burger::WeakPointerAnchor::GetProxyReferenceCount
 	ProxyReferenceCounter *pResult = m_pReferenceCounter;
 	if (pResult == NULL) {
 		pResult = ProxyReferenceCounter::New();
-		m_pReferenceCounter = pResult;
-		pResult->AddRef();
+		if (pResult) {
+			// This reference is owned by the anchor
+			pResult->AddRef();
+#if defined(BURGER_64BITCPU)
+			Word bInstalled = AtomicSetIfMatch(reinterpret_cast<volatile Word64 *>(&m_pReferenceCounter),
+				0,static_cast<Word64>(reinterpret_cast<WordPtr>(pResult)));
+#else
+			Word bInstalled = AtomicSetIfMatch(reinterpret_cast<volatile Word32 *>(&m_pReferenceCounter),
+				0,static_cast<Word32>(reinterpret_cast<WordPtr>(pResult)));
+#endif
+			if (!bInstalled) {
+				// Another thread installed a proxy first, use that one
+				pResult->Release();
+				pResult = m_pReferenceCounter;
+			}
+		}
 	}
 	return pResult;
 }
@@ -321,21 +653,23 @@ Burger::ProxyReferenceCounter* Burger::WeakPointerAnchor::GetProxyReferenceCount
 
 /*! ************************************
 
-	\class Burger::WeakAndStrongBase
+	\class Burger::WeakAndStrongBaseT
 	\brief Base class to support WeakPointer and SmartPointer
 
 	Sometimes it's desired to support both weak and smart pointers
 	at the same time. This base class will offer this support.
-	Derive from this class to obtain the functions to easily
-	allow SmartPointer and WeakPointer support.
+	Derive from the typedefs WeakAndStrongBase or AtomicWeakAndStrongBase
+	to obtain the functions to easily allow SmartPointer and WeakPointer
+	support with a single threaded or thread safe reference count.
 
-	\sa WeakPointer, SmartPointer and ReferenceCounter
+	\tparam TPolicy ReferenceCountNonAtomic or ReferenceCountAtomic
+	\sa WeakPointer, SmartPointer and ReferenceCounterT
 
 ***************************************/
 
 /*! ************************************
 
-	\fn Burger::ProxyReferenceCounter * Burger::WeakAndStrongBase::GetProxyReferenceCounter(void) const
+	\fn Burger::ProxyReferenceCounter * Burger::WeakAndStrongBaseT::GetProxyReferenceCounter(void) const
 	\brief Function used by WeakPointer
 
 	This function is inserted by \ref BURGER_ALLOW_WEAK_POINTERS()
@@ -347,7 +681,7 @@ Burger::ProxyReferenceCounter* Burger::WeakPointerAnchor::GetProxyReferenceCount
 
 /*! ************************************
 
-	\var WeakPointerAnchor Burger::WeakAndStrongBase::m_WeakPointerAnchor
+	\var WeakPointerAnchor Burger::WeakAndStrongBaseT::m_WeakPointerAnchor
 	\brief Data to track WeakPointer data
 
 	This data is used by the WeakPointer system to notify
@@ -358,19 +692,38 @@ Burger::ProxyReferenceCounter* Burger::WeakPointerAnchor::GetProxyReferenceCount
 ***************************************/
 
 #if !defined(DOXYGEN)
-BURGER_CREATE_STATICRTTI_PARENT(Burger::WeakAndStrongBase,Burger::ReferenceCounter);
+BURGER_CREATE_STATICRTTI_POLICY(Burger::WeakAndStrongBase,Burger::ReferenceCounter);
+BURGER_CREATE_STATICRTTI_POLICY(Burger::AtomicWeakAndStrongBase,Burger::AtomicReferenceCounter);
 #endif
 
 /*! ************************************
 
-	\var const Burger::StaticRTTI Burger::WeakAndStrongBase::g_StaticRTTI
+	\var const Burger::StaticRTTI Burger::WeakAndStrongBaseT::g_StaticRTTI
 	\brief The global description of the class
 
-	This record contains the name of this class and a
-	reference to the parent
+	This record contains the name of the typedef, either
+	Burger::WeakAndStrongBase or Burger::AtomicWeakAndStrongBase
+	and a reference to the parent
+
+***************************************/
+
+/*! ************************************
+
+	\typedef Burger::WeakAndStrongBase
+	\brief WeakPointer and SmartPointer support for a single thread
+
+	\sa WeakAndStrongBaseT or AtomicWeakAndStrongBase
 
 ***************************************/
 
+/*! ************************************
+
+	\typedef Burger::AtomicWeakAndStrongBase
+	\brief WeakPointer and thread safe SmartPointer support
+
+	\sa WeakAndStrongBaseT or WeakAndStrongBase
+
+***************************************/
 
 /*! ************************************
 
@@ -455,6 +808,33 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::WeakAndStrongBase,Burger::ReferenceCount
 
 ***************************************/
 
+/*! ************************************
+
+	\fn Burger::SmartPointer::SmartPointer(SmartPointer &&rData)
+	\brief Move a smart pointer
+
+	Take ownership of the reference held by rData without
+	calling AddRef() or Release(). rData is set to \ref NULL.
+
+	\param rData Reference to an instance of another SmartPointer
+	\sa SmartPointer(const SmartPointer &)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::SmartPointer::operator=(SmartPointer &&rData)
+	\brief Move a smart pointer
+
+	Release() the current pointer (If not \ref NULL) and take
+	ownership of the reference held by rData without calling
+	AddRef(). rData is set to \ref NULL.
+
+	\param rData Reference to an instance of another SmartPointer
+	\sa operator=(const SmartPointer &)
+
+***************************************/
+
 /*! ************************************
 
 	\fn Burger::SmartPointer::~SmartPointer()
@@ -718,6 +1098,46 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::WeakAndStrongBase,Burger::ReferenceCount
 ***************************************/
 
 
+/*! ************************************
+
+	\fn Burger::WeakPointer::WeakPointer(WeakPointer &&rData)
+	\brief Move a weak pointer
+
+	Take over the tracking of the object from rData without
+	changing the reference count of the ProxyReferenceCounter.
+	rData is set to \ref NULL.
+
+	\param rData Reference to an instance of another WeakPointer
+	\sa WeakPointer::WeakPointer(const WeakPointer &)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::WeakPointer::operator=(WeakPointer &&rData)
+	\brief Move a weak pointer
+
+	Take over the tracking of the object from rData without
+	changing the reference count of the ProxyReferenceCounter.
+	rData is set to \ref NULL.
+
+	\param rData Reference to an instance of another WeakPointer
+	\sa WeakPointer::operator=(const WeakPointer &)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::WeakPointer::operator=(const WeakPointer &rData)
+	\brief Copy a weak pointer
+
+	Track the same object as rData.
+
+	\param rData Reference to an instance of another WeakPointer
+	\sa WeakPointer::operator=(T*)
+
+***************************************/
+
 /*! ************************************
 
 	\fn Burger::WeakPointer::~WeakPointer()
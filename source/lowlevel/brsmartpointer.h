@@ -34,36 +34,71 @@
 #include "brglobalmemorymanager.h"
 #endif
 
+#ifndef __BRATOMIC_H__
+#include "bratomic.h"
+#endif
+
 /* BEGIN */
 namespace Burger {
+class ReferenceCountNonAtomic {
+	BURGER_DISABLE_COPY(ReferenceCountNonAtomic);
+	Word32 m_uRefCount;				///< Reference count
+public:
+	ReferenceCountNonAtomic() BURGER_NOEXCEPT : m_uRefCount(0) {}
+	BURGER_INLINE Word32 Increment(void) BURGER_NOEXCEPT { return ++m_uRefCount; }
+	BURGER_INLINE Word32 Decrement(void) BURGER_NOEXCEPT { return --m_uRefCount; }
+	BURGER_INLINE Word32 GetCount(void) const BURGER_NOEXCEPT { return m_uRefCount; }
+};
+
+class ReferenceCountAtomic {
+	BURGER_DISABLE_COPY(ReferenceCountAtomic);
+	volatile Word32 m_uRefCount;	///< Reference count, only modified with atomic operations
+public:
+	ReferenceCountAtomic() BURGER_NOEXCEPT : m_uRefCount(0) {}
+	BURGER_INLINE Word32 Increment(void) BURGER_NOEXCEPT { return AtomicPreIncrement(&m_uRefCount); }
+	BURGER_INLINE Word32 Decrement(void) BURGER_NOEXCEPT { return AtomicPreDecrement(&m_uRefCount); }
+	BURGER_INLINE Word32 GetCount(void) const BURGER_NOEXCEPT { return m_uRefCount; }
+};
+
 class ProxyReferenceCounter {
     BURGER_DISABLE_COPY(ProxyReferenceCounter);
+public:
+	struct Chunk_t;
+	static const Word cProxiesPerChunk = 64;	///< Number of proxies allocated at a time
 private:
-	Word m_uRefCount;				///< Number of weak pointers that are using this object as an anchor
-	Word m_bParentAlive;			///< \ref TRUE if the parent object was deleted
-	ProxyReferenceCounter() : m_uRefCount(0),m_bParentAlive(TRUE) {}
+	ReferenceCountAtomic m_RefCount;	///< Number of weak pointers that are using this object as an anchor
+	Chunk_t *m_pChunk;					///< Pool chunk this proxy was allocated from
+	volatile Word32 m_bParentAlive;		///< \ref TRUE if the parent object was not deleted
+	ProxyReferenceCounter() : m_RefCount(),m_pChunk(NULL),m_bParentAlive(TRUE) {}
+	static void BURGER_API Dispose(ProxyReferenceCounter *pProxy);
 public:
 	static ProxyReferenceCounter * BURGER_API New(void);
+	static Word BURGER_API GetChunkCount(void);
 	BURGER_INLINE Word IsParentAlive(void) const { return m_bParentAlive; }
 	BURGER_INLINE void ParentIsDead(void) { m_bParentAlive = FALSE; }
-	BURGER_INLINE void AddRef(void) { ++m_uRefCount; }
-	BURGER_INLINE void Release(void) { if (--m_uRefCount == 0) { Free(this); } }
+	BURGER_INLINE void AddRef(void) { m_RefCount.Increment(); }
+	BURGER_INLINE void Release(void) { if (!m_RefCount.Decrement()) { Dispose(this); } }
 };
 
-class ReferenceCounter : public Base {
-    BURGER_DISABLE_COPY(ReferenceCounter);
+template<class TPolicy>
+class ReferenceCounterT : public Base {
+    BURGER_DISABLE_COPY(ReferenceCounterT);
 	BURGER_RTTI_IN_CLASS();
 private:
-	Word m_uRefCount;					///< Number of smart pointers that are claiming ownership of this object
+	TPolicy m_RefCount;		///< Number of smart pointers that are claiming ownership of this object
 public:
-	ReferenceCounter() BURGER_NOEXCEPT : m_uRefCount(0) { }
-	virtual ~ReferenceCounter();
-	BURGER_INLINE void AddRef(void) BURGER_NOEXCEPT { ++m_uRefCount; }
-	BURGER_INLINE void Release(void) BURGER_NOEXCEPT { if (--m_uRefCount == 0) { Delete(this); } }
+	ReferenceCounterT() BURGER_NOEXCEPT : m_RefCount() { }
+	virtual ~ReferenceCounterT() {}
+	BURGER_INLINE void AddRef(void) BURGER_NOEXCEPT { m_RefCount.Increment(); }
+	BURGER_INLINE void Release(void) BURGER_NOEXCEPT { if (!m_RefCount.Decrement()) { Delete(this); } }
+	BURGER_INLINE Word32 GetRefCount(void) const BURGER_NOEXCEPT { return m_RefCount.GetCount(); }
 };
 
+typedef ReferenceCounterT<ReferenceCountNonAtomic> ReferenceCounter;
+typedef ReferenceCounterT<ReferenceCountAtomic> AtomicReferenceCounter;
+
 class WeakPointerAnchor {
-	mutable ProxyReferenceCounter* m_pReferenceCounter;
+	mutable ProxyReferenceCounter* volatile m_pReferenceCounter;	///< Shared proxy, only set with an atomic operation
 public:
 	WeakPointerAnchor() BURGER_NOEXCEPT : m_pReferenceCounter(nullptr) {}
 	~WeakPointerAnchor();
@@ -74,11 +109,25 @@ public:
 public: BURGER_INLINE ProxyReferenceCounter* GetProxyReferenceCounter(void) const { return m_WeakPointerAnchor.GetProxyReferenceCounter(); } \
 private: WeakPointerAnchor m_WeakPointerAnchor
 
-class WeakAndStrongBase : public ReferenceCounter {
+template<class TPolicy>
+class WeakAndStrongBaseT : public ReferenceCounterT<TPolicy> {
 	BURGER_ALLOW_WEAK_POINTERS();
 	BURGER_RTTI_IN_CLASS();
 };
 
+typedef WeakAndStrongBaseT<ReferenceCountNonAtomic> WeakAndStrongBase;
+typedef WeakAndStrongBaseT<ReferenceCountAtomic> AtomicWeakAndStrongBase;
+
+// The RTTI records are created in brsmartpointer.cpp
+template<> const StaticRTTI* ReferenceCounter::GetStaticRTTI(void) const BURGER_NOEXCEPT;
+template<> const StaticRTTI ReferenceCounter::g_StaticRTTI;
+template<> const StaticRTTI* AtomicReferenceCounter::GetStaticRTTI(void) const BURGER_NOEXCEPT;
+template<> const StaticRTTI AtomicReferenceCounter::g_StaticRTTI;
+template<> const StaticRTTI* WeakAndStrongBase::GetStaticRTTI(void) const BURGER_NOEXCEPT;
+template<> const StaticRTTI WeakAndStrongBase::g_StaticRTTI;
+template<> const StaticRTTI* AtomicWeakAndStrongBase::GetStaticRTTI(void) const BURGER_NOEXCEPT;
+template<> const StaticRTTI AtomicWeakAndStrongBase::g_StaticRTTI;
+
 template<class T>
 class SmartPointer {
 	T* m_pData;			///< Private copy of the pointer this class is tracking
@@ -113,6 +162,24 @@ public:
 			m_pData->AddRef();
 		}
 	}
+#if defined(BURGER_RVALUE_REFERENCES) || defined(DOXYGEN)
+	SmartPointer(SmartPointer<T>&& rData) BURGER_NOEXCEPT : m_pData(rData.m_pData)
+	{
+		// Take ownership of the reference
+		rData.m_pData = NULL;
+	}
+	BURGER_INLINE void operator=(SmartPointer<T>&& rData) BURGER_NOEXCEPT
+	{
+		if (this != &rData) {
+			T* pOld = m_pData;
+			m_pData = rData.m_pData;
+			rData.m_pData = NULL;
+			if (pOld) {
+				pOld->Release();
+			}
+		}
+	}
+#endif
 	~SmartPointer() {
 		// Release if one is owned
 		if (m_pData) {
@@ -141,8 +208,10 @@ class WeakPointer {
 	{
 		T* pData = m_pData;
 		if (pData) {
-			// If the parent was deleted, remove the shared proxy reference
-			if (!m_pProxy->IsParentAlive()) {
+			// If the parent was deleted or a proxy couldn't be
+			// allocated, remove the shared proxy reference
+			const ProxyReferenceCounter* pProxy = m_pProxy.GetPtr();
+			if (!pProxy || !pProxy->IsParentAlive()) {
 				pData = NULL;
 				m_pProxy = NULL;
 				m_pData = NULL;
@@ -167,6 +236,20 @@ public:
 			m_pProxy = m_pData->GetProxyReferenceCounter();
 		}
 	}
+#if defined(BURGER_RVALUE_REFERENCES) || defined(DOXYGEN)
+	WeakPointer(WeakPointer<T>&& rData) BURGER_NOEXCEPT : m_pData(rData.m_pData),
+		m_pProxy(static_cast<SmartPointer<ProxyReferenceCounter>&&>(rData.m_pProxy)) {
+		rData.m_pData = NULL;
+	}
+	BURGER_INLINE void operator=(WeakPointer<T>&& rData) BURGER_NOEXCEPT
+	{
+		if (this != &rData) {
+			m_pData = rData.m_pData;
+			m_pProxy = static_cast<SmartPointer<ProxyReferenceCounter>&&>(rData.m_pProxy);
+			rData.m_pData = NULL;
+		}
+	}
+#endif
 	~WeakPointer() {}
 	BURGER_INLINE void operator=(T* pData)
 	{
@@ -179,6 +262,11 @@ public:
 		}
 		m_pProxy = pProxy;
 	}
+	BURGER_INLINE void operator=(const WeakPointer<T>& rData)
+	{
+		m_pData = rData.m_pData;
+		m_pProxy = rData.m_pProxy;
+	}
 	BURGER_INLINE void operator=(const SmartPointer<T>& rData) { operator=(rData.GetPtr()); }
 	BURGER_INLINE T* operator->() const { return Dereference(); }
 	BURGER_INLINE T* GetPtr() const {	return Dereference(); }
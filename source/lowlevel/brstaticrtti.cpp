@@ -13,6 +13,31 @@
 ***************************************/
 
 #include "brstaticrtti.h"
+#include "bratomic.h"
+
+/*! ************************************
+
+    \brief Linked list of all registered StaticRTTI records
+
+    \sa StaticRTTI::Register(const StaticRTTI*)
+
+***************************************/
+
+const Burger::StaticRTTI* Burger::StaticRTTI::g_pFirstRegistered;
+
+/*! ************************************
+
+    \brief State of the type IDs of the registered records
+
+    Set to \ref kTypeIDsValid only after every registered record has its
+    type IDs, so a thread never uses type IDs that are still being assigned
+    by another thread.
+
+    \sa StaticRTTI::ComputeTypeIDs(void)
+
+***************************************/
+
+volatile uint32_t Burger::StaticRTTI::g_uTypeIDState;
 
 /*! ************************************
 
@@ -27,6 +52,10 @@
     The class itself does not contain any additional data to support this
     feature!!!
 
+    Every record is registered at startup and given an interval of type IDs
+    that covers all of its derived classes, so testing the type of a class is
+    a single compare and doesn't depend on the depth of the class tree.
+
     By using macros for calls, data tables and class hooks, a simple way to
     check if a base class is really a specific class is created.
 
@@ -190,30 +219,194 @@
 
 ***************************************/
 
+/*! ************************************
+
+    \fn uint_t Burger::StaticRTTI::IsInList(const StaticRTTI* pInput) const
+    \brief Determine if a class is of a specific type
+
+    Every registered StaticRTTI record is given a type ID in a depth first
+    walk of the class tree, so all of the classes derived from a class have
+    type IDs between that class's m_uTypeID and m_uLastTypeID. Once the type
+    IDs are assigned, this test is a single unsigned compare.
+
+    If the type IDs are not assigned yet or either record doesn't have a type
+    ID, IsInListSlow(const StaticRTTI*) const is called to assign them or
+    walk the linked list.
+
+    \param pInput Pointer to a StaticRTTI record to compare to this one
+    \return \ref TRUE if this record is in the linked list chain
+
+    \sa IsInListSlow(const StaticRTTI*) const or ComputeTypeIDs(void)
+
+***************************************/
+
 /*! ************************************
 
     \brief Determine if a class is of a specific type
 
-    Walk the StaticRTTI linked list from the most derived type and up to the
-    base class, all the while checking for a match.
+    If there are registered records that have not been assigned type IDs,
+    call ComputeTypeIDs(void) and use the new IDs. If another thread is
+    assigning the type IDs or a record has no type ID, walk the
+    StaticRTTI linked list from the most derived type and up to the base
+    class, all the while checking for a match. The walk is only needed for
+    records that were not created with BURGER_CREATE_STATICRTTI_BASE or
+    BURGER_CREATE_STATICRTTI_PARENT.
 
     \param pInput Pointer to a StaticRTTI record to compare to this one
     \return \ref TRUE if this record is in the linked list chain
 
+    \sa IsInList(const StaticRTTI*) const
+
 ***************************************/
 
-uint_t BURGER_API Burger::StaticRTTI::IsInList(
+uint_t BURGER_API Burger::StaticRTTI::IsInListSlow(
     const StaticRTTI* pInput) const BURGER_NOEXCEPT
 {
+    if (AtomicGetAcquire(&g_uTypeIDState) != kTypeIDsValid) {
+        ComputeTypeIDs();
+        if (AtomicGetAcquire(&g_uTypeIDState) == kTypeIDsValid) {
+            const uint32_t uTypeID = m_uTypeID;
+            const uint32_t uFirst = pInput->m_uTypeID;
+            if (uTypeID && uFirst) {
+                return (uTypeID - uFirst) <= (pInput->m_uLastTypeID - uFirst);
+            }
+        }
+    }
+
     // since there should be only one static instance of the type ID, it should
     // be safe to compare the ID string pointers
-    uint_t bRetVal = (pInput->m_pClassName == m_pClassName);
-    if (!bRetVal && m_pParent) {
-        bRetVal = m_pParent->IsInList(pInput);
+    const StaticRTTI* pWork = this;
+    do {
+        if (pInput->m_pClassName == pWork->m_pClassName) {
+            return TRUE;
+        }
+        pWork = pWork->m_pParent;
+    } while (pWork);
+    return FALSE;
+}
+
+/*! ************************************
+
+    \brief Add a StaticRTTI record to the list of known classes
+
+    BURGER_CREATE_STATICRTTI_BASE and BURGER_CREATE_STATICRTTI_PARENT call
+    this function at startup for every class so ComputeTypeIDs(void) can
+    assign type IDs to all classes at once.
+
+    \note This is called during static construction, so it must not
+        allocate memory or depend on any other global object. Registering
+        a record while other threads are performing type tests is not thread
+        safe.
+
+    \param pInput Pointer to a StaticRTTI record to register
+
+    \sa ComputeTypeIDs(void) or StaticRTTIRegister
+
+***************************************/
+
+void BURGER_API Burger::StaticRTTI::Register(
+    const StaticRTTI* pInput) BURGER_NOEXCEPT
+{
+    pInput->m_pNextRegistered = g_pFirstRegistered;
+    g_pFirstRegistered = pInput;
+    AtomicSetRelease(&g_uTypeIDState, kTypeIDsInvalid);
+}
+
+#if !defined(DOXYGEN)
+
+//
+// Assign type IDs to a class and all of the classes derived from it.
+// Return the next available type ID
+//
+
+static uint32_t BURGER_API AssignTypeIDs(
+    const Burger::StaticRTTI* pParent, uint32_t uTypeID) BURGER_NOEXCEPT
+{
+    pParent->m_uTypeID = uTypeID;
+    ++uTypeID;
+    const Burger::StaticRTTI* pWork = Burger::StaticRTTI::g_pFirstRegistered;
+    while (pWork) {
+        if (pWork->m_pParent == pParent) {
+            uTypeID = AssignTypeIDs(pWork, uTypeID);
+        }
+        pWork = pWork->m_pNextRegistered;
+    }
+    pParent->m_uLastTypeID = uTypeID - 1;
+    return uTypeID;
+}
+
+#endif
+
+/*! ************************************
+
+    \brief Assign type IDs to all registered classes
+
+    Number all of the registered StaticRTTI records with a depth first walk
+    of each class tree so every class has a range of type IDs that includes
+    itself and all of its derived classes. This turns IsInList(const
+    StaticRTTI*) const into a range test instead of a walk of the linked list.
+
+    This is called automatically by the first type test after a class was
+    registered, which is normally the first type test after startup. It can be
+    called manually at startup so the work is done before any threads are
+    started.
+
+    The records are shared by all threads, so only the thread that moves
+    \ref g_uTypeIDState from \ref kTypeIDsInvalid to \ref kTypeIDsBusy assigns
+    the type IDs. Type tests on other threads walk the linked list until
+    the state is set to \ref kTypeIDsValid after the last type ID is written.
+
+    \note Classes whose parent was not registered are not given type IDs,
+        type tests on them will fall back to walking the linked list.
+
+    \sa Register(const StaticRTTI*) or IsInList(const StaticRTTI*) const
+
+***************************************/
+
+void BURGER_API Burger::StaticRTTI::ComputeTypeIDs(void) BURGER_NOEXCEPT
+{
+    // Only one thread assigns the type IDs
+    if (AtomicSetIfMatch(&g_uTypeIDState, kTypeIDsInvalid, kTypeIDsBusy)) {
+        // Start at 1, since zero means no type ID
+        uint32_t uTypeID = 1;
+        const StaticRTTI* pWork = g_pFirstRegistered;
+        while (pWork) {
+            // Walk every class tree from its base class
+            if (!pWork->m_pParent) {
+                uTypeID = AssignTypeIDs(pWork, uTypeID);
+            }
+            pWork = pWork->m_pNextRegistered;
+        }
+        // Publish the type IDs, the compare and swap is a full memory
+        // barrier, so it releases the type ID stores to the acquire load
+        // in IsInList(). If a record was registered in the meantime, leave
+        // the state invalid so the type IDs are assigned again.
+        AtomicSetIfMatch(&g_uTypeIDState, kTypeIDsBusy, kTypeIDsValid);
     }
-    return bRetVal;
 }
 
+/*! ************************************
+
+    \class Burger::StaticRTTIRegister
+    \brief Register a StaticRTTI record at startup
+
+    BURGER_CREATE_STATICRTTI_BASE and BURGER_CREATE_STATICRTTI_PARENT create a
+    static instance of this class next to every StaticRTTI record so all
+    records are known before main() is called.
+
+    \sa StaticRTTI::Register(const StaticRTTI*)
+
+***************************************/
+
+/*! ************************************
+
+    \fn Burger::StaticRTTIRegister::StaticRTTIRegister(const StaticRTTI* pInput)
+    \brief Register a StaticRTTI record
+
+    \param pInput Pointer to a StaticRTTI record to register
+
+***************************************/
+
 /*! ************************************
 
     \def BURGER_RTTI_IN_BASE_CLASS()
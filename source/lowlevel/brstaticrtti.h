@@ -18,16 +18,57 @@
 #include "brtypes.h"
 #endif
 
+#ifndef __BRATOMIC_H__
+#include "bratomic.h"
+#endif
+
 /* BEGIN */
 namespace Burger {
 struct StaticRTTI {
+    enum eTypeIDState {
+        kTypeIDsInvalid, ///< Type IDs need to be assigned
+        kTypeIDsBusy,    ///< A thread is assigning the type IDs
+        kTypeIDsValid    ///< All registered records have type IDs
+    };
+
     const char* m_pClassName;    ///< Pointer to the name of the class
     const StaticRTTI* m_pParent; ///< Pointer to the parent in a derived class
+    mutable const StaticRTTI* m_pNextRegistered; ///< Next registered record
+    mutable uint32_t m_uTypeID;     ///< Type ID, zero if not assigned yet
+    mutable uint32_t m_uLastTypeID; ///< Highest type ID of all derived classes
+
+    static const StaticRTTI* g_pFirstRegistered; ///< List of all records
+    static volatile uint32_t g_uTypeIDState; ///< State of the type IDs
+
     BURGER_INLINE const char* GetClassName(void) const BURGER_NOEXCEPT
     {
         return m_pClassName;
     }
-    uint_t BURGER_API IsInList(const StaticRTTI* pInput) const BURGER_NOEXCEPT;
+    BURGER_INLINE uint_t IsInList(const StaticRTTI* pInput) const BURGER_NOEXCEPT
+    {
+        // Only use the type IDs once they are all assigned, the acquire
+        // pairs with the release in ComputeTypeIDs()
+        if (AtomicGetAcquire(&g_uTypeIDState) == kTypeIDsValid) {
+            const uint32_t uTypeID = m_uTypeID;
+            const uint32_t uFirst = pInput->m_uTypeID;
+            if (uTypeID && uFirst) {
+                // uTypeID>=uFirst && uTypeID<=m_uLastTypeID
+                return (uTypeID - uFirst) <= (pInput->m_uLastTypeID - uFirst);
+            }
+        }
+        return IsInListSlow(pInput);
+    }
+    uint_t BURGER_API IsInListSlow(const StaticRTTI* pInput) const BURGER_NOEXCEPT;
+    static void BURGER_API Register(const StaticRTTI* pInput) BURGER_NOEXCEPT;
+    static void BURGER_API ComputeTypeIDs(void) BURGER_NOEXCEPT;
+};
+
+class StaticRTTIRegister {
+public:
+    BURGER_INLINE StaticRTTIRegister(const StaticRTTI* pInput) BURGER_NOEXCEPT
+    {
+        StaticRTTI::Register(pInput);
+    }
 };
 }
 
@@ -53,7 +94,10 @@ public: \
     { \
         return &g_StaticRTTI; \
     } \
-    const Burger::StaticRTTI __ClassName::g_StaticRTTI = {#__ClassName, nullptr}
+    const Burger::StaticRTTI __ClassName::g_StaticRTTI = { \
+        #__ClassName, nullptr, nullptr, 0, 0}; \
+    static const Burger::StaticRTTIRegister BURGER_JOIN( \
+        StaticRTTIRegister, __LINE__)(&__ClassName::g_StaticRTTI)
 
 #define BURGER_CREATE_STATICRTTI_PARENT(__ClassName, __ParentClass) \
     const Burger::StaticRTTI* __ClassName ::GetStaticRTTI(void) \
@@ -62,7 +106,9 @@ public: \
         return &g_StaticRTTI; \
     } \
     const Burger::StaticRTTI __ClassName::g_StaticRTTI = { \
-        #__ClassName, &__ParentClass::g_StaticRTTI}
+        #__ClassName, &__ParentClass::g_StaticRTTI, nullptr, 0, 0}; \
+    static const Burger::StaticRTTIRegister BURGER_JOIN( \
+        StaticRTTIRegister, __LINE__)(&__ClassName::g_StaticRTTI)
 
 #define BURGER_STATICRTTI_ISTYPE(__ClassName, __Pointer) \
     (__Pointer)->GetStaticRTTI()->IsInList(&__ClassName::g_StaticRTTI)
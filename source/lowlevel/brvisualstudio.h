@@ -138,6 +138,9 @@ long __cdecl _InterlockedIncrement(long volatile*);
 long __cdecl _InterlockedDecrement(long volatile*);
 #pragma intrinsic(_InterlockedIncrement, _InterlockedDecrement)
 
+void _ReadWriteBarrier(void);
+#pragma intrinsic(_ReadWriteBarrier)
+
 #if defined(BURGER_64BITCPU)
 __int64 _InterlockedExchange64(__int64 volatile*, __int64);
 __int64 _InterlockedIncrement64(__int64 volatile*);
@@ -105,6 +105,7 @@
 #include "brwiiutypes.h"
 #include "brendian.h"
 #include "brfpinfo.h"
+#include "bratomic.h"
 #include "brstaticrtti.h"
 #include "brbase.h"
 #include "brcodelibrary.h"
@@ -115,7 +116,7 @@
 #include "brisolatin1.h"
 #include "brmacromanus.h"
 #include "brwin1252.h"
-#include "bratomic.h"
+#include "brcpudispatch.h"
 #include "brcriticalsection.h"
 #include "brmemorymanager.h"
 #include "brmemoryansi.h"
@@ -145,6 +146,8 @@
 #include "brmd5.h"
 #include "brpackfloat.h"
 #include "brsha1.h"
+#include "brsha256.h"
+#include "brmultihash.h"
 #include "brgost.h"
 #include "brunpackbytes.h"
 #include "brglobals.h"
@@ -196,10 +199,13 @@
 #include "brcompresslbmrle.h"
 #include "brcompresslzss.h"
 #include "brcompressdeflate.h"
+#include "brcompresslz4.h"
 #include "brdecompress.h"
 #include "brdecompresslbmrle.h"
 #include "brdecompresslzss.h"
 #include "brdecompressdeflate.h"
+#include "brdecompresslz4.h"
+#include "brdecompressstream.h"
 #include "brrezfile.h"
 #include "brgameapp.h"
 #include "brrenderer.h"
@@ -224,6 +230,9 @@
 #include "brdxt1.h"
 #include "brdxt3.h"
 #include "brdxt5.h"
+#include "brbc4.h"
+#include "brbc5.h"
+#include "brbc7.h"
 #include "brtexturedirectx9.h"
 #include "brtextureopengl.h"
 #include "brshaders.h"
@@ -272,6 +281,7 @@
 #include "brnetendpointtcp.h"
 #include "brnetplay.h"
 #include "brgridindex.h"
+#include "brboundingboxtree.h"
 #include "brearcliptriangulate.h"
 #include "brflashstream.h"
 #include "brflashrgba.h"
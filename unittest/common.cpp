@@ -18,6 +18,8 @@
 #include "brglobals.h"
 #include "createtables.h"
 #include "testbralgorithm.h"
+#include "testbrbenchmark.h"
+#include "testbrboundingboxtree.h"
 #include "testbrcompression.h"
 #include "testbrdisplay.h"
 #include "testbrendian.h"
@@ -25,11 +27,13 @@
 #include "testbrfilemanager.h"
 #include "testbrfixedpoint.h"
 #include "testbrfloatingpoint.h"
+#include "testbrgridindex.h"
 #include "testbrhashes.h"
 #include "testbrmatrix3d.h"
 #include "testbrmatrix4d.h"
 #include "testbrnetwork.h"
 #include "testbrprintf.h"
+#include "testbrsmartpointer.h"
 #include "testbrstaticrtti.h"
 #include "testbrstrings.h"
 #include "testbrtimedate.h"
@@ -245,10 +249,12 @@ int BURGER_ANSIAPI main(int argc, const char** argv)
     CommandParameterBooleanTrue DisplayTests("Display tests", "display");
     CommandParameterBooleanTrue FileTests("File tests", "file");
     CommandParameterBooleanTrue CompressTests("Compression tests", "compress");
+    CommandParameterBooleanTrue BenchmarkTests(
+        "Compression benchmarks", "benchmark");
 
     const CommandParameter* MyParms[] = {&Version, &WriteTables, &AllTests,
         &Verbose, &ShowMacros, &DialogTests, &NetworkTests, &TimeTests,
-        &DisplayTests, &FileTests, &CompressTests};
+        &DisplayTests, &FileTests, &CompressTests, &BenchmarkTests};
 
     iResult = CommandParameter::Process(MyApp.GetArgc(), MyApp.GetArgv(),
         MyParms, sizeof(MyParms) / sizeof(MyParms[0]),
@@ -289,6 +295,9 @@ int BURGER_ANSIAPI main(int argc, const char** argv)
         if (CompressTests.GetValue()) {
             uVerbose |= VERBOSE_COMPRESS;
         }
+        if (BenchmarkTests.GetValue()) {
+            uVerbose |= VERBOSE_BENCHMARK;
+        }
     }
 
     // Special cases
@@ -331,6 +340,9 @@ int BURGER_ANSIAPI main(int argc, const char** argv)
         iResult |= TestBrmatrix3d(uVerbose);
         iResult |= TestBrmatrix4d(uVerbose);
         iResult |= TestBrstaticrtti(uVerbose);
+        iResult |= TestBrsmartpointer(uVerbose);
+        iResult |= TestBrboundingboxtree(uVerbose);
+        iResult |= TestBrgridindex(uVerbose);
         iResult |= TestBrhashes(uVerbose);
         iResult |= TestCharset(uVerbose);
         iResult |= TestBrstrings(uVerbose);
@@ -338,6 +350,7 @@ int BURGER_ANSIAPI main(int argc, const char** argv)
         iResult |= TestDateTime(uVerbose);
         iResult |= TestNetwork(uVerbose);
         iResult |= TestBrcompression(uVerbose);
+        iResult |= TestBrbenchmark(uVerbose);
         iResult |= TestBrFileManager(uVerbose);
 
         if (uVerbose & VERBOSE_DIALOGS) {
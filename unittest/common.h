@@ -33,6 +33,7 @@
 #define VERBOSE_DIALOGS 0x0020  // Set for testing dialogs
 #define VERBOSE_DISPLAY 0x0040  // Set for testing display modes
 #define VERBOSE_COMPRESS 0x0080 // Set for testing compression algorithms
+#define VERBOSE_BENCHMARK 0x0100 // Set for compression benchmarks
 #define VERBOSE_DOTESTS 0x8000  // Set if tests are to be performed
 #define VERBOSE_ALL 0xFFFF
 
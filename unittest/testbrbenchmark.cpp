@@ -0,0 +1,595 @@
+/***************************************
+
+    Benchmarks for the compression and checksum libraries
+
+    Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+    It is released under an MIT Open Source license. Please see LICENSE for
+    license details. Yes, you can use it in a commercial title without paying
+    anything, just give me a credit.
+
+    Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrbenchmark.h"
+#include "bradler16.h"
+#include "bradler32.h"
+#include "brcompressdeflate.h"
+#include "brcompresslbmrle.h"
+#include "brcompresslz4.h"
+#include "brcompresslzss.h"
+#include "brcrc16.h"
+#include "brcrc32.h"
+#include "brdecompressdeflate.h"
+#include "brdecompresslbmrle.h"
+#include "brdecompresslz4.h"
+#include "brdecompresslzss.h"
+#include "brendian.h"
+#include "brfloatingpoint.h"
+#include "brglobals.h"
+#include "brgost.h"
+#include "brmd2.h"
+#include "brmd4.h"
+#include "brmd5.h"
+#include "brmemoryfunctions.h"
+#include "brnumberto.h"
+#include "broutputmemorystream.h"
+#include "brsha1.h"
+#include "brsha256.h"
+#include "brstringfunctions.h"
+#include "brtick.h"
+#include "common.h"
+
+using namespace Burger;
+
+//
+// Every result is printed as a comma separated line that starts with
+// "benchmark," so it can be pulled out of the log with grep and compared
+// between versions. Times are the fastest of several runs after a warm up
+// run, and MB/s is 1,000,000 bytes per second.
+//
+
+static const Word32 g_uBenchmarkMinimumTime = 100000; // Microseconds
+static const Word g_uBenchmarkMinimumRuns = 3;
+static const Word g_uBenchmarkMaximumRuns = 1000;
+
+static const WordPtr g_uBenchmarkSampleSize = 0x40000;
+static const Word g_uBenchmarkSampleCount = 4;
+static const char* g_BenchmarkSampleNames[g_uBenchmarkSampleCount] = {
+	"text", "binary", "image", "audio"};
+
+static Word8 g_BenchmarkCorpus[g_uBenchmarkSampleCount][g_uBenchmarkSampleSize];
+static Word8 g_BenchmarkCompressed[g_uBenchmarkSampleSize + (g_uBenchmarkSampleSize / 4)];
+static Word8 g_BenchmarkDecompressed[g_uBenchmarkSampleSize];
+
+//
+// Text made from a vocabulary, split into sentences and lines
+//
+
+static const char* g_BenchmarkWords[] = {"the", "of", "and", "to", "a", "in",
+	"is", "it", "that", "was", "for", "on", "with", "as", "his", "they", "at",
+	"be", "this", "from", "have", "or", "by", "one", "had", "but", "what",
+	"all", "were", "when", "we", "there", "can", "an", "your", "which",
+	"their", "said", "each", "she", "do", "how", "will", "up", "other",
+	"about", "out", "many", "then", "them", "these", "so", "some", "her",
+	"would", "make", "like", "him", "into", "time", "has", "look", "two",
+	"more", "write", "go", "see", "number", "no", "way", "could", "people",
+	"dragon", "castle", "sword", "texture", "level", "player", "score"};
+
+static void BuildBenchmarkText(Word8* pOutput, WordPtr uLength)
+{
+	Word32 uSeed = 0x10203040U;
+	WordPtr uColumn = 0;
+	Word bCapital = TRUE;
+	WordPtr i = 0;
+	while (i < uLength) {
+		uSeed = (uSeed * 1103515245U) + 12345U;
+		const char* pWord = g_BenchmarkWords[(uSeed >> 16U) %
+			BURGER_ARRAYSIZE(g_BenchmarkWords)];
+		Word uFirst = static_cast<Word8>(pWord[0]);
+		if (bCapital) {
+			uFirst -= 'a' - 'A';
+			bCapital = FALSE;
+		}
+		pOutput[i++] = static_cast<Word8>(uFirst);
+		++pWord;
+		++uColumn;
+		while (pWord[0] && (i < uLength)) {
+			pOutput[i++] = static_cast<Word8>(pWord[0]);
+			++pWord;
+			++uColumn;
+		}
+		// End of a sentence?
+		if (!((uSeed >> 8U) % 11U) && (i < uLength)) {
+			pOutput[i++] = ((uSeed >> 4U) & 7U) ? '.' : '?';
+			++uColumn;
+			bCapital = TRUE;
+		} else if (!((uSeed >> 8U) % 13U) && (i < uLength)) {
+			pOutput[i++] = ',';
+			++uColumn;
+		}
+		if (i < uLength) {
+			if (uColumn >= 72) {
+				pOutput[i++] = '\n';
+				uColumn = 0;
+			} else {
+				pOutput[i++] = ' ';
+				++uColumn;
+			}
+		}
+	}
+}
+
+//
+// Game data records followed by something that looks like machine code
+//
+
+static void BuildBenchmarkBinary(Word8* pOutput, WordPtr uLength)
+{
+	Word32 uSeed = 0x55AA1234U;
+	WordPtr uHalf = uLength / 2;
+	WordPtr i = 0;
+	Word32 uID = 1000;
+	while ((i + 24) <= uHalf) {
+		uSeed = (uSeed * 1103515245U) + 12345U;
+		LittleEndian::StoreAny(reinterpret_cast<Word32*>(pOutput + i), uID);
+		LittleEndian::StoreAny(reinterpret_cast<float*>(pOutput + i + 4),
+			static_cast<float>(uID & 0xFFU) * 16.0f);
+		LittleEndian::StoreAny(reinterpret_cast<float*>(pOutput + i + 8),
+			static_cast<float>((uSeed >> 16U) & 0x3FFU) * 0.5f);
+		LittleEndian::StoreAny(reinterpret_cast<float*>(pOutput + i + 12), 0.0f);
+		LittleEndian::StoreAny(reinterpret_cast<Word16*>(pOutput + i + 16),
+			static_cast<Word16>((uSeed >> 28U) | 0x100U));
+		LittleEndian::StoreAny(reinterpret_cast<Word16*>(pOutput + i + 18),
+			static_cast<Word16>(uID % 7U));
+		LittleEndian::StoreAny(
+			reinterpret_cast<Word32*>(pOutput + i + 20), 100U - (uSeed >> 29U));
+		uID += 1 + ((uSeed >> 24U) & 1U);
+		i += 24;
+	}
+
+	// Opcodes from a small set, some with immediate values
+	static const Word8 s_Opcodes[] = {0x48, 0x89, 0x8B, 0xE8, 0xC3, 0x83,
+		0x0F, 0x74, 0x75, 0xFF, 0x50, 0x58, 0x31, 0xC0, 0x90, 0xEB};
+	while (i < uLength) {
+		uSeed = (uSeed * 1103515245U) + 12345U;
+		Word uOpcode = s_Opcodes[(uSeed >> 16U) & 15U];
+		pOutput[i++] = static_cast<Word8>(uOpcode);
+		if ((uOpcode == 0xE8) || (uOpcode == 0x83)) {
+			Word j = 0;
+			while ((j < 4) && (i < uLength)) {
+				pOutput[i++] = static_cast<Word8>(
+					(j < 2) ? (uSeed >> (8U * j)) : ((uSeed & 0x100U) ? 0xFF : 0));
+				++j;
+			}
+		}
+	}
+}
+
+//
+// A 256x256 RGBA image with gradients, a few shapes and sensor noise
+//
+
+static void BuildBenchmarkImage(Word8* pOutput, WordPtr uLength)
+{
+	Word32 uSeed = 0x0BADF00DU;
+	Word uHeight = static_cast<Word>(uLength / (256 * 4));
+	Word y = 0;
+	do {
+		Word x = 0;
+		do {
+			uSeed = (uSeed * 1103515245U) + 12345U;
+			Word uNoise = (uSeed >> 16U) & 3U;
+			Word uRed = x;
+			Word uGreen = y;
+			Word uBlue = (x + y) >> 1U;
+			// Circle in the middle
+			int iDX = static_cast<int>(x) - 128;
+			int iDY = static_cast<int>(y) - 128;
+			if (((iDX * iDX) + (iDY * iDY)) < (60 * 60)) {
+				uRed = 0xF0;
+				uGreen = 0x80;
+				uBlue = 0x20;
+			}
+			// Checkerboard in a corner
+			if ((x < 64) && (y < 64) && (((x >> 3U) ^ (y >> 3U)) & 1U)) {
+				uRed = uGreen = uBlue = 0xFF;
+			}
+			pOutput[0] = static_cast<Word8>(uRed ^ uNoise);
+			pOutput[1] = static_cast<Word8>(uGreen ^ uNoise);
+			pOutput[2] = static_cast<Word8>(uBlue ^ uNoise);
+			pOutput[3] = 0xFF;
+			pOutput += 4;
+		} while (++x < 256);
+	} while (++y < uHeight);
+}
+
+//
+// 16 bit stereo at 44.1KHz, notes with an envelope and a little hiss
+//
+
+static void BuildBenchmarkAudio(Word8* pOutput, WordPtr uLength)
+{
+	static const float s_Notes[] = {261.63f, 293.66f, 329.63f, 349.23f,
+		392.00f, 440.00f, 493.88f, 523.25f};
+	Word32 uSeed = 0x600DCAFEU;
+	WordPtr uFrames = uLength / 4;
+	WordPtr i = 0;
+	do {
+		WordPtr uNote = (i / 4096) % BURGER_ARRAYSIZE(s_Notes);
+		float fTime = static_cast<float>(i) * (1.0f / 44100.0f);
+		float fEnvelope =
+			1.0f - (static_cast<float>(i & 4095) * (1.0f / 4096.0f));
+		float fSample = (Sin(fTime * s_Notes[uNote] * g_fPi * 2.0f) * 0.6f) +
+			(Sin(fTime * s_Notes[uNote] * g_fPi * 3.0f) * 0.2f);
+		fSample *= fEnvelope * 16000.0f;
+		uSeed = (uSeed * 1103515245U) + 12345U;
+		int iNoise = static_cast<int>((uSeed >> 16U) & 63U) - 32;
+		Int16 iLeft = static_cast<Int16>(static_cast<int>(fSample) + iNoise);
+		Int16 iRight =
+			static_cast<Int16>(static_cast<int>(fSample * 0.8f) - iNoise);
+		LittleEndian::StoreAny(reinterpret_cast<Int16*>(pOutput), iLeft);
+		LittleEndian::StoreAny(reinterpret_cast<Int16*>(pOutput + 2), iRight);
+		pOutput += 4;
+	} while (++i < uFrames);
+}
+
+//
+// Codecs to benchmark, add new Compress/Decompress pairs here
+//
+
+static Compress* NewILBMRLE(void)
+{
+	return New<CompressILBMRLE>();
+}
+
+static Decompress* NewUnILBMRLE(void)
+{
+	return New<DecompressILBMRLE>();
+}
+
+static Compress* NewLZSS(void)
+{
+	return New<CompressLZSS>();
+}
+
+static Decompress* NewUnLZSS(void)
+{
+	return New<DecompressLZSS>();
+}
+
+static Compress* NewLZSSLarge(void)
+{
+	CompressLZSS* pCompress = New<CompressLZSS>();
+	pCompress->SetLargeWindow(TRUE);
+	return pCompress;
+}
+
+static Decompress* NewUnLZSSLarge(void)
+{
+	DecompressLZSS* pDecompress = New<DecompressLZSS>();
+	pDecompress->SetLargeWindow(TRUE);
+	return pDecompress;
+}
+
+static Compress* NewDeflateFast(void)
+{
+	CompressDeflate* pCompress = New<CompressDeflate>();
+	pCompress->SetLevel(CompressDeflate::Z_BEST_SPEED);
+	return pCompress;
+}
+
+static Compress* NewDeflate(void)
+{
+	CompressDeflate* pCompress = New<CompressDeflate>();
+	pCompress->SetLevel(CompressDeflate::Z_DEFAULT_COMPRESSION);
+	return pCompress;
+}
+
+static Compress* NewDeflateBest(void)
+{
+	CompressDeflate* pCompress = New<CompressDeflate>();
+	pCompress->SetLevel(CompressDeflate::Z_BEST_COMPRESSION);
+	return pCompress;
+}
+
+static Decompress* NewInflate(void)
+{
+	return New<DecompressDeflate>();
+}
+
+static Compress* NewLZ4(void)
+{
+	return New<CompressLZ4>();
+}
+
+static Compress* NewLZ4High(void)
+{
+	CompressLZ4* pCompress = New<CompressLZ4>();
+	pCompress->SetHighCompression(TRUE);
+	return pCompress;
+}
+
+static Decompress* NewUnLZ4(void)
+{
+	return New<DecompressLZ4>();
+}
+
+struct BenchmarkCodec_t {
+	const char* m_pName;
+	Compress* (*m_pNewCompress)(void);
+	Decompress* (*m_pNewDecompress)(void);
+};
+
+static const BenchmarkCodec_t g_BenchmarkCodecs[] = {
+	{"ILBMRLE", NewILBMRLE, NewUnILBMRLE}, {"LZSS", NewLZSS, NewUnLZSS},
+	{"LZSSLarge", NewLZSSLarge, NewUnLZSSLarge},
+	{"Deflate1", NewDeflateFast, NewInflate},
+	{"Deflate6", NewDeflate, NewInflate},
+	{"Deflate9", NewDeflateBest, NewInflate}, {"LZ4", NewLZ4, NewUnLZ4},
+	{"LZ4High", NewLZ4High, NewUnLZ4}};
+
+//
+// Checksums and hashes to benchmark
+//
+
+static void BenchmarkAdler16(void* pOutput, const void* pInput, WordPtr uLength)
+{
+	static_cast<Word32*>(pOutput)[0] = CalcAdler16(pInput, uLength);
+}
+
+static void BenchmarkAdler32(void* pOutput, const void* pInput, WordPtr uLength)
+{
+	static_cast<Word32*>(pOutput)[0] = CalcAdler32(pInput, uLength);
+}
+
+static void BenchmarkCRC16IBM(
+	void* pOutput, const void* pInput, WordPtr uLength)
+{
+	static_cast<Word32*>(pOutput)[0] = CalcCRC16IBM(pInput, uLength);
+}
+
+static void BenchmarkCRC32(void* pOutput, const void* pInput, WordPtr uLength)
+{
+	static_cast<Word32*>(pOutput)[0] = CalcCRC32(pInput, uLength);
+}
+
+static void BenchmarkCRC32B(void* pOutput, const void* pInput, WordPtr uLength)
+{
+	static_cast<Word32*>(pOutput)[0] = CalcCRC32B(pInput, uLength);
+}
+
+static void BenchmarkCRC32C(void* pOutput, const void* pInput, WordPtr uLength)
+{
+	static_cast<Word32*>(pOutput)[0] = CalcCRC32C(pInput, uLength);
+}
+
+static void BenchmarkMD2(void* pOutput, const void* pInput, WordPtr uLength)
+{
+	Hash(static_cast<MD2_t*>(pOutput), pInput, uLength);
+}
+
+static void BenchmarkMD4(void* pOutput, const void* pInput, WordPtr uLength)
+{
+	Hash(static_cast<MD4_t*>(pOutput), pInput, uLength);
+}
+
+static void BenchmarkMD5(void* pOutput, const void* pInput, WordPtr uLength)
+{
+	Hash(static_cast<MD5_t*>(pOutput), pInput, uLength);
+}
+
+static void BenchmarkSHA1(void* pOutput, const void* pInput, WordPtr uLength)
+{
+	Hash(static_cast<SHA1_t*>(pOutput), pInput, uLength);
+}
+
+static void BenchmarkSHA256(void* pOutput, const void* pInput, WordPtr uLength)
+{
+	Hash(static_cast<SHA256_t*>(pOutput), pInput, uLength);
+}
+
+static void BenchmarkGOST(void* pOutput, const void* pInput, WordPtr uLength)
+{
+	Hash(static_cast<GOST_t*>(pOutput), pInput, uLength);
+}
+
+struct BenchmarkChecksum_t {
+	const char* m_pName;
+	void (*m_pProc)(void* pOutput, const void* pInput, WordPtr uLength);
+	WordPtr m_uOutputSize;
+};
+
+static const BenchmarkChecksum_t g_BenchmarkChecksums[] = {
+	{"Adler16", BenchmarkAdler16, 2}, {"Adler32", BenchmarkAdler32, 4},
+	{"CRC16IBM", BenchmarkCRC16IBM, 2}, {"CRC32", BenchmarkCRC32, 4},
+	{"CRC32B", BenchmarkCRC32B, 4}, {"CRC32C", BenchmarkCRC32C, 4},
+	{"MD2", BenchmarkMD2, sizeof(MD2_t)}, {"MD4", BenchmarkMD4, sizeof(MD4_t)},
+	{"MD5", BenchmarkMD5, sizeof(MD5_t)},
+	{"SHA1", BenchmarkSHA1, sizeof(SHA1_t)},
+	{"SHA256", BenchmarkSHA256, sizeof(SHA256_t)},
+	{"GOST", BenchmarkGOST, sizeof(GOST_t)}};
+
+//
+// Run a step once to warm the caches, then time it until enough
+// runs were made and return the fastest time in microseconds
+//
+
+struct BenchmarkJob_t {
+	Compress* m_pCompress;
+	Decompress* m_pDecompress;
+	const BenchmarkChecksum_t* m_pChecksum;
+	const Word8* m_pInput;
+	WordPtr m_uInputLength;
+	WordPtr m_uCompressedLength;
+	Decompress::eError m_eError;
+};
+
+typedef void (*BenchmarkProc)(BenchmarkJob_t* pJob);
+
+static void BenchmarkCompress(BenchmarkJob_t* pJob)
+{
+	Compress* pCompress = pJob->m_pCompress;
+	pCompress->Init();
+	pCompress->Process(pJob->m_pInput, pJob->m_uInputLength);
+	pCompress->Finalize();
+}
+
+static void BenchmarkDecompress(BenchmarkJob_t* pJob)
+{
+	Decompress* pDecompress = pJob->m_pDecompress;
+	pDecompress->Reset();
+	pJob->m_eError = pDecompress->Process(g_BenchmarkDecompressed,
+		pJob->m_uInputLength, g_BenchmarkCompressed,
+		pJob->m_uCompressedLength);
+}
+
+static void BenchmarkChecksum(BenchmarkJob_t* pJob)
+{
+	Word32 Output[16];
+	pJob->m_pChecksum->m_pProc(Output, pJob->m_pInput, pJob->m_uInputLength);
+}
+
+static Word32 BenchmarkTime(BenchmarkProc pProc, BenchmarkJob_t* pJob)
+{
+	pProc(pJob);
+	Word32 uBest = BURGER_MAXUINT;
+	Word32 uTotal = 0;
+	Word uRuns = 0;
+	do {
+		Word32 uStart = Tick::ReadMicroseconds();
+		pProc(pJob);
+		Word32 uTime = Tick::ReadMicroseconds() - uStart;
+		if (uTime < uBest) {
+			uBest = uTime;
+		}
+		uTotal += uTime;
+	} while (((++uRuns < g_uBenchmarkMinimumRuns) ||
+				 (uTotal < g_uBenchmarkMinimumTime)) &&
+		(uRuns < g_uBenchmarkMaximumRuns));
+	// Don't divide by zero
+	return uBest ? uBest : 1;
+}
+
+//
+// Bytes per microsecond is MB/s
+//
+
+static double BenchmarkSpeed(WordPtr uLength, Word32 uTime)
+{
+	return static_cast<double>(uLength) / static_cast<double>(uTime);
+}
+
+//
+// Benchmark a codec with one sample of the corpus
+//
+
+static Word BenchmarkCodec(const BenchmarkCodec_t* pCodec,
+	const char* pVersion, const char* pSampleName, const Word8* pInput,
+	WordPtr uLength)
+{
+	Word uFailure = FALSE;
+	BenchmarkJob_t Job;
+	Job.m_pCompress = pCodec->m_pNewCompress();
+	Job.m_pDecompress = pCodec->m_pNewDecompress();
+	Job.m_pChecksum = NULL;
+	Job.m_pInput = pInput;
+	Job.m_uInputLength = uLength;
+	Job.m_eError = Decompress::DECOMPRESS_OKAY;
+
+	Word32 uCompressTime = BenchmarkTime(BenchmarkCompress, &Job);
+	WordPtr uCompressedLength = Job.m_pCompress->GetOutputSize();
+	if ((uCompressedLength > sizeof(g_BenchmarkCompressed)) ||
+		Job.m_pCompress->GetOutput()->Flatten(
+			g_BenchmarkCompressed, uCompressedLength)) {
+		ReportFailure("Benchmark %s %s compressed to %u bytes", TRUE,
+			pCodec->m_pName, pSampleName,
+			static_cast<Word>(uCompressedLength));
+		uFailure = TRUE;
+	} else {
+		Job.m_uCompressedLength = uCompressedLength;
+		MemoryClear(g_BenchmarkDecompressed, uLength);
+		Word32 uDecompressTime = BenchmarkTime(BenchmarkDecompress, &Job);
+
+		// A fast codec that's wrong is worthless
+		if ((Job.m_eError != Decompress::DECOMPRESS_OKAY) ||
+			MemoryCompare(g_BenchmarkDecompressed, pInput, uLength)) {
+			ReportFailure("Benchmark %s %s round trip failed, error %d", TRUE,
+				pCodec->m_pName, pSampleName, Job.m_eError);
+			uFailure = TRUE;
+		} else {
+			Message("benchmark,%s,%s,%s,%u,%u,%.4f,%.2f,%.2f", pVersion,
+				pCodec->m_pName, pSampleName, static_cast<Word>(uLength),
+				static_cast<Word>(uCompressedLength),
+				static_cast<double>(uCompressedLength) /
+					static_cast<double>(uLength),
+				BenchmarkSpeed(uLength, uCompressTime),
+				BenchmarkSpeed(uLength, uDecompressTime));
+		}
+	}
+	Delete(Job.m_pDecompress);
+	Delete(Job.m_pCompress);
+	return uFailure;
+}
+
+//
+// Benchmark every codec with every sample, then the checksums
+//
+
+int BURGER_API TestBrbenchmark(Word uVerbose)
+{
+	Word uResult = 0;
+	if (uVerbose & VERBOSE_BENCHMARK) {
+		if (uVerbose & VERBOSE_MSG) {
+			Message("Running Compression benchmarks");
+		}
+		BuildBenchmarkText(g_BenchmarkCorpus[0], g_uBenchmarkSampleSize);
+		BuildBenchmarkBinary(g_BenchmarkCorpus[1], g_uBenchmarkSampleSize);
+		BuildBenchmarkImage(g_BenchmarkCorpus[2], g_uBenchmarkSampleSize);
+		BuildBenchmarkAudio(g_BenchmarkCorpus[3], g_uBenchmarkSampleSize);
+
+		// The version is in every line so logs can be merged
+		char Version[64];
+		Word32 uVersion = Globals::Version();
+		char* pVersion = NumberToAscii(Version, uVersion >> 24U);
+		pVersion[0] = '.';
+		pVersion = NumberToAscii(pVersion + 1, (uVersion >> 16U) & 0xFFU);
+		pVersion[0] = '.';
+		NumberToAscii(pVersion + 1, Globals::VersionBuild());
+
+		Message("benchmark,version,codec,corpus,bytes,compressed,ratio,"
+				"compress_mbs,decompress_mbs");
+		WordPtr i = 0;
+		do {
+			Word j = 0;
+			do {
+				uResult |= BenchmarkCodec(&g_BenchmarkCodecs[i], Version,
+					g_BenchmarkSampleNames[j], g_BenchmarkCorpus[j],
+					g_uBenchmarkSampleSize);
+			} while (++j < g_uBenchmarkSampleCount);
+		} while (++i < BURGER_ARRAYSIZE(g_BenchmarkCodecs));
+
+		// Checksums don't decompress, so ratio and decompress are empty
+		BenchmarkJob_t Job;
+		Job.m_pCompress = NULL;
+		Job.m_pDecompress = NULL;
+		Job.m_pInput = g_BenchmarkCorpus[0];
+		Job.m_uInputLength = sizeof(g_BenchmarkCorpus);
+		i = 0;
+		do {
+			Job.m_pChecksum = &g_BenchmarkChecksums[i];
+			Word32 uTime = BenchmarkTime(BenchmarkChecksum, &Job);
+			Message("benchmark,%s,%s,all,%u,%u,,%.2f,", Version,
+				g_BenchmarkChecksums[i].m_pName,
+				static_cast<Word>(sizeof(g_BenchmarkCorpus)),
+				static_cast<Word>(g_BenchmarkChecksums[i].m_uOutputSize),
+				BenchmarkSpeed(sizeof(g_BenchmarkCorpus), uTime));
+		} while (++i < BURGER_ARRAYSIZE(g_BenchmarkChecksums));
+
+		if (!uResult && (uVerbose & VERBOSE_MSG)) {
+			Message("Finished all Compression benchmarks!");
+		}
+	}
+	return static_cast<int>(uResult);
+}
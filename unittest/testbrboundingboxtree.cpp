@@ -0,0 +1,462 @@
+/***************************************
+
+	Unit tests for the bounding box tree
+
+    Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+    It is released under an MIT Open Source license. Please see LICENSE for
+    license details. Yes, you can use it in a commercial title without paying
+    anything, just give me a credit.
+
+    Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrboundingboxtree.h"
+#include "brboundingboxtree.h"
+#include "brfloatingpoint.h"
+#include "brrandom.h"
+#include "common.h"
+
+using namespace Burger;
+
+//
+// Every query is checked against a brute force test of all the items
+//
+
+static const Word g_uItemCount = 2000;
+static const Word g_uQueryCount = 64;
+static Vector4D_t g_ItemBounds[g_uItemCount];
+static Word g_ItemValues[g_uItemCount];
+static Word g_ItemProxies[g_uItemCount];
+static Word8 g_ItemLive[g_uItemCount];
+static Word8 g_ItemMarks[g_uItemCount];
+
+//
+// Create a random box, a few of them are large
+//
+
+static void MakeBox(Vector4D_t *pOutput, Random *pRandom, Word uIndex)
+{
+	float fSize = (!(uIndex % 50)) ? 200.0f : 8.0f;
+	pOutput->x = pRandom->GetFloat(1000.0f);
+	pOutput->y = pRandom->GetFloat(1000.0f);
+	pOutput->z = pOutput->x + pRandom->GetFloat(fSize);
+	pOutput->w = pOutput->y + pRandom->GetFloat(fSize);
+}
+
+//
+// Brute force versions of the tree's tests
+//
+
+static Word OverlapsBox(const Vector4D_t *pA, const Vector4D_t *pB)
+{
+	return (pA->x <= pB->z) && (pA->z >= pB->x) && (pA->y <= pB->w) &&
+		(pA->w >= pB->y);
+}
+
+static Word ContainsBox(const Vector4D_t *pOuter, const Vector4D_t *pInner)
+{
+	return (pInner->x >= pOuter->x) && (pInner->y >= pOuter->y) &&
+		(pInner->z <= pOuter->z) && (pInner->w <= pOuter->w);
+}
+
+static Word ContainsPoint(const Vector4D_t *pBounds, const Vector2D_t *pPoint)
+{
+	return (pPoint->x >= pBounds->x) && (pPoint->x <= pBounds->z) &&
+		(pPoint->y >= pBounds->y) && (pPoint->y <= pBounds->w);
+}
+
+static Word TouchesFrustum(
+	const Vector4D_t *pBounds, const Vector3D_t *pPlanes, Word uPlaneCount)
+{
+	Word i = 0;
+	while (i < uPlaneCount) {
+		// Test the corner furthest along the normal
+		float fNX = pPlanes[i].x;
+		float fNY = pPlanes[i].y;
+		if (((fNX * ((fNX >= 0.0f) ? pBounds->z : pBounds->x)) +
+				(fNY * ((fNY >= 0.0f) ? pBounds->w : pBounds->y)) +
+				pPlanes[i].z) < 0.0f) {
+			return FALSE;
+		}
+		++i;
+	}
+	return TRUE;
+}
+
+static Word RayHitsBox(float *pEnter, const Vector4D_t *pBounds,
+	const Vector2D_t *pStart, const Vector2D_t *pEnd)
+{
+	float fMin = 0.0f;
+	float fMax = 1.0f;
+	const float *pBoxMin = &pBounds->x;
+	const float *pBoxMax = &pBounds->z;
+	const float *pRayStart = &pStart->x;
+	const float *pRayEnd = &pEnd->x;
+	Word i = 0;
+	do {
+		float fDelta = pRayEnd[i] - pRayStart[i];
+		if (fDelta == 0.0f) {
+			if ((pRayStart[i] < pBoxMin[i]) || (pRayStart[i] > pBoxMax[i])) {
+				return FALSE;
+			}
+		} else {
+			float fInverse = 1.0f / fDelta;
+			float fT1 = (pBoxMin[i] - pRayStart[i]) * fInverse;
+			float fT2 = (pBoxMax[i] - pRayStart[i]) * fInverse;
+			if (fT1 > fT2) {
+				float fTemp = fT1;
+				fT1 = fT2;
+				fT2 = fTemp;
+			}
+			fMin = Max(fMin, fT1);
+			fMax = Min(fMax, fT2);
+			if (fMin > fMax) {
+				return FALSE;
+			}
+		}
+	} while (++i < 2);
+	pEnter[0] = fMin;
+	return TRUE;
+}
+
+//
+// g_ItemMarks has a 1 for every item the brute force test found.
+// Make sure the tree returned each of them exactly once and nothing else.
+//
+
+static Word CheckResults(const BoundingBoxTree *pTree,
+	const SimpleArray<Word> *pResults, const char *pName)
+{
+	Word uFailure = FALSE;
+	WordPtr i = 0;
+	WordPtr uCount = pResults->size();
+	while (i < uCount) {
+		Word uValue = pTree->GetValue((*pResults)[i]);
+		if ((uValue >= g_uItemCount) || (g_ItemMarks[uValue] != 1)) {
+			uFailure = TRUE;
+		} else {
+			g_ItemMarks[uValue] = 2;
+		}
+		++i;
+	}
+	i = 0;
+	do {
+		if (g_ItemMarks[i] == 1) {
+			uFailure = TRUE;
+		}
+		g_ItemMarks[i] = 0;
+	} while (++i < g_uItemCount);
+	ReportFailure("BoundingBoxTree::%s() doesn't match the brute force test",
+		uFailure, pName);
+	return uFailure;
+}
+
+//
+// Check the links, heights and bounds of every node,
+// return the number of leaves
+//
+
+static Word ValidateNode(
+	const BoundingBoxTree *pTree, Word uNode, int *pHeight, Word *pFailure)
+{
+	const BoundingBoxTree::Node_t *pNode = pTree->GetNode(uNode);
+	if (pNode->IsLeaf()) {
+		pHeight[0] = 0;
+		if (!ContainsBox(&pNode->m_Bounds, &pNode->m_ItemBounds)) {
+			pFailure[0] = TRUE;
+		}
+		return 1;
+	}
+	int iHeight1;
+	int iHeight2;
+	Word uLeaves =
+		ValidateNode(pTree, pNode->m_uChild1, &iHeight1, pFailure) +
+		ValidateNode(pTree, pNode->m_uChild2, &iHeight2, pFailure);
+	int iHeight = 1 + Max(iHeight1, iHeight2);
+	pHeight[0] = iHeight;
+	const BoundingBoxTree::Node_t *pChild1 = pTree->GetNode(pNode->m_uChild1);
+	const BoundingBoxTree::Node_t *pChild2 = pTree->GetNode(pNode->m_uChild2);
+	if ((pChild1->m_uParent != uNode) || (pChild2->m_uParent != uNode) ||
+		(pNode->m_iHeight != iHeight) ||
+		!ContainsBox(&pNode->m_Bounds, &pChild1->m_Bounds) ||
+		!ContainsBox(&pNode->m_Bounds, &pChild2->m_Bounds)) {
+		pFailure[0] = TRUE;
+	}
+	return uLeaves;
+}
+
+static Word ValidateTree(const BoundingBoxTree *pTree, const char *pName)
+{
+	Word uFailure = FALSE;
+	Word uLive = 0;
+	Word i = 0;
+	do {
+		uLive += g_ItemLive[i];
+	} while (++i < g_uItemCount);
+	Word uLeaves = 0;
+	if (pTree->GetRoot() != BoundingBoxTree::cNullNode) {
+		int iHeight;
+		uLeaves = ValidateNode(pTree, pTree->GetRoot(), &iHeight, &uFailure);
+		if (pTree->GetNode(pTree->GetRoot())->m_uParent !=
+			BoundingBoxTree::cNullNode) {
+			uFailure = TRUE;
+		}
+	}
+	uFailure |= (uLeaves != uLive);
+	ReportFailure("BoundingBoxTree is damaged after %s()", uFailure, pName);
+	return uFailure;
+}
+
+//
+// Test every query against the live items
+//
+
+static Word TestQueries(const BoundingBoxTree *pTree, Random *pRandom)
+{
+	Word uFailure = FALSE;
+	SimpleArray<Word> Results;
+	Word uQuery = 0;
+	do {
+		Vector4D_t Box;
+		MakeBox(&Box, pRandom, 1);
+		Box.z += 50.0f;
+		Box.w += 50.0f;
+
+		// Box query
+		Word i = 0;
+		do {
+			g_ItemMarks[i] = static_cast<Word8>(
+				g_ItemLive[i] && OverlapsBox(&g_ItemBounds[i], &Box));
+		} while (++i < g_uItemCount);
+		uFailure |= pTree->QueryBox(&Results, &Box) != kErrorNone;
+		uFailure |= CheckResults(pTree, &Results, "QueryBox");
+
+		// Point query
+		Vector2D_t Point;
+		Point.x = Box.x;
+		Point.y = Box.y;
+		i = 0;
+		do {
+			g_ItemMarks[i] = static_cast<Word8>(
+				g_ItemLive[i] && ContainsPoint(&g_ItemBounds[i], &Point));
+		} while (++i < g_uItemCount);
+		uFailure |= pTree->QueryPoint(&Results, &Point) != kErrorNone;
+		uFailure |= CheckResults(pTree, &Results, "QueryPoint");
+
+		// The box as four planes plus a triangle around its center,
+		// so some subtrees are completely inside and some are clipped
+		Vector3D_t Planes[7];
+		Planes[0].Set(1.0f, 0.0f, -Box.x);
+		Planes[1].Set(-1.0f, 0.0f, Box.z);
+		Planes[2].Set(0.0f, 1.0f, -Box.y);
+		Planes[3].Set(0.0f, -1.0f, Box.w);
+		float fCenterX = (Box.x + Box.z) * 0.5f;
+		float fCenterY = (Box.y + Box.w) * 0.5f;
+		float fRadius = pRandom->GetFloat(40.0f);
+		Planes[4].Set(1.0f, 0.0f, fRadius - fCenterX);
+		Planes[5].Set(-0.5f, 0.8660254f,
+			fRadius + (0.5f * fCenterX) - (0.8660254f * fCenterY));
+		Planes[6].Set(-0.5f, -0.8660254f,
+			fRadius + (0.5f * fCenterX) + (0.8660254f * fCenterY));
+		Word uPlaneCount = (uQuery & 1) ? 7U : 4U;
+		i = 0;
+		do {
+			g_ItemMarks[i] = static_cast<Word8>(g_ItemLive[i] &&
+				TouchesFrustum(&g_ItemBounds[i], Planes, uPlaneCount));
+		} while (++i < g_uItemCount);
+		uFailure |= pTree->QueryFrustum(&Results, Planes, uPlaneCount) !=
+			kErrorNone;
+		uFailure |= CheckResults(pTree, &Results, "QueryFrustum");
+
+		// Rays, the closest hit and all hits
+		Vector2D_t Start;
+		Vector2D_t End;
+		Start.x = pRandom->GetFloat(1000.0f);
+		Start.y = pRandom->GetFloat(1000.0f);
+		End.x = pRandom->GetFloat(1000.0f);
+		End.y = pRandom->GetFloat(1000.0f);
+		// Every fourth ray is axis aligned
+		if (!(uQuery & 3)) {
+			End.y = Start.y;
+		}
+		float fBest = 2.0f;
+		i = 0;
+		do {
+			float fEnter;
+			Word uHit = g_ItemLive[i] &&
+				RayHitsBox(&fEnter, &g_ItemBounds[i], &Start, &End);
+			g_ItemMarks[i] = static_cast<Word8>(uHit);
+			if (uHit && (fEnter < fBest)) {
+				fBest = fEnter;
+			}
+		} while (++i < g_uItemCount);
+		Word uProxy;
+		float fFraction;
+		Word uTest =
+			pTree->RayCast(&uProxy, &fFraction, &Start, &End) != kErrorNone;
+		if (fBest > 1.0f) {
+			uTest |= (uProxy != BoundingBoxTree::cNullNode);
+		} else if (uProxy == BoundingBoxTree::cNullNode) {
+			uTest = TRUE;
+		} else {
+			// Ties can return any of the closest items
+			Word uValue = pTree->GetValue(uProxy);
+			float fEnter = 2.0f;
+			uTest |= (uValue >= g_uItemCount) || !g_ItemMarks[uValue] ||
+				!RayHitsBox(&fEnter, &g_ItemBounds[uValue], &Start, &End) ||
+				(Abs(fEnter - fBest) > 0.00001f) ||
+				(Abs(fFraction - fBest) > 0.00001f);
+		}
+		ReportFailure(
+			"BoundingBoxTree::RayCast() didn't find the closest item %g",
+			uTest, fBest);
+		uFailure |= uTest;
+		uFailure |= pTree->RayCastAll(&Results, &Start, &End) != kErrorNone;
+		uFailure |= CheckResults(pTree, &Results, "RayCastAll");
+	} while (++uQuery < g_uQueryCount);
+
+	// No planes accepts everything
+	Word i = 0;
+	do {
+		g_ItemMarks[i] = g_ItemLive[i];
+	} while (++i < g_uItemCount);
+	uFailure |= pTree->QueryFrustum(&Results, NULL, 0) != kErrorNone;
+	uFailure |= CheckResults(pTree, &Results, "QueryFrustum");
+
+	// Every overlapping pair, once
+	SimpleArray<BoundingBoxTree::Pair_t> Pairs;
+	Word uTest = pTree->QueryPairs(&Pairs) != kErrorNone;
+	WordPtr uExpected = 0;
+	i = 0;
+	do {
+		if (g_ItemLive[i]) {
+			Word j = i + 1;
+			while (j < g_uItemCount) {
+				if (g_ItemLive[j] &&
+					OverlapsBox(&g_ItemBounds[i], &g_ItemBounds[j])) {
+					++uExpected;
+				}
+				++j;
+			}
+		}
+	} while (++i < g_uItemCount);
+	uTest |= (Pairs.size() != uExpected);
+	WordPtr uPair = 0;
+	while (uPair < Pairs.size()) {
+		const BoundingBoxTree::Pair_t *pPair = &Pairs[uPair];
+		uTest |= (pPair->m_uProxy1 >= pPair->m_uProxy2) ||
+			!OverlapsBox(pTree->GetBounds(pPair->m_uProxy1),
+				pTree->GetBounds(pPair->m_uProxy2));
+		++uPair;
+	}
+	ReportFailure("BoundingBoxTree::QueryPairs() found %u pairs, expected %u",
+		uTest, static_cast<Word>(Pairs.size()), static_cast<Word>(uExpected));
+	uFailure |= uTest;
+	return uFailure;
+}
+
+//
+// Fill a tree with Insert() or Build(), then change it with
+// Remove(), Move() and Refit() and check it after each step
+//
+
+static Word TestTree(Word bBuild)
+{
+	Random MyRandom(bBuild ? 0x1234U : 0x5678U);
+	Word uFailure = FALSE;
+	BoundingBoxTree Tree(0.5f);
+	const char *pName = bBuild ? "Build" : "Insert";
+
+	Word i = 0;
+	do {
+		MakeBox(&g_ItemBounds[i], &MyRandom, i);
+		g_ItemValues[i] = i;
+		g_ItemLive[i] = TRUE;
+		g_ItemMarks[i] = 0;
+	} while (++i < g_uItemCount);
+	if (bBuild) {
+		Word uTest = Tree.Build(g_ItemBounds, g_ItemValues, g_uItemCount,
+						 g_ItemProxies) != kErrorNone;
+		ReportFailure("BoundingBoxTree::Build() failed", uTest);
+		uFailure |= uTest;
+	} else {
+		i = 0;
+		do {
+			g_ItemProxies[i] = Tree.Insert(&g_ItemBounds[i], i);
+		} while (++i < g_uItemCount);
+	}
+	uFailure |= ValidateTree(&Tree, pName);
+	uFailure |= TestQueries(&Tree, &MyRandom);
+
+	// Remove every third item
+	i = 0;
+	do {
+		Tree.Remove(g_ItemProxies[i]);
+		g_ItemLive[i] = FALSE;
+		i += 3;
+	} while (i < g_uItemCount);
+	uFailure |= ValidateTree(&Tree, "Remove");
+
+	// Move some items a little with Move() and Refit()
+	i = 1;
+	do {
+		if (g_ItemLive[i]) {
+			Vector4D_t *pBounds = &g_ItemBounds[i];
+			float fX = MyRandom.GetSymmetricFloat(10.0f);
+			float fY = MyRandom.GetSymmetricFloat(10.0f);
+			pBounds->x += fX;
+			pBounds->y += fY;
+			pBounds->z += fX + MyRandom.GetFloat(2.0f);
+			pBounds->w += fY;
+			if (i & 1) {
+				Tree.Move(g_ItemProxies[i], pBounds);
+			} else {
+				Tree.Refit(g_ItemProxies[i], pBounds);
+			}
+		}
+		i += 5;
+	} while (i < g_uItemCount);
+	uFailure |= ValidateTree(&Tree, "Move");
+
+	// Insert new items into the holes
+	i = 0;
+	do {
+		MakeBox(&g_ItemBounds[i], &MyRandom, i + 1);
+		g_ItemProxies[i] = Tree.Insert(&g_ItemBounds[i], i);
+		g_ItemLive[i] = TRUE;
+		i += 6;
+	} while (i < g_uItemCount);
+	uFailure |= ValidateTree(&Tree, "Insert");
+	uFailure |= TestQueries(&Tree, &MyRandom);
+
+	// An empty tree finds nothing
+	Tree.Clear();
+	i = 0;
+	do {
+		g_ItemLive[i] = FALSE;
+	} while (++i < g_uItemCount);
+	uFailure |= ValidateTree(&Tree, "Clear");
+	uFailure |= TestQueries(&Tree, &MyRandom);
+	return uFailure;
+}
+
+//
+// Perform all the tests for the bounding box tree
+//
+
+int BURGER_API TestBrboundingboxtree(Word uVerbose)
+{
+	if (uVerbose & VERBOSE_MSG) {
+		Message("Running Bounding Box Tree tests");
+	}
+
+	Word uTotal = TestTree(FALSE);
+	uTotal |= TestTree(TRUE);
+
+	if (!uTotal && (uVerbose & VERBOSE_MSG)) {
+		Message("Passed all Bounding Box Tree tests!");
+	}
+	return static_cast<int>(uTotal);
+}
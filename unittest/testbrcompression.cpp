@@ -13,16 +13,38 @@
 ***************************************/
 
 #include "testbrcompression.h"
+#include "brbc4.h"
+#include "brbc5.h"
+#include "brbc7.h"
 #include "brcompressdeflate.h"
 #include "brcompresslbmrle.h"
+#include "brcompresslz4.h"
 #include "brcompresslzss.h"
+#include "brcpudispatch.h"
 #include "brdecompressdeflate.h"
 #include "brdecompresslbmrle.h"
+#include "brdecompresslz4.h"
 #include "brdecompresslzss.h"
+#include "brdecompressstream.h"
+#include "brdxt1.h"
+#include "brdxt3.h"
+#include "brdxt5.h"
+#include "brendian.h"
+#include "brfile.h"
+#include "brfiledds.h"
+#include "brfilemanager.h"
 #include "brfixedpoint.h"
+#include "brimage.h"
+#include "brinputmemorystream.h"
+#include "brmemoryhandle.h"
 #include "brmemoryansi.h"
 #include "brnumberstringhex.h"
+#include "brnumberto.h"
+#include "brpackfloat.h"
+#include "broutputmemorystream.h"
+#include "brrezfile.h"
 #include "brstringfunctions.h"
+#include "brtick.h"
 #include "common.h"
 
 using namespace Burger;
@@ -991,6 +1013,2314 @@ static Word TestDeflateCompress(void)
 	return uFailure;
 }
 
+//
+// Corpus for the Deflate level tests. It's a mix of text, structured
+// binary records and low entropy noise so the matchers at every
+// level have something to find.
+//
+
+static const char* g_DeflateWords[] = {"the", "quick", "brown", "fox",
+	"jumps", "over", "lazy", "dog", "Burgerlib", "compression", "level",
+	"window", "match", "literal", "texture", "sound", "save", "game", "pack",
+	"rez", "file", "data", "\n", ", ", ". "};
+
+static Word8 g_DeflateCorpus[0x40000];
+static Word8 g_DeflateCompressed[0x48000];
+static Word8 g_DeflateDecompressed[0x40000 + 80];
+
+static void BuildDeflateCorpus(Word8* pOutput, WordPtr uLength)
+{
+	Word32 uSeed = 0x31415926U;
+	WordPtr uThird = uLength / 3;
+
+	// Text made from a small vocabulary
+	WordPtr i = 0;
+	while (i < uThird) {
+		uSeed = (uSeed * 1103515245U) + 12345U;
+		const char* pWord = g_DeflateWords[(uSeed >> 16U) %
+			BURGER_ARRAYSIZE(g_DeflateWords)];
+		while (pWord[0] && (i < uThird)) {
+			pOutput[i++] = static_cast<Word8>(pWord[0]);
+			++pWord;
+		}
+		if (i < uThird) {
+			pOutput[i++] = ' ';
+		}
+	}
+
+	// 16 byte records with an index, a slowly changing value and a tag
+	Word32 uIndex = 0;
+	while ((i + 16) <= (uThird * 2)) {
+		uSeed = (uSeed * 1103515245U) + 12345U;
+		LittleEndian::StoreAny(reinterpret_cast<Word32*>(pOutput + i), uIndex);
+		LittleEndian::StoreAny(
+			reinterpret_cast<Word32*>(pOutput + i + 4), uIndex * 3);
+		LittleEndian::StoreAny(
+			reinterpret_cast<Word32*>(pOutput + i + 8), (uSeed >> 24U) & 7U);
+		LittleEndian::StoreAny(
+			reinterpret_cast<Word32*>(pOutput + i + 12), 0x52454344U);
+		++uIndex;
+		i += 16;
+	}
+
+	// Noise from a 16 symbol alphabet
+	while (i < uLength) {
+		uSeed = (uSeed * 1103515245U) + 12345U;
+		pOutput[i++] = static_cast<Word8>('A' + ((uSeed >> 16U) & 15U));
+	}
+}
+
+//
+// Compress the corpus with a level and return the compressed size
+//
+
+static WordPtr DeflateCorpus(
+	Compress* pTester, const Word8* pInput, WordPtr uLength)
+{
+	pTester->Init();
+	// Split the input at an odd place to exercise the streaming
+	WordPtr uSplit = (uLength / 3) + 7;
+	pTester->Process(pInput, uSplit);
+	pTester->Process(pInput + uSplit, uLength - uSplit);
+	pTester->Finalize();
+	WordPtr uCompressedSize = pTester->GetOutputSize();
+	if ((uCompressedSize > sizeof(g_DeflateCompressed)) ||
+		pTester->GetOutput()->Flatten(
+			g_DeflateCompressed, uCompressedSize)) {
+		uCompressedSize = 0;
+	}
+	return uCompressedSize;
+}
+
+//
+// Compress with every level and verify DecompressDeflate restores
+// the data
+//
+
+static Word TestDeflateLevels(void)
+{
+	Word uFailure = FALSE;
+	CompressDeflate* pTester = New<CompressDeflate>();
+	DecompressDeflate* pDecompress = New<DecompressDeflate>();
+	BuildDeflateCorpus(g_DeflateCorpus, sizeof(g_DeflateCorpus));
+	MemoryFill(g_DeflateDecompressed, 0xD5, sizeof(g_DeflateDecompressed));
+
+	WordPtr uFastestSize = 0;
+	Word uLevel = CompressDeflate::Z_NO_COMPRESSION;
+	do {
+		pTester->SetLevel(uLevel);
+		WordPtr uCompressedSize =
+			DeflateCorpus(pTester, g_DeflateCorpus, sizeof(g_DeflateCorpus));
+		if (!uCompressedSize) {
+			ReportFailure(
+				"CompressDeflate::Finalize() level %u output too large",
+				TRUE, uLevel);
+			uFailure = TRUE;
+			continue;
+		}
+		// The zlib header must be valid
+		Word uHeader = (static_cast<Word>(g_DeflateCompressed[0]) << 8U) +
+			g_DeflateCompressed[1];
+		if ((uHeader % 31) || ((uHeader & 0x0F00) != 0x0800)) {
+			ReportFailure("CompressDeflate level %u header = 0x%04X", TRUE,
+				uLevel, uHeader);
+			uFailure = TRUE;
+		}
+		if (uLevel == CompressDeflate::Z_BEST_SPEED) {
+			uFastestSize = uCompressedSize;
+		}
+		if ((uLevel == CompressDeflate::Z_BEST_COMPRESSION) &&
+			(uCompressedSize > uFastestSize)) {
+			ReportFailure(
+				"CompressDeflate level 9 size %u is larger than level 1 size %u",
+				TRUE, static_cast<Word>(uCompressedSize),
+				static_cast<Word>(uFastestSize));
+			uFailure = TRUE;
+		}
+
+		pDecompress->Reset();
+		Decompress::eError Error = pDecompress->Process(g_DeflateDecompressed,
+			sizeof(g_DeflateCorpus), g_DeflateCompressed, uCompressedSize);
+		if ((Error != Decompress::DECOMPRESS_OKAY) ||
+			(pDecompress->GetProcessedOutputSize() !=
+				sizeof(g_DeflateCorpus))) {
+			ReportFailure(
+				"DecompressDeflate::Process() of level %u = %d, expected Decompress::DECOMPRESS_OKAY",
+				TRUE, uLevel, Error);
+			uFailure = TRUE;
+		}
+		uFailure |= ReportDecompress(g_DeflateDecompressed, g_DeflateCorpus,
+			sizeof(g_DeflateCorpus), "CompressDeflate level round trip");
+	} while (++uLevel <= CompressDeflate::Z_BEST_COMPRESSION);
+	Delete(pDecompress);
+	Delete(pTester);
+	return uFailure;
+}
+
+//
+// Compress with several threads and verify that the stitched stream
+// is the same for any thread count and decompresses properly
+//
+
+static Word TestDeflateParallel(void)
+{
+	static const Word s_Levels[] = {CompressDeflate::Z_NO_COMPRESSION,
+		CompressDeflate::Z_BEST_SPEED, CompressDeflate::Z_DEFAULT_COMPRESSION,
+		CompressDeflate::Z_BEST_COMPRESSION};
+	static const WordPtr s_BlockSizes[] = {
+		0x8000, 0x9001, CompressDeflate::c_uParallelBlockSize};
+	static const Word s_Threads[] = {1, 3, 8};
+
+	Word uFailure = FALSE;
+	CompressDeflate* pTester = New<CompressDeflate>();
+	CompressDeflate* pSingle = New<CompressDeflate>();
+	DecompressDeflate* pDecompress = New<DecompressDeflate>();
+	BuildDeflateCorpus(g_DeflateCorpus, sizeof(g_DeflateCorpus));
+	MemoryFill(g_DeflateDecompressed, 0xD5, sizeof(g_DeflateDecompressed));
+
+	WordPtr i = 0;
+	do {
+		pTester->SetLevel(s_Levels[i]);
+		pSingle->SetLevel(s_Levels[i]);
+		WordPtr j = 0;
+		do {
+			pSingle->CompressParallel(
+				g_DeflateCorpus, sizeof(g_DeflateCorpus), 1, s_BlockSizes[j]);
+			WordPtr k = 0;
+			do {
+				Compress::eError Error = pTester->CompressParallel(g_DeflateCorpus,
+					sizeof(g_DeflateCorpus), s_Threads[k], s_BlockSizes[j]);
+				WordPtr uCompressedSize = pTester->GetOutputSize();
+				if ((Error != Compress::COMPRESS_OKAY) ||
+					(uCompressedSize > sizeof(g_DeflateCompressed)) ||
+					pTester->GetOutput()->Flatten(
+						g_DeflateCompressed, uCompressedSize)) {
+					ReportFailure(
+						"CompressDeflate::CompressParallel(level %u, threads %u) = %d",
+						TRUE, s_Levels[i], s_Threads[k], Error);
+					uFailure = TRUE;
+					continue;
+				}
+				if ((uCompressedSize != pSingle->GetOutputSize()) ||
+					pSingle->GetOutput()->Compare(
+						g_DeflateCompressed, uCompressedSize)) {
+					ReportFailure(
+						"CompressDeflate::CompressParallel(level %u, threads %u) output depends on the thread count",
+						TRUE, s_Levels[i], s_Threads[k]);
+					uFailure = TRUE;
+				}
+				pDecompress->Reset();
+				Decompress::eError DError = pDecompress->Process(
+					g_DeflateDecompressed, sizeof(g_DeflateCorpus),
+					g_DeflateCompressed, uCompressedSize);
+				if ((DError != Decompress::DECOMPRESS_OKAY) ||
+					(pDecompress->GetProcessedOutputSize() !=
+						sizeof(g_DeflateCorpus))) {
+					ReportFailure(
+						"DecompressDeflate::Process() of CompressParallel(level %u, threads %u) = %d",
+						TRUE, s_Levels[i], s_Threads[k], DError);
+					uFailure = TRUE;
+				}
+				uFailure |= ReportDecompress(g_DeflateDecompressed,
+					g_DeflateCorpus, sizeof(g_DeflateCorpus),
+					"CompressDeflate::CompressParallel round trip");
+			} while (++k < BURGER_ARRAYSIZE(s_Threads));
+		} while (++j < BURGER_ARRAYSIZE(s_BlockSizes));
+	} while (++i < BURGER_ARRAYSIZE(s_Levels));
+
+	// Empty input still creates a valid stream
+	pTester->CompressParallel(g_DeflateCorpus, 0, 4);
+	pSingle->Init();
+	pSingle->Finalize();
+	if ((pTester->GetOutputSize() != pSingle->GetOutputSize()) ||
+		(pTester->GetOutputSize() > sizeof(g_DeflateCompressed)) ||
+		pTester->GetOutput()->Flatten(
+			g_DeflateCompressed, pTester->GetOutputSize()) ||
+		pSingle->GetOutput()->Compare(
+			g_DeflateCompressed, pTester->GetOutputSize())) {
+		ReportFailure("CompressDeflate::CompressParallel(0 bytes) mismatch", TRUE);
+		uFailure = TRUE;
+	}
+	Delete(pDecompress);
+	Delete(pSingle);
+	Delete(pTester);
+	return uFailure;
+}
+
+//
+// Decompress a stream with odd sized input and output chunks so the
+// decoder hands off between the fast loop and the byte at a time
+// decoder in every possible state
+//
+
+static Word TestDeflateChunks(void)
+{
+	static const WordPtr s_InputChunks[] = {1, 9, 17, 4093};
+	static const WordPtr s_OutputChunks[] = {7, 300, 0x8001};
+	Word uFailure = FALSE;
+	CompressDeflate* pTester = New<CompressDeflate>();
+	DecompressDeflate* pDecompress = New<DecompressDeflate>();
+	BuildDeflateCorpus(g_DeflateCorpus, sizeof(g_DeflateCorpus));
+
+	// Fixed and dynamic trees
+	static const Word s_Levels[] = {
+		CompressDeflate::Z_BEST_SPEED, CompressDeflate::Z_BEST_COMPRESSION};
+	WordPtr i = 0;
+	do {
+		pTester->SetLevel(s_Levels[i]);
+		// Only the first 32K, so it's quick with one byte chunks
+		WordPtr uCompressedSize = DeflateCorpus(pTester, g_DeflateCorpus, 0x8000);
+		WordPtr j = 0;
+		do {
+			WordPtr k = 0;
+			do {
+				MemoryFill(g_DeflateDecompressed, 0xD5, 0x8000 + 80);
+				pDecompress->Reset();
+				WordPtr uInputIndex = 0;
+				WordPtr uOutputIndex = 0;
+				Decompress::eError Error;
+				do {
+					WordPtr uInputChunk = uCompressedSize - uInputIndex;
+					if (uInputChunk > s_InputChunks[j]) {
+						uInputChunk = s_InputChunks[j];
+					}
+					WordPtr uOutputChunk = 0x8000 - uOutputIndex;
+					if (uOutputChunk > s_OutputChunks[k]) {
+						uOutputChunk = s_OutputChunks[k];
+					}
+					Error = pDecompress->Process(
+						g_DeflateDecompressed + uOutputIndex, uOutputChunk,
+						g_DeflateCompressed + uInputIndex, uInputChunk);
+					uInputIndex += pDecompress->GetProcessedInputSize();
+					uOutputIndex += pDecompress->GetProcessedOutputSize();
+				} while ((Error == Decompress::DECOMPRESS_OUTPUTUNDERRUN) ||
+					(Error == Decompress::DECOMPRESS_OUTPUTOVERRUN));
+				if ((Error != Decompress::DECOMPRESS_OKAY) ||
+					(uOutputIndex != 0x8000)) {
+					ReportFailure(
+						"DecompressDeflate::Process(level %u, input chunks %u, output chunks %u) = %d",
+						TRUE, s_Levels[i], static_cast<Word>(s_InputChunks[j]),
+						static_cast<Word>(s_OutputChunks[k]), Error);
+					uFailure = TRUE;
+				}
+				uFailure |= ReportDecompress(g_DeflateDecompressed,
+					g_DeflateCorpus, 0x8000, "DecompressDeflate chunked");
+			} while (++k < BURGER_ARRAYSIZE(s_OutputChunks));
+		} while (++j < BURGER_ARRAYSIZE(s_InputChunks));
+	} while (++i < BURGER_ARRAYSIZE(s_Levels));
+	Delete(pDecompress);
+	Delete(pTester);
+	return uFailure;
+}
+
+//
+// Test the one shot decompressor against the corpus and broken
+// streams
+//
+
+static Word TestSimpleDecompressDeflate(void)
+{
+	Word uFailure = FALSE;
+	Word8 Buffer[sizeof(RawData) + 80];
+
+	// The small sample
+	MemoryFill(Buffer, 0xD5, sizeof(Buffer));
+	Decompress::eError Error = SimpleDecompressDeflate(
+		Buffer, sizeof(RawData), DeflateCompressed, sizeof(DeflateCompressed));
+	if (Error != Decompress::DECOMPRESS_OKAY) {
+		ReportFailure(
+			"SimpleDecompressDeflate(Buffer,sizeof(RawData),DeflateCompressed,sizeof(DeflateCompressed)) = %d, expected Decompress::DECOMPRESS_OKAY",
+			TRUE, Error);
+		uFailure = TRUE;
+	}
+	uFailure |= ReportDecompress(
+		Buffer, RawData, sizeof(RawData), "SimpleDecompressDeflate(RawData)");
+
+	CompressDeflate* pTester = New<CompressDeflate>();
+	BuildDeflateCorpus(g_DeflateCorpus, sizeof(g_DeflateCorpus));
+	static const Word s_Levels[] = {CompressDeflate::Z_NO_COMPRESSION,
+		CompressDeflate::Z_BEST_SPEED, CompressDeflate::Z_DEFAULT_COMPRESSION,
+		CompressDeflate::Z_BEST_COMPRESSION};
+	WordPtr i = 0;
+	do {
+		pTester->SetLevel(s_Levels[i]);
+		WordPtr uCompressedSize =
+			DeflateCorpus(pTester, g_DeflateCorpus, sizeof(g_DeflateCorpus));
+		MemoryFill(g_DeflateDecompressed, 0xD5, sizeof(g_DeflateDecompressed));
+		Error = SimpleDecompressDeflate(g_DeflateDecompressed,
+			sizeof(g_DeflateCorpus), g_DeflateCompressed, uCompressedSize);
+		if (Error != Decompress::DECOMPRESS_OKAY) {
+			ReportFailure(
+				"SimpleDecompressDeflate() of level %u = %d, expected Decompress::DECOMPRESS_OKAY",
+				TRUE, s_Levels[i], Error);
+			uFailure = TRUE;
+		}
+		uFailure |= ReportDecompress(g_DeflateDecompressed, g_DeflateCorpus,
+			sizeof(g_DeflateCorpus), "SimpleDecompressDeflate round trip");
+
+		// Truncated input
+		Error = SimpleDecompressDeflate(g_DeflateDecompressed,
+			sizeof(g_DeflateCorpus), g_DeflateCompressed, uCompressedSize - 5);
+		if (Error != Decompress::DECOMPRESS_OUTPUTUNDERRUN) {
+			ReportFailure(
+				"SimpleDecompressDeflate() of truncated level %u = %d, expected Decompress::DECOMPRESS_OUTPUTUNDERRUN",
+				TRUE, s_Levels[i], Error);
+			uFailure = TRUE;
+		}
+		// Output buffer too small
+		Error = SimpleDecompressDeflate(g_DeflateDecompressed,
+			sizeof(g_DeflateCorpus) - 1, g_DeflateCompressed, uCompressedSize);
+		if (Error != Decompress::DECOMPRESS_OUTPUTOVERRUN) {
+			ReportFailure(
+				"SimpleDecompressDeflate() of short output level %u = %d, expected Decompress::DECOMPRESS_OUTPUTOVERRUN",
+				TRUE, s_Levels[i], Error);
+			uFailure = TRUE;
+		}
+		// Output buffer too large
+		Error = SimpleDecompressDeflate(g_DeflateDecompressed,
+			sizeof(g_DeflateCorpus) + 1, g_DeflateCompressed, uCompressedSize);
+		if (Error != Decompress::DECOMPRESS_OUTPUTUNDERRUN) {
+			ReportFailure(
+				"SimpleDecompressDeflate() of long output level %u = %d, expected Decompress::DECOMPRESS_OUTPUTUNDERRUN",
+				TRUE, s_Levels[i], Error);
+			uFailure = TRUE;
+		}
+		// Bad checksum
+		g_DeflateCompressed[uCompressedSize - 1] ^= 0x55U;
+		Error = SimpleDecompressDeflate(g_DeflateDecompressed,
+			sizeof(g_DeflateCorpus), g_DeflateCompressed, uCompressedSize);
+		if (Error != Decompress::DECOMPRESS_BADINPUT) {
+			ReportFailure(
+				"SimpleDecompressDeflate() of bad checksum level %u = %d, expected Decompress::DECOMPRESS_BADINPUT",
+				TRUE, s_Levels[i], Error);
+			uFailure = TRUE;
+		}
+	} while (++i < BURGER_ARRAYSIZE(s_Levels));
+	Delete(pTester);
+	return uFailure;
+}
+
+//
+// Small JSON like records that share most of their text, the kind
+// of data preset dictionaries are for
+//
+
+static const char* g_DictionaryWords[] = {"sword", "shield", "potion",
+	"torch", "goblin", "dragon", "knight", "archer", "forest", "castle",
+	"spawn", "death", "open", "close", "gold", "silver"};
+
+static const WordPtr g_uDictionarySampleCount = 48;
+static const WordPtr g_uDictionarySampleSize = 400;
+static char g_DictionarySamples[g_uDictionarySampleCount]
+							   [g_uDictionarySampleSize];
+static WordPtr g_DictionaryLengths[g_uDictionarySampleCount];
+static Word8 g_DeflateDictionary[0x1000];
+
+static WordPtr AppendSample(char* pOutput, const char* pInput)
+{
+	WordPtr uLength = StringLength(pInput);
+	MemoryCopy(pOutput, pInput, uLength);
+	return uLength;
+}
+
+static void BuildDictionarySamples(void)
+{
+	Word32 uSeed = 0x27182818U;
+	WordPtr i = 0;
+	do {
+		char* pOutput = g_DictionarySamples[i];
+		WordPtr uLength = 0;
+		static const char* s_Fields[] = {"{\"id\":", ",\"name\":\"",
+			"\",\"class\":\"", "\",\"health\":", ",\"mana\":",
+			",\"position\":{\"x\":", ",\"y\":", ",\"z\":",
+			"},\"inventory\":[\"", "\",\"",
+			"\"],\"flags\":{\"visible\":true,\"solid\":false,\"persistent\":true},\"script\":\"on_",
+			"_", "\"}\n"};
+		WordPtr j = 0;
+		do {
+			uLength += AppendSample(pOutput + uLength, s_Fields[j]);
+			uSeed = (uSeed * 1103515245U) + 12345U;
+			// Numbers after the ':' fields, words in the strings
+			if (pOutput[uLength - 1] == '"' || pOutput[uLength - 1] == '_') {
+				uLength += AppendSample(pOutput + uLength,
+					g_DictionaryWords[(uSeed >> 16U) %
+						BURGER_ARRAYSIZE(g_DictionaryWords)]);
+			} else if (j + 1 < BURGER_ARRAYSIZE(s_Fields)) {
+				NumberToAscii(pOutput + uLength,
+					static_cast<Word32>((uSeed >> 16U) % 10000U));
+				uLength += StringLength(pOutput + uLength);
+			}
+		} while (++j < BURGER_ARRAYSIZE(s_Fields));
+		g_DictionaryLengths[i] = uLength;
+	} while (++i < g_uDictionarySampleCount);
+}
+
+//
+// Compress a sample, return the compressed size
+//
+
+static WordPtr DeflateSample(
+	CompressDeflate* pTester, const void* pInput, WordPtr uLength)
+{
+	pTester->Init();
+	pTester->Process(pInput, uLength);
+	pTester->Finalize();
+	WordPtr uCompressedSize = pTester->GetOutputSize();
+	if ((uCompressedSize > sizeof(g_DeflateCompressed)) ||
+		pTester->GetOutput()->Flatten(g_DeflateCompressed, uCompressedSize)) {
+		uCompressedSize = 0;
+	}
+	return uCompressedSize;
+}
+
+//
+// Train a dictionary, verify it helps and that the decompressor finds it
+//
+
+static Word TestDeflateDictionary(void)
+{
+	Word uFailure = FALSE;
+	CompressDeflate* pTester = New<CompressDeflate>();
+	DecompressDeflate* pDecompress = New<DecompressDeflate>();
+	BuildDictionarySamples();
+
+	const void* pSamples[g_uDictionarySampleCount];
+	WordPtr i = 0;
+	do {
+		pSamples[i] = g_DictionarySamples[i];
+	} while (++i < g_uDictionarySampleCount);
+	WordPtr uDictionarySize =
+		CompressDeflate::TrainDictionary(g_DeflateDictionary,
+			sizeof(g_DeflateDictionary), pSamples, g_DictionaryLengths,
+			g_uDictionarySampleCount);
+	if (!uDictionarySize || (uDictionarySize > sizeof(g_DeflateDictionary))) {
+		ReportFailure("CompressDeflate::TrainDictionary() = %u", TRUE,
+			static_cast<Word>(uDictionarySize));
+		uFailure = TRUE;
+		uDictionarySize = 64;
+	}
+	// Not enough data for a single segment
+	if (CompressDeflate::TrainDictionary(g_DeflateCorpus, 0x1000, pSamples,
+			g_DictionaryLengths, 0)) {
+		ReportFailure("CompressDeflate::TrainDictionary() with no samples",
+			TRUE);
+		uFailure = TRUE;
+	}
+
+	// A second dictionary that doesn't match
+	Word8 Wrong[256];
+	MemoryFill(Wrong, 'x', sizeof(Wrong));
+	pDecompress->AddDictionary(Wrong, sizeof(Wrong));
+	pDecompress->AddDictionary(g_DeflateDictionary, uDictionarySize);
+
+	WordPtr uPlainTotal = 0;
+	WordPtr uDictionaryTotal = 0;
+	i = 0;
+	do {
+		pTester->SetDictionary(NULL, 0);
+		uPlainTotal += DeflateSample(
+			pTester, g_DictionarySamples[i], g_DictionaryLengths[i]);
+		pTester->SetDictionary(g_DeflateDictionary, uDictionarySize);
+		WordPtr uCompressedSize = DeflateSample(
+			pTester, g_DictionarySamples[i], g_DictionaryLengths[i]);
+		uDictionaryTotal += uCompressedSize;
+		// The FDICT flag must be set
+		if (!(g_DeflateCompressed[1] & 0x20U)) {
+			ReportFailure("CompressDeflate::SetDictionary() header = 0x%02X",
+				TRUE, g_DeflateCompressed[1]);
+			uFailure = TRUE;
+		}
+		MemoryFill(g_DeflateDecompressed, 0xD5, g_uDictionarySampleSize);
+		pDecompress->Reset();
+		Decompress::eError Error = pDecompress->Process(g_DeflateDecompressed,
+			g_DictionaryLengths[i], g_DeflateCompressed, uCompressedSize);
+		if ((Error != Decompress::DECOMPRESS_OKAY) ||
+			(pDecompress->GetProcessedOutputSize() != g_DictionaryLengths[i])) {
+			ReportFailure(
+				"DecompressDeflate::Process() with a dictionary = %d", TRUE,
+				Error);
+			uFailure = TRUE;
+		}
+		uFailure |= ReportDecompress(g_DeflateDecompressed,
+			reinterpret_cast<const Word8*>(g_DictionarySamples[i]),
+			g_DictionaryLengths[i], "DecompressDeflate with a dictionary");
+	} while (++i < g_uDictionarySampleCount);
+
+	// Small records must shrink noticeably
+	if ((uDictionaryTotal * 2) > uPlainTotal) {
+		ReportFailure(
+			"CompressDeflate with a dictionary = %u bytes, without = %u bytes",
+			TRUE, static_cast<Word>(uDictionaryTotal),
+			static_cast<Word>(uPlainTotal));
+		uFailure = TRUE;
+	}
+
+	// Missing dictionary
+	pDecompress->ClearDictionaries();
+	pDecompress->AddDictionary(Wrong, sizeof(Wrong));
+	pDecompress->Reset();
+	Decompress::eError Error = pDecompress->Process(g_DeflateDecompressed,
+		g_uDictionarySampleSize, g_DeflateCompressed,
+		DeflateSample(pTester, g_DictionarySamples[0], g_DictionaryLengths[0]));
+	if (Error != Decompress::DECOMPRESS_BADINPUT) {
+		ReportFailure(
+			"DecompressDeflate::Process() without the dictionary = %d, expected Decompress::DECOMPRESS_BADINPUT",
+			TRUE, Error);
+		uFailure = TRUE;
+	}
+
+	// Compress in parallel with the dictionary
+	WordPtr uCorpusSize = 0;
+	i = 0;
+	while ((uCorpusSize + g_uDictionarySampleSize) <= 0x18000) {
+		WordPtr uLength = g_DictionaryLengths[i % g_uDictionarySampleCount];
+		MemoryCopy(g_DeflateCorpus + uCorpusSize,
+			g_DictionarySamples[i % g_uDictionarySampleCount], uLength);
+		uCorpusSize += uLength;
+		++i;
+	}
+	pDecompress->AddDictionary(g_DeflateDictionary, uDictionarySize);
+	Word uThreads = 1;
+	do {
+		Compress::eError CError = pTester->CompressParallel(
+			g_DeflateCorpus, uCorpusSize, uThreads, 0x8000);
+		WordPtr uCompressedSize = pTester->GetOutputSize();
+		if ((CError != Compress::COMPRESS_OKAY) ||
+			(uCompressedSize > sizeof(g_DeflateCompressed)) ||
+			pTester->GetOutput()->Flatten(
+				g_DeflateCompressed, uCompressedSize)) {
+			ReportFailure(
+				"CompressDeflate::CompressParallel() with a dictionary = %d",
+				TRUE, CError);
+			uFailure = TRUE;
+			continue;
+		}
+		MemoryFill(g_DeflateDecompressed, 0xD5, uCorpusSize + 80);
+		pDecompress->Reset();
+		Error = pDecompress->Process(g_DeflateDecompressed, uCorpusSize,
+			g_DeflateCompressed, uCompressedSize);
+		if ((Error != Decompress::DECOMPRESS_OKAY) ||
+			(pDecompress->GetProcessedOutputSize() != uCorpusSize)) {
+			ReportFailure(
+				"DecompressDeflate::Process() of CompressParallel(threads %u) with a dictionary = %d",
+				TRUE, uThreads, Error);
+			uFailure = TRUE;
+		}
+		uFailure |= ReportDecompress(g_DeflateDecompressed, g_DeflateCorpus,
+			uCorpusSize, "CompressDeflate::CompressParallel with a dictionary");
+	} while (++uThreads < 4);
+	pTester->SetDictionary(NULL, 0);
+	Delete(pDecompress);
+	Delete(pTester);
+	return uFailure;
+}
+
+//
+// Load resources compressed with a dictionary stored in a rez file
+//
+
+static Word TestRezFileDictionary(void)
+{
+	Word uFailure = FALSE;
+	CompressDeflate* pTester = New<CompressDeflate>();
+	DecompressDeflate* pDecompress = New<DecompressDeflate>();
+	BuildDictionarySamples();
+	const void* pSamples[g_uDictionarySampleCount];
+	WordPtr i = 0;
+	do {
+		pSamples[i] = g_DictionarySamples[i];
+	} while (++i < g_uDictionarySampleCount);
+	Word32 uDictionarySize =
+		static_cast<Word32>(CompressDeflate::TrainDictionary(
+			g_DeflateDictionary, sizeof(g_DeflateDictionary), pSamples,
+			g_DictionaryLengths, g_uDictionarySampleCount));
+	pTester->SetDictionary(g_DeflateDictionary, uDictionarySize);
+
+	// Two resources compressed with the first codec
+	static const Word32 s_uResourceCount = 2;
+	Word32 uMemSize =
+		(sizeof(Word32) * 2) + (s_uResourceCount * sizeof(Word32) * 4) +
+		uDictionarySize + (sizeof(Word32) * 2) + 4;
+	OutputMemoryStream Header;
+	OutputMemoryStream Data;
+	Header.Append(RezFile::g_RezFileSignature, 4);
+	Header.Append(static_cast<Word32>(1));
+	Header.Append(uMemSize);
+	Header.Append("ZLIBNONENONE", 12);
+	Header.Append(static_cast<Word32>(1));
+	Header.Append(s_uResourceCount);
+	Word32 uFileOffset = RezFile::ROOTHEADERSIZE + uMemSize;
+	Word32 j = 0;
+	do {
+		WordPtr uCompressedSize = DeflateSample(
+			pTester, g_DictionarySamples[j], g_DictionaryLengths[j]);
+		Header.Append(uFileOffset);
+		Header.Append(static_cast<Word32>(g_DictionaryLengths[j]));
+		Header.Append(static_cast<Word32>(1U << RezFile::ENTRYFLAGSDECOMPSHIFT));
+		Header.Append(static_cast<Word32>(uCompressedSize));
+		Data.Append(g_DeflateCompressed, uCompressedSize);
+		uFileOffset += static_cast<Word32>(uCompressedSize);
+	} while (++j < s_uResourceCount);
+	Header.Append(g_DeflateDictionary, uDictionarySize);
+	Header.Append(uDictionarySize);
+	Header.Append(static_cast<Word32>(1));
+	Header.Append(RezFile::g_RezFileDictionarySignature, 4);
+	WordPtr uHeaderSize = Header.GetSize();
+	Header.Flatten(g_DeflateCorpus, uHeaderSize);
+	Data.Flatten(g_DeflateCorpus + uHeaderSize, Data.GetSize());
+
+	const char* pFilename = "9:dictionary.rez";
+	if (!FileManager::SaveFile(
+			pFilename, g_DeflateCorpus, uHeaderSize + Data.GetSize())) {
+		ReportFailure("FileManager::SaveFile(\"%s\")", TRUE, pFilename);
+		uFailure = TRUE;
+	} else {
+		MemoryManagerHandle Handles(0x100000);
+		RezFile Rez(&Handles);
+		// Log the codec before and after the file is opened
+		Word uPass = 0;
+		do {
+			if (!uPass) {
+				Rez.LogDecompressor(1, pDecompress);
+			}
+			if (Rez.Init(pFilename) || (Rez.GetDictionaryCount() != 1)) {
+				ReportFailure("RezFile::Init(\"%s\") with a dictionary", TRUE,
+					pFilename);
+				uFailure = TRUE;
+				break;
+			}
+			if (uPass) {
+				Rez.LogDecompressor(1, pDecompress);
+			}
+			if (pDecompress->GetDictionaryCount() != 1) {
+				ReportFailure(
+					"RezFile gave %u dictionaries to the codec, expected 1",
+					TRUE, pDecompress->GetDictionaryCount());
+				uFailure = TRUE;
+			}
+			j = 0;
+			do {
+				MemoryFill(g_DeflateDecompressed, 0xD5, g_uDictionarySampleSize);
+				if (Rez.Read(j + 1, g_DeflateDecompressed,
+						g_uDictionarySampleSize)) {
+					ReportFailure("RezFile::Read(%u) with a dictionary", TRUE,
+						static_cast<Word>(j + 1));
+					uFailure = TRUE;
+				} else {
+					uFailure |= ReportDecompress(g_DeflateDecompressed,
+						reinterpret_cast<const Word8*>(g_DictionarySamples[j]),
+						g_DictionaryLengths[j], "RezFile::Read()");
+				}
+			} while (++j < s_uResourceCount);
+			Rez.Shutdown();
+			if (pDecompress->GetDictionaryCount()) {
+				ReportFailure(
+					"RezFile::Shutdown() left dictionaries in the codec", TRUE);
+				uFailure = TRUE;
+			}
+			Rez.LogDecompressor(1, NULL);
+		} while (++uPass < 2);
+		FileManager::DeleteFile(pFilename);
+	}
+	Delete(pDecompress);
+	Delete(pTester);
+	return uFailure;
+}
+
+//
+// Load resources from a memory mapped rez file
+//
+
+static Word TestRezFileMapped(void)
+{
+	Word uFailure = FALSE;
+	CompressDeflate* pTester = New<CompressDeflate>();
+	DecompressDeflate* pDecompress = New<DecompressDeflate>();
+	BuildDictionarySamples();
+
+	// Resource 1 is stored, resource 2 is compressed
+	static const Word32 s_uResourceCount = 2;
+	Word32 uMemSize =
+		(sizeof(Word32) * 2) + (s_uResourceCount * sizeof(Word32) * 4);
+	OutputMemoryStream Header;
+	OutputMemoryStream Data;
+	Header.Append(RezFile::g_RezFileSignature, 4);
+	Header.Append(static_cast<Word32>(1));
+	Header.Append(uMemSize);
+	Header.Append("ZLIBNONENONE", 12);
+	Header.Append(static_cast<Word32>(1));
+	Header.Append(s_uResourceCount);
+	Word32 uFileOffset = RezFile::ROOTHEADERSIZE + uMemSize;
+	Header.Append(uFileOffset);
+	Header.Append(static_cast<Word32>(g_DictionaryLengths[0]));
+	Header.Append(static_cast<Word32>(0));
+	Header.Append(static_cast<Word32>(g_DictionaryLengths[0]));
+	Data.Append(g_DictionarySamples[0], g_DictionaryLengths[0]);
+	uFileOffset += static_cast<Word32>(g_DictionaryLengths[0]);
+	WordPtr uCompressedSize = DeflateSample(
+		pTester, g_DictionarySamples[1], g_DictionaryLengths[1]);
+	Header.Append(uFileOffset);
+	Header.Append(static_cast<Word32>(g_DictionaryLengths[1]));
+	Header.Append(static_cast<Word32>(1U << RezFile::ENTRYFLAGSDECOMPSHIFT));
+	Header.Append(static_cast<Word32>(uCompressedSize));
+	Data.Append(g_DeflateCompressed, uCompressedSize);
+	WordPtr uHeaderSize = Header.GetSize();
+	Header.Flatten(g_DeflateCorpus, uHeaderSize);
+	Data.Flatten(g_DeflateCorpus + uHeaderSize, Data.GetSize());
+
+	const char* pFilename = "9:mapped.rez";
+	if (!FileManager::SaveFile(
+			pFilename, g_DeflateCorpus, uHeaderSize + Data.GetSize())) {
+		ReportFailure("FileManager::SaveFile(\"%s\")", TRUE, pFilename);
+		uFailure = TRUE;
+	} else {
+		MemoryManagerHandle Handles(0x100000);
+		RezFile Rez(&Handles);
+		Rez.LogDecompressor(1, pDecompress);
+		// Test with file reads and then with the mapped file
+		Word bMapped = FALSE;
+		do {
+			Rez.SetMappedFlag(bMapped);
+			if (Rez.Init(pFilename)) {
+				ReportFailure("RezFile::Init(\"%s\") mapped = %u", TRUE,
+					pFilename, bMapped);
+				uFailure = TRUE;
+				break;
+			}
+#if defined(BURGER_LINUX)
+			if (Rez.IsMapped() != bMapped) {
+				ReportFailure("RezFile::IsMapped() = %u, expected %u", TRUE,
+					Rez.IsMapped(), bMapped);
+				uFailure = TRUE;
+			}
+#endif
+			// Loading twice must return the same data, new only once
+			Word bLoaded1 = FALSE;
+			Word bLoaded2 = TRUE;
+			Word8* pData1 = static_cast<Word8*>(Rez.Load(1, &bLoaded1));
+			Word8* pData2 = static_cast<Word8*>(Rez.Load(1, &bLoaded2));
+			if (!pData1 || (pData1 != pData2) || !bLoaded1 || bLoaded2) {
+				ReportFailure("RezFile::Load(1) mapped = %u", TRUE, bMapped);
+				uFailure = TRUE;
+			} else {
+				if (MemoryCompare(pData1, g_DictionarySamples[0],
+						g_DictionaryLengths[0])) {
+					ReportFailure(
+						"RezFile::Load(1) data mismatch, mapped = %u", TRUE,
+						bMapped);
+					uFailure = TRUE;
+				}
+				Word uRezNum = 0;
+				if (Rez.GetIDFromPointer(pData1, &uRezNum, NULL, 0) ||
+					(uRezNum != 1)) {
+					ReportFailure(
+						"RezFile::GetIDFromPointer() mapped = %u", TRUE, bMapped);
+					uFailure = TRUE;
+				}
+				// The data can be modified in place
+				Word8 uOld = pData1[0];
+				pData1[0] = static_cast<Word8>(uOld ^ 0xFF);
+				if (pData2[0] != static_cast<Word8>(uOld ^ 0xFF)) {
+					ReportFailure("RezFile::Load() data is not writable, mapped = %u",
+						TRUE, bMapped);
+					uFailure = TRUE;
+				}
+				pData1[0] = uOld;
+			}
+			if (pData1) {
+				Rez.Release(1);
+			}
+			if (pData2) {
+				Rez.Release(1);
+			}
+			MemoryFill(g_DeflateDecompressed, 0xD5, g_uDictionarySampleSize);
+			if (Rez.Read(2, g_DeflateDecompressed, g_uDictionarySampleSize)) {
+				ReportFailure("RezFile::Read(2) mapped = %u", TRUE, bMapped);
+				uFailure = TRUE;
+			} else {
+				uFailure |= ReportDecompress(g_DeflateDecompressed,
+					reinterpret_cast<const Word8*>(g_DictionarySamples[1]),
+					g_DictionaryLengths[1], "RezFile::Read()");
+			}
+			Rez.Shutdown();
+			if (Rez.IsMapped()) {
+				ReportFailure(
+					"RezFile::Shutdown() didn't release the mapping", TRUE);
+				uFailure = TRUE;
+			}
+		} while (++bMapped < 2);
+		Rez.LogDecompressor(1, NULL);
+		FileManager::DeleteFile(pFilename);
+	}
+	Delete(pDecompress);
+	Delete(pTester);
+	return uFailure;
+}
+
+//
+// Show the decompression speed
+//
+
+static void TimeDeflateDecompress(void)
+{
+	CompressDeflate* pTester = New<CompressDeflate>();
+	DecompressDeflate* pDecompress = New<DecompressDeflate>();
+	static const Word s_Levels[] = {
+		CompressDeflate::Z_BEST_SPEED, CompressDeflate::Z_BEST_COMPRESSION};
+	WordPtr i = 0;
+	do {
+		pTester->SetLevel(s_Levels[i]);
+		WordPtr uCompressedSize =
+			DeflateCorpus(pTester, g_DeflateCorpus, sizeof(g_DeflateCorpus));
+		const Word uIterations = 20;
+		Word32 uStart = Tick::ReadMicroseconds();
+		Word j = 0;
+		do {
+			pDecompress->Reset();
+			pDecompress->Process(g_DeflateDecompressed, sizeof(g_DeflateCorpus),
+				g_DeflateCompressed, uCompressedSize);
+		} while (++j < uIterations);
+		Word32 uTime = Tick::ReadMicroseconds() - uStart;
+
+		// Same data without the sliding window
+		uStart = Tick::ReadMicroseconds();
+		j = 0;
+		do {
+			SimpleDecompressDeflate(g_DeflateDecompressed,
+				sizeof(g_DeflateCorpus), g_DeflateCompressed, uCompressedSize);
+		} while (++j < uIterations);
+		Word32 uSimpleTime = Tick::ReadMicroseconds() - uStart;
+		WordPtr uTotal = sizeof(g_DeflateCorpus) * uIterations;
+		Message(
+			"Deflate level %u, DecompressDeflate::Process() %u MB/s, SimpleDecompressDeflate() %u MB/s",
+			s_Levels[i], static_cast<Word>(uTotal / (uTime + 1)),
+			static_cast<Word>(uTotal / (uSimpleTime + 1)));
+	} while (++i < BURGER_ARRAYSIZE(s_Levels));
+
+	// Small resource sized entries, where the setup of the sliding
+	// window is most of the cost
+	pTester->SetLevel(CompressDeflate::Z_DEFAULT_COMPRESSION);
+	const WordPtr uSmallSize = 0x1000;
+	WordPtr uCompressedSize =
+		DeflateCorpus(pTester, g_DeflateCorpus, uSmallSize);
+	const Word uIterations = 2000;
+	Word32 uStart = Tick::ReadMicroseconds();
+	Word j = 0;
+	do {
+		DecompressDeflate* pSmall = New<DecompressDeflate>();
+		pSmall->Process(g_DeflateDecompressed, uSmallSize, g_DeflateCompressed,
+			uCompressedSize);
+		Delete(pSmall);
+	} while (++j < uIterations);
+	Word32 uTime = Tick::ReadMicroseconds() - uStart;
+	uStart = Tick::ReadMicroseconds();
+	j = 0;
+	do {
+		SimpleDecompressDeflate(g_DeflateDecompressed, uSmallSize,
+			g_DeflateCompressed, uCompressedSize);
+	} while (++j < uIterations);
+	Word32 uSimpleTime = Tick::ReadMicroseconds() - uStart;
+	WordPtr uTotal = uSmallSize * uIterations;
+	Message(
+		"Deflate 4K entries, new DecompressDeflate %u MB/s, SimpleDecompressDeflate() %u MB/s",
+		static_cast<Word>(uTotal / (uTime + 1)),
+		static_cast<Word>(uTotal / (uSimpleTime + 1)));
+	Delete(pDecompress);
+	Delete(pTester);
+}
+
+//
+// Show the speed and the compressed size for each level
+//
+
+static void TimeDeflateLevels(void)
+{
+	CompressDeflate* pTester = New<CompressDeflate>();
+	Word uLevel = CompressDeflate::Z_NO_COMPRESSION;
+	do {
+		pTester->SetLevel(uLevel);
+		const Word uIterations = 4;
+		WordPtr uCompressedSize = 0;
+		Word32 uStart = Tick::ReadMicroseconds();
+		Word i = 0;
+		do {
+			uCompressedSize = DeflateCorpus(
+				pTester, g_DeflateCorpus, sizeof(g_DeflateCorpus));
+		} while (++i < uIterations);
+		Word32 uTime = Tick::ReadMicroseconds() - uStart;
+
+		// Bytes per microsecond is megabytes per second
+		WordPtr uTotal = sizeof(g_DeflateCorpus) * uIterations;
+		Word uRatio = static_cast<Word>(
+			(uCompressedSize * 10000U) / sizeof(g_DeflateCorpus));
+		Message("Deflate level %u, %u MB/s, %u bytes, %u.%02u%% of original",
+			uLevel, static_cast<Word>(uTotal / (uTime + 1)),
+			static_cast<Word>(uCompressedSize), uRatio / 100, uRatio % 100);
+	} while (++uLevel <= CompressDeflate::Z_BEST_COMPRESSION);
+
+	// Show the scaling of the parallel compressor
+	pTester->SetLevel(CompressDeflate::Z_DEFAULT_COMPRESSION);
+	Word uThreads = 1;
+	do {
+		const Word uIterations = 4;
+		Word32 uStart = Tick::ReadMicroseconds();
+		Word i = 0;
+		do {
+			pTester->CompressParallel(
+				g_DeflateCorpus, sizeof(g_DeflateCorpus), uThreads, 0x8000);
+		} while (++i < uIterations);
+		Word32 uTime = Tick::ReadMicroseconds() - uStart;
+		WordPtr uTotal = sizeof(g_DeflateCorpus) * uIterations;
+		Message("Deflate level 6, %u threads, %u MB/s, %u bytes", uThreads,
+			static_cast<Word>(uTotal / (uTime + 1)),
+			static_cast<Word>(pTester->GetOutputSize()));
+		uThreads <<= 1U;
+	} while (uThreads <= 8);
+	Delete(pTester);
+}
+
+//
+// Test LZ4 round trips in both modes, streamed decompression and
+// broken streams
+//
+
+static Word TestLZ4(void)
+{
+	Word uFailure = FALSE;
+	CompressLZ4* pTester = New<CompressLZ4>();
+	DecompressLZ4* pDecompress = New<DecompressLZ4>();
+	BuildDeflateCorpus(g_DeflateCorpus, sizeof(g_DeflateCorpus));
+
+	// An empty stream is only the end marker
+	pTester->Init();
+	pTester->Finalize();
+	WordPtr uCompressedSize = pTester->GetOutputSize();
+	if (uCompressedSize != 4) {
+		ReportFailure("CompressLZ4 of no data = %u bytes, expected 4", TRUE,
+			static_cast<Word>(uCompressedSize));
+		uFailure = TRUE;
+	}
+
+	// The small sample
+	Word8 Buffer[sizeof(RawData) + 80];
+	uCompressedSize = DeflateCorpus(pTester, RawData, sizeof(RawData));
+	MemoryFill(Buffer, 0xD5, sizeof(Buffer));
+	Decompress::eError Error = SimpleDecompressLZ4(
+		Buffer, sizeof(RawData), g_DeflateCompressed, uCompressedSize);
+	if (Error != Decompress::DECOMPRESS_OKAY) {
+		ReportFailure(
+			"SimpleDecompressLZ4(RawData) = %d, expected Decompress::DECOMPRESS_OKAY",
+			TRUE, Error);
+		uFailure = TRUE;
+	}
+	uFailure |= ReportDecompress(
+		Buffer, RawData, sizeof(RawData), "SimpleDecompressLZ4(RawData)");
+
+	static const WordPtr s_InputChunks[] = {1, 7, 4093};
+	static const WordPtr s_OutputChunks[] = {5, 0x8001};
+	Word bHigh = FALSE;
+	do {
+		pTester->SetHighCompression(bHigh);
+		// Crosses several blocks so matches reach into the previous one
+		uCompressedSize =
+			DeflateCorpus(pTester, g_DeflateCorpus, sizeof(g_DeflateCorpus));
+		MemoryFill(g_DeflateDecompressed, 0xD5, sizeof(g_DeflateDecompressed));
+		Error = SimpleDecompressLZ4(g_DeflateDecompressed,
+			sizeof(g_DeflateCorpus), g_DeflateCompressed, uCompressedSize);
+		if (Error != Decompress::DECOMPRESS_OKAY) {
+			ReportFailure(
+				"SimpleDecompressLZ4() of high compression %u = %d, expected Decompress::DECOMPRESS_OKAY",
+				TRUE, bHigh, Error);
+			uFailure = TRUE;
+		}
+		uFailure |= ReportDecompress(g_DeflateDecompressed, g_DeflateCorpus,
+			sizeof(g_DeflateCorpus), "SimpleDecompressLZ4 round trip");
+
+		// Feed it in pieces, the way RezFile does
+		WordPtr j = 0;
+		do {
+			WordPtr k = 0;
+			do {
+				MemoryFill(g_DeflateDecompressed, 0xD5,
+					sizeof(g_DeflateDecompressed));
+				pDecompress->Reset();
+				WordPtr uInputIndex = 0;
+				WordPtr uOutputIndex = 0;
+				do {
+					WordPtr uInputChunk = uCompressedSize - uInputIndex;
+					if (uInputChunk > s_InputChunks[j]) {
+						uInputChunk = s_InputChunks[j];
+					}
+					WordPtr uOutputChunk = sizeof(g_DeflateCorpus) - uOutputIndex;
+					if (uOutputChunk > s_OutputChunks[k]) {
+						uOutputChunk = s_OutputChunks[k];
+					}
+					Error = pDecompress->Process(
+						g_DeflateDecompressed + uOutputIndex, uOutputChunk,
+						g_DeflateCompressed + uInputIndex, uInputChunk);
+					uInputIndex += pDecompress->GetProcessedInputSize();
+					uOutputIndex += pDecompress->GetProcessedOutputSize();
+				} while ((Error == Decompress::DECOMPRESS_OUTPUTUNDERRUN) ||
+					(Error == Decompress::DECOMPRESS_OUTPUTOVERRUN));
+				if ((Error != Decompress::DECOMPRESS_OKAY) ||
+					(uOutputIndex != sizeof(g_DeflateCorpus))) {
+					ReportFailure(
+						"DecompressLZ4::Process(high compression %u, input chunks %u, output chunks %u) = %d",
+						TRUE, bHigh, static_cast<Word>(s_InputChunks[j]),
+						static_cast<Word>(s_OutputChunks[k]), Error);
+					uFailure = TRUE;
+				}
+				uFailure |= ReportDecompress(g_DeflateDecompressed,
+					g_DeflateCorpus, sizeof(g_DeflateCorpus),
+					"DecompressLZ4 chunked");
+			} while (++k < BURGER_ARRAYSIZE(s_OutputChunks));
+		} while (++j < BURGER_ARRAYSIZE(s_InputChunks));
+
+		// Truncated input
+		Error = SimpleDecompressLZ4(g_DeflateDecompressed,
+			sizeof(g_DeflateCorpus), g_DeflateCompressed, uCompressedSize - 5);
+		if (Error != Decompress::DECOMPRESS_OUTPUTUNDERRUN) {
+			ReportFailure(
+				"SimpleDecompressLZ4() of truncated high compression %u = %d, expected Decompress::DECOMPRESS_OUTPUTUNDERRUN",
+				TRUE, bHigh, Error);
+			uFailure = TRUE;
+		}
+		// Output buffer too small
+		Error = SimpleDecompressLZ4(g_DeflateDecompressed,
+			sizeof(g_DeflateCorpus) - 1, g_DeflateCompressed, uCompressedSize);
+		if (Error != Decompress::DECOMPRESS_OUTPUTOVERRUN) {
+			ReportFailure(
+				"SimpleDecompressLZ4() of short output high compression %u = %d, expected Decompress::DECOMPRESS_OUTPUTOVERRUN",
+				TRUE, bHigh, Error);
+			uFailure = TRUE;
+		}
+	} while (++bHigh < 2);
+
+	// A match that reaches before the start of the data
+	static const Word8 s_BadOffset[] = {0x08, 0x00, 0x00, 0x00, 0x10, 'A',
+		0x05, 0x00, 0x10, 'B', 0x00, 0x00, 0x00, 0x00};
+	Error = SimpleDecompressLZ4(
+		Buffer, sizeof(RawData), s_BadOffset, sizeof(s_BadOffset));
+	if (Error != Decompress::DECOMPRESS_BADINPUT) {
+		ReportFailure(
+			"SimpleDecompressLZ4(s_BadOffset) = %d, expected Decompress::DECOMPRESS_BADINPUT",
+			TRUE, Error);
+		uFailure = TRUE;
+	}
+	Delete(pDecompress);
+	Delete(pTester);
+	return uFailure;
+}
+
+//
+// Show the LZ4 speed and size next to deflate
+//
+
+static void TimeLZ4(void)
+{
+	CompressLZ4* pTester = New<CompressLZ4>();
+	Word bHigh = FALSE;
+	do {
+		pTester->SetHighCompression(bHigh);
+		const Word uIterations = 4;
+		WordPtr uCompressedSize = 0;
+		Word32 uStart = Tick::ReadMicroseconds();
+		Word i = 0;
+		do {
+			uCompressedSize =
+				DeflateCorpus(pTester, g_DeflateCorpus, sizeof(g_DeflateCorpus));
+		} while (++i < uIterations);
+		Word32 uCompressTime = Tick::ReadMicroseconds() - uStart;
+
+		const Word uDecompressIterations = 40;
+		uStart = Tick::ReadMicroseconds();
+		i = 0;
+		do {
+			SimpleDecompressLZ4(g_DeflateDecompressed, sizeof(g_DeflateCorpus),
+				g_DeflateCompressed, uCompressedSize);
+		} while (++i < uDecompressIterations);
+		Word32 uTime = Tick::ReadMicroseconds() - uStart;
+		Word uRatio = static_cast<Word>(
+			(uCompressedSize * 10000U) / sizeof(g_DeflateCorpus));
+		Message(
+			"LZ4 high compression %u, compress %u MB/s, decompress %u MB/s, %u bytes, %u.%02u%% of original",
+			bHigh,
+			static_cast<Word>(
+				(sizeof(g_DeflateCorpus) * uIterations) / (uCompressTime + 1)),
+			static_cast<Word>((sizeof(g_DeflateCorpus) * uDecompressIterations) /
+				(uTime + 1)),
+			static_cast<Word>(uCompressedSize), uRatio / 100, uRatio % 100);
+	} while (++bHigh < 2);
+	Delete(pTester);
+}
+
+//
+// Pull the corpus out of a DecompressStream in pieces of uChunk bytes
+//
+
+static Word ReadDecompressStream(DecompressStream* pStream, WordPtr uChunk,
+	const char* pName, WordPtr uVariant)
+{
+	Word uFailure = FALSE;
+	MemoryFill(g_DeflateDecompressed, 0xD5, sizeof(g_DeflateDecompressed));
+	WordPtr uTotal = 0;
+	WordPtr uLength;
+	do {
+		WordPtr uRequest = sizeof(g_DeflateCorpus) - uTotal;
+		if (uRequest > uChunk) {
+			uRequest = uChunk;
+		}
+		// Ask for one extra byte at the end to find the end of the data
+		if (!uRequest) {
+			uRequest = 1;
+		}
+		uLength = pStream->Read(g_DeflateDecompressed + uTotal, uRequest);
+		uTotal += uLength;
+	} while (uLength && (uTotal <= sizeof(g_DeflateCorpus)));
+	if ((uTotal != sizeof(g_DeflateCorpus)) || !pStream->IsEndOfStream() ||
+		(pStream->GetError() == Decompress::DECOMPRESS_BADINPUT) ||
+		pStream->IsReadFailure() ||
+		(pStream->GetTotalOutputSize() != sizeof(g_DeflateCorpus))) {
+		ReportFailure(
+			"DecompressStream::Read(%s %u, chunk %u) = %u bytes, error %d",
+			TRUE, pName, static_cast<Word>(uVariant),
+			static_cast<Word>(uChunk), static_cast<Word>(uTotal),
+			pStream->GetError());
+		uFailure = TRUE;
+	}
+	uFailure |= ReportDecompress(g_DeflateDecompressed, g_DeflateCorpus,
+		sizeof(g_DeflateCorpus), "DecompressStream::Read()");
+	return uFailure;
+}
+
+//
+// Test the pull based decompression from memory and files
+//
+
+static Word TestDecompressStream(void)
+{
+	Word uFailure = FALSE;
+	CompressDeflate* pDeflate = New<CompressDeflate>();
+	CompressLZ4* pLZ4 = New<CompressLZ4>();
+	DecompressDeflate* pInflate = New<DecompressDeflate>();
+	DecompressLZ4* pUnLZ4 = New<DecompressLZ4>();
+	BuildDeflateCorpus(g_DeflateCorpus, sizeof(g_DeflateCorpus));
+
+	static const WordPtr s_ReadChunks[] = {1, 4093, sizeof(g_DeflateCorpus)};
+	static const WordPtr s_BufferSizes[] = {7, 0x1000, 0};
+	const char* pFilename = "9:decompressstream.tmp";
+	DecompressStream Stream;
+
+	Word uType = 0;
+	do {
+		Decompress* pDecompress;
+		WordPtr uCompressedSize;
+		if (!uType) {
+			uCompressedSize =
+				DeflateCorpus(pDeflate, g_DeflateCorpus, sizeof(g_DeflateCorpus));
+			pDecompress = pInflate;
+		} else {
+			uCompressedSize =
+				DeflateCorpus(pLZ4, g_DeflateCorpus, sizeof(g_DeflateCorpus));
+			pDecompress = pUnLZ4;
+		}
+		// Data after the compressed data must not be touched
+		MemoryFill(g_DeflateCompressed + uCompressedSize, 0xD5, 16);
+
+		// Decompress in place from memory
+		WordPtr j = 0;
+		do {
+			InputMemoryStream Input(
+				g_DeflateCompressed, uCompressedSize + 16, TRUE);
+			if (Stream.Open(pDecompress, &Input, uCompressedSize)) {
+				ReportFailure("DecompressStream::Open(InputMemoryStream *)",
+					TRUE);
+				uFailure = TRUE;
+			} else {
+				uFailure |= ReadDecompressStream(
+					&Stream, s_ReadChunks[j], "memory type", uType);
+				if (Input.BytesRemaining() != 16) {
+					ReportFailure(
+						"DecompressStream from memory type %u left %u bytes, expected 16",
+						TRUE, uType,
+						static_cast<Word>(Input.BytesRemaining()));
+					uFailure = TRUE;
+				}
+				Stream.Close();
+			}
+		} while (++j < BURGER_ARRAYSIZE(s_ReadChunks));
+
+		// Read from a file with and without the prefetch thread
+		if (!FileManager::SaveFile(
+				pFilename, g_DeflateCompressed, uCompressedSize)) {
+			ReportFailure("FileManager::SaveFile(\"%s\")", TRUE, pFilename);
+			uFailure = TRUE;
+		} else {
+			File Input;
+			j = 0;
+			do {
+				Word bPrefetch = FALSE;
+				do {
+					if (Input.Open(pFilename, File::READONLY) ||
+						Stream.Open(pDecompress, &Input, uCompressedSize,
+							s_BufferSizes[j], bPrefetch)) {
+						ReportFailure("DecompressStream::Open(File *)", TRUE);
+						uFailure = TRUE;
+					} else {
+						uFailure |= ReadDecompressStream(&Stream,
+							s_ReadChunks[j], "file buffer size",
+							s_BufferSizes[j] + bPrefetch);
+						Stream.Close();
+					}
+					Input.Close();
+				} while (++bPrefetch < 2);
+			} while (++j < BURGER_ARRAYSIZE(s_BufferSizes));
+
+			// A file shorter than promised
+			if (!Input.Open(pFilename, File::READONLY) &&
+				!Stream.Open(pDecompress, &Input, uCompressedSize + 100, 0x1000,
+					TRUE)) {
+				Stream.Read(
+					g_DeflateDecompressed, sizeof(g_DeflateDecompressed));
+				if (!Stream.IsReadFailure() || !Stream.IsEndOfStream()) {
+					ReportFailure(
+						"DecompressStream::IsReadFailure() type %u on a short file",
+						TRUE, uType);
+					uFailure = TRUE;
+				}
+				Stream.Close();
+			}
+			Input.Close();
+			FileManager::DeleteFile(pFilename);
+		}
+	} while (++uType < 2);
+
+	// Bad data stops the stream
+	static const Word8 s_BadOffset[] = {0x08, 0x00, 0x00, 0x00, 0x10, 'A',
+		0x05, 0x00, 0x10, 'B', 0x00, 0x00, 0x00, 0x00};
+	InputMemoryStream BadInput(s_BadOffset, sizeof(s_BadOffset), TRUE);
+	Stream.Open(pUnLZ4, &BadInput, sizeof(s_BadOffset));
+	Stream.Read(g_DeflateDecompressed, 16);
+	if ((Stream.GetError() != Decompress::DECOMPRESS_BADINPUT) ||
+		!Stream.IsEndOfStream() || Stream.Read(g_DeflateDecompressed, 16)) {
+		ReportFailure(
+			"DecompressStream::GetError() = %d, expected Decompress::DECOMPRESS_BADINPUT",
+			TRUE, Stream.GetError());
+		uFailure = TRUE;
+	}
+	Stream.Close();
+
+	Delete(pUnLZ4);
+	Delete(pInflate);
+	Delete(pLZ4);
+	Delete(pDeflate);
+	return uFailure;
+}
+
+//
+// Test the LZSS hash chains in both formats
+//
+
+static Word TestLZSSChains(void)
+{
+	Word uFailure = FALSE;
+	CompressLZSS* pTester = New<CompressLZSS>();
+	DecompressLZSS* pDecompress = New<DecompressLZSS>();
+	pDecompress->SetLargeWindow(TRUE);
+	BuildDeflateCorpus(g_DeflateCorpus, sizeof(g_DeflateCorpus));
+
+	static const Word s_Depths[] = {1, 16, 256};
+	static const WordPtr s_InputChunks[] = {1, 7, 4093};
+	static const WordPtr s_OutputChunks[] = {5, 0x8001};
+	Word bLarge = FALSE;
+	do {
+		pTester->SetLargeWindow(bLarge);
+		WordPtr i = 0;
+		do {
+			pTester->SetSearchDepth(s_Depths[i]);
+			WordPtr uCompressedSize = DeflateCorpus(
+				pTester, g_DeflateCorpus, sizeof(g_DeflateCorpus));
+			MemoryFill(
+				g_DeflateDecompressed, 0xD5, sizeof(g_DeflateDecompressed));
+			Decompress::eError Error;
+			if (bLarge) {
+				Error = SimpleDecompressLZSSLargeWindow(g_DeflateDecompressed,
+					sizeof(g_DeflateCorpus), g_DeflateCompressed,
+					uCompressedSize);
+			} else {
+				Error = SimpleDecompressLZSS(g_DeflateDecompressed,
+					sizeof(g_DeflateCorpus), g_DeflateCompressed,
+					uCompressedSize);
+			}
+			if (Error != Decompress::DECOMPRESS_OKAY) {
+				ReportFailure(
+					"SimpleDecompressLZSS() of large window %u, depth %u = %d, expected Decompress::DECOMPRESS_OKAY",
+					TRUE, bLarge, s_Depths[i], Error);
+				uFailure = TRUE;
+			}
+			uFailure |= ReportDecompress(g_DeflateDecompressed,
+				g_DeflateCorpus, sizeof(g_DeflateCorpus),
+				"CompressLZSS hash chain round trip");
+		} while (++i < BURGER_ARRAYSIZE(s_Depths));
+	} while (++bLarge < 2);
+
+	// Feed the decoder in pieces so groups are split across calls
+	bLarge = FALSE;
+	do {
+		pTester->SetLargeWindow(bLarge);
+		pDecompress->SetLargeWindow(bLarge);
+		WordPtr uCompressedSize =
+			DeflateCorpus(pTester, g_DeflateCorpus, sizeof(g_DeflateCorpus));
+		WordPtr j = 0;
+		do {
+			WordPtr k = 0;
+			do {
+				MemoryFill(
+					g_DeflateDecompressed, 0xD5, sizeof(g_DeflateDecompressed));
+				pDecompress->Reset();
+				WordPtr uInputIndex = 0;
+				WordPtr uOutputIndex = 0;
+				Decompress::eError Error;
+				do {
+					WordPtr uInputChunk = uCompressedSize - uInputIndex;
+					if (uInputChunk > s_InputChunks[j]) {
+						uInputChunk = s_InputChunks[j];
+					}
+					WordPtr uOutputChunk = sizeof(g_DeflateCorpus) - uOutputIndex;
+					if (uOutputChunk > s_OutputChunks[k]) {
+						uOutputChunk = s_OutputChunks[k];
+					}
+					Error = pDecompress->Process(
+						g_DeflateDecompressed + uOutputIndex, uOutputChunk,
+						g_DeflateCompressed + uInputIndex, uInputChunk);
+					uInputIndex += pDecompress->GetProcessedInputSize();
+					uOutputIndex += pDecompress->GetProcessedOutputSize();
+					// There's no end marker, so stop when the output is full
+					// or nothing was done
+					if (!pDecompress->GetProcessedInputSize() &&
+						!pDecompress->GetProcessedOutputSize()) {
+						break;
+					}
+				} while ((Error != Decompress::DECOMPRESS_BADINPUT) &&
+					(uOutputIndex < sizeof(g_DeflateCorpus)));
+				if ((Error != Decompress::DECOMPRESS_OKAY) ||
+					(uOutputIndex != sizeof(g_DeflateCorpus))) {
+					ReportFailure(
+						"DecompressLZSS::Process(large window %u, input chunks %u, output chunks %u) = %d",
+						TRUE, bLarge, static_cast<Word>(s_InputChunks[j]),
+						static_cast<Word>(s_OutputChunks[k]), Error);
+					uFailure = TRUE;
+				}
+				uFailure |= ReportDecompress(g_DeflateDecompressed, g_DeflateCorpus,
+					sizeof(g_DeflateCorpus), "DecompressLZSS chunked");
+			} while (++k < BURGER_ARRAYSIZE(s_OutputChunks));
+		} while (++j < BURGER_ARRAYSIZE(s_InputChunks));
+	} while (++bLarge < 2);
+
+	// A match that reaches before the start of the data
+	static const Word8 s_BadOffset[] = {0x01, 'A', 0x02, 0x10};
+	Word8 Buffer[16];
+	Decompress::eError Error = SimpleDecompressLZSSLargeWindow(
+		Buffer, sizeof(Buffer), s_BadOffset, sizeof(s_BadOffset));
+	if (Error != Decompress::DECOMPRESS_BADINPUT) {
+		ReportFailure(
+			"SimpleDecompressLZSSLargeWindow(s_BadOffset) = %d, expected Decompress::DECOMPRESS_BADINPUT",
+			TRUE, Error);
+		uFailure = TRUE;
+	}
+	Delete(pDecompress);
+	Delete(pTester);
+	return uFailure;
+}
+
+//
+// Show the LZSS speed and size with the binary tree and hash chains
+//
+
+static void TimeLZSS(void)
+{
+	CompressLZSS* pTester = New<CompressLZSS>();
+	static const Word s_Depths[] = {0, 4, 32, 256};
+	Word bLarge = FALSE;
+	do {
+		pTester->SetLargeWindow(bLarge);
+		WordPtr i = bLarge ? 1U : 0U;
+		do {
+			pTester->SetSearchDepth(s_Depths[i]);
+			const Word uIterations = 2;
+			WordPtr uCompressedSize = 0;
+			Word32 uStart = Tick::ReadMicroseconds();
+			Word j = 0;
+			do {
+				uCompressedSize = DeflateCorpus(
+					pTester, g_DeflateCorpus, sizeof(g_DeflateCorpus));
+			} while (++j < uIterations);
+			Word32 uCompressTime = Tick::ReadMicroseconds() - uStart;
+
+			const Word uDecompressIterations = 10;
+			uStart = Tick::ReadMicroseconds();
+			j = 0;
+			do {
+				if (bLarge) {
+					SimpleDecompressLZSSLargeWindow(g_DeflateDecompressed,
+						sizeof(g_DeflateCorpus), g_DeflateCompressed,
+						uCompressedSize);
+				} else {
+					SimpleDecompressLZSS(g_DeflateDecompressed,
+						sizeof(g_DeflateCorpus), g_DeflateCompressed,
+						uCompressedSize);
+				}
+			} while (++j < uDecompressIterations);
+			Word32 uTime = Tick::ReadMicroseconds() - uStart;
+			Word uRatio = static_cast<Word>(
+				(uCompressedSize * 10000U) / sizeof(g_DeflateCorpus));
+			Message(
+				"LZSS large window %u, depth %u, compress %u MB/s, decompress %u MB/s, %u bytes, %u.%02u%% of original",
+				bLarge, s_Depths[i],
+				static_cast<Word>(
+					(sizeof(g_DeflateCorpus) * uIterations) / (uCompressTime + 1)),
+				static_cast<Word>(
+					(sizeof(g_DeflateCorpus) * uDecompressIterations) /
+					(uTime + 1)),
+				static_cast<Word>(uCompressedSize), uRatio / 100,
+				uRatio % 100);
+		} while (++i < BURGER_ARRAYSIZE(s_Depths));
+	} while (++bLarge < 2);
+
+	// Data that repeats every 16K, like an archive of similar assets,
+	// where only the large window can find the matches
+	Word32 uSeed = 0x27182818U;
+	WordPtr uIndex = 0;
+	do {
+		uSeed = (uSeed * 1103515245U) + 12345U;
+		g_DeflateCorpus[uIndex] = static_cast<Word8>(uSeed >> 24U);
+	} while (++uIndex < 0x4000);
+	do {
+		g_DeflateCorpus[uIndex] = g_DeflateCorpus[uIndex - 0x4000];
+		if (!(uIndex & 0xFF)) {
+			++g_DeflateCorpus[uIndex];
+		}
+	} while (++uIndex < sizeof(g_DeflateCorpus));
+	bLarge = FALSE;
+	do {
+		pTester->SetLargeWindow(bLarge);
+		pTester->SetSearchDepth(32);
+		WordPtr uCompressedSize =
+			DeflateCorpus(pTester, g_DeflateCorpus, sizeof(g_DeflateCorpus));
+		Word uRatio = static_cast<Word>(
+			(uCompressedSize * 10000U) / sizeof(g_DeflateCorpus));
+		Message(
+			"LZSS large window %u, depth 32, 16K repeats, %u bytes, %u.%02u%% of original",
+			bLarge, static_cast<Word>(uCompressedSize), uRatio / 100,
+			uRatio % 100);
+	} while (++bLarge < 2);
+	BuildDeflateCorpus(g_DeflateCorpus, sizeof(g_DeflateCorpus));
+	Delete(pTester);
+}
+
+//
+// Build an RGBA picture with gradients, hard edges, noise and an alpha
+// ramp. The size isn't a multiple of 4 to test the edge blocks.
+//
+
+static const Word g_uDXTWidth = 258;
+static const Word g_uDXTHeight = 130;
+static RGBAWord8_t g_DXTDecoded[g_uDXTWidth * g_uDXTHeight];
+
+static void BuildDXTImage(Image* pImage)
+{
+	pImage->Init(g_uDXTWidth, g_uDXTHeight, Image::PIXELTYPE8888);
+	Word32 uSeed = 0x12345678U;
+	Word y = 0;
+	do {
+		RGBAWord8_t* pRow = reinterpret_cast<RGBAWord8_t*>(
+			pImage->GetImage() + (pImage->GetStride() * y));
+		Word x = 0;
+		do {
+			uSeed = (uSeed * 1103515245U) + 12345U;
+			Word uNoise = (uSeed >> 16U) & 7U;
+			Word uRed = (x * 255U) / g_uDXTWidth;
+			Word uGreen = (y * 255U) / g_uDXTHeight;
+			Word uBlue = ((x + y) & 0x20U) ? 200U : 40U;
+			// Checkerboard of hard edges in the lower right
+			if ((x >= 128) && (y >= 64) && (((x >> 3U) ^ (y >> 3U)) & 1U)) {
+				uRed = 255 - uRed;
+				uGreen = 255 - uGreen;
+			}
+			pRow[x].m_uRed = static_cast<Word8>(uRed ^ uNoise);
+			pRow[x].m_uGreen = static_cast<Word8>(uGreen ^ uNoise);
+			pRow[x].m_uBlue = static_cast<Word8>(uBlue ^ uNoise);
+			// Alpha ramp on the left, cut out circles on the right
+			Word uAlpha = (y * 255U) / g_uDXTHeight;
+			if (x >= 128) {
+				Word uX = x & 15U;
+				Word uY = y & 15U;
+				uAlpha = ((((uX - 8) * (uX - 8)) + ((uY - 8) * (uY - 8))) < 40) ?
+					0U :
+					255U;
+			}
+			pRow[x].m_uAlpha = static_cast<Word8>(uAlpha);
+		} while (++x < g_uDXTWidth);
+	} while (++y < g_uDXTHeight);
+}
+
+//
+// Decompress an image into g_DXTDecoded
+//
+
+static void DecompressDXT(Image::ePixelTypes eType, const Image* pCompressed,
+	WordPtr uStride, Word uThreadCount)
+{
+	if (eType == Image::PIXELTYPEDXT1) {
+		DecompressImage(g_DXTDecoded, uStride, g_uDXTWidth, g_uDXTHeight,
+			reinterpret_cast<const Dxt1Packet_t*>(pCompressed->GetImage()),
+			pCompressed->GetStride(), uThreadCount);
+	} else if (eType == Image::PIXELTYPEDXT3) {
+		DecompressImage(g_DXTDecoded, uStride, g_uDXTWidth, g_uDXTHeight,
+			reinterpret_cast<const Dxt3Packet_t*>(pCompressed->GetImage()),
+			pCompressed->GetStride(), uThreadCount);
+	} else {
+		DecompressImage(g_DXTDecoded, uStride, g_uDXTWidth, g_uDXTHeight,
+			reinterpret_cast<const Dxt5Packet_t*>(pCompressed->GetImage()),
+			pCompressed->GetStride(), uThreadCount);
+	}
+}
+
+//
+// Squared color and alpha error of the decoded image
+//
+
+static void DXTError(const Image* pSource, Word bPunchThrough,
+	Word32* pColorError, Word32* pAlphaError)
+{
+	Word32 uColorError = 0;
+	Word32 uAlphaError = 0;
+	const RGBAWord8_t* pDecoded = g_DXTDecoded;
+	Word y = 0;
+	do {
+		const RGBAWord8_t* pRow = reinterpret_cast<const RGBAWord8_t*>(
+			pSource->GetImage() + (pSource->GetStride() * y));
+		Word x = 0;
+		do {
+			// DXT1 transparent pixels are black
+			if (!bPunchThrough || (pRow[x].m_uAlpha >= 128)) {
+				int iRed = pRow[x].m_uRed - pDecoded->m_uRed;
+				int iGreen = pRow[x].m_uGreen - pDecoded->m_uGreen;
+				int iBlue = pRow[x].m_uBlue - pDecoded->m_uBlue;
+				uColorError += static_cast<Word32>(
+					(iRed * iRed) + (iGreen * iGreen) + (iBlue * iBlue));
+			}
+			int iAlpha = pRow[x].m_uAlpha - pDecoded->m_uAlpha;
+			if (bPunchThrough) {
+				iAlpha = (pRow[x].m_uAlpha >= 128) ?
+					(255 - pDecoded->m_uAlpha) :
+					pDecoded->m_uAlpha;
+			}
+			uAlphaError += static_cast<Word32>(iAlpha * iAlpha);
+			++pDecoded;
+		} while (++x < g_uDXTWidth);
+	} while (++y < g_uDXTHeight);
+	pColorError[0] = uColorError;
+	pAlphaError[0] = uAlphaError;
+}
+
+//
+// Compress and decompress the test image, return the errors
+//
+
+static Word TestDXTFormat(const Image* pSource, Image::ePixelTypes eType,
+	Word bClusterFit, Word32* pColorError)
+{
+	Word uFailure = FALSE;
+	Image Compressed;
+	Compressed.Init(g_uDXTWidth, g_uDXTHeight, eType);
+	if (Compressed.StoreDXT(pSource, bClusterFit)) {
+		ReportFailure("Image::StoreDXT(%u) failed", TRUE, eType);
+		return TRUE;
+	}
+
+	// Threads must give the same result
+	Image Threaded;
+	Threaded.Init(g_uDXTWidth, g_uDXTHeight, eType);
+	Threaded.StoreDXT(pSource, bClusterFit, 4);
+	WordPtr uSize = Compressed.GetImageSize(0);
+	if (MemoryCompare(Compressed.GetImage(), Threaded.GetImage(), uSize)) {
+		ReportFailure("Image::StoreDXT(%u) with 4 threads doesn't match",
+			TRUE, eType);
+		uFailure = TRUE;
+	}
+
+	// Limits are about double the measured error
+	Word32 uColorLimit;
+	Word32 uAlphaLimit;
+	MemoryFill(g_DXTDecoded, 0xD5, sizeof(g_DXTDecoded));
+	DecompressDXT(eType, &Compressed, g_uDXTWidth * sizeof(RGBAWord8_t), 1);
+	if (eType == Image::PIXELTYPEDXT1) {
+		uColorLimit = 26;
+		uAlphaLimit = 0;
+	} else if (eType == Image::PIXELTYPEDXT3) {
+		uColorLimit = 54;
+		uAlphaLimit = 22;
+	} else {
+		uColorLimit = 54;
+		uAlphaLimit = 1;
+	}
+	Word32 uAlphaError;
+	DXTError(pSource, eType == Image::PIXELTYPEDXT1, pColorError, &uAlphaError);
+	// Mean squared error
+	Word32 uColorMSE = pColorError[0] / (g_uDXTWidth * g_uDXTHeight);
+	Word32 uAlphaMSE = uAlphaError / (g_uDXTWidth * g_uDXTHeight);
+	if ((uColorMSE > uColorLimit) || (uAlphaMSE > uAlphaLimit)) {
+		ReportFailure(
+			"DXT type %u cluster fit %u color error %u, alpha error %u, expected less than %u and %u",
+			TRUE, eType, bClusterFit, uColorMSE, uAlphaMSE, uColorLimit,
+			uAlphaLimit);
+		uFailure = TRUE;
+	}
+	return uFailure;
+}
+
+//
+// Test the DXT encoders
+//
+
+static Word TestDXT(void)
+{
+	Word uFailure = FALSE;
+	Image Source;
+	BuildDXTImage(&Source);
+
+	static const Image::ePixelTypes s_Types[] = {
+		Image::PIXELTYPEDXT1, Image::PIXELTYPEDXT3, Image::PIXELTYPEDXT5};
+	static const Word32 s_Masks[] = {0, CPUDispatch::kAllFeatures};
+	WordPtr i = 0;
+	do {
+		CPUDispatch::SetFamilyFeatureMask(CPUDispatch::kFamilyPixel, s_Masks[i]);
+		WordPtr j = 0;
+		do {
+			Word32 uRangeError;
+			Word32 uClusterError;
+			uFailure |= TestDXTFormat(&Source, s_Types[j], FALSE, &uRangeError);
+			uFailure |= TestDXTFormat(&Source, s_Types[j], TRUE, &uClusterError);
+			// Cluster fit tries the range fit first, so it's never worse
+			if (uClusterError > uRangeError) {
+				ReportFailure(
+					"DXT type %u cluster fit error %u is more than the range fit error %u",
+					TRUE, s_Types[j], uClusterError, uRangeError);
+				uFailure = TRUE;
+			}
+		} while (++j < BURGER_ARRAYSIZE(s_Types));
+	} while (++i < BURGER_ARRAYSIZE(s_Masks));
+	CPUDispatch::ResetFeatureMasks();
+
+	// A solid block is exact if the color is in R5:G6:B5
+	RGBAWord8_t Pixels[16];
+	RGBAWord8_t Decoded[16];
+	i = 0;
+	do {
+		Pixels[i].m_uRed = 0x84;
+		Pixels[i].m_uGreen = 0x41;
+		Pixels[i].m_uBlue = 0xFF;
+		Pixels[i].m_uAlpha = (i & 1) ? 0x00 : 0xFF;
+	} while (++i < 16);
+	Dxt5Packet_t Packet5;
+	Packet5.Compress(Pixels);
+	Packet5.Decompress(Decoded);
+	if (MemoryCompare(Pixels, Decoded, sizeof(Pixels))) {
+		ReportFailure("Dxt5Packet_t::Compress() of a solid block isn't exact",
+			TRUE);
+		uFailure = TRUE;
+	}
+
+	// Transparent DXT1 pixels decode as transparent black
+	Dxt1Packet_t Packet1;
+	Packet1.Compress(Pixels);
+	Packet1.Decompress(Decoded);
+	i = 0;
+	do {
+		Word32 uExpected = (i & 1) ? 0U : 0xFFFF4184U;
+		Word32 uDecoded = static_cast<Word32>(Decoded[i].m_uRed) |
+			(static_cast<Word32>(Decoded[i].m_uGreen) << 8U) |
+			(static_cast<Word32>(Decoded[i].m_uBlue) << 16U) |
+			(static_cast<Word32>(Decoded[i].m_uAlpha) << 24U);
+		if (uDecoded != uExpected) {
+			ReportFailure(
+				"Dxt1Packet_t::Compress() pixel %u = 0x%08X, expected 0x%08X",
+				TRUE, static_cast<Word>(i), uDecoded, uExpected);
+			uFailure = TRUE;
+		}
+	} while (++i < 16);
+	return uFailure;
+}
+
+//
+// Random blocks decoded by the row decoders and threads must match the
+// block decoder. The image is big enough for 4 threads and is written
+// into a wider buffer to check the stride and the clipping.
+//
+
+static const Word g_uDXTDecodeWidth = 1030;
+static const Word g_uDXTDecodeHeight = 258;
+static const Word g_uDXTDecodePadding = 6;
+static const Word g_uDXTDecodeBlockWidth = (g_uDXTDecodeWidth + 3) / 4;
+static const Word g_uDXTDecodeBlockHeight = (g_uDXTDecodeHeight + 3) / 4;
+static Word8
+	g_DXTBlocks[g_uDXTDecodeBlockWidth * g_uDXTDecodeBlockHeight * 16];
+static RGBAWord8_t g_DXTReference[g_uDXTDecodeWidth * g_uDXTDecodeHeight];
+static RGBAWord8_t g_DXTStrided[(g_uDXTDecodeWidth + g_uDXTDecodePadding) *
+	g_uDXTDecodeHeight];
+
+static Word TestDXTDecode(void)
+{
+	Word uFailure = FALSE;
+	Word32 uSeed = 0x9E3779B9U;
+	WordPtr i = 0;
+	do {
+		uSeed = (uSeed * 1103515245U) + 12345U;
+		g_DXTBlocks[i] = static_cast<Word8>(uSeed >> 16U);
+	} while (++i < sizeof(g_DXTBlocks));
+
+	static const Image::ePixelTypes s_Types[] = {Image::PIXELTYPEDXT1,
+		Image::PIXELTYPEDXT3, Image::PIXELTYPEDXT5, Image::PIXELTYPEBC4,
+		Image::PIXELTYPEBC5, Image::PIXELTYPEBC7};
+	static const Word32 s_Masks[] = {0, CPUDispatch::kSSE2,
+		CPUDispatch::kAllFeatures};
+	static const Word s_Threads[] = {1, 4};
+	WordPtr j = 0;
+	do {
+		Image::ePixelTypes eType = s_Types[j];
+		WordPtr uPacketSize = ((eType == Image::PIXELTYPEDXT1) ||
+								  (eType == Image::PIXELTYPEBC4)) ?
+			8U :
+			16U;
+		WordPtr uInputStride = uPacketSize * g_uDXTDecodeBlockWidth;
+
+		// Decode every block with the packet decoder
+		Word y = 0;
+		do {
+			Word x = 0;
+			do {
+				RGBAWord8_t Block[16];
+				const Word8* pPacket =
+					g_DXTBlocks + (uInputStride * (y / 4)) + (uPacketSize * (x / 4));
+				switch (eType) {
+				case Image::PIXELTYPEDXT1:
+					reinterpret_cast<const Dxt1Packet_t*>(pPacket)->Decompress(Block);
+					break;
+				case Image::PIXELTYPEDXT3:
+					reinterpret_cast<const Dxt3Packet_t*>(pPacket)->Decompress(Block);
+					break;
+				case Image::PIXELTYPEDXT5:
+					reinterpret_cast<const Dxt5Packet_t*>(pPacket)->Decompress(Block);
+					break;
+				case Image::PIXELTYPEBC4:
+					reinterpret_cast<const Bc4Packet_t*>(pPacket)->Decompress(Block);
+					break;
+				case Image::PIXELTYPEBC5:
+					reinterpret_cast<const Bc5Packet_t*>(pPacket)->Decompress(Block);
+					break;
+				default:
+					reinterpret_cast<const Bc7Packet_t*>(pPacket)->Decompress(Block);
+					break;
+				}
+				Word uBottom = g_uDXTDecodeHeight - y;
+				Word v = 0;
+				do {
+					Word uRight = g_uDXTDecodeWidth - x;
+					Word u = 0;
+					do {
+						g_DXTReference[((y + v) * g_uDXTDecodeWidth) + x + u] =
+							Block[(v * 4) + u];
+					} while ((++u < 4) && (u < uRight));
+				} while ((++v < 4) && (v < uBottom));
+				x += 4;
+			} while (x < g_uDXTDecodeWidth);
+			y += 4;
+		} while (y < g_uDXTDecodeHeight);
+
+		WordPtr k = 0;
+		do {
+			CPUDispatch::SetFamilyFeatureMask(CPUDispatch::kFamilyPixel, s_Masks[k]);
+			WordPtr t = 0;
+			do {
+				MemoryFill(g_DXTStrided, 0xD5, sizeof(g_DXTStrided));
+				WordPtr uStride = (g_uDXTDecodeWidth + g_uDXTDecodePadding) *
+					sizeof(RGBAWord8_t);
+				switch (eType) {
+				case Image::PIXELTYPEDXT1:
+					DecompressImage(g_DXTStrided, uStride, g_uDXTDecodeWidth,
+						g_uDXTDecodeHeight,
+						reinterpret_cast<const Dxt1Packet_t*>(g_DXTBlocks),
+						uInputStride, s_Threads[t]);
+					break;
+				case Image::PIXELTYPEDXT3:
+					DecompressImage(g_DXTStrided, uStride, g_uDXTDecodeWidth,
+						g_uDXTDecodeHeight,
+						reinterpret_cast<const Dxt3Packet_t*>(g_DXTBlocks),
+						uInputStride, s_Threads[t]);
+					break;
+				case Image::PIXELTYPEDXT5:
+					DecompressImage(g_DXTStrided, uStride, g_uDXTDecodeWidth,
+						g_uDXTDecodeHeight,
+						reinterpret_cast<const Dxt5Packet_t*>(g_DXTBlocks),
+						uInputStride, s_Threads[t]);
+					break;
+				case Image::PIXELTYPEBC4:
+					DecompressImage(g_DXTStrided, uStride, g_uDXTDecodeWidth,
+						g_uDXTDecodeHeight,
+						reinterpret_cast<const Bc4Packet_t*>(g_DXTBlocks),
+						uInputStride, s_Threads[t]);
+					break;
+				case Image::PIXELTYPEBC5:
+					DecompressImage(g_DXTStrided, uStride, g_uDXTDecodeWidth,
+						g_uDXTDecodeHeight,
+						reinterpret_cast<const Bc5Packet_t*>(g_DXTBlocks),
+						uInputStride, s_Threads[t]);
+					break;
+				default:
+					DecompressImage(g_DXTStrided, uStride, g_uDXTDecodeWidth,
+						g_uDXTDecodeHeight,
+						reinterpret_cast<const Bc7Packet_t*>(g_DXTBlocks),
+						uInputStride, s_Threads[t]);
+					break;
+				}
+				y = 0;
+				do {
+					const RGBAWord8_t* pRow = g_DXTStrided +
+						(y * (g_uDXTDecodeWidth + g_uDXTDecodePadding));
+					Word uTest = MemoryCompare(pRow,
+						g_DXTReference + (y * g_uDXTDecodeWidth),
+						g_uDXTDecodeWidth * sizeof(RGBAWord8_t)) != 0;
+					// The padding must not be touched
+					const Word8* pPadding =
+						reinterpret_cast<const Word8*>(pRow + g_uDXTDecodeWidth);
+					Word u = 0;
+					do {
+						if (pPadding[u] != 0xD5) {
+							uTest = TRUE;
+						}
+					} while (++u < (g_uDXTDecodePadding * sizeof(RGBAWord8_t)));
+					if (uTest) {
+						ReportFailure(
+							"DecompressImage(type %u) mask 0x%08X, %u threads, line %u doesn't match",
+							TRUE, eType, s_Masks[k], s_Threads[t], y);
+						uFailure = TRUE;
+						break;
+					}
+				} while (++y < g_uDXTDecodeHeight);
+			} while (++t < BURGER_ARRAYSIZE(s_Threads));
+		} while (++k < BURGER_ARRAYSIZE(s_Masks));
+	} while (++j < BURGER_ARRAYSIZE(s_Types));
+	CPUDispatch::ResetFeatureMasks();
+	return uFailure;
+}
+
+//
+// One BC7 block of each mode and the pixels they decode to
+//
+
+static const Word8 g_BC7Blocks[8 * 16] = {
+	0x1D, 0x15, 0xA5, 0xD6, 0x7A, 0xF2, 0x2C, 0x87,
+	0x00, 0x5F, 0xF9, 0x60, 0x91, 0x3B, 0x10, 0x61,
+	0x9A, 0x19, 0x0B, 0x1E, 0xC4, 0x36, 0xFB, 0x60,
+	0x19, 0x69, 0x0C, 0x9C, 0x07, 0x8D, 0x82, 0x11,
+	0x3C, 0xE6, 0x31, 0xC5, 0x30, 0x06, 0xB5, 0x3A,
+	0xFB, 0xC9, 0xF0, 0xC8, 0xA3, 0x65, 0xEB, 0x75,
+	0xA8, 0x85, 0xE9, 0x07, 0x98, 0x1C, 0x8B, 0x32,
+	0x35, 0x1F, 0x3E, 0x9B, 0x08, 0x1D, 0xC8, 0x22,
+	0xB0, 0xF8, 0x5E, 0x16, 0xFC, 0x96, 0x75, 0xC3,
+	0x47, 0x71, 0xD0, 0xF0, 0x93, 0x2D, 0xD2, 0xBA,
+	0xA0, 0x87, 0x72, 0x88, 0xCC, 0xCC, 0x74, 0x66,
+	0xB0, 0x12, 0xC1, 0xBF, 0x90, 0x6E, 0xA7, 0xE4,
+	0x40, 0x07, 0xC2, 0x54, 0xDA, 0x9C, 0xD6, 0x3E,
+	0x58, 0x3A, 0x8B, 0x87, 0x99, 0x4F, 0x29, 0xDA,
+	0x80, 0xFF, 0x54, 0x4B, 0x5C, 0x13, 0x8E, 0x25,
+	0xAA, 0xD4, 0x46, 0x8B, 0x46, 0x90, 0xA3, 0xE5,
+};
+
+static const Word8 g_BC7Decoded[8 * 16 * 4] = {
+	0x95, 0x97, 0x6E, 0xFF, 0xAD, 0xDE, 0x39, 0xFF, 0x84, 0x31, 0x42, 0xFF, 0x84, 0x31, 0x42, 0xFF,
+	0x95, 0x97, 0x6E, 0xFF, 0x77, 0x40, 0x3A, 0xFF, 0x6A, 0x4F, 0x32, 0xFF, 0xA7, 0x65, 0xE7, 0xFF,
+	0x43, 0x7E, 0x18, 0xFF, 0x5E, 0x5E, 0x2A, 0xFF, 0x52, 0x73, 0x84, 0xFF, 0x8B, 0x6A, 0xC6, 0xFF,
+	0x84, 0x31, 0x42, 0xFF, 0x60, 0x71, 0x94, 0xFF, 0x8B, 0x6A, 0xC6, 0xFF, 0x60, 0x71, 0x94, 0xFF,
+	0x84, 0x37, 0x89, 0xFF, 0x81, 0xCD, 0x44, 0xFF, 0x81, 0xCD, 0x44, 0xFF, 0xB1, 0x6C, 0x95, 0xFF,
+	0x47, 0xE6, 0x59, 0xFF, 0xB1, 0x6C, 0x95, 0xFF, 0x64, 0x10, 0x81, 0xFF, 0x47, 0xE6, 0x59, 0xFF,
+	0xA6, 0x5F, 0x92, 0xFF, 0x81, 0xCD, 0x44, 0xFF, 0x38, 0xED, 0x5E, 0xFF, 0x64, 0x10, 0x81, 0xFF,
+	0x47, 0xE6, 0x59, 0xFF, 0x6F, 0x1D, 0x84, 0xFF, 0x7A, 0x2A, 0x87, 0xFF, 0x81, 0xCD, 0x44, 0xFF,
+	0x9C, 0x63, 0x7B, 0xFF, 0x59, 0x79, 0x8C, 0xFF, 0x2C, 0x7D, 0x55, 0xFF, 0x2E, 0xAB, 0x2E, 0xFF,
+	0x7C, 0x6E, 0x83, 0xFF, 0x59, 0x79, 0x8C, 0xFF, 0x2E, 0xAB, 0x2E, 0xFF, 0x29, 0x52, 0x7B, 0xFF,
+	0x31, 0x39, 0x21, 0xFF, 0x41, 0x6F, 0x3F, 0xFF, 0x29, 0x52, 0x7B, 0xFF, 0x29, 0x52, 0x7B, 0xFF,
+	0x53, 0xA8, 0x5D, 0xFF, 0x53, 0xA8, 0x5D, 0xFF, 0x29, 0x52, 0x7B, 0xFF, 0x31, 0xD6, 0x08, 0xFF,
+	0xC2, 0xE4, 0x9A, 0xFF, 0x29, 0x4F, 0x77, 0xFF, 0x0E, 0x50, 0x7C, 0xFF, 0xC2, 0xE4, 0x9A, 0xFF,
+	0xCF, 0xD3, 0x72, 0xFF, 0x60, 0x4C, 0x6C, 0xFF, 0x29, 0x4F, 0x77, 0xFF, 0xC2, 0xE4, 0x9A, 0xFF,
+	0xC2, 0xE4, 0x9A, 0xFF, 0x45, 0x4D, 0x71, 0xFF, 0x0E, 0x50, 0x7C, 0xFF, 0xE9, 0xB1, 0x1F, 0xFF,
+	0xDC, 0xC2, 0x47, 0xFF, 0x0E, 0x50, 0x7C, 0xFF, 0x45, 0x4D, 0x71, 0xFF, 0xC2, 0xE4, 0x9A, 0xFF,
+	0x6A, 0xBD, 0x08, 0xC6, 0x68, 0xA4, 0x4B, 0xC3, 0x65, 0x97, 0x6D, 0xC2, 0x68, 0xBD, 0x08, 0xC6,
+	0x6A, 0x63, 0xF7, 0xBD, 0x6D, 0x63, 0xF7, 0xBD, 0x68, 0x89, 0x92, 0xC1, 0x65, 0x89, 0x92, 0xC1,
+	0x65, 0x7C, 0xB4, 0xC0, 0x6D, 0x7C, 0xB4, 0xC0, 0x68, 0xBD, 0x08, 0xC6, 0x68, 0xB0, 0x2A, 0xC5,
+	0x6D, 0x7C, 0xB4, 0xC0, 0x68, 0x7C, 0xB4, 0xC0, 0x65, 0x70, 0xD5, 0xBE, 0x6D, 0x7C, 0xB4, 0xC0,
+	0x0E, 0x9D, 0x99, 0x42, 0x8D, 0x9D, 0x54, 0x9D, 0x4C, 0x72, 0x77, 0x6E, 0x4C, 0x44, 0x77, 0x6E,
+	0x4C, 0x44, 0x77, 0x6E, 0x8D, 0x19, 0x54, 0x9D, 0x0E, 0x44, 0x99, 0x42, 0x8D, 0x72, 0x54, 0x9D,
+	0x0E, 0x19, 0x99, 0x42, 0x0E, 0x72, 0x99, 0x42, 0x8D, 0x44, 0x54, 0x9D, 0xCB, 0x44, 0x32, 0xC9,
+	0xCB, 0x9D, 0x32, 0xC9, 0xCB, 0x72, 0x32, 0xC9, 0x4C, 0x44, 0x77, 0x6E, 0x4C, 0x19, 0x77, 0x6E,
+	0x19, 0x4B, 0x3C, 0xBE, 0x18, 0x4B, 0x3E, 0xB8, 0x14, 0x4B, 0x46, 0x9A, 0x1A, 0x4C, 0x3B, 0xC4,
+	0x13, 0x4B, 0x48, 0x94, 0x16, 0x4B, 0x43, 0xA6, 0x16, 0x4B, 0x41, 0xAC, 0x16, 0x4B, 0x43, 0xA6,
+	0x15, 0x4B, 0x44, 0xA1, 0x15, 0x4B, 0x44, 0xA1, 0x10, 0x4A, 0x4E, 0x7C, 0x19, 0x4B, 0x3C, 0xBE,
+	0x15, 0x4B, 0x44, 0xA1, 0x1A, 0x4C, 0x39, 0xC9, 0x14, 0x4B, 0x46, 0x9A, 0x12, 0x4A, 0x4B, 0x89,
+	0x83, 0x8E, 0x83, 0x96, 0x59, 0x08, 0x51, 0xA2, 0x6C, 0x60, 0x53, 0x81, 0x9A, 0xBA, 0xB2, 0xAA,
+	0x9A, 0xBA, 0xB2, 0xAA, 0x2B, 0x2B, 0x38, 0x53, 0x9A, 0xBA, 0xB2, 0xAA, 0x55, 0x34, 0x24, 0x6D,
+	0x83, 0x8E, 0x83, 0x96, 0x59, 0x08, 0x51, 0xA2, 0x42, 0x19, 0x45, 0x7B, 0x14, 0x3C, 0x2C, 0x2C,
+	0x6C, 0x60, 0x53, 0x81, 0x59, 0x08, 0x51, 0xA2, 0x14, 0x3C, 0x2C, 0x2C, 0x42, 0x19, 0x45, 0x7B,
+};
+
+static Word TestBC7(void)
+{
+	Word uFailure = FALSE;
+	static const Word32 s_Masks[] = {0, CPUDispatch::kAllFeatures};
+	WordPtr k = 0;
+	do {
+		CPUDispatch::SetFamilyFeatureMask(CPUDispatch::kFamilyPixel, s_Masks[k]);
+		Word uMode = 0;
+		do {
+			RGBAWord8_t Block[16];
+			reinterpret_cast<const Bc7Packet_t*>(g_BC7Blocks + (uMode * 16))
+				->Decompress(Block);
+			if (MemoryCompare(Block, g_BC7Decoded + (uMode * 64), 64)) {
+				ReportFailure("Bc7Packet_t::Decompress() mode %u mask 0x%08X",
+					TRUE, uMode, s_Masks[k]);
+				uFailure = TRUE;
+			}
+		} while (++uMode < 8);
+
+		// The reserved mode is transparent black
+		Word8 Reserved[16];
+		MemoryClear(Reserved, sizeof(Reserved));
+		Reserved[5] = 0x55;
+		RGBAWord8_t Block[16];
+		MemoryFill(Block, 0xD5, sizeof(Block));
+		reinterpret_cast<const Bc7Packet_t*>(Reserved)->Decompress(Block);
+		Word i = 0;
+		do {
+			if (reinterpret_cast<const Word8*>(Block)[i]) {
+				ReportFailure("Bc7Packet_t::Decompress() reserved mode mask 0x%08X",
+					TRUE, s_Masks[k]);
+				uFailure = TRUE;
+				break;
+			}
+		} while (++i < sizeof(Block));
+	} while (++k < BURGER_ARRAYSIZE(s_Masks));
+	CPUDispatch::ResetFeatureMasks();
+
+	// Save the blocks as a DDS file, load it and decode it with Image
+	Image Compressed;
+	Compressed.Init(32, 4, Image::PIXELTYPEBC7);
+	MemoryCopy(Compressed.GetImage(), g_BC7Blocks, sizeof(g_BC7Blocks));
+	FileDDS DDS;
+	OutputMemoryStream Output;
+	Word uTest = DDS.Save(&Output, &Compressed);
+	Image* pLoaded = NULL;
+	if (!uTest) {
+		WordPtr uLength;
+		void* pFile = Output.Flatten(&uLength);
+		InputMemoryStream Input(pFile, uLength);
+		pLoaded = DDS.Load(&Input);
+	}
+	if (!pLoaded || (pLoaded->GetType() != Image::PIXELTYPEBC7)) {
+		uTest = TRUE;
+	} else {
+		Image Decoded;
+		Decoded.Init(32, 4, Image::PIXELTYPE8888);
+		uTest = Decoded.Store8888(pLoaded, NULL);
+		Word y = 0;
+		do {
+			Word uMode = 0;
+			do {
+				if (MemoryCompare(Decoded.GetImage() +
+							(Decoded.GetStride() * y) + (uMode * 16),
+						g_BC7Decoded + (uMode * 64) + (y * 16), 16)) {
+					uTest = TRUE;
+				}
+			} while (++uMode < 8);
+		} while (++y < 4);
+	}
+	Delete(pLoaded);
+	if (uTest) {
+		ReportFailure("FileDDS BC7 round trip", TRUE);
+		uFailure = TRUE;
+	}
+	return uFailure;
+}
+
+//
+// Show the DXT encoder and decoder speed
+//
+
+static void TimeDXT(void)
+{
+	Image Source;
+	BuildDXTImage(&Source);
+	static const Image::ePixelTypes s_Types[] = {
+		Image::PIXELTYPEDXT1, Image::PIXELTYPEDXT3, Image::PIXELTYPEDXT5};
+	WordPtr j = 0;
+	do {
+		Image Compressed;
+		Compressed.Init(g_uDXTWidth, g_uDXTHeight, s_Types[j]);
+		Word bClusterFit = FALSE;
+		do {
+			const Word uIterations = bClusterFit ? 2U : 20U;
+			Word32 uStart = Tick::ReadMicroseconds();
+			Word i = 0;
+			do {
+				Compressed.StoreDXT(&Source, bClusterFit);
+			} while (++i < uIterations);
+			Word32 uTime = Tick::ReadMicroseconds() - uStart;
+			Word uRate = static_cast<Word>(
+				(g_uDXTWidth * g_uDXTHeight * uIterations * 100U) / (uTime + 1));
+			Message("DXT type %u cluster fit %u, %u.%02u megapixels/s",
+				s_Types[j], bClusterFit, uRate / 100, uRate % 100);
+		} while (++bClusterFit < 2);
+
+		const Word uIterations = 200;
+		WordPtr uStride = g_uDXTWidth * sizeof(RGBAWord8_t);
+		Word32 uStart = Tick::ReadMicroseconds();
+		Word i = 0;
+		do {
+			DecompressDXT(s_Types[j], &Compressed, uStride, 1);
+		} while (++i < uIterations);
+		Word32 uTime = Tick::ReadMicroseconds() - uStart;
+		Message("DXT type %u decompress, %u megapixels/s", s_Types[j],
+			static_cast<Word>(
+				(g_uDXTWidth * g_uDXTHeight * uIterations) / (uTime + 1)));
+	} while (++j < BURGER_ARRAYSIZE(s_Types));
+}
+
+//
+// Test the half and packed float array conversions
+//
+
+static float g_PackFloats[0x10000];
+static float g_PackFloatsReference[0x10000];
+static Word16 g_PackHalfs[0x10000];
+static Word16 g_PackHalfsReference[0x10000];
+
+struct HalfToFloat_t {
+	Word16 m_uHalf;
+	Word32 m_uFloat;
+};
+
+static const HalfToFloat_t g_HalfToFloat[] = {{0x0000, 0x00000000U},
+	{0x8000, 0x80000000U}, {0x3C00, 0x3F800000U}, {0xC000, 0xC0000000U},
+	{0x7BFF, 0x477FE000U}, {0x0001, 0x33800000U}, {0x03FF, 0x387FC000U},
+	{0x0400, 0x38800000U}, {0x7C00, 0x7F800000U}, {0xFC00, 0xFF800000U},
+	{0x7C01, 0x7FC02000U}, {0x7E00, 0x7FC00000U}};
+
+static const HalfToFloat_t g_FloatToHalf[] = {{0x7BFF, 0x477FEFFFU},
+	{0x7C00, 0x477FF000U}, {0x0000, 0x33000000U}, {0x0001, 0x33000001U},
+	{0x3C00, 0x3F801000U}, {0x3C02, 0x3F803000U}, {0x3C01, 0x3F801001U},
+	{0x7E00, 0x7F800001U}, {0xFE3F, 0xFFC7E000U}, {0x8000, 0xB2FFFFFFU}};
+
+static Word TestPackFloat(void)
+{
+	Word uFailure = FALSE;
+
+	// Known values in both directions
+	WordPtr i = 0;
+	do {
+		Word32ToFloat Result;
+		Result = UnpackHalfToFloat(g_HalfToFloat[i].m_uHalf);
+		float fResult = Result;
+		Word32 uResult = Result.GetWord();
+		Word uTest = uResult != g_HalfToFloat[i].m_uFloat;
+		uFailure |= uTest;
+		ReportFailure("UnpackHalfToFloat(0x%04X) = 0x%08X, expected 0x%08X",
+			uTest, g_HalfToFloat[i].m_uHalf, uResult,
+			g_HalfToFloat[i].m_uFloat);
+		if (!(g_HalfToFloat[i].m_uHalf & 0x0200) ||
+			((g_HalfToFloat[i].m_uHalf & 0x7C00) != 0x7C00)) {
+			Word uHalf = PackFloatToHalf(fResult);
+			uTest = (uHalf != g_HalfToFloat[i].m_uHalf) &&
+				((g_HalfToFloat[i].m_uHalf & 0x7FFF) <= 0x7C00);
+			uFailure |= uTest;
+			ReportFailure("PackFloatToHalf(0x%08X) = 0x%04X, expected 0x%04X",
+				uTest, uResult, uHalf, g_HalfToFloat[i].m_uHalf);
+		}
+	} while (++i < BURGER_ARRAYSIZE(g_HalfToFloat));
+	i = 0;
+	do {
+		Word32ToFloat Input;
+		Input.SetWord(g_FloatToHalf[i].m_uFloat);
+		Word uHalf = PackFloatToHalf(Input);
+		Word uTest = uHalf != g_FloatToHalf[i].m_uHalf;
+		uFailure |= uTest;
+		ReportFailure("PackFloatToHalf(0x%08X) = 0x%04X, expected 0x%04X",
+			uTest, g_FloatToHalf[i].m_uFloat, uHalf, g_FloatToHalf[i].m_uHalf);
+	} while (++i < BURGER_ARRAYSIZE(g_FloatToHalf));
+
+	// Every half value, with unaligned starts and odd lengths for the tails
+	i = 0;
+	do {
+		g_PackHalfs[i] = static_cast<Word16>(i);
+		g_PackFloatsReference[i] = UnpackHalfToFloat(static_cast<Word16>(i));
+	} while (++i < 0x10000);
+
+	static const Word32 s_Masks[] = {
+		0, CPUDispatch::kSSE2, CPUDispatch::kAllFeatures};
+	static const WordPtr s_Starts[] = {0, 3};
+	WordPtr k = 0;
+	do {
+		CPUDispatch::SetFamilyFeatureMask(CPUDispatch::kFamilyMath, s_Masks[k]);
+		WordPtr j = 0;
+		do {
+			WordPtr uStart = s_Starts[j];
+			WordPtr uCount = 0x10000 - (uStart * 2);
+			MemoryClear(g_PackFloats, sizeof(g_PackFloats));
+			UnpackHalfToFloats(
+				g_PackFloats + uStart, g_PackHalfs + uStart, uCount);
+			Word uTest = MemoryCompare(g_PackFloats + uStart,
+							 g_PackFloatsReference + uStart,
+							 uCount * sizeof(float)) != 0;
+			uFailure |= uTest;
+			ReportFailure("UnpackHalfToFloats() mask 0x%08X start %u", uTest,
+				s_Masks[k], static_cast<Word>(uStart));
+
+			// Halves must survive the round trip, NaNs become quiet
+			MemoryClear(g_PackHalfsReference, sizeof(g_PackHalfsReference));
+			PackFloatsToHalf(
+				g_PackHalfsReference + uStart, g_PackFloats + uStart, uCount);
+			i = uStart;
+			do {
+				Word uExpected = static_cast<Word>(i);
+				if ((uExpected & 0x7FFF) > 0x7C00) {
+					uExpected |= 0x0200;
+				}
+				if (g_PackHalfsReference[i] != uExpected) {
+					ReportFailure(
+						"PackFloatsToHalf() mask 0x%08X 0x%04X became 0x%04X",
+						TRUE, s_Masks[k], static_cast<Word>(i),
+						g_PackHalfsReference[i]);
+					uFailure = TRUE;
+					break;
+				}
+			} while (++i < (uStart + uCount));
+		} while (++j < BURGER_ARRAYSIZE(s_Starts));
+	} while (++k < BURGER_ARRAYSIZE(s_Masks));
+
+	// Random bit patterns cover rounding, overflow and denormals
+	Word32 uSeed = 0x2545F491U;
+	i = 0;
+	do {
+		uSeed = (uSeed * 1103515245U) + 12345U;
+		Word32 uBits = (uSeed & 0xFFFF0000U) | (i & 0xFFFFU);
+		reinterpret_cast<Word32*>(g_PackFloatsReference)[i] = uBits;
+		g_PackHalfsReference[i] = PackFloatToHalf(g_PackFloatsReference[i]);
+	} while (++i < 0x10000);
+	k = 0;
+	do {
+		CPUDispatch::SetFamilyFeatureMask(CPUDispatch::kFamilyMath, s_Masks[k]);
+		MemoryClear(g_PackHalfs, sizeof(g_PackHalfs));
+		PackFloatsToHalf(g_PackHalfs, g_PackFloatsReference, 0x10000 - 5);
+		Word uTest = MemoryCompare(g_PackHalfs, g_PackHalfsReference,
+						 (0x10000 - 5) * sizeof(Word16)) != 0;
+		uFailure |= uTest;
+		ReportFailure("PackFloatsToHalf() mask 0x%08X", uTest, s_Masks[k]);
+	} while (++k < BURGER_ARRAYSIZE(s_Masks));
+
+	// The base exponent format must match the single value functions
+	static const Word32 s_Exponents[] = {111, 120};
+	WordPtr e = 0;
+	do {
+		Word32 uBaseExponent = s_Exponents[e];
+		i = 0;
+		do {
+			g_PackFloats[i] = Unpack16ToFloat(
+				static_cast<Int16>(g_PackHalfsReference[i]), uBaseExponent);
+			g_PackHalfs[i] = static_cast<Word16>(PackFloatTo16(
+				g_PackFloatsReference[i] * ((i & 1) ? 1.0f : 1.0e-30f),
+				uBaseExponent));
+		} while (++i < 0x10000);
+		k = 0;
+		do {
+			CPUDispatch::SetFamilyFeatureMask(
+				CPUDispatch::kFamilyMath, s_Masks[k]);
+			float Floats[259];
+			Unpack16ToFloats(Floats,
+				reinterpret_cast<const Int16*>(g_PackHalfsReference + 1000),
+				BURGER_ARRAYSIZE(Floats), uBaseExponent);
+			Word uTest = MemoryCompare(
+							 Floats, g_PackFloats + 1000, sizeof(Floats)) != 0;
+			uFailure |= uTest;
+			ReportFailure("Unpack16ToFloats() mask 0x%08X exponent %u", uTest,
+				s_Masks[k], uBaseExponent);
+
+			Int16 Packed[259];
+			float Scaled[259];
+			WordPtr j = 0;
+			do {
+				Scaled[j] = g_PackFloatsReference[2000 + j] *
+					(((2000 + j) & 1) ? 1.0f : 1.0e-30f);
+			} while (++j < BURGER_ARRAYSIZE(Scaled));
+			PackFloatsTo16(
+				Packed, Scaled, BURGER_ARRAYSIZE(Packed), uBaseExponent);
+			uTest =
+				MemoryCompare(Packed, g_PackHalfs + 2000, sizeof(Packed)) != 0;
+			uFailure |= uTest;
+			ReportFailure("PackFloatsTo16() mask 0x%08X exponent %u", uTest,
+				s_Masks[k], uBaseExponent);
+		} while (++k < BURGER_ARRAYSIZE(s_Masks));
+	} while (++e < BURGER_ARRAYSIZE(s_Exponents));
+	CPUDispatch::ResetFeatureMasks();
+	return uFailure;
+}
+
+//
+// Show the half float conversion speed for each instruction set
+//
+
+static void TimePackFloat(void)
+{
+	Word32 uSeed = 0x2545F491U;
+	WordPtr i = 0;
+	do {
+		uSeed = (uSeed * 1103515245U) + 12345U;
+		g_PackFloats[i] = static_cast<float>(static_cast<Int32>(uSeed)) *
+			(1.0f / 2147483648.0f);
+	} while (++i < 0x10000);
+
+	static const Word32 s_Masks[] = {
+		0, CPUDispatch::kSSE2, CPUDispatch::kAllFeatures};
+	const Word uIterations = 200;
+	WordPtr k = 0;
+	do {
+		CPUDispatch::SetFamilyFeatureMask(CPUDispatch::kFamilyMath, s_Masks[k]);
+		Word32 uStart = Tick::ReadMicroseconds();
+		Word j = 0;
+		do {
+			PackFloatsToHalf(g_PackHalfs, g_PackFloats, 0x10000);
+		} while (++j < uIterations);
+		Word32 uPack = Tick::ReadMicroseconds() - uStart;
+		uStart = Tick::ReadMicroseconds();
+		j = 0;
+		do {
+			UnpackHalfToFloats(g_PackFloatsReference, g_PackHalfs, 0x10000);
+		} while (++j < uIterations);
+		Word32 uUnpack = Tick::ReadMicroseconds() - uStart;
+		uStart = Tick::ReadMicroseconds();
+		j = 0;
+		do {
+			PackFloatsTo16(reinterpret_cast<Int16*>(g_PackHalfs),
+				g_PackFloats, 0x10000);
+		} while (++j < uIterations);
+		Word32 uPack16 = Tick::ReadMicroseconds() - uStart;
+		Message(
+			"Half floats mask 0x%08X, pack %u, unpack %u, base exponent pack %u million/s",
+			s_Masks[k],
+			static_cast<Word>((0x10000U * uIterations) / (uPack + 1)),
+			static_cast<Word>((0x10000U * uIterations) / (uUnpack + 1)),
+			static_cast<Word>((0x10000U * uIterations) / (uPack16 + 1)));
+	} while (++k < BURGER_ARRAYSIZE(s_Masks));
+	CPUDispatch::ResetFeatureMasks();
+}
+
 //
 // Test compression code
 //
@@ -1008,6 +3338,28 @@ int BURGER_API TestBrcompression(Word uVerbose)
 		uResult |= TestLZSSCompress();
 		uResult |= TestDeflateDecompress();
 		uResult |= TestDeflateCompress();
+		uResult |= TestDeflateLevels();
+		uResult |= TestDeflateParallel();
+		uResult |= TestDeflateChunks();
+		uResult |= TestSimpleDecompressDeflate();
+		uResult |= TestDeflateDictionary();
+		uResult |= TestRezFileDictionary();
+		uResult |= TestRezFileMapped();
+		uResult |= TestLZ4();
+		uResult |= TestDecompressStream();
+		uResult |= TestLZSSChains();
+		uResult |= TestDXT();
+		uResult |= TestDXTDecode();
+		uResult |= TestBC7();
+		uResult |= TestPackFloat();
+		if (!uResult && (uVerbose & VERBOSE_TIME)) {
+			TimeDeflateLevels();
+			TimeDeflateDecompress();
+			TimeLZ4();
+			TimeLZSS();
+			TimeDXT();
+			TimePackFloat();
+		}
 		if (!uResult && (uVerbose & VERBOSE_MSG)) {
 			Message("Passed all Compression tests!");
 		}
@@ -14,6 +14,7 @@
 
 #include "testbrendian.h"
 #include "brendian.h"
+#include "brcpudispatch.h"
 #include "brmemoryfunctions.h"
 #include "common.h"
 
@@ -4593,6 +4594,190 @@ static uint_t BURGER_API TestBurgerLittleEndianFixupAnyDoublePtr(void)
     return uFailureTotal;
 }
 
+//
+// Burger::ConvertEndian() and Burger::SwapEndian::ConvertArray()
+//
+// Test a range of counts and starting offsets so the SIMD blocks and the
+// scalar tails are all exercised
+//
+
+static uint_t BURGER_API TestBurgerConvertEndian16(void)
+{
+    uint16_t Source[80];
+    uint16_t Output[80];
+    uint16_t InPlace[80];
+    uint_t uFailureTotal = FALSE;
+    uintptr_t i = 0;
+    do {
+        Source[i] = static_cast<uint16_t>((i * 0x1357U) ^ 0xA5C3U);
+    } while (++i < BURGER_ARRAYSIZE(Source));
+
+    uintptr_t uOffset = 0;
+    do {
+        uintptr_t uCount = 0;
+        do {
+            Burger::MemoryClear(Output, sizeof(Output));
+            Burger::MemoryCopy(InPlace, Source, sizeof(InPlace));
+            Burger::ConvertEndian(Output + uOffset, Source + uOffset, uCount);
+            Burger::SwapEndian::FixupArray(InPlace + uOffset, uCount);
+            uint_t uFailure = FALSE;
+            i = 0;
+            do {
+                uint16_t uExpected = 0;
+                uint16_t uInPlace = Source[i];
+                if ((i >= uOffset) && (i < (uOffset + uCount))) {
+                    uExpected = Burger::SwapEndian::Load(Source[i]);
+                    uInPlace = uExpected;
+                }
+                uFailure |= (Output[i] != uExpected);
+                uFailure |= (InPlace[i] != uInPlace);
+            } while (++i < BURGER_ARRAYSIZE(Source));
+            uFailureTotal |= uFailure;
+            ReportFailure("Burger::ConvertEndian(uint16_t *,const uint16_t *,%u) offset %u",
+                uFailure, static_cast<uint_t>(uCount),
+                static_cast<uint_t>(uOffset));
+        } while (++uCount <= 70);
+    } while (++uOffset < 8);
+    return uFailureTotal;
+}
+
+static uint_t BURGER_API TestBurgerConvertEndian32(void)
+{
+    uint32_t Source[72];
+    uint32_t Output[72];
+    uint32_t InPlace[72];
+    uint_t uFailureTotal = FALSE;
+    uintptr_t i = 0;
+    do {
+        Source[i] = static_cast<uint32_t>((i * 0x13579BDFU) ^ 0xA5C3E1F0U);
+    } while (++i < BURGER_ARRAYSIZE(Source));
+
+    uintptr_t uOffset = 0;
+    do {
+        uintptr_t uCount = 0;
+        do {
+            Burger::MemoryClear(Output, sizeof(Output));
+            Burger::MemoryCopy(InPlace, Source, sizeof(InPlace));
+            Burger::SwapEndian::ConvertArray(
+                Output + uOffset, Source + uOffset, uCount);
+            Burger::ConvertEndian(InPlace + uOffset, uCount);
+            uint_t uFailure = FALSE;
+            i = 0;
+            do {
+                uint32_t uExpected = 0;
+                uint32_t uInPlace = Source[i];
+                if ((i >= uOffset) && (i < (uOffset + uCount))) {
+                    uExpected = Burger::SwapEndian::Load(Source[i]);
+                    uInPlace = uExpected;
+                }
+                uFailure |= (Output[i] != uExpected);
+                uFailure |= (InPlace[i] != uInPlace);
+            } while (++i < BURGER_ARRAYSIZE(Source));
+            uFailureTotal |= uFailure;
+            ReportFailure("Burger::ConvertEndian(uint32_t *,const uint32_t *,%u) offset %u",
+                uFailure, static_cast<uint_t>(uCount),
+                static_cast<uint_t>(uOffset));
+        } while (++uCount <= 64);
+    } while (++uOffset < 8);
+    return uFailureTotal;
+}
+
+static uint_t BURGER_API TestBurgerConvertEndian64(void)
+{
+    uint64_t Source[40];
+    uint64_t Output[40];
+    uint64_t InPlace[40];
+    uint_t uFailureTotal = FALSE;
+    uintptr_t i = 0;
+    do {
+        Source[i] = (static_cast<uint64_t>(i) * 0x0123456789ABCDEFULL) ^
+            0xF0E1D2C3B4A59687ULL;
+    } while (++i < BURGER_ARRAYSIZE(Source));
+
+    uintptr_t uOffset = 0;
+    do {
+        uintptr_t uCount = 0;
+        do {
+            Burger::MemoryClear(Output, sizeof(Output));
+            Burger::MemoryCopy(InPlace, Source, sizeof(InPlace));
+            Burger::ConvertEndian(Output + uOffset, Source + uOffset, uCount);
+            Burger::ConvertEndian(InPlace + uOffset, uCount);
+            uint_t uFailure = FALSE;
+            i = 0;
+            do {
+                uint64_t uExpected = 0;
+                uint64_t uInPlace = Source[i];
+                if ((i >= uOffset) && (i < (uOffset + uCount))) {
+                    uExpected = Burger::SwapEndian::Load(Source[i]);
+                    uInPlace = uExpected;
+                }
+                uFailure |= (Output[i] != uExpected);
+                uFailure |= (InPlace[i] != uInPlace);
+            } while (++i < BURGER_ARRAYSIZE(Source));
+            uFailureTotal |= uFailure;
+            ReportFailure("Burger::ConvertEndian(uint64_t *,const uint64_t *,%u) offset %u",
+                uFailure, static_cast<uint_t>(uCount),
+                static_cast<uint_t>(uOffset));
+        } while (++uCount <= 32);
+    } while (++uOffset < 8);
+    return uFailureTotal;
+}
+
+//
+// Make sure the unaligned forms work and NativeEndian only copies
+//
+
+static uint_t BURGER_API TestBurgerConvertArrayUnaligned(void)
+{
+    uint8_t Source[(33 * 4) + 4];
+    uint8_t Output[(33 * 4) + 4];
+    uintptr_t i = 0;
+    do {
+        Source[i] = static_cast<uint8_t>(i * 7U);
+    } while (++i < sizeof(Source));
+
+    uint_t uFailureTotal = FALSE;
+    uintptr_t uOffset = 1;
+    do {
+        Burger::MemoryClear(Output, sizeof(Output));
+        Burger::ConvertEndian(reinterpret_cast<uint32_t*>(Output + uOffset),
+            reinterpret_cast<const uint32_t*>(Source + uOffset), 33);
+        uint_t uFailure = FALSE;
+        i = 0;
+        do {
+            uintptr_t uIndex = uOffset + (i * 4);
+            uFailure |= (Output[uIndex] != Source[uIndex + 3]);
+            uFailure |= (Output[uIndex + 1] != Source[uIndex + 2]);
+            uFailure |= (Output[uIndex + 2] != Source[uIndex + 1]);
+            uFailure |= (Output[uIndex + 3] != Source[uIndex]);
+        } while (++i < 33);
+        uFailureTotal |= uFailure;
+        ReportFailure("Burger::ConvertEndian(uint32_t *,const uint32_t *,33) unaligned offset %u",
+            uFailure, static_cast<uint_t>(uOffset));
+    } while (++uOffset < 4);
+
+    float fNative[5] = {1.0f, -2.5f, 3.25f, 100.0f, -0.125f};
+    float fOutput[5];
+    Burger::NativeEndian::ConvertArray(fOutput, fNative, 5);
+    Burger::NativeEndian::FixupArray(fOutput, 5);
+    uint_t uFailure =
+        static_cast<uint_t>(Burger::MemoryCompare(fOutput, fNative, sizeof(fNative)) != 0);
+    Burger::SwapEndian::ConvertArray(fOutput, fNative, 5);
+    Burger::SwapEndian::FixupArray(fOutput, 5);
+    uFailure |=
+        static_cast<uint_t>(Burger::MemoryCompare(fOutput, fNative, sizeof(fNative)) != 0);
+    uFailureTotal |= uFailure;
+    ReportFailure("Burger::NativeEndian::ConvertArray(float *,const float *,5)",
+        uFailure);
+    return uFailureTotal;
+}
+
+// Feature masks to force each variant of ConvertEndian()
+
+static const uint32_t g_DispatchMasks[] = {0, Burger::CPUDispatch::kSSE2,
+    Burger::CPUDispatch::kSSE2 | Burger::CPUDispatch::kSSSE3,
+    Burger::CPUDispatch::kAllFeatures};
+
 //
 // Perform all the tests for the Burgerlib Endian Manager
 //
@@ -4832,6 +5017,24 @@ int BURGER_API TestBrendian(uint_t uVerbose)
     uTotal |= TestBurgerLittleEndianFixupAnyFloatPtr();
     uTotal |= TestBurgerLittleEndianFixupAnyDoublePtr();
 
+    // ConvertEndian() and ConvertArray(), force every SIMD variant
+    uintptr_t i = 0;
+    do {
+        uint32_t uMask = g_DispatchMasks[i];
+        Burger::CPUDispatch::SetFamilyFeatureMask(
+            Burger::CPUDispatch::kFamilyMemory, uMask);
+        if (uVerbose & VERBOSE_MSG) {
+            Message("Testing ConvertEndian() with features 0x%04X",
+                Burger::CPUDispatch::GetFeatures(
+                    Burger::CPUDispatch::kFamilyMemory));
+        }
+        uTotal |= TestBurgerConvertEndian16();
+        uTotal |= TestBurgerConvertEndian32();
+        uTotal |= TestBurgerConvertEndian64();
+        uTotal |= TestBurgerConvertArrayUnaligned();
+    } while (++i < BURGER_ARRAYSIZE(g_DispatchMasks));
+    Burger::CPUDispatch::ResetFeatureMasks();
+
     if (!uTotal && (uVerbose & VERBOSE_MSG)) {
         Message("Passed all Endian tests!");
     }
@@ -0,0 +1,454 @@
+/***************************************
+
+	Unit tests for the grid index classes
+
+    Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+    It is released under an MIT Open Source license. Please see LICENSE for
+    license details. Yes, you can use it in a commercial title without paying
+    anything, just give me a credit.
+
+    Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrgridindex.h"
+#include "brgridindex.h"
+#include "brmemoryfunctions.h"
+#include "brrandom.h"
+#include "common.h"
+
+using namespace Burger;
+
+//
+// Enough items so Build() splits the work into 4 threads
+//
+
+static const WordPtr g_uGridItemCount = 20000;
+static const Word g_uGridThreadCount = 4;
+static const WordPtr g_uGridQueryCount = 64;
+static Vector2D_t g_GridPoints[g_uGridItemCount];
+static Vector4D_t g_GridBoxes[g_uGridItemCount];
+static Word g_GridValues[g_uGridItemCount];
+static Word8 g_GridMarks[g_uGridItemCount];
+static Vector2D_t g_GridQueryPoints[g_uGridQueryCount];
+static Vector4D_t g_GridQueryBoxes[g_uGridQueryCount];
+static GridIndexSpan_t g_GridSpans[g_uGridItemCount];
+
+//
+// Create a random box inside of the bounds, sized in cells.
+// Every eighth one is in the last few cells to test the far edges.
+//
+
+static void MakeGridBox(Vector4D_t *pOutput, Random *pRandom,
+	const Vector4D_t *pBounds, Word uXCells, Word uYCells, WordPtr uIndex,
+	float fMaxCells)
+{
+	float fWidth = pBounds->GetWidth();
+	float fHeight = pBounds->GetHeight();
+	float fCellWidth = fWidth / static_cast<float>(static_cast<int>(uXCells));
+	float fCellHeight =
+		fHeight / static_cast<float>(static_cast<int>(uYCells));
+	if (!(uIndex & 7)) {
+		pOutput->x = pBounds->z - pRandom->GetFloat(fCellWidth * 16.0f);
+		pOutput->y = pBounds->w - pRandom->GetFloat(fCellHeight * 16.0f);
+	} else {
+		pOutput->x = pBounds->x + pRandom->GetFloat(fWidth);
+		pOutput->y = pBounds->y + pRandom->GetFloat(fHeight);
+	}
+	// A few boxes are large or hang off the edges of the grid
+	if (!(uIndex % 97)) {
+		fMaxCells *= 20.0f;
+	}
+	pOutput->z = pOutput->x + pRandom->GetFloat(fCellWidth * fMaxCells);
+	pOutput->w = pOutput->y + pRandom->GetFloat(fCellHeight * fMaxCells);
+}
+
+//
+// g_GridMarks has a 1 for every item the brute force test found.
+// Mark each found item with a 2, fail on items that weren't expected
+// or found twice.
+//
+
+static Word MarkFound(WordPtr uItem)
+{
+	if ((uItem >= g_uGridItemCount) || (g_GridMarks[uItem] != 1)) {
+		return TRUE;
+	}
+	g_GridMarks[uItem] = 2;
+	return FALSE;
+}
+
+//
+// Fail on any item that was expected and not found, then clear the marks
+//
+
+static Word CheckMarks(Word uFailure, const char *pName)
+{
+	WordPtr i = 0;
+	do {
+		if (g_GridMarks[i] == 1) {
+			uFailure = TRUE;
+		}
+		g_GridMarks[i] = 0;
+	} while (++i < g_uGridItemCount);
+	ReportFailure("%s doesn't match the brute force test", uFailure, pName);
+	return uFailure;
+}
+
+//
+// Return the cell a point is sorted into
+//
+
+static void GetCell(
+	Word *pX, Word *pY, const GridIndexPoints *pGrid, const Vector2D_t *pPoint)
+{
+	Vector2D_t vCell;
+	pGrid->GetContainingCellClamped(&vCell, pPoint);
+	pX[0] = static_cast<Word>(static_cast<int>(vCell.x));
+	pY[0] = static_cast<Word>(static_cast<int>(vCell.y));
+}
+
+//
+// Test GridIndexPoints::Build() and the queries on the packed data
+//
+
+static Word TestGridPoints(Word bRandomCount)
+{
+	Word uFailure = FALSE;
+	Random MyRandom(bRandomCount ? 0x2468U : 0x1357U);
+	Vector4D_t Bounds;
+	Bounds.Set(-100.0f, 50.0f, 900.0f, 800.0f);
+	// An odd number of points leaves a remainder for the last thread
+	WordPtr uCount = bRandomCount ? g_uGridItemCount - 3 : g_uGridItemCount;
+
+	WordPtr i = 0;
+	do {
+		Vector2D_t *pPoint = &g_GridPoints[i];
+		pPoint->x = Bounds.x + MyRandom.GetFloat(Bounds.GetWidth());
+		pPoint->y = Bounds.y + MyRandom.GetFloat(Bounds.GetHeight());
+		// Some points are on the edges or off the grid
+		if (!(i % 101)) {
+			pPoint->x = Bounds.z + MyRandom.GetSymmetricFloat(10.0f);
+		}
+		if (!(i % 103)) {
+			pPoint->y = Bounds.y + MyRandom.GetSymmetricFloat(10.0f);
+		}
+		g_GridValues[i] = static_cast<Word>(i);
+	} while (++i < uCount);
+
+	GridIndexPoints Single(&Bounds, uCount);
+	GridIndexPoints Multi(&Bounds, uCount);
+	Word uXCells = Single.GetXCells();
+	Word uYCells = Single.GetYCells();
+	Word uTest =
+		(Single.Build(g_GridPoints, g_GridValues, uCount, 1) != kErrorNone) ||
+		(Multi.Build(g_GridPoints, g_GridValues, uCount, g_uGridThreadCount) !=
+			kErrorNone) ||
+		(Single.GetPackedCount() != uCount) ||
+		(Multi.GetPackedCount() != uCount);
+	ReportFailure("GridIndexPoints::Build() failed", uTest);
+	uFailure |= uTest;
+	if (uTest) {
+		return uFailure;
+	}
+
+	// The threaded build must create the same arrays
+	uTest = MemoryCompare(Single.GetPackedX(), Multi.GetPackedX(),
+				sizeof(float) * uCount) ||
+		MemoryCompare(Single.GetPackedY(), Multi.GetPackedY(),
+			sizeof(float) * uCount) ||
+		MemoryCompare(Single.GetPackedValues(), Multi.GetPackedValues(),
+			sizeof(Word) * uCount);
+	Word uY = 0;
+	do {
+		Word uX = 0;
+		do {
+			GridIndexSpan_t Span1 = Single.GetCellSpan(uX, uY);
+			GridIndexSpan_t Span2 = Multi.GetCellSpan(uX, uY);
+			if ((Span1.m_uStart != Span2.m_uStart) ||
+				(Span1.m_uCount != Span2.m_uCount)) {
+				uTest = TRUE;
+			}
+			// Every entry is in the right cell and in the order passed
+			WordPtr uEnd = Span1.m_uStart + Span1.m_uCount;
+			WordPtr j = Span1.m_uStart;
+			while (j < uEnd) {
+				Word uValue = Single.GetPackedValues()[j];
+				Word uCellX;
+				Word uCellY;
+				GetCell(&uCellX, &uCellY, &Single, &g_GridPoints[uValue]);
+				if ((uCellX != uX) || (uCellY != uY) ||
+					((j != Span1.m_uStart) &&
+						(Single.GetPackedValues()[j - 1] >= uValue))) {
+					uTest = TRUE;
+				}
+				++j;
+			}
+		} while (++uX < uXCells);
+	} while (++uY < uYCells);
+	ReportFailure(
+		"GridIndexPoints::Build() with %u threads doesn't match one thread",
+		uTest, g_uGridThreadCount);
+	uFailure |= uTest;
+
+	// Every point is in the span of its own cell
+	Single.QueryPoints(g_GridSpans, g_GridPoints, uCount);
+	uTest = FALSE;
+	i = 0;
+	do {
+		const GridIndexSpan_t *pSpan = &g_GridSpans[i];
+		Word uX;
+		GetCell(&uX, &uY, &Single, &g_GridPoints[i]);
+		GridIndexSpan_t Cell = Single.GetCellSpan(uX, uY);
+		if ((pSpan->m_uStart != Cell.m_uStart) ||
+			(pSpan->m_uCount != Cell.m_uCount)) {
+			uTest = TRUE;
+		} else {
+			WordPtr j = 0;
+			while ((j < pSpan->m_uCount) &&
+				(Single.GetPackedValues()[pSpan->m_uStart + j] != i)) {
+				++j;
+			}
+			uTest |= (j == pSpan->m_uCount);
+		}
+	} while (++i < uCount);
+	ReportFailure("GridIndexPoints::QueryPoints() returned the wrong cells",
+		uTest);
+	uFailure |= uTest;
+
+	// Random rectangles, some overlapping the edges of the grid
+	i = 0;
+	do {
+		MakeGridBox(&g_GridQueryBoxes[i], &MyRandom, &Bounds, uXCells,
+			uYCells, i + 1, 8.0f);
+		g_GridQueryBoxes[i].x -= 5.0f;
+	} while (++i < g_uGridQueryCount);
+	// One query covers the whole grid
+	g_GridQueryBoxes[0].Set(Bounds.x - 20.0f, Bounds.y - 20.0f,
+		Bounds.z + 20.0f, Bounds.w + 20.0f);
+
+	// The row spans cover exactly the cells touched by the rectangle
+	GridIndexSpan_t RowSpans[256];
+	BURGER_ASSERT(uYCells <= BURGER_ARRAYSIZE(RowSpans));
+	i = 0;
+	do {
+		const Vector4D_t *pQuery = &g_GridQueryBoxes[i];
+		Word uLeft;
+		Word uTop;
+		Word uRight;
+		Word uBottom;
+		GetCell(&uLeft, &uTop, &Single, pQuery->GetTopLeft());
+		GetCell(&uRight, &uBottom, &Single, pQuery->GetBottomRight());
+		WordPtr uSpans = Single.GetRowSpans(RowSpans, pQuery);
+		WordPtr j = 0;
+		do {
+			Word uCellX;
+			Word uCellY;
+			GetCell(&uCellX, &uCellY, &Single, &g_GridPoints[j]);
+			g_GridMarks[j] = static_cast<Word8>((uCellX >= uLeft) &&
+				(uCellX <= uRight) && (uCellY >= uTop) && (uCellY <= uBottom));
+		} while (++j < uCount);
+		uTest = uSpans > uYCells;
+		j = 0;
+		while (j < uSpans) {
+			WordPtr k = 0;
+			uTest |= !RowSpans[j].m_uCount;
+			while (k < RowSpans[j].m_uCount) {
+				uTest |= MarkFound(
+					Single.GetPackedValues()[RowSpans[j].m_uStart + k]);
+				++k;
+			}
+			++j;
+		}
+		uFailure |= CheckMarks(uTest, "GridIndexPoints::GetRowSpans()");
+	} while (++i < g_uGridQueryCount);
+
+	// Exact point in rectangle tests
+	SimpleArray<WordPtr> Indexes;
+	Multi.QueryBoxes(g_GridSpans, &Indexes, g_GridQueryBoxes, g_uGridQueryCount);
+	i = 0;
+	do {
+		const Vector4D_t *pQuery = &g_GridQueryBoxes[i];
+		WordPtr j = 0;
+		do {
+			const Vector2D_t *pPoint = &g_GridPoints[j];
+			g_GridMarks[j] = static_cast<Word8>((pPoint->x >= pQuery->x) &&
+				(pPoint->x <= pQuery->z) && (pPoint->y >= pQuery->y) &&
+				(pPoint->y <= pQuery->w));
+		} while (++j < uCount);
+		uTest = FALSE;
+		j = 0;
+		while (j < g_GridSpans[i].m_uCount) {
+			uTest |= MarkFound(Multi.GetPackedValues()[Indexes[g_GridSpans[i].m_uStart + j]]);
+			++j;
+		}
+		uFailure |= CheckMarks(uTest, "GridIndexPoints::QueryBoxes()");
+	} while (++i < g_uGridQueryCount);
+
+	// An empty build finds nothing
+	uTest = Multi.Build(g_GridPoints, g_GridValues, 0, g_uGridThreadCount) !=
+		kErrorNone;
+	Multi.QueryBoxes(g_GridSpans, &Indexes, g_GridQueryBoxes, 1);
+	uTest |= (Multi.GetRowSpans(RowSpans, g_GridQueryBoxes) != 0) ||
+		(g_GridSpans[0].m_uCount != 0) || (Indexes.size() != 0);
+	ReportFailure("GridIndexPoints::Build() with no points failed", uTest);
+	uFailure |= uTest;
+	return uFailure;
+}
+
+//
+// Test GridIndexBox::Build() and the queries on the packed data
+//
+
+static Word TestGridBoxes(
+	const Vector4D_t *pBounds, Word uXCells, Word uYCells, Word32 uSeed)
+{
+	Word uFailure = FALSE;
+	Random MyRandom(uSeed);
+
+	WordPtr i = 0;
+	do {
+		MakeGridBox(&g_GridBoxes[i], &MyRandom, pBounds, uXCells, uYCells, i,
+			3.0f);
+		g_GridValues[i] = static_cast<Word>(i * 3);
+	} while (++i < g_uGridItemCount);
+
+	GridIndexBox Single(pBounds, uXCells, uYCells);
+	GridIndexBox Multi(pBounds, uXCells, uYCells);
+	Word uTest = (Single.Build(g_GridBoxes, g_GridValues, g_uGridItemCount,
+					  1) != kErrorNone) ||
+		(Multi.Build(g_GridBoxes, g_GridValues, g_uGridItemCount,
+			 g_uGridThreadCount) != kErrorNone) ||
+		(Single.GetPackedCount() != g_uGridItemCount) ||
+		(Multi.GetPackedCount() != g_uGridItemCount);
+	ReportFailure("GridIndexBox::Build() with a %u by %u grid failed", uTest,
+		uXCells, uYCells);
+	uFailure |= uTest;
+	if (uTest) {
+		return uFailure;
+	}
+
+	// The threaded build must create the same arrays
+	GridIndexSpan_t Last = Single.GetCellSpan(uXCells - 1, uYCells - 1);
+	WordPtr uItemCount = Last.m_uStart + Last.m_uCount;
+	uTest = MemoryCompare(Single.GetPackedLeft(), Multi.GetPackedLeft(),
+				sizeof(float) * g_uGridItemCount) ||
+		MemoryCompare(Single.GetPackedTop(), Multi.GetPackedTop(),
+			sizeof(float) * g_uGridItemCount) ||
+		MemoryCompare(Single.GetPackedRight(), Multi.GetPackedRight(),
+			sizeof(float) * g_uGridItemCount) ||
+		MemoryCompare(Single.GetPackedBottom(), Multi.GetPackedBottom(),
+			sizeof(float) * g_uGridItemCount) ||
+		MemoryCompare(Single.GetPackedValues(), Multi.GetPackedValues(),
+			sizeof(Word) * g_uGridItemCount) ||
+		MemoryCompare(Single.GetCellItems(), Multi.GetCellItems(),
+			sizeof(WordPtr) * uItemCount);
+	Word uY = 0;
+	do {
+		Word uX = 0;
+		do {
+			GridIndexSpan_t Span1 = Single.GetCellSpan(uX, uY);
+			GridIndexSpan_t Span2 = Multi.GetCellSpan(uX, uY);
+			if ((Span1.m_uStart != Span2.m_uStart) ||
+				(Span1.m_uCount != Span2.m_uCount)) {
+				uTest = TRUE;
+			}
+		} while (++uX < uXCells);
+	} while (++uY < uYCells);
+	ReportFailure(
+		"GridIndexBox::Build() with %u threads doesn't match one thread on a %u by %u grid",
+		uTest, g_uGridThreadCount, uXCells, uYCells);
+	uFailure |= uTest;
+
+	// Box overlap tests, the first query covers everything
+	i = 0;
+	do {
+		MakeGridBox(&g_GridQueryBoxes[i], &MyRandom, pBounds, uXCells,
+			uYCells, i, 12.0f);
+	} while (++i < g_uGridQueryCount);
+	g_GridQueryBoxes[0] = pBounds[0];
+	g_GridQueryBoxes[0].z += 1.0f;
+	SimpleArray<WordPtr> Indexes;
+	Multi.QueryBoxes(g_GridSpans, &Indexes, g_GridQueryBoxes, g_uGridQueryCount);
+	i = 0;
+	do {
+		const Vector4D_t *pQuery = &g_GridQueryBoxes[i];
+		WordPtr j = 0;
+		do {
+			const Vector4D_t *pBox = &g_GridBoxes[j];
+			g_GridMarks[j] = static_cast<Word8>((pBox->x <= pQuery->z) &&
+				(pBox->z >= pQuery->x) && (pBox->y <= pQuery->w) &&
+				(pBox->w >= pQuery->y));
+		} while (++j < g_uGridItemCount);
+		uTest = FALSE;
+		j = 0;
+		while (j < g_GridSpans[i].m_uCount) {
+			uTest |= MarkFound(Indexes[g_GridSpans[i].m_uStart + j]);
+			++j;
+		}
+		uFailure |= CheckMarks(uTest, "GridIndexBox::QueryBoxes()");
+	} while (++i < g_uGridQueryCount);
+
+	// Point in box tests, use the corners of the boxes so edges are hit
+	i = 0;
+	do {
+		Vector2D_t *pPoint = &g_GridQueryPoints[i];
+		const Vector4D_t *pBox = &g_GridBoxes[(i * 7) % g_uGridItemCount];
+		pPoint->x = (i & 1) ? pBox->z : pBox->x;
+		pPoint->y = (i & 2) ? pBox->w : pBox->y;
+	} while (++i < g_uGridQueryCount);
+	Single.QueryPoints(
+		g_GridSpans, &Indexes, g_GridQueryPoints, g_uGridQueryCount);
+	i = 0;
+	do {
+		const Vector2D_t *pPoint = &g_GridQueryPoints[i];
+		WordPtr j = 0;
+		do {
+			const Vector4D_t *pBox = &g_GridBoxes[j];
+			g_GridMarks[j] = static_cast<Word8>((pPoint->x >= pBox->x) &&
+				(pPoint->x <= pBox->z) && (pPoint->y >= pBox->y) &&
+				(pPoint->y <= pBox->w));
+		} while (++j < g_uGridItemCount);
+		uTest = FALSE;
+		j = 0;
+		while (j < g_GridSpans[i].m_uCount) {
+			uTest |= MarkFound(Indexes[g_GridSpans[i].m_uStart + j]);
+			++j;
+		}
+		uFailure |= CheckMarks(uTest, "GridIndexBox::QueryPoints()");
+	} while (++i < g_uGridQueryCount);
+	return uFailure;
+}
+
+//
+// Perform all the tests for the grid index classes
+//
+
+int BURGER_API TestBrgridindex(Word uVerbose)
+{
+	if (uVerbose & VERBOSE_MSG) {
+		Message("Running Grid Index tests");
+	}
+
+	Word uTotal = TestGridPoints(FALSE);
+	uTotal |= TestGridPoints(TRUE);
+
+	Vector4D_t Bounds;
+	Bounds.Set(0.0f, 0.0f, 1000.0f, 1000.0f);
+	uTotal |= TestGridBoxes(&Bounds, 64, 48, 0x1234U);
+
+	// The first cell of a packed box is stored as two 16 bit values,
+	// so test the largest grids Build() allows
+	Bounds.Set(0.0f, 0.0f, 65536.0f, 2.0f);
+	uTotal |= TestGridBoxes(&Bounds, 65536, 2, 0x2345U);
+	Bounds.Set(0.0f, 0.0f, 2.0f, 65536.0f);
+	uTotal |= TestGridBoxes(&Bounds, 2, 65536, 0x3456U);
+	Bounds.Set(0.0f, 0.0f, 65535.0f, 65535.0f);
+	uTotal |= TestGridBoxes(&Bounds, 65535, 3, 0x4567U);
+
+	if (!uTotal && (uVerbose & VERBOSE_MSG)) {
+		Message("Passed all Grid Index tests!");
+	}
+	return static_cast<int>(uTotal);
+}
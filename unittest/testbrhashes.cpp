@@ -16,7 +16,9 @@
 #include "bradler16.h"
 #include "bradler32.h"
 #include "brcrc16.h"
+#include "brcpudispatch.h"
 #include "brcrc32.h"
+#include "brendian.h"
 #include "brfixedpoint.h"
 #include "brgost.h"
 #include "brmd2.h"
@@ -24,7 +26,11 @@
 #include "brmd5.h"
 #include "brnumberstringhex.h"
 #include "brsha1.h"
+#include "brsha256.h"
+#include "brinputmemorystream.h"
+#include "brtick.h"
 #include "brmemoryfunctions.h"
+#include "brmultihash.h"
 #include "common.h"
 
 
@@ -47,6 +53,7 @@ struct HashTest_t {
 	Burger::MD5_t m_HashMD5;
 	Burger::SHA1_t m_HashSHA1;
 	Burger::GOST_t m_HashGOST;
+	Burger::SHA256_t m_HashSHA256;
 	Word16 m_CRC16IBM;
 };
 
@@ -63,6 +70,9 @@ static const HashTest_t g_HashTestTable[] = {
 		{0xce, 0x85, 0xb9, 0x9c, 0xc4, 0x67, 0x52, 0xff, 0xfe, 0xe3, 0x5c, 0xab,
 			0x9a, 0x7b, 0x02, 0x78, 0xab, 0xb4, 0xc2, 0xd2, 0x05, 0x5c, 0xff,
 			0x68, 0x5a, 0xf4, 0x91, 0x2c, 0x49, 0x49, 0x0f, 0x8d},
+		{0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8,
+			0x99, 0x6f, 0xb9, 0x24, 0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93,
+			0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55},
 		0x0000},
 
 	{"a", 0x00006262, 0x00620062, 0x6b9b9319, 0xe8b7be43,
@@ -77,6 +87,9 @@ static const HashTest_t g_HashTestTable[] = {
 		{0xd4, 0x2c, 0x53, 0x9e, 0x36, 0x7c, 0x66, 0xe9, 0xc8, 0x8a, 0x80, 0x1f,
 			0x66, 0x49, 0x34, 0x9c, 0x21, 0x87, 0x1b, 0x43, 0x44, 0xc6, 0xa5,
 			0x73, 0xf8, 0x49, 0xfd, 0xce, 0x62, 0xf3, 0x14, 0xdd},
+		{0xca, 0x97, 0x81, 0x12, 0xca, 0x1b, 0xbd, 0xca, 0xfa, 0xc2, 0x31, 0xb3,
+			0x9a, 0x23, 0xdc, 0x4d, 0xa7, 0x86, 0xef, 0xf8, 0x14, 0x7c, 0x4e,
+			0x72, 0xb9, 0x80, 0x77, 0x85, 0xaf, 0xee, 0x48, 0xbb},
 		0xE8C1},
 
 	{"message digest", 0x0000479F, 0x29750586, 0x5703c9bf, 0x20159d7f,
@@ -91,6 +104,9 @@ static const HashTest_t g_HashTestTable[] = {
 		{0xad, 0x44, 0x34, 0xec, 0xb1, 0x8f, 0x2c, 0x99, 0xb6, 0x0c, 0xbe, 0x59,
 			0xec, 0x3d, 0x24, 0x69, 0x58, 0x2b, 0x65, 0x27, 0x3f, 0x48, 0xde,
 			0x72, 0xdb, 0x2f, 0xde, 0x16, 0xa4, 0x88, 0x9a, 0x4d},
+		{0xf7, 0x84, 0x6f, 0x55, 0xcf, 0x23, 0xe1, 0x4e, 0xeb, 0xea, 0xb5, 0xb4,
+			0xe1, 0x55, 0x0c, 0xad, 0x5b, 0x50, 0x9e, 0x33, 0x48, 0xfb, 0xc4,
+			0xef, 0xa3, 0xa1, 0x41, 0x3d, 0x39, 0x3c, 0xb6, 0x50},
 		0x3B44},
 
 	{"abcdefghijklmnopqrstuvwxyz", 0x00006557, 0x90860b20, 0x9693bf77,
@@ -106,6 +122,9 @@ static const HashTest_t g_HashTestTable[] = {
 		{0x3b, 0x79, 0x17, 0x93, 0x75, 0x40, 0xa4, 0xf3, 0x3f, 0xfc, 0xb5, 0xf3,
 			0x7f, 0x29, 0xe8, 0xa9, 0x92, 0x1b, 0x06, 0x55, 0xd7, 0xfd, 0x56,
 			0x8d, 0x7c, 0xf2, 0x72, 0x91, 0xcb, 0x89, 0x7b, 0xb4},
+		{0x71, 0xc4, 0x80, 0xdf, 0x93, 0xd6, 0xae, 0x2f, 0x1e, 0xfa, 0xd1, 0x44,
+			0x7c, 0x66, 0xc9, 0x52, 0x5e, 0x31, 0x62, 0x18, 0xcf, 0x51, 0xfc,
+			0x8d, 0x9e, 0xd8, 0x32, 0xf2, 0xda, 0xf1, 0x8b, 0x73},
 		0x9C1D},
 
 	{"0123456789ABCDEF", 0x00005CB2, 0x1ccb03a3, 0xef127626, 0x983c37b5,
@@ -120,6 +139,9 @@ static const HashTest_t g_HashTestTable[] = {
 		{0xca, 0xe0, 0xe3, 0xa6, 0x42, 0x63, 0x4a, 0x92, 0xc9, 0x52, 0x71, 0xe5,
 			0xee, 0x94, 0x9b, 0xc5, 0xde, 0x8f, 0x35, 0xf0, 0x2a, 0x1e, 0x1d,
 			0xda, 0x7e, 0xdc, 0x81, 0x58, 0x98, 0xa9, 0xed, 0x9e},
+		{0x21, 0x25, 0xb2, 0xc3, 0x32, 0xb1, 0x11, 0x3a, 0xae, 0x9b, 0xfc, 0x5e,
+			0x9f, 0x7e, 0x3b, 0x4c, 0x91, 0xd8, 0x28, 0xcb, 0x94, 0x2c, 0x2d,
+			0xf1, 0xee, 0xb0, 0x25, 0x02, 0xec, 0xca, 0xe9, 0xe9},
 		0x0F65},
 
 	{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
@@ -135,6 +157,9 @@ static const HashTest_t g_HashTestTable[] = {
 		{0x95, 0xc1, 0xaf, 0x62, 0x7c, 0x35, 0x64, 0x96, 0xd8, 0x02, 0x74, 0x33,
 			0x0b, 0x2c, 0xff, 0x6a, 0x10, 0xc6, 0x7b, 0x5f, 0x59, 0x70, 0x87,
 			0x20, 0x2f, 0x94, 0xd0, 0x6d, 0x23, 0x38, 0xcf, 0x8e},
+		{0xdb, 0x4b, 0xfc, 0xbd, 0x4d, 0xa0, 0xcd, 0x85, 0xa6, 0x0c, 0x3c, 0x37,
+			0xd3, 0xfb, 0xd8, 0x80, 0x5c, 0x77, 0xf1, 0x5f, 0xc6, 0xb1, 0xfd,
+			0xfe, 0x61, 0x4e, 0xe0, 0xa7, 0xc8, 0xfd, 0xb4, 0xc0},
 		0x57B4},
 
 	{"12345678901234567890123456789012345678901234567890123456789012345678901234567890",
@@ -150,6 +175,9 @@ static const HashTest_t g_HashTestTable[] = {
 		{0xcc, 0x17, 0x8d, 0xca, 0xd4, 0xdf, 0x61, 0x9d, 0xca, 0xa0, 0x0a, 0xac,
 			0x79, 0xca, 0x35, 0x5c, 0x00, 0x14, 0x4e, 0x4a, 0xda, 0x27, 0x93,
 			0xd7, 0xbd, 0x9b, 0x35, 0x18, 0xea, 0xd3, 0xcc, 0xd3},
+		{0xf3, 0x71, 0xbc, 0x4a, 0x31, 0x1f, 0x2b, 0x00, 0x9e, 0xef, 0x95, 0x2d,
+			0xd8, 0x3c, 0xa8, 0x0e, 0x2b, 0x60, 0x02, 0x6c, 0x8e, 0x93, 0x55,
+			0x92, 0xd0, 0xf9, 0xc3, 0x08, 0x45, 0x3c, 0x81, 0x3e},
 		0x5EC7},
 
 	{"Let me eat your brain!", 0x000068D1, 0x57ab07ae, 0x88e5a24a, 0xc3fda0e7,
@@ -164,6 +192,9 @@ static const HashTest_t g_HashTestTable[] = {
 		{0x46, 0xcf, 0x15, 0xcf, 0xdc, 0x3b, 0xda, 0x9a, 0x77, 0x5f, 0x3b, 0x33,
 			0xf1, 0xe2, 0x52, 0xa4, 0x68, 0xab, 0x74, 0x14, 0xd6, 0x30, 0xb7,
 			0x13, 0xb1, 0x95, 0xa6, 0x3f, 0xff, 0x3c, 0x66, 0x02},
+		{0xc7, 0x1a, 0x95, 0x1d, 0x8e, 0xec, 0x68, 0x28, 0xf5, 0x69, 0x80, 0x20,
+			0xdc, 0x04, 0xe1, 0xe4, 0x6f, 0x24, 0xdd, 0xf7, 0x19, 0x0f, 0x64,
+			0x66, 0xe0, 0x37, 0x3c, 0x83, 0x1e, 0xa2, 0xb9, 0x5b},
 		0xE287},
 
 	{"Calculate the cyclic redundancy checksum polynomial of 32-bit lengths of the string.",
@@ -179,6 +210,9 @@ static const HashTest_t g_HashTestTable[] = {
 		{0x14, 0x1d, 0x44, 0x14, 0xdd, 0x31, 0xdd, 0x2e, 0x4b, 0xf3, 0xad, 0x4a,
 			0xdd, 0x64, 0x9a, 0xc8, 0x63, 0x8d, 0x4d, 0x80, 0xa7, 0xf1, 0x35,
 			0x5f, 0x71, 0x47, 0x6a, 0xbe, 0x80, 0x79, 0xb5, 0x5c},
+		{0xc5, 0xc6, 0x16, 0xef, 0x77, 0xef, 0x7e, 0xc1, 0x52, 0xfa, 0x97, 0x46,
+			0x03, 0xcf, 0x00, 0xdc, 0x4c, 0x87, 0xcf, 0x4b, 0x66, 0x18, 0xb3,
+			0xf8, 0x52, 0x66, 0xb4, 0xd4, 0x69, 0x4c, 0xc0, 0xcf},
 		0xE367},
 
 	{"The quick brown fox jumps over the lazy dog", 0x0000B72A, 0x5bdc0fda,
@@ -194,6 +228,9 @@ static const HashTest_t g_HashTestTable[] = {
 		{0x77, 0xb7, 0xfa, 0x41, 0x0c, 0x9a, 0xc5, 0x8a, 0x25, 0xf4, 0x9b, 0xca,
 			0x7d, 0x04, 0x68, 0xc9, 0x29, 0x65, 0x29, 0x31, 0x5e, 0xac, 0xa7,
 			0x6b, 0xd1, 0xa1, 0x0f, 0x37, 0x6d, 0x1f, 0x42, 0x94},
+		{0xd7, 0xa8, 0xfb, 0xb3, 0x07, 0xd7, 0x80, 0x94, 0x69, 0xca, 0x9a, 0xbc,
+			0xb0, 0x08, 0x2e, 0x4f, 0x8d, 0x56, 0x51, 0xe4, 0x6d, 0x3c, 0xdb,
+			0x76, 0x2d, 0x02, 0xd0, 0xbf, 0x37, 0xc9, 0xe5, 0x92},
 		0xFCDF}};
 
 //
@@ -291,6 +328,425 @@ static Word TestCRC32(void)
 	return uFailure;
 }
 
+//
+// Test CalcCRC32C()
+//
+
+struct CRC32CTest_t {
+	const char *m_pString;
+	Word32 m_uCRC32C;
+};
+
+static const CRC32CTest_t g_CRC32CTestTable[] = {
+	{"",0x00000000},
+	{"a",0xC1D04330},
+	{"abc",0x364B3FB7},
+	{"123456789",0xE3069283},
+	{"The quick brown fox jumps over the lazy dog",0x22620404}
+};
+
+static Word TestCRC32C(void)
+{
+	Word uFailure = FALSE;
+	const CRC32CTest_t* pWork = g_CRC32CTestTable;
+	WordPtr uCount = BURGER_ARRAYSIZE(g_CRC32CTestTable);
+	do {
+		Word32 uTester = Burger::CalcCRC32C(
+			pWork->m_pString, Burger::StringLength(pWork->m_pString));
+		Word uTest = (uTester != pWork->m_uCRC32C);
+		uFailure |= uTest;
+		if (uTest) {
+			ReportFailure("Burger::CalcCRC32C(\"%s\") = 0x%08X, expected 0x%08X",
+				uTest, pWork->m_pString, uTester, pWork->m_uCRC32C);
+		}
+		++pWork;
+	} while (--uCount);
+	return uFailure;
+}
+
+//
+// Bit at a time reference versions of the CRCs
+//
+
+static Word32 ReferenceCRC32B(const Word8 *pInput,WordPtr uLength,Word32 uPolynomial)
+{
+	Word32 uCRC = 0xFFFFFFFFU;
+	while (uLength) {
+		uCRC ^= pInput[0];
+		Word i = 8;
+		do {
+			uCRC = (uCRC>>1U)^((0U-(uCRC&1U))&uPolynomial);
+		} while (--i);
+		++pInput;
+		--uLength;
+	}
+	return ~uCRC;
+}
+
+static Word32 ReferenceCRC32(const Word8 *pInput,WordPtr uLength)
+{
+	Word32 uCRC = 0xFFFFFFFFU;
+	while (uLength) {
+		uCRC ^= static_cast<Word32>(pInput[0])<<24U;
+		Word i = 8;
+		do {
+			uCRC = (uCRC<<1U)^((0U-(uCRC>>31U))&0x04C11DB7U);
+		} while (--i);
+		++pInput;
+		--uLength;
+	}
+	return ~Burger::SwapEndian::Load(uCRC);
+}
+
+// Random data for the block tests
+
+static Word8 g_HashBuffer[65536];
+
+//
+// Compare the optimized CRCs against the references with every
+// length and alignment the slicing and folding code cares about
+//
+
+static const WordPtr g_CRCLengths[] = {
+	0,1,2,3,4,7,8,9,15,16,17,31,32,33,47,48,63,64,65,79,80,
+	127,128,129,191,192,255,256,257,1000,1023,1024,4096,4099
+};
+
+static Word TestCRC32Slicing(const Word8 *pBuffer)
+{
+	Word uFailure = FALSE;
+	WordPtr i = 0;
+	do {
+		WordPtr uLength = g_CRCLengths[i];
+		WordPtr uOffset = 0;
+		do {
+			const Word8 *pInput = pBuffer+uOffset;
+			Word32 uExpected = ReferenceCRC32B(pInput,uLength,0xEDB88320U);
+			Word32 uTester = Burger::CalcCRC32B(pInput,uLength);
+			Word uTest = (uTester != uExpected);
+			if (!uTest) {
+				// Chain two halves
+				WordPtr uHalf = uLength>>1U;
+				uTester = Burger::CalcCRC32B(pInput+uHalf,uLength-uHalf,
+					Burger::CalcCRC32B(pInput,uHalf));
+				uTest = (uTester != uExpected);
+			}
+			uFailure |= uTest;
+			if (uTest) {
+				ReportFailure("Burger::CalcCRC32B(%u bytes at %u) = 0x%08X, expected 0x%08X",
+					uTest, static_cast<Word>(uLength), static_cast<Word>(uOffset), uTester, uExpected);
+			}
+
+			uExpected = ReferenceCRC32B(pInput,uLength,0x82F63B78U);
+			uTester = Burger::CalcCRC32C(pInput,uLength);
+			uTest = (uTester != uExpected);
+			if (!uTest) {
+				WordPtr uHalf = uLength>>1U;
+				uTester = Burger::CalcCRC32C(pInput+uHalf,uLength-uHalf,
+					Burger::CalcCRC32C(pInput,uHalf));
+				uTest = (uTester != uExpected);
+			}
+			uFailure |= uTest;
+			if (uTest) {
+				ReportFailure("Burger::CalcCRC32C(%u bytes at %u) = 0x%08X, expected 0x%08X",
+					uTest, static_cast<Word>(uLength), static_cast<Word>(uOffset), uTester, uExpected);
+			}
+
+			uExpected = ReferenceCRC32(pInput,uLength);
+			uTester = Burger::CalcCRC32(pInput,uLength);
+			uTest = (uTester != uExpected);
+			uFailure |= uTest;
+			if (uTest) {
+				ReportFailure("Burger::CalcCRC32(%u bytes at %u) = 0x%08X, expected 0x%08X",
+					uTest, static_cast<Word>(uLength), static_cast<Word>(uOffset), uTester, uExpected);
+			}
+		} while (++uOffset<16);
+	} while (++i<BURGER_ARRAYSIZE(g_CRCLengths));
+	return uFailure;
+}
+
+//
+// Reference version of Adler-32, a modulo per byte
+//
+
+static Word32 ReferenceAdler32(const Word8 *pInput,WordPtr uLength,Word32 uAdler32)
+{
+	Word32 uAdditive = uAdler32&0xFFFFU;
+	Word32 uFactorial = uAdler32>>16U;
+	while (uLength) {
+		uAdditive = (uAdditive+pInput[0])%65521U;
+		uFactorial = (uFactorial+uAdditive)%65521U;
+		++pInput;
+		--uLength;
+	}
+	return (uFactorial<<16U)+uAdditive;
+}
+
+//
+// Reference version of Adler-16, a modulo per byte
+//
+
+static Word ReferenceAdler16(const Word8 *pInput,WordPtr uLength,Word uAdler16)
+{
+	Word32 uAdditive = (uAdler16&0xFFU)%251U;
+	Word32 uFactorial = (uAdler16>>8U)%251U;
+	while (uLength) {
+		uAdditive = (uAdditive+pInput[0])%251U;
+		uFactorial = (uFactorial+uAdditive)%251U;
+		++pInput;
+		--uLength;
+	}
+	return static_cast<Word>((uFactorial<<8U)+uAdditive);
+}
+
+//
+// Compare CalcAdler32() and CalcAdler16() against the references with
+// lengths that cross the vector block and modulo pass boundaries
+//
+
+static const WordPtr g_AdlerLengths[] = {
+	1,15,16,31,32,33,63,64,65,100,5535,5536,5552,5553,5568,5792,5793,5824,11104,
+	11200,65536-15
+};
+
+static Word TestAdlerBlocks(const Word8 *pBuffer)
+{
+	Word uFailure = FALSE;
+	WordPtr i = 0;
+	do {
+		WordPtr uLength = g_AdlerLengths[i];
+		WordPtr uOffset = 0;
+		do {
+			const Word8 *pInput = pBuffer+uOffset;
+			Word32 uExpected = ReferenceAdler32(pInput,uLength,1);
+			Word32 uTester = Burger::CalcAdler32(pInput,uLength);
+			Word uTest = (uTester != uExpected);
+			if (!uTest) {
+				// Chain two halves
+				WordPtr uHalf = uLength>>1U;
+				uTester = Burger::CalcAdler32(pInput+uHalf,uLength-uHalf,
+					Burger::CalcAdler32(pInput,uHalf));
+				uTest = (uTester != uExpected);
+			}
+			uFailure |= uTest;
+			if (uTest) {
+				ReportFailure("Burger::CalcAdler32(%u bytes at %u) = 0x%08X, expected 0x%08X",
+					uTest, static_cast<Word>(uLength), static_cast<Word>(uOffset), uTester, uExpected);
+			}
+			Word uExpected16 = ReferenceAdler16(pInput,uLength,1);
+			Word uTester16 = Burger::CalcAdler16(pInput,uLength);
+			uTest = (uTester16 != uExpected16);
+			if (!uTest) {
+				WordPtr uHalf = uLength>>1U;
+				uTester16 = Burger::CalcAdler16(pInput+uHalf,uLength-uHalf,
+					Burger::CalcAdler16(pInput,uHalf));
+				uTest = (uTester16 != uExpected16);
+			}
+			uFailure |= uTest;
+			if (uTest) {
+				ReportFailure("Burger::CalcAdler16(%u bytes at %u) = 0x%04X, expected 0x%04X",
+					uTest, static_cast<Word>(uLength), static_cast<Word>(uOffset), uTester16, uExpected16);
+			}
+		} while (++uOffset<15);
+	} while (++i<BURGER_ARRAYSIZE(g_AdlerLengths));
+
+	// Worst case for overflow, all bytes are 0xFF and the sums start at 65520
+	Word8 Ones[8192];
+	Burger::MemoryFill(Ones,0xFF,sizeof(Ones));
+	Word32 uExpected = ReferenceAdler32(Ones,sizeof(Ones),0xFFF0FFF0U);
+	Word32 uTester = Burger::CalcAdler32(Ones,sizeof(Ones),0xFFF0FFF0U);
+	Word uTest = (uTester != uExpected);
+	uFailure |= uTest;
+	if (uTest) {
+		ReportFailure("Burger::CalcAdler32(0xFF) = 0x%08X, expected 0x%08X",
+			uTest, uTester, uExpected);
+	}
+	Word uExpected16 = ReferenceAdler16(Ones,sizeof(Ones),0xFAFAU);
+	Word uTester16 = Burger::CalcAdler16(Ones,sizeof(Ones),0xFAFAU);
+	uTest = (uTester16 != uExpected16);
+	uFailure |= uTest;
+	if (uTest) {
+		ReportFailure("Burger::CalcAdler16(0xFF) = 0x%04X, expected 0x%04X",
+			uTest, uTester16, uExpected16);
+	}
+	return uFailure;
+}
+
+//
+// Show the throughput of Adler-32
+//
+
+static void TimeAdler32(const Word8 *pBuffer,WordPtr uLength)
+{
+	const Word uIterations = 1024;
+	Word32 uAdler32 = 0;
+	Word32 uStart = Burger::Tick::ReadMicroseconds();
+	Word i = 0;
+	do {
+		uAdler32 += Burger::CalcAdler32(pBuffer,uLength);
+	} while (++i<uIterations);
+	Word32 uTime = Burger::Tick::ReadMicroseconds()-uStart;
+
+	// Bytes per microsecond is megabytes per second
+	WordPtr uTotal = uLength*uIterations;
+	Message("Features 0x%04X, Adler32 %u MB/s (0x%08X)",
+		Burger::CPUDispatch::GetFeatures(Burger::CPUDispatch::kFamilyHash),
+		static_cast<Word>(uTotal/(uTime+1)),uAdler32);
+}
+
+//
+// Compare HashMultiple() and HashBatch() against hashing one message
+// at a time. The lengths cover the one and two padding block cases and
+// are mixed so the lanes finish at different times.
+//
+
+static const WordPtr g_MultipleLengths[] = {
+	0,1,3,55,56,57,63,64,65,119,120,128,200,1000,4000,17,
+	333,64,0,5000,72,9,250,127,2047,100,31,32,63,511,512,44,
+	1,2,8000,90
+};
+
+static Word TestHashMultiple(const Word8 *pBuffer)
+{
+	const WordPtr uCount = BURGER_ARRAYSIZE(g_MultipleLengths);
+	const void *Inputs[uCount];
+	Burger::MD5_t MD5Expected[uCount];
+	Burger::MD5_t MD5Multiple[uCount];
+	Burger::MD5_t MD5Batch[uCount];
+	Burger::SHA1_t SHA1Expected[uCount];
+	Burger::SHA1_t SHA1Multiple[uCount];
+	Burger::SHA1_t SHA1Batch[uCount];
+
+	WordPtr i = 0;
+	do {
+		Inputs[i] = pBuffer+((i*97)&4095);
+		Burger::Hash(&MD5Expected[i],Inputs[i],g_MultipleLengths[i]);
+		Burger::Hash(&SHA1Expected[i],Inputs[i],g_MultipleLengths[i]);
+	} while (++i<uCount);
+
+	Burger::HashMultiple(MD5Multiple,Inputs,g_MultipleLengths,uCount);
+	Burger::HashBatch(MD5Batch,Inputs,g_MultipleLengths,uCount,4);
+	Burger::HashMultiple(SHA1Multiple,Inputs,g_MultipleLengths,uCount);
+	Burger::HashBatch(SHA1Batch,Inputs,g_MultipleLengths,uCount,4);
+
+	Word uFailure = FALSE;
+	i = 0;
+	do {
+		Word uTest = static_cast<Word>(Burger::MemoryCompare(&MD5Expected[i],&MD5Multiple[i],sizeof(Burger::MD5_t))!=0);
+		uTest |= static_cast<Word>(Burger::MemoryCompare(&MD5Expected[i],&MD5Batch[i],sizeof(Burger::MD5_t))!=0);
+		uFailure |= uTest;
+		if (uTest) {
+			ReportFailure("Burger::HashMultiple(MD5_t) message %u of %u bytes is wrong",
+				uTest, static_cast<Word>(i), static_cast<Word>(g_MultipleLengths[i]));
+		}
+		uTest = static_cast<Word>(Burger::MemoryCompare(&SHA1Expected[i],&SHA1Multiple[i],sizeof(Burger::SHA1_t))!=0);
+		uTest |= static_cast<Word>(Burger::MemoryCompare(&SHA1Expected[i],&SHA1Batch[i],sizeof(Burger::SHA1_t))!=0);
+		uFailure |= uTest;
+		if (uTest) {
+			ReportFailure("Burger::HashMultiple(SHA1_t) message %u of %u bytes is wrong",
+				uTest, static_cast<Word>(i), static_cast<Word>(g_MultipleLengths[i]));
+		}
+	} while (++i<uCount);
+	return uFailure;
+}
+
+//
+// Show the throughput of hashing many small messages
+//
+
+static void TimeHashMultiple(const Word8 *pBuffer)
+{
+	const WordPtr uCount = 512;
+	const WordPtr uLength = 128;
+	const void *Inputs[uCount];
+	WordPtr Lengths[uCount];
+	Burger::MD5_t MD5Hashes[uCount];
+	Burger::SHA1_t SHA1Hashes[uCount];
+	WordPtr i = 0;
+	do {
+		Inputs[i] = pBuffer+(i*uLength);
+		Lengths[i] = uLength;
+	} while (++i<uCount);
+
+	const Word uIterations = 64;
+	Word32 uStart = Burger::Tick::ReadMicroseconds();
+	Word j = 0;
+	do {
+		i = 0;
+		do {
+			Burger::Hash(&MD5Hashes[i],Inputs[i],uLength);
+		} while (++i<uCount);
+	} while (++j<uIterations);
+	Word32 uMD5Single = Burger::Tick::ReadMicroseconds()-uStart;
+
+	uStart = Burger::Tick::ReadMicroseconds();
+	j = 0;
+	do {
+		Burger::HashMultiple(MD5Hashes,Inputs,Lengths,uCount);
+	} while (++j<uIterations);
+	Word32 uMD5Multiple = Burger::Tick::ReadMicroseconds()-uStart;
+
+	uStart = Burger::Tick::ReadMicroseconds();
+	j = 0;
+	do {
+		i = 0;
+		do {
+			Burger::Hash(&SHA1Hashes[i],Inputs[i],uLength);
+		} while (++i<uCount);
+	} while (++j<uIterations);
+	Word32 uSHA1Single = Burger::Tick::ReadMicroseconds()-uStart;
+
+	uStart = Burger::Tick::ReadMicroseconds();
+	j = 0;
+	do {
+		Burger::HashMultiple(SHA1Hashes,Inputs,Lengths,uCount);
+	} while (++j<uIterations);
+	Word32 uSHA1Multiple = Burger::Tick::ReadMicroseconds()-uStart;
+
+	Message("Features 0x%04X, %u x %u byte messages, MD5 %u us, MD5 multiple %u us, SHA-1 %u us, SHA-1 multiple %u us",
+		Burger::CPUDispatch::GetFeatures(Burger::CPUDispatch::kFamilyHash),
+		static_cast<Word>(uCount*uIterations),static_cast<Word>(uLength),
+		uMD5Single,uMD5Multiple,uSHA1Single,uSHA1Multiple);
+}
+
+//
+// Show the throughput of the CRCs
+//
+
+static void TimeCRC32(Word8 *pBuffer,WordPtr uLength)
+{
+	const Word uIterations = 1024;
+	Word32 uCRC = 0;
+
+	Word32 uStart = Burger::Tick::ReadMicroseconds();
+	Word i = 0;
+	do {
+		uCRC += Burger::CalcCRC32B(pBuffer,uLength);
+	} while (++i<uIterations);
+	Word32 uCRC32B = Burger::Tick::ReadMicroseconds()-uStart;
+
+	uStart = Burger::Tick::ReadMicroseconds();
+	i = 0;
+	do {
+		uCRC += Burger::CalcCRC32C(pBuffer,uLength);
+	} while (++i<uIterations);
+	Word32 uCRC32C = Burger::Tick::ReadMicroseconds()-uStart;
+
+	uStart = Burger::Tick::ReadMicroseconds();
+	i = 0;
+	do {
+		uCRC += Burger::CalcCRC32(pBuffer,uLength);
+	} while (++i<uIterations);
+	Word32 uCRC32 = Burger::Tick::ReadMicroseconds()-uStart;
+
+	// Bytes per microsecond is megabytes per second
+	WordPtr uTotal = uLength*uIterations;
+	Message("Features 0x%04X, CRC32B %u MB/s, CRC32C %u MB/s, CRC32 %u MB/s (0x%08X)",
+		Burger::CPUDispatch::GetFeatures(Burger::CPUDispatch::kFamilyCRC),
+		static_cast<Word>(uTotal/(uCRC32B+1)),static_cast<Word>(uTotal/(uCRC32C+1)),
+		static_cast<Word>(uTotal/(uCRC32+1)),uCRC);
+}
+
 //
 // Test CalcCRC16IBM()
 //
@@ -431,6 +887,77 @@ static Word TestSHA1(void)
 	return uFailure;
 }
 
+//
+// Test SHA-256
+//
+
+static Word TestSHA256(void)
+{
+	Word uFailure = FALSE;
+	const HashTest_t* pWork = g_HashTestTable;
+	WordPtr uCount = BURGER_ARRAYSIZE(g_HashTestTable);
+	do {
+		Burger::SHA256_t Tester;
+		Burger::Hash(&Tester, (const Word8*)pWork->m_pString,
+			Burger::StringLength(pWork->m_pString));
+		Word uTest = static_cast<Word>(Burger::MemoryCompare(
+			Tester.m_Hash, pWork->m_HashSHA256.m_Hash, sizeof(Tester)));
+		uFailure |= uTest;
+		if (uTest) {
+			ReportFailure(
+				"Burger::Hash(SHA256_t,\"%s\") = 0x%02X%02X%02X%02X, expected 0x%02X%02X%02X%02X",
+				uTest, pWork->m_pString, Tester.m_Hash[0], Tester.m_Hash[1],
+				Tester.m_Hash[2], Tester.m_Hash[3], pWork->m_HashSHA256.m_Hash[0],
+				pWork->m_HashSHA256.m_Hash[1], pWork->m_HashSHA256.m_Hash[2],
+				pWork->m_HashSHA256.m_Hash[3]);
+		}
+		++pWork;
+	} while (--uCount);
+	return uFailure;
+}
+
+//
+// Hash a large buffer in one pass, in odd sized pieces and
+// from a stream and make sure they all agree
+//
+
+static Word TestSHA256Chunks(const Word8 *pBuffer,WordPtr uLength)
+{
+	Burger::SHA256_t Expected;
+	Burger::Hash(&Expected,pBuffer,uLength);
+
+	Burger::SHA256Hasher_t Context;
+	Context.Init();
+	WordPtr uOffset = 0;
+	WordPtr uStep = 1;
+	do {
+		WordPtr uChunk = uLength-uOffset;
+		if (uChunk>uStep) {
+			uChunk = uStep;
+		}
+		Context.Process(pBuffer+uOffset,uChunk);
+		uOffset += uChunk;
+		uStep = (uStep*3)+7;
+	} while (uOffset<uLength);
+	Context.Finalize();
+	Word uFailure = static_cast<Word>(Burger::MemoryCompare(
+		Context.m_Hash.m_Hash, Expected.m_Hash, sizeof(Expected)));
+	if (uFailure) {
+		ReportFailure("SHA256Hasher_t::Process() in pieces doesn't match Hash(SHA256_t)",uFailure);
+	}
+
+	Burger::InputMemoryStream Stream(pBuffer,uLength,TRUE);
+	Burger::SHA256_t Tester;
+	Burger::Hash(&Tester,&Stream);
+	Word uTest = static_cast<Word>(Burger::MemoryCompare(
+		Tester.m_Hash, Expected.m_Hash, sizeof(Expected)));
+	uTest |= static_cast<Word>(!Stream.IsEmpty());
+	if (uTest) {
+		ReportFailure("Burger::Hash(SHA256_t,InputMemoryStream *) doesn't match Hash(SHA256_t)",uTest);
+	}
+	return uFailure|uTest;
+}
+
 //
 // Test GOST
 //
@@ -473,13 +1000,51 @@ int BURGER_API TestBrhashes(Word uVerbose)
 	uResult |= TestAdler32();
 	uResult |= TestCRC32B();
 	uResult |= TestCRC32();
+	uResult |= TestCRC32C();
 	uResult |= TestCRC16IBM();
 	uResult |= TestMD2();
 	uResult |= TestMD4();
 	uResult |= TestMD5();
 	uResult |= TestSHA1();
+	uResult |= TestSHA256();
 	uResult |= TestGOST();
 
+	// Test the CRCs with every variant CPUDispatch can pick
+	Word32 uSeed = 0x12345678U;
+	WordPtr i = 0;
+	do {
+		uSeed = (uSeed*1103515245U)+12345U;
+		g_HashBuffer[i] = static_cast<Word8>(uSeed>>16U);
+	} while (++i<sizeof(g_HashBuffer));
+
+	static const Word32 s_Masks[] = {0,Burger::CPUDispatch::kAllFeatures};
+	i = 0;
+	do {
+		Burger::CPUDispatch::SetFamilyFeatureMask(Burger::CPUDispatch::kFamilyCRC,s_Masks[i]);
+		uResult |= TestCRC32Slicing(g_HashBuffer);
+		if (!uResult && (uVerbose & VERBOSE_TIME)) {
+			TimeCRC32(g_HashBuffer,sizeof(g_HashBuffer));
+		}
+	} while (++i<BURGER_ARRAYSIZE(s_Masks));
+
+	// Test Adler-32, SHA-1, SHA-256 and the multi-buffer hashes with every variant
+	static const Word32 s_HashMasks[] = {0,Burger::CPUDispatch::kSSE2|Burger::CPUDispatch::kSSSE3,
+		Burger::CPUDispatch::kAllFeatures};
+	i = 0;
+	do {
+		Burger::CPUDispatch::SetFamilyFeatureMask(Burger::CPUDispatch::kFamilyHash,s_HashMasks[i]);
+		uResult |= TestAdlerBlocks(g_HashBuffer);
+		uResult |= TestSHA1();
+		uResult |= TestSHA256();
+		uResult |= TestSHA256Chunks(g_HashBuffer,sizeof(g_HashBuffer));
+		uResult |= TestHashMultiple(g_HashBuffer);
+		if (!uResult && (uVerbose & VERBOSE_TIME)) {
+			TimeAdler32(g_HashBuffer,sizeof(g_HashBuffer));
+			TimeHashMultiple(g_HashBuffer);
+		}
+	} while (++i<BURGER_ARRAYSIZE(s_HashMasks));
+	Burger::CPUDispatch::ResetFeatureMasks();
+
 	if (!uResult && (uVerbose & VERBOSE_MSG)) {
 		Message("Passed all Hashing tests!");
 	}
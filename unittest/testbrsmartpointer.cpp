@@ -0,0 +1,316 @@
+/***************************************
+
+	Unit tests for the smart pointer classes
+
+    Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+    It is released under an MIT Open Source license. Please see LICENSE for
+    license details. Yes, you can use it in a commercial title without paying
+    anything, just give me a credit.
+
+    Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrsmartpointer.h"
+#include "brsmartpointer.h"
+#include "brcriticalsection.h"
+#include "brstringfunctions.h"
+#include "common.h"
+
+using namespace Burger;
+
+//
+// Classes that count how many instances exist
+//
+
+static volatile Word32 g_uLiveObjects;
+
+class SingleThreaded : public WeakAndStrongBase {
+public:
+	SingleThreaded() { ++g_uLiveObjects; }
+	virtual ~SingleThreaded() { --g_uLiveObjects; }
+};
+
+class MultiThreaded : public AtomicWeakAndStrongBase {
+public:
+	MultiThreaded() { AtomicPreIncrement(&g_uLiveObjects); }
+	virtual ~MultiThreaded() { AtomicPreDecrement(&g_uLiveObjects); }
+};
+
+//
+// Test the move constructors and move assignment
+//
+
+static Word TestMove(void)
+{
+	Word uResult = 0;
+#if defined(BURGER_RVALUE_REFERENCES)
+	{
+		SmartPointer<SingleThreaded> pFirst(New<SingleThreaded>());
+		SingleThreaded *pObject = pFirst.GetPtr();
+
+		// The reference is handed over, not copied
+		SmartPointer<SingleThreaded> pSecond(static_cast<SmartPointer<SingleThreaded> &&>(pFirst));
+		Word uTest = (pFirst.GetPtr() != NULL) || (pSecond.GetPtr() != pObject) || (pObject->GetRefCount() != 1);
+		ReportFailure("SmartPointer(SmartPointer &&) didn't take the reference", uTest);
+		uResult |= uTest;
+
+		// Move assignment releases the old object
+		SmartPointer<SingleThreaded> pThird(New<SingleThreaded>());
+		pThird = static_cast<SmartPointer<SingleThreaded> &&>(pSecond);
+		uTest = (pSecond.GetPtr() != NULL) || (pThird.GetPtr() != pObject) || (pObject->GetRefCount() != 1) || (g_uLiveObjects != 1);
+		ReportFailure("SmartPointer::operator=(SmartPointer &&) failed", uTest);
+		uResult |= uTest;
+
+		// Moved weak pointers still track the object
+		WeakPointer<SingleThreaded> pWeak(pThird);
+		WeakPointer<SingleThreaded> pWeak2(static_cast<WeakPointer<SingleThreaded> &&>(pWeak));
+		uTest = (pWeak.GetPtr() != NULL) || (pWeak2.GetPtr() != pObject) || (pObject->GetRefCount() != 1);
+		ReportFailure("WeakPointer(WeakPointer &&) failed", uTest);
+		uResult |= uTest;
+
+		WeakPointer<SingleThreaded> pWeak3;
+		pWeak3 = static_cast<WeakPointer<SingleThreaded> &&>(pWeak2);
+		uTest = (pWeak2.GetPtr() != NULL) || (pWeak3.GetPtr() != pObject);
+		ReportFailure("WeakPointer::operator=(WeakPointer &&) failed", uTest);
+		uResult |= uTest;
+
+		// Deleting the object clears the moved weak pointer
+		pThird = NULL;
+		uTest = (pWeak3.GetPtr() != NULL) || g_uLiveObjects;
+		ReportFailure("WeakPointer didn't see the object was deleted", uTest);
+		uResult |= uTest;
+	}
+#endif
+	Word uTest = g_uLiveObjects != 0;
+	ReportFailure("TestMove() leaked %u objects", uTest, g_uLiveObjects);
+	uResult |= uTest;
+	return uResult;
+}
+
+//
+// Each thread adds and removes references to a shared object
+//
+
+static WordPtr BURGER_API AtomicCountThread(void *pData)
+{
+	MultiThreaded *pShared = static_cast<MultiThreaded *>(pData);
+	Word i = 100000;
+	do {
+		SmartPointer<MultiThreaded> pLocal(pShared);
+		WeakPointer<MultiThreaded> pWeak(pLocal);
+		if (pWeak.GetPtr() != pShared) {
+			return 1;
+		}
+	} while (--i);
+	return 0;
+}
+
+//
+// Test the atomic reference count policy
+//
+
+static Word TestAtomic(void)
+{
+	Word uResult = 0;
+	{
+		SmartPointer<MultiThreaded> pShared(New<MultiThreaded>());
+
+		// The policy is part of the type
+		Word uTest = !BURGER_STATICRTTI_ISTYPE(AtomicWeakAndStrongBase, pShared.GetPtr()) ||
+			!BURGER_STATICRTTI_ISTYPE(AtomicReferenceCounter, pShared.GetPtr()) ||
+			BURGER_STATICRTTI_ISTYPE(ReferenceCounter, pShared.GetPtr()) ||
+			StringCompare(AtomicWeakAndStrongBase::g_StaticRTTI.GetClassName(), "Burger::AtomicWeakAndStrongBase");
+		ReportFailure("AtomicWeakAndStrongBase has the wrong RTTI", uTest);
+		uResult |= uTest;
+
+		SmartPointer<SingleThreaded> pSingle(New<SingleThreaded>());
+		uTest = !BURGER_STATICRTTI_ISTYPE(ReferenceCounter, pSingle.GetPtr()) ||
+			BURGER_STATICRTTI_ISTYPE(AtomicReferenceCounter, pSingle.GetPtr()) ||
+			StringCompare(ReferenceCounter::g_StaticRTTI.GetClassName(), "Burger::ReferenceCounter");
+		ReportFailure("WeakAndStrongBase has the wrong RTTI", uTest);
+		uResult |= uTest;
+
+		// Hammer the count from several threads
+		MultiThreaded *pObject = pShared.GetPtr();
+		Thread Threads[4];
+		Word i = 0;
+		do {
+			Threads[i].Start(AtomicCountThread, pObject);
+		} while (++i < BURGER_ARRAYSIZE(Threads));
+		WordPtr uThreadResults = AtomicCountThread(pObject);
+		i = 0;
+		do {
+			Threads[i].Wait();
+			uThreadResults |= Threads[i].GetResult();
+		} while (++i < BURGER_ARRAYSIZE(Threads));
+
+		uTest = (pObject->GetRefCount() != 1) || (uThreadResults != 0);
+		ReportFailure("AtomicWeakAndStrongBase reference count is %u instead of 1", uTest, pObject->GetRefCount());
+		uResult |= uTest;
+	}
+	Word uTest = g_uLiveObjects != 0;
+	ReportFailure("TestAtomic() leaked %u objects", uTest, g_uLiveObjects);
+	uResult |= uTest;
+	return uResult;
+}
+
+//
+// Each thread creates the first weak pointers to a set of new objects
+//
+
+struct ProxyRace_t {
+	MultiThreaded **m_ppObjects;			// Objects to point to
+	WeakPointer<MultiThreaded> *m_pWeak;	// Weak pointers for this thread
+	Word m_uCount;							// Number of objects
+};
+
+static WordPtr BURGER_API ProxyRaceThread(void *pData)
+{
+	ProxyRace_t *pRace = static_cast<ProxyRace_t *>(pData);
+	Word i = 0;
+	do {
+		pRace->m_pWeak[i] = pRace->m_ppObjects[i];
+	} while (++i < pRace->m_uCount);
+	return 0;
+}
+
+//
+// Threads racing to create the proxy must share a single one
+//
+
+static Word TestProxyRace(void)
+{
+	Word uResult = 0;
+	const Word uStartChunks = ProxyReferenceCounter::GetChunkCount();
+	{
+		MultiThreaded *pObjects[256];
+		WeakPointer<MultiThreaded> Weak[4][256];
+		ProxyRace_t Races[4];
+		Word i = 0;
+		do {
+			pObjects[i] = New<MultiThreaded>();
+		} while (++i < BURGER_ARRAYSIZE(pObjects));
+		i = 0;
+		do {
+			Races[i].m_ppObjects = pObjects;
+			Races[i].m_pWeak = Weak[i];
+			Races[i].m_uCount = BURGER_ARRAYSIZE(pObjects);
+		} while (++i < BURGER_ARRAYSIZE(Races));
+
+		Thread Threads[3];
+		i = 0;
+		do {
+			Threads[i].Start(ProxyRaceThread, &Races[i + 1]);
+		} while (++i < BURGER_ARRAYSIZE(Threads));
+		ProxyRaceThread(&Races[0]);
+		i = 0;
+		do {
+			Threads[i].Wait();
+		} while (++i < BURGER_ARRAYSIZE(Threads));
+
+		// Deleting the objects must clear every weak pointer
+		i = 0;
+		do {
+			Delete(pObjects[i]);
+		} while (++i < BURGER_ARRAYSIZE(pObjects));
+		Word uTest = FALSE;
+		i = 0;
+		do {
+			Word j = 0;
+			do {
+				uTest |= (Weak[j][i].GetPtr() != NULL);
+			} while (++j < BURGER_ARRAYSIZE(Races));
+		} while (++i < BURGER_ARRAYSIZE(pObjects));
+		ReportFailure("WeakPointer still points to a deleted object", uTest);
+		uResult |= uTest;
+	}
+
+	// A proxy lost in the race would keep a chunk alive
+	Word uTest = ProxyReferenceCounter::GetChunkCount() != uStartChunks;
+	ReportFailure("ProxyReferenceCounter pool leaked %u chunks", uTest,
+		ProxyReferenceCounter::GetChunkCount() - uStartChunks);
+	uResult |= uTest;
+	uTest = g_uLiveObjects != 0;
+	ReportFailure("TestProxyRace() leaked %u objects", uTest, g_uLiveObjects);
+	uResult |= uTest;
+	return uResult;
+}
+
+//
+// Test the pool of ProxyReferenceCounter objects
+//
+
+static Word TestProxyPool(void)
+{
+	Word uResult = 0;
+	const Word uStartChunks = ProxyReferenceCounter::GetChunkCount();
+	const Word uCount = (ProxyReferenceCounter::cProxiesPerChunk * 3) + 5;
+	{
+		SmartPointer<SingleThreaded> Objects[(ProxyReferenceCounter::cProxiesPerChunk * 3) + 5];
+		WeakPointer<SingleThreaded> Weak[(ProxyReferenceCounter::cProxiesPerChunk * 3) + 5];
+		Word i = 0;
+		do {
+			Objects[i] = New<SingleThreaded>();
+			Weak[i] = Objects[i];
+		} while (++i < uCount);
+
+		// Every proxy needs a slot, at most one chunk was partially free
+		Word uTest = ProxyReferenceCounter::GetChunkCount() < (uStartChunks + 3);
+		ReportFailure("ProxyReferenceCounter pool has %u chunks", uTest, ProxyReferenceCounter::GetChunkCount());
+		uResult |= uTest;
+
+		// Delete every other object, the proxies live on in the weak pointers
+		i = 0;
+		do {
+			Objects[i] = NULL;
+			i += 2;
+		} while (i < uCount);
+		i = 0;
+		do {
+			uTest = (Weak[i].GetPtr() != NULL) != ((i & 1) != 0);
+			if (uTest) {
+				ReportFailure("WeakPointer %u has the wrong state", uTest, i);
+				uResult |= uTest;
+			}
+		} while (++i < uCount);
+
+		// Release the proxies in reverse order
+		i = uCount;
+		do {
+			--i;
+			Weak[i] = static_cast<SingleThreaded *>(NULL);
+		} while (i);
+	}
+
+	// The pool releases the last chunk once it's empty
+	Word uTest = ProxyReferenceCounter::GetChunkCount() != uStartChunks;
+	ReportFailure("ProxyReferenceCounter pool has %u chunks, expected %u", uTest, ProxyReferenceCounter::GetChunkCount(), uStartChunks);
+	uResult |= uTest;
+	uTest = g_uLiveObjects != 0;
+	ReportFailure("TestProxyPool() leaked %u objects", uTest, g_uLiveObjects);
+	uResult |= uTest;
+	return uResult;
+}
+
+//
+// Perform all the tests for the Burgerlib smart pointers
+//
+
+int BURGER_API TestBrsmartpointer(Word uVerbose)
+{
+	if (uVerbose & VERBOSE_MSG) {
+		Message("Running Smart Pointer tests");
+	}
+
+	Word uTotal = TestMove();
+	uTotal |= TestAtomic();
+	uTotal |= TestProxyRace();
+	uTotal |= TestProxyPool();
+
+	if (!uTotal && (uVerbose & VERBOSE_MSG)) {
+		Message("Passed all Smart Pointer tests!");
+	}
+	return static_cast<int>(uTotal);
+}
@@ -15,6 +15,7 @@
 #include "testbrstaticrtti.h"
 #include "brstaticrtti.h"
 #include "brstringfunctions.h"
+#include "brtick.h"
 #include "common.h"
 
 
@@ -60,6 +61,44 @@ BURGER_CREATE_STATICRTTI_PARENT(foo3, foo2);
 BURGER_CREATE_STATICRTTI_PARENT(foo4, foo2);
 BURGER_CREATE_STATICRTTI_PARENT(foo5, foo);
 
+//
+// Deep class tree for benchmarking
+//
+
+class deep1 : public foo5 {
+public:
+	BURGER_RTTI_IN_CLASS();
+};
+class deep2 : public deep1 {
+public:
+	BURGER_RTTI_IN_CLASS();
+};
+class deep3 : public deep2 {
+public:
+	BURGER_RTTI_IN_CLASS();
+};
+class deep4 : public deep3 {
+public:
+	BURGER_RTTI_IN_CLASS();
+};
+class deep5 : public deep4 {
+public:
+	BURGER_RTTI_IN_CLASS();
+};
+class deep6 : public deep5 {
+public:
+	BURGER_RTTI_IN_CLASS();
+};
+BURGER_CREATE_STATICRTTI_PARENT(deep1, foo5);
+BURGER_CREATE_STATICRTTI_PARENT(deep2, deep1);
+BURGER_CREATE_STATICRTTI_PARENT(deep3, deep2);
+BURGER_CREATE_STATICRTTI_PARENT(deep4, deep3);
+BURGER_CREATE_STATICRTTI_PARENT(deep5, deep4);
+BURGER_CREATE_STATICRTTI_PARENT(deep6, deep5);
+
+// Record that isn't registered, must use the linked list
+static const StaticRTTI g_Unregistered = {"unregistered", &foo2::g_StaticRTTI, NULL, 0, 0};
+
 //
 // Brute force tests
 //
@@ -199,6 +238,91 @@ static Word TestRTTI(void)
 	return uResult;
 }
 
+//
+// Test the type ID ranges
+//
+
+static Word TestTypeIDs(void)
+{
+	StaticRTTI::ComputeTypeIDs();
+
+	// Every registered record needs a type ID
+	Word uResult = !foo::g_StaticRTTI.m_uTypeID || !foo4::g_StaticRTTI.m_uTypeID || !deep6::g_StaticRTTI.m_uTypeID;
+	ReportFailure("StaticRTTI::ComputeTypeIDs() didn't assign a type ID", uResult);
+
+	// Base classes cover all derived classes
+	Word uTest = (foo::g_StaticRTTI.m_uLastTypeID-foo::g_StaticRTTI.m_uTypeID)!=10;
+	ReportFailure("foo::g_StaticRTTI doesn't cover 11 classes", uTest);
+	uResult |= uTest;
+	uTest = (foo2::g_StaticRTTI.m_uLastTypeID-foo2::g_StaticRTTI.m_uTypeID)!=2;
+	ReportFailure("foo2::g_StaticRTTI doesn't cover 3 classes", uTest);
+	uResult |= uTest;
+	uTest = foo3::g_StaticRTTI.m_uLastTypeID!=foo3::g_StaticRTTI.m_uTypeID;
+	ReportFailure("foo3::g_StaticRTTI has derived classes", uTest);
+	uResult |= uTest;
+
+	// The unregistered record falls back to walking the list
+	uTest = !g_Unregistered.IsInList(&foo::g_StaticRTTI) ||
+		!g_Unregistered.IsInList(&foo2::g_StaticRTTI) ||
+		g_Unregistered.IsInList(&foo5::g_StaticRTTI) ||
+		foo2::g_StaticRTTI.IsInList(&g_Unregistered);
+	ReportFailure("StaticRTTI::IsInList() failed on an unregistered record", uTest);
+	uResult |= uTest;
+
+	// Compare the fast path with walking the list
+	const StaticRTTI *Records[11] = {
+		&foo::g_StaticRTTI,&foo2::g_StaticRTTI,&foo3::g_StaticRTTI,
+		&foo4::g_StaticRTTI,&foo5::g_StaticRTTI,&deep1::g_StaticRTTI,
+		&deep2::g_StaticRTTI,&deep3::g_StaticRTTI,&deep4::g_StaticRTTI,
+		&deep5::g_StaticRTTI,&deep6::g_StaticRTTI
+	};
+	Word i = 0;
+	do {
+		Word j = 0;
+		do {
+			uTest = Records[i]->IsInList(Records[j])!=Records[i]->IsInListSlow(Records[j]);
+			if (uTest) {
+				ReportFailure("%s->IsInList(%s) doesn't match IsInListSlow()",uTest,Records[i]->GetClassName(),Records[j]->GetClassName());
+				uResult |= uTest;
+			}
+		} while (++j<BURGER_ARRAYSIZE(Records));
+	} while (++i<BURGER_ARRAYSIZE(Records));
+	return uResult;
+}
+
+//
+// Time the type ID test against walking the linked list
+//
+
+static void TimeRTTI(void)
+{
+	deep6 bar6;
+	foo4 bar4;
+	foo *pList[2];
+	pList[0] = &bar6;
+	pList[1] = &bar4;
+	const Word uIterations = 1000000;
+
+	// Walk the list, worst case is a miss from the deepest class
+	Word uCount = 0;
+	Word32 uStart = Tick::ReadMicroseconds();
+	Word i = 0;
+	do {
+		uCount += pList[i&1]->GetStaticRTTI()->IsInListSlow(&foo4::g_StaticRTTI);
+	} while (++i<uIterations);
+	Word32 uWalk = Tick::ReadMicroseconds()-uStart;
+
+	// Use the type IDs
+	uStart = Tick::ReadMicroseconds();
+	i = 0;
+	do {
+		uCount += BURGER_STATICRTTI_ISTYPE(foo4,pList[i&1]);
+	} while (++i<uIterations);
+	Word32 uRange = Tick::ReadMicroseconds()-uStart;
+
+	Message("StaticRTTI %u tests, linked list %u us, type IDs %u us (%u hits)",uIterations,uWalk,uRange,uCount);
+}
+
 //
 // Perform all the tests for the Burgerlib Static RTTI
 //
@@ -210,6 +334,11 @@ int BURGER_API TestBrstaticrtti(Word uVerbose)
 	}
 
 	Word uTotal = TestRTTI();
+	uTotal |= TestTypeIDs();
+
+	if (!uTotal && (uVerbose & VERBOSE_TIME)) {
+		TimeRTTI();
+	}
 
 	if (!uTotal && (uVerbose & VERBOSE_MSG)) {
 		Message("Passed all Static RTTI tests!");
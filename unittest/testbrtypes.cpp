@@ -507,6 +507,30 @@ static void BURGER_API ShowCPUFeatures(uint_t uVerbose)
             if (MyID.HasFMA3()) {
                 Message("HasFMA3");
             }
+            if (MyID.HasPCLMULQDQ()) {
+                Message("HasPCLMULQDQ");
+            }
+            if (MyID.HasPOPCNT()) {
+                Message("HasPOPCNT");
+            }
+            if (MyID.HasOSXSAVE()) {
+                Message("HasOSXSAVE");
+            }
+            if (MyID.HasAVX2()) {
+                Message("HasAVX2");
+            }
+            if (MyID.HasBMI1()) {
+                Message("HasBMI1");
+            }
+            if (MyID.HasBMI2()) {
+                Message("HasBMI2");
+            }
+            if (MyID.HasAVX512F()) {
+                Message("HasAVX512F");
+            }
+            if (MyID.HasSHA()) {
+                Message("HasSHA");
+            }
             if (MyID.HasFMA4()) {
                 Message("HasFMA4");
             }